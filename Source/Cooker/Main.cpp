@@ -0,0 +1,103 @@
+﻿/*+===================================================================
+  File:      MAIN.CPP
+
+  Summary:   This console application cooks the PNG and JPEG textures
+			 under a directory to block compressed DDS files with mip
+			 chains and prints the size and quality of each one.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Common.h"
+
+#include <cstdio>
+
+#include "Texture/TextureCooker.h"
+
+namespace
+{
+	constexpr PCWSTR FORMAT_NAMES[static_cast<size_t>(library::eBlockFormat::COUNT)] = { L"BC1", L"BC3", L"BC5", L"BC7" };
+	constexpr DOUBLE MEGABYTE = 1024.0 * 1024.0;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: wmain
+
+  Summary:  Entry point to the cooker. Cooks every texture under the
+			given directory, then prints one line per texture and
+			the totals.
+
+  Args:     INT argc
+			  Number of arguments
+			WCHAR* argv[]
+			  Arguments: the directory and an optional "--bc7" to
+			  use BC7 for color textures
+
+  Returns:  INT
+			  0 if every texture was cooked, 1 otherwise.
+-----------------------------------------------------------------F-F*/
+INT wmain(_In_ INT argc, _In_reads_(argc) WCHAR* argv[])
+{
+	if (argc < 2)
+	{
+		fwprintf(stderr, L"Usage: Cooker <directory> [--bc7]\n");
+		return 1;
+	}
+
+	BOOL bUseBc7 = FALSE;
+	for (INT i = 2; i < argc; ++i)
+	{
+		if (wcscmp(argv[i], L"--bc7") == 0)
+		{
+			bUseBc7 = TRUE;
+		}
+	}
+
+	std::vector<library::CookResult> aResults = library::TextureCooker::CookDirectory(argv[1], bUseBc7);
+
+	wprintf(L"%-48s %-6s %-11s %5s %10s %10s %10s %9s\n", L"Texture", L"Format", L"Size", L"Mips", L"File MB", L"RGBA MB", L"Cooked MB", L"PSNR dB");
+
+	UINT uNumFailed = 0u;
+	UINT64 uSourceBytes = 0ull;
+	UINT64 uUncompressedBytes = 0ull;
+	UINT64 uCookedBytes = 0ull;
+	for (const library::CookResult& result : aResults)
+	{
+		std::wstring szName = result.SourcePath.lexically_relative(argv[1]).wstring();
+		if (FAILED(result.Result))
+		{
+			wprintf(L"%-48s failed (0x%08X)\n", szName.c_str(), static_cast<UINT>(result.Result));
+			++uNumFailed;
+			continue;
+		}
+
+		WCHAR szSize[32];
+		swprintf_s(szSize, L"%ux%u", result.uWidth, result.uHeight);
+		wprintf(
+			L"%-48s %-6s %-11s %5u %10.2f %10.2f %10.2f %9.2f\n",
+			szName.c_str(),
+			FORMAT_NAMES[static_cast<size_t>(result.Format)],
+			szSize,
+			result.uNumMips,
+			static_cast<DOUBLE>(result.uSourceBytes) / MEGABYTE,
+			static_cast<DOUBLE>(result.uUncompressedBytes) / MEGABYTE,
+			static_cast<DOUBLE>(result.uCookedBytes) / MEGABYTE,
+			static_cast<DOUBLE>(result.Psnr)
+		);
+
+		uSourceBytes += result.uSourceBytes;
+		uUncompressedBytes += result.uUncompressedBytes;
+		uCookedBytes += result.uCookedBytes;
+	}
+
+	wprintf(
+		L"%u texture(s), %u failed: %.2f MB of files, %.2f MB uncompressed with mips, %.2f MB cooked\n",
+		static_cast<UINT>(aResults.size()),
+		uNumFailed,
+		static_cast<DOUBLE>(uSourceBytes) / MEGABYTE,
+		static_cast<DOUBLE>(uUncompressedBytes) / MEGABYTE,
+		static_cast<DOUBLE>(uCookedBytes) / MEGABYTE
+	);
+
+	return uNumFailed == 0u ? 0 : 1;
+}
@@ -12,6 +12,7 @@
 #include "Common.h"
 
 #include <cstdio>
+#include <cwchar>
 #include <fstream>
 #include <memory>
 
@@ -24,6 +25,8 @@
 #include "Scene/Scene.h"
 #include "Scene/Voxel.h"
 #include "Shader/SkyMapVertexShader.h"
+#include "Texture/TextureCache.h"
+#include "Texture/TextureStreamer.h"
 
 /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
   Function: wWinMain
@@ -49,10 +52,16 @@
 INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPWSTR lpCmdLine, _In_ INT nCmdShow)
 {
 	UNREFERENCED_PARAMETER(hPrevInstance);
-	UNREFERENCED_PARAMETER(lpCmdLine);
 
 	std::unique_ptr<library::Game> game = std::make_unique<library::Game>(L"Game Graphics Programming Assignment 3: Cube Mapping");
 
+	// Textures are decoded on the job system while the scene loads; with
+	// -streamtextures they stream in over the first frames instead
+	if (wcsstr(lpCmdLine, L"-streamtextures"))
+	{
+		library::TextureStreamer::GetInstance().SetEnabled(TRUE);
+	}
+
 	std::ofstream sceneFile;
 	sceneFile.open("HeightMap.txt");
 	constexpr const UINT MAP_WIDTH = 0;
@@ -344,7 +353,7 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 	XMFLOAT4 white;
 	XMStoreFloat4(&white, Colors::White);
 	const auto floorMaterial = std::make_shared<library::Material>(L"FloorMat");
-	floorMaterial->pDiffuse = std::make_shared<library::Texture>("Content/plane.jpg");
+	floorMaterial->pDiffuse = library::TextureCache::GetInstance().GetOrCreate("Content/plane.jpg");
 	if (FAILED(mainScene->AddMaterial(floorMaterial)))
 		return 0;
 	const auto floor = std::make_shared<Cube>(white);
@@ -11,15 +11,8 @@
 ===================================================================+*/
 #pragma once
 
-#ifndef  UNICODE
-#define UNICODE
-#endif // ! UNICODE
+#include "Portable.h"
 
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif // ! WIN32_LEAN_AND_MEAN
-
-#include <windows.h>
 #include <wincodec.h>
 #include <wrl.h>
 
@@ -48,7 +41,6 @@
 constexpr LPCWSTR PSZ_COURSE_TITLE = L"Game Graphics Programming";
 
 using namespace Microsoft::WRL;
-using namespace DirectX;
 
 #define ASSIMP_LOAD_FLAGS (aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices | aiProcess_ConvertToLeftHanded | aiProcess_CalcTangentSpace)
 
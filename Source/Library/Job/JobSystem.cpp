@@ -0,0 +1,435 @@
+#include "Job/JobSystem.h"
+
+namespace library
+{
+	thread_local UINT JobSystem::sm_uWorkerIndex = 0u;
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::GetInstance
+
+	  Summary:  Returns the process-wide job system. The first call
+				starts one worker per hardware thread, minus the
+				calling thread.
+
+	  Returns:  JobSystem&
+				  The shared job system
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	JobSystem& JobSystem::GetInstance()
+	{
+		static JobSystem s_instance;
+		static std::once_flag s_initFlag;
+
+		std::call_once(s_initFlag, []()
+			{
+				UINT uNumThreads = std::thread::hardware_concurrency();
+				s_instance.Initialize(uNumThreads > 1u ? uNumThreads - 1u : 0u);
+			}
+		);
+
+		return s_instance;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::JobSystem
+
+	  Summary:  Constructor
+
+	  Modifies: [m_aQueues, m_backgroundQueue, m_aWorkers, m_sleepMutex,
+				 m_wakeCondition, m_uNumQueued, m_uNextQueue, m_bRunning].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	JobSystem::JobSystem()
+		: m_aQueues()
+		, m_backgroundQueue()
+		, m_aWorkers()
+		, m_sleepMutex()
+		, m_wakeCondition()
+		, m_uNumQueued(0u)
+		, m_uNextQueue(0u)
+		, m_bRunning(FALSE)
+	{
+		m_aQueues.push_back(std::make_unique<WorkQueue>());
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::~JobSystem
+
+	  Summary:  Destructor
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	JobSystem::~JobSystem()
+	{
+		Shutdown();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::Initialize
+
+	  Summary:  Starts the worker threads. Queue 0 belongs to threads
+				that are not workers, queue i + 1 to worker i. Calling
+				it again restarts the pool with the new worker count.
+				The jobs queued before the restart are run by Shutdown
+				first, so no counter is left waiting on a dropped job.
+				Must not be called from a job.
+
+	  Args:     UINT uNumWorkers
+				  Number of worker threads, 0 runs every job on the
+				  thread that waits for it
+
+	  Modifies: [m_aQueues, m_aWorkers, m_bRunning].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void JobSystem::Initialize(_In_ UINT uNumWorkers)
+	{
+		assert(sm_uWorkerIndex == 0u);
+
+		Shutdown();
+
+		m_aQueues.clear();
+		for (UINT i = 0u; i < uNumWorkers + 1u; ++i)
+		{
+			m_aQueues.push_back(std::make_unique<WorkQueue>());
+		}
+
+		m_bRunning = TRUE;
+
+		m_aWorkers.reserve(uNumWorkers);
+		for (UINT i = 0u; i < uNumWorkers; ++i)
+		{
+			m_aWorkers.emplace_back(&JobSystem::workerMain, this, i + 1u);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::Shutdown
+
+	  Summary:  Wakes and joins every worker thread, then runs the
+				jobs still queued on the calling thread. Background
+				jobs are run too, since no worker is left to pick
+				them up.
+
+	  Modifies: [m_aQueues, m_backgroundQueue, m_aWorkers,
+				 m_uNumQueued, m_bRunning].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void JobSystem::Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_bRunning = FALSE;
+		}
+		m_wakeCondition.notify_all();
+
+		for (std::thread& worker : m_aWorkers)
+		{
+			if (worker.joinable())
+			{
+				worker.join();
+			}
+		}
+		m_aWorkers.clear();
+
+		// Jobs may submit more jobs, which land in the queues drained here
+		while (tryRunOne(0u) || tryRunBackground())
+		{
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::Submit
+
+	  Summary:  Queues a job. Workers push onto their own queue, other
+				threads spread the jobs over all the queues.
+
+	  Args:     Job job
+				  Function to run
+				JobCounter& counter
+				  Counter that is decremented when the job finishes
+
+	  Modifies: [m_aQueues, m_uNumQueued, m_uNextQueue].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void JobSystem::Submit(_In_ Job job, _Inout_ JobCounter& counter)
+	{
+		counter.uNumPending.fetch_add(1u, std::memory_order_relaxed);
+
+		UINT uQueueIndex = sm_uWorkerIndex;
+		if (uQueueIndex == 0u || uQueueIndex >= m_aQueues.size())
+		{
+			uQueueIndex = m_uNextQueue.fetch_add(1u, std::memory_order_relaxed) % static_cast<UINT>(m_aQueues.size());
+		}
+
+		{
+			WorkQueue& queue = *m_aQueues[uQueueIndex];
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			queue.Jobs.push_back(PendingJob{ .Function = std::move(job), .pCounter = &counter });
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_uNumQueued.fetch_add(1u, std::memory_order_release);
+		}
+		m_wakeCondition.notify_one();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::SubmitBackground
+
+	  Summary:  Queues a job that may run for many frames, such as
+				importing an asset. Only workers run background jobs,
+				and only when no regular job is queued, so a thread
+				waiting on its own jobs never picks one up. Without
+				workers the job runs right away on the calling thread.
+
+	  Args:     Job job
+				  Function to run
+				JobCounter& counter
+				  Counter that is decremented when the job finishes
+
+	  Modifies: [m_backgroundQueue, m_uNumQueued].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void JobSystem::SubmitBackground(_In_ Job job, _Inout_ JobCounter& counter)
+	{
+		if (m_aWorkers.empty())
+		{
+			job();
+			return;
+		}
+
+		counter.uNumPending.fetch_add(1u, std::memory_order_relaxed);
+
+		{
+			std::lock_guard<std::mutex> lock(m_backgroundQueue.Mutex);
+			m_backgroundQueue.Jobs.push_back(PendingJob{ .Function = std::move(job), .pCounter = &counter });
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_uNumQueued.fetch_add(1u, std::memory_order_release);
+		}
+		m_wakeCondition.notify_one();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::Wait
+
+	  Summary:  Runs queued jobs on the calling thread until the
+				counter drops to zero, so waiting never idles a core
+
+	  Args:     JobCounter& counter
+				  Counter to wait on
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void JobSystem::Wait(_Inout_ JobCounter& counter)
+	{
+		UINT uQueueIndex = sm_uWorkerIndex < m_aQueues.size() ? sm_uWorkerIndex : 0u;
+
+		while (counter.uNumPending.load(std::memory_order_acquire) > 0u)
+		{
+			if (!tryRunOne(uQueueIndex))
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::ParallelFor
+
+	  Summary:  Splits [0, uCount) into ranges of uGrainSize elements,
+				runs them as jobs and waits for all of them. Each range
+				is handed to exactly one job, so as long as the job only
+				writes the elements of its own range nothing is shared.
+
+	  Args:     UINT uCount
+				  Number of elements
+				UINT uGrainSize
+				  Number of elements per job
+				const RangeJob& job
+				  Function called with [uBegin, uEnd)
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void JobSystem::ParallelFor(_In_ UINT uCount, _In_ UINT uGrainSize, _In_ const RangeJob& job)
+	{
+		if (uCount == 0u)
+		{
+			return;
+		}
+
+		uGrainSize = uGrainSize > 0u ? uGrainSize : 1u;
+
+		if (m_aWorkers.empty() || uCount <= uGrainSize)
+		{
+			job(0u, uCount);
+			return;
+		}
+
+		JobCounter counter;
+		for (UINT uBegin = 0u; uBegin < uCount; uBegin += uGrainSize)
+		{
+			UINT uEnd = uBegin + uGrainSize < uCount ? uBegin + uGrainSize : uCount;
+			Submit([&job, uBegin, uEnd]() { job(uBegin, uEnd); }, counter);
+		}
+
+		Wait(counter);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::GetNumWorkers
+
+	  Summary:  Returns the number of worker threads
+
+	  Returns:  UINT
+				  Number of worker threads
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT JobSystem::GetNumWorkers() const
+	{
+		return static_cast<UINT>(m_aWorkers.size());
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::tryRunBackground
+
+	  Summary:  Runs the oldest background job
+
+	  Modifies: [m_backgroundQueue, m_uNumQueued].
+
+	  Returns:  BOOL
+				  Whether a job has been run
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL JobSystem::tryRunBackground()
+	{
+		PendingJob pendingJob;
+		{
+			std::lock_guard<std::mutex> lock(m_backgroundQueue.Mutex);
+
+			if (m_backgroundQueue.Jobs.empty())
+			{
+				return FALSE;
+			}
+
+			pendingJob = std::move(m_backgroundQueue.Jobs.front());
+			m_backgroundQueue.Jobs.pop_front();
+		}
+
+		m_uNumQueued.fetch_sub(1u, std::memory_order_relaxed);
+
+		pendingJob.Function();
+		pendingJob.pCounter->uNumPending.fetch_sub(1u, std::memory_order_release);
+
+		return TRUE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::tryRunOne
+
+	  Summary:  Runs a single job from the given queue, or one stolen
+				from another queue
+
+	  Args:     UINT uQueueIndex
+				  Queue of the calling thread
+
+	  Returns:  BOOL
+				  Whether a job has been run
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL JobSystem::tryRunOne(_In_ UINT uQueueIndex)
+	{
+		PendingJob pendingJob;
+		if (!tryPop(uQueueIndex, pendingJob) && !trySteal(uQueueIndex, pendingJob))
+		{
+			return FALSE;
+		}
+
+		m_uNumQueued.fetch_sub(1u, std::memory_order_relaxed);
+
+		pendingJob.Function();
+		pendingJob.pCounter->uNumPending.fetch_sub(1u, std::memory_order_release);
+
+		return TRUE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::tryPop
+
+	  Summary:  Pops the most recently pushed job of the given queue
+
+	  Args:     UINT uQueueIndex
+				  Index of the queue
+				PendingJob& outJob
+				  Popped job
+
+	  Returns:  BOOL
+				  Whether a job has been popped
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL JobSystem::tryPop(_In_ UINT uQueueIndex, _Out_ PendingJob& outJob)
+	{
+		WorkQueue& queue = *m_aQueues[uQueueIndex];
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+
+		if (queue.Jobs.empty())
+		{
+			return FALSE;
+		}
+
+		outJob = std::move(queue.Jobs.back());
+		queue.Jobs.pop_back();
+
+		return TRUE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::trySteal
+
+	  Summary:  Takes the oldest job of the first other queue that has
+				one, starting right after the thief's own queue
+
+	  Args:     UINT uThiefIndex
+				  Queue of the stealing thread
+				PendingJob& outJob
+				  Stolen job
+
+	  Returns:  BOOL
+				  Whether a job has been stolen
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL JobSystem::trySteal(_In_ UINT uThiefIndex, _Out_ PendingJob& outJob)
+	{
+		UINT uNumQueues = static_cast<UINT>(m_aQueues.size());
+
+		for (UINT i = 1u; i < uNumQueues; ++i)
+		{
+			WorkQueue& queue = *m_aQueues[(uThiefIndex + i) % uNumQueues];
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+
+			if (!queue.Jobs.empty())
+			{
+				outJob = std::move(queue.Jobs.front());
+				queue.Jobs.pop_front();
+
+				return TRUE;
+			}
+		}
+
+		return FALSE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   JobSystem::workerMain
+
+	  Summary:  Worker loop. Sleeps while nothing is queued.
+
+	  Args:     UINT uWorkerIndex
+				  Index of the worker's queue
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void JobSystem::workerMain(_In_ UINT uWorkerIndex)
+	{
+		sm_uWorkerIndex = uWorkerIndex;
+
+		while (m_bRunning.load(std::memory_order_acquire))
+		{
+			if (tryRunOne(uWorkerIndex) || tryRunBackground())
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_wakeCondition.wait(lock, [this]()
+				{
+					return !m_bRunning.load(std::memory_order_acquire) || m_uNumQueued.load(std::memory_order_acquire) > 0u;
+				}
+			);
+		}
+	}
+}
@@ -0,0 +1,122 @@
+/*+===================================================================
+  File:      JOBSYSTEM.H
+
+  Summary:   JobSystem header file contains declarations of the
+			 work-stealing job system used to run independent engine
+			 work on worker threads.
+
+  Classes: JobSystem
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Portable.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace library
+{
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   JobCounter
+
+		Summary:  Number of submitted jobs that have not finished yet.
+				  Waiting on a counter blocks until it reaches zero.
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct JobCounter
+	{
+		std::atomic<UINT> uNumPending{ 0u };
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    JobSystem
+
+	  Summary:  Fixed pool of worker threads. Each worker owns a job
+				queue, pops its own jobs from the back and steals from
+				the front of the other queues when it runs dry.
+
+	  Methods:  GetInstance
+				  Returns the process-wide job system
+				Initialize
+				  Starts the given number of worker threads
+				Shutdown
+				  Stops and joins all the worker threads
+				Submit
+				  Queues a job and increments the counter
+				SubmitBackground
+				  Queues a long job that only the workers run, once
+				  they have nothing else to do
+				Wait
+				  Helps running jobs until the counter reaches zero
+				ParallelFor
+				  Splits [0, uCount) into ranges and runs them on the
+				  workers, returns when every range is done
+				GetNumWorkers
+				  Returns the number of worker threads
+				JobSystem
+				  Constructor.
+				~JobSystem
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class JobSystem final
+	{
+	public:
+		using Job = std::function<void()>;
+		using RangeJob = std::function<void(UINT uBegin, UINT uEnd)>;
+
+		static JobSystem& GetInstance();
+
+		JobSystem();
+		JobSystem(const JobSystem& other) = delete;
+		JobSystem(JobSystem&& other) = delete;
+		JobSystem& operator=(const JobSystem& other) = delete;
+		JobSystem& operator=(JobSystem&& other) = delete;
+		~JobSystem();
+
+		void Initialize(_In_ UINT uNumWorkers);
+		void Shutdown();
+
+		void Submit(_In_ Job job, _Inout_ JobCounter& counter);
+		void SubmitBackground(_In_ Job job, _Inout_ JobCounter& counter);
+		void Wait(_Inout_ JobCounter& counter);
+		void ParallelFor(_In_ UINT uCount, _In_ UINT uGrainSize, _In_ const RangeJob& job);
+
+		UINT GetNumWorkers() const;
+
+	private:
+		struct PendingJob
+		{
+			Job Function;
+			JobCounter* pCounter;
+		};
+
+		struct WorkQueue
+		{
+			std::mutex Mutex;
+			std::deque<PendingJob> Jobs;
+		};
+
+		BOOL tryRunBackground();
+		BOOL tryRunOne(_In_ UINT uQueueIndex);
+		BOOL tryPop(_In_ UINT uQueueIndex, _Out_ PendingJob& outJob);
+		BOOL trySteal(_In_ UINT uThiefIndex, _Out_ PendingJob& outJob);
+		void workerMain(_In_ UINT uWorkerIndex);
+
+	private:
+		static thread_local UINT sm_uWorkerIndex;
+
+		std::vector<std::unique_ptr<WorkQueue>> m_aQueues;
+		WorkQueue m_backgroundQueue;
+		std::vector<std::thread> m_aWorkers;
+		std::mutex m_sleepMutex;
+		std::condition_variable m_wakeCondition;
+		std::atomic<UINT> m_uNumQueued;
+		std::atomic<UINT> m_uNextQueue;
+		std::atomic<BOOL> m_bRunning;
+	};
+}
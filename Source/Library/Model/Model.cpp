@@ -1,5 +1,13 @@
 #include "Model/Model.h"
 
+#include <algorithm>
+
+#include "Job/JobSystem.h"
+#include "Model/ModelCache.h"
+#include "Renderer/D3D11Backend.h"
+#include "Texture/TextureCache.h"
+#include "Texture/TextureStreamer.h"
+
 #include "assimp/Importer.hpp"	// C++ importer interface
 #include "assimp/scene.h"		    // output data structure
 #include "assimp/postprocess.h"	// post processing flags
@@ -35,32 +43,7 @@ namespace library
 		);
 	}
 
-	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   ConvertVector3dToFloat3
-
-	  Summary:  Conver aiVector3D to XMFLOAT3
-
-	  Returns:  XMFLOAT3
-	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	XMFLOAT3 ConvertVector3dToFloat3(_In_ const aiVector3D& vector)
-	{
-		return XMFLOAT3(vector.x, vector.y, vector.z);
-	}
-
-	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   ConvertQuaternionToVector
-
-	  Summary:  Convert aiQuaternion to XMVECTOR
-
-	  Returns:  XMVECTOR
-	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	XMVECTOR ConvertQuaternionToVector(_In_ const aiQuaternion& quaternion)
-	{
-		XMFLOAT4 float4 = XMFLOAT4(quaternion.x, quaternion.y, quaternion.z, quaternion.w);
-		return XMLoadFloat4(&float4);
-	}
-
-	std::unique_ptr<Assimp::Importer> Model::sm_pImporter = std::make_unique<Assimp::Importer>();
+	thread_local std::unique_ptr<Assimp::Importer> Model::sm_pImporter;
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Model::Model
@@ -70,17 +53,25 @@ namespace library
 	  Args:     const std::filesystem::path& filePath
 				  Path to the model to load
 
-	  Modifies: [m_filePath, m_animationBuffer, m_skinningConstantBuffer,
-				 m_skinningConstantBuffer, m_aVertices, m_aAnimationData,
+	  Modifies: [m_filePath, m_sourceModel, m_animationBuffer,
+				 m_skinningConstantBuffer,
+				 m_skinnedVertexBuffer, m_skinnedNormalBuffer,
+				 m_aVertices, m_aAnimationData,
 				 m_aIndices, m_aBoneData, m_aBoneInfo, m_aTransforms,
 				 m_aBoneInfo, m_aTransforms, m_boneNameToIndexMap,
-				 m_pScene, m_timeSinceLoaded, m_globalInverseTransform].
+				 m_skeleton, m_pose, m_aSkinnedVertices, m_aSkinnedNormalData,
+				 m_aSkinningRanges, m_pScene, m_timeSinceLoaded, m_bCpuSkinning,
+				 m_bSkinnedVerticesDirty, m_bIsReady,
+				 m_globalInverseTransform].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	Model::Model(_In_ const std::filesystem::path& filePath) :
 		Renderable(XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f)),
 		m_filePath(filePath),
+		m_sourceModel(),
 		m_animationBuffer(),
 		m_skinningConstantBuffer(),
+		m_skinnedVertexBuffer(),
+		m_skinnedNormalBuffer(),
 		m_aVertices(),
 		m_aAnimationData(),
 		m_aIndices(),
@@ -88,37 +79,98 @@ namespace library
 		m_aBoneInfo(),
 		m_aTransforms(),
 		m_boneNameToIndexMap(),
+		m_skeleton(),
+		m_pose(),
+		m_aSkinnedVertices(),
+		m_aSkinnedNormalData(),
+		m_aSkinningRanges(),
 		m_pScene(),
 		m_timeSinceLoaded(),
+		m_bCpuSkinning(FALSE),
+		m_bSkinnedVerticesDirty(FALSE),
+		m_bIsReady(FALSE),
 		m_globalInverseTransform()
 	{}
 
 	Model::~Model()
 	{
-		delete m_pScene;
+		// Instances borrow the scene of their source model
+		if (!m_sourceModel)
+		{
+			delete m_pScene;
+		}
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Model::Initialize
 
-	  Summary:  Load and initialize the 3d model and create buffers
+	  Summary:  Initialize the model as an instance of the source model
+				of its file. The file is imported only by the first
+				model that asks the model cache for it.
 
 	  Args:     ID3D11Device* pDevice
 				  The Direct3D device to create the buffers
 				ID3D11DeviceContext* pImmediateContext
 				  The Direct3D context to set buffers
 
-	  Modifies: [m_pScene, m_globalInverseTransform, m_animationBuffer,
-				 m_skinningConstantBuffer].
+	  Modifies: [m_sourceModel].
 
 	  Returns:  HRESULT
 				  Status code
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	HRESULT Model::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+	{
+		std::shared_ptr<Model> source;
+		HRESULT hr = ModelCache::GetInstance().GetOrLoad(pDevice, pImmediateContext, m_filePath, source);
+		if (FAILED(hr)) return hr;
+
+		return InitializeInstance(pDevice, source);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Model::Load
+
+	  Summary:  Load and initialize the 3d model and create buffers
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the buffers
+				ID3D11DeviceContext* pImmediateContext
+				  The Direct3D context to set buffers
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Model::Load(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+	{
+		HRESULT hr = Import();
+		if (FAILED(hr)) return hr;
+
+		return CreateDeviceObjects(pDevice, pImmediateContext);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Model::Import
+
+	  Summary:  Parses the file and builds the vertices, indices,
+				materials and skeleton without touching the device.
+				Each thread imports with its own assimp importer, so
+				different files can be imported on the job system at
+				the same time.
+
+	  Modifies: [m_pScene, m_globalInverseTransform, m_skeleton, m_pose,
+				 m_aTransforms, m_aSkinningRanges, m_aMaterials].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Model::Import()
 	{
 		HRESULT hr = S_OK;
 
-		// Create the buffers for the vertices attributes
+		if (!sm_pImporter)
+		{
+			sm_pImporter = std::make_unique<Assimp::Importer>();
+		}
 
 		sm_pImporter->ReadFile(
 			m_filePath.string().c_str(),
@@ -143,7 +195,76 @@ namespace library
 		auto determinant = XMMatrixDeterminant(transformation);
 
 		m_globalInverseTransform = XMMatrixInverse(&determinant, transformation);
-		hr = initFromScene(pDevice, pImmediateContext, m_pScene, m_filePath);
+		hr = initFromScene(m_pScene, m_filePath);
+		if (FAILED(hr)) return hr;
+
+		decodeTextures();
+
+		// Flatten the hierarchy once so the palette does not walk the assimp nodes every frame
+		std::vector<XMMATRIX> aBoneOffsets;
+		aBoneOffsets.reserve(m_aBoneInfo.size());
+		for (const BoneInfo& boneInfo : m_aBoneInfo)
+		{
+			aBoneOffsets.push_back(boneInfo.OffsetMatrix);
+		}
+
+		m_skeleton = std::make_shared<Skeleton>();
+		hr = m_skeleton->Initialize(m_pScene, m_boneNameToIndexMap, aBoneOffsets, m_globalInverseTransform);
+		if (FAILED(hr)) return hr;
+
+		m_skeleton->InitializePose(m_pose);
+		m_aTransforms.resize(m_aBoneInfo.size());
+
+		// One skinning job per mesh, large meshes are split further
+		m_aSkinningRanges.clear();
+		for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+		{
+			UINT uBaseVertex = m_aMeshes[i].uBaseVertex;
+			UINT uEndVertex = i + 1u < m_aMeshes.size() ? m_aMeshes[i + 1u].uBaseVertex : GetNumVertices();
+
+			for (UINT uBegin = uBaseVertex; uBegin < uEndVertex; uBegin += MAX_NUM_VERTICES_PER_SKINNING_JOB)
+			{
+				m_aSkinningRanges.push_back(
+					SkinningRange
+					{
+						.uBaseVertex = uBegin,
+						.uNumVertices = std::min<UINT>(MAX_NUM_VERTICES_PER_SKINNING_JOB, uEndVertex - uBegin)
+					}
+				);
+			}
+		}
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Model::CreateDeviceObjects
+
+	  Summary:  Creates the buffers and textures of an imported model.
+				Only the thread that owns the immediate context may
+				call it. Calling it again after it succeeded does
+				nothing.
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the buffers
+				ID3D11DeviceContext* pImmediateContext
+				  The Direct3D context to set buffers
+
+	  Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer,
+				 m_normalBuffer, m_animationBuffer,
+				 m_skinningConstantBuffer, m_aMaterials, m_bIsReady].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Model::CreateDeviceObjects(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+	{
+		if (m_bIsReady)
+		{
+			return S_OK;
+		}
+
+		HRESULT hr = initialize(pDevice, pImmediateContext);
 		if (FAILED(hr)) return hr;
 
 		// Create animation vertex buffer
@@ -184,9 +305,35 @@ namespace library
 		hr = pDevice->CreateBuffer(&cBufferDesc, &cData, &m_skinningConstantBuffer);
 		if (FAILED(hr)) return hr;
 
+		// A missing texture leaves the material untextured instead of failing the model
+		for (const std::shared_ptr<Material>& material : m_aMaterials)
+		{
+			if (FAILED(material->Initialize(pDevice, pImmediateContext)))
+			{
+				OutputDebugString(L"Error loading the textures of material \"");
+				OutputDebugString(material->GetName().c_str());
+				OutputDebugString(L"\"\n");
+			}
+		}
+
+		m_bIsReady = TRUE;
+
 		return S_OK;
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Model::IsReady
+
+	  Summary:  Returns whether the buffers of the model exist, so it
+				can be updated and drawn
+
+	  Returns:  BOOL
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL Model::IsReady() const
+	{
+		return m_bIsReady;
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Model::Update
 
@@ -195,10 +342,13 @@ namespace library
 	  Args:     FLOAT deltaTime
 				  Time difference of a frame
 
-	  Modifies: [m_aTransforms].
+	  Modifies: [m_aTransforms, m_pose, m_aSkinnedVertices,
+				 m_aSkinnedNormalData].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	void Model::Update(_In_ FLOAT deltaTime)
 	{
+		if (!m_bIsReady) return;
+
 		m_timeSinceLoaded += deltaTime;
 
 		if (!m_pScene->HasAnimations()) return;
@@ -210,13 +360,12 @@ namespace library
 		FLOAT ticks = m_timeSinceLoaded * tps;
 		ticks = fmod(ticks, static_cast<FLOAT>(anim->mDuration));
 
-		readNodeHierarchy(ticks, m_pScene->mRootNode, XMMatrixIdentity());
-		// Resize m_aTransforms same as m_aBoneInfo
-		m_aTransforms.resize(m_aBoneInfo.size());
-		// Store each final transformations in the bone information to the m_aTransforms
-		for (UINT i = 0u; i < m_aBoneInfo.size(); i++)
+		m_aTransforms.resize(m_skeleton->GetNumBones());
+		m_skeleton->ComputePalette(ticks, m_pose, m_aTransforms.data());
+
+		if (m_bCpuSkinning)
 		{
-			m_aTransforms[i] = m_aBoneInfo[i].FinalTransformation;
+			skinVertices();
 		}
 	}
 
@@ -256,7 +405,7 @@ namespace library
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	UINT Model::GetNumVertices() const
 	{
-		return static_cast<UINT>(m_aVertices.size());
+		return static_cast<UINT>(getSource().m_aVertices.size());
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -269,7 +418,7 @@ namespace library
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	UINT Model::GetNumIndices() const
 	{
-		return static_cast<UINT>(m_aIndices.size());
+		return static_cast<UINT>(getSource().m_aIndices.size());
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -295,150 +444,311 @@ namespace library
 	 M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	const std::unordered_map<std::string, UINT>& Model::GetBoneNameToIndexMap() const
 	{
-		return m_boneNameToIndexMap;
+		return getSource().m_boneNameToIndexMap;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Model::countVerticesAndIndices
+	  Method:   Model::SetCpuSkinning
 
-	  Summary:  Fill the BasicMeshEntry information
+	  Summary:  Enables or disables skinning on the CPU. When enabled
+				the skinned vertices replace the bind pose vertices in
+				every pass and the skinning shader is given no bones,
+				which it treats as an identity palette.
 
-	  Args:     UINT& uOutNumVertices
-				  Total number of vertices
-				UINT& uOutNumIndices
-				  Total number of indices
-				const aiScene* pScene
-				  Pointer to an assimp scene object that contains the
-				  mesh information
+	  Args:     BOOL bEnable
+				  Whether to skin on the CPU
+
+	  Modifies: [m_bCpuSkinning].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	void Model::countVerticesAndIndices(_Inout_ UINT& uOutNumVertices, _Inout_ UINT& uOutNumIndices, _In_ const aiScene* pScene)
+	void Model::SetCpuSkinning(_In_ BOOL bEnable)
 	{
-		uOutNumVertices = 0;
-		uOutNumIndices = 0;
+		m_bCpuSkinning = bEnable;
+	}
 
-		for (UINT i = 0; i < pScene->mNumMeshes; i++)
-		{
-			const auto& mesh = pScene->mMeshes[i];
-			uOutNumVertices += mesh->mNumVertices;
-			uOutNumIndices += mesh->mNumFaces * 3u;
-		}
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Model::IsCpuSkinned
+
+	  Summary:  Returns whether the skinned vertex buffer holds the
+				vertices to draw
+
+	  Returns:  BOOL
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL Model::IsCpuSkinned() const
+	{
+		return m_bCpuSkinning && m_skinnedVertexBuffer != nullptr && m_skinnedNormalBuffer != nullptr;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-		Method:   Model::findNodeAnimOrNull
+	  Method:   Model::UploadSkinnedVertices
 
-		Summary:  Find the aiNodeAnim with the givne node name in the given animation
+	  Summary:  Copies the vertices, tangents and bitangents skinned by
+				the last Update to the dynamic skinned vertex and
+				normal buffers, creating them on first use. Called once
+				a frame before any pass is drawn.
 
-		Args:     const aiAnimation* pAnimation
-					Pointer to an assimp animation object
-				  PCSTR pszNodeName
-					Node name to find
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the buffer with
+				IRenderContext& context
+				  The immediate context to upload with
 
-		Returns:  aiNodeAnim* or nullptr
-	 M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	const aiNodeAnim* Model::findNodeAnimOrNull(_In_ const aiAnimation* pAnimation, _In_ PCSTR pszNodeName)
+	  Modifies: [m_skinnedVertexBuffer, m_skinnedNormalBuffer,
+				 m_bSkinnedVerticesDirty].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Model::UploadSkinnedVertices(_In_ ID3D11Device* pDevice, _Inout_ IRenderContext& context)
 	{
-		for (UINT i = 0u; i < pAnimation->mNumChannels; ++i)
+		HRESULT hr = S_OK;
+
+		if (!m_bCpuSkinning || m_aSkinnedVertices.empty())
 		{
-			const aiNodeAnim* pNodeAnim = pAnimation->mChannels[i];
+			return S_OK;
+		}
 
-			if (strncmp(pNodeAnim->mNodeName.data, pszNodeName, pNodeAnim->mNodeName.length) == 0)
+		if (!m_skinnedVertexBuffer)
+		{
+			D3D11_BUFFER_DESC vBufferDesc =
 			{
-				return pNodeAnim;
-			}
+				.ByteWidth = static_cast<UINT>(sizeof(SimpleVertex) * m_aSkinnedVertices.size()),
+				.Usage = D3D11_USAGE_DYNAMIC,
+				.BindFlags = D3D11_BIND_VERTEX_BUFFER,
+				.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE
+			};
+
+			hr = pDevice->CreateBuffer(&vBufferDesc, nullptr, &m_skinnedVertexBuffer);
+			if (FAILED(hr)) return hr;
 		}
 
-		return nullptr;
+		if (!m_skinnedNormalBuffer)
+		{
+			D3D11_BUFFER_DESC nBufferDesc =
+			{
+				.ByteWidth = static_cast<UINT>(sizeof(NormalData) * m_aSkinnedNormalData.size()),
+				.Usage = D3D11_USAGE_DYNAMIC,
+				.BindFlags = D3D11_BIND_VERTEX_BUFFER,
+				.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE
+			};
+
+			hr = pDevice->CreateBuffer(&nBufferDesc, nullptr, &m_skinnedNormalBuffer);
+			if (FAILED(hr)) return hr;
+		}
+
+		if (m_bSkinnedVerticesDirty)
+		{
+			void* pMapped = nullptr;
+			hr = context.Map(ToGpu(m_skinnedVertexBuffer.Get()), 0u, eMapType::WRITE_DISCARD, &pMapped);
+			if (FAILED(hr)) return hr;
+
+			memcpy(pMapped, m_aSkinnedVertices.data(), sizeof(SimpleVertex) * m_aSkinnedVertices.size());
+			context.Unmap(ToGpu(m_skinnedVertexBuffer.Get()), 0u);
+
+			hr = context.Map(ToGpu(m_skinnedNormalBuffer.Get()), 0u, eMapType::WRITE_DISCARD, &pMapped);
+			if (FAILED(hr)) return hr;
+
+			memcpy(pMapped, m_aSkinnedNormalData.data(), sizeof(NormalData) * m_aSkinnedNormalData.size());
+			context.Unmap(ToGpu(m_skinnedNormalBuffer.Get()), 0u);
+
+			m_bSkinnedVerticesDirty = FALSE;
+		}
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Model::GetSkinnedVertexBuffer
+
+	  Summary:  Returns the skinned vertex buffer
+
+	  Returns:  ComPtr<ID3D11Buffer>&
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	ComPtr<ID3D11Buffer>& Model::GetSkinnedVertexBuffer()
+	{
+		return m_skinnedVertexBuffer;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-		Method:   Model::findPosition
+	  Method:   Model::GetSkinnedNormalBuffer
 
-		Summary:  Find the index of the position key right before the given animation time
+	  Summary:  Returns the skinned tangent and bitangent buffer
 
-		Args:     FLOAT animationTimeTicks
-					Animation time
-				  const aiNodeAnim* pNodeAnim
-					 Pointer to an assimp node anim object
+	  Returns:  ComPtr<ID3D11Buffer>&
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	ComPtr<ID3D11Buffer>& Model::GetSkinnedNormalBuffer()
+	{
+		return m_skinnedNormalBuffer;
+	}
 
-		Returns:  UINT
-					Index of the key
-	 M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	UINT Model::findPosition(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Model::GetSkinnedVertices
+
+	  Summary:  Returns the vertices skinned by the last Update, in
+				model space. Empty until CPU skinning has run once.
+
+	  Returns:  const std::vector<SimpleVertex>&
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const std::vector<SimpleVertex>& Model::GetSkinnedVertices() const
 	{
-		assert(pNodeAnim->mNumPositionKeys > 0);
+		return m_aSkinnedVertices;
+	}
 
-		for (UINT i = 0; i < pNodeAnim->mNumPositionKeys - 1; ++i)
-		{
-			FLOAT t = static_cast<FLOAT>(pNodeAnim->mPositionKeys[i + 1].mTime);
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Model::GetSkinnedNormalData
 
-			if (animationTimeTicks < t)
-			{
-				return i;
-			}
-		}
+	  Summary:  Returns the tangents and bitangents skinned by the last
+				Update, in model space. Empty until CPU skinning has
+				run once.
 
-		return 0u;
+	  Returns:  const std::vector<NormalData>&
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const std::vector<NormalData>& Model::GetSkinnedNormalData() const
+	{
+		return m_aSkinnedNormalData;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-		Method:   Model::findRotation
+	  Method:   Model::GetFilePath
 
-		Summary:  Find the index of the rotation key right before the given animation time
+	  Summary:  Returns the path to the model file
 
-		Args:     FLOAT animationTimeTicks
-					Animation time
-				  const aiNodeAnim* pNodeAnim
-					 Pointer to an assimp node anim object
+	  Returns:  const std::filesystem::path&
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const std::filesystem::path& Model::GetFilePath() const
+	{
+		return m_filePath;
+	}
 
-		Returns:  UINT
-					Index of the key
-	 M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	UINT Model::findRotation(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Model::GetNumSharedCpuBytes
+
+	  Summary:  Returns the bytes of the vertex, index and bone arrays,
+				the bone tables and the skeleton an instance shares
+				with its source model instead of owning a copy. Bone
+				names count their entry and characters, not the hash
+				buckets.
+
+	  Returns:  SIZE_T
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T Model::GetNumSharedCpuBytes() const
 	{
-		assert(pNodeAnim->mNumRotationKeys > 0);
+		const Model& source = getSource();
 
-		for (UINT i = 0u; i < pNodeAnim->mNumRotationKeys - 1; ++i)
+		SIZE_T uNumBoneNameBytes = 0u;
+		for (const auto& pair : source.m_boneNameToIndexMap)
 		{
-			FLOAT t = static_cast<FLOAT>(pNodeAnim->mRotationKeys[i + 1].mTime);
+			uNumBoneNameBytes += sizeof(pair) + pair.first.capacity();
+		}
 
-			if (animationTimeTicks < t)
+		return source.m_aVertices.size() * sizeof(SimpleVertex) +
+			source.m_aNormalData.size() * sizeof(NormalData) +
+			source.m_aAnimationData.size() * sizeof(AnimationData) +
+			source.m_aIndices.size() * sizeof(WORD) +
+			source.m_aBoneData.size() * sizeof(VertexBoneData) +
+			source.m_aBoneInfo.size() * sizeof(BoneInfo) +
+			source.m_aSkinningRanges.size() * sizeof(SkinningRange) +
+			uNumBoneNameBytes +
+			(source.m_skeleton ? source.m_skeleton->GetNumBytes() : 0u);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Model::GetNumSharedGpuBytes
+
+	  Summary:  Returns the bytes of the vertex and index buffers an
+				instance shares with its source model, read from the
+				buffers themselves. Zero until the source has created
+				its device objects.
+
+	  Returns:  SIZE_T
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T Model::GetNumSharedGpuBytes() const
+	{
+		const Model& source = getSource();
+
+		SIZE_T uNumBytes = 0u;
+		for (ID3D11Buffer* pBuffer : { source.m_vertexBuffer.Get(), source.m_normalBuffer.Get(), source.m_animationBuffer.Get(), source.m_indexBuffer.Get() })
+		{
+			if (pBuffer)
 			{
-				return i;
+				D3D11_BUFFER_DESC desc = {};
+				pBuffer->GetDesc(&desc);
+				uNumBytes += desc.ByteWidth;
 			}
 		}
 
-		return 0u;
+		return uNumBytes;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-		Method:   Model::findScaling
-
-		Summary:  Find the index of the scaling key right before the given animation time
+	  Method:   Model::countVerticesAndIndices
 
-		Args:     FLOAT animationTimeTicks
-					Animation time
-				  const aiNodeAnim* pNodeAnim
-					 Pointer to an assimp node anim object
+	  Summary:  Fill the BasicMeshEntry information
 
-		Returns:  UINT
-					Index of the key
-	 M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	UINT Model::findScaling(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+	  Args:     UINT& uOutNumVertices
+				  Total number of vertices
+				UINT& uOutNumIndices
+				  Total number of indices
+				const aiScene* pScene
+				  Pointer to an assimp scene object that contains the
+				  mesh information
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Model::countVerticesAndIndices(_Inout_ UINT& uOutNumVertices, _Inout_ UINT& uOutNumIndices, _In_ const aiScene* pScene)
 	{
-		assert(pNodeAnim->mNumScalingKeys > 0);
+		uOutNumVertices = 0;
+		uOutNumIndices = 0;
+
+		for (UINT i = 0; i < pScene->mNumMeshes; i++)
+		{
+			const auto& mesh = pScene->mMeshes[i];
+			uOutNumVertices += mesh->mNumVertices;
+			uOutNumIndices += mesh->mNumFaces * 3u;
+		}
+	}
 
-		for (UINT i = 0u; i < pNodeAnim->mNumScalingKeys - 1; ++i)
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Model::decodeTextures
+
+	  Summary:  Decodes the textures of every material and builds their
+				mip chains, one texture per job, so CreateDeviceObjects
+				only has to upload them. Textures shared with other
+				models are decoded once. Only diffuse textures hold
+				colors, the others are filtered as plain data. Streamed
+				textures are decoded by the texture streamer instead.
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Model::decodeTextures()
+	{
+		if (TextureStreamer::GetInstance().IsEnabled())
 		{
-			FLOAT t = static_cast<FLOAT>(pNodeAnim->mScalingKeys[i + 1].mTime);
+			return;
+		}
 
-			if (animationTimeTicks < t)
+		std::vector<std::pair<Texture*, BOOL>> aTextures;
+		auto addTexture = [&aTextures](Texture* pTexture, BOOL bIsSrgb)
+		{
+			if (pTexture && std::find_if(aTextures.begin(), aTextures.end(), [pTexture](const auto& entry) { return entry.first == pTexture; }) == aTextures.end())
 			{
-				return i;
+				aTextures.emplace_back(pTexture, bIsSrgb);
 			}
+		};
+
+		for (const std::shared_ptr<Material>& material : m_aMaterials)
+		{
+			addTexture(material->pDiffuse.get(), TRUE);
+			addTexture(material->pSpecularExponent.get(), FALSE);
+			addTexture(material->pNormal.get(), FALSE);
 		}
 
-		return 0u;
+		JobSystem::GetInstance().ParallelFor(
+			static_cast<UINT>(aTextures.size()),
+			1u,
+			[&aTextures](UINT uBegin, UINT uEnd)
+			{
+				for (UINT i = uBegin; i < uEnd; ++i)
+				{
+					// Files the decoder does not handle are loaded by Texture::Initialize
+					aTextures[i].first->Decode(aTextures[i].second);
+				}
+			}
+		);
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -471,6 +781,20 @@ namespace library
 		return uBoneIndex;
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Model::getSource
+
+	  Summary:  Returns the model that owns the geometry, which is the
+				source model for instances and the model itself
+				otherwise
+
+	  Returns:  const Model&
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const Model& Model::getSource() const
+	{
+		return m_sourceModel ? *m_sourceModel : *this;
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Model::getVertices
 
@@ -481,7 +805,7 @@ namespace library
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	const SimpleVertex* Model::getVertices() const
 	{
-		return m_aVertices.data();
+		return getSource().m_aVertices.data();
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -494,7 +818,7 @@ namespace library
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	const WORD* Model::getIndices() const
 	{
-		return m_aIndices.data();
+		return getSource().m_aIndices.data();
 	}
 
 
@@ -520,11 +844,7 @@ namespace library
 
 	  Summary:  Initialize all meshes in a given assimp scene
 
-	  Args:     ID3D11Device* pDevice
-				  The Direct3D device to create the buffers
-				ID3D11DeviceContext* pImmediateContext
-				  The Direct3D context to set buffers
-				const aiScene* pScene
+	  Args:     const aiScene* pScene
 				  Assimp scene
 				const std::filesystem::path& filePath
 				  Path to the model
@@ -532,12 +852,7 @@ namespace library
 	  Returns:  HRESULT
 				  Status code
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Model::initFromScene(
-		_In_ ID3D11Device* pDevice,
-		_In_ ID3D11DeviceContext* pImmediateContext,
-		_In_ const aiScene* pScene,
-		_In_ const std::filesystem::path& filePath
-	)
+	HRESULT Model::initFromScene(_In_ const aiScene* pScene, _In_ const std::filesystem::path& filePath)
 	{
 		HRESULT hr = S_OK;
 
@@ -552,7 +867,7 @@ namespace library
 
 		initAllMeshes(pScene);
 
-		hr = initMaterials(pDevice, pImmediateContext, pScene, filePath);
+		hr = initMaterials(pScene, filePath);
 		if (FAILED(hr))
 		{
 			return hr;
@@ -569,25 +884,112 @@ namespace library
 			);
 		}
 
-		hr = initialize(pDevice, pImmediateContext);
-		if (FAILED(hr))
-		{
-			return hr;
-		}
-
 		return hr;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Model::initMaterials
+	  Method:   Model::InitializeInstance
 
-	  Summary:  Initialize all materials in a given assimp scene
+	  Summary:  Shares the buffers, materials, bone tables and
+				skeleton of the source model and creates the constant
+				buffers and animation state owned by this instance.
+				The constant buffers cannot be shared: without the
+				constant ring every object's constants are written to
+				its own buffer before any draw is recorded.
 
 	  Args:     ID3D11Device* pDevice
 				  The Direct3D device to create the buffers
-				ID3D11DeviceContext* pImmediateContext
-				  The Direct3D context to set buffers
-				const aiScene* pScene
+				const std::shared_ptr<Model>& source
+				  Loaded source model of the same file
+
+	  Modifies: [m_sourceModel, m_pScene, m_globalInverseTransform,
+				 m_vertexBuffer, m_indexBuffer, m_normalBuffer,
+				 m_animationBuffer, m_aMeshes, m_aMaterials,
+				 m_bHasNormalMap, m_boundingRadius, m_skeleton, m_pose,
+				 m_aTransforms, m_constantBuffer,
+				 m_skinningConstantBuffer, m_bIsReady].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Model::InitializeInstance(_In_ ID3D11Device* pDevice, _In_ const std::shared_ptr<Model>& source)
+	{
+		HRESULT hr = S_OK;
+
+		m_sourceModel = source;
+		m_pScene = source->m_pScene;
+		m_globalInverseTransform = source->m_globalInverseTransform;
+
+		m_vertexBuffer = source->m_vertexBuffer;
+		m_indexBuffer = source->m_indexBuffer;
+		m_normalBuffer = source->m_normalBuffer;
+		m_animationBuffer = source->m_animationBuffer;
+
+		m_aMeshes = source->m_aMeshes;
+		m_aMaterials = source->m_aMaterials;
+		m_bHasNormalMap = source->m_bHasNormalMap;
+		m_boundingRadius = source->m_boundingRadius;
+
+		// Bone tables and skinning ranges are read through getSource
+		m_skeleton = source->m_skeleton;
+		m_skeleton->InitializePose(m_pose);
+		m_aTransforms.resize(m_skeleton->GetNumBones());
+
+		// Create the constant buffers owned by this instance
+		D3D11_BUFFER_DESC cBufferDesc = {
+			.ByteWidth = sizeof(CBChangesEveryFrame),
+			.Usage = D3D11_USAGE_DEFAULT,
+			.BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+			.CPUAccessFlags = 0,
+			.MiscFlags = 0,
+			.StructureByteStride = 0
+		};
+
+		CBChangesEveryFrame cb = {
+			.World = XMMatrixTranspose(m_world),
+			.OutputColor = m_outputColor
+		};
+
+		D3D11_SUBRESOURCE_DATA cData = {
+			.pSysMem = &cb,
+			.SysMemPitch = 0,
+			.SysMemSlicePitch = 0
+		};
+
+		hr = pDevice->CreateBuffer(&cBufferDesc, &cData, &m_constantBuffer);
+		if (FAILED(hr)) return hr;
+
+		D3D11_BUFFER_DESC sBufferDesc = {
+			.ByteWidth = sizeof(CBSkinning),
+			.Usage = D3D11_USAGE_DEFAULT,
+			.BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+			.CPUAccessFlags = 0,
+			.MiscFlags = 0,
+			.StructureByteStride = 0
+		};
+
+		CBSkinning cbSkinning = {};
+
+		D3D11_SUBRESOURCE_DATA sData = {
+			.pSysMem = &cbSkinning,
+			.SysMemPitch = 0,
+			.SysMemSlicePitch = 0
+		};
+
+		hr = pDevice->CreateBuffer(&sBufferDesc, &sData, &m_skinningConstantBuffer);
+		if (FAILED(hr)) return hr;
+
+		m_bIsReady = TRUE;
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Model::initMaterials
+
+	  Summary:  Initialize all materials in a given assimp scene
+
+	  Args:     const aiScene* pScene
 				  Assimp scene
 				const std::filesystem::path& filePath
 				  Path to the model
@@ -595,12 +997,7 @@ namespace library
 	  Returns:  HRESULT
 				  Status code
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Model::initMaterials(
-		_In_ ID3D11Device* pDevice,
-		_In_ ID3D11DeviceContext* pImmediateContext,
-		_In_ const aiScene* pScene,
-		_In_ const std::filesystem::path& filePath
-	)
+	HRESULT Model::initMaterials(_In_ const aiScene* pScene, _In_ const std::filesystem::path& filePath)
 	{
 		HRESULT hr = S_OK;
 
@@ -617,7 +1014,7 @@ namespace library
 			std::copy(szName.begin(), szName.end(), pwszName.begin());
 			m_aMaterials.push_back(std::make_shared<Material>(pwszName));
 
-			loadTextures(pDevice, pImmediateContext, parentDirectory, pMaterial, i);
+			loadTextures(parentDirectory, pMaterial, i);
 		}
 
 		return hr;
@@ -742,122 +1139,12 @@ namespace library
 		initMeshBones(uMeshIndex, pMesh);
 	}
 
-	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Model::interpolatePosition
-
-	  Summary:  Interpolate two keyframes to find translate vector
-
-	  Args:     XMFLOAT3& outTranslate
-				  Translate vector
-				FLOAT animationTimeTicks
-				  Animation time
-				const aiNodeAnim* pNodeAnim
-				  Pointer to an assimp node anim object
-	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	void Model::interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
-	{
-		if (pNodeAnim->mNumPositionKeys == 1)
-		{
-			outTranslate = ConvertVector3dToFloat3(pNodeAnim->mPositionKeys[0].mValue);
-			return;
-		}
-
-		UINT uPositionIndex = findPosition(animationTimeTicks, pNodeAnim);
-		UINT uNextPositionIndex = uPositionIndex + 1u;
-		assert(uNextPositionIndex < pNodeAnim->mNumPositionKeys);
-
-		FLOAT t1 = static_cast<FLOAT>(pNodeAnim->mPositionKeys[uPositionIndex].mTime);
-		FLOAT t2 = static_cast<FLOAT>(pNodeAnim->mPositionKeys[uNextPositionIndex].mTime);
-		FLOAT deltaTime = t2 - t1;
-		FLOAT factor = (animationTimeTicks - t1) / deltaTime;
-		assert(factor >= 0.0f && factor <= 1.0f);
-		const aiVector3D& start = pNodeAnim->mPositionKeys[uPositionIndex].mValue;
-		const aiVector3D& end = pNodeAnim->mPositionKeys[uNextPositionIndex].mValue;
-		aiVector3D delta = end - start;
-		outTranslate = ConvertVector3dToFloat3(start + factor * delta);
-	}
-
-	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Model::interpolateRotation
-
-	  Summary:  Interpolate two keyframes to find rotation vector
-
-	  Args:     XMVECTOR& outQuaternion
-				  Quaternion vector
-				FLOAT animationTimeTicks
-				  Animation time
-				const aiNodeAnim* pNodeAnim
-				  Pointer to an assimp node anim object
-	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	void Model::interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
-	{
-		if (pNodeAnim->mNumRotationKeys == 1)
-		{
-			outQuaternion = ConvertQuaternionToVector(pNodeAnim->mRotationKeys[0].mValue);
-			return;
-		}
-
-		UINT uRotationIndex = findRotation(animationTimeTicks, pNodeAnim);
-		UINT uNextRotationIndex = uRotationIndex + 1u;
-		assert(uNextRotationIndex < pNodeAnim->mNumRotationKeys);
-
-		FLOAT t1 = static_cast<FLOAT>(pNodeAnim->mRotationKeys[uRotationIndex].mTime);
-		FLOAT t2 = static_cast<FLOAT>(pNodeAnim->mRotationKeys[uNextRotationIndex].mTime);
-		FLOAT deltaTime = t2 - t1;
-		FLOAT factor = (animationTimeTicks - t1) / deltaTime;
-		assert(factor >= 0.0f && factor <= 1.0f);
-		const aiQuaternion& start = pNodeAnim->mRotationKeys[uRotationIndex].mValue;
-		const aiQuaternion& end = pNodeAnim->mRotationKeys[uNextRotationIndex].mValue;
-		aiQuaternion result;
-		aiQuaternion::Interpolate(result, start, end, factor);
-		outQuaternion = ConvertQuaternionToVector(result);
-	}
-
-	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Model::interpolateScaling
-
-	  Summary:  Interpolate two keyframes to find scaling vector
-
-	  Args:     XMFLOAT3& outScale
-				  Scaling vector
-				FLOAT animationTimeTicks
-				  Animation time
-				const aiNodeAnim* pNodeAnim
-				  Pointer to an assimp node anim object
-	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	void Model::interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
-	{
-		if (pNodeAnim->mNumScalingKeys == 1)
-		{
-			outScale = ConvertVector3dToFloat3(pNodeAnim->mScalingKeys[0].mValue);
-			return;
-		}
-
-		UINT uScalingIndex = findScaling(animationTimeTicks, pNodeAnim);
-		UINT uNextScalingIndex = uScalingIndex + 1u;
-		assert(uNextScalingIndex < pNodeAnim->mNumScalingKeys);
-
-		FLOAT t1 = static_cast<FLOAT>(pNodeAnim->mScalingKeys[uScalingIndex].mTime);
-		FLOAT t2 = static_cast<FLOAT>(pNodeAnim->mScalingKeys[uNextScalingIndex].mTime);
-		FLOAT deltaTime = t2 - t1;
-		FLOAT factor = (animationTimeTicks - t1) / deltaTime;
-		assert(factor >= 0.0f && factor <= 1.0f);
-		const aiVector3D& start = pNodeAnim->mScalingKeys[uScalingIndex].mValue;
-		const aiVector3D& end = pNodeAnim->mScalingKeys[uNextScalingIndex].mValue;
-		aiVector3D delta = end - start;
-		outScale = ConvertVector3dToFloat3(start + factor * delta);
-	}
-
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Model::loadDiffuseTexture
 
 	  Summary:  Load a diffuse texture from given path
 
-	  Args:     ID3D11Device* pDevice
-				  The Direct3D device to create the buffers
-				ID3D11DeviceContext* pImmediateContext
-				  The Direct3D context to set buffers
-				const std::filesystem::path& parentDirectory
+	  Args:     const std::filesystem::path& parentDirectory
 				  Parent path to the model
 				const aiMaterial* pMaterial
 				  Pointer to an assimp material object
@@ -865,8 +1152,6 @@ namespace library
 				  Index to a material
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	HRESULT Model::loadDiffuseTexture(
-		_In_ ID3D11Device* pDevice,
-		_In_ ID3D11DeviceContext* pImmediateContext,
 		_In_ const std::filesystem::path& parentDirectory,
 		_In_ const aiMaterial* pMaterial,
 		_In_ UINT uIndex
@@ -890,19 +1175,10 @@ namespace library
 
 				std::filesystem::path fullPath = parentDirectory / szPath;
 
-				m_aMaterials[uIndex]->pDiffuse = std::make_shared<Texture>(fullPath);
-
-				hr = m_aMaterials[uIndex]->pDiffuse->Initialize(pDevice, pImmediateContext);
-				if (FAILED(hr))
-				{
-					OutputDebugString(L"Error loading diffuse texture \"");
-					OutputDebugString(fullPath.c_str());
-					OutputDebugString(L"\"\n");
-
-					return hr;
-				}
+				// The texture is created with the other device objects of the model
+				m_aMaterials[uIndex]->pDiffuse = TextureCache::GetInstance().GetOrCreate(fullPath);
 
-				OutputDebugString(L"Loaded diffuse texture \"");
+				OutputDebugString(L"Found diffuse texture \"");
 				OutputDebugString(fullPath.c_str());
 				OutputDebugString(L"\"\n");
 			}
@@ -916,11 +1192,7 @@ namespace library
 
 	  Summary:  Load a specular texture from given path
 
-	  Args:     ID3D11Device* pDevice
-				  The Direct3D device to create the buffers
-				ID3D11DeviceContext* pImmediateContext
-				  The Direct3D context to set buffers
-				const std::filesystem::path& parentDirectory
+	  Args:     const std::filesystem::path& parentDirectory
 				  Parent path to the model
 				const aiMaterial* pMaterial
 				  Pointer to an assimp material object
@@ -928,8 +1200,6 @@ namespace library
 				  Index to a material
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	HRESULT Model::loadSpecularTexture(
-		_In_ ID3D11Device* pDevice,
-		_In_ ID3D11DeviceContext* pImmediateContext,
 		_In_ const std::filesystem::path& parentDirectory,
 		_In_ const aiMaterial* pMaterial,
 		_In_ UINT uIndex
@@ -953,19 +1223,10 @@ namespace library
 
 				std::filesystem::path fullPath = parentDirectory / szPath;
 
-				m_aMaterials[uIndex]->pSpecularExponent = std::make_shared<Texture>(fullPath);
-
-				hr = m_aMaterials[uIndex]->pSpecularExponent->Initialize(pDevice, pImmediateContext);
-				if (FAILED(hr))
-				{
-					OutputDebugString(L"Error loading specular texture \"");
-					OutputDebugString(fullPath.c_str());
-					OutputDebugString(L"\"\n");
-
-					return hr;
-				}
+				// The texture is created with the other device objects of the model
+				m_aMaterials[uIndex]->pSpecularExponent = TextureCache::GetInstance().GetOrCreate(fullPath);
 
-				OutputDebugString(L"Loaded specular texture \"");
+				OutputDebugString(L"Found specular texture \"");
 				OutputDebugString(fullPath.c_str());
 				OutputDebugString(L"\"\n");
 			}
@@ -979,22 +1240,15 @@ namespace library
 
 	  Summary:  Load a normal texture from given path
 
-	  Args:     ID3D11Device* pDevice
-				  The Direct3D device to create the buffers
-				ID3D11DeviceContext* pImmediateContext
-				  The Direct3D context to set buffers
-				const std::filesystem::path& parentDirectory
+	  Args:     const std::filesystem::path& parentDirectory
 				  Parent path to the model
 				const aiMaterial* pMaterial
 				  Pointer to an assimp material object
 				UINT uIndex
 				  Index to a material
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Model::loadNormalTexture(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ const std::filesystem::path& parentDirectory, _In_ const aiMaterial* pMaterial, _In_ UINT uIndex)
+	HRESULT Model::loadNormalTexture(_In_ const std::filesystem::path& parentDirectory, _In_ const aiMaterial* pMaterial, _In_ UINT uIndex)
 	{
-		UNREFERENCED_PARAMETER(pDevice);
-		UNREFERENCED_PARAMETER(pImmediateContext);
-
 		HRESULT hr = S_OK;
 		m_aMaterials[uIndex]->pNormal = nullptr;
 
@@ -1013,7 +1267,7 @@ namespace library
 
 				std::filesystem::path fullPath = parentDirectory / szPath;
 
-				m_aMaterials[uIndex]->pNormal = std::make_shared<Texture>(fullPath);
+				m_aMaterials[uIndex]->pNormal = TextureCache::GetInstance().GetOrCreate(fullPath);
 				m_bHasNormalMap = true;
 
 				if (FAILED(hr))
@@ -1039,32 +1293,28 @@ namespace library
 
 	  Summary:  Load a specular texture from given path
 
-	  Args:     ID3D11Device* pDevice
-				  The Direct3D device to create the buffers
-				ID3D11DeviceContext* pImmediateContext
-				  The Direct3D context to set buffers
-				const std::filesystem::path& parentDirectory
+	  Args:     const std::filesystem::path& parentDirectory
 				  Parent path to the model
 				const aiMaterial* pMaterial
 				  Pointer to an assimp material object
 				UINT uIndex
 				  Index to a material
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Model::loadTextures(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ const std::filesystem::path& parentDirectory, _In_ const aiMaterial* pMaterial, _In_ UINT uIndex)
+	HRESULT Model::loadTextures(_In_ const std::filesystem::path& parentDirectory, _In_ const aiMaterial* pMaterial, _In_ UINT uIndex)
 	{
-		HRESULT hr = loadDiffuseTexture(pDevice, pImmediateContext, parentDirectory, pMaterial, uIndex);
+		HRESULT hr = loadDiffuseTexture(parentDirectory, pMaterial, uIndex);
 		if (FAILED(hr))
 		{
 			return hr;
 		}
 
-		hr = loadSpecularTexture(pDevice, pImmediateContext, parentDirectory, pMaterial, uIndex);
+		hr = loadSpecularTexture(parentDirectory, pMaterial, uIndex);
 		if (FAILED(hr))
 		{
 			return hr;
 		}
 
-		hr = loadNormalTexture(pDevice, pImmediateContext, parentDirectory, pMaterial, uIndex);
+		hr = loadNormalTexture(parentDirectory, pMaterial, uIndex);
 		if (FAILED(hr))
 		{
 			return hr;
@@ -1073,56 +1323,6 @@ namespace library
 		return hr;
 	}
 
-	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Model::readNodeHierarchy
-
-	  Summary:  Calculate bone transformation of the given assimp node
-
-	  Args:     FLOAT animationTimeTicks
-				  Animation time
-			   const aiNode* pNode
-				  Pointer to an assimp node object
-				const XMMATRIX& parentTransform
-				  Parent transform in hierarchy
-	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	void Model::readNodeHierarchy(
-		_In_ FLOAT animationTimeTicks,
-		_In_ const aiNode* pNode,
-		_In_ const XMMATRIX& parentTransform
-	)
-	{
-		XMMATRIX nodeTransform = ConvertMatrix(pNode->mTransformation);
-		const auto& anim = m_pScene->mAnimations[0];
-
-		const auto nodeAnim = findNodeAnimOrNull(anim, pNode->mName.C_Str());
-		if (nodeAnim) {
-			XMFLOAT3 vecScale = {};
-			XMVECTOR vecRot = {};
-			XMFLOAT3 vecTrans = {};
-			interpolateScaling(vecScale, animationTimeTicks, nodeAnim);
-			interpolateRotation(vecRot, animationTimeTicks, nodeAnim);
-			interpolatePosition(vecTrans, animationTimeTicks, nodeAnim);
-
-			const XMMATRIX matScale = XMMatrixScaling(vecScale.x, vecScale.y, vecScale.z);
-			const XMMATRIX matRot = XMMatrixRotationQuaternion(vecRot);
-			const XMMATRIX matTrans = XMMatrixTranslation(vecTrans.x, vecTrans.y, vecTrans.z);
-			nodeTransform = matScale * matRot * matTrans;
-		}
-		const XMMATRIX globalTransform = nodeTransform * parentTransform;
-		if (m_boneNameToIndexMap.contains(pNode->mName.C_Str()))
-		{
-			const UINT index = m_boneNameToIndexMap[pNode->mName.C_Str()];
-			auto& boneInfo = m_aBoneInfo[index];
-			boneInfo.FinalTransformation = boneInfo.OffsetMatrix * globalTransform * m_globalInverseTransform;
-		}
-
-		for (UINT i = 0u; i < pNode->mNumChildren; i++)
-		{
-			const auto& child = pNode->mChildren[i];
-			readNodeHierarchy(animationTimeTicks, child, globalTransform);
-		}
-	}
-
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Model::reserveSpace
 
@@ -1139,4 +1339,38 @@ namespace library
 		m_aIndices.reserve(uNumIndices);
 		m_aBoneData.resize(uNumVertices);
 	}
-}
\ No newline at end of file
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Model::skinVertices
+
+	  Summary:  Skins the bind pose vertices, tangents and bitangents
+				with the current palette on the job system, one job per
+				skinning range
+
+	  Modifies: [m_aSkinnedVertices, m_aSkinnedNormalData,
+				 m_bSkinnedVerticesDirty].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Model::skinVertices()
+	{
+		const Model& source = getSource();
+		if (m_aTransforms.empty() || source.m_aVertices.empty())
+		{
+			return;
+		}
+
+		m_aSkinnedVertices.resize(source.m_aVertices.size());
+		m_aSkinnedNormalData.resize(source.m_aNormalData.size());
+
+		SkinningEngine::SkinRanges(
+			source.m_aSkinningRanges,
+			source.m_aVertices.data(),
+			source.m_aNormalData.data(),
+			source.m_aAnimationData.data(),
+			m_aTransforms.data(),
+			m_aSkinnedVertices.data(),
+			m_aSkinnedNormalData.data()
+		);
+
+		m_bSkinnedVerticesDirty = TRUE;
+	}
+}
@@ -12,7 +12,10 @@
 #pragma once
 
 #include "Common.h"
+#include "Model/Skeleton.h"
+#include "Model/SkinningEngine.h"
 #include "Renderer/DataTypes.h"
+#include "Renderer/RenderDevice.h"
 #include "Renderer/Renderable.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
@@ -39,7 +42,22 @@ namespace library
 	  Summary:  Model class is a renderable from model files
 
 	  Methods:  Initialize
-				  Pure virtual function that initializes the object
+				  Initializes the model as an instance of the shared
+				  model of its file
+				Load
+				  Imports the file and creates the buffers and
+				  materials of a source model
+				Import
+				  Parses the file and builds the CPU side of a source
+				  model, callable from any thread
+				CreateDeviceObjects
+				  Creates the buffers and textures of an imported
+				  source model
+				InitializeInstance
+				  Initializes the model as an instance of a ready
+				  source model
+				IsReady
+				  Returns whether the model can be updated and drawn
 				Update
 				  Pure virtual function that updates the object each
 				  frame
@@ -57,6 +75,31 @@ namespace library
 				GetNumIndices
 				  Pure virtual function that returns the number of
 				  indices
+				SetCpuSkinning
+				  Enables skinning the vertices on the CPU each frame
+				IsCpuSkinned
+				  Returns whether the skinned vertex buffer replaces
+				  the bind pose vertex buffer
+				UploadSkinnedVertices
+				  Copies the skinned vertices of this frame to the
+				  skinned vertex buffer
+				GetSkinnedVertexBuffer
+				  Returns the skinned vertex buffer
+				GetSkinnedNormalBuffer
+				  Returns the skinned tangent and bitangent buffer
+				GetSkinnedVertices
+				  Returns the skinned vertices of this frame
+				GetSkinnedNormalData
+				  Returns the skinned tangents and bitangents of this
+				  frame
+				GetNumSharedCpuBytes
+				  Returns the geometry array bytes an instance shares
+				  with its source model
+				GetNumSharedGpuBytes
+				  Returns the geometry buffer bytes an instance shares
+				  with its source model
+				GetFilePath
+				  Returns the path to the model file
 				Model
 				  Constructor.
 				~Model
@@ -74,6 +117,11 @@ namespace library
 		~Model() override;
 
 		virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+		HRESULT Load(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+		HRESULT Import();
+		HRESULT CreateDeviceObjects(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+		HRESULT InitializeInstance(_In_ ID3D11Device* pDevice, _In_ const std::shared_ptr<Model>& source);
+		BOOL IsReady() const;
 		virtual void Update(_In_ FLOAT deltaTime) override;
 
 		ComPtr<ID3D11Buffer>& GetAnimationBuffer();
@@ -85,6 +133,17 @@ namespace library
 		std::vector<XMMATRIX>& GetBoneTransforms();
 		const std::unordered_map<std::string, UINT>& GetBoneNameToIndexMap() const;
 
+		void SetCpuSkinning(_In_ BOOL bEnable);
+		BOOL IsCpuSkinned() const;
+		HRESULT UploadSkinnedVertices(_In_ ID3D11Device* pDevice, _Inout_ IRenderContext& context);
+		ComPtr<ID3D11Buffer>& GetSkinnedVertexBuffer();
+		ComPtr<ID3D11Buffer>& GetSkinnedNormalBuffer();
+		const std::vector<SimpleVertex>& GetSkinnedVertices() const;
+		const std::vector<NormalData>& GetSkinnedNormalData() const;
+		SIZE_T GetNumSharedCpuBytes() const;
+		SIZE_T GetNumSharedGpuBytes() const;
+		const std::filesystem::path& GetFilePath() const;
+
 	protected:
 		struct VertexBoneData
 		{
@@ -104,7 +163,7 @@ namespace library
 				aBoneIds[uNumBones] = uBoneId;
 				aWeights[uNumBones] = weight;
 
-				static CHAR szDebugMessage[256];
+				CHAR szDebugMessage[256];
 				sprintf_s(szDebugMessage, "\t\t\tBone %d, weight: %f, index %u\n", uBoneId, weight, uNumBones);
 				OutputDebugStringA(szDebugMessage);
 
@@ -121,80 +180,60 @@ namespace library
 			BoneInfo() = default;
 			BoneInfo(const XMMATRIX& Offset)
 				: OffsetMatrix(Offset)
-				, FinalTransformation()
 			{
 			}
 
 			XMMATRIX OffsetMatrix;
-			XMMATRIX FinalTransformation;
 		};
 
 		void countVerticesAndIndices(_Inout_ UINT& uOutNumVertices, _Inout_ UINT& uOutNumIndices, _In_ const aiScene* pScene);
-		const aiNodeAnim* findNodeAnimOrNull(_In_ const aiAnimation* pAnimation, _In_ PCSTR pszNodeName);
-		UINT findPosition(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-		UINT findRotation(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-		UINT findScaling(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
+		void decodeTextures();
 		UINT getBoneId(_In_ const aiBone* pBone);
+		const Model& getSource() const;
 		const virtual SimpleVertex* getVertices() const override;
 		virtual const WORD* getIndices() const override;
 		void initAllMeshes(_In_ const aiScene* pScene);
-		HRESULT initFromScene(
-			_In_ ID3D11Device* pDevice,
-			_In_ ID3D11DeviceContext* pImmediateContext,
-			_In_ const aiScene* pScene,
-			_In_ const std::filesystem::path& filePath
-		);
-		HRESULT initMaterials(
-			_In_ ID3D11Device* pDevice,
-			_In_ ID3D11DeviceContext* pImmediateContext,
-			_In_ const aiScene* pScene,
-			_In_ const std::filesystem::path& filePath
-		);
+		HRESULT initFromScene(_In_ const aiScene* pScene, _In_ const std::filesystem::path& filePath);
+		HRESULT initMaterials(_In_ const aiScene* pScene, _In_ const std::filesystem::path& filePath);
 		void initMeshBones(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh);
 		void initMeshSingleBone(_In_ UINT uBoneIndex, _In_ const aiBone* pBone);
 		virtual void initSingleMesh(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh);
-		void interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-		void interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-		void interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
 		HRESULT loadDiffuseTexture(
-			_In_ ID3D11Device* pDevice,
-			_In_ ID3D11DeviceContext* pImmediateContext,
 			_In_ const std::filesystem::path& parentDirectory,
 			_In_ const aiMaterial* pMaterial,
 			_In_ UINT uIndex
 		);
 		HRESULT loadSpecularTexture(
-			_In_ ID3D11Device* pDevice,
-			_In_ ID3D11DeviceContext* pImmediateContext,
 			_In_ const std::filesystem::path& parentDirectory,
 			_In_ const aiMaterial* pMaterial,
 			_In_ UINT uIndex
 		);
 		HRESULT loadNormalTexture(
-			_In_ ID3D11Device* pDevice,
-			_In_ ID3D11DeviceContext* pImmediateContext,
 			_In_ const std::filesystem::path& parentDirectory,
 			_In_ const aiMaterial* pMaterial,
 			_In_ UINT uIndex
 		);
 		HRESULT loadTextures(
-			_In_ ID3D11Device* pDevice,
-			_In_ ID3D11DeviceContext* pImmediateContext,
 			_In_ const std::filesystem::path& parentDirectory,
 			_In_ const aiMaterial* pMaterial,
 			_In_ UINT uIndex
 		);
-		void readNodeHierarchy(_In_ FLOAT animationTimeTicks, _In_ const aiNode* pNode, _In_ const XMMATRIX& parentTransform);
 		void reserveSpace(_In_ UINT uNumVertices, _In_ UINT uNumIndices);
+		void skinVertices();
 
 	protected:
-		static std::unique_ptr<Assimp::Importer> sm_pImporter;
+		static constexpr UINT MAX_NUM_VERTICES_PER_SKINNING_JOB = 16384u;
+
+		static thread_local std::unique_ptr<Assimp::Importer> sm_pImporter;
 
 	protected:
 		std::filesystem::path m_filePath;
+		std::shared_ptr<Model> m_sourceModel;
 
 		ComPtr<ID3D11Buffer> m_animationBuffer;
 		ComPtr<ID3D11Buffer> m_skinningConstantBuffer;
+		ComPtr<ID3D11Buffer> m_skinnedVertexBuffer;
+		ComPtr<ID3D11Buffer> m_skinnedNormalBuffer;
 
 		std::vector<SimpleVertex> m_aVertices;
 		std::vector<AnimationData> m_aAnimationData;
@@ -203,11 +242,20 @@ namespace library
 		std::vector<BoneInfo> m_aBoneInfo;
 		std::vector<XMMATRIX> m_aTransforms;
 		std::unordered_map<std::string, UINT> m_boneNameToIndexMap;
+		std::shared_ptr<Skeleton> m_skeleton;
+		SkeletonPose m_pose;
+		std::vector<SimpleVertex> m_aSkinnedVertices;
+		std::vector<NormalData> m_aSkinnedNormalData;
+		std::vector<SkinningRange> m_aSkinningRanges;
 
 		const aiScene* m_pScene;
 
 		float m_timeSinceLoaded;
 
+		BOOL m_bCpuSkinning;
+		BOOL m_bSkinnedVerticesDirty;
+		BOOL m_bIsReady;
+
 		XMMATRIX m_globalInverseTransform;
 
 		//BYTE m_padding[8];
@@ -0,0 +1,373 @@
+#include "Model/ModelCache.h"
+
+#include <chrono>
+
+#include "Model/Model.h"
+
+namespace library
+{
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ModelCache::GetInstance
+
+	  Summary:  Returns the process-wide model cache
+
+	  Returns:  ModelCache&
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	ModelCache& ModelCache::GetInstance()
+	{
+		static ModelCache s_instance;
+		return s_instance;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ModelCache::ModelCache
+
+	  Summary:  Constructor
+
+	  Modifies: [m_mutex, m_entries, m_uNumLoads, m_uNumHits,
+				 m_loadSecondsSaved].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	ModelCache::ModelCache()
+		: m_mutex()
+		, m_entries()
+		, m_uNumLoads(0u)
+		, m_uNumHits(0u)
+		, m_loadSecondsSaved(0.0f)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ModelCache::GetOrLoad
+
+	  Summary:  Returns the source model of the file. The first request
+				imports the file and creates its buffers and materials,
+				later requests return the same object.
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the buffers
+				ID3D11DeviceContext* pImmediateContext
+				  The Direct3D context to set buffers
+				const std::filesystem::path& filePath
+				  Path to the model file
+				std::shared_ptr<Model>& outModel
+				  Source model of the file
+
+	  Modifies: [m_entries, m_uNumLoads, m_uNumHits,
+				 m_loadSecondsSaved].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT ModelCache::GetOrLoad(
+		_In_ ID3D11Device* pDevice,
+		_In_ ID3D11DeviceContext* pImmediateContext,
+		_In_ const std::filesystem::path& filePath,
+		_Out_ std::shared_ptr<Model>& outModel
+	)
+	{
+		HRESULT hr = GetOrImport(filePath, outModel);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		return outModel->CreateDeviceObjects(pDevice, pImmediateContext);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ModelCache::GetOrImport
+
+	  Summary:  Returns the source model of the file without creating
+				its device objects, so it may be called from the job
+				system. The first request registers the import under
+				the lock and runs it, concurrent requests for the same
+				file wait for its result. A failed import is forgotten
+				so a later request tries again.
+
+	  Args:     const std::filesystem::path& filePath
+				  Path to the model file
+				std::shared_ptr<Model>& outModel
+				  Imported source model of the file
+
+	  Modifies: [m_entries, m_uNumLoads, m_uNumHits,
+				 m_loadSecondsSaved].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT ModelCache::GetOrImport(
+		_In_ const std::filesystem::path& filePath,
+		_Out_ std::shared_ptr<Model>& outModel
+	)
+	{
+		std::wstring szKey = canonicalize(filePath);
+
+		std::promise<HRESULT> importPromise;
+		std::shared_future<HRESULT> import;
+		BOOL bIsImporter = FALSE;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			auto [it, bInserted] = m_entries.try_emplace(
+				szKey,
+				Entry
+				{
+					.Import = std::shared_future<HRESULT>(),
+					.Source = nullptr,
+					.LoadSeconds = 0.0f,
+					.uNumHits = 0u
+				}
+			);
+			if (bInserted)
+			{
+				it->second.Import = importPromise.get_future().share();
+				bIsImporter = TRUE;
+			}
+
+			import = it->second.Import;
+		}
+
+		if (!bIsImporter)
+		{
+			HRESULT hr = import.get();
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+
+				auto it = m_entries.find(szKey);
+				if (it != m_entries.end() && it->second.Source)
+				{
+					outModel = it->second.Source;
+					++it->second.uNumHits;
+					++m_uNumHits;
+					m_loadSecondsSaved += it->second.LoadSeconds;
+
+					return S_OK;
+				}
+			}
+
+			// Cleared while this request waited
+			return GetOrImport(filePath, outModel);
+		}
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		std::shared_ptr<Model> source = std::make_shared<Model>(filePath);
+		HRESULT hr = source->Import();
+
+		auto end = std::chrono::high_resolution_clock::now();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			// Clear skips imports in flight, so the entry is still here
+			auto it = m_entries.find(szKey);
+			assert(it != m_entries.end());
+
+			if (SUCCEEDED(hr))
+			{
+				it->second.Source = source;
+				it->second.LoadSeconds = std::chrono::duration<FLOAT>(end - start).count();
+				++m_uNumLoads;
+			}
+			else
+			{
+				m_entries.erase(it);
+			}
+		}
+
+		importPromise.set_value(hr);
+
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		outModel = source;
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ModelCache::Clear
+
+	  Summary:  Releases every imported source model. Instances keep
+				their source alive until they are destroyed, and
+				imports still in flight stay registered.
+
+	  Modifies: [m_entries].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void ModelCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		std::erase_if(m_entries, [](const auto& pair) { return pair.second.Source != nullptr; });
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ModelCache::ReportStatistics
+
+	  Summary:  Logs the number of imports and hits, and the memory and
+				load time that the hits did not spend
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void ModelCache::ReportStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		WCHAR szMessage[256];
+		swprintf_s(
+			szMessage,
+			L"ModelCache: %u file(s) loaded, %u hit(s), %.2f MB of geometry arrays, %.2f MB of geometry buffers and %.1f ms of loading saved\n",
+			m_uNumLoads,
+			m_uNumHits,
+			static_cast<FLOAT>(getNumCpuBytesSaved()) / (1024.0f * 1024.0f),
+			static_cast<FLOAT>(getNumGpuBytesSaved()) / (1024.0f * 1024.0f),
+			m_loadSecondsSaved * 1000.0f
+		);
+		OutputDebugString(szMessage);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ModelCache::GetNumLoads
+
+	  Summary:  Returns the number of files imported
+
+	  Returns:  UINT
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT ModelCache::GetNumLoads() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		return m_uNumLoads;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ModelCache::GetNumHits
+
+	  Summary:  Returns the number of requests served from the cache
+
+	  Returns:  UINT
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT ModelCache::GetNumHits() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		return m_uNumHits;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ModelCache::GetNumCpuBytesSaved
+
+	  Summary:  Returns the geometry array bytes that hits did not
+				allocate again
+
+	  Returns:  SIZE_T
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T ModelCache::GetNumCpuBytesSaved() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		return getNumCpuBytesSaved();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ModelCache::GetNumGpuBytesSaved
+
+	  Summary:  Returns the geometry buffer bytes that hits did not
+				allocate again
+
+	  Returns:  SIZE_T
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T ModelCache::GetNumGpuBytesSaved() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		return getNumGpuBytesSaved();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ModelCache::GetLoadSecondsSaved
+
+	  Summary:  Returns the load time that hits did not spend
+
+	  Returns:  FLOAT
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	FLOAT ModelCache::GetLoadSecondsSaved() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		return m_loadSecondsSaved;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ModelCache::canonicalize
+
+	  Summary:  Returns the key of a file path, so different spellings
+				of the same file share one entry
+
+	  Args:     const std::filesystem::path& filePath
+				  Path to the model file
+
+	  Returns:  std::wstring
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	std::wstring ModelCache::canonicalize(_In_ const std::filesystem::path& filePath)
+	{
+		std::error_code errorCode;
+		std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filePath, errorCode);
+		if (errorCode)
+		{
+			canonicalPath = filePath.lexically_normal();
+		}
+
+		return canonicalPath.wstring();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ModelCache::getNumCpuBytesSaved
+
+	  Summary:  Sums the geometry array bytes of every imported source
+				times its hits. The caller holds the mutex.
+
+	  Returns:  SIZE_T
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T ModelCache::getNumCpuBytesSaved() const
+	{
+		SIZE_T uNumBytes = 0u;
+		for (const auto& pair : m_entries)
+		{
+			if (pair.second.Source)
+			{
+				uNumBytes += pair.second.Source->GetNumSharedCpuBytes() * pair.second.uNumHits;
+			}
+		}
+
+		return uNumBytes;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ModelCache::getNumGpuBytesSaved
+
+	  Summary:  Sums the geometry buffer bytes of every imported source
+				times its hits. Sources whose device objects are not
+				created yet count as zero. The caller holds the mutex.
+
+	  Returns:  SIZE_T
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T ModelCache::getNumGpuBytesSaved() const
+	{
+		SIZE_T uNumBytes = 0u;
+		for (const auto& pair : m_entries)
+		{
+			if (pair.second.Source)
+			{
+				uNumBytes += pair.second.Source->GetNumSharedGpuBytes() * pair.second.uNumHits;
+			}
+		}
+
+		return uNumBytes;
+	}
+}
@@ -0,0 +1,115 @@
+/*+===================================================================
+  File:      MODELCACHE.H
+
+  Summary:   ModelCache header file contains declarations of
+			 ModelCache class that loads each model file once and
+			 shares it between every model placed from that file.
+
+  Classes: ModelCache
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <future>
+#include <mutex>
+
+namespace library
+{
+	class Model;
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    ModelCache
+
+	  Summary:  Keeps one fully loaded source model per canonical file
+				path. Models placed in a scene become lightweight
+				instances of the source: they share its geometry,
+				buffers, materials and skeleton, and only own their
+				world matrix, animation state and constant buffers.
+				Requests for a file that is still being imported wait
+				for that import instead of starting another one.
+
+	  Methods:  GetInstance
+				  Returns the process-wide model cache
+				GetOrLoad
+				  Returns the source model of the file, loading it on
+				  the first request
+				GetOrImport
+				  Returns the source model of the file, importing it
+				  without device objects on the first request
+				Clear
+				  Releases every source model
+				ReportStatistics
+				  Logs loads, hits and the memory and time saved
+				GetNumLoads
+				  Returns the number of files imported
+				GetNumHits
+				  Returns the number of requests served from the cache
+				GetNumCpuBytesSaved
+				  Returns the geometry array bytes not duplicated by
+				  hits
+				GetNumGpuBytesSaved
+				  Returns the geometry buffer bytes not duplicated by
+				  hits
+				GetLoadSecondsSaved
+				  Returns the load time not spent thanks to hits
+				ModelCache
+				  Constructor.
+				~ModelCache
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class ModelCache final
+	{
+	public:
+		static ModelCache& GetInstance();
+
+		ModelCache();
+		ModelCache(const ModelCache& other) = delete;
+		ModelCache(ModelCache&& other) = delete;
+		ModelCache& operator=(const ModelCache& other) = delete;
+		ModelCache& operator=(ModelCache&& other) = delete;
+		~ModelCache() = default;
+
+		HRESULT GetOrLoad(
+			_In_ ID3D11Device* pDevice,
+			_In_ ID3D11DeviceContext* pImmediateContext,
+			_In_ const std::filesystem::path& filePath,
+			_Out_ std::shared_ptr<Model>& outModel
+		);
+		HRESULT GetOrImport(
+			_In_ const std::filesystem::path& filePath,
+			_Out_ std::shared_ptr<Model>& outModel
+		);
+		void Clear();
+		void ReportStatistics() const;
+
+		UINT GetNumLoads() const;
+		UINT GetNumHits() const;
+		SIZE_T GetNumCpuBytesSaved() const;
+		SIZE_T GetNumGpuBytesSaved() const;
+		FLOAT GetLoadSecondsSaved() const;
+
+	private:
+		struct Entry
+		{
+			std::shared_future<HRESULT> Import;
+			std::shared_ptr<Model> Source;
+			FLOAT LoadSeconds;
+			UINT uNumHits;
+		};
+
+		static std::wstring canonicalize(_In_ const std::filesystem::path& filePath);
+
+		SIZE_T getNumCpuBytesSaved() const;
+		SIZE_T getNumGpuBytesSaved() const;
+
+	private:
+		mutable std::mutex m_mutex;
+		std::unordered_map<std::wstring, Entry> m_entries;
+		UINT m_uNumLoads;
+		UINT m_uNumHits;
+		FLOAT m_loadSecondsSaved;
+	};
+}
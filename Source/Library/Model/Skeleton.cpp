@@ -0,0 +1,610 @@
+#include "Model/Skeleton.h"
+
+#include <algorithm>
+#include <immintrin.h>
+
+#include "assimp/scene.h"		    // output data structure
+
+namespace library
+{
+	XMMATRIX ConvertMatrix(_In_ const aiMatrix4x4& matrix);
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: findKey
+
+	  Summary:  Find the index of the key right before the given
+				animation time, starting from the cached cursor when
+				the time did not go backwards
+
+	  Args:     FLOAT animationTimeTicks
+				  Animation time
+				const KEY* aKeys
+				  Keys of a channel
+				UINT uNumKeys
+				  Number of keys
+				UINT& uCursor
+				  Index returned by the previous call
+
+	  Returns:  UINT
+				  Index of the key
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	template <class KEY>
+	UINT findKey(_In_ FLOAT animationTimeTicks, _In_reads_(uNumKeys) const KEY* aKeys, _In_ UINT uNumKeys, _Inout_ UINT& uCursor)
+	{
+		UINT uStart = uCursor;
+		if (uStart >= uNumKeys || animationTimeTicks < static_cast<FLOAT>(aKeys[uStart].mTime))
+		{
+			uStart = 0u;
+		}
+
+		for (UINT i = uStart; i < uNumKeys - 1u; ++i)
+		{
+			if (animationTimeTicks < static_cast<FLOAT>(aKeys[i + 1u].mTime))
+			{
+				uCursor = i;
+				return i;
+			}
+		}
+
+		uCursor = 0u;
+		return 0u;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: keyFactor
+
+	  Summary:  Returns the interpolation factor between two keys
+
+	  Returns:  FLOAT
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	template <class KEY>
+	FLOAT keyFactor(_In_ FLOAT animationTimeTicks, _In_ const KEY& start, _In_ const KEY& end)
+	{
+		FLOAT t1 = static_cast<FLOAT>(start.mTime);
+		FLOAT t2 = static_cast<FLOAT>(end.mTime);
+		FLOAT factor = (animationTimeTicks - t1) / (t2 - t1);
+		assert(factor >= 0.0f && factor <= 1.0f);
+
+		return factor;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: composeBatch4
+
+	  Summary:  Builds scale * rotation * translation matrices of four
+				channels at once. The quaternion to matrix conversion
+				runs on the structure of arrays streams and four
+				transposes turn the lanes into matrix rows.
+
+	  Args:     const FLOAT* pTx, pTy, pTz
+				  Translation streams
+				const FLOAT* pQx, pQy, pQz, pQw
+				  Rotation streams
+				const FLOAT* pSx, pSy, pSz
+				  Scale streams
+				XMMATRIX* aOutMatrices
+				  Four output matrices
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	void composeBatch4(
+		_In_reads_(4) const FLOAT* pTx, _In_reads_(4) const FLOAT* pTy, _In_reads_(4) const FLOAT* pTz,
+		_In_reads_(4) const FLOAT* pQx, _In_reads_(4) const FLOAT* pQy, _In_reads_(4) const FLOAT* pQz, _In_reads_(4) const FLOAT* pQw,
+		_In_reads_(4) const FLOAT* pSx, _In_reads_(4) const FLOAT* pSy, _In_reads_(4) const FLOAT* pSz,
+		_Out_writes_(4) XMMATRIX* aOutMatrices
+	)
+	{
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 two = _mm_set1_ps(2.0f);
+
+		__m128 qx = _mm_loadu_ps(pQx);
+		__m128 qy = _mm_loadu_ps(pQy);
+		__m128 qz = _mm_loadu_ps(pQz);
+		__m128 qw = _mm_loadu_ps(pQw);
+
+		__m128 x2 = _mm_mul_ps(qx, two);
+		__m128 y2 = _mm_mul_ps(qy, two);
+		__m128 z2 = _mm_mul_ps(qz, two);
+
+		__m128 xx = _mm_mul_ps(qx, x2);
+		__m128 yy = _mm_mul_ps(qy, y2);
+		__m128 zz = _mm_mul_ps(qz, z2);
+		__m128 xy = _mm_mul_ps(qx, y2);
+		__m128 xz = _mm_mul_ps(qx, z2);
+		__m128 yz = _mm_mul_ps(qy, z2);
+		__m128 wx = _mm_mul_ps(qw, x2);
+		__m128 wy = _mm_mul_ps(qw, y2);
+		__m128 wz = _mm_mul_ps(qw, z2);
+
+		__m128 sx = _mm_loadu_ps(pSx);
+		__m128 sy = _mm_loadu_ps(pSy);
+		__m128 sz = _mm_loadu_ps(pSz);
+
+		__m128 m00 = _mm_mul_ps(sx, _mm_sub_ps(one, _mm_add_ps(yy, zz)));
+		__m128 m01 = _mm_mul_ps(sx, _mm_add_ps(xy, wz));
+		__m128 m02 = _mm_mul_ps(sx, _mm_sub_ps(xz, wy));
+		__m128 m03 = _mm_setzero_ps();
+
+		__m128 m10 = _mm_mul_ps(sy, _mm_sub_ps(xy, wz));
+		__m128 m11 = _mm_mul_ps(sy, _mm_sub_ps(one, _mm_add_ps(xx, zz)));
+		__m128 m12 = _mm_mul_ps(sy, _mm_add_ps(yz, wx));
+		__m128 m13 = _mm_setzero_ps();
+
+		__m128 m20 = _mm_mul_ps(sz, _mm_add_ps(xz, wy));
+		__m128 m21 = _mm_mul_ps(sz, _mm_sub_ps(yz, wx));
+		__m128 m22 = _mm_mul_ps(sz, _mm_sub_ps(one, _mm_add_ps(xx, yy)));
+		__m128 m23 = _mm_setzero_ps();
+
+		__m128 m30 = _mm_loadu_ps(pTx);
+		__m128 m31 = _mm_loadu_ps(pTy);
+		__m128 m32 = _mm_loadu_ps(pTz);
+		__m128 m33 = one;
+
+		_MM_TRANSPOSE4_PS(m00, m01, m02, m03);
+		_MM_TRANSPOSE4_PS(m10, m11, m12, m13);
+		_MM_TRANSPOSE4_PS(m20, m21, m22, m23);
+		_MM_TRANSPOSE4_PS(m30, m31, m32, m33);
+
+		aOutMatrices[0].r[0] = m00; aOutMatrices[0].r[1] = m10; aOutMatrices[0].r[2] = m20; aOutMatrices[0].r[3] = m30;
+		aOutMatrices[1].r[0] = m01; aOutMatrices[1].r[1] = m11; aOutMatrices[1].r[2] = m21; aOutMatrices[1].r[3] = m31;
+		aOutMatrices[2].r[0] = m02; aOutMatrices[2].r[1] = m12; aOutMatrices[2].r[2] = m22; aOutMatrices[2].r[3] = m32;
+		aOutMatrices[3].r[0] = m03; aOutMatrices[3].r[1] = m13; aOutMatrices[3].r[2] = m23; aOutMatrices[3].r[3] = m33;
+	}
+
+#if defined(__AVX__)
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: composeBatch8
+
+	  Summary:  Eight wide version of composeBatch4 used when the
+				library is compiled with /arch:AVX or later, as the
+				project files do. The arithmetic runs on 256-bit
+				registers and each 128-bit half is transposed into
+				four matrices.
+
+	  Args:     Same as composeBatch4 with eight lanes per stream
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	void composeBatch8(
+		_In_reads_(8) const FLOAT* pTx, _In_reads_(8) const FLOAT* pTy, _In_reads_(8) const FLOAT* pTz,
+		_In_reads_(8) const FLOAT* pQx, _In_reads_(8) const FLOAT* pQy, _In_reads_(8) const FLOAT* pQz, _In_reads_(8) const FLOAT* pQw,
+		_In_reads_(8) const FLOAT* pSx, _In_reads_(8) const FLOAT* pSy, _In_reads_(8) const FLOAT* pSz,
+		_Out_writes_(8) XMMATRIX* aOutMatrices
+	)
+	{
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 two = _mm256_set1_ps(2.0f);
+
+		__m256 qx = _mm256_loadu_ps(pQx);
+		__m256 qy = _mm256_loadu_ps(pQy);
+		__m256 qz = _mm256_loadu_ps(pQz);
+		__m256 qw = _mm256_loadu_ps(pQw);
+
+		__m256 x2 = _mm256_mul_ps(qx, two);
+		__m256 y2 = _mm256_mul_ps(qy, two);
+		__m256 z2 = _mm256_mul_ps(qz, two);
+
+		__m256 xx = _mm256_mul_ps(qx, x2);
+		__m256 yy = _mm256_mul_ps(qy, y2);
+		__m256 zz = _mm256_mul_ps(qz, z2);
+		__m256 xy = _mm256_mul_ps(qx, y2);
+		__m256 xz = _mm256_mul_ps(qx, z2);
+		__m256 yz = _mm256_mul_ps(qy, z2);
+		__m256 wx = _mm256_mul_ps(qw, x2);
+		__m256 wy = _mm256_mul_ps(qw, y2);
+		__m256 wz = _mm256_mul_ps(qw, z2);
+
+		__m256 sx = _mm256_loadu_ps(pSx);
+		__m256 sy = _mm256_loadu_ps(pSy);
+		__m256 sz = _mm256_loadu_ps(pSz);
+
+		__m256 aRows[12] =
+		{
+			_mm256_mul_ps(sx, _mm256_sub_ps(one, _mm256_add_ps(yy, zz))),
+			_mm256_mul_ps(sx, _mm256_add_ps(xy, wz)),
+			_mm256_mul_ps(sx, _mm256_sub_ps(xz, wy)),
+			_mm256_mul_ps(sy, _mm256_sub_ps(xy, wz)),
+			_mm256_mul_ps(sy, _mm256_sub_ps(one, _mm256_add_ps(xx, zz))),
+			_mm256_mul_ps(sy, _mm256_add_ps(yz, wx)),
+			_mm256_mul_ps(sz, _mm256_add_ps(xz, wy)),
+			_mm256_mul_ps(sz, _mm256_sub_ps(yz, wx)),
+			_mm256_mul_ps(sz, _mm256_sub_ps(one, _mm256_add_ps(xx, yy))),
+			_mm256_loadu_ps(pTx),
+			_mm256_loadu_ps(pTy),
+			_mm256_loadu_ps(pTz),
+		};
+
+		for (UINT uHalf = 0u; uHalf < 2u; ++uHalf)
+		{
+			__m128 aHalves[12];
+			for (UINT i = 0u; i < 12u; ++i)
+			{
+				aHalves[i] = uHalf == 0u ? _mm256_castps256_ps128(aRows[i]) : _mm256_extractf128_ps(aRows[i], 1);
+			}
+
+			XMMATRIX* aMatrices = aOutMatrices + uHalf * 4u;
+			for (UINT uRow = 0u; uRow < 4u; ++uRow)
+			{
+				__m128 c0 = aHalves[uRow * 3u];
+				__m128 c1 = aHalves[uRow * 3u + 1u];
+				__m128 c2 = aHalves[uRow * 3u + 2u];
+				__m128 c3 = uRow == 3u ? _mm_set1_ps(1.0f) : _mm_setzero_ps();
+
+				_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+				aMatrices[0].r[uRow] = c0;
+				aMatrices[1].r[uRow] = c1;
+				aMatrices[2].r[uRow] = c2;
+				aMatrices[3].r[uRow] = c3;
+			}
+		}
+	}
+#endif
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Skeleton::Skeleton
+
+	  Summary:  Constructor
+
+	  Modifies: [m_aParentIndices, m_aBoneIndices, m_aBindTransforms,
+				 m_aAnimatedNodes, m_aChannels, m_aBoneOffsets,
+				 m_uNumPaddedChannels, m_globalInverseTransform].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	Skeleton::Skeleton()
+		: m_aParentIndices()
+		, m_aBoneIndices()
+		, m_aBindTransforms()
+		, m_aAnimatedNodes()
+		, m_aChannels()
+		, m_aBoneOffsets()
+		, m_uNumPaddedChannels(0u)
+		, m_globalInverseTransform(XMMatrixIdentity())
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Skeleton::Initialize
+
+	  Summary:  Flattens the node hierarchy so every parent comes
+				before its children, and resolves the bone index and
+				the animation channel of every node once
+
+	  Args:     const aiScene* pScene
+				  Assimp scene that owns the hierarchy
+				const std::unordered_map<std::string, UINT>& boneNameToIndexMap
+				  Bone index of each bone node name
+				const std::vector<XMMATRIX>& aBoneOffsets
+				  Offset matrix of each bone
+				const XMMATRIX& globalInverseTransform
+				  Inverse of the root transform
+
+	  Modifies: [m_aParentIndices, m_aBoneIndices, m_aBindTransforms,
+				 m_aAnimatedNodes, m_aChannels, m_aBoneOffsets,
+				 m_uNumPaddedChannels, m_globalInverseTransform].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Skeleton::Initialize(
+		_In_ const aiScene* pScene,
+		_In_ const std::unordered_map<std::string, UINT>& boneNameToIndexMap,
+		_In_ const std::vector<XMMATRIX>& aBoneOffsets,
+		_In_ const XMMATRIX& globalInverseTransform
+	)
+	{
+		if (!pScene || !pScene->mRootNode)
+		{
+			return E_INVALIDARG;
+		}
+
+		const aiAnimation* pAnimation = pScene->HasAnimations() ? pScene->mAnimations[0] : nullptr;
+
+		m_aParentIndices.clear();
+		m_aBoneIndices.clear();
+		m_aBindTransforms.clear();
+		m_aAnimatedNodes.clear();
+		m_aChannels.clear();
+		m_aBoneOffsets = aBoneOffsets;
+		m_globalInverseTransform = globalInverseTransform;
+
+		std::vector<std::pair<const aiNode*, INT>> aStack;
+		aStack.push_back({ pScene->mRootNode, -1 });
+
+		while (!aStack.empty())
+		{
+			auto [pNode, iParent] = aStack.back();
+			aStack.pop_back();
+
+			UINT uNodeIndex = static_cast<UINT>(m_aParentIndices.size());
+			m_aParentIndices.push_back(iParent);
+			m_aBindTransforms.push_back(ConvertMatrix(pNode->mTransformation));
+
+			auto itBone = boneNameToIndexMap.find(pNode->mName.C_Str());
+			m_aBoneIndices.push_back(itBone != boneNameToIndexMap.end() ? static_cast<INT>(itBone->second) : -1);
+
+			const aiNodeAnim* pNodeAnim = pAnimation ? findNodeAnimOrNull(pAnimation, pNode->mName.C_Str()) : nullptr;
+			if (pNodeAnim)
+			{
+				m_aAnimatedNodes.push_back(uNodeIndex);
+				m_aChannels.push_back(pNodeAnim);
+			}
+
+			// Push in reverse so children are visited in their original order
+			for (UINT i = pNode->mNumChildren; i > 0u; --i)
+			{
+				aStack.push_back({ pNode->mChildren[i - 1u], static_cast<INT>(uNodeIndex) });
+			}
+		}
+
+		UINT uNumChannels = static_cast<UINT>(m_aChannels.size());
+		m_uNumPaddedChannels = (uNumChannels + SIMD_WIDTH - 1u) / SIMD_WIDTH * SIMD_WIDTH;
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Skeleton::InitializePose
+
+	  Summary:  Allocates the scratch of one animated instance. Padding
+				lanes hold an identity channel so the SIMD kernel never
+				reads garbage.
+
+	  Args:     SkeletonPose& outPose
+				  Pose to allocate
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Skeleton::InitializePose(_Out_ SkeletonPose& outPose) const
+	{
+		outPose.aTranslationX.assign(m_uNumPaddedChannels, 0.0f);
+		outPose.aTranslationY.assign(m_uNumPaddedChannels, 0.0f);
+		outPose.aTranslationZ.assign(m_uNumPaddedChannels, 0.0f);
+		outPose.aRotationX.assign(m_uNumPaddedChannels, 0.0f);
+		outPose.aRotationY.assign(m_uNumPaddedChannels, 0.0f);
+		outPose.aRotationZ.assign(m_uNumPaddedChannels, 0.0f);
+		outPose.aRotationW.assign(m_uNumPaddedChannels, 1.0f);
+		outPose.aScaleX.assign(m_uNumPaddedChannels, 1.0f);
+		outPose.aScaleY.assign(m_uNumPaddedChannels, 1.0f);
+		outPose.aScaleZ.assign(m_uNumPaddedChannels, 1.0f);
+		outPose.aKeyCursors.assign(m_aChannels.size() * 3u, 0u);
+		outPose.aLocalTransforms = m_aBindTransforms;
+		outPose.aGlobalTransforms.resize(m_aBindTransforms.size());
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Skeleton::ComputePalette
+
+	  Summary:  Samples every channel, builds the local transforms with
+				SIMD, accumulates the global transforms in flattened
+				order and writes offset * global * globalInverse of
+				every bone. The global inverse is applied at the root
+				so it is shared by the whole hierarchy.
+
+	  Args:     FLOAT animationTimeTicks
+				  Animation time
+				SkeletonPose& pose
+				  Per instance scratch from InitializePose
+				XMMATRIX* aOutPalette
+				  Bone palette, GetNumBones() matrices
+
+	  Modifies: [pose].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Skeleton::ComputePalette(_In_ FLOAT animationTimeTicks, _Inout_ SkeletonPose& pose, _Out_writes_(GetNumBones()) XMMATRIX* aOutPalette) const
+	{
+		assert(pose.aLocalTransforms.size() == m_aBindTransforms.size());
+
+		sampleChannels(animationTimeTicks, pose);
+		composeLocalTransforms(pose);
+
+		UINT uNumNodes = static_cast<UINT>(m_aParentIndices.size());
+		for (UINT i = 0u; i < uNumNodes; ++i)
+		{
+			INT iParent = m_aParentIndices[i];
+			const XMMATRIX& parentTransform = iParent < 0 ? m_globalInverseTransform : pose.aGlobalTransforms[iParent];
+			pose.aGlobalTransforms[i] = XMMatrixMultiply(pose.aLocalTransforms[i], parentTransform);
+
+			INT iBone = m_aBoneIndices[i];
+			if (iBone >= 0)
+			{
+				aOutPalette[iBone] = XMMatrixMultiply(m_aBoneOffsets[iBone], pose.aGlobalTransforms[i]);
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Skeleton::GetNumNodes
+
+	  Summary:  Returns the number of nodes
+
+	  Returns:  UINT
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Skeleton::GetNumNodes() const
+	{
+		return static_cast<UINT>(m_aParentIndices.size());
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Skeleton::GetNumAnimatedNodes
+
+	  Summary:  Returns the number of nodes driven by a channel
+
+	  Returns:  UINT
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Skeleton::GetNumAnimatedNodes() const
+	{
+		return static_cast<UINT>(m_aAnimatedNodes.size());
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Skeleton::GetNumBones
+
+	  Summary:  Returns the number of bones
+
+	  Returns:  UINT
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Skeleton::GetNumBones() const
+	{
+		return static_cast<UINT>(m_aBoneOffsets.size());
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Skeleton::GetNumBytes
+
+	  Summary:  Returns the bytes of the flattened hierarchy, channel
+				and bone offset tables every instance shares
+
+	  Returns:  SIZE_T
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T Skeleton::GetNumBytes() const
+	{
+		return m_aParentIndices.size() * sizeof(INT) +
+			m_aBoneIndices.size() * sizeof(INT) +
+			m_aBindTransforms.size() * sizeof(XMMATRIX) +
+			m_aAnimatedNodes.size() * sizeof(UINT) +
+			m_aChannels.size() * sizeof(const aiNodeAnim*) +
+			m_aBoneOffsets.size() * sizeof(XMMATRIX);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Skeleton::HasAnimation
+
+	  Summary:  Returns whether any node is driven by a channel
+
+	  Returns:  BOOL
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL Skeleton::HasAnimation() const
+	{
+		return !m_aChannels.empty();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Skeleton::composeLocalTransforms
+
+	  Summary:  Converts the sampled channels into the local transforms
+				of the animated nodes, SIMD_WIDTH channels at a time
+
+	  Args:     SkeletonPose& pose
+				  Pose with sampled channels
+
+	  Modifies: [pose.aLocalTransforms].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Skeleton::composeLocalTransforms(_Inout_ SkeletonPose& pose) const
+	{
+		UINT uNumChannels = static_cast<UINT>(m_aChannels.size());
+		XMMATRIX aBatch[SIMD_WIDTH];
+
+		for (UINT uBase = 0u; uBase < uNumChannels; uBase += SIMD_WIDTH)
+		{
+#if defined(__AVX__)
+			composeBatch8(
+				&pose.aTranslationX[uBase], &pose.aTranslationY[uBase], &pose.aTranslationZ[uBase],
+				&pose.aRotationX[uBase], &pose.aRotationY[uBase], &pose.aRotationZ[uBase], &pose.aRotationW[uBase],
+				&pose.aScaleX[uBase], &pose.aScaleY[uBase], &pose.aScaleZ[uBase],
+				aBatch
+			);
+#else
+			for (UINT uOffset = 0u; uOffset < SIMD_WIDTH; uOffset += 4u)
+			{
+				UINT i = uBase + uOffset;
+				composeBatch4(
+					&pose.aTranslationX[i], &pose.aTranslationY[i], &pose.aTranslationZ[i],
+					&pose.aRotationX[i], &pose.aRotationY[i], &pose.aRotationZ[i], &pose.aRotationW[i],
+					&pose.aScaleX[i], &pose.aScaleY[i], &pose.aScaleZ[i],
+					aBatch + uOffset
+				);
+			}
+#endif
+
+			UINT uNumLanes = std::min<UINT>(SIMD_WIDTH, uNumChannels - uBase);
+			for (UINT uLane = 0u; uLane < uNumLanes; ++uLane)
+			{
+				pose.aLocalTransforms[m_aAnimatedNodes[uBase + uLane]] = aBatch[uLane];
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Skeleton::sampleChannels
+
+	  Summary:  Interpolates the scaling, rotation and translation keys
+				of every channel into the structure of arrays streams
+
+	  Args:     FLOAT animationTimeTicks
+				  Animation time
+				SkeletonPose& pose
+				  Pose to fill
+
+	  Modifies: [pose].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Skeleton::sampleChannels(_In_ FLOAT animationTimeTicks, _Inout_ SkeletonPose& pose) const
+	{
+		UINT uNumChannels = static_cast<UINT>(m_aChannels.size());
+
+		for (UINT i = 0u; i < uNumChannels; ++i)
+		{
+			const aiNodeAnim* pNodeAnim = m_aChannels[i];
+			UINT* aCursors = &pose.aKeyCursors[i * 3u];
+
+			aiVector3D scale = pNodeAnim->mScalingKeys[0].mValue;
+			if (pNodeAnim->mNumScalingKeys > 1u)
+			{
+				UINT uKey = findKey(animationTimeTicks, pNodeAnim->mScalingKeys, pNodeAnim->mNumScalingKeys, aCursors[0]);
+				const aiVectorKey& start = pNodeAnim->mScalingKeys[uKey];
+				const aiVectorKey& end = pNodeAnim->mScalingKeys[uKey + 1u];
+				scale = start.mValue + keyFactor(animationTimeTicks, start, end) * (end.mValue - start.mValue);
+			}
+
+			aiQuaternion rotation = pNodeAnim->mRotationKeys[0].mValue;
+			if (pNodeAnim->mNumRotationKeys > 1u)
+			{
+				UINT uKey = findKey(animationTimeTicks, pNodeAnim->mRotationKeys, pNodeAnim->mNumRotationKeys, aCursors[1]);
+				const aiQuatKey& start = pNodeAnim->mRotationKeys[uKey];
+				const aiQuatKey& end = pNodeAnim->mRotationKeys[uKey + 1u];
+				aiQuaternion::Interpolate(rotation, start.mValue, end.mValue, keyFactor(animationTimeTicks, start, end));
+			}
+
+			aiVector3D translation = pNodeAnim->mPositionKeys[0].mValue;
+			if (pNodeAnim->mNumPositionKeys > 1u)
+			{
+				UINT uKey = findKey(animationTimeTicks, pNodeAnim->mPositionKeys, pNodeAnim->mNumPositionKeys, aCursors[2]);
+				const aiVectorKey& start = pNodeAnim->mPositionKeys[uKey];
+				const aiVectorKey& end = pNodeAnim->mPositionKeys[uKey + 1u];
+				translation = start.mValue + keyFactor(animationTimeTicks, start, end) * (end.mValue - start.mValue);
+			}
+
+			pose.aScaleX[i] = scale.x;
+			pose.aScaleY[i] = scale.y;
+			pose.aScaleZ[i] = scale.z;
+			pose.aRotationX[i] = rotation.x;
+			pose.aRotationY[i] = rotation.y;
+			pose.aRotationZ[i] = rotation.z;
+			pose.aRotationW[i] = rotation.w;
+			pose.aTranslationX[i] = translation.x;
+			pose.aTranslationY[i] = translation.y;
+			pose.aTranslationZ[i] = translation.z;
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Skeleton::findNodeAnimOrNull
+
+	  Summary:  Find the aiNodeAnim with the given node name in the
+				given animation, comparing as many characters as the
+				channel name holds
+
+	  Args:     const aiAnimation* pAnimation
+				  Pointer to an assimp animation object
+				PCSTR pszNodeName
+				  Node name to find
+
+	  Returns:  aiNodeAnim* or nullptr
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const aiNodeAnim* Skeleton::findNodeAnimOrNull(_In_ const aiAnimation* pAnimation, _In_ PCSTR pszNodeName)
+	{
+		for (UINT i = 0u; i < pAnimation->mNumChannels; ++i)
+		{
+			const aiNodeAnim* pNodeAnim = pAnimation->mChannels[i];
+
+			if (strncmp(pNodeAnim->mNodeName.data, pszNodeName, pNodeAnim->mNodeName.length) == 0)
+			{
+				return pNodeAnim;
+			}
+		}
+
+		return nullptr;
+	}
+}
@@ -0,0 +1,123 @@
+/*+===================================================================
+  File:      SKELETON.H
+
+  Summary:   Skeleton header file contains declarations of Skeleton
+			 class that computes the bone palette of an animated
+			 model from a flattened node hierarchy.
+
+  Classes: Skeleton
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+struct aiScene;
+struct aiNode;
+struct aiAnimation;
+struct aiNodeAnim;
+
+namespace library
+{
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   SkeletonPose
+
+		Summary:  Per instance scratch of a skeleton. Sampled channels
+				  are stored as structure of arrays, one stream per
+				  component, padded to a multiple of the SIMD width.
+				  Key cursors remember the last key used by each
+				  channel so sampling does not rescan the keys.
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct SkeletonPose
+	{
+		std::vector<FLOAT> aTranslationX;
+		std::vector<FLOAT> aTranslationY;
+		std::vector<FLOAT> aTranslationZ;
+		std::vector<FLOAT> aRotationX;
+		std::vector<FLOAT> aRotationY;
+		std::vector<FLOAT> aRotationZ;
+		std::vector<FLOAT> aRotationW;
+		std::vector<FLOAT> aScaleX;
+		std::vector<FLOAT> aScaleY;
+		std::vector<FLOAT> aScaleZ;
+		std::vector<UINT> aKeyCursors;
+		std::vector<XMMATRIX> aLocalTransforms;
+		std::vector<XMMATRIX> aGlobalTransforms;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    Skeleton
+
+	  Summary:  Node hierarchy of a model flattened in parent before
+				child order. Animation channels are resolved once at
+				load time, local transforms of animated nodes are
+				built several at a time with SIMD and the global
+				inverse transform is folded into the root so each bone
+				costs a single matrix multiply.
+
+	  Methods:  Initialize
+				  Flattens the hierarchy and resolves the channels
+				InitializePose
+				  Allocates the per instance scratch
+				ComputePalette
+				  Samples the animation and writes the bone palette
+				GetNumNodes
+				  Returns the number of nodes
+				GetNumAnimatedNodes
+				  Returns the number of nodes with a channel
+				GetNumBones
+				  Returns the number of bones
+				GetNumBytes
+				  Returns the bytes of the flattened tables
+				HasAnimation
+				  Returns whether the skeleton has an animation
+				Skeleton
+				  Constructor.
+				~Skeleton
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class Skeleton final
+	{
+	public:
+		Skeleton();
+		Skeleton(const Skeleton& other) = delete;
+		Skeleton(Skeleton&& other) = delete;
+		Skeleton& operator=(const Skeleton& other) = delete;
+		Skeleton& operator=(Skeleton&& other) = delete;
+		~Skeleton() = default;
+
+		HRESULT Initialize(
+			_In_ const aiScene* pScene,
+			_In_ const std::unordered_map<std::string, UINT>& boneNameToIndexMap,
+			_In_ const std::vector<XMMATRIX>& aBoneOffsets,
+			_In_ const XMMATRIX& globalInverseTransform
+		);
+		void InitializePose(_Out_ SkeletonPose& outPose) const;
+		void ComputePalette(_In_ FLOAT animationTimeTicks, _Inout_ SkeletonPose& pose, _Out_writes_(GetNumBones()) XMMATRIX* aOutPalette) const;
+
+		UINT GetNumNodes() const;
+		UINT GetNumAnimatedNodes() const;
+		UINT GetNumBones() const;
+		SIZE_T GetNumBytes() const;
+		BOOL HasAnimation() const;
+
+	private:
+		void composeLocalTransforms(_Inout_ SkeletonPose& pose) const;
+		void sampleChannels(_In_ FLOAT animationTimeTicks, _Inout_ SkeletonPose& pose) const;
+
+		static const aiNodeAnim* findNodeAnimOrNull(_In_ const aiAnimation* pAnimation, _In_ PCSTR pszNodeName);
+
+	private:
+		static constexpr UINT SIMD_WIDTH = 8u;
+
+		std::vector<INT> m_aParentIndices;
+		std::vector<INT> m_aBoneIndices;
+		std::vector<XMMATRIX> m_aBindTransforms;
+		std::vector<UINT> m_aAnimatedNodes;
+		std::vector<const aiNodeAnim*> m_aChannels;
+		std::vector<XMMATRIX> m_aBoneOffsets;
+		UINT m_uNumPaddedChannels;
+		XMMATRIX m_globalInverseTransform;
+	};
+}
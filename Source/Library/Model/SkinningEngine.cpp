@@ -0,0 +1,140 @@
+#include "Model/SkinningEngine.h"
+
+#include "Job/JobSystem.h"
+
+namespace library
+{
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SkinningEngine::SkinVertices
+
+	  Summary:  Blends the four weighted bone matrices of each vertex
+				and transforms its position, normal, tangent and
+				bitangent. The blend runs on whole matrix rows so every
+				step is a vector multiply-add. Texture coordinates are
+				copied through.
+
+				Vertices are not batched into x, y and z lanes like the
+				bone channels of Skeleton::composeBatch4: each lane
+				reads four different bones, so the blend stays a row
+				blend per vertex, and the transposes needed to move the
+				blended matrices and the float3 streams into lanes and
+				back cost what the lane-wise transforms save.
+
+	  Args:     const SimpleVertex* aBindVertices
+				  Bind pose vertices
+				const NormalData* aBindNormalData
+				  Bind pose tangents and bitangents
+				const AnimationData* aAnimationData
+				  Bone indices and weights of each vertex
+				UINT uNumVertices
+				  Number of vertices to skin
+				const XMMATRIX* aPalette
+				  Bone palette of the current frame
+				SimpleVertex* aOutVertices
+				  Skinned vertices
+				NormalData* aOutNormalData
+				  Skinned tangents and bitangents
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SkinningEngine::SkinVertices(
+		_In_reads_(uNumVertices) const SimpleVertex* aBindVertices,
+		_In_reads_(uNumVertices) const NormalData* aBindNormalData,
+		_In_reads_(uNumVertices) const AnimationData* aAnimationData,
+		_In_ UINT uNumVertices,
+		_In_ const XMMATRIX* aPalette,
+		_Out_writes_(uNumVertices) SimpleVertex* aOutVertices,
+		_Out_writes_(uNumVertices) NormalData* aOutNormalData
+	)
+	{
+		for (UINT i = 0u; i < uNumVertices; ++i)
+		{
+			const AnimationData& animationData = aAnimationData[i];
+			XMVECTOR weights = XMLoadFloat4(&animationData.aBoneWeights);
+
+			const XMMATRIX& bone0 = aPalette[animationData.aBoneIndices.x];
+			const XMMATRIX& bone1 = aPalette[animationData.aBoneIndices.y];
+			const XMMATRIX& bone2 = aPalette[animationData.aBoneIndices.z];
+			const XMMATRIX& bone3 = aPalette[animationData.aBoneIndices.w];
+
+			XMVECTOR w0 = XMVectorSplatX(weights);
+			XMVECTOR w1 = XMVectorSplatY(weights);
+			XMVECTOR w2 = XMVectorSplatZ(weights);
+			XMVECTOR w3 = XMVectorSplatW(weights);
+
+			XMMATRIX skin;
+			for (UINT uRow = 0u; uRow < 4u; ++uRow)
+			{
+				XMVECTOR row = XMVectorMultiply(bone0.r[uRow], w0);
+				row = XMVectorMultiplyAdd(bone1.r[uRow], w1, row);
+				row = XMVectorMultiplyAdd(bone2.r[uRow], w2, row);
+				skin.r[uRow] = XMVectorMultiplyAdd(bone3.r[uRow], w3, row);
+			}
+
+			XMVECTOR position = XMVector3Transform(XMLoadFloat3(&aBindVertices[i].Position), skin);
+			XMVECTOR normal = XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&aBindVertices[i].Normal), skin));
+
+			XMStoreFloat3(&aOutVertices[i].Position, position);
+			XMStoreFloat3(&aOutVertices[i].Normal, normal);
+			aOutVertices[i].TexCoord = aBindVertices[i].TexCoord;
+
+			// Meshes without tangents keep zero vectors, which normalize to zero
+			XMVECTOR tangent = XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&aBindNormalData[i].Tangent), skin));
+			XMVECTOR bitangent = XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&aBindNormalData[i].Bitangent), skin));
+
+			XMStoreFloat3(&aOutNormalData[i].Tangent, tangent);
+			XMStoreFloat3(&aOutNormalData[i].Bitangent, bitangent);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SkinningEngine::SkinRanges
+
+	  Summary:  Skins every range as a separate job and returns when
+				all of them are done
+
+	  Args:     const std::vector<SkinningRange>& aRanges
+				  Vertex ranges, one per mesh
+				const SimpleVertex* aBindVertices
+				  Bind pose vertices of the whole model
+				const NormalData* aBindNormalData
+				  Bind pose tangents and bitangents of the whole model
+				const AnimationData* aAnimationData
+				  Bone indices and weights of the whole model
+				const XMMATRIX* aPalette
+				  Bone palette of the current frame
+				SimpleVertex* aOutVertices
+				  Skinned vertices of the whole model
+				NormalData* aOutNormalData
+				  Skinned tangents and bitangents of the whole model
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SkinningEngine::SkinRanges(
+		_In_ const std::vector<SkinningRange>& aRanges,
+		_In_ const SimpleVertex* aBindVertices,
+		_In_ const NormalData* aBindNormalData,
+		_In_ const AnimationData* aAnimationData,
+		_In_ const XMMATRIX* aPalette,
+		_Out_ SimpleVertex* aOutVertices,
+		_Out_ NormalData* aOutNormalData
+	)
+	{
+		JobSystem::GetInstance().ParallelFor(
+			static_cast<UINT>(aRanges.size()),
+			1u,
+			[&](UINT uBegin, UINT uEnd)
+			{
+				for (UINT i = uBegin; i < uEnd; ++i)
+				{
+					const SkinningRange& range = aRanges[i];
+					SkinVertices(
+						aBindVertices + range.uBaseVertex,
+						aBindNormalData + range.uBaseVertex,
+						aAnimationData + range.uBaseVertex,
+						range.uNumVertices,
+						aPalette,
+						aOutVertices + range.uBaseVertex,
+						aOutNormalData + range.uBaseVertex
+					);
+				}
+			}
+		);
+	}
+}
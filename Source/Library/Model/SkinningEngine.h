@@ -0,0 +1,75 @@
+/*+===================================================================
+  File:      SKINNINGENGINE.H
+
+  Summary:   SkinningEngine header file contains declarations of
+			 SkinningEngine class that skins model vertices on the
+			 CPU.
+
+  Classes: SkinningEngine
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   SkinningRange
+
+		Summary:  Contiguous range of vertices skinned by one job,
+				  usually a single mesh of a model
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct SkinningRange
+	{
+		UINT uBaseVertex;
+		UINT uNumVertices;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    SkinningEngine
+
+	  Summary:  Skins bind pose vertices with a bone palette the same
+				way SkinningShaders.fxh does, producing a vertex stream
+				and a tangent frame stream that any pass or CPU query
+				can reuse.
+
+	  Methods:  SkinVertices
+				  Skins a range of vertices on the calling thread
+				SkinRanges
+				  Skins every range on the job system, one job per
+				  range
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class SkinningEngine final
+	{
+	public:
+		SkinningEngine() = delete;
+		SkinningEngine(const SkinningEngine& other) = delete;
+		SkinningEngine(SkinningEngine&& other) = delete;
+		SkinningEngine& operator=(const SkinningEngine& other) = delete;
+		SkinningEngine& operator=(SkinningEngine&& other) = delete;
+		~SkinningEngine() = delete;
+
+		static void SkinVertices(
+			_In_reads_(uNumVertices) const SimpleVertex* aBindVertices,
+			_In_reads_(uNumVertices) const NormalData* aBindNormalData,
+			_In_reads_(uNumVertices) const AnimationData* aAnimationData,
+			_In_ UINT uNumVertices,
+			_In_ const XMMATRIX* aPalette,
+			_Out_writes_(uNumVertices) SimpleVertex* aOutVertices,
+			_Out_writes_(uNumVertices) NormalData* aOutNormalData
+		);
+		static void SkinRanges(
+			_In_ const std::vector<SkinningRange>& aRanges,
+			_In_ const SimpleVertex* aBindVertices,
+			_In_ const NormalData* aBindNormalData,
+			_In_ const AnimationData* aAnimationData,
+			_In_ const XMMATRIX* aPalette,
+			_Out_ SimpleVertex* aOutVertices,
+			_Out_ NormalData* aOutNormalData
+		);
+	};
+}
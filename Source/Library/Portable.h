@@ -0,0 +1,46 @@
+/*+===================================================================
+  File:      PORTABLE.H
+
+  Summary:   Portable header file that contains the Windows types,
+			 DirectXMath and the standard headers shared by the
+			 Library code that does not talk to Direct3D. Common.h
+			 includes it, code that must also build without a GPU,
+			 such as the null render backend and the tests, includes
+			 only this file. Off Windows the types come from the
+			 DirectX-Headers WSL adapter, as they do for DDSLayout.h.
+
+  Functions:
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#ifdef _WIN32
+
+#ifndef  UNICODE
+#define UNICODE
+#endif // ! UNICODE
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif // ! WIN32_LEAN_AND_MEAN
+
+#include <windows.h>
+
+#else
+
+#include <wsl/winadapter.h>
+
+#endif // _WIN32
+
+#include <DirectXMath.h>
+
+#include <cassert>
+#include <climits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace DirectX;
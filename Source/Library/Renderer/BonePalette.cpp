@@ -0,0 +1,384 @@
+#include "Renderer/BonePalette.h"
+
+#include "Renderer/D3D11Backend.h"
+
+#include <algorithm>
+
+namespace library
+{
+	namespace
+	{
+		/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+		  Function: storeBone
+
+		  Summary:  Converts a bone transform into the elements of a
+					palette format. Dual quaternions keep the rotation
+					and translation of the transform and drop its scale.
+
+		  Args:     eBonePaletteFormat eFormat
+					  Format of the palette
+					FXMMATRIX transform
+					  Final transform of the bone
+					XMFLOAT4* aOutElements
+					  Elements of the bone, as many as the format takes
+		F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+		void storeBone(_In_ eBonePaletteFormat eFormat, _In_ FXMMATRIX transform, _Out_writes_(4) XMFLOAT4* aOutElements)
+		{
+			switch (eFormat)
+			{
+			case eBonePaletteFormat::AFFINE_3X4:
+			{
+				// The last column is always (0, 0, 0, 1), the columns are kept as rows
+				const XMMATRIX transposed = XMMatrixTranspose(transform);
+				for (UINT i = 0u; i < 3u; ++i)
+				{
+					XMStoreFloat4(&aOutElements[i], transposed.r[i]);
+				}
+				break;
+			}
+			case eBonePaletteFormat::DUAL_QUATERNION:
+			{
+				XMVECTOR scale;
+				XMVECTOR rotation;
+				XMVECTOR translation;
+				if (!XMMatrixDecompose(&scale, &rotation, &translation, transform))
+				{
+					rotation = XMQuaternionIdentity();
+					translation = transform.r[3];
+				}
+				rotation = XMQuaternionNormalize(rotation);
+
+				// Dual part is half of the translation times the rotation, XMQuaternionMultiply(q, t) is t * q
+				const XMVECTOR dual = XMVectorScale(XMQuaternionMultiply(rotation, XMVectorSetW(translation, 0.0f)), 0.5f);
+
+				XMStoreFloat4(&aOutElements[0], rotation);
+				XMStoreFloat4(&aOutElements[1], dual);
+				break;
+			}
+			default:
+				for (UINT i = 0u; i < 4u; ++i)
+				{
+					XMStoreFloat4(&aOutElements[i], transform.r[i]);
+				}
+				break;
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BonePalette::BonePalette
+
+	  Summary:  Constructor of an empty palette, the buffer is created
+				by the first upload
+
+	  Modifies: [m_buffer, m_shaderResourceView, m_aElements, m_eFormat,
+				 m_uCapacity, m_uNumBones, m_uNumPalettes,
+				 m_uNumUploadedBytes].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BonePalette::BonePalette()
+		: m_buffer()
+		, m_shaderResourceView()
+		, m_aElements()
+		, m_eFormat(eBonePaletteFormat::MATRIX_4X4)
+		, m_uCapacity(0u)
+		, m_uNumBones(0u)
+		, m_uNumPalettes(0u)
+		, m_uNumUploadedBytes(0u)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BonePalette::Reset
+
+	  Summary:  Empties the palette, keeping the buffer and the memory
+				of the bones for the next frame
+
+	  Modifies: [m_aElements, m_uNumBones, m_uNumPalettes,
+				 m_uNumUploadedBytes].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void BonePalette::Reset()
+	{
+		m_aElements.clear();
+		m_uNumBones = 0u;
+		m_uNumPalettes = 0u;
+		m_uNumUploadedBytes = 0u;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BonePalette::SetFormat
+
+	  Summary:  Sets how bones are stored and empties the palette, as
+				bones already added are in the old format
+
+	  Args:     eBonePaletteFormat eFormat
+				  Format of the bones
+
+	  Modifies: [m_eFormat, m_aElements, m_uNumBones, m_uNumPalettes,
+				 m_uNumUploadedBytes].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void BonePalette::SetFormat(_In_ eBonePaletteFormat eFormat)
+	{
+		assert(eFormat < eBonePaletteFormat::COUNT);
+
+		m_eFormat = eFormat;
+		Reset();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BonePalette::GetFormat
+
+	  Summary:  Returns how bones are stored
+
+	  Returns:  eBonePaletteFormat
+				  Format of the bones
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	eBonePaletteFormat BonePalette::GetFormat() const
+	{
+		return m_eFormat;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BonePalette::Add
+
+	  Summary:  Converts the bones of a model into the format of the
+				palette and appends them
+
+	  Args:     const XMMATRIX* aTransforms
+				  Bone transforms of the model
+				UINT uNumBones
+				  Number of bones of the model
+
+	  Modifies: [m_aElements, m_uNumBones, m_uNumPalettes].
+
+	  Returns:  UINT
+				  Index of the first bone of the model in the palette
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT BonePalette::Add(_In_reads_(uNumBones) const XMMATRIX* aTransforms, _In_ UINT uNumBones)
+	{
+		static_assert(sizeof(XMMATRIX) == 4u * sizeof(XMFLOAT4), "full matrices are copied as they are laid out in memory");
+
+		const UINT uOffset = m_uNumBones;
+		const UINT uNumElements = GetNumElements(m_eFormat);
+		const size_t uFirstElement = m_aElements.size();
+		m_aElements.resize(uFirstElement + static_cast<size_t>(uNumBones) * uNumElements);
+
+		if (m_eFormat == eBonePaletteFormat::MATRIX_4X4)
+		{
+			memcpy(m_aElements.data() + uFirstElement, aTransforms, uNumBones * sizeof(XMMATRIX));
+		}
+		else
+		{
+			for (UINT i = 0u; i < uNumBones; ++i)
+			{
+				storeBone(m_eFormat, aTransforms[i], &m_aElements[uFirstElement + static_cast<size_t>(i) * uNumElements]);
+			}
+		}
+
+		m_uNumBones += uNumBones;
+		++m_uNumPalettes;
+
+		return uOffset;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BonePalette::Upload
+
+	  Summary:  Copies the elements of the frame into the buffer,
+				recreating it with twice the capacity when they no
+				longer fit. Nothing is uploaded when no bones were
+				added.
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the buffer with
+				IRenderContext& context
+				  The immediate context to map the buffer with
+
+	  Modifies: [m_buffer, m_shaderResourceView, m_uCapacity,
+				 m_uNumUploadedBytes].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT BonePalette::Upload(_In_ ID3D11Device* pDevice, _Inout_ IRenderContext& context)
+	{
+		const UINT uNumElements = static_cast<UINT>(m_aElements.size());
+		if (uNumElements == 0u)
+		{
+			return S_OK;
+		}
+
+		HRESULT hr = S_OK;
+		if (uNumElements > m_uCapacity)
+		{
+			UINT uCapacity = std::max<UINT>(m_uCapacity, MIN_CAPACITY);
+			while (uCapacity < uNumElements)
+			{
+				uCapacity *= 2u;
+			}
+
+			hr = createBuffer(pDevice, uCapacity);
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+		}
+
+		void* pMapped = nullptr;
+		hr = context.Map(ToGpu(m_buffer.Get()), 0u, eMapType::WRITE_DISCARD, &pMapped);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		m_uNumUploadedBytes = uNumElements * sizeof(XMFLOAT4);
+		memcpy(pMapped, m_aElements.data(), m_uNumUploadedBytes);
+		context.Unmap(ToGpu(m_buffer.Get()), 0u);
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BonePalette::GetShaderResourceView
+
+	  Summary:  Returns the view of the structured buffer
+
+	  Returns:  ComPtr<ID3D11ShaderResourceView>&
+				  The view, null before the first upload
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	ComPtr<ID3D11ShaderResourceView>& BonePalette::GetShaderResourceView()
+	{
+		return m_shaderResourceView;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BonePalette::GetNumBones
+
+	  Summary:  Returns the number of bones added this frame
+
+	  Returns:  UINT
+				  Number of bones
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT BonePalette::GetNumBones() const
+	{
+		return m_uNumBones;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BonePalette::GetNumUploadedBytes
+
+	  Summary:  Returns the bytes of bones uploaded this frame
+
+	  Returns:  UINT
+				  Number of bytes
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT BonePalette::GetNumUploadedBytes() const
+	{
+		return m_uNumUploadedBytes;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BonePalette::GetNumFixedPaletteBytes
+
+	  Summary:  Returns the bytes the models of this frame would have
+				uploaded with one full 256 bone constant buffer each,
+				to compare against GetNumUploadedBytes
+
+	  Returns:  UINT
+				  Number of bytes
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT BonePalette::GetNumFixedPaletteBytes() const
+	{
+		return m_uNumPalettes * FIXED_PALETTE_SIZE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BonePalette::GetElements
+
+	  Summary:  Returns the float4 elements of the bones added since
+				the last reset, in the format of the palette
+
+	  Returns:  const std::vector<XMFLOAT4>&
+				  Elements the next upload copies
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const std::vector<XMFLOAT4>& BonePalette::GetElements() const
+	{
+		return m_aElements;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BonePalette::GetNumElements
+
+	  Summary:  Returns the float4 elements one bone takes
+
+	  Args:     eBonePaletteFormat eFormat
+				  Format of the bone
+
+	  Returns:  UINT
+				  Number of elements
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT BonePalette::GetNumElements(_In_ eBonePaletteFormat eFormat)
+	{
+		switch (eFormat)
+		{
+		case eBonePaletteFormat::AFFINE_3X4:
+			return 3u;
+		case eBonePaletteFormat::DUAL_QUATERNION:
+			return 2u;
+		default:
+			return 4u;
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BonePalette::createBuffer
+
+	  Summary:  Creates the dynamic structured buffer and its view
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the buffer
+				UINT uCapacity
+				  Number of float4 elements the buffer holds
+
+	  Modifies: [m_buffer, m_shaderResourceView, m_uCapacity].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT BonePalette::createBuffer(_In_ ID3D11Device* pDevice, _In_ UINT uCapacity)
+	{
+		m_shaderResourceView.Reset();
+		m_buffer.Reset();
+		m_uCapacity = 0u;
+
+		D3D11_BUFFER_DESC bd =
+		{
+			.ByteWidth = uCapacity * static_cast<UINT>(sizeof(XMFLOAT4)),
+			.Usage = D3D11_USAGE_DYNAMIC,
+			.BindFlags = D3D11_BIND_SHADER_RESOURCE,
+			.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+			.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED,
+			.StructureByteStride = sizeof(XMFLOAT4)
+		};
+		HRESULT hr = pDevice->CreateBuffer(&bd, nullptr, m_buffer.GetAddressOf());
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+		srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+		srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+		srvDesc.Buffer.FirstElement = 0u;
+		srvDesc.Buffer.NumElements = uCapacity;
+		hr = pDevice->CreateShaderResourceView(m_buffer.Get(), &srvDesc, m_shaderResourceView.GetAddressOf());
+		if (FAILED(hr))
+		{
+			m_buffer.Reset();
+			return hr;
+		}
+
+		m_uCapacity = uCapacity;
+
+		return S_OK;
+	}
+}
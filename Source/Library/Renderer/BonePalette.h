@@ -0,0 +1,121 @@
+/*+===================================================================
+  File:      BONEPALETTE.H
+
+  Summary:   BonePalette header file contains declarations of
+			 BonePalette class, one structured buffer that the bone
+			 transforms of every skinned model of the frame are
+			 packed into, as full matrices, affine 3x4 matrices or
+			 dual quaternions.
+
+  Classes: BonePalette
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/RenderDevice.h"
+
+namespace library
+{
+	/*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+		Enum:     eBonePaletteFormat
+
+		Summary:  Enumeration of the ways a bone is stored in the
+				  palette, the value is passed to the skinning shader
+				  as is. MATRIX_4X4 takes four float4 per bone,
+				  AFFINE_3X4 three, leaving out the constant last
+				  column, and DUAL_QUATERNION two. Dual quaternions
+				  blend rotations without the collapsing joints of
+				  linear blending, but hold no scale.
+	E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+	enum class eBonePaletteFormat : UINT
+	{
+		MATRIX_4X4 = 0,
+		AFFINE_3X4,
+		DUAL_QUATERNION,
+		COUNT,
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    BonePalette
+
+	  Summary:  Collects the live bones of every skinned model into
+				one array, each model getting the range that starts
+				at the offset Add returns, and uploads the array into
+				a dynamic structured buffer once a frame. Models are
+				no longer limited to a fixed number of bones and only
+				the bones they have are uploaded. Bones are converted
+				on the CPU into the format of the palette and stored
+				as float4 elements. The buffer grows by doubling when
+				a frame needs more elements than it holds.
+
+	  Methods:  Reset
+				  Empties the palette for a new frame
+				SetFormat
+				  Sets how the bones are stored and empties it
+				GetFormat
+				  Returns how the bones are stored
+				Add
+				  Appends the bones of a model
+				Upload
+				  Copies the bones into the buffer
+				GetShaderResourceView
+				  Returns the view of the buffer
+				GetNumBones
+				  Returns the number of bones added
+				GetNumUploadedBytes
+				  Returns the bytes uploaded this frame
+				GetNumFixedPaletteBytes
+				  Returns the bytes full palettes would upload
+				GetElements
+				  Returns the elements of the bones added
+				GetNumElements
+				  Returns the float4 elements of a bone
+				BonePalette
+				  Constructor.
+				~BonePalette
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class BonePalette final
+	{
+	public:
+		static constexpr UINT FIXED_PALETTE_SIZE = 256u * sizeof(XMFLOAT4X4);
+		static constexpr UINT MIN_CAPACITY = 1024u;
+
+	public:
+		BonePalette();
+		BonePalette(const BonePalette& other) = delete;
+		BonePalette(BonePalette&& other) = delete;
+		BonePalette& operator=(const BonePalette& other) = delete;
+		BonePalette& operator=(BonePalette&& other) = delete;
+		~BonePalette() = default;
+
+		void Reset();
+		void SetFormat(_In_ eBonePaletteFormat eFormat);
+		eBonePaletteFormat GetFormat() const;
+		UINT Add(_In_reads_(uNumBones) const XMMATRIX* aTransforms, _In_ UINT uNumBones);
+		HRESULT Upload(_In_ ID3D11Device* pDevice, _Inout_ IRenderContext& context);
+
+		ComPtr<ID3D11ShaderResourceView>& GetShaderResourceView();
+		UINT GetNumBones() const;
+		UINT GetNumUploadedBytes() const;
+		UINT GetNumFixedPaletteBytes() const;
+		const std::vector<XMFLOAT4>& GetElements() const;
+
+		static UINT GetNumElements(_In_ eBonePaletteFormat eFormat);
+
+	private:
+		HRESULT createBuffer(_In_ ID3D11Device* pDevice, _In_ UINT uCapacity);
+
+		ComPtr<ID3D11Buffer> m_buffer;
+		ComPtr<ID3D11ShaderResourceView> m_shaderResourceView;
+		std::vector<XMFLOAT4> m_aElements;
+		eBonePaletteFormat m_eFormat;
+		UINT m_uCapacity;
+		UINT m_uNumBones;
+		UINT m_uNumPalettes;
+		UINT m_uNumUploadedBytes;
+	};
+}
@@ -0,0 +1,123 @@
+#include "Renderer/CommandRecorder.h"
+
+namespace library
+{
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   DeferredContextBackend::DeferredContextBackend
+
+	  Summary:  Constructor
+
+	  Modifies: [m_pDevice, m_pImmediateContext].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	DeferredContextBackend::DeferredContextBackend()
+		: m_pDevice(nullptr)
+		, m_pImmediateContext(nullptr)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   DeferredContextBackend::Initialize
+
+	  Summary:  Sets the device the deferred contexts are created on
+				and the context the lists execute on
+
+	  Args:     IRenderDevice* pDevice
+				  The render device
+				IRenderContext* pImmediateContext
+				  The immediate context
+
+	  Modifies: [m_pDevice, m_pImmediateContext].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void DeferredContextBackend::Initialize(_In_ IRenderDevice* pDevice, _In_ IRenderContext* pImmediateContext)
+	{
+		m_pDevice = pDevice;
+		m_pImmediateContext = pImmediateContext;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   DeferredContextBackend::HasDriverCommandLists
+
+	  Summary:  Returns whether the driver records command lists
+				itself instead of leaving it to the runtime
+
+	  Returns:  BOOL
+				  TRUE if command lists are native
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL DeferredContextBackend::HasDriverCommandLists() const
+	{
+		return m_pDevice && m_pDevice->HasDriverCommandLists();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   DeferredContextBackend::CreateContext
+
+	  Summary:  Creates a deferred context and points its state cache
+				at it
+
+	  Args:     Context& context
+				  Context to create
+
+	  Modifies: [context].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT DeferredContextBackend::CreateContext(_Inout_ Context& context)
+	{
+		if (!m_pDevice || !m_pImmediateContext)
+		{
+			return E_FAIL;
+		}
+
+		HRESULT hr = m_pDevice->CreateDeferredContext(context.Context);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		context.Cache.SetContext(context.Context.get());
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   DeferredContextBackend::FinishCommandList
+
+	  Summary:  Turns the commands a context recorded into a command
+				list. The context is back in the default state after,
+				so its state cache forgets what it bound.
+
+	  Args:     Context& context
+				  Context that recorded
+				CommandList& outList
+				  The command list
+
+	  Modifies: [context].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT DeferredContextBackend::FinishCommandList(_Inout_ Context& context, _Out_ CommandList& outList)
+	{
+		context.Cache.Invalidate();
+
+		return context.Context->FinishCommandList(outList);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   DeferredContextBackend::ExecuteCommandList
+
+	  Summary:  Executes a command list on the immediate context and
+				releases it. The immediate context is left in the
+				default state instead of being restored, which is the
+				cheaper way.
+
+	  Args:     CommandList& list
+				  The command list
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void DeferredContextBackend::ExecuteCommandList(_Inout_ CommandList& list)
+	{
+		m_pImmediateContext->ExecuteCommandList(*list);
+		list.reset();
+	}
+}
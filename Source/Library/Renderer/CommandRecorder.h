@@ -0,0 +1,397 @@
+/*+===================================================================
+  File:      COMMANDRECORDER.H
+
+  Summary:   CommandRecorder header file contains declarations of
+			 BasicCommandRecorder class template that records ranges
+			 of a draw list on worker threads, one command list per
+			 range, and executes the lists in order, and of
+			 DeferredContextBackend class that records them into
+			 the deferred contexts of a render device.
+
+  Classes: BasicCommandRecorder<BackendType>, DeferredContextBackend
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Portable.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+
+#include "Job/JobSystem.h"
+#include "Renderer/RenderDevice.h"
+#include "Renderer/StateCache.h"
+
+namespace library
+{
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    BasicCommandRecorder
+
+	  Summary:  Splits a list of items into contiguous ranges and
+				records each range on the job system into a context of
+				its own, which is turned into a command list. Execute
+				waits for every range and executes the lists in the
+				order they were recorded in, so the submitted commands
+				are the same whichever thread recorded which range.
+				Contexts are created on demand and reused every frame.
+				The backend is a template argument with a Context and
+				a CommandList type, CreateContext, FinishCommandList
+				and ExecuteCommandList, so a stand-in backend can
+				check the recorded streams without a device.
+
+	  Methods:  SetBackend
+				  Sets the backend and drops the contexts
+				Record
+				  Records the ranges of a list of items
+				Execute
+				  Waits for the ranges and executes their lists
+				GetNumContexts
+				  Returns the number of contexts created
+				GetNumExecutedLists
+				  Returns the lists the last Execute executed
+				GetRange
+				  Returns the items a range records
+				BasicCommandRecorder
+				  Constructor.
+				~BasicCommandRecorder
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	template <class BackendType>
+	class BasicCommandRecorder final
+	{
+	public:
+		using Context = typename BackendType::Context;
+		using CommandList = typename BackendType::CommandList;
+		using RecordJob = std::function<void(_Inout_ Context& context, _In_ UINT uBegin, _In_ UINT uEnd)>;
+
+	public:
+		BasicCommandRecorder();
+		BasicCommandRecorder(const BasicCommandRecorder& other) = delete;
+		BasicCommandRecorder(BasicCommandRecorder&& other) = delete;
+		BasicCommandRecorder& operator=(const BasicCommandRecorder& other) = delete;
+		BasicCommandRecorder& operator=(BasicCommandRecorder&& other) = delete;
+		~BasicCommandRecorder();
+
+		void SetBackend(_In_opt_ BackendType* pBackend);
+
+		HRESULT Record(_In_ UINT uNumItems, _In_ UINT uNumRanges, _In_ RecordJob job);
+		HRESULT Execute();
+
+		UINT GetNumContexts() const;
+		UINT GetNumExecutedLists() const;
+
+		static void GetRange(_In_ UINT uNumItems, _In_ UINT uNumRanges, _In_ UINT uRange, _Out_ UINT& uOutBegin, _Out_ UINT& uOutEnd);
+
+	private:
+		struct Recording
+		{
+			Context* pContext;
+			const RecordJob* pJob;
+			UINT uBegin;
+			UINT uEnd;
+			CommandList List;
+			HRESULT hr;
+		};
+
+		BackendType* m_pBackend;
+		std::vector<std::unique_ptr<Context>> m_aContexts;
+		std::deque<RecordJob> m_aJobs;
+		std::deque<Recording> m_aRecordings;
+		JobCounter m_counter;
+		UINT m_uNumUsedContexts;
+		UINT m_uNumExecutedLists;
+	};
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   DeferredContext
+
+		Summary:  A deferred context and the state cache its binds go
+				  through
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct DeferredContext
+	{
+		std::unique_ptr<IRenderContext> Context;
+		StateCache Cache;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    DeferredContextBackend
+
+	  Summary:  Records into the deferred contexts of a render device
+				and executes the command lists on its immediate
+				context, Direct3D 11 or null alike. A command list
+				starts from the default pipeline state and leaves the
+				immediate context in the default state after it
+				executes, so the recorded ranges bind all the state
+				they draw with.
+
+	  Methods:  Initialize
+				  Sets the device and the immediate context
+				HasDriverCommandLists
+				  Returns whether the driver records natively
+				CreateContext
+				  Creates a deferred context
+				FinishCommandList
+				  Turns what a context recorded into a command list
+				ExecuteCommandList
+				  Executes a command list on the immediate context
+				DeferredContextBackend
+				  Constructor.
+				~DeferredContextBackend
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class DeferredContextBackend final
+	{
+	public:
+		using Context = DeferredContext;
+		using CommandList = std::unique_ptr<IRenderCommandList>;
+
+	public:
+		DeferredContextBackend();
+		DeferredContextBackend(const DeferredContextBackend& other) = delete;
+		DeferredContextBackend(DeferredContextBackend&& other) = delete;
+		DeferredContextBackend& operator=(const DeferredContextBackend& other) = delete;
+		DeferredContextBackend& operator=(DeferredContextBackend&& other) = delete;
+		~DeferredContextBackend() = default;
+
+		void Initialize(_In_ IRenderDevice* pDevice, _In_ IRenderContext* pImmediateContext);
+		BOOL HasDriverCommandLists() const;
+
+		HRESULT CreateContext(_Inout_ Context& context);
+		HRESULT FinishCommandList(_Inout_ Context& context, _Out_ CommandList& outList);
+		void ExecuteCommandList(_Inout_ CommandList& list);
+
+	private:
+		IRenderDevice* m_pDevice;
+		IRenderContext* m_pImmediateContext;
+	};
+
+	using CommandRecorder = BasicCommandRecorder<DeferredContextBackend>;
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicCommandRecorder<BackendType>::BasicCommandRecorder
+
+	  Summary:  Constructor of a recorder without a backend
+
+	  Modifies: [m_pBackend, m_aContexts, m_aJobs, m_aRecordings,
+				 m_counter, m_uNumUsedContexts, m_uNumExecutedLists].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class BackendType>
+	BasicCommandRecorder<BackendType>::BasicCommandRecorder()
+		: m_pBackend(nullptr)
+		, m_aContexts()
+		, m_aJobs()
+		, m_aRecordings()
+		, m_counter()
+		, m_uNumUsedContexts(0u)
+		, m_uNumExecutedLists(0u)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicCommandRecorder<BackendType>::~BasicCommandRecorder
+
+	  Summary:  Destructor, waits for ranges still being recorded
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class BackendType>
+	BasicCommandRecorder<BackendType>::~BasicCommandRecorder()
+	{
+		if (m_counter.uNumPending.load() > 0u)
+		{
+			JobSystem::GetInstance().Wait(m_counter);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicCommandRecorder<BackendType>::SetBackend
+
+	  Summary:  Sets the backend the contexts come from, dropping the
+				contexts of the previous one. Must not be called while
+				ranges are recorded.
+
+	  Args:     BackendType* pBackend
+				  The backend
+
+	  Modifies: [m_pBackend, m_aContexts, m_uNumUsedContexts].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class BackendType>
+	void BasicCommandRecorder<BackendType>::SetBackend(_In_opt_ BackendType* pBackend)
+	{
+		assert(m_aRecordings.empty());
+
+		m_pBackend = pBackend;
+		m_aContexts.clear();
+		m_uNumUsedContexts = 0u;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicCommandRecorder<BackendType>::Record
+
+	  Summary:  Splits [0, uNumItems) into ranges and submits a job
+				per range that records it into a context of its own.
+				There is always at least one range, so a pass without
+				items still records what it does before its first
+				item. Returns once the jobs are submitted, Execute
+				waits for them.
+
+	  Args:     UINT uNumItems
+				  Number of items
+				UINT uNumRanges
+				  Number of ranges, clamped to [1, uNumItems]
+				RecordJob job
+				  Function that records [uBegin, uEnd) into a context
+
+	  Modifies: [m_aContexts, m_aJobs, m_aRecordings, m_counter,
+				 m_uNumUsedContexts].
+
+	  Returns:  HRESULT
+				  Status code, ranges are skipped if no context could
+				  be created for them
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class BackendType>
+	HRESULT BasicCommandRecorder<BackendType>::Record(_In_ UINT uNumItems, _In_ UINT uNumRanges, _In_ RecordJob job)
+	{
+		if (!m_pBackend)
+		{
+			return E_FAIL;
+		}
+
+		uNumRanges = std::max<UINT>(std::min<UINT>(uNumRanges, uNumItems), 1u);
+
+		const RecordJob* pJob = &m_aJobs.emplace_back(std::move(job));
+		for (UINT uRange = 0u; uRange < uNumRanges; ++uRange)
+		{
+			if (m_uNumUsedContexts == m_aContexts.size())
+			{
+				std::unique_ptr<Context> context = std::make_unique<Context>();
+				HRESULT hr = m_pBackend->CreateContext(*context);
+				if (FAILED(hr))
+				{
+					return hr;
+				}
+
+				m_aContexts.push_back(std::move(context));
+			}
+
+			Recording& recording = m_aRecordings.emplace_back(
+				Recording
+				{
+					.pContext = m_aContexts[m_uNumUsedContexts++].get(),
+					.pJob = pJob,
+					.uBegin = 0u,
+					.uEnd = 0u,
+					.List = CommandList(),
+					.hr = E_PENDING
+				}
+			);
+			GetRange(uNumItems, uNumRanges, uRange, recording.uBegin, recording.uEnd);
+
+			JobSystem::GetInstance().Submit([this, &recording]()
+				{
+					(*recording.pJob)(*recording.pContext, recording.uBegin, recording.uEnd);
+					recording.hr = m_pBackend->FinishCommandList(*recording.pContext, recording.List);
+				},
+				m_counter
+			);
+		}
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicCommandRecorder<BackendType>::Execute
+
+	  Summary:  Waits for every recorded range, helping to record
+				them meanwhile, and executes their lists in the order
+				Record was called and, within a call, in item order
+
+	  Modifies: [m_aJobs, m_aRecordings, m_uNumUsedContexts,
+				 m_uNumExecutedLists].
+
+	  Returns:  HRESULT
+				  Status code, a list that failed to finish is skipped
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class BackendType>
+	HRESULT BasicCommandRecorder<BackendType>::Execute()
+	{
+		JobSystem::GetInstance().Wait(m_counter);
+
+		HRESULT hr = S_OK;
+		m_uNumExecutedLists = 0u;
+		for (Recording& recording : m_aRecordings)
+		{
+			if (FAILED(recording.hr))
+			{
+				hr = SUCCEEDED(hr) ? recording.hr : hr;
+				continue;
+			}
+
+			m_pBackend->ExecuteCommandList(recording.List);
+			++m_uNumExecutedLists;
+		}
+
+		m_aRecordings.clear();
+		m_aJobs.clear();
+		m_uNumUsedContexts = 0u;
+
+		return hr;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicCommandRecorder<BackendType>::GetNumContexts
+
+	  Summary:  Returns the number of contexts created so far
+
+	  Returns:  UINT
+				  Number of contexts
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class BackendType>
+	UINT BasicCommandRecorder<BackendType>::GetNumContexts() const
+	{
+		return static_cast<UINT>(m_aContexts.size());
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicCommandRecorder<BackendType>::GetNumExecutedLists
+
+	  Summary:  Returns the command lists the last Execute executed
+
+	  Returns:  UINT
+				  Number of command lists
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class BackendType>
+	UINT BasicCommandRecorder<BackendType>::GetNumExecutedLists() const
+	{
+		return m_uNumExecutedLists;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicCommandRecorder<BackendType>::GetRange
+
+	  Summary:  Returns the items of a range. The first
+				uNumItems % uNumRanges ranges hold one item more than
+				the others, so the split only depends on the counts.
+
+	  Args:     UINT uNumItems
+				  Number of items
+				UINT uNumRanges
+				  Number of ranges, at least 1
+				UINT uRange
+				  Index of the range
+				UINT& uOutBegin
+				  First item of the range
+				UINT& uOutEnd
+				  One past the last item of the range
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class BackendType>
+	void BasicCommandRecorder<BackendType>::GetRange(_In_ UINT uNumItems, _In_ UINT uNumRanges, _In_ UINT uRange, _Out_ UINT& uOutBegin, _Out_ UINT& uOutEnd)
+	{
+		const UINT uSize = uNumItems / uNumRanges;
+		const UINT uRemainder = uNumItems % uNumRanges;
+
+		uOutBegin = uRange * uSize + std::min<UINT>(uRange, uRemainder);
+		uOutEnd = uOutBegin + uSize + (uRange < uRemainder ? 1u : 0u);
+	}
+}
@@ -0,0 +1,204 @@
+#include "Renderer/ConstantRing.h"
+
+#include "Renderer/D3D11Backend.h"
+
+#include <algorithm>
+
+namespace library
+{
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ConstantRing::ConstantRing
+
+	  Summary:  Constructor of a ring of the default size
+
+	  Modifies: [m_buffer, m_allocator, m_uSize].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	ConstantRing::ConstantRing()
+		: ConstantRing(DEFAULT_SIZE)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ConstantRing::ConstantRing
+
+	  Summary:  Constructor
+
+	  Args:     UINT uSize
+				  Size of the buffer in bytes
+
+	  Modifies: [m_buffer, m_allocator, m_uSize].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	ConstantRing::ConstantRing(_In_ UINT uSize)
+		: m_buffer()
+		, m_allocator()
+		, m_uSize(uSize & ~(ALIGNMENT - 1u))
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ConstantRing::Initialize
+
+	  Summary:  Creates the dynamic buffer if the device can bind
+				constant buffers by offset and map them without
+				overwriting, otherwise leaves the ring disabled
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the buffer
+				ID3D11DeviceContext1* pImmediateContext1
+				  The Direct3D 11.1 context, null on 11.0 devices
+
+	  Modifies: [m_buffer, m_allocator].
+
+	  Returns:  HRESULT
+				  S_OK if the ring is enabled, S_FALSE if the device
+				  does not support it, an error code otherwise
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT ConstantRing::Initialize(_In_ ID3D11Device* pDevice, _In_opt_ ID3D11DeviceContext1* pImmediateContext1)
+	{
+		m_buffer.Reset();
+
+		if (!pImmediateContext1)
+		{
+			return S_FALSE;
+		}
+
+		D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+		HRESULT hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options));
+		if (FAILED(hr) || !options.ConstantBufferOffsetting || !options.MapNoOverwriteOnDynamicConstantBuffer)
+		{
+			return S_FALSE;
+		}
+
+		D3D11_BUFFER_DESC bd =
+		{
+			.ByteWidth = m_uSize,
+			.Usage = D3D11_USAGE_DYNAMIC,
+			.BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+			.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+			.MiscFlags = 0
+		};
+		hr = pDevice->CreateBuffer(&bd, nullptr, m_buffer.GetAddressOf());
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		m_allocator.Reset(m_uSize, ALIGNMENT);
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ConstantRing::IsEnabled
+
+	  Summary:  Returns whether the device supports the ring
+
+	  Returns:  BOOL
+				  TRUE if constants can be written into the ring
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL ConstantRing::IsEnabled() const
+	{
+		return m_buffer != nullptr;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ConstantRing::BeginFrame
+
+	  Summary:  Starts the writes of a frame, the first one discards
+				the ring and starts it over
+
+	  Modifies: [m_allocator].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void ConstantRing::BeginFrame()
+	{
+		m_allocator.Restart();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ConstantRing::Write
+
+	  Summary:  Copies constants into the next free range of the ring
+
+	  Args:     IRenderContext& context
+				  The immediate context to map the buffer with
+				const void* pData
+				  Constants to copy
+				UINT uDataSize
+				  Bytes to copy
+				UINT uReservedSize
+				  Bytes the range binds, at least uDataSize. Bytes
+				  past uDataSize are left undefined, for constants
+				  the shader declares but never reads.
+
+	  Modifies: [m_allocator].
+
+	  Returns:  UINT
+				  First constant of the range, NO_OFFSET if the ring
+				  is disabled, the frame filled it or the range could
+				  not be written
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT ConstantRing::Write(_Inout_ IRenderContext& context, _In_reads_bytes_(uDataSize) const void* pData, _In_ UINT uDataSize, _In_ UINT uReservedSize)
+	{
+		if (!m_buffer)
+		{
+			return NO_OFFSET;
+		}
+
+		UINT uOffset = 0u;
+		BOOL bWrapped = FALSE;
+		if (!m_allocator.Allocate(std::max<UINT>(uDataSize, uReservedSize), FALSE, uOffset, bWrapped))
+		{
+			return NO_OFFSET;
+		}
+
+		void* pMapped = nullptr;
+		HRESULT hr = context.Map(ToGpu(m_buffer.Get()), 0u, bWrapped ? eMapType::WRITE_DISCARD : eMapType::WRITE_NO_OVERWRITE, &pMapped);
+		if (FAILED(hr))
+		{
+			// A failed discard is retried by the next range, the old
+			// ring may still be in flight. A range later in the frame
+			// is dropped, discarding then would lose the earlier ranges.
+			if (bWrapped)
+			{
+				m_allocator.Restart();
+			}
+			return NO_OFFSET;
+		}
+
+		memcpy(static_cast<BYTE*>(pMapped) + uOffset, pData, uDataSize);
+		context.Unmap(ToGpu(m_buffer.Get()), 0u);
+
+		return uOffset / CONSTANT_SIZE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ConstantRing::GetBuffer
+
+	  Summary:  Returns the ring buffer
+
+	  Returns:  ComPtr<ID3D11Buffer>&
+				  The buffer, null if the ring is disabled
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	ComPtr<ID3D11Buffer>& ConstantRing::GetBuffer()
+	{
+		return m_buffer;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ConstantRing::GetNumConstants
+
+	  Summary:  Returns the constants a range of the given size binds,
+				rounded up to the 16 constant granularity of
+				VSSetConstantBuffers1
+
+	  Args:     UINT uSize
+				  Size of the constants in bytes
+
+	  Returns:  UINT
+				  Number of 16 byte constants
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT ConstantRing::GetNumConstants(_In_ UINT uSize)
+	{
+		return ((uSize + ALIGNMENT - 1u) & ~(ALIGNMENT - 1u)) / CONSTANT_SIZE;
+	}
+}
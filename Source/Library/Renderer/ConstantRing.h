@@ -0,0 +1,89 @@
+/*+===================================================================
+  File:      CONSTANTRING.H
+
+  Summary:   ConstantRing header file contains declarations of
+			 ConstantRing class, one large dynamic constant buffer
+			 that per draw constants are written into and bound from
+			 by offset.
+
+  Classes: ConstantRing
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/RenderDevice.h"
+#include "Renderer/RingAllocator.h"
+
+namespace library
+{
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    ConstantRing
+
+	  Summary:  One large dynamic constant buffer. Each write maps it
+				with MAP_WRITE_NO_OVERWRITE, copies the constants to
+				the next free range and returns the first constant of
+				the range, to bind with VSSetConstantBuffers1. The
+				first write of a frame maps it with MAP_WRITE_DISCARD
+				instead, so the driver hands out fresh memory while
+				the draws of the last frame keep the old one. A frame
+				writes all its constants before its draws are
+				recorded or executed, and a discard in the middle
+				would hide the constants written before it from
+				those draws, so the ring never wraps within a frame:
+				writes that no longer fit return NO_OFFSET and their
+				draws use their own constant buffers. Devices without
+				constant buffer offsetting, Direct3D 11.0, leave the
+				ring disabled and Write returns NO_OFFSET.
+
+	  Methods:  Initialize
+				  Creates the buffer if offsets are supported
+				IsEnabled
+				  Returns whether writes are possible
+				BeginFrame
+				  Makes the next write discard the ring
+				Write
+				  Copies constants into the ring
+				GetBuffer
+				  Returns the buffer
+				GetNumConstants
+				  Returns the constants a range binds
+				ConstantRing
+				  Constructor.
+				~ConstantRing
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class ConstantRing final
+	{
+	public:
+		static constexpr UINT CONSTANT_SIZE = 16u;
+		static constexpr UINT ALIGNMENT = 16u * CONSTANT_SIZE;
+		static constexpr UINT DEFAULT_SIZE = 4u * 1024u * 1024u;
+		static constexpr UINT NO_OFFSET = UINT_MAX;
+
+	public:
+		ConstantRing();
+		explicit ConstantRing(_In_ UINT uSize);
+		ConstantRing(const ConstantRing& other) = delete;
+		ConstantRing(ConstantRing&& other) = delete;
+		ConstantRing& operator=(const ConstantRing& other) = delete;
+		ConstantRing& operator=(ConstantRing&& other) = delete;
+		~ConstantRing() = default;
+
+		HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_opt_ ID3D11DeviceContext1* pImmediateContext1);
+		BOOL IsEnabled() const;
+
+		void BeginFrame();
+		UINT Write(_Inout_ IRenderContext& context, _In_reads_bytes_(uDataSize) const void* pData, _In_ UINT uDataSize, _In_ UINT uReservedSize);
+		ComPtr<ID3D11Buffer>& GetBuffer();
+
+		static UINT GetNumConstants(_In_ UINT uSize);
+
+	private:
+		ComPtr<ID3D11Buffer> m_buffer;
+		RingAllocator m_allocator;
+		UINT m_uSize;
+	};
+}
@@ -0,0 +1,494 @@
+#include "Renderer/D3D11Backend.h"
+
+#include <cstddef>
+
+namespace library
+{
+	static_assert(sizeof(GpuViewport) == sizeof(D3D11_VIEWPORT) && offsetof(GpuViewport, MaxDepth) == offsetof(D3D11_VIEWPORT, MaxDepth));
+	static_assert(sizeof(GpuBox) == sizeof(D3D11_BOX) && offsetof(GpuBox, back) == offsetof(D3D11_BOX, back));
+	static_assert(static_cast<UINT>(ePrimitiveTopology::TRIANGLE_LIST) == D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	static_assert(static_cast<UINT>(eMapType::WRITE_DISCARD) == D3D11_MAP_WRITE_DISCARD && static_cast<UINT>(eMapType::WRITE_NO_OVERWRITE) == D3D11_MAP_WRITE_NO_OVERWRITE);
+	static_assert(IRenderContext::CLEAR_DEPTH == D3D11_CLEAR_DEPTH && IRenderContext::CLEAR_STENCIL == D3D11_CLEAR_STENCIL);
+	static_assert(IRenderContext::MAX_VERTEX_BUFFERS == D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+	static_assert(IRenderContext::MAX_CONSTANT_BUFFERS == D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT);
+	static_assert(IRenderContext::MAX_SHADER_RESOURCES == D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT);
+	static_assert(IRenderContext::MAX_SAMPLERS == D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT);
+	static_assert(IRenderContext::MAX_RENDER_TARGETS == D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT);
+	static_assert(IRenderContext::MAX_VIEWPORTS == D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE);
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11CommandList::D3D11CommandList
+
+	  Summary:  Constructor
+
+	  Args:     ComPtr<ID3D11CommandList>&& commandList
+				  The finished command list
+
+	  Modifies: [m_commandList].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	D3D11CommandList::D3D11CommandList(_In_ ComPtr<ID3D11CommandList>&& commandList)
+		: m_commandList(std::move(commandList))
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11CommandList::GetCommandList
+
+	  Summary:  Returns the Direct3D command list
+
+	  Returns:  ID3D11CommandList*
+				  The command list
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	ID3D11CommandList* D3D11CommandList::GetCommandList() const
+	{
+		return m_commandList.Get();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::D3D11RenderContext
+
+	  Summary:  Constructor
+
+	  Modifies: [m_context, m_context1].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	D3D11RenderContext::D3D11RenderContext()
+		: m_context()
+		, m_context1()
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::Initialize
+
+	  Summary:  Sets the wrapped device context and queries its 11.1
+				interface
+
+	  Args:     ID3D11DeviceContext* pContext
+				  The device context, immediate or deferred
+
+	  Modifies: [m_context, m_context1].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::Initialize(_In_ ID3D11DeviceContext* pContext)
+	{
+		m_context = pContext;
+		m_context1.Reset();
+		m_context.As(&m_context1);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::GetContext
+
+	  Summary:  Returns the wrapped device context
+
+	  Returns:  ID3D11DeviceContext*
+				  The device context
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	ID3D11DeviceContext* D3D11RenderContext::GetContext() const
+	{
+		return m_context.Get();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::IASetInputLayout
+
+	  Summary:  Forwards to ID3D11DeviceContext::IASetInputLayout
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::IASetInputLayout(_In_opt_ GpuInputLayout* pInputLayout)
+	{
+		m_context->IASetInputLayout(ToD3D11(pInputLayout));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::IASetVertexBuffers
+
+	  Summary:  Forwards to ID3D11DeviceContext::IASetVertexBuffers
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::IASetVertexBuffers(
+		_In_ UINT uStartSlot,
+		_In_ UINT uNumBuffers,
+		_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppVertexBuffers,
+		_In_reads_opt_(uNumBuffers) const UINT* puStrides,
+		_In_reads_opt_(uNumBuffers) const UINT* puOffsets
+	)
+	{
+		m_context->IASetVertexBuffers(uStartSlot, uNumBuffers, ToD3D11(ppVertexBuffers), puStrides, puOffsets);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::IASetIndexBuffer
+
+	  Summary:  Forwards to ID3D11DeviceContext::IASetIndexBuffer
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::IASetIndexBuffer(_In_opt_ GpuBuffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset)
+	{
+		m_context->IASetIndexBuffer(ToD3D11(pIndexBuffer), format, uOffset);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::IASetPrimitiveTopology
+
+	  Summary:  Forwards to ID3D11DeviceContext::IASetPrimitiveTopology
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::IASetPrimitiveTopology(_In_ ePrimitiveTopology topology)
+	{
+		m_context->IASetPrimitiveTopology(static_cast<D3D11_PRIMITIVE_TOPOLOGY>(topology));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::VSSetShader
+
+	  Summary:  Forwards to ID3D11DeviceContext::VSSetShader without
+				class instances
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::VSSetShader(_In_opt_ GpuVertexShader* pVertexShader)
+	{
+		m_context->VSSetShader(ToD3D11(pVertexShader), nullptr, 0u);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::PSSetShader
+
+	  Summary:  Forwards to ID3D11DeviceContext::PSSetShader without
+				class instances
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::PSSetShader(_In_opt_ GpuPixelShader* pPixelShader)
+	{
+		m_context->PSSetShader(ToD3D11(pPixelShader), nullptr, 0u);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::VSSetConstantBuffers
+
+	  Summary:  Forwards to ID3D11DeviceContext::VSSetConstantBuffers
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::VSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers)
+	{
+		m_context->VSSetConstantBuffers(uStartSlot, uNumBuffers, ToD3D11(ppConstantBuffers));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::PSSetConstantBuffers
+
+	  Summary:  Forwards to ID3D11DeviceContext::PSSetConstantBuffers
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::PSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers)
+	{
+		m_context->PSSetConstantBuffers(uStartSlot, uNumBuffers, ToD3D11(ppConstantBuffers));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::VSSetConstantBuffers1
+
+	  Summary:  Forwards to ID3D11DeviceContext1::VSSetConstantBuffers1,
+				the caller checks HasConstantBufferOffsets first
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::VSSetConstantBuffers1(
+		_In_ UINT uStartSlot,
+		_In_ UINT uNumBuffers,
+		_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers,
+		_In_reads_opt_(uNumBuffers) const UINT* puFirstConstant,
+		_In_reads_opt_(uNumBuffers) const UINT* puNumConstants
+	)
+	{
+		assert(m_context1);
+		m_context1->VSSetConstantBuffers1(uStartSlot, uNumBuffers, ToD3D11(ppConstantBuffers), puFirstConstant, puNumConstants);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::PSSetConstantBuffers1
+
+	  Summary:  Forwards to ID3D11DeviceContext1::PSSetConstantBuffers1,
+				the caller checks HasConstantBufferOffsets first
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::PSSetConstantBuffers1(
+		_In_ UINT uStartSlot,
+		_In_ UINT uNumBuffers,
+		_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers,
+		_In_reads_opt_(uNumBuffers) const UINT* puFirstConstant,
+		_In_reads_opt_(uNumBuffers) const UINT* puNumConstants
+	)
+	{
+		assert(m_context1);
+		m_context1->PSSetConstantBuffers1(uStartSlot, uNumBuffers, ToD3D11(ppConstantBuffers), puFirstConstant, puNumConstants);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::VSSetShaderResources
+
+	  Summary:  Forwards to ID3D11DeviceContext::VSSetShaderResources
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::VSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuShaderResourceView* const* ppShaderResourceViews)
+	{
+		m_context->VSSetShaderResources(uStartSlot, uNumViews, ToD3D11(ppShaderResourceViews));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::PSSetShaderResources
+
+	  Summary:  Forwards to ID3D11DeviceContext::PSSetShaderResources
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::PSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuShaderResourceView* const* ppShaderResourceViews)
+	{
+		m_context->PSSetShaderResources(uStartSlot, uNumViews, ToD3D11(ppShaderResourceViews));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::PSSetSamplers
+
+	  Summary:  Forwards to ID3D11DeviceContext::PSSetSamplers
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::PSSetSamplers(_In_ UINT uStartSlot, _In_ UINT uNumSamplers, _In_reads_opt_(uNumSamplers) GpuSamplerState* const* ppSamplers)
+	{
+		m_context->PSSetSamplers(uStartSlot, uNumSamplers, ToD3D11(ppSamplers));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::OMSetRenderTargets
+
+	  Summary:  Forwards to ID3D11DeviceContext::OMSetRenderTargets
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::OMSetRenderTargets(_In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuRenderTargetView* const* ppRenderTargetViews, _In_opt_ GpuDepthStencilView* pDepthStencilView)
+	{
+		m_context->OMSetRenderTargets(uNumViews, ToD3D11(ppRenderTargetViews), ToD3D11(pDepthStencilView));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::RSSetViewports
+
+	  Summary:  Forwards to ID3D11DeviceContext::RSSetViewports
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::RSSetViewports(_In_ UINT uNumViewports, _In_reads_opt_(uNumViewports) const GpuViewport* pViewports)
+	{
+		m_context->RSSetViewports(uNumViewports, reinterpret_cast<const D3D11_VIEWPORT*>(pViewports));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::ClearRenderTargetView
+
+	  Summary:  Forwards to ID3D11DeviceContext::ClearRenderTargetView
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::ClearRenderTargetView(_In_ GpuRenderTargetView* pRenderTargetView, _In_ const FLOAT colorRGBA[4])
+	{
+		m_context->ClearRenderTargetView(ToD3D11(pRenderTargetView), colorRGBA);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::ClearDepthStencilView
+
+	  Summary:  Forwards to ID3D11DeviceContext::ClearDepthStencilView
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::ClearDepthStencilView(_In_ GpuDepthStencilView* pDepthStencilView, _In_ UINT uClearFlags, _In_ FLOAT depth, _In_ UINT8 stencil)
+	{
+		m_context->ClearDepthStencilView(ToD3D11(pDepthStencilView), uClearFlags, depth, stencil);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::UpdateSubresource
+
+	  Summary:  Forwards to ID3D11DeviceContext::UpdateSubresource
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::UpdateSubresource(
+		_In_ GpuResource* pDstResource,
+		_In_ UINT uDstSubresource,
+		_In_opt_ const GpuBox* pDstBox,
+		_In_ const void* pSrcData,
+		_In_ UINT uSrcRowPitch,
+		_In_ UINT uSrcDepthPitch
+	)
+	{
+		m_context->UpdateSubresource(ToD3D11(pDstResource), uDstSubresource, reinterpret_cast<const D3D11_BOX*>(pDstBox), pSrcData, uSrcRowPitch, uSrcDepthPitch);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::Map
+
+	  Summary:  Forwards to ID3D11DeviceContext::Map
+
+	  Args:     GpuResource* pResource
+				  Mapped resource
+				UINT uSubresource
+				  Mapped subresource
+				eMapType mapType
+				  How the memory is written
+				void** ppData
+				  Receives the mapped memory
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT D3D11RenderContext::Map(_In_ GpuResource* pResource, _In_ UINT uSubresource, _In_ eMapType mapType, _Out_ void** ppData)
+	{
+		D3D11_MAPPED_SUBRESOURCE mapped = {};
+		HRESULT hr = m_context->Map(ToD3D11(pResource), uSubresource, static_cast<D3D11_MAP>(mapType), 0u, &mapped);
+		*ppData = SUCCEEDED(hr) ? mapped.pData : nullptr;
+
+		return hr;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::Unmap
+
+	  Summary:  Forwards to ID3D11DeviceContext::Unmap
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::Unmap(_In_ GpuResource* pResource, _In_ UINT uSubresource)
+	{
+		m_context->Unmap(ToD3D11(pResource), uSubresource);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::DrawIndexed
+
+	  Summary:  Forwards to ID3D11DeviceContext::DrawIndexed
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndexLocation, _In_ INT baseVertexLocation)
+	{
+		m_context->DrawIndexed(uIndexCount, uStartIndexLocation, baseVertexLocation);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::DrawIndexedInstanced
+
+	  Summary:  Forwards to ID3D11DeviceContext::DrawIndexedInstanced
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::DrawIndexedInstanced(
+		_In_ UINT uIndexCountPerInstance,
+		_In_ UINT uInstanceCount,
+		_In_ UINT uStartIndexLocation,
+		_In_ INT baseVertexLocation,
+		_In_ UINT uStartInstanceLocation
+	)
+	{
+		m_context->DrawIndexedInstanced(uIndexCountPerInstance, uInstanceCount, uStartIndexLocation, baseVertexLocation, uStartInstanceLocation);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::HasConstantBufferOffsets
+
+	  Summary:  Returns whether the context has the 11.1 interface
+				that binds constant buffer ranges
+
+	  Returns:  BOOL
+				  TRUE if VSSetConstantBuffers1 may be called
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL D3D11RenderContext::HasConstantBufferOffsets() const
+	{
+		return m_context1 != nullptr;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::FinishCommandList
+
+	  Summary:  Turns what a deferred context recorded into a command
+				list. The context is back in the default state after.
+
+	  Args:     std::unique_ptr<IRenderCommandList>& outList
+				  Receives the command list
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT D3D11RenderContext::FinishCommandList(_Out_ std::unique_ptr<IRenderCommandList>& outList)
+	{
+		ComPtr<ID3D11CommandList> commandList;
+		HRESULT hr = m_context->FinishCommandList(FALSE, commandList.GetAddressOf());
+		if (FAILED(hr))
+		{
+			outList.reset();
+			return hr;
+		}
+
+		outList = std::make_unique<D3D11CommandList>(std::move(commandList));
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderContext::ExecuteCommandList
+
+	  Summary:  Executes a command list a deferred Direct3D context
+				finished. The context is back in the default state
+				after.
+
+	  Args:     IRenderCommandList& list
+				  The command list
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderContext::ExecuteCommandList(_In_ IRenderCommandList& list)
+	{
+		m_context->ExecuteCommandList(static_cast<D3D11CommandList&>(list).GetCommandList(), FALSE);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderDevice::D3D11RenderDevice
+
+	  Summary:  Constructor
+
+	  Modifies: [m_device, m_bDriverCommandLists].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	D3D11RenderDevice::D3D11RenderDevice()
+		: m_device()
+		, m_bDriverCommandLists(FALSE)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderDevice::Initialize
+
+	  Summary:  Sets the device the deferred contexts are created on
+				and checks whether its driver records command lists
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device
+
+	  Modifies: [m_device, m_bDriverCommandLists].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void D3D11RenderDevice::Initialize(_In_ ID3D11Device* pDevice)
+	{
+		m_device = pDevice;
+
+		D3D11_FEATURE_DATA_THREADING threading = {};
+		HRESULT hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading));
+		m_bDriverCommandLists = SUCCEEDED(hr) && threading.DriverCommandLists;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderDevice::CreateDeferredContext
+
+	  Summary:  Creates a deferred context
+
+	  Args:     std::unique_ptr<IRenderContext>& outContext
+				  Receives the context
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT D3D11RenderDevice::CreateDeferredContext(_Out_ std::unique_ptr<IRenderContext>& outContext)
+	{
+		ComPtr<ID3D11DeviceContext> deferredContext;
+		HRESULT hr = m_device->CreateDeferredContext(0u, deferredContext.GetAddressOf());
+		if (FAILED(hr))
+		{
+			outContext.reset();
+			return hr;
+		}
+
+		std::unique_ptr<D3D11RenderContext> context = std::make_unique<D3D11RenderContext>();
+		context->Initialize(deferredContext.Get());
+		outContext = std::move(context);
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   D3D11RenderDevice::HasDriverCommandLists
+
+	  Summary:  Returns whether the driver records command lists
+				itself instead of leaving it to the runtime
+
+	  Returns:  BOOL
+				  TRUE if command lists are native
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL D3D11RenderDevice::HasDriverCommandLists() const
+	{
+		return m_bDriverCommandLists;
+	}
+}
@@ -0,0 +1,244 @@
+/*+===================================================================
+  File:      D3D11BACKEND.H
+
+  Summary:   D3D11Backend header file contains declarations of the
+			 Direct3D 11 implementation of the render interfaces:
+			 D3D11RenderContext that forwards to a device context,
+			 D3D11CommandList that holds an ID3D11CommandList, and
+			 D3D11RenderDevice that creates deferred contexts, and
+			 of the functions that turn Direct3D objects into
+			 handles and back.
+
+  Classes: D3D11RenderContext, D3D11CommandList, D3D11RenderDevice
+
+  Functions: ToGpu, ToD3D11
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/RenderDevice.h"
+
+namespace library
+{
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: ToGpu
+
+	  Summary:  Returns the handle of a Direct3D object, or of an
+				array of them. A handle is the interface pointer
+				itself, so the conversion costs nothing.
+
+	  Args:     ID3D11... * p
+				  The object, or the array of objects
+
+	  Returns:  Gpu...*
+				  The handle, or the array of handles
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	inline GpuResource* ToGpu(_In_opt_ ID3D11Resource* p) { return reinterpret_cast<GpuResource*>(p); }
+	inline GpuBuffer* ToGpu(_In_opt_ ID3D11Buffer* p) { return reinterpret_cast<GpuBuffer*>(p); }
+	inline GpuTexture2D* ToGpu(_In_opt_ ID3D11Texture2D* p) { return reinterpret_cast<GpuTexture2D*>(p); }
+	inline GpuInputLayout* ToGpu(_In_opt_ ID3D11InputLayout* p) { return reinterpret_cast<GpuInputLayout*>(p); }
+	inline GpuVertexShader* ToGpu(_In_opt_ ID3D11VertexShader* p) { return reinterpret_cast<GpuVertexShader*>(p); }
+	inline GpuPixelShader* ToGpu(_In_opt_ ID3D11PixelShader* p) { return reinterpret_cast<GpuPixelShader*>(p); }
+	inline GpuShaderResourceView* ToGpu(_In_opt_ ID3D11ShaderResourceView* p) { return reinterpret_cast<GpuShaderResourceView*>(p); }
+	inline GpuSamplerState* ToGpu(_In_opt_ ID3D11SamplerState* p) { return reinterpret_cast<GpuSamplerState*>(p); }
+	inline GpuRenderTargetView* ToGpu(_In_opt_ ID3D11RenderTargetView* p) { return reinterpret_cast<GpuRenderTargetView*>(p); }
+	inline GpuDepthStencilView* ToGpu(_In_opt_ ID3D11DepthStencilView* p) { return reinterpret_cast<GpuDepthStencilView*>(p); }
+
+	inline GpuBuffer* const* ToGpu(_In_opt_ ID3D11Buffer* const* pp) { return reinterpret_cast<GpuBuffer* const*>(pp); }
+	inline GpuShaderResourceView* const* ToGpu(_In_opt_ ID3D11ShaderResourceView* const* pp) { return reinterpret_cast<GpuShaderResourceView* const*>(pp); }
+	inline GpuSamplerState* const* ToGpu(_In_opt_ ID3D11SamplerState* const* pp) { return reinterpret_cast<GpuSamplerState* const*>(pp); }
+	inline GpuRenderTargetView* const* ToGpu(_In_opt_ ID3D11RenderTargetView* const* pp) { return reinterpret_cast<GpuRenderTargetView* const*>(pp); }
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: ToD3D11
+
+	  Summary:  Returns the Direct3D object of a handle ToGpu made, or
+				of an array of them
+
+	  Args:     Gpu...* p
+				  The handle, or the array of handles
+
+	  Returns:  ID3D11...*
+				  The object, or the array of objects
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	inline ID3D11Resource* ToD3D11(_In_opt_ GpuResource* p) { return reinterpret_cast<ID3D11Resource*>(p); }
+	inline ID3D11Buffer* ToD3D11(_In_opt_ GpuBuffer* p) { return reinterpret_cast<ID3D11Buffer*>(p); }
+	inline ID3D11InputLayout* ToD3D11(_In_opt_ GpuInputLayout* p) { return reinterpret_cast<ID3D11InputLayout*>(p); }
+	inline ID3D11VertexShader* ToD3D11(_In_opt_ GpuVertexShader* p) { return reinterpret_cast<ID3D11VertexShader*>(p); }
+	inline ID3D11PixelShader* ToD3D11(_In_opt_ GpuPixelShader* p) { return reinterpret_cast<ID3D11PixelShader*>(p); }
+	inline ID3D11RenderTargetView* ToD3D11(_In_opt_ GpuRenderTargetView* p) { return reinterpret_cast<ID3D11RenderTargetView*>(p); }
+	inline ID3D11DepthStencilView* ToD3D11(_In_opt_ GpuDepthStencilView* p) { return reinterpret_cast<ID3D11DepthStencilView*>(p); }
+
+	inline ID3D11Buffer* const* ToD3D11(_In_opt_ GpuBuffer* const* pp) { return reinterpret_cast<ID3D11Buffer* const*>(pp); }
+	inline ID3D11ShaderResourceView* const* ToD3D11(_In_opt_ GpuShaderResourceView* const* pp) { return reinterpret_cast<ID3D11ShaderResourceView* const*>(pp); }
+	inline ID3D11SamplerState* const* ToD3D11(_In_opt_ GpuSamplerState* const* pp) { return reinterpret_cast<ID3D11SamplerState* const*>(pp); }
+	inline ID3D11RenderTargetView* const* ToD3D11(_In_opt_ GpuRenderTargetView* const* pp) { return reinterpret_cast<ID3D11RenderTargetView* const*>(pp); }
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    D3D11CommandList
+
+	  Summary:  A command list a deferred Direct3D context finished
+
+	  Methods:  GetCommandList
+				  Returns the Direct3D command list
+				D3D11CommandList
+				  Constructor.
+				~D3D11CommandList
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class D3D11CommandList final : public IRenderCommandList
+	{
+	public:
+		explicit D3D11CommandList(_In_ ComPtr<ID3D11CommandList>&& commandList);
+		D3D11CommandList(const D3D11CommandList& other) = delete;
+		D3D11CommandList(D3D11CommandList&& other) = delete;
+		D3D11CommandList& operator=(const D3D11CommandList& other) = delete;
+		D3D11CommandList& operator=(D3D11CommandList&& other) = delete;
+		~D3D11CommandList() override = default;
+
+		ID3D11CommandList* GetCommandList() const;
+
+	private:
+		ComPtr<ID3D11CommandList> m_commandList;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    D3D11RenderContext
+
+	  Summary:  Forwards the calls of IRenderContext to a Direct3D 11
+				device context, turning the handles back into the
+				objects. Constant buffer ranges need the 11.1
+				interface, which 11.0 devices do not have.
+
+	  Methods:  Initialize
+				  Sets the wrapped device context
+				GetContext
+				  Returns the wrapped device context
+				(IRenderContext methods)
+				  Forwarded to the device context
+				D3D11RenderContext
+				  Constructor.
+				~D3D11RenderContext
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class D3D11RenderContext final : public IRenderContext
+	{
+	public:
+		D3D11RenderContext();
+		D3D11RenderContext(const D3D11RenderContext& other) = delete;
+		D3D11RenderContext(D3D11RenderContext&& other) = delete;
+		D3D11RenderContext& operator=(const D3D11RenderContext& other) = delete;
+		D3D11RenderContext& operator=(D3D11RenderContext&& other) = delete;
+		~D3D11RenderContext() override = default;
+
+		void Initialize(_In_ ID3D11DeviceContext* pContext);
+		ID3D11DeviceContext* GetContext() const;
+
+		void IASetInputLayout(_In_opt_ GpuInputLayout* pInputLayout) override;
+		void IASetVertexBuffers(
+			_In_ UINT uStartSlot,
+			_In_ UINT uNumBuffers,
+			_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppVertexBuffers,
+			_In_reads_opt_(uNumBuffers) const UINT* puStrides,
+			_In_reads_opt_(uNumBuffers) const UINT* puOffsets
+		) override;
+		void IASetIndexBuffer(_In_opt_ GpuBuffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset) override;
+		void IASetPrimitiveTopology(_In_ ePrimitiveTopology topology) override;
+
+		void VSSetShader(_In_opt_ GpuVertexShader* pVertexShader) override;
+		void PSSetShader(_In_opt_ GpuPixelShader* pPixelShader) override;
+
+		void VSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers) override;
+		void PSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers) override;
+		void VSSetConstantBuffers1(
+			_In_ UINT uStartSlot,
+			_In_ UINT uNumBuffers,
+			_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers,
+			_In_reads_opt_(uNumBuffers) const UINT* puFirstConstant,
+			_In_reads_opt_(uNumBuffers) const UINT* puNumConstants
+		) override;
+		void PSSetConstantBuffers1(
+			_In_ UINT uStartSlot,
+			_In_ UINT uNumBuffers,
+			_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers,
+			_In_reads_opt_(uNumBuffers) const UINT* puFirstConstant,
+			_In_reads_opt_(uNumBuffers) const UINT* puNumConstants
+		) override;
+		void VSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuShaderResourceView* const* ppShaderResourceViews) override;
+		void PSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuShaderResourceView* const* ppShaderResourceViews) override;
+		void PSSetSamplers(_In_ UINT uStartSlot, _In_ UINT uNumSamplers, _In_reads_opt_(uNumSamplers) GpuSamplerState* const* ppSamplers) override;
+
+		void OMSetRenderTargets(_In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuRenderTargetView* const* ppRenderTargetViews, _In_opt_ GpuDepthStencilView* pDepthStencilView) override;
+		void RSSetViewports(_In_ UINT uNumViewports, _In_reads_opt_(uNumViewports) const GpuViewport* pViewports) override;
+		void ClearRenderTargetView(_In_ GpuRenderTargetView* pRenderTargetView, _In_ const FLOAT colorRGBA[4]) override;
+		void ClearDepthStencilView(_In_ GpuDepthStencilView* pDepthStencilView, _In_ UINT uClearFlags, _In_ FLOAT depth, _In_ UINT8 stencil) override;
+
+		void UpdateSubresource(
+			_In_ GpuResource* pDstResource,
+			_In_ UINT uDstSubresource,
+			_In_opt_ const GpuBox* pDstBox,
+			_In_ const void* pSrcData,
+			_In_ UINT uSrcRowPitch,
+			_In_ UINT uSrcDepthPitch
+		) override;
+		HRESULT Map(_In_ GpuResource* pResource, _In_ UINT uSubresource, _In_ eMapType mapType, _Out_ void** ppData) override;
+		void Unmap(_In_ GpuResource* pResource, _In_ UINT uSubresource) override;
+
+		void DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndexLocation, _In_ INT baseVertexLocation) override;
+		void DrawIndexedInstanced(
+			_In_ UINT uIndexCountPerInstance,
+			_In_ UINT uInstanceCount,
+			_In_ UINT uStartIndexLocation,
+			_In_ INT baseVertexLocation,
+			_In_ UINT uStartInstanceLocation
+		) override;
+
+		BOOL HasConstantBufferOffsets() const override;
+		HRESULT FinishCommandList(_Out_ std::unique_ptr<IRenderCommandList>& outList) override;
+		void ExecuteCommandList(_In_ IRenderCommandList& list) override;
+
+	private:
+		ComPtr<ID3D11DeviceContext> m_context;
+		ComPtr<ID3D11DeviceContext1> m_context1;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    D3D11RenderDevice
+
+	  Summary:  Creates deferred Direct3D 11 contexts. Drivers without
+				command lists still work, the runtime records for them.
+
+	  Methods:  Initialize
+				  Sets the device and checks for driver command lists
+				CreateDeferredContext
+				  Creates a deferred context
+				HasDriverCommandLists
+				  Returns whether the driver records natively
+				D3D11RenderDevice
+				  Constructor.
+				~D3D11RenderDevice
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class D3D11RenderDevice final : public IRenderDevice
+	{
+	public:
+		D3D11RenderDevice();
+		D3D11RenderDevice(const D3D11RenderDevice& other) = delete;
+		D3D11RenderDevice(D3D11RenderDevice&& other) = delete;
+		D3D11RenderDevice& operator=(const D3D11RenderDevice& other) = delete;
+		D3D11RenderDevice& operator=(D3D11RenderDevice&& other) = delete;
+		~D3D11RenderDevice() override = default;
+
+		void Initialize(_In_ ID3D11Device* pDevice);
+
+		HRESULT CreateDeferredContext(_Out_ std::unique_ptr<IRenderContext>& outContext) override;
+		BOOL HasDriverCommandLists() const override;
+
+	private:
+		ComPtr<ID3D11Device> m_device;
+		BOOL m_bDriverCommandLists;
+	};
+}
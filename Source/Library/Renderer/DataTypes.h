@@ -5,7 +5,6 @@
 namespace library
 {
 #define NUM_LIGHTS (1)
-#define MAX_NUM_BONES (256)
 #define MAX_NUM_BONES_PER_VERTEX (16)
 
 	struct SimpleVertex
@@ -18,6 +17,7 @@ namespace library
 	struct InstanceData
 	{
 		XMMATRIX Transformation;
+		UINT BlockSlice;
 	};
 
 	struct AnimationData
@@ -48,11 +48,16 @@ namespace library
 		XMMATRIX World;
 		XMFLOAT4 OutputColor;
 		BOOL HasNormalMap;
+		BOOL HasTwoChannelNormalMap;
+		BOOL HasBlockTextures;
 	};
 
 	struct CBSkinning
 	{
-		XMMATRIX BoneTransforms[MAX_NUM_BONES];
+		UINT BoneOffset;
+		UINT NumBones;
+		UINT BoneFormat;
+		UINT Padding;
 	};
 
 	struct PointLightData
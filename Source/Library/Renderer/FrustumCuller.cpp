@@ -0,0 +1,561 @@
+#include "Renderer/FrustumCuller.h"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace library
+{
+	namespace
+	{
+		void setLane(_Inout_ XMFLOAT4A& vector, _In_ UINT uLane, _In_ FLOAT value)
+		{
+			(&vector.x)[uLane] = value;
+		}
+
+		FLOAT getLane(_In_ const XMFLOAT4A& vector, _In_ UINT uLane)
+		{
+			return (&vector.x)[uLane];
+		}
+
+		const XMFLOAT3* getPosition(_In_ const XMFLOAT3* pPositions, _In_ UINT uVertexStride, _In_ UINT uVertex)
+		{
+			return reinterpret_cast<const XMFLOAT3*>(reinterpret_cast<const BYTE*>(pPositions) + static_cast<SIZE_T>(uVertex) * uVertexStride);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::FrustumCuller
+
+	  Summary:  Constructor. Every bounds is visible until
+				SetViewProjection is called.
+
+	  Modifies: [m_aPlanes, m_aBatches, m_aVisible, m_uNumBounds,
+				 m_uNumVisible].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	FrustumCuller::FrustumCuller()
+		: m_aPlanes()
+		, m_aBatches()
+		, m_aVisible()
+		, m_uNumBounds(0u)
+		, m_uNumVisible(0u)
+	{
+		for (XMFLOAT4A& plane : m_aPlanes)
+		{
+			plane = XMFLOAT4A(0.0f, 0.0f, 0.0f, 1.0f);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::SetViewProjection
+
+	  Summary:  Extracts the six frustum planes from the combined
+				view and projection matrix, normals pointing inside
+				and normalized so plane distances are world units
+
+	  Args:     FXMMATRIX viewProjection
+				  View matrix times projection matrix
+
+	  Modifies: [m_aPlanes].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void FrustumCuller::SetViewProjection(_In_ FXMMATRIX viewProjection)
+	{
+		// Rows of the transpose are the columns the clip coordinates come from
+		const XMMATRIX columns = XMMatrixTranspose(viewProjection);
+
+		const XMVECTOR aPlanes[NUM_PLANES] =
+		{
+			XMVectorAdd(columns.r[3], columns.r[0]),		// left
+			XMVectorSubtract(columns.r[3], columns.r[0]),	// right
+			XMVectorAdd(columns.r[3], columns.r[1]),		// bottom
+			XMVectorSubtract(columns.r[3], columns.r[1]),	// top
+			columns.r[2],									// near, depth starts at 0
+			XMVectorSubtract(columns.r[3], columns.r[2]),	// far
+		};
+
+		for (UINT i = 0u; i < NUM_PLANES; ++i)
+		{
+			XMStoreFloat4A(&m_aPlanes[i], XMPlaneNormalize(aPlanes[i]));
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::Reset
+
+	  Summary:  Removes every bounds, keeping the memory for the next
+				frame
+
+	  Modifies: [m_aBatches, m_aVisible, m_uNumBounds, m_uNumVisible].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void FrustumCuller::Reset()
+	{
+		m_aBatches.clear();
+		m_aVisible.clear();
+		m_uNumBounds = 0u;
+		m_uNumVisible = 0u;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::AddBounds
+
+	  Summary:  Transforms the bounds of a mesh to world space and adds
+				them to the next Cull
+
+	  Args:     const MeshBounds& bounds
+				  Bounds in the space of the mesh
+				FXMMATRIX world
+				  World matrix of the mesh
+
+	  Modifies: [m_aBatches, m_uNumBounds].
+
+	  Returns:  UINT
+				  Index to pass to IsVisible
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT FrustumCuller::AddBounds(_In_ const MeshBounds& bounds, _In_ FXMMATRIX world)
+	{
+		const UINT uLane = m_uNumBounds % 4u;
+		if (uLane == 0u)
+		{
+			m_aBatches.push_back(BoundsBatch());
+		}
+
+		MeshBounds worldBounds =
+		{
+			.Center = XMFLOAT3(0.0f, 0.0f, 0.0f),
+			.Extents = XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX),
+			.Radius = FLT_MAX
+		};
+		if (bounds.Radius >= 0.0f)
+		{
+			worldBounds = TransformBounds(bounds, world);
+		}
+
+		BoundsBatch& batch = m_aBatches.back();
+		setLane(batch.CenterX, uLane, worldBounds.Center.x);
+		setLane(batch.CenterY, uLane, worldBounds.Center.y);
+		setLane(batch.CenterZ, uLane, worldBounds.Center.z);
+		setLane(batch.ExtentX, uLane, worldBounds.Extents.x);
+		setLane(batch.ExtentY, uLane, worldBounds.Extents.y);
+		setLane(batch.ExtentZ, uLane, worldBounds.Extents.z);
+		setLane(batch.Radius, uLane, worldBounds.Radius);
+
+		return m_uNumBounds++;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::AddHidden
+
+	  Summary:  Adds bounds that fail the next Cull without being
+				transformed, for the meshes of an object a coarser
+				query already found outside the frustum, so indices
+				stay in the order the meshes are drawn
+
+	  Args:     UINT uNumBounds
+				  Number of bounds to add
+
+	  Modifies: [m_aBatches, m_uNumBounds].
+
+	  Returns:  UINT
+				  Index of the first bounds added
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT FrustumCuller::AddHidden(_In_ UINT uNumBounds)
+	{
+		const UINT uFirstIndex = m_uNumBounds;
+		for (UINT i = 0u; i < uNumBounds; ++i)
+		{
+			const UINT uLane = m_uNumBounds % 4u;
+			if (uLane == 0u)
+			{
+				m_aBatches.push_back(BoundsBatch());
+			}
+
+			// Negative extents and radius put the bounds behind every plane
+			BoundsBatch& batch = m_aBatches.back();
+			setLane(batch.CenterX, uLane, 0.0f);
+			setLane(batch.CenterY, uLane, 0.0f);
+			setLane(batch.CenterZ, uLane, 0.0f);
+			setLane(batch.ExtentX, uLane, -FLT_MAX);
+			setLane(batch.ExtentY, uLane, -FLT_MAX);
+			setLane(batch.ExtentZ, uLane, -FLT_MAX);
+			setLane(batch.Radius, uLane, -FLT_MAX);
+
+			++m_uNumBounds;
+		}
+
+		return uFirstIndex;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::Cull
+
+	  Summary:  Tests every bounds added since Reset against the
+				frustum. For each plane, the distance of the centers
+				and the projected radius of the boxes are computed
+				for four bounds at once; the smaller of the box and
+				sphere radius decides, as both enclose the mesh.
+
+	  Modifies: [m_aVisible, m_uNumVisible].
+
+	  Returns:  UINT
+				  Number of visible bounds
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT FrustumCuller::Cull()
+	{
+		XMVECTOR aPlaneX[NUM_PLANES];
+		XMVECTOR aPlaneY[NUM_PLANES];
+		XMVECTOR aPlaneZ[NUM_PLANES];
+		XMVECTOR aPlaneW[NUM_PLANES];
+		for (UINT i = 0u; i < NUM_PLANES; ++i)
+		{
+			aPlaneX[i] = XMVectorReplicate(m_aPlanes[i].x);
+			aPlaneY[i] = XMVectorReplicate(m_aPlanes[i].y);
+			aPlaneZ[i] = XMVectorReplicate(m_aPlanes[i].z);
+			aPlaneW[i] = XMVectorReplicate(m_aPlanes[i].w);
+		}
+
+		m_aVisible.assign(m_uNumBounds, FALSE);
+		m_uNumVisible = 0u;
+
+		for (UINT uBatch = 0u; uBatch < m_aBatches.size(); ++uBatch)
+		{
+			const BoundsBatch& batch = m_aBatches[uBatch];
+			const XMVECTOR centerX = XMLoadFloat4A(&batch.CenterX);
+			const XMVECTOR centerY = XMLoadFloat4A(&batch.CenterY);
+			const XMVECTOR centerZ = XMLoadFloat4A(&batch.CenterZ);
+			const XMVECTOR extentX = XMLoadFloat4A(&batch.ExtentX);
+			const XMVECTOR extentY = XMLoadFloat4A(&batch.ExtentY);
+			const XMVECTOR extentZ = XMLoadFloat4A(&batch.ExtentZ);
+			const XMVECTOR radius = XMLoadFloat4A(&batch.Radius);
+
+			XMVECTOR outside = XMVectorFalseInt();
+			for (UINT i = 0u; i < NUM_PLANES; ++i)
+			{
+				XMVECTOR distance = XMVectorMultiplyAdd(centerX, aPlaneX[i], aPlaneW[i]);
+				distance = XMVectorMultiplyAdd(centerY, aPlaneY[i], distance);
+				distance = XMVectorMultiplyAdd(centerZ, aPlaneZ[i], distance);
+
+				XMVECTOR boxRadius = XMVectorMultiply(extentX, XMVectorAbs(aPlaneX[i]));
+				boxRadius = XMVectorMultiplyAdd(extentY, XMVectorAbs(aPlaneY[i]), boxRadius);
+				boxRadius = XMVectorMultiplyAdd(extentZ, XMVectorAbs(aPlaneZ[i]), boxRadius);
+
+				const XMVECTOR tightRadius = XMVectorMin(boxRadius, radius);
+				outside = XMVectorOrInt(outside, XMVectorLess(XMVectorAdd(distance, tightRadius), XMVectorZero()));
+			}
+
+			// Lane masks are stored as raw bits, XMStoreUInt4 would convert them as floats
+			UINT aOutside[4];
+			XMStoreInt4(aOutside, outside);
+
+			const UINT uNumLanes = std::min<UINT>(4u, m_uNumBounds - uBatch * 4u);
+			for (UINT uLane = 0u; uLane < uNumLanes; ++uLane)
+			{
+				if (aOutside[uLane] == 0u)
+				{
+					m_aVisible[uBatch * 4u + uLane] = TRUE;
+					++m_uNumVisible;
+				}
+			}
+		}
+
+		return m_uNumVisible;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::IsVisible
+
+	  Summary:  Returns whether bounds passed the last Cull. Bounds
+				added after it are visible.
+
+	  Args:     UINT uIndex
+				  Index returned by AddBounds
+
+	  Returns:  BOOL
+				  TRUE if the mesh should be drawn
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL FrustumCuller::IsVisible(_In_ UINT uIndex) const
+	{
+		return uIndex >= m_aVisible.size() || m_aVisible[uIndex];
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::IsAnyVisible
+
+	  Summary:  Returns whether any of consecutive bounds passed the
+				last Cull, to skip an object with every mesh culled
+
+	  Args:     UINT uFirstIndex
+				  Index of the first bounds
+				UINT uNumBounds
+				  Number of bounds
+
+	  Returns:  BOOL
+				  TRUE if any of the meshes should be drawn
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL FrustumCuller::IsAnyVisible(_In_ UINT uFirstIndex, _In_ UINT uNumBounds) const
+	{
+		for (UINT i = uFirstIndex; i < uFirstIndex + uNumBounds; ++i)
+		{
+			if (IsVisible(i))
+			{
+				return TRUE;
+			}
+		}
+
+		return FALSE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::GetBounds
+
+	  Summary:  Returns the world space bounds AddBounds stored, so
+				visible meshes can be tested further without keeping
+				their bounds twice
+
+	  Args:     UINT uIndex
+				  Index returned by AddBounds
+
+	  Returns:  MeshBounds
+				  World space bounds, with a negative radius if they
+				  were never computed
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	MeshBounds FrustumCuller::GetBounds(_In_ UINT uIndex) const
+	{
+		const BoundsBatch& batch = m_aBatches[uIndex / 4u];
+		const UINT uLane = uIndex % 4u;
+
+		MeshBounds bounds =
+		{
+			.Center = XMFLOAT3(getLane(batch.CenterX, uLane), getLane(batch.CenterY, uLane), getLane(batch.CenterZ, uLane)),
+			.Extents = XMFLOAT3(getLane(batch.ExtentX, uLane), getLane(batch.ExtentY, uLane), getLane(batch.ExtentZ, uLane)),
+			.Radius = getLane(batch.Radius, uLane)
+		};
+		if (bounds.Radius == FLT_MAX)
+		{
+			bounds.Radius = -1.0f;
+		}
+
+		return bounds;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::Hide
+
+	  Summary:  Culls bounds that passed the last Cull, when a later
+				test such as occlusion finds the mesh hidden
+
+	  Args:     UINT uIndex
+				  Index returned by AddBounds
+
+	  Modifies: [m_aVisible, m_uNumVisible].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void FrustumCuller::Hide(_In_ UINT uIndex)
+	{
+		if (uIndex < m_aVisible.size() && m_aVisible[uIndex])
+		{
+			m_aVisible[uIndex] = FALSE;
+			--m_uNumVisible;
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::GetNumBounds
+
+	  Summary:  Returns the number of bounds added since Reset
+
+	  Returns:  UINT
+				  Number of bounds
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT FrustumCuller::GetNumBounds() const
+	{
+		return m_uNumBounds;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::GetNumVisible
+
+	  Summary:  Returns the number of bounds that passed the last Cull
+
+	  Returns:  UINT
+				  Number of visible bounds
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT FrustumCuller::GetNumVisible() const
+	{
+		return m_uNumVisible;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::GetPlanes
+
+	  Summary:  Returns the planes extracted by SetViewProjection, so
+				other structures can be tested against the same
+				frustum
+
+	  Returns:  const XMFLOAT4A*
+				  NUM_PLANES planes, normals pointing inside
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const XMFLOAT4A* FrustumCuller::GetPlanes() const
+	{
+		return m_aPlanes;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::ComputeBounds
+
+	  Summary:  Computes the box of the vertices a mesh indexes and
+				the sphere around the center of the box that holds
+				them, which is often tighter than the box corners
+
+	  Args:     const XMFLOAT3* pPositions
+				  Position of the first vertex of the renderable
+				UINT uVertexStride
+				  Bytes from one position to the next
+				UINT uNumVertices
+				  Number of vertices
+				const WORD* pIndices
+				  Indices of the mesh
+				UINT uNumIndices
+				  Number of indices of the mesh
+				UINT uBaseVertex
+				  Added to each index
+
+	  Returns:  MeshBounds
+				  Bounds, with a negative radius if no index is valid
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	MeshBounds FrustumCuller::ComputeBounds(
+		_In_reads_bytes_(uNumVertices * uVertexStride) const XMFLOAT3* pPositions,
+		_In_ UINT uVertexStride,
+		_In_ UINT uNumVertices,
+		_In_reads_(uNumIndices) const WORD* pIndices,
+		_In_ UINT uNumIndices,
+		_In_ UINT uBaseVertex
+	)
+	{
+		MeshBounds bounds =
+		{
+			.Center = XMFLOAT3(0.0f, 0.0f, 0.0f),
+			.Extents = XMFLOAT3(0.0f, 0.0f, 0.0f),
+			.Radius = -1.0f
+		};
+
+		XMVECTOR minimum = XMVectorReplicate(FLT_MAX);
+		XMVECTOR maximum = XMVectorReplicate(-FLT_MAX);
+		BOOL bHasVertex = FALSE;
+		for (UINT i = 0u; i < uNumIndices; ++i)
+		{
+			const UINT uVertex = uBaseVertex + pIndices[i];
+			if (uVertex < uNumVertices)
+			{
+				const XMVECTOR position = XMLoadFloat3(getPosition(pPositions, uVertexStride, uVertex));
+				minimum = XMVectorMin(minimum, position);
+				maximum = XMVectorMax(maximum, position);
+				bHasVertex = TRUE;
+			}
+		}
+
+		if (!bHasVertex)
+		{
+			return bounds;
+		}
+
+		const XMVECTOR center = XMVectorScale(XMVectorAdd(minimum, maximum), 0.5f);
+		XMStoreFloat3(&bounds.Center, center);
+		XMStoreFloat3(&bounds.Extents, XMVectorScale(XMVectorSubtract(maximum, minimum), 0.5f));
+
+		FLOAT radiusSq = 0.0f;
+		for (UINT i = 0u; i < uNumIndices; ++i)
+		{
+			const UINT uVertex = uBaseVertex + pIndices[i];
+			if (uVertex < uNumVertices)
+			{
+				const XMVECTOR offset = XMVectorSubtract(XMLoadFloat3(getPosition(pPositions, uVertexStride, uVertex)), center);
+				radiusSq = std::max<FLOAT>(radiusSq, XMVectorGetX(XMVector3LengthSq(offset)));
+			}
+		}
+		bounds.Radius = sqrtf(radiusSq);
+
+		return bounds;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::TransformBounds
+
+	  Summary:  Returns the axis aligned box enclosing the transformed
+				box, and the sphere scaled by the largest axis scale
+
+	  Args:     const MeshBounds& bounds
+				  Bounds to transform
+				FXMMATRIX transform
+				  Affine transform, row vector convention
+
+	  Returns:  MeshBounds
+				  Transformed bounds
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	MeshBounds FrustumCuller::TransformBounds(_In_ const MeshBounds& bounds, _In_ FXMMATRIX transform)
+	{
+		MeshBounds transformed = {};
+
+		const XMVECTOR center = XMVector3Transform(XMLoadFloat3(&bounds.Center), transform);
+		XMVECTOR extents = XMVectorScale(XMVectorAbs(transform.r[0]), bounds.Extents.x);
+		extents = XMVectorMultiplyAdd(XMVectorAbs(transform.r[1]), XMVectorReplicate(bounds.Extents.y), extents);
+		extents = XMVectorMultiplyAdd(XMVectorAbs(transform.r[2]), XMVectorReplicate(bounds.Extents.z), extents);
+		XMStoreFloat3(&transformed.Center, center);
+		XMStoreFloat3(&transformed.Extents, extents);
+
+		const FLOAT scale = std::max<FLOAT>(
+			XMVectorGetX(XMVector3Length(transform.r[0])),
+			std::max<FLOAT>(XMVectorGetX(XMVector3Length(transform.r[1])), XMVectorGetX(XMVector3Length(transform.r[2])))
+		);
+		transformed.Radius = bounds.Radius * scale;
+
+		return transformed;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   FrustumCuller::MergeBounds
+
+	  Summary:  Returns the box enclosing both boxes and a sphere
+				around its center enclosing both spheres, no larger
+				than the box. Bounds with a negative radius are empty.
+
+	  Args:     const MeshBounds& a
+				  First bounds
+				const MeshBounds& b
+				  Second bounds
+
+	  Returns:  MeshBounds
+				  Merged bounds
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	MeshBounds FrustumCuller::MergeBounds(_In_ const MeshBounds& a, _In_ const MeshBounds& b)
+	{
+		if (a.Radius < 0.0f)
+		{
+			return b;
+		}
+		if (b.Radius < 0.0f)
+		{
+			return a;
+		}
+
+		const XMVECTOR centerA = XMLoadFloat3(&a.Center);
+		const XMVECTOR centerB = XMLoadFloat3(&b.Center);
+		const XMVECTOR extentsA = XMLoadFloat3(&a.Extents);
+		const XMVECTOR extentsB = XMLoadFloat3(&b.Extents);
+
+		const XMVECTOR minimum = XMVectorMin(XMVectorSubtract(centerA, extentsA), XMVectorSubtract(centerB, extentsB));
+		const XMVECTOR maximum = XMVectorMax(XMVectorAdd(centerA, extentsA), XMVectorAdd(centerB, extentsB));
+		const XMVECTOR center = XMVectorScale(XMVectorAdd(minimum, maximum), 0.5f);
+		const XMVECTOR extents = XMVectorScale(XMVectorSubtract(maximum, minimum), 0.5f);
+
+		MeshBounds merged = {};
+		XMStoreFloat3(&merged.Center, center);
+		XMStoreFloat3(&merged.Extents, extents);
+		merged.Radius = std::min<FLOAT>(
+			XMVectorGetX(XMVector3Length(extents)),
+			std::max<FLOAT>(
+				XMVectorGetX(XMVector3Length(XMVectorSubtract(centerA, center))) + a.Radius,
+				XMVectorGetX(XMVector3Length(XMVectorSubtract(centerB, center))) + b.Radius
+			)
+		);
+
+		return merged;
+	}
+}
@@ -0,0 +1,136 @@
+/*+===================================================================
+  File:      FRUSTUMCULLER.H
+
+  Summary:   FrustumCuller header file contains declarations of
+			 MeshBounds struct and FrustumCuller class that tests
+			 the bounds of meshes against the view frustum, four
+			 at a time.
+
+  Classes: FrustumCuller
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Portable.h"
+
+namespace library
+{
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   MeshBounds
+
+		Summary:  Axis aligned box and bounding sphere of a mesh, both
+				  around Center. A negative radius marks bounds that
+				  were never computed and are never culled.
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct MeshBounds
+	{
+		XMFLOAT3 Center;
+		XMFLOAT3 Extents;
+		FLOAT Radius;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    FrustumCuller
+
+	  Summary:  Collects the world space bounds of every mesh of a
+				frame, then tests them against the six planes of the
+				view frustum in one pass before any draw is issued.
+				Bounds are kept as structures of arrays so each plane
+				is tested against four meshes per vector operation.
+				A mesh is culled once its box or its sphere lies
+				entirely behind one plane.
+
+	  Methods:  SetViewProjection
+				  Extracts the frustum planes
+				Reset
+				  Removes every bounds
+				AddBounds
+				  Transforms bounds to world space and adds them
+				AddHidden
+				  Adds bounds that are culled without a test
+				Cull
+				  Tests every bounds against the frustum
+				IsVisible
+				  Returns whether bounds passed the last Cull
+				IsAnyVisible
+				  Returns whether any of a range of bounds passed
+				GetBounds
+				  Returns world space bounds that were added
+				Hide
+				  Culls bounds that passed, for later tests
+				GetNumBounds
+				  Returns the number of bounds added
+				GetNumVisible
+				  Returns the number of bounds that passed
+				GetPlanes
+				  Returns the frustum planes
+				ComputeBounds
+				  Computes the bounds of the vertices of a mesh
+				TransformBounds
+				  Returns bounds enclosing transformed bounds
+				MergeBounds
+				  Returns bounds enclosing two bounds
+				FrustumCuller
+				  Constructor.
+				~FrustumCuller
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class FrustumCuller final
+	{
+	public:
+		static constexpr UINT NUM_PLANES = 6u;
+
+	public:
+		FrustumCuller();
+		FrustumCuller(const FrustumCuller& other) = delete;
+		FrustumCuller(FrustumCuller&& other) = delete;
+		FrustumCuller& operator=(const FrustumCuller& other) = delete;
+		FrustumCuller& operator=(FrustumCuller&& other) = delete;
+		~FrustumCuller() = default;
+
+		void SetViewProjection(_In_ FXMMATRIX viewProjection);
+		void Reset();
+		UINT AddBounds(_In_ const MeshBounds& bounds, _In_ FXMMATRIX world);
+		UINT AddHidden(_In_ UINT uNumBounds);
+		UINT Cull();
+
+		BOOL IsVisible(_In_ UINT uIndex) const;
+		BOOL IsAnyVisible(_In_ UINT uFirstIndex, _In_ UINT uNumBounds) const;
+		MeshBounds GetBounds(_In_ UINT uIndex) const;
+		void Hide(_In_ UINT uIndex);
+		UINT GetNumBounds() const;
+		UINT GetNumVisible() const;
+		const XMFLOAT4A* GetPlanes() const;
+
+		static MeshBounds ComputeBounds(
+			_In_reads_bytes_(uNumVertices * uVertexStride) const XMFLOAT3* pPositions,
+			_In_ UINT uVertexStride,
+			_In_ UINT uNumVertices,
+			_In_reads_(uNumIndices) const WORD* pIndices,
+			_In_ UINT uNumIndices,
+			_In_ UINT uBaseVertex
+		);
+		static MeshBounds TransformBounds(_In_ const MeshBounds& bounds, _In_ FXMMATRIX transform);
+		static MeshBounds MergeBounds(_In_ const MeshBounds& a, _In_ const MeshBounds& b);
+
+	private:
+		struct BoundsBatch
+		{
+			XMFLOAT4A CenterX;
+			XMFLOAT4A CenterY;
+			XMFLOAT4A CenterZ;
+			XMFLOAT4A ExtentX;
+			XMFLOAT4A ExtentY;
+			XMFLOAT4A ExtentZ;
+			XMFLOAT4A Radius;
+		};
+
+	private:
+		XMFLOAT4A m_aPlanes[NUM_PLANES];
+		std::vector<BoundsBatch> m_aBatches;
+		std::vector<BOOL> m_aVisible;
+		UINT m_uNumBounds;
+		UINT m_uNumVisible;
+	};
+}
@@ -0,0 +1,673 @@
+#include "Renderer/HorizonCuller.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+
+namespace library
+{
+	namespace
+	{
+		// Pseudo angles go once around in four units
+		constexpr FLOAT PSEUDO_TURN = 4.0f;
+		constexpr FLOAT PSEUDO_HALF_TURN = 2.0f;
+
+		// The view seen from above is widened by this many radians on each side
+		constexpr FLOAT WEDGE_PADDING = 0.01f;
+
+		// Half of the diagonal of a column, relative to its size
+		constexpr FLOAT HALF_DIAGONAL = 0.7072f;
+
+		// Bounds may reach this far below the bottom of the columns and be hidden
+		constexpr FLOAT BOTTOM_TOLERANCE = 0.001f;
+
+		/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+		  Function: getPseudoAngle
+
+		  Summary:  Maps a direction to a value that grows with its
+					angle from +x toward +z, without a trigonometric
+					call. Opposite directions are half a turn apart.
+
+		  Args:     FLOAT x
+					  X of the direction
+					FLOAT z
+					  Z of the direction
+
+		  Returns:  FLOAT
+					  Pseudo angle from 0 up to PSEUDO_TURN
+		F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+		FLOAT getPseudoAngle(_In_ FLOAT x, _In_ FLOAT z)
+		{
+			if (x == 0.0f && z == 0.0f)
+			{
+				return 0.0f;
+			}
+
+			if (z >= 0.0f)
+			{
+				return x >= 0.0f ? z / (x + z) : 1.0f - x / (z - x);
+			}
+
+			return x < 0.0f ? 2.0f - z / (-x - z) : 3.0f + x / (x - z);
+		}
+
+		FLOAT wrapPseudoAngle(_In_ FLOAT angle)
+		{
+			while (angle >= PSEUDO_HALF_TURN)
+			{
+				angle -= PSEUDO_TURN;
+			}
+			while (angle < -PSEUDO_HALF_TURN)
+			{
+				angle += PSEUDO_TURN;
+			}
+
+			return angle;
+		}
+
+		FLOAT cross(_In_ const XMFLOAT2& a, _In_ FLOAT x, _In_ FLOAT z)
+		{
+			return a.x * z - a.y * x;
+		}
+
+		/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+		  Function: getRectangleSpan
+
+		  Summary:  Finds the directions a rectangle, seen from above,
+					covers from the eye. A rectangle around the eye
+					covers every direction.
+
+		  Args:     FLOAT minX
+					  Smallest x relative to the eye
+					FLOAT minZ
+					  Smallest z relative to the eye
+					FLOAT maxX
+					  Largest x relative to the eye
+					FLOAT maxZ
+					  Largest z relative to the eye
+					FLOAT& outStart
+					  Receives the pseudo angle the span starts at
+					FLOAT& outLength
+					  Receives the length of the span
+
+		  Modifies: [outStart, outLength].
+		F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+		void getRectangleSpan(_In_ FLOAT minX, _In_ FLOAT minZ, _In_ FLOAT maxX, _In_ FLOAT maxZ, _Out_ FLOAT& outStart, _Out_ FLOAT& outLength)
+		{
+			if (minX <= 0.0f && 0.0f <= maxX && minZ <= 0.0f && 0.0f <= maxZ)
+			{
+				outStart = 0.0f;
+				outLength = PSEUDO_TURN;
+				return;
+			}
+
+			// Every corner is less than half a turn from the center
+			const FLOAT center = getPseudoAngle((minX + maxX) * 0.5f, (minZ + maxZ) * 0.5f);
+			FLOAT minDelta = 0.0f;
+			FLOAT maxDelta = 0.0f;
+			for (UINT i = 0u; i < 4u; ++i)
+			{
+				const FLOAT delta = wrapPseudoAngle(getPseudoAngle(i & 1u ? maxX : minX, i & 2u ? maxZ : minZ) - center);
+				minDelta = std::min(minDelta, delta);
+				maxDelta = std::max(maxDelta, delta);
+			}
+
+			outStart = center + minDelta;
+			outLength = maxDelta - minDelta;
+		}
+
+		void getRectangleDistances(_In_ FLOAT minX, _In_ FLOAT minZ, _In_ FLOAT maxX, _In_ FLOAT maxZ, _Out_ FLOAT& outNear, _Out_ FLOAT& outFar)
+		{
+			const FLOAT nearX = std::max({ minX, -maxX, 0.0f });
+			const FLOAT nearZ = std::max({ minZ, -maxZ, 0.0f });
+			const FLOAT farX = std::max(fabsf(minX), fabsf(maxX));
+			const FLOAT farZ = std::max(fabsf(minZ), fabsf(maxZ));
+			outNear = sqrtf(nearX * nearX + nearZ * nearZ);
+			outFar = sqrtf(farX * farX + farZ * farZ);
+		}
+
+		/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+		  Function: clampToHalfPlane
+
+		  Summary:  Narrows a range of columns along a side of a ring
+					to those where a linear function of the index may
+					be positive, keeping one extra column at each end
+
+		  Args:     FLOAT value
+					  Value of the function at index zero
+					FLOAT step
+					  Change of the function per index
+					INT& iBegin
+					  First index of the range
+					INT& iEnd
+					  Index after the range
+
+		  Modifies: [iBegin, iEnd].
+		F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+		void clampToHalfPlane(_In_ FLOAT value, _In_ FLOAT step, _Inout_ INT& iBegin, _Inout_ INT& iEnd)
+		{
+			if (step == 0.0f)
+			{
+				if (value < 0.0f)
+				{
+					iEnd = iBegin;
+				}
+				return;
+			}
+
+			const FLOAT root = std::clamp(-value / step, -1.0e6f, 1.0e6f);
+			if (step > 0.0f)
+			{
+				iBegin = std::max(iBegin, static_cast<INT>(floorf(root)));
+			}
+			else
+			{
+				iEnd = std::min(iEnd, static_cast<INT>(floorf(root)) + 2);
+			}
+		}
+
+		FLOAT getColumnHeight(_In_ const HeightField& field, _In_ INT iX, _In_ INT iZ)
+		{
+			return field.aHeights[static_cast<size_t>(iZ) * field.uNumColumnsX + static_cast<size_t>(iX)];
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   HorizonCuller::HorizonCuller
+
+	  Summary:  Constructor
+
+	  Modifies: [m_heightField, m_eye, m_wedgeStart, m_wedgeEnd,
+				 m_wedgeStartAngle, m_wedgeLength, m_bIsFullCircle,
+				 m_aHorizon, m_aRingSlopes, m_aRingStamps,
+				 m_aTouchedBuckets, m_aTests, m_aSortedTests,
+				 m_aRingOffsets, m_stats].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HorizonCuller::HorizonCuller()
+		: m_heightField()
+		, m_eye(0.0f, 0.0f, 0.0f)
+		, m_wedgeStart(1.0f, 0.0f)
+		, m_wedgeEnd(1.0f, 0.0f)
+		, m_wedgeStartAngle(0.0f)
+		, m_wedgeLength(0.0f)
+		, m_bIsFullCircle(TRUE)
+		, m_aHorizon(NUM_BUCKETS, -FLT_MAX)
+		, m_aRingSlopes(NUM_BUCKETS, FLT_MAX)
+		, m_aRingStamps(NUM_BUCKETS, UINT_MAX)
+		, m_aTouchedBuckets()
+		, m_aTests()
+		, m_aSortedTests()
+		, m_aRingOffsets()
+		, m_stats()
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   HorizonCuller::SetHeightField
+
+	  Summary:  Copies the column tops to cull against. A height
+				field without columns culls nothing.
+
+	  Args:     const HeightField& heightField
+				  Column tops in world space
+
+	  Modifies: [m_heightField].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void HorizonCuller::SetHeightField(_In_ const HeightField& heightField)
+	{
+		m_heightField = heightField;
+		if (m_heightField.aHeights.size() != static_cast<size_t>(m_heightField.uNumColumnsX) * m_heightField.uNumColumnsZ
+			|| !(m_heightField.CellSize > 0.0f))
+		{
+			m_heightField.aHeights.clear();
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   HorizonCuller::SetCamera
+
+	  Summary:  Sets the eye and finds the wedge the frustum covers
+				seen from above, from its four edges. When they span
+				half a turn or more, as when looking down, every
+				direction is swept.
+
+	  Args:     FXMVECTOR eye
+				  Eye position
+				CXMMATRIX viewProjection
+				  View matrix times projection matrix
+
+	  Modifies: [m_eye, m_wedgeStart, m_wedgeEnd, m_wedgeStartAngle,
+				 m_wedgeLength, m_bIsFullCircle].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void HorizonCuller::SetCamera(_In_ FXMVECTOR eye, _In_ CXMMATRIX viewProjection)
+	{
+		XMStoreFloat3(&m_eye, eye);
+
+		const XMMATRIX inverse = XMMatrixInverse(nullptr, viewProjection);
+		FLOAT aAngles[4];
+		m_bIsFullCircle = FALSE;
+		for (UINT i = 0u; i < 4u; ++i)
+		{
+			const FLOAT x = i & 1u ? 1.0f : -1.0f;
+			const FLOAT y = i & 2u ? 1.0f : -1.0f;
+			XMFLOAT3 edge;
+			XMStoreFloat3(
+				&edge,
+				XMVectorSubtract(XMVector3TransformCoord(XMVectorSet(x, y, 1.0f, 1.0f), inverse), XMVector3TransformCoord(XMVectorSet(x, y, 0.0f, 1.0f), inverse))
+			);
+
+			// An edge pointing straight up or down is seen from above in every direction
+			if (sqrtf(edge.x * edge.x + edge.z * edge.z) <= 0.001f * fabsf(edge.y))
+			{
+				m_bIsFullCircle = TRUE;
+			}
+			aAngles[i] = atan2f(edge.z, edge.x);
+		}
+
+		std::sort(aAngles, aAngles + 4);
+		UINT uAfterGap = 0u;
+		FLOAT largestGap = aAngles[0] + XM_2PI - aAngles[3];
+		for (UINT i = 1u; i < 4u; ++i)
+		{
+			if (aAngles[i] - aAngles[i - 1u] > largestGap)
+			{
+				largestGap = aAngles[i] - aAngles[i - 1u];
+				uAfterGap = i;
+			}
+		}
+
+		const FLOAT span = XM_2PI - largestGap + 2.0f * WEDGE_PADDING;
+		if (m_bIsFullCircle || span >= XM_PI)
+		{
+			m_bIsFullCircle = TRUE;
+			return;
+		}
+
+		const FLOAT startAngle = aAngles[uAfterGap] - WEDGE_PADDING;
+		m_wedgeStart = XMFLOAT2(cosf(startAngle), sinf(startAngle));
+		m_wedgeEnd = XMFLOAT2(cosf(startAngle + span), sinf(startAngle + span));
+		m_wedgeStartAngle = getPseudoAngle(m_wedgeStart.x, m_wedgeStart.y);
+		m_wedgeLength = wrapPseudoAngle(getPseudoAngle(m_wedgeEnd.x, m_wedgeEnd.y) - m_wedgeStartAngle);
+		if (m_wedgeLength < 0.0f)
+		{
+			m_wedgeLength += PSEUDO_TURN;
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   HorizonCuller::Cull
+
+	  Summary:  Sorts the bounds that passed the last Cull of a
+				frustum culler by the last ring in front of them, then
+				sweeps the rings outward, testing the bounds of each
+				ring once it is swept and hiding those below the
+				horizon. The sweep stops at the farthest ring any
+				bounds wait for, so it visits the columns in view up
+				to the farthest bounds and no others.
+
+	  Args:     FrustumCuller& frustumCuller
+				  Frustum culler, culled with the same view
+				  projection, whose visible bounds are tested
+
+	  Modifies: [m_aHorizon, m_aRingSlopes, m_aRingStamps,
+				 m_aTouchedBuckets, m_aTests, m_aSortedTests,
+				 m_aRingOffsets, m_stats, frustumCuller].
+
+	  Returns:  UINT
+				  Number of bounds hidden
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT HorizonCuller::Cull(_Inout_ FrustumCuller& frustumCuller)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		m_stats = {};
+		const HeightField& field = m_heightField;
+
+		// Rays from below the columns pass under them
+		if (field.aHeights.empty() || m_eye.y < field.Bottom)
+		{
+			return 0u;
+		}
+
+		const INT iEyeX = static_cast<INT>(floorf((m_eye.x - field.MinX) / field.CellSize));
+		const INT iEyeZ = static_cast<INT>(floorf((m_eye.z - field.MinZ) / field.CellSize));
+		const INT iLastX = static_cast<INT>(field.uNumColumnsX) - 1;
+		const INT iLastZ = static_cast<INT>(field.uNumColumnsZ) - 1;
+
+		// Rings before the first that reaches the grid block nothing
+		const INT iFirstRing = std::max({ 1, -iEyeX, iEyeX - iLastX, -iEyeZ, iEyeZ - iLastZ });
+		INT iLastRing = std::max({ iEyeX, iLastX - iEyeX, iEyeZ, iLastZ - iEyeZ });
+
+		m_aTests.clear();
+		for (UINT i = 0u; i < frustumCuller.GetNumBounds(); ++i)
+		{
+			if (!frustumCuller.IsVisible(i))
+			{
+				continue;
+			}
+
+			++m_stats.uNumTestedBounds;
+			HorizonTest test;
+			if (setupTest(i, frustumCuller.GetBounds(i), test) && test.iRing >= iFirstRing)
+			{
+				test.iRing = std::min(test.iRing, iLastRing);
+				m_aTests.push_back(test);
+			}
+		}
+		if (m_aTests.empty() || iFirstRing > iLastRing)
+		{
+			return 0u;
+		}
+
+		// Counting sort by ring, the offset of ring k ends up at k + 1
+		iLastRing = iFirstRing;
+		for (const HorizonTest& test : m_aTests)
+		{
+			iLastRing = std::max(iLastRing, test.iRing);
+		}
+		m_aRingOffsets.assign(static_cast<size_t>(iLastRing - iFirstRing) + 2u, 0u);
+		for (const HorizonTest& test : m_aTests)
+		{
+			++m_aRingOffsets[static_cast<size_t>(test.iRing - iFirstRing) + 1u];
+		}
+		for (size_t i = 1u; i < m_aRingOffsets.size(); ++i)
+		{
+			m_aRingOffsets[i] += m_aRingOffsets[i - 1u];
+		}
+		m_aSortedTests.resize(m_aTests.size());
+		for (const HorizonTest& test : m_aTests)
+		{
+			m_aSortedTests[m_aRingOffsets[static_cast<size_t>(test.iRing - iFirstRing)]++] = test;
+		}
+
+		std::fill(m_aHorizon.begin(), m_aHorizon.end(), -FLT_MAX);
+		std::fill(m_aRingStamps.begin(), m_aRingStamps.end(), UINT_MAX);
+
+		UINT uFirstTest = 0u;
+		for (INT iRing = iFirstRing; iRing <= iLastRing; ++iRing)
+		{
+			const UINT uRing = static_cast<UINT>(iRing);
+			m_aTouchedBuckets.clear();
+			sweepSide(iEyeX - iRing, iEyeZ - iRing, 1, 0, 2 * iRing + 1, uRing);
+			sweepSide(iEyeX - iRing, iEyeZ + iRing, 1, 0, 2 * iRing + 1, uRing);
+			sweepSide(iEyeX - iRing, iEyeZ - iRing + 1, 0, 1, 2 * iRing - 1, uRing);
+			sweepSide(iEyeX + iRing, iEyeZ - iRing + 1, 0, 1, 2 * iRing - 1, uRing);
+
+			for (UINT uBucket : m_aTouchedBuckets)
+			{
+				m_aHorizon[uBucket] = std::max(m_aHorizon[uBucket], m_aRingSlopes[uBucket]);
+			}
+
+			const UINT uEndTest = m_aRingOffsets[static_cast<size_t>(iRing - iFirstRing)];
+			for (UINT i = uFirstTest; i < uEndTest; ++i)
+			{
+				if (isBelowHorizon(m_aSortedTests[i]))
+				{
+					frustumCuller.Hide(m_aSortedTests[i].uIndex);
+					++m_stats.uNumHiddenBounds;
+				}
+			}
+			uFirstTest = uEndTest;
+		}
+
+		const auto end = std::chrono::high_resolution_clock::now();
+		m_stats.Milliseconds = std::chrono::duration<FLOAT, std::milli>(end - start).count();
+
+		return m_stats.uNumHiddenBounds;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   HorizonCuller::GetStats
+
+	  Summary:  Returns the work done by the last Cull
+
+	  Returns:  const HorizonStats&
+				  Counts and time
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const HorizonStats& HorizonCuller::GetStats() const
+	{
+		return m_stats;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   HorizonCuller::setupTest
+
+	  Summary:  Finds the highest slope of world space bounds from the
+				eye, the directions they span within the view, and
+				the last ring whose columns are all nearer along every
+				ray, by the distance of the bounds in the larger of x
+				and z. Bounds around the eye or reaching below the
+				columns are never hidden.
+
+	  Args:     UINT uIndex
+				  Index of the bounds in the frustum culler
+				const MeshBounds& bounds
+				  World space bounds
+				HorizonTest& outTest
+				  Receives the test
+
+	  Modifies: [outTest].
+
+	  Returns:  BOOL
+				  TRUE if the bounds can be hidden
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL HorizonCuller::setupTest(_In_ UINT uIndex, _In_ const MeshBounds& bounds, _Out_ HorizonTest& outTest) const
+	{
+		outTest = {};
+		if (bounds.Radius < 0.0f || bounds.Center.y - bounds.Extents.y < m_heightField.Bottom - BOTTOM_TOLERANCE)
+		{
+			return FALSE;
+		}
+
+		const FLOAT minX = bounds.Center.x - bounds.Extents.x - m_eye.x;
+		const FLOAT maxX = bounds.Center.x + bounds.Extents.x - m_eye.x;
+		const FLOAT minZ = bounds.Center.z - bounds.Extents.z - m_eye.z;
+		const FLOAT maxZ = bounds.Center.z + bounds.Extents.z - m_eye.z;
+
+		FLOAT nearDistance;
+		FLOAT farDistance;
+		getRectangleDistances(minX, minZ, maxX, maxZ, nearDistance, farDistance);
+		if (!(nearDistance > 0.0f))
+		{
+			return FALSE;
+		}
+
+		const FLOAT top = bounds.Center.y + bounds.Extents.y - m_eye.y;
+		outTest.uIndex = uIndex;
+		outTest.Slope = top / (top > 0.0f ? nearDistance : farDistance);
+		getRectangleSpan(minX, minZ, maxX, maxZ, outTest.Start, outTest.Length);
+
+		if (!m_bIsFullCircle)
+		{
+			const FLOAT first = wrapPseudoAngle(outTest.Start - m_wedgeStartAngle);
+			const FLOAT begin = std::max(first, 0.0f);
+			const FLOAT end = std::min(first + outTest.Length, m_wedgeLength);
+			if (begin > end)
+			{
+				return FALSE;
+			}
+			outTest.Start = m_wedgeStartAngle + begin;
+			outTest.Length = end - begin;
+		}
+
+		const FLOAT distance = std::max({ minX, -maxX, minZ, -maxZ });
+		outTest.iRing = static_cast<INT>(std::min(floorf(distance / m_heightField.CellSize), 1.0e6f)) - 1;
+
+		return TRUE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   HorizonCuller::sweepSide
+
+	  Summary:  Lowers the buckets of a ring for the columns along one
+				side of it that may be in the wedge of the view. Each
+				column blocks its directions up to the slope of its
+				top at its far corner, or at its near corner when the
+				top is below the eye. Stretches of the side outside
+				of the grid block nothing.
+
+	  Args:     INT iX
+				  Column of the first position along x
+				INT iZ
+				  Column of the first position along z
+				INT iStepX
+				  Step along x between positions
+				INT iStepZ
+				  Step along z between positions
+				INT iCount
+				  Number of positions
+				UINT uRing
+				  Ring the side belongs to
+
+	  Modifies: [m_aRingSlopes, m_aRingStamps, m_aTouchedBuckets,
+				 m_stats].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void HorizonCuller::sweepSide(_In_ INT iX, _In_ INT iZ, _In_ INT iStepX, _In_ INT iStepZ, _In_ INT iCount, _In_ UINT uRing)
+	{
+		const HeightField& field = m_heightField;
+		const FLOAT cellSize = field.CellSize;
+
+		// Columns relative to the eye, from the first to the last of a stretch
+		auto getMinX = [&](INT i) { return field.MinX + static_cast<FLOAT>(iX + i * iStepX) * cellSize - m_eye.x; };
+		auto getMinZ = [&](INT i) { return field.MinZ + static_cast<FLOAT>(iZ + i * iStepZ) * cellSize - m_eye.z; };
+
+		INT iBegin = 0;
+		INT iEnd = iCount;
+		if (!m_bIsFullCircle)
+		{
+			// Column centers no farther than half a diagonal outside of either edge
+			const FLOAT centerX = getMinX(0) + cellSize * 0.5f;
+			const FLOAT centerZ = getMinZ(0) + cellSize * 0.5f;
+			const FLOAT stepX = static_cast<FLOAT>(iStepX) * cellSize;
+			const FLOAT stepZ = static_cast<FLOAT>(iStepZ) * cellSize;
+			const FLOAT margin = cellSize * HALF_DIAGONAL;
+			clampToHalfPlane(cross(m_wedgeStart, centerX, centerZ) + margin, cross(m_wedgeStart, stepX, stepZ), iBegin, iEnd);
+			clampToHalfPlane(-cross(m_wedgeEnd, centerX, centerZ) + margin, -cross(m_wedgeEnd, stepX, stepZ), iBegin, iEnd);
+			if (iBegin >= iEnd)
+			{
+				return;
+			}
+		}
+
+		INT iGridBegin = iBegin;
+		INT iGridEnd = iBegin;
+		const INT iFixed = iStepX != 0 ? iZ : iX;
+		const INT iNumFixed = static_cast<INT>(iStepX != 0 ? field.uNumColumnsZ : field.uNumColumnsX);
+		if (0 <= iFixed && iFixed < iNumFixed)
+		{
+			const INT iFirst = iStepX != 0 ? iX : iZ;
+			const INT iNumColumns = static_cast<INT>(iStepX != 0 ? field.uNumColumnsX : field.uNumColumnsZ);
+			iGridBegin = std::clamp(-iFirst, iBegin, iEnd);
+			iGridEnd = std::clamp(iNumColumns - iFirst, iGridBegin, iEnd);
+		}
+
+		auto blockNothing = [&](INT iFirst, INT iLast)
+		{
+			FLOAT start;
+			FLOAT length;
+			getRectangleSpan(getMinX(iFirst), getMinZ(iFirst), getMinX(iLast) + cellSize, getMinZ(iLast) + cellSize, start, length);
+			lowerBuckets(start, length, -FLT_MAX, uRing);
+		};
+		if (iBegin < iGridBegin)
+		{
+			blockNothing(iBegin, iGridBegin - 1);
+		}
+		if (iGridEnd < iEnd)
+		{
+			blockNothing(iGridEnd, iEnd - 1);
+		}
+
+		for (INT i = iGridBegin; i < iGridEnd; ++i)
+		{
+			const FLOAT minX = getMinX(i);
+			const FLOAT minZ = getMinZ(i);
+			FLOAT nearDistance;
+			FLOAT farDistance;
+			getRectangleDistances(minX, minZ, minX + cellSize, minZ + cellSize, nearDistance, farDistance);
+
+			const FLOAT top = getColumnHeight(field, iX + i * iStepX, iZ + i * iStepZ) - m_eye.y;
+			const FLOAT slope = top > 0.0f
+				? top / farDistance
+				: (nearDistance > 0.0f ? top / nearDistance : -FLT_MAX);
+
+			FLOAT start;
+			FLOAT length;
+			getRectangleSpan(minX, minZ, minX + cellSize, minZ + cellSize, start, length);
+			lowerBuckets(start, length, slope, uRing);
+			++m_stats.uNumSweptColumns;
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   HorizonCuller::lowerBuckets
+
+	  Summary:  Lowers the slope a ring blocks in every bucket a span
+				of directions touches, starting the bucket over on the
+				first touch of the ring
+
+	  Args:     FLOAT start
+				  Pseudo angle the span starts at
+				FLOAT length
+				  Length of the span
+				FLOAT slope
+				  Slope blocked over the span
+				UINT uRing
+				  Ring being swept
+
+	  Modifies: [m_aRingSlopes, m_aRingStamps, m_aTouchedBuckets].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void HorizonCuller::lowerBuckets(_In_ FLOAT start, _In_ FLOAT length, _In_ FLOAT slope, _In_ UINT uRing)
+	{
+		constexpr FLOAT BUCKETS_PER_UNIT = static_cast<FLOAT>(NUM_BUCKETS) / PSEUDO_TURN;
+		constexpr INT NUM_SIGNED_BUCKETS = static_cast<INT>(NUM_BUCKETS);
+
+		const INT iFirst = static_cast<INT>(floorf(start * BUCKETS_PER_UNIT));
+		const INT iLast = std::min(static_cast<INT>(floorf((start + length) * BUCKETS_PER_UNIT)), iFirst + NUM_SIGNED_BUCKETS - 1);
+		for (INT i = iFirst; i <= iLast; ++i)
+		{
+			const UINT uBucket = static_cast<UINT>((i % NUM_SIGNED_BUCKETS + NUM_SIGNED_BUCKETS) % NUM_SIGNED_BUCKETS);
+			if (m_aRingStamps[uBucket] != uRing)
+			{
+				m_aRingStamps[uBucket] = uRing;
+				m_aRingSlopes[uBucket] = slope;
+				m_aTouchedBuckets.push_back(uBucket);
+			}
+			else
+			{
+				m_aRingSlopes[uBucket] = std::min(m_aRingSlopes[uBucket], slope);
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   HorizonCuller::isBelowHorizon
+
+	  Summary:  Tests bounds against the horizon of the buckets they
+				touch, as swept so far
+
+	  Args:     const HorizonTest& test
+				  Test set up for the bounds
+
+	  Returns:  BOOL
+				  TRUE if the bounds are below the horizon everywhere
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL HorizonCuller::isBelowHorizon(_In_ const HorizonTest& test) const
+	{
+		constexpr FLOAT BUCKETS_PER_UNIT = static_cast<FLOAT>(NUM_BUCKETS) / PSEUDO_TURN;
+		constexpr INT NUM_SIGNED_BUCKETS = static_cast<INT>(NUM_BUCKETS);
+
+		const INT iFirst = static_cast<INT>(floorf(test.Start * BUCKETS_PER_UNIT));
+		const INT iLast = std::min(static_cast<INT>(floorf((test.Start + test.Length) * BUCKETS_PER_UNIT)), iFirst + NUM_SIGNED_BUCKETS - 1);
+		for (INT i = iFirst; i <= iLast; ++i)
+		{
+			const UINT uBucket = static_cast<UINT>((i % NUM_SIGNED_BUCKETS + NUM_SIGNED_BUCKETS) % NUM_SIGNED_BUCKETS);
+			if (!(test.Slope < m_aHorizon[uBucket]))
+			{
+				return FALSE;
+			}
+		}
+
+		return TRUE;
+	}
+}
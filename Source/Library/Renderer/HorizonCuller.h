@@ -0,0 +1,146 @@
+/*+===================================================================
+  File:      HORIZONCULLER.H
+
+  Summary:   HorizonCuller header file contains declarations of
+			 HeightField struct and HorizonCuller class that hides
+			 bounds below the horizon the terrain columns form as
+			 seen from the camera.
+
+  Classes: HorizonCuller
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+#include "Renderer/FrustumCuller.h"
+
+namespace library
+{
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+	  Struct:   HeightField
+
+	  Summary:  Top of each column of a grid of solid columns that
+				all start at Bottom, row by row along z. Column
+				(x, z) covers MinX + x * CellSize to one CellSize
+				further, and likewise along z. An empty column has a
+				height of Bottom.
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct HeightField
+	{
+		UINT uNumColumnsX;
+		UINT uNumColumnsZ;
+		FLOAT MinX;
+		FLOAT MinZ;
+		FLOAT CellSize;
+		FLOAT Bottom;
+		std::vector<FLOAT> aHeights;
+	};
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+	  Struct:   HorizonStats
+
+	  Summary:  Work done by the last Cull
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct HorizonStats
+	{
+		UINT uNumSweptColumns;
+		UINT uNumTestedBounds;
+		UINT uNumHiddenBounds;
+		FLOAT Milliseconds;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    HorizonCuller
+
+	  Summary:  Culls against a height field without rasterizing it.
+				The columns are swept in square rings going outward
+				from the column of the eye, only where the rings cross
+				the view seen from above. Directions around the eye
+				are split into buckets. For each ring, a bucket takes
+				the lowest elevation, as a slope, that any column of
+				the ring it touches is sure to block, and the horizon
+				of the bucket is the highest such slope of the rings
+				swept so far. Every ring crosses every ray, so a ray
+				of the bucket below its horizon is blocked by the time
+				it leaves the ring. Bounds are tested once the last
+				ring entirely in front of them is swept, and are
+				hidden when their highest slope is below the horizon
+				of every bucket they touch.
+
+	  Methods:  SetHeightField
+				  Copies the column tops
+				SetCamera
+				  Sets the eye and finds the view seen from above
+				Cull
+				  Hides the bounds a frustum culler passed that are
+				  below the horizon
+				GetStats
+				  Returns the work done by the last Cull
+				HorizonCuller
+				  Constructor.
+				~HorizonCuller
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class HorizonCuller final
+	{
+	public:
+		// Buckets of directions around the eye, evenly spaced in pseudo angle
+		static constexpr UINT NUM_BUCKETS = 1024u;
+
+	public:
+		HorizonCuller();
+		HorizonCuller(const HorizonCuller& other) = delete;
+		HorizonCuller(HorizonCuller&& other) = delete;
+		HorizonCuller& operator=(const HorizonCuller& other) = delete;
+		HorizonCuller& operator=(HorizonCuller&& other) = delete;
+		~HorizonCuller() = default;
+
+		void SetHeightField(_In_ const HeightField& heightField);
+		void SetCamera(_In_ FXMVECTOR eye, _In_ CXMMATRIX viewProjection);
+		UINT Cull(_Inout_ FrustumCuller& frustumCuller);
+
+		const HorizonStats& GetStats() const;
+
+	private:
+		/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		  Struct:   HorizonTest
+
+		  Summary:  Bounds waiting for the horizon of the last ring in
+					front of them, with the directions they span
+		S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+		struct HorizonTest
+		{
+			UINT uIndex;
+			INT iRing;
+			FLOAT Slope;
+			FLOAT Start;
+			FLOAT Length;
+		};
+
+	private:
+		BOOL setupTest(_In_ UINT uIndex, _In_ const MeshBounds& bounds, _Out_ HorizonTest& outTest) const;
+		void sweepSide(_In_ INT iX, _In_ INT iZ, _In_ INT iStepX, _In_ INT iStepZ, _In_ INT iCount, _In_ UINT uRing);
+		void lowerBuckets(_In_ FLOAT start, _In_ FLOAT length, _In_ FLOAT slope, _In_ UINT uRing);
+		BOOL isBelowHorizon(_In_ const HorizonTest& test) const;
+
+	private:
+		HeightField m_heightField;
+		XMFLOAT3 m_eye;
+		XMFLOAT2 m_wedgeStart;
+		XMFLOAT2 m_wedgeEnd;
+		FLOAT m_wedgeStartAngle;
+		FLOAT m_wedgeLength;
+		BOOL m_bIsFullCircle;
+		std::vector<FLOAT> m_aHorizon;
+		std::vector<FLOAT> m_aRingSlopes;
+		std::vector<UINT> m_aRingStamps;
+		std::vector<UINT> m_aTouchedBuckets;
+		std::vector<HorizonTest> m_aTests;
+		std::vector<HorizonTest> m_aSortedTests;
+		std::vector<UINT> m_aRingOffsets;
+		HorizonStats m_stats;
+	};
+}
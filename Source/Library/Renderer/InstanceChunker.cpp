@@ -0,0 +1,162 @@
+#include "Renderer/InstanceChunker.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace library
+{
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   InstanceChunker::SortIntoChunks
+
+	  Summary:  Sorts the instances by the chunk their translation is
+				in, keeping the order within a chunk, and builds one
+				chunk per occupied cube with the bounds of every mesh
+				of its instances
+
+	  Args:     std::vector<InstanceData>& aInstances
+				  Instances to reorder
+				const std::vector<MeshBounds>& aMeshBounds
+				  Bounds of the meshes drawn for each instance
+				FLOAT chunkSize
+				  Edge length of the chunk cubes in world units
+				std::vector<InstanceChunk>& aOutChunks
+				  Chunks in instance buffer order
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void InstanceChunker::SortIntoChunks(
+		_Inout_ std::vector<InstanceData>& aInstances,
+		_In_ const std::vector<MeshBounds>& aMeshBounds,
+		_In_ FLOAT chunkSize,
+		_Out_ std::vector<InstanceChunk>& aOutChunks
+	)
+	{
+		struct ChunkKey
+		{
+			INT aCell[3];
+			UINT uInstance;
+		};
+
+		aOutChunks.clear();
+		if (aInstances.empty())
+		{
+			return;
+		}
+
+		const FLOAT inverseChunkSize = 1.0f / std::max<FLOAT>(chunkSize, 1e-3f);
+		std::vector<ChunkKey> aKeys(aInstances.size());
+		for (UINT i = 0u; i < aInstances.size(); ++i)
+		{
+			XMFLOAT3 translation;
+			XMStoreFloat3(&translation, aInstances[i].Transformation.r[3]);
+
+			aKeys[i] =
+			{
+				.aCell =
+				{
+					static_cast<INT>(std::floor(translation.x * inverseChunkSize)),
+					static_cast<INT>(std::floor(translation.y * inverseChunkSize)),
+					static_cast<INT>(std::floor(translation.z * inverseChunkSize))
+				},
+				.uInstance = i
+			};
+		}
+
+		std::sort(
+			aKeys.begin(),
+			aKeys.end(),
+			[](const ChunkKey& a, const ChunkKey& b)
+			{
+				for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+				{
+					if (a.aCell[uAxis] != b.aCell[uAxis])
+					{
+						return a.aCell[uAxis] < b.aCell[uAxis];
+					}
+				}
+				return a.uInstance < b.uInstance;
+			}
+		);
+
+		std::vector<InstanceData> aSorted;
+		aSorted.reserve(aInstances.size());
+		for (UINT i = 0u; i < aKeys.size(); ++i)
+		{
+			const ChunkKey& key = aKeys[i];
+			if (i == 0u || !std::equal(key.aCell, key.aCell + 3, aKeys[i - 1u].aCell))
+			{
+				aOutChunks.push_back(
+					InstanceChunk
+					{
+						.Range = {.uStartInstance = i, .uNumInstances = 0u },
+						.Bounds = {.Center = XMFLOAT3(0.0f, 0.0f, 0.0f), .Extents = XMFLOAT3(0.0f, 0.0f, 0.0f), .Radius = -1.0f }
+					}
+				);
+			}
+
+			InstanceChunk& chunk = aOutChunks.back();
+			const InstanceData& instance = aInstances[key.uInstance];
+			for (const MeshBounds& meshBounds : aMeshBounds)
+			{
+				if (meshBounds.Radius >= 0.0f)
+				{
+					chunk.Bounds = FrustumCuller::MergeBounds(chunk.Bounds, FrustumCuller::TransformBounds(meshBounds, instance.Transformation));
+				}
+			}
+			++chunk.Range.uNumInstances;
+
+			aSorted.push_back(instance);
+		}
+
+		aInstances = std::move(aSorted);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   InstanceChunker::GetVisibleRanges
+
+	  Summary:  Collects the instances of the chunks that passed the
+				last Cull, merging neighbouring visible chunks into
+				one range so each range is one instanced draw
+
+	  Args:     const FrustumCuller& culler
+				  Culler the chunk bounds were added to, in order
+				UINT uFirstBounds
+				  Index AddBounds returned for the first chunk
+				const std::vector<InstanceChunk>& aChunks
+				  Chunks in instance buffer order
+				std::vector<InstanceRange>& aOutRanges
+				  Ranges to draw
+
+	  Returns:  UINT
+				  Number of instances to draw
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT InstanceChunker::GetVisibleRanges(
+		_In_ const FrustumCuller& culler,
+		_In_ UINT uFirstBounds,
+		_In_ const std::vector<InstanceChunk>& aChunks,
+		_Out_ std::vector<InstanceRange>& aOutRanges
+	)
+	{
+		aOutRanges.clear();
+
+		UINT uNumInstances = 0u;
+		for (UINT i = 0u; i < aChunks.size(); ++i)
+		{
+			if (!culler.IsVisible(uFirstBounds + i))
+			{
+				continue;
+			}
+
+			const InstanceRange& range = aChunks[i].Range;
+			if (!aOutRanges.empty() && aOutRanges.back().uStartInstance + aOutRanges.back().uNumInstances == range.uStartInstance)
+			{
+				aOutRanges.back().uNumInstances += range.uNumInstances;
+			}
+			else
+			{
+				aOutRanges.push_back(range);
+			}
+			uNumInstances += range.uNumInstances;
+		}
+
+		return uNumInstances;
+	}
+}
@@ -0,0 +1,87 @@
+/*+===================================================================
+  File:      INSTANCECHUNKER.H
+
+  Summary:   InstanceChunker header file contains declarations of
+			 InstanceChunker class that sorts instances into spatial
+			 chunks so instanced draws can be frustum culled by
+			 chunk.
+
+  Classes: InstanceChunker
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+#include "Renderer/FrustumCuller.h"
+
+namespace library
+{
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   InstanceRange
+
+		Summary:  Contiguous instances of an instance buffer, drawn with
+				  one instanced draw starting at uStartInstance
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct InstanceRange
+	{
+		UINT uStartInstance;
+		UINT uNumInstances;
+	};
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   InstanceChunk
+
+		Summary:  Instances within one cube of space and the bounds of
+				  all their meshes, before the world matrix
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct InstanceChunk
+	{
+		InstanceRange Range;
+		MeshBounds Bounds;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    InstanceChunker
+
+	  Summary:  Sorts instances by the cube of space their translation
+				falls in, so every chunk is a contiguous range of the
+				instance buffer with its own bounds. Chunks are then
+				frustum culled like meshes, and the visible ones are
+				drawn with one instanced draw per run of neighbouring
+				visible chunks.
+
+	  Methods:  SortIntoChunks
+				  Reorders instances by chunk and builds the chunks
+				GetVisibleRanges
+				  Merges the visible chunks into instance ranges
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class InstanceChunker final
+	{
+	public:
+		static constexpr FLOAT DEFAULT_CHUNK_SIZE = 32.0f;
+
+	public:
+		InstanceChunker() = delete;
+		InstanceChunker(const InstanceChunker& other) = delete;
+		InstanceChunker(InstanceChunker&& other) = delete;
+		InstanceChunker& operator=(const InstanceChunker& other) = delete;
+		InstanceChunker& operator=(InstanceChunker&& other) = delete;
+		~InstanceChunker() = delete;
+
+		static void SortIntoChunks(
+			_Inout_ std::vector<InstanceData>& aInstances,
+			_In_ const std::vector<MeshBounds>& aMeshBounds,
+			_In_ FLOAT chunkSize,
+			_Out_ std::vector<InstanceChunk>& aOutChunks
+		);
+		static UINT GetVisibleRanges(
+			_In_ const FrustumCuller& culler,
+			_In_ UINT uFirstBounds,
+			_In_ const std::vector<InstanceChunk>& aChunks,
+			_Out_ std::vector<InstanceRange>& aOutRanges
+		);
+	};
+}
@@ -14,6 +14,7 @@ namespace library
 		Renderable(outputColor),
 		m_instanceBuffer(),
 		m_aInstanceData(),
+		m_aChunks(),
 		m_padding()
 	{}
 
@@ -27,12 +28,13 @@ namespace library
 				const XMFLOAT4& outputColor
 				  Default color of the renderable
 
-	  Modifies: [m_instanceBuffer, m_aInstanceData].
+	  Modifies: [m_instanceBuffer, m_aInstanceData, m_aChunks].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	InstancedRenderable::InstancedRenderable(_In_ std::vector<InstanceData>&& aInstanceData, _In_ const XMFLOAT4& outputColor) :
 		Renderable(outputColor),
 		m_instanceBuffer(),
 		m_aInstanceData(aInstanceData),
+		m_aChunks(),
 		m_padding()
 	{}
 
@@ -77,21 +79,58 @@ namespace library
 		return static_cast<UINT>(m_aInstanceData.size());
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   InstancedRenderable::GetChunks
+
+	  Summary:  Returns the spatial chunks of the instances, each a
+				contiguous range of the instance buffer
+
+	  Returns:  const std::vector<InstanceChunk>&
+				  Chunks, empty before the instance buffer is created
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const std::vector<InstanceChunk>& InstancedRenderable::GetChunks() const
+	{
+		return m_aChunks;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   InstancedRenderable::GetInstanceData
+
+	  Summary:  Returns the instance data in the order of the instance
+				buffer, sorted into chunks once it is created
+
+	  Returns:  const std::vector<InstanceData>&
+				  Instance data
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const std::vector<InstanceData>& InstancedRenderable::GetInstanceData() const
+	{
+		return m_aInstanceData;
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   InstancedRenderable::initializeInstance
 
-	  Summary:  Creates an instance buffer
+	  Summary:  Sorts the instances into spatial chunks and creates
+				the instance buffer in chunk order
 
 	  Args:     ID3D11Device* pDevice
 				  Pointer to a Direct3D 11 device
 
-	  Modifies: [m_instanceBuffer].
+	  Modifies: [m_aInstanceData, m_aChunks, m_instanceBuffer].
 
 	  Returns:  HRESULT
 				  Status code
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	HRESULT InstancedRenderable::initializeInstance(_In_ ID3D11Device* pDevice)
 	{
+		std::vector<MeshBounds> aMeshBounds;
+		aMeshBounds.reserve(m_aMeshes.size());
+		for (const BasicMeshEntry& mesh : m_aMeshes)
+		{
+			aMeshBounds.push_back(mesh.Bounds);
+		}
+		InstanceChunker::SortIntoChunks(m_aInstanceData, aMeshBounds, InstanceChunker::DEFAULT_CHUNK_SIZE, m_aChunks);
+
 		D3D11_BUFFER_DESC bufferDesc =
 		{
 			.ByteWidth = static_cast<UINT>(sizeof(InstanceData) * GetNumInstances()),
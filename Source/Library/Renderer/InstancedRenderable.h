@@ -14,6 +14,7 @@
 #include "Common.h"
 
 #include "Renderer/DataTypes.h"
+#include "Renderer/InstanceChunker.h"
 #include "Renderer/Renderable.h"
 
 namespace library
@@ -29,6 +30,10 @@ namespace library
 				  Returns a instance buffer
 				GetNumInstances
 				  Returns the number of instance data
+				GetChunks
+				  Returns the spatial chunks of the instances
+				GetInstanceData
+				  Returns the instance data
 				initializeInstance
 				  Initialize the instance buffer
 				InstancedRenderable
@@ -54,6 +59,8 @@ namespace library
 
 		virtual ComPtr<ID3D11Buffer>& GetInstanceBuffer();
 		virtual UINT GetNumInstances() const;
+		const std::vector<InstanceChunk>& GetChunks() const;
+		const std::vector<InstanceData>& GetInstanceData() const;
 
 		UINT GetNumVertices() const override = 0;
 		UINT GetNumIndices() const override = 0;
@@ -67,6 +74,7 @@ namespace library
 	protected:
 		ComPtr<ID3D11Buffer> m_instanceBuffer;
 		std::vector<InstanceData> m_aInstanceData;
+		std::vector<InstanceChunk> m_aChunks;
 
 	private:
 		BYTE m_padding[8];
@@ -0,0 +1,1786 @@
+#include "Renderer/NullBackend.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace library
+{
+	namespace
+	{
+		/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+		  Function: isBlockCompressed
+
+		  Summary:  Returns whether a format stores 4x4 texel blocks
+
+		  Args:     DXGI_FORMAT format
+					  The format
+
+		  Returns:  BOOL
+					  TRUE for the BC formats
+		F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+		BOOL isBlockCompressed(_In_ DXGI_FORMAT format)
+		{
+			return (format >= DXGI_FORMAT_BC1_TYPELESS && format <= DXGI_FORMAT_BC5_SNORM)
+				|| (format >= DXGI_FORMAT_BC6H_TYPELESS && format <= DXGI_FORMAT_BC7_UNORM_SRGB);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::NullDevice
+
+	  Summary:  Constructor
+
+	  Modifies: [m_mutex, m_aObjects, m_handles, m_auNumObjects,
+				  m_uNumAllocatedBytes].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	NullDevice::NullDevice()
+		: m_mutex()
+		, m_aObjects()
+		, m_handles()
+		, m_auNumObjects{ 0u }
+		, m_uNumAllocatedBytes(0u)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::CreateBuffer
+
+	  Summary:  Creates a buffer handle of a size
+
+	  Args:     UINT uByteWidth
+				  Bytes of the buffer
+				GpuBuffer** ppBuffer
+				  Receives the handle
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT NullDevice::CreateBuffer(_In_ UINT uByteWidth, _Out_ GpuBuffer** ppBuffer)
+	{
+		if (!ppBuffer || uByteWidth == 0u)
+		{
+			return E_INVALIDARG;
+		}
+
+		*ppBuffer = static_cast<GpuBuffer*>(createObject(
+			NullObject
+			{
+				.Type = eNullObjectType::BUFFER,
+				.uByteSize = uByteWidth,
+				.uHeight = 0u,
+				.uBlockHeight = 0u,
+				.uNumMipLevels = 0u
+			}
+		));
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::CreateTexture2D
+
+	  Summary:  Creates a 2D texture handle, sized as every mip of
+				every slice would be. A mip count of zero makes the
+				full chain, as it does on a Direct3D device.
+
+	  Args:     const NullTextureDesc& desc
+				  Description of the texture
+				GpuTexture2D** ppTexture2D
+				  Receives the handle
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT NullDevice::CreateTexture2D(_In_ const NullTextureDesc& desc, _Out_ GpuTexture2D** ppTexture2D)
+	{
+		if (!ppTexture2D || desc.uWidth == 0u || desc.uHeight == 0u || desc.uArraySize == 0u)
+		{
+			return E_INVALIDARG;
+		}
+
+		UINT uNumMipLevels = desc.uNumMipLevels;
+		if (uNumMipLevels == 0u)
+		{
+			for (UINT uSize = std::max(desc.uWidth, desc.uHeight); uSize > 0u; uSize >>= 1u)
+			{
+				++uNumMipLevels;
+			}
+		}
+
+		const UINT uBlockSize = isBlockCompressed(desc.Format) ? 4u : 1u;
+		const UINT uBitsPerBlock = GetBitsPerPixel(desc.Format) * uBlockSize * uBlockSize;
+
+		UINT64 uByteSize = 0u;
+		for (UINT uMip = 0u; uMip < uNumMipLevels; ++uMip)
+		{
+			const UINT uWidth = std::max(desc.uWidth >> uMip, 1u);
+			const UINT uHeight = std::max(desc.uHeight >> uMip, 1u);
+			const UINT64 uNumBlocks = static_cast<UINT64>((uWidth + uBlockSize - 1u) / uBlockSize) * ((uHeight + uBlockSize - 1u) / uBlockSize);
+
+			uByteSize += uNumBlocks * uBitsPerBlock / 8u;
+		}
+		uByteSize *= desc.uArraySize;
+
+		if (uByteSize > UINT_MAX)
+		{
+			return E_OUTOFMEMORY;
+		}
+
+		*ppTexture2D = static_cast<GpuTexture2D*>(createObject(
+			NullObject
+			{
+				.Type = eNullObjectType::TEXTURE_2D,
+				.uByteSize = static_cast<UINT>(uByteSize),
+				.uHeight = desc.uHeight,
+				.uBlockHeight = uBlockSize,
+				.uNumMipLevels = uNumMipLevels
+			}
+		));
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::CreateVertexShader
+
+	  Summary:  Creates a vertex shader handle the size of its bytecode
+
+	  Args:     const void* pShaderBytecode
+				  Compiled shader
+				SIZE_T bytecodeLength
+				  Bytes of the compiled shader
+				GpuVertexShader** ppVertexShader
+				  Receives the handle
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT NullDevice::CreateVertexShader(_In_reads_bytes_(bytecodeLength) const void* pShaderBytecode, _In_ SIZE_T bytecodeLength, _Out_ GpuVertexShader** ppVertexShader)
+	{
+		if (!pShaderBytecode || !ppVertexShader || bytecodeLength == 0u || bytecodeLength > UINT_MAX)
+		{
+			return E_INVALIDARG;
+		}
+
+		*ppVertexShader = static_cast<GpuVertexShader*>(createObject(
+			NullObject{ .Type = eNullObjectType::VERTEX_SHADER, .uByteSize = static_cast<UINT>(bytecodeLength) }
+		));
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::CreatePixelShader
+
+	  Summary:  Creates a pixel shader handle the size of its bytecode
+
+	  Args:     const void* pShaderBytecode
+				  Compiled shader
+				SIZE_T bytecodeLength
+				  Bytes of the compiled shader
+				GpuPixelShader** ppPixelShader
+				  Receives the handle
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT NullDevice::CreatePixelShader(_In_reads_bytes_(bytecodeLength) const void* pShaderBytecode, _In_ SIZE_T bytecodeLength, _Out_ GpuPixelShader** ppPixelShader)
+	{
+		if (!pShaderBytecode || !ppPixelShader || bytecodeLength == 0u || bytecodeLength > UINT_MAX)
+		{
+			return E_INVALIDARG;
+		}
+
+		*ppPixelShader = static_cast<GpuPixelShader*>(createObject(
+			NullObject{ .Type = eNullObjectType::PIXEL_SHADER, .uByteSize = static_cast<UINT>(bytecodeLength) }
+		));
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::CreateInputLayout
+
+	  Summary:  Creates an input layout handle, signatures are not
+				matched
+
+	  Args:     UINT uNumElements
+				  Number of elements of the layout
+				GpuInputLayout** ppInputLayout
+				  Receives the handle
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT NullDevice::CreateInputLayout(_In_ UINT uNumElements, _Out_ GpuInputLayout** ppInputLayout)
+	{
+		if (!ppInputLayout || uNumElements == 0u || uNumElements > MAX_INPUT_ELEMENTS)
+		{
+			return E_INVALIDARG;
+		}
+
+		*ppInputLayout = static_cast<GpuInputLayout*>(createObject(NullObject{ .Type = eNullObjectType::INPUT_LAYOUT }));
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::CreateSamplerState
+
+	  Summary:  Creates a sampler state handle
+
+	  Args:     GpuSamplerState** ppSamplerState
+				  Receives the handle
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT NullDevice::CreateSamplerState(_Out_ GpuSamplerState** ppSamplerState)
+	{
+		if (!ppSamplerState)
+		{
+			return E_INVALIDARG;
+		}
+
+		*ppSamplerState = static_cast<GpuSamplerState*>(createObject(NullObject{ .Type = eNullObjectType::SAMPLER_STATE }));
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::CreateShaderResourceView
+
+	  Summary:  Creates a shader resource view handle of a resource
+				this device created
+
+	  Args:     GpuResource* pResource
+				  Viewed resource
+				GpuShaderResourceView** ppSRView
+				  Receives the handle
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT NullDevice::CreateShaderResourceView(_In_ GpuResource* pResource, _Out_ GpuShaderResourceView** ppSRView)
+	{
+		NullObject resource;
+		if (!ppSRView || !FindObject(pResource, resource))
+		{
+			return E_INVALIDARG;
+		}
+
+		*ppSRView = static_cast<GpuShaderResourceView*>(createObject(NullObject{ .Type = eNullObjectType::SHADER_RESOURCE_VIEW }));
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::CreateRenderTargetView
+
+	  Summary:  Creates a render target view handle of a texture this
+				device created
+
+	  Args:     GpuResource* pResource
+				  Viewed texture
+				GpuRenderTargetView** ppRTView
+				  Receives the handle
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT NullDevice::CreateRenderTargetView(_In_ GpuResource* pResource, _Out_ GpuRenderTargetView** ppRTView)
+	{
+		NullObject resource;
+		if (!ppRTView || !FindObject(pResource, resource) || resource.Type != eNullObjectType::TEXTURE_2D)
+		{
+			return E_INVALIDARG;
+		}
+
+		*ppRTView = static_cast<GpuRenderTargetView*>(createObject(NullObject{ .Type = eNullObjectType::RENDER_TARGET_VIEW }));
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::CreateDepthStencilView
+
+	  Summary:  Creates a depth stencil view handle of a texture this
+				device created
+
+	  Args:     GpuResource* pResource
+				  Viewed texture
+				GpuDepthStencilView** ppDepthStencilView
+				  Receives the handle
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT NullDevice::CreateDepthStencilView(_In_ GpuResource* pResource, _Out_ GpuDepthStencilView** ppDepthStencilView)
+	{
+		NullObject resource;
+		if (!ppDepthStencilView || !FindObject(pResource, resource) || resource.Type != eNullObjectType::TEXTURE_2D)
+		{
+			return E_INVALIDARG;
+		}
+
+		*ppDepthStencilView = static_cast<GpuDepthStencilView*>(createObject(NullObject{ .Type = eNullObjectType::DEPTH_STENCIL_VIEW }));
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::CreateDeferredContext
+
+	  Summary:  Creates a null context that measures updates and
+				sizes maps against this device
+
+	  Args:     std::unique_ptr<IRenderContext>& outContext
+				  Receives the context
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT NullDevice::CreateDeferredContext(_Out_ std::unique_ptr<IRenderContext>& outContext)
+	{
+		std::unique_ptr<NullContext> context = std::make_unique<NullContext>();
+		context->SetDevice(this);
+		outContext = std::move(context);
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::HasDriverCommandLists
+
+	  Summary:  Returns whether contexts record natively, which null
+				contexts always do
+
+	  Returns:  BOOL
+				  TRUE
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL NullDevice::HasDriverCommandLists() const
+	{
+		return TRUE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::FindObject
+
+	  Summary:  Returns what the device knows of a handle
+
+	  Args:     const void* pHandle
+				  Handle, of any type
+				NullObject& outObject
+				  Receives the object
+
+	  Returns:  BOOL
+				  TRUE if this device created the handle
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL NullDevice::FindObject(_In_opt_ const void* pHandle, _Out_ NullObject& outObject) const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		const auto it = m_handles.find(pHandle);
+		if (it == m_handles.end())
+		{
+			outObject = NullObject{ .Type = eNullObjectType::COUNT };
+			return FALSE;
+		}
+
+		outObject = *it->second;
+		return TRUE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::GetNumObjects
+
+	  Summary:  Returns the objects of a kind created so far
+
+	  Args:     eNullObjectType type
+				  Kind of object
+
+	  Returns:  UINT
+				  Number of objects
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT NullDevice::GetNumObjects(_In_ eNullObjectType type) const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		return type < eNullObjectType::COUNT ? m_auNumObjects[static_cast<size_t>(type)] : 0u;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::GetNumAllocatedBytes
+
+	  Summary:  Returns the bytes the buffers, textures and shaders
+				created so far would take on a device
+
+	  Returns:  UINT64
+				  Number of bytes
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT64 NullDevice::GetNumAllocatedBytes() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		return m_uNumAllocatedBytes;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::GetBitsPerPixel
+
+	  Summary:  Returns the bits of a texel of the formats the engine
+				creates, averaged over a block for BC formats. Other
+				formats count as 32 bits.
+
+	  Args:     DXGI_FORMAT format
+				  The format
+
+	  Returns:  UINT
+				  Bits per texel
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT NullDevice::GetBitsPerPixel(_In_ DXGI_FORMAT format)
+	{
+		switch (format)
+		{
+		case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		case DXGI_FORMAT_R32G32B32A32_UINT:
+		case DXGI_FORMAT_R32G32B32A32_SINT:
+			return 128u;
+
+		case DXGI_FORMAT_R32G32B32_TYPELESS:
+		case DXGI_FORMAT_R32G32B32_FLOAT:
+		case DXGI_FORMAT_R32G32B32_UINT:
+		case DXGI_FORMAT_R32G32B32_SINT:
+			return 96u;
+
+		case DXGI_FORMAT_R16G16B16A16_TYPELESS:
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+		case DXGI_FORMAT_R16G16B16A16_UNORM:
+		case DXGI_FORMAT_R16G16B16A16_UINT:
+		case DXGI_FORMAT_R16G16B16A16_SNORM:
+		case DXGI_FORMAT_R16G16B16A16_SINT:
+		case DXGI_FORMAT_R32G32_TYPELESS:
+		case DXGI_FORMAT_R32G32_FLOAT:
+		case DXGI_FORMAT_R32G32_UINT:
+		case DXGI_FORMAT_R32G32_SINT:
+			return 64u;
+
+		case DXGI_FORMAT_R16_TYPELESS:
+		case DXGI_FORMAT_R16_FLOAT:
+		case DXGI_FORMAT_D16_UNORM:
+		case DXGI_FORMAT_R16_UNORM:
+		case DXGI_FORMAT_R16_UINT:
+		case DXGI_FORMAT_R16_SNORM:
+		case DXGI_FORMAT_R16_SINT:
+		case DXGI_FORMAT_R8G8_TYPELESS:
+		case DXGI_FORMAT_R8G8_UNORM:
+		case DXGI_FORMAT_R8G8_UINT:
+		case DXGI_FORMAT_R8G8_SNORM:
+		case DXGI_FORMAT_R8G8_SINT:
+			return 16u;
+
+		case DXGI_FORMAT_R8_TYPELESS:
+		case DXGI_FORMAT_R8_UNORM:
+		case DXGI_FORMAT_R8_UINT:
+		case DXGI_FORMAT_R8_SNORM:
+		case DXGI_FORMAT_R8_SINT:
+		case DXGI_FORMAT_A8_UNORM:
+		case DXGI_FORMAT_BC2_TYPELESS:
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB:
+		case DXGI_FORMAT_BC3_TYPELESS:
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+		case DXGI_FORMAT_BC5_TYPELESS:
+		case DXGI_FORMAT_BC5_UNORM:
+		case DXGI_FORMAT_BC5_SNORM:
+		case DXGI_FORMAT_BC6H_TYPELESS:
+		case DXGI_FORMAT_BC6H_UF16:
+		case DXGI_FORMAT_BC6H_SF16:
+		case DXGI_FORMAT_BC7_TYPELESS:
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			return 8u;
+
+		case DXGI_FORMAT_BC1_TYPELESS:
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+		case DXGI_FORMAT_BC4_TYPELESS:
+		case DXGI_FORMAT_BC4_UNORM:
+		case DXGI_FORMAT_BC4_SNORM:
+			return 4u;
+
+		default:
+			return 32u;
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullDevice::createObject
+
+	  Summary:  Stores an object and returns its address as its handle
+
+	  Args:     const NullObject& object
+				  The object
+
+	  Modifies: [m_aObjects, m_handles, m_auNumObjects,
+				  m_uNumAllocatedBytes].
+
+	  Returns:  void*
+				  The handle
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void* NullDevice::createObject(_In_ const NullObject& object)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		NullObject& stored = m_aObjects.emplace_back(object);
+		m_handles[&stored] = &stored;
+		++m_auNumObjects[static_cast<size_t>(object.Type)];
+		m_uNumAllocatedBytes += object.uByteSize;
+
+		return &stored;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::NullContext
+
+	  Summary:  Constructor of an empty stream without a device
+
+	  Modifies: [m_pDevice, m_aCommands, m_aArgs, m_mappedMemory,
+				  m_auNumCommands, m_uNumIndices, m_uNumUploadedBytes].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	NullContext::NullContext()
+		: m_pDevice(nullptr)
+		, m_aCommands()
+		, m_aArgs()
+		, m_mappedMemory()
+		, m_auNumCommands{ 0u }
+		, m_uNumIndices(0u)
+		, m_uNumUploadedBytes(0u)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::SetDevice
+
+	  Summary:  Sets the device whose objects updates and maps are
+				measured against. Updates of objects it did not create
+				are measured from their box and pitches, or recorded
+				without their bytes if they have no box, and maps of
+				them fail.
+
+	  Args:     const NullDevice* pDevice
+				  The device
+
+	  Modifies: [m_pDevice].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::SetDevice(_In_opt_ const NullDevice* pDevice)
+	{
+		m_pDevice = pDevice;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::Clear
+
+	  Summary:  Drops the recorded commands and zeroes the counts,
+				keeping the memory for the next recording
+
+	  Modifies: [m_aCommands, m_aArgs, m_auNumCommands, m_uNumIndices,
+				  m_uNumUploadedBytes].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::Clear()
+	{
+		m_aCommands.clear();
+		m_aArgs.clear();
+		std::fill(std::begin(m_auNumCommands), std::end(m_auNumCommands), 0u);
+		m_uNumIndices = 0u;
+		m_uNumUploadedBytes = 0u;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::Append
+
+	  Summary:  Appends the commands and counts of another null
+				context, as executing its command list would
+
+	  Args:     const NullContext& other
+				  Context whose commands are appended
+
+	  Modifies: [m_aCommands, m_aArgs, m_auNumCommands, m_uNumIndices,
+				  m_uNumUploadedBytes].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::Append(_In_ const NullContext& other)
+	{
+		assert(&other != this);
+
+		const UINT uArgOffset = static_cast<UINT>(m_aArgs.size());
+		m_aArgs.insert(m_aArgs.end(), other.m_aArgs.begin(), other.m_aArgs.end());
+
+		m_aCommands.reserve(m_aCommands.size() + other.m_aCommands.size());
+		for (const NullCommand& command : other.m_aCommands)
+		{
+			m_aCommands.push_back(
+				NullCommand
+				{
+					.Type = command.Type,
+					.uFirstArg = command.uFirstArg + uArgOffset,
+					.uNumArgs = command.uNumArgs
+				}
+			);
+		}
+
+		for (size_t i = 0u; i < ARRAYSIZE(m_auNumCommands); ++i)
+		{
+			m_auNumCommands[i] += other.m_auNumCommands[i];
+		}
+		m_uNumIndices += other.m_uNumIndices;
+		m_uNumUploadedBytes += other.m_uNumUploadedBytes;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::Replay
+
+	  Summary:  Issues the recorded commands, in order, on a render
+				context. The handles are passed as recorded, so a
+				stream recorded with null device handles only replays
+				on a null context. Maps are replayed without writing
+				to the memory they return.
+
+	  Args:     IRenderContext& context
+				  Context the commands are issued on
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::Replay(_Inout_ IRenderContext& context) const
+	{
+		const BOOL bNullContext = dynamic_cast<const NullContext*>(&context) != nullptr;
+
+		void* apObjects[MAX_SHADER_RESOURCES] = {};
+		UINT auFirst[MAX_VERTEX_BUFFERS] = {};
+		UINT auSecond[MAX_VERTEX_BUFFERS] = {};
+
+		for (const NullCommand& command : m_aCommands)
+		{
+			const UINT uArg = command.uFirstArg;
+			switch (command.Type)
+			{
+			case eNullCommand::SET_INPUT_LAYOUT:
+				context.IASetInputLayout(getPointer<GpuInputLayout>(uArg));
+				break;
+
+			case eNullCommand::SET_VERTEX_BUFFERS:
+			{
+				// Start slot, count, then a buffer, stride and offset per slot
+				const UINT uNumBuffers = static_cast<UINT>(m_aArgs[uArg + 1u]);
+				for (UINT i = 0u; i < uNumBuffers; ++i)
+				{
+					apObjects[i] = getPointer<void>(uArg + 2u + i * 3u);
+					auFirst[i] = static_cast<UINT>(m_aArgs[uArg + 3u + i * 3u]);
+					auSecond[i] = static_cast<UINT>(m_aArgs[uArg + 4u + i * 3u]);
+				}
+				context.IASetVertexBuffers(static_cast<UINT>(m_aArgs[uArg]), uNumBuffers, reinterpret_cast<GpuBuffer* const*>(apObjects), auFirst, auSecond);
+				break;
+			}
+
+			case eNullCommand::SET_INDEX_BUFFER:
+				context.IASetIndexBuffer(getPointer<GpuBuffer>(uArg), static_cast<DXGI_FORMAT>(m_aArgs[uArg + 1u]), static_cast<UINT>(m_aArgs[uArg + 2u]));
+				break;
+
+			case eNullCommand::SET_PRIMITIVE_TOPOLOGY:
+				context.IASetPrimitiveTopology(static_cast<ePrimitiveTopology>(m_aArgs[uArg]));
+				break;
+
+			case eNullCommand::SET_VERTEX_SHADER:
+				context.VSSetShader(getPointer<GpuVertexShader>(uArg));
+				break;
+
+			case eNullCommand::SET_PIXEL_SHADER:
+				context.PSSetShader(getPointer<GpuPixelShader>(uArg));
+				break;
+
+			case eNullCommand::SET_VS_CONSTANT_BUFFERS1:
+			case eNullCommand::SET_PS_CONSTANT_BUFFERS1:
+			{
+				// Start slot, count, then a buffer, first and number of constants per slot
+				const UINT uNumBuffers = static_cast<UINT>(m_aArgs[uArg + 1u]);
+				for (UINT i = 0u; i < uNumBuffers; ++i)
+				{
+					apObjects[i] = getPointer<void>(uArg + 2u + i * 3u);
+					auFirst[i] = static_cast<UINT>(m_aArgs[uArg + 3u + i * 3u]);
+					auSecond[i] = static_cast<UINT>(m_aArgs[uArg + 4u + i * 3u]);
+				}
+
+				GpuBuffer* const* ppBuffers = reinterpret_cast<GpuBuffer* const*>(apObjects);
+				if (command.Type == eNullCommand::SET_VS_CONSTANT_BUFFERS1)
+				{
+					context.VSSetConstantBuffers1(static_cast<UINT>(m_aArgs[uArg]), uNumBuffers, ppBuffers, auFirst, auSecond);
+				}
+				else
+				{
+					context.PSSetConstantBuffers1(static_cast<UINT>(m_aArgs[uArg]), uNumBuffers, ppBuffers, auFirst, auSecond);
+				}
+				break;
+			}
+
+			case eNullCommand::SET_VS_CONSTANT_BUFFERS:
+			case eNullCommand::SET_PS_CONSTANT_BUFFERS:
+			case eNullCommand::SET_VS_SHADER_RESOURCES:
+			case eNullCommand::SET_PS_SHADER_RESOURCES:
+			case eNullCommand::SET_PS_SAMPLERS:
+			{
+				// Start slot, count, then an object per slot
+				const UINT uStartSlot = static_cast<UINT>(m_aArgs[uArg]);
+				const UINT uNumSlots = static_cast<UINT>(m_aArgs[uArg + 1u]);
+				for (UINT i = 0u; i < uNumSlots; ++i)
+				{
+					apObjects[i] = getPointer<void>(uArg + 2u + i);
+				}
+
+				switch (command.Type)
+				{
+				case eNullCommand::SET_VS_CONSTANT_BUFFERS:
+					context.VSSetConstantBuffers(uStartSlot, uNumSlots, reinterpret_cast<GpuBuffer* const*>(apObjects));
+					break;
+				case eNullCommand::SET_PS_CONSTANT_BUFFERS:
+					context.PSSetConstantBuffers(uStartSlot, uNumSlots, reinterpret_cast<GpuBuffer* const*>(apObjects));
+					break;
+				case eNullCommand::SET_VS_SHADER_RESOURCES:
+					context.VSSetShaderResources(uStartSlot, uNumSlots, reinterpret_cast<GpuShaderResourceView* const*>(apObjects));
+					break;
+				case eNullCommand::SET_PS_SHADER_RESOURCES:
+					context.PSSetShaderResources(uStartSlot, uNumSlots, reinterpret_cast<GpuShaderResourceView* const*>(apObjects));
+					break;
+				default:
+					context.PSSetSamplers(uStartSlot, uNumSlots, reinterpret_cast<GpuSamplerState* const*>(apObjects));
+					break;
+				}
+				break;
+			}
+
+			case eNullCommand::SET_RENDER_TARGETS:
+			{
+				// Count, the depth stencil view, then a view per target
+				const UINT uNumViews = static_cast<UINT>(m_aArgs[uArg]);
+				for (UINT i = 0u; i < uNumViews; ++i)
+				{
+					apObjects[i] = getPointer<void>(uArg + 2u + i);
+				}
+				context.OMSetRenderTargets(uNumViews, reinterpret_cast<GpuRenderTargetView* const*>(apObjects), getPointer<GpuDepthStencilView>(uArg + 1u));
+				break;
+			}
+
+			case eNullCommand::SET_VIEWPORTS:
+			{
+				GpuViewport aViewports[MAX_VIEWPORTS] = {};
+				const UINT uNumViewports = static_cast<UINT>(m_aArgs[uArg]);
+				for (UINT i = 0u; i < uNumViewports; ++i)
+				{
+					const UINT uViewportArg = uArg + 1u + i * 6u;
+					aViewports[i] =
+					{
+						.TopLeftX = getFloat(uViewportArg),
+						.TopLeftY = getFloat(uViewportArg + 1u),
+						.Width = getFloat(uViewportArg + 2u),
+						.Height = getFloat(uViewportArg + 3u),
+						.MinDepth = getFloat(uViewportArg + 4u),
+						.MaxDepth = getFloat(uViewportArg + 5u),
+					};
+				}
+				context.RSSetViewports(uNumViewports, aViewports);
+				break;
+			}
+
+			case eNullCommand::CLEAR_RENDER_TARGET_VIEW:
+			{
+				const FLOAT aColor[4] = { getFloat(uArg + 1u), getFloat(uArg + 2u), getFloat(uArg + 3u), getFloat(uArg + 4u) };
+				context.ClearRenderTargetView(getPointer<GpuRenderTargetView>(uArg), aColor);
+				break;
+			}
+
+			case eNullCommand::CLEAR_DEPTH_STENCIL_VIEW:
+				context.ClearDepthStencilView(getPointer<GpuDepthStencilView>(uArg), static_cast<UINT>(m_aArgs[uArg + 1u]), getFloat(uArg + 2u), static_cast<UINT8>(m_aArgs[uArg + 3u]));
+				break;
+
+			case eNullCommand::UPDATE_SUBRESOURCE:
+			{
+				// Resource, subresource, whether there is a box, the box,
+				// the pitches, the byte count, then the bytes. An update
+				// recorded without its bytes only replays on a null context.
+				if (m_aArgs[uArg + 11u] == 0u && !bNullContext)
+				{
+					break;
+				}
+
+				const GpuBox box =
+				{
+					.left = static_cast<UINT>(m_aArgs[uArg + 3u]),
+					.top = static_cast<UINT>(m_aArgs[uArg + 4u]),
+					.front = static_cast<UINT>(m_aArgs[uArg + 5u]),
+					.right = static_cast<UINT>(m_aArgs[uArg + 6u]),
+					.bottom = static_cast<UINT>(m_aArgs[uArg + 7u]),
+					.back = static_cast<UINT>(m_aArgs[uArg + 8u]),
+				};
+				context.UpdateSubresource(
+					getPointer<GpuResource>(uArg),
+					static_cast<UINT>(m_aArgs[uArg + 1u]),
+					m_aArgs[uArg + 2u] != 0u ? &box : nullptr,
+					m_aArgs.data() + uArg + 12u,
+					static_cast<UINT>(m_aArgs[uArg + 9u]),
+					static_cast<UINT>(m_aArgs[uArg + 10u])
+				);
+				break;
+			}
+
+			case eNullCommand::MAP:
+			{
+				void* pData = nullptr;
+				context.Map(getPointer<GpuResource>(uArg), static_cast<UINT>(m_aArgs[uArg + 1u]), static_cast<eMapType>(m_aArgs[uArg + 2u]), &pData);
+				break;
+			}
+
+			case eNullCommand::UNMAP:
+				context.Unmap(getPointer<GpuResource>(uArg), static_cast<UINT>(m_aArgs[uArg + 1u]));
+				break;
+
+			case eNullCommand::DRAW_INDEXED:
+				context.DrawIndexed(static_cast<UINT>(m_aArgs[uArg]), static_cast<UINT>(m_aArgs[uArg + 1u]), static_cast<INT>(m_aArgs[uArg + 2u]));
+				break;
+
+			case eNullCommand::DRAW_INDEXED_INSTANCED:
+				context.DrawIndexedInstanced(
+					static_cast<UINT>(m_aArgs[uArg]),
+					static_cast<UINT>(m_aArgs[uArg + 1u]),
+					static_cast<UINT>(m_aArgs[uArg + 2u]),
+					static_cast<INT>(m_aArgs[uArg + 3u]),
+					static_cast<UINT>(m_aArgs[uArg + 4u])
+				);
+				break;
+
+			default:
+				assert(false);
+				break;
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::Compare
+
+	  Summary:  Compares two streams call by call, arguments and
+				updated bytes included
+
+	  Args:     const NullContext& other
+				  Stream to compare with
+
+	  Returns:  UINT
+				  Index of the first command that differs, the length
+				  of the shorter stream if one starts the other, or
+				  NO_MISMATCH if they are the same
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT NullContext::Compare(_In_ const NullContext& other) const
+	{
+		const size_t uNumCommands = std::min(m_aCommands.size(), other.m_aCommands.size());
+		for (size_t i = 0u; i < uNumCommands; ++i)
+		{
+			const NullCommand& command = m_aCommands[i];
+			const NullCommand& otherCommand = other.m_aCommands[i];
+			if (command.Type != otherCommand.Type
+				|| command.uNumArgs != otherCommand.uNumArgs
+				|| !std::equal(
+					m_aArgs.begin() + command.uFirstArg,
+					m_aArgs.begin() + command.uFirstArg + command.uNumArgs,
+					other.m_aArgs.begin() + otherCommand.uFirstArg))
+			{
+				return static_cast<UINT>(i);
+			}
+		}
+
+		return m_aCommands.size() == other.m_aCommands.size() ? NO_MISMATCH : static_cast<UINT>(uNumCommands);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::GetNumCommands
+
+	  Summary:  Returns the recorded commands
+
+	  Returns:  UINT
+				  Number of commands
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT NullContext::GetNumCommands() const
+	{
+		return static_cast<UINT>(m_aCommands.size());
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::GetNumCommands
+
+	  Summary:  Returns the recorded commands of a kind
+
+	  Args:     eNullCommand type
+				  Kind of command
+
+	  Returns:  UINT
+				  Number of commands
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT NullContext::GetNumCommands(_In_ eNullCommand type) const
+	{
+		return type < eNullCommand::COUNT ? m_auNumCommands[static_cast<size_t>(type)] : 0u;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::GetCommand
+
+	  Summary:  Returns a recorded command
+
+	  Args:     UINT uCommand
+				  Index of the command
+
+	  Returns:  const NullCommand&
+				  The command
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const NullCommand& NullContext::GetCommand(_In_ UINT uCommand) const
+	{
+		return m_aCommands[uCommand];
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::GetCommandArg
+
+	  Summary:  Returns an argument of a recorded command, a handle
+				by its address and a float by its bits
+
+	  Args:     UINT uCommand
+				  Index of the command
+				UINT uArg
+				  Index of the argument in the command
+
+	  Returns:  UINT64
+				  The argument
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT64 NullContext::GetCommandArg(_In_ UINT uCommand, _In_ UINT uArg) const
+	{
+		assert(uArg < m_aCommands[uCommand].uNumArgs);
+
+		return m_aArgs[m_aCommands[uCommand].uFirstArg + uArg];
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::GetNumDraws
+
+	  Summary:  Returns the recorded draws, instanced or not
+
+	  Returns:  UINT
+				  Number of draws
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT NullContext::GetNumDraws() const
+	{
+		return GetNumCommands(eNullCommand::DRAW_INDEXED) + GetNumCommands(eNullCommand::DRAW_INDEXED_INSTANCED);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::GetNumIndices
+
+	  Summary:  Returns the indices the recorded draws read, every
+				instance counted
+
+	  Returns:  UINT64
+				  Number of indices
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT64 NullContext::GetNumIndices() const
+	{
+		return m_uNumIndices;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::GetNumUploadedBytes
+
+	  Summary:  Returns the bytes the recorded updates copied
+
+	  Returns:  UINT64
+				  Number of bytes
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT64 NullContext::GetNumUploadedBytes() const
+	{
+		return m_uNumUploadedBytes;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::IASetInputLayout
+
+	  Summary:  Records an input layout bind
+
+	  Args:     GpuInputLayout* pInputLayout
+				  The input layout
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::IASetInputLayout(_In_opt_ GpuInputLayout* pInputLayout)
+	{
+		beginCommand(eNullCommand::SET_INPUT_LAYOUT);
+		pushPointer(pInputLayout);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::IASetVertexBuffers
+
+	  Summary:  Records vertex buffer binds with their strides and
+				offsets
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumBuffers
+				  Number of slots
+				GpuBuffer* const* ppVertexBuffers
+				  Buffers
+				const UINT* puStrides
+				  Strides
+				const UINT* puOffsets
+				  Offsets
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::IASetVertexBuffers(
+		_In_ UINT uStartSlot,
+		_In_ UINT uNumBuffers,
+		_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppVertexBuffers,
+		_In_reads_opt_(uNumBuffers) const UINT* puStrides,
+		_In_reads_opt_(uNumBuffers) const UINT* puOffsets
+	)
+	{
+		uNumBuffers = uStartSlot < MAX_VERTEX_BUFFERS ? std::min(uNumBuffers, MAX_VERTEX_BUFFERS - uStartSlot) : 0u;
+
+		beginCommand(eNullCommand::SET_VERTEX_BUFFERS);
+		pushArg(uStartSlot);
+		pushArg(uNumBuffers);
+		for (UINT i = 0u; i < uNumBuffers; ++i)
+		{
+			pushPointer(ppVertexBuffers ? ppVertexBuffers[i] : nullptr);
+			pushArg(puStrides ? puStrides[i] : 0u);
+			pushArg(puOffsets ? puOffsets[i] : 0u);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::IASetIndexBuffer
+
+	  Summary:  Records an index buffer bind
+
+	  Args:     GpuBuffer* pIndexBuffer
+				  The index buffer
+				DXGI_FORMAT format
+				  Format of the indices
+				UINT uOffset
+				  Offset of the first index
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::IASetIndexBuffer(_In_opt_ GpuBuffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset)
+	{
+		beginCommand(eNullCommand::SET_INDEX_BUFFER);
+		pushPointer(pIndexBuffer);
+		pushArg(static_cast<UINT>(format));
+		pushArg(uOffset);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::IASetPrimitiveTopology
+
+	  Summary:  Records a topology change
+
+	  Args:     ePrimitiveTopology topology
+				  The topology
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::IASetPrimitiveTopology(_In_ ePrimitiveTopology topology)
+	{
+		beginCommand(eNullCommand::SET_PRIMITIVE_TOPOLOGY);
+		pushArg(static_cast<UINT>(topology));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::VSSetShader
+
+	  Summary:  Records a vertex shader bind
+
+	  Args:     GpuVertexShader* pVertexShader
+				  The vertex shader
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::VSSetShader(_In_opt_ GpuVertexShader* pVertexShader)
+	{
+		beginCommand(eNullCommand::SET_VERTEX_SHADER);
+		pushPointer(pVertexShader);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::PSSetShader
+
+	  Summary:  Records a pixel shader bind
+
+	  Args:     GpuPixelShader* pPixelShader
+				  The pixel shader
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::PSSetShader(_In_opt_ GpuPixelShader* pPixelShader)
+	{
+		beginCommand(eNullCommand::SET_PIXEL_SHADER);
+		pushPointer(pPixelShader);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::VSSetConstantBuffers
+
+	  Summary:  Records vertex shader constant buffer binds
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumBuffers
+				  Number of slots
+				GpuBuffer* const* ppConstantBuffers
+				  Buffers
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::VSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers)
+	{
+		pushSlots(eNullCommand::SET_VS_CONSTANT_BUFFERS, uStartSlot, uNumBuffers, MAX_CONSTANT_BUFFERS, reinterpret_cast<const void* const*>(ppConstantBuffers));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::PSSetConstantBuffers
+
+	  Summary:  Records pixel shader constant buffer binds
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumBuffers
+				  Number of slots
+				GpuBuffer* const* ppConstantBuffers
+				  Buffers
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::PSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers)
+	{
+		pushSlots(eNullCommand::SET_PS_CONSTANT_BUFFERS, uStartSlot, uNumBuffers, MAX_CONSTANT_BUFFERS, reinterpret_cast<const void* const*>(ppConstantBuffers));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::VSSetConstantBuffers1
+
+	  Summary:  Records vertex shader binds of constant buffer ranges
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumBuffers
+				  Number of slots
+				GpuBuffer* const* ppConstantBuffers
+				  Buffers
+				const UINT* puFirstConstant
+				  First constant of each range
+				const UINT* puNumConstants
+				  Constants of each range
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::VSSetConstantBuffers1(
+		_In_ UINT uStartSlot,
+		_In_ UINT uNumBuffers,
+		_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers,
+		_In_reads_opt_(uNumBuffers) const UINT* puFirstConstant,
+		_In_reads_opt_(uNumBuffers) const UINT* puNumConstants
+	)
+	{
+		uNumBuffers = uStartSlot < MAX_CONSTANT_BUFFERS ? std::min(uNumBuffers, MAX_CONSTANT_BUFFERS - uStartSlot) : 0u;
+
+		beginCommand(eNullCommand::SET_VS_CONSTANT_BUFFERS1);
+		pushArg(uStartSlot);
+		pushArg(uNumBuffers);
+		for (UINT i = 0u; i < uNumBuffers; ++i)
+		{
+			pushPointer(ppConstantBuffers ? ppConstantBuffers[i] : nullptr);
+			pushArg(puFirstConstant ? puFirstConstant[i] : 0u);
+			pushArg(puNumConstants ? puNumConstants[i] : 0u);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::PSSetConstantBuffers1
+
+	  Summary:  Records pixel shader binds of constant buffer ranges
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumBuffers
+				  Number of slots
+				GpuBuffer* const* ppConstantBuffers
+				  Buffers
+				const UINT* puFirstConstant
+				  First constant of each range
+				const UINT* puNumConstants
+				  Constants of each range
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::PSSetConstantBuffers1(
+		_In_ UINT uStartSlot,
+		_In_ UINT uNumBuffers,
+		_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers,
+		_In_reads_opt_(uNumBuffers) const UINT* puFirstConstant,
+		_In_reads_opt_(uNumBuffers) const UINT* puNumConstants
+	)
+	{
+		uNumBuffers = uStartSlot < MAX_CONSTANT_BUFFERS ? std::min(uNumBuffers, MAX_CONSTANT_BUFFERS - uStartSlot) : 0u;
+
+		beginCommand(eNullCommand::SET_PS_CONSTANT_BUFFERS1);
+		pushArg(uStartSlot);
+		pushArg(uNumBuffers);
+		for (UINT i = 0u; i < uNumBuffers; ++i)
+		{
+			pushPointer(ppConstantBuffers ? ppConstantBuffers[i] : nullptr);
+			pushArg(puFirstConstant ? puFirstConstant[i] : 0u);
+			pushArg(puNumConstants ? puNumConstants[i] : 0u);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::VSSetShaderResources
+
+	  Summary:  Records vertex shader resource view binds
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumViews
+				  Number of slots
+				GpuShaderResourceView* const* ppShaderResourceViews
+				  Views
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::VSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuShaderResourceView* const* ppShaderResourceViews)
+	{
+		pushSlots(eNullCommand::SET_VS_SHADER_RESOURCES, uStartSlot, uNumViews, MAX_SHADER_RESOURCES, reinterpret_cast<const void* const*>(ppShaderResourceViews));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::PSSetShaderResources
+
+	  Summary:  Records pixel shader resource view binds
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumViews
+				  Number of slots
+				GpuShaderResourceView* const* ppShaderResourceViews
+				  Views
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::PSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuShaderResourceView* const* ppShaderResourceViews)
+	{
+		pushSlots(eNullCommand::SET_PS_SHADER_RESOURCES, uStartSlot, uNumViews, MAX_SHADER_RESOURCES, reinterpret_cast<const void* const*>(ppShaderResourceViews));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::PSSetSamplers
+
+	  Summary:  Records pixel shader sampler binds
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumSamplers
+				  Number of slots
+				GpuSamplerState* const* ppSamplers
+				  Samplers
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::PSSetSamplers(_In_ UINT uStartSlot, _In_ UINT uNumSamplers, _In_reads_opt_(uNumSamplers) GpuSamplerState* const* ppSamplers)
+	{
+		pushSlots(eNullCommand::SET_PS_SAMPLERS, uStartSlot, uNumSamplers, MAX_SAMPLERS, reinterpret_cast<const void* const*>(ppSamplers));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::OMSetRenderTargets
+
+	  Summary:  Records render target and depth stencil binds
+
+	  Args:     UINT uNumViews
+				  Number of render targets
+				GpuRenderTargetView* const* ppRenderTargetViews
+				  Render targets
+				GpuDepthStencilView* pDepthStencilView
+				  Depth stencil target
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::OMSetRenderTargets(_In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuRenderTargetView* const* ppRenderTargetViews, _In_opt_ GpuDepthStencilView* pDepthStencilView)
+	{
+		uNumViews = std::min(uNumViews, MAX_RENDER_TARGETS);
+
+		beginCommand(eNullCommand::SET_RENDER_TARGETS);
+		pushArg(uNumViews);
+		pushPointer(pDepthStencilView);
+		for (UINT i = 0u; i < uNumViews; ++i)
+		{
+			pushPointer(ppRenderTargetViews ? ppRenderTargetViews[i] : nullptr);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::RSSetViewports
+
+	  Summary:  Records viewports
+
+	  Args:     UINT uNumViewports
+				  Number of viewports
+				const GpuViewport* pViewports
+				  Viewports
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::RSSetViewports(_In_ UINT uNumViewports, _In_reads_opt_(uNumViewports) const GpuViewport* pViewports)
+	{
+		uNumViewports = pViewports ? std::min(uNumViewports, MAX_VIEWPORTS) : 0u;
+
+		beginCommand(eNullCommand::SET_VIEWPORTS);
+		pushArg(uNumViewports);
+		for (UINT i = 0u; i < uNumViewports; ++i)
+		{
+			const GpuViewport& viewport = pViewports[i];
+			pushFloat(viewport.TopLeftX);
+			pushFloat(viewport.TopLeftY);
+			pushFloat(viewport.Width);
+			pushFloat(viewport.Height);
+			pushFloat(viewport.MinDepth);
+			pushFloat(viewport.MaxDepth);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::ClearRenderTargetView
+
+	  Summary:  Records a render target clear
+
+	  Args:     GpuRenderTargetView* pRenderTargetView
+				  Cleared target
+				const FLOAT colorRGBA[4]
+				  Clear color
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::ClearRenderTargetView(_In_ GpuRenderTargetView* pRenderTargetView, _In_ const FLOAT colorRGBA[4])
+	{
+		beginCommand(eNullCommand::CLEAR_RENDER_TARGET_VIEW);
+		pushPointer(pRenderTargetView);
+		for (UINT i = 0u; i < 4u; ++i)
+		{
+			pushFloat(colorRGBA[i]);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::ClearDepthStencilView
+
+	  Summary:  Records a depth stencil clear
+
+	  Args:     GpuDepthStencilView* pDepthStencilView
+				  Cleared target
+				UINT uClearFlags
+				  Whether depth, stencil or both are cleared
+				FLOAT depth
+				  Clear depth
+				UINT8 stencil
+				  Clear stencil
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::ClearDepthStencilView(_In_ GpuDepthStencilView* pDepthStencilView, _In_ UINT uClearFlags, _In_ FLOAT depth, _In_ UINT8 stencil)
+	{
+		beginCommand(eNullCommand::CLEAR_DEPTH_STENCIL_VIEW);
+		pushPointer(pDepthStencilView);
+		pushArg(uClearFlags);
+		pushFloat(depth);
+		pushArg(stencil);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::UpdateSubresource
+
+	  Summary:  Records an update and copies the bytes it uploads,
+				so replaying it uploads the same data
+
+	  Args:     GpuResource* pDstResource
+				  Updated resource
+				UINT uDstSubresource
+				  Updated subresource
+				const GpuBox* pDstBox
+				  Updated region, the whole subresource if null
+				const void* pSrcData
+				  Data
+				UINT uSrcRowPitch
+				  Bytes of a row of the data
+				UINT uSrcDepthPitch
+				  Bytes of a slice of the data
+
+	  Modifies: [m_uNumUploadedBytes].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::UpdateSubresource(
+		_In_ GpuResource* pDstResource,
+		_In_ UINT uDstSubresource,
+		_In_opt_ const GpuBox* pDstBox,
+		_In_ const void* pSrcData,
+		_In_ UINT uSrcRowPitch,
+		_In_ UINT uSrcDepthPitch
+	)
+	{
+		const UINT uNumBytes = pSrcData ? getUpdateSize(pDstResource, uDstSubresource, pDstBox, uSrcRowPitch, uSrcDepthPitch) : 0u;
+
+		beginCommand(eNullCommand::UPDATE_SUBRESOURCE);
+		pushPointer(pDstResource);
+		pushArg(uDstSubresource);
+		pushArg(pDstBox ? 1u : 0u);
+		pushArg(pDstBox ? pDstBox->left : 0u);
+		pushArg(pDstBox ? pDstBox->top : 0u);
+		pushArg(pDstBox ? pDstBox->front : 0u);
+		pushArg(pDstBox ? pDstBox->right : 0u);
+		pushArg(pDstBox ? pDstBox->bottom : 0u);
+		pushArg(pDstBox ? pDstBox->back : 0u);
+		pushArg(uSrcRowPitch);
+		pushArg(uSrcDepthPitch);
+		pushArg(uNumBytes);
+		pushBytes(pSrcData, uNumBytes);
+
+		m_uNumUploadedBytes += uNumBytes;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::Map
+
+	  Summary:  Records a map and returns memory the size of the
+				resource, kept per resource as a buffer's would be.
+				What is written to it is not recorded.
+
+	  Args:     GpuResource* pResource
+				  Mapped resource, created by the device
+				UINT uSubresource
+				  Mapped subresource
+				eMapType mapType
+				  Whether the contents are discarded or kept
+				void** ppData
+				  Receives the memory
+
+	  Modifies: [m_mappedMemory].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT NullContext::Map(_In_ GpuResource* pResource, _In_ UINT uSubresource, _In_ eMapType mapType, _Out_ void** ppData)
+	{
+		if (!ppData)
+		{
+			return E_INVALIDARG;
+		}
+		*ppData = nullptr;
+
+		NullObject object;
+		if (!m_pDevice || !m_pDevice->FindObject(pResource, object) || object.uByteSize == 0u)
+		{
+			return E_INVALIDARG;
+		}
+
+		beginCommand(eNullCommand::MAP);
+		pushPointer(pResource);
+		pushArg(uSubresource);
+		pushArg(static_cast<UINT>(mapType));
+
+		std::vector<BYTE>& memory = m_mappedMemory[pResource];
+		memory.resize(object.uByteSize);
+		*ppData = memory.data();
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::Unmap
+
+	  Summary:  Records an unmap
+
+	  Args:     GpuResource* pResource
+				  Unmapped resource
+				UINT uSubresource
+				  Unmapped subresource
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::Unmap(_In_ GpuResource* pResource, _In_ UINT uSubresource)
+	{
+		beginCommand(eNullCommand::UNMAP);
+		pushPointer(pResource);
+		pushArg(uSubresource);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::DrawIndexed
+
+	  Summary:  Records an indexed draw
+
+	  Args:     UINT uIndexCount
+				  Number of indices
+				UINT uStartIndexLocation
+				  First index
+				INT baseVertexLocation
+				  Added to each index
+
+	  Modifies: [m_uNumIndices].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndexLocation, _In_ INT baseVertexLocation)
+	{
+		beginCommand(eNullCommand::DRAW_INDEXED);
+		pushArg(uIndexCount);
+		pushArg(uStartIndexLocation);
+		pushArg(static_cast<UINT>(baseVertexLocation));
+
+		m_uNumIndices += uIndexCount;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::DrawIndexedInstanced
+
+	  Summary:  Records an instanced indexed draw
+
+	  Args:     UINT uIndexCountPerInstance
+				  Number of indices of an instance
+				UINT uInstanceCount
+				  Number of instances
+				UINT uStartIndexLocation
+				  First index
+				INT baseVertexLocation
+				  Added to each index
+				UINT uStartInstanceLocation
+				  First instance
+
+	  Modifies: [m_uNumIndices].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::DrawIndexedInstanced(
+		_In_ UINT uIndexCountPerInstance,
+		_In_ UINT uInstanceCount,
+		_In_ UINT uStartIndexLocation,
+		_In_ INT baseVertexLocation,
+		_In_ UINT uStartInstanceLocation
+	)
+	{
+		beginCommand(eNullCommand::DRAW_INDEXED_INSTANCED);
+		pushArg(uIndexCountPerInstance);
+		pushArg(uInstanceCount);
+		pushArg(uStartIndexLocation);
+		pushArg(static_cast<UINT>(baseVertexLocation));
+		pushArg(uStartInstanceLocation);
+
+		m_uNumIndices += static_cast<UINT64>(uIndexCountPerInstance) * uInstanceCount;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::HasConstantBufferOffsets
+
+	  Summary:  Returns whether constant buffer ranges can be bound,
+				which a null context records as given
+
+	  Returns:  BOOL
+				  TRUE
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL NullContext::HasConstantBufferOffsets() const
+	{
+		return TRUE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::FinishCommandList
+
+	  Summary:  Moves the recorded stream into a new null context and
+				starts this one over, as a deferred context does
+
+	  Args:     std::unique_ptr<IRenderCommandList>& outList
+				  Receives the command list
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT NullContext::FinishCommandList(_Out_ std::unique_ptr<IRenderCommandList>& outList)
+	{
+		std::unique_ptr<NullContext> list = std::make_unique<NullContext>();
+		list->SetDevice(m_pDevice);
+		list->Append(*this);
+		Clear();
+
+		outList = std::move(list);
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::ExecuteCommandList
+
+	  Summary:  Appends the stream of a command list a null context
+				finished
+
+	  Args:     IRenderCommandList& list
+				  The command list
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::ExecuteCommandList(_In_ IRenderCommandList& list)
+	{
+		Append(static_cast<const NullContext&>(list));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::beginCommand
+
+	  Summary:  Starts a command, the arguments pushed until the next
+				one are its arguments
+
+	  Args:     eNullCommand type
+				  Kind of command
+
+	  Modifies: [m_aCommands, m_auNumCommands].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::beginCommand(_In_ eNullCommand type)
+	{
+		m_aCommands.push_back(NullCommand{ .Type = type, .uFirstArg = static_cast<UINT>(m_aArgs.size()), .uNumArgs = 0u });
+		++m_auNumCommands[static_cast<size_t>(type)];
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::pushArg
+
+	  Summary:  Appends an argument to the current command
+
+	  Args:     UINT64 uArg
+				  The argument
+
+	  Modifies: [m_aCommands, m_aArgs].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::pushArg(_In_ UINT64 uArg)
+	{
+		m_aArgs.push_back(uArg);
+		++m_aCommands.back().uNumArgs;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::pushPointer
+
+	  Summary:  Appends a handle by address to the current command
+
+	  Args:     const void* p
+				  The handle
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::pushPointer(_In_opt_ const void* p)
+	{
+		pushArg(reinterpret_cast<UINT_PTR>(p));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::pushFloat
+
+	  Summary:  Appends a float by its bits to the current command, so
+				streams compare exactly
+
+	  Args:     FLOAT f
+				  The float
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::pushFloat(_In_ FLOAT f)
+	{
+		UINT uBits = 0u;
+		memcpy(&uBits, &f, sizeof(uBits));
+		pushArg(uBits);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::pushBytes
+
+	  Summary:  Appends bytes to the current command, padded with
+				zeros to whole arguments
+
+	  Args:     const void* pData
+				  The bytes
+				UINT uNumBytes
+				  Number of bytes
+
+	  Modifies: [m_aCommands, m_aArgs].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::pushBytes(_In_reads_bytes_(uNumBytes) const void* pData, _In_ UINT uNumBytes)
+	{
+		const UINT uNumArgs = (uNumBytes + sizeof(UINT64) - 1u) / sizeof(UINT64);
+		const size_t uFirstArg = m_aArgs.size();
+
+		m_aArgs.resize(uFirstArg + uNumArgs, 0u);
+		if (uNumBytes > 0u)
+		{
+			memcpy(m_aArgs.data() + uFirstArg, pData, uNumBytes);
+		}
+		m_aCommands.back().uNumArgs += uNumArgs;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::pushSlots
+
+	  Summary:  Records a command binding one object per slot, slots
+				past the last one a context has are dropped
+
+	  Args:     eNullCommand type
+				  Kind of command
+				UINT uStartSlot
+				  First slot
+				UINT uNumSlots
+				  Number of slots
+				UINT uMaxSlots
+				  Slots the context has
+				const void* const* ppObjects
+				  Objects, all null if null
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void NullContext::pushSlots(_In_ eNullCommand type, _In_ UINT uStartSlot, _In_ UINT uNumSlots, _In_ UINT uMaxSlots, _In_reads_opt_(uNumSlots) const void* const* ppObjects)
+	{
+		uNumSlots = uStartSlot < uMaxSlots ? std::min(uNumSlots, uMaxSlots - uStartSlot) : 0u;
+
+		beginCommand(type);
+		pushArg(uStartSlot);
+		pushArg(uNumSlots);
+		for (UINT i = 0u; i < uNumSlots; ++i)
+		{
+			pushPointer(ppObjects ? ppObjects[i] : nullptr);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::getUpdateSize
+
+	  Summary:  Returns the bytes an update reads from its data. A
+				buffer copies its box or all of it, a texture copies
+				a row pitch per row of its box or subresource, and a
+				depth pitch per slice past the first.
+
+	  Args:     const GpuResource* pDstResource
+				  Updated resource
+				UINT uDstSubresource
+				  Updated subresource
+				const GpuBox* pDstBox
+				  Updated region
+				UINT uSrcRowPitch
+				  Bytes of a row of the data
+				UINT uSrcDepthPitch
+				  Bytes of a slice of the data
+
+	  Returns:  UINT
+				  Number of bytes, 0 if it cannot be told
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT NullContext::getUpdateSize(_In_ const GpuResource* pDstResource, _In_ UINT uDstSubresource, _In_opt_ const GpuBox* pDstBox, _In_ UINT uSrcRowPitch, _In_ UINT uSrcDepthPitch) const
+	{
+		NullObject object;
+		const BOOL bKnown = m_pDevice && m_pDevice->FindObject(pDstResource, object);
+
+		if (bKnown && object.Type == eNullObjectType::BUFFER)
+		{
+			return pDstBox ? pDstBox->right - pDstBox->left : object.uByteSize;
+		}
+
+		UINT uNumRows = 0u;
+		UINT uNumSlices = 1u;
+		if (pDstBox)
+		{
+			const UINT uBlockHeight = bKnown ? object.uBlockHeight : 1u;
+			uNumRows = (pDstBox->bottom - pDstBox->top + uBlockHeight - 1u) / uBlockHeight;
+			uNumSlices = std::max(pDstBox->back - pDstBox->front, 1u);
+		}
+		else if (bKnown && object.Type == eNullObjectType::TEXTURE_2D)
+		{
+			const UINT uHeight = std::max(object.uHeight >> (uDstSubresource % object.uNumMipLevels), 1u);
+			uNumRows = (uHeight + object.uBlockHeight - 1u) / object.uBlockHeight;
+		}
+
+		return uNumRows > 0u ? uSrcDepthPitch * (uNumSlices - 1u) + uSrcRowPitch * uNumRows : 0u;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::getFloat
+
+	  Summary:  Returns a float stored in the argument stream
+
+	  Args:     UINT uArg
+				  Index of the argument
+
+	  Returns:  FLOAT
+				  The float as it was recorded
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	FLOAT NullContext::getFloat(_In_ UINT uArg) const
+	{
+		const UINT uBits = static_cast<UINT>(m_aArgs[uArg]);
+		FLOAT f = 0.0f;
+		memcpy(&f, &uBits, sizeof(f));
+		return f;
+	}
+}
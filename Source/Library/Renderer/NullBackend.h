@@ -0,0 +1,428 @@
+/*+===================================================================
+  File:      NULLBACKEND.H
+
+  Summary:   NullBackend header file contains declarations of the
+			 headless render backend: NullDevice that hands out
+			 resource handles, tracks their sizes and creates
+			 deferred null contexts, and NullContext that records
+			 the calls of IRenderContext into a stream that can be
+			 counted, compared and replayed. Neither needs a GPU or
+			 a Direct3D header.
+
+  Classes: NullDevice, NullContext
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Portable.h"
+
+#include <deque>
+#include <mutex>
+
+#include "Renderer/RenderDevice.h"
+
+namespace library
+{
+	/*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+	  Enum:     eNullObjectType
+
+	  Summary:  Kinds of objects a null device hands out
+	E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+	enum class eNullObjectType : UINT
+	{
+		BUFFER = 0,
+		TEXTURE_2D,
+		VERTEX_SHADER,
+		PIXEL_SHADER,
+		INPUT_LAYOUT,
+		SAMPLER_STATE,
+		SHADER_RESOURCE_VIEW,
+		RENDER_TARGET_VIEW,
+		DEPTH_STENCIL_VIEW,
+		COUNT,
+	};
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+	  Struct:   NullObject
+
+	  Summary:  What a null device remembers of an object. Height,
+				block height and mip levels are only set for textures,
+				updates use them to count the rows they copy.
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct NullObject
+	{
+		eNullObjectType Type;
+		UINT uByteSize;
+		UINT uHeight;
+		UINT uBlockHeight;
+		UINT uNumMipLevels;
+	};
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+	  Struct:   NullTextureDesc
+
+	  Summary:  What a null device needs to size a 2D texture
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct NullTextureDesc
+	{
+		UINT uWidth;
+		UINT uHeight;
+		UINT uNumMipLevels;
+		UINT uArraySize;
+		DXGI_FORMAT Format;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    NullDevice
+
+	  Summary:  Render device without a GPU. The create methods hand
+				out handles of the types IRenderContext takes, which
+				only a null context or a state cache may use, and
+				remember their sizes. Like a Direct3D device it may be
+				called from any thread.
+
+	  Methods:  CreateBuffer
+				  Creates a buffer handle
+				CreateTexture2D
+				  Creates a 2D texture handle
+				CreateVertexShader
+				  Creates a vertex shader handle
+				CreatePixelShader
+				  Creates a pixel shader handle
+				CreateInputLayout
+				  Creates an input layout handle
+				CreateSamplerState
+				  Creates a sampler state handle
+				CreateShaderResourceView
+				  Creates a shader resource view handle
+				CreateRenderTargetView
+				  Creates a render target view handle
+				CreateDepthStencilView
+				  Creates a depth stencil view handle
+				CreateDeferredContext
+				  Creates a null context measuring against the device
+				HasDriverCommandLists
+				  Returns TRUE, null contexts record natively
+				FindObject
+				  Returns what the device knows of a handle
+				GetNumObjects
+				  Returns the objects of a kind created
+				GetNumAllocatedBytes
+				  Returns the bytes of buffers, textures and shaders
+				GetBitsPerPixel
+				  Returns the size of a texel of a format
+				NullDevice
+				  Constructor.
+				~NullDevice
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class NullDevice final : public IRenderDevice
+	{
+	public:
+		static constexpr UINT MAX_INPUT_ELEMENTS = 32u;
+
+	public:
+		NullDevice();
+		NullDevice(const NullDevice& other) = delete;
+		NullDevice(NullDevice&& other) = delete;
+		NullDevice& operator=(const NullDevice& other) = delete;
+		NullDevice& operator=(NullDevice&& other) = delete;
+		~NullDevice() override = default;
+
+		HRESULT CreateBuffer(_In_ UINT uByteWidth, _Out_ GpuBuffer** ppBuffer);
+		HRESULT CreateTexture2D(_In_ const NullTextureDesc& desc, _Out_ GpuTexture2D** ppTexture2D);
+		HRESULT CreateVertexShader(_In_reads_bytes_(bytecodeLength) const void* pShaderBytecode, _In_ SIZE_T bytecodeLength, _Out_ GpuVertexShader** ppVertexShader);
+		HRESULT CreatePixelShader(_In_reads_bytes_(bytecodeLength) const void* pShaderBytecode, _In_ SIZE_T bytecodeLength, _Out_ GpuPixelShader** ppPixelShader);
+		HRESULT CreateInputLayout(_In_ UINT uNumElements, _Out_ GpuInputLayout** ppInputLayout);
+		HRESULT CreateSamplerState(_Out_ GpuSamplerState** ppSamplerState);
+		HRESULT CreateShaderResourceView(_In_ GpuResource* pResource, _Out_ GpuShaderResourceView** ppSRView);
+		HRESULT CreateRenderTargetView(_In_ GpuResource* pResource, _Out_ GpuRenderTargetView** ppRTView);
+		HRESULT CreateDepthStencilView(_In_ GpuResource* pResource, _Out_ GpuDepthStencilView** ppDepthStencilView);
+
+		HRESULT CreateDeferredContext(_Out_ std::unique_ptr<IRenderContext>& outContext) override;
+		BOOL HasDriverCommandLists() const override;
+
+		BOOL FindObject(_In_opt_ const void* pHandle, _Out_ NullObject& outObject) const;
+		UINT GetNumObjects(_In_ eNullObjectType type) const;
+		UINT64 GetNumAllocatedBytes() const;
+
+		static UINT GetBitsPerPixel(_In_ DXGI_FORMAT format);
+
+	private:
+		void* createObject(_In_ const NullObject& object);
+
+	private:
+		mutable std::mutex m_mutex;
+		std::deque<NullObject> m_aObjects;
+		std::unordered_map<const void*, const NullObject*> m_handles;
+		UINT m_auNumObjects[static_cast<size_t>(eNullObjectType::COUNT)];
+		UINT64 m_uNumAllocatedBytes;
+	};
+
+	/*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+	  Enum:     eNullCommand
+
+	  Summary:  Render context calls a null context records
+	E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+	enum class eNullCommand : UINT
+	{
+		SET_INPUT_LAYOUT = 0,
+		SET_VERTEX_BUFFERS,
+		SET_INDEX_BUFFER,
+		SET_PRIMITIVE_TOPOLOGY,
+		SET_VERTEX_SHADER,
+		SET_PIXEL_SHADER,
+		SET_VS_CONSTANT_BUFFERS,
+		SET_PS_CONSTANT_BUFFERS,
+		SET_VS_CONSTANT_BUFFERS1,
+		SET_PS_CONSTANT_BUFFERS1,
+		SET_VS_SHADER_RESOURCES,
+		SET_PS_SHADER_RESOURCES,
+		SET_PS_SAMPLERS,
+		SET_RENDER_TARGETS,
+		SET_VIEWPORTS,
+		CLEAR_RENDER_TARGET_VIEW,
+		CLEAR_DEPTH_STENCIL_VIEW,
+		UPDATE_SUBRESOURCE,
+		MAP,
+		UNMAP,
+		DRAW_INDEXED,
+		DRAW_INDEXED_INSTANCED,
+		COUNT,
+	};
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+	  Struct:   NullCommand
+
+	  Summary:  A recorded call and the range of the argument stream
+				holding its arguments
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct NullCommand
+	{
+		eNullCommand Type;
+		UINT uFirstArg;
+		UINT uNumArgs;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    NullContext
+
+	  Summary:  Render context without a GPU. Each call the renderer
+				makes is appended to a command stream with its
+				arguments, object handles by address and updated
+				constants by value, and counted per kind. Two streams
+				can be compared call by call, and a stream can be
+				appended to another null context, as executing a
+				command list would, or replayed on any render context.
+				A finished command list is itself a null context.
+				With a null device set, updates are measured in bytes
+				and maps hand out memory the size of the resource,
+				whose contents are not recorded.
+
+	  Methods:  SetDevice
+				  Sets the device whose objects are measured
+				Clear
+				  Drops the recorded commands and counts
+				Append
+				  Appends the commands of another null context
+				Replay
+				  Issues the recorded commands on a context
+				Compare
+				  Returns the first command two streams differ in
+				GetNumCommands
+				  Returns the recorded commands, all or of a kind
+				GetCommand
+				  Returns a recorded command
+				GetCommandArg
+				  Returns an argument of a recorded command
+				GetNumDraws
+				  Returns the recorded draws
+				GetNumIndices
+				  Returns the indices the draws read
+				GetNumUploadedBytes
+				  Returns the bytes the updates copied
+				IASetInputLayout
+				  Records an input layout bind
+				IASetVertexBuffers
+				  Records vertex buffer binds
+				IASetIndexBuffer
+				  Records an index buffer bind
+				IASetPrimitiveTopology
+				  Records a topology change
+				VSSetShader
+				  Records a vertex shader bind
+				PSSetShader
+				  Records a pixel shader bind
+				VSSetConstantBuffers
+				  Records vertex shader constant buffer binds
+				PSSetConstantBuffers
+				  Records pixel shader constant buffer binds
+				VSSetConstantBuffers1
+				  Records vertex shader constant buffer range binds
+				PSSetConstantBuffers1
+				  Records pixel shader constant buffer range binds
+				VSSetShaderResources
+				  Records vertex shader resource view binds
+				PSSetShaderResources
+				  Records pixel shader resource view binds
+				PSSetSamplers
+				  Records pixel shader sampler binds
+				OMSetRenderTargets
+				  Records render target binds
+				RSSetViewports
+				  Records viewports
+				ClearRenderTargetView
+				  Records a render target clear
+				ClearDepthStencilView
+				  Records a depth stencil clear
+				UpdateSubresource
+				  Records an update and copies its data
+				Map
+				  Records a map and returns the resource's memory
+				Unmap
+				  Records an unmap
+				DrawIndexed
+				  Records an indexed draw
+				DrawIndexedInstanced
+				  Records an instanced indexed draw
+				HasConstantBufferOffsets
+				  Returns TRUE, ranges are recorded as given
+				FinishCommandList
+				  Moves the stream into a new null context
+				ExecuteCommandList
+				  Appends a null context's stream
+				NullContext
+				  Constructor.
+				~NullContext
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class NullContext final : public IRenderContext, public IRenderCommandList
+	{
+	public:
+		static constexpr UINT NO_MISMATCH = UINT_MAX;
+
+	public:
+		NullContext();
+		NullContext(const NullContext& other) = delete;
+		NullContext(NullContext&& other) = delete;
+		NullContext& operator=(const NullContext& other) = delete;
+		NullContext& operator=(NullContext&& other) = delete;
+		~NullContext() override = default;
+
+		void SetDevice(_In_opt_ const NullDevice* pDevice);
+		void Clear();
+		void Append(_In_ const NullContext& other);
+		void Replay(_Inout_ IRenderContext& context) const;
+		UINT Compare(_In_ const NullContext& other) const;
+
+		UINT GetNumCommands() const;
+		UINT GetNumCommands(_In_ eNullCommand type) const;
+		const NullCommand& GetCommand(_In_ UINT uCommand) const;
+		UINT64 GetCommandArg(_In_ UINT uCommand, _In_ UINT uArg) const;
+		UINT GetNumDraws() const;
+		UINT64 GetNumIndices() const;
+		UINT64 GetNumUploadedBytes() const;
+
+		void IASetInputLayout(_In_opt_ GpuInputLayout* pInputLayout) override;
+		void IASetVertexBuffers(
+			_In_ UINT uStartSlot,
+			_In_ UINT uNumBuffers,
+			_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppVertexBuffers,
+			_In_reads_opt_(uNumBuffers) const UINT* puStrides,
+			_In_reads_opt_(uNumBuffers) const UINT* puOffsets
+		) override;
+		void IASetIndexBuffer(_In_opt_ GpuBuffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset) override;
+		void IASetPrimitiveTopology(_In_ ePrimitiveTopology topology) override;
+
+		void VSSetShader(_In_opt_ GpuVertexShader* pVertexShader) override;
+		void PSSetShader(_In_opt_ GpuPixelShader* pPixelShader) override;
+
+		void VSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers) override;
+		void PSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers) override;
+		void VSSetConstantBuffers1(
+			_In_ UINT uStartSlot,
+			_In_ UINT uNumBuffers,
+			_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers,
+			_In_reads_opt_(uNumBuffers) const UINT* puFirstConstant,
+			_In_reads_opt_(uNumBuffers) const UINT* puNumConstants
+		) override;
+		void PSSetConstantBuffers1(
+			_In_ UINT uStartSlot,
+			_In_ UINT uNumBuffers,
+			_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers,
+			_In_reads_opt_(uNumBuffers) const UINT* puFirstConstant,
+			_In_reads_opt_(uNumBuffers) const UINT* puNumConstants
+		) override;
+		void VSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuShaderResourceView* const* ppShaderResourceViews) override;
+		void PSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuShaderResourceView* const* ppShaderResourceViews) override;
+		void PSSetSamplers(_In_ UINT uStartSlot, _In_ UINT uNumSamplers, _In_reads_opt_(uNumSamplers) GpuSamplerState* const* ppSamplers) override;
+
+		void OMSetRenderTargets(_In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuRenderTargetView* const* ppRenderTargetViews, _In_opt_ GpuDepthStencilView* pDepthStencilView) override;
+		void RSSetViewports(_In_ UINT uNumViewports, _In_reads_opt_(uNumViewports) const GpuViewport* pViewports) override;
+		void ClearRenderTargetView(_In_ GpuRenderTargetView* pRenderTargetView, _In_ const FLOAT colorRGBA[4]) override;
+		void ClearDepthStencilView(_In_ GpuDepthStencilView* pDepthStencilView, _In_ UINT uClearFlags, _In_ FLOAT depth, _In_ UINT8 stencil) override;
+		void UpdateSubresource(
+			_In_ GpuResource* pDstResource,
+			_In_ UINT uDstSubresource,
+			_In_opt_ const GpuBox* pDstBox,
+			_In_ const void* pSrcData,
+			_In_ UINT uSrcRowPitch,
+			_In_ UINT uSrcDepthPitch
+		) override;
+		HRESULT Map(_In_ GpuResource* pResource, _In_ UINT uSubresource, _In_ eMapType mapType, _Out_ void** ppData) override;
+		void Unmap(_In_ GpuResource* pResource, _In_ UINT uSubresource) override;
+
+		void DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndexLocation, _In_ INT baseVertexLocation) override;
+		void DrawIndexedInstanced(
+			_In_ UINT uIndexCountPerInstance,
+			_In_ UINT uInstanceCount,
+			_In_ UINT uStartIndexLocation,
+			_In_ INT baseVertexLocation,
+			_In_ UINT uStartInstanceLocation
+		) override;
+
+		BOOL HasConstantBufferOffsets() const override;
+		HRESULT FinishCommandList(_Out_ std::unique_ptr<IRenderCommandList>& outList) override;
+		void ExecuteCommandList(_In_ IRenderCommandList& list) override;
+
+	private:
+		void beginCommand(_In_ eNullCommand type);
+		void pushArg(_In_ UINT64 uArg);
+		void pushPointer(_In_opt_ const void* p);
+		void pushFloat(_In_ FLOAT f);
+		void pushBytes(_In_reads_bytes_(uNumBytes) const void* pData, _In_ UINT uNumBytes);
+		void pushSlots(_In_ eNullCommand type, _In_ UINT uStartSlot, _In_ UINT uNumSlots, _In_ UINT uMaxSlots, _In_reads_opt_(uNumSlots) const void* const* ppObjects);
+		UINT getUpdateSize(_In_ const GpuResource* pDstResource, _In_ UINT uDstSubresource, _In_opt_ const GpuBox* pDstBox, _In_ UINT uSrcRowPitch, _In_ UINT uSrcDepthPitch) const;
+
+		template <class ObjectType>
+		ObjectType* getPointer(_In_ UINT uArg) const;
+		FLOAT getFloat(_In_ UINT uArg) const;
+
+	private:
+		const NullDevice* m_pDevice;
+		std::vector<NullCommand> m_aCommands;
+		std::vector<UINT64> m_aArgs;
+		std::unordered_map<const GpuResource*, std::vector<BYTE>> m_mappedMemory;
+		UINT m_auNumCommands[static_cast<size_t>(eNullCommand::COUNT)];
+		UINT64 m_uNumIndices;
+		UINT64 m_uNumUploadedBytes;
+	};
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   NullContext::getPointer
+
+	  Summary:  Returns a handle stored in the argument stream
+
+	  Args:     UINT uArg
+				  Index of the argument
+
+	  Returns:  ObjectType*
+				  The handle as it was recorded
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ObjectType>
+	ObjectType* NullContext::getPointer(_In_ UINT uArg) const
+	{
+		return reinterpret_cast<ObjectType*>(static_cast<UINT_PTR>(m_aArgs[uArg]));
+	}
+}
@@ -0,0 +1,1021 @@
+#include "Renderer/OcclusionCuller.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+
+namespace library
+{
+	namespace
+	{
+		// Triangles are only clipped against the sides when they reach
+		// this far outside of the screen
+		constexpr FLOAT GUARD_BAND = 8.0f;
+
+		// Near plane first, then the guard band, as distances a*x + b*y + c*z + d*w
+		constexpr UINT NUM_CLIP_PLANES = 5u;
+		const XMFLOAT4 CLIP_PLANES[NUM_CLIP_PLANES] =
+		{
+			XMFLOAT4(0.0f, 0.0f, 1.0f, 0.0f),
+			XMFLOAT4(1.0f, 0.0f, 0.0f, GUARD_BAND),
+			XMFLOAT4(-1.0f, 0.0f, 0.0f, GUARD_BAND),
+			XMFLOAT4(0.0f, 1.0f, 0.0f, GUARD_BAND),
+			XMFLOAT4(0.0f, -1.0f, 0.0f, GUARD_BAND),
+		};
+		constexpr UINT MAX_CLIPPED_VERTICES = 3u + NUM_CLIP_PLANES;
+
+		// Bounds tested by one job of Cull
+		constexpr UINT BOUNDS_PER_JOB = 64u;
+
+		// Columns whose tops differ by at most this many cells share a hull
+		constexpr INT HULL_HEIGHT_TOLERANCE = 1;
+
+		// Outward faces of a box whose corner i has bit 0 set for +x,
+		// bit 1 for +y and bit 2 for +z, clockwise seen from outside
+		constexpr WORD BOX_INDICES[] =
+		{
+			2u, 1u, 0u, 2u, 3u, 1u,
+			4u, 5u, 6u, 6u, 5u, 7u,
+			0u, 4u, 2u, 2u, 4u, 6u,
+			1u, 3u, 5u, 3u, 7u, 5u,
+			0u, 1u, 4u, 1u, 5u, 4u,
+			2u, 6u, 3u, 3u, 6u, 7u,
+		};
+
+		FLOAT getClipDistance(_In_ const XMFLOAT4& plane, _In_ const XMFLOAT4& position)
+		{
+			return plane.x * position.x + plane.y * position.y + plane.z * position.z + plane.w * position.w;
+		}
+
+		UINT getOutCode(_In_ const XMFLOAT4& position)
+		{
+			return (position.x < -position.w ? 1u : 0u)
+				| (position.x > position.w ? 2u : 0u)
+				| (position.y < -position.w ? 4u : 0u)
+				| (position.y > position.w ? 8u : 0u)
+				| (position.z < 0.0f ? 16u : 0u)
+				| (position.z > position.w ? 32u : 0u);
+		}
+
+		BOOL isInsideGuardBand(_In_ const XMFLOAT4& position)
+		{
+			return position.z >= 0.0f
+				&& fabsf(position.x) <= GUARD_BAND * position.w
+				&& fabsf(position.y) <= GUARD_BAND * position.w;
+		}
+
+		XMVECTOR getBoxCorner(_In_ const MeshBounds& box, _In_ UINT uCorner)
+		{
+			return XMVectorSet(
+				box.Center.x + (uCorner & 1u ? box.Extents.x : -box.Extents.x),
+				box.Center.y + (uCorner & 2u ? box.Extents.y : -box.Extents.y),
+				box.Center.z + (uCorner & 4u ? box.Extents.z : -box.Extents.z),
+				1.0f
+			);
+		}
+
+		MeshBounds makeBox(_In_ FXMVECTOR minimum, _In_ FXMVECTOR maximum)
+		{
+			MeshBounds box;
+			const XMVECTOR extents = XMVectorScale(XMVectorSubtract(maximum, minimum), 0.5f);
+			XMStoreFloat3(&box.Center, XMVectorScale(XMVectorAdd(minimum, maximum), 0.5f));
+			XMStoreFloat3(&box.Extents, extents);
+			box.Radius = XMVectorGetX(XMVector3Length(extents));
+
+			return box;
+		}
+
+		UINT64 getColumnKey(_In_ INT iX, _In_ INT iZ)
+		{
+			return (static_cast<UINT64>(static_cast<UINT>(iX)) << 32u) | static_cast<UINT>(iZ);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::OcclusionCuller
+
+	  Summary:  Constructor
+
+	  Modifies: [m_viewProjection, m_uWidth, m_uHeight, m_aLevels,
+				 m_aDepths, m_aVertices, m_aIndices, m_aClipPositions,
+				 m_aBatches, m_aOccluded, m_stats].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	OcclusionCuller::OcclusionCuller()
+		: m_viewProjection(XMMatrixIdentity())
+		, m_uWidth(0u)
+		, m_uHeight(0u)
+		, m_aLevels()
+		, m_aDepths()
+		, m_aVertices()
+		, m_aIndices()
+		, m_aClipPositions()
+		, m_aBatches()
+		, m_aOccluded()
+		, m_stats()
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::Initialize
+
+	  Summary:  Creates the depth buffer and every level of its
+				pyramid down to a single texel, halving the size and
+				rounding up, in one array
+
+	  Args:     UINT uWidth
+				  Width of the depth buffer
+				UINT uHeight
+				  Height of the depth buffer
+
+	  Modifies: [m_uWidth, m_uHeight, m_aLevels, m_aDepths].
+
+	  Returns:  HRESULT
+				  Status code, E_INVALIDARG for an empty buffer
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT OcclusionCuller::Initialize(_In_ UINT uWidth, _In_ UINT uHeight)
+	{
+		if (uWidth == 0u || uHeight == 0u)
+		{
+			return E_INVALIDARG;
+		}
+
+		m_uWidth = uWidth;
+		m_uHeight = uHeight;
+
+		m_aLevels.clear();
+		size_t uNumTexels = 0u;
+		DepthLevel level = { .uWidth = uWidth, .uHeight = uHeight, .uOffset = 0u };
+		for (;;)
+		{
+			level.uOffset = uNumTexels;
+			m_aLevels.push_back(level);
+			uNumTexels += static_cast<size_t>(level.uWidth) * level.uHeight;
+
+			if (level.uWidth == 1u && level.uHeight == 1u)
+			{
+				break;
+			}
+			level.uWidth = (level.uWidth + 1u) / 2u;
+			level.uHeight = (level.uHeight + 1u) / 2u;
+		}
+		m_aDepths.assign(uNumTexels, 0.0f);
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::SetViewProjection
+
+	  Summary:  Sets the matrix occluders and tested bounds are
+				projected with, the one the frustum was culled with
+
+	  Args:     FXMMATRIX viewProjection
+				  View matrix times projection matrix
+
+	  Modifies: [m_viewProjection].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void OcclusionCuller::SetViewProjection(_In_ FXMMATRIX viewProjection)
+	{
+		m_viewProjection = viewProjection;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::Reset
+
+	  Summary:  Removes every occluder, keeping the memory for the
+				next frame
+
+	  Modifies: [m_aVertices, m_aIndices, m_stats].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void OcclusionCuller::Reset()
+	{
+		m_aVertices.clear();
+		m_aIndices.clear();
+		m_stats = {};
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::AddOccluderBox
+
+	  Summary:  Adds the twelve triangles of a box that is solid, such
+				as the hull of terrain cells
+
+	  Args:     const MeshBounds& box
+				  Box, skipped when its radius is negative
+				FXMMATRIX world
+				  World matrix of the box
+
+	  Modifies: [m_aVertices, m_aIndices, m_stats].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void OcclusionCuller::AddOccluderBox(_In_ const MeshBounds& box, _In_ FXMMATRIX world)
+	{
+		if (box.Radius < 0.0f)
+		{
+			return;
+		}
+
+		const UINT uFirstVertex = static_cast<UINT>(m_aVertices.size());
+		for (UINT i = 0u; i < 8u; ++i)
+		{
+			XMFLOAT3 position;
+			XMStoreFloat3(&position, XMVector3TransformCoord(getBoxCorner(box, i), world));
+			m_aVertices.push_back(position);
+		}
+		for (WORD uIndex : BOX_INDICES)
+		{
+			m_aIndices.push_back(uFirstVertex + uIndex);
+		}
+
+		++m_stats.uNumOccluders;
+		m_stats.uNumOccluderTriangles += ARRAYSIZE(BOX_INDICES) / 3u;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::AddOccluderMesh
+
+	  Summary:  Adds the triangles of a closed mesh, transforming the
+				vertices it indexes to world space once. Triangles
+				with an index past the vertices are skipped.
+
+	  Args:     const SimpleVertex* pVertices
+				  Vertices of the renderable
+				UINT uNumVertices
+				  Number of vertices
+				const WORD* pIndices
+				  Indices of the mesh
+				UINT uNumIndices
+				  Number of indices of the mesh
+				UINT uBaseVertex
+				  Added to each index
+				FXMMATRIX world
+				  World matrix of the renderable
+
+	  Modifies: [m_aVertices, m_aIndices, m_stats].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void OcclusionCuller::AddOccluderMesh(
+		_In_reads_(uNumVertices) const SimpleVertex* pVertices,
+		_In_ UINT uNumVertices,
+		_In_reads_(uNumIndices) const WORD* pIndices,
+		_In_ UINT uNumIndices,
+		_In_ UINT uBaseVertex,
+		_In_ FXMMATRIX world
+	)
+	{
+		UINT uMinVertex = UINT_MAX;
+		UINT uMaxVertex = 0u;
+		for (UINT i = 0u; i < uNumIndices; ++i)
+		{
+			const UINT uVertex = uBaseVertex + pIndices[i];
+			if (uVertex < uNumVertices)
+			{
+				uMinVertex = std::min(uMinVertex, uVertex);
+				uMaxVertex = std::max(uMaxVertex, uVertex);
+			}
+		}
+		if (uMinVertex > uMaxVertex)
+		{
+			return;
+		}
+
+		const UINT uFirstVertex = static_cast<UINT>(m_aVertices.size());
+		for (UINT uVertex = uMinVertex; uVertex <= uMaxVertex; ++uVertex)
+		{
+			XMFLOAT3 position;
+			XMStoreFloat3(&position, XMVector3TransformCoord(XMLoadFloat3(&pVertices[uVertex].Position), world));
+			m_aVertices.push_back(position);
+		}
+
+		for (UINT i = 0u; i + 2u < uNumIndices; i += 3u)
+		{
+			const UINT aVertices[3] = { uBaseVertex + pIndices[i], uBaseVertex + pIndices[i + 1u], uBaseVertex + pIndices[i + 2u] };
+			if (aVertices[0] >= uNumVertices || aVertices[1] >= uNumVertices || aVertices[2] >= uNumVertices)
+			{
+				continue;
+			}
+
+			for (UINT uVertex : aVertices)
+			{
+				m_aIndices.push_back(uFirstVertex + uVertex - uMinVertex);
+			}
+			++m_stats.uNumOccluderTriangles;
+		}
+
+		++m_stats.uNumOccluders;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::Rasterize
+
+	  Summary:  Projects the occluder vertices, sets up their
+				triangles in batches, rasterizes strips of rows of the
+				depth buffer and builds the pyramid a level at a
+				time, each step spread over the job system
+
+	  Modifies: [m_aClipPositions, m_aBatches, m_aDepths, m_stats].
+
+	  Returns:  HRESULT
+				  Status code, E_FAIL before Initialize
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT OcclusionCuller::Rasterize()
+	{
+		if (m_aDepths.empty())
+		{
+			OutputDebugString(L"OcclusionCuller: rasterized before Initialize\n");
+			return E_FAIL;
+		}
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		JobSystem& jobSystem = JobSystem::GetInstance();
+
+		m_aClipPositions.resize(m_aVertices.size());
+		jobSystem.ParallelFor(
+			static_cast<UINT>(m_aVertices.size()),
+			TRIANGLES_PER_BATCH,
+			[this](UINT uBegin, UINT uEnd)
+			{
+				for (UINT i = uBegin; i < uEnd; ++i)
+				{
+					const XMFLOAT3& position = m_aVertices[i];
+					XMStoreFloat4(&m_aClipPositions[i], XMVector4Transform(XMVectorSet(position.x, position.y, position.z, 1.0f), m_viewProjection));
+				}
+			}
+		);
+
+		const UINT uNumTriangles = static_cast<UINT>(m_aIndices.size() / 3u);
+		m_aBatches.resize((uNumTriangles + TRIANGLES_PER_BATCH - 1u) / TRIANGLES_PER_BATCH);
+		jobSystem.ParallelFor(
+			static_cast<UINT>(m_aBatches.size()),
+			1u,
+			[this](UINT uBegin, UINT uEnd)
+			{
+				for (UINT i = uBegin; i < uEnd; ++i)
+				{
+					setupBatch(i);
+				}
+			}
+		);
+
+		jobSystem.ParallelFor(
+			(m_uHeight + STRIP_HEIGHT - 1u) / STRIP_HEIGHT,
+			1u,
+			[this](UINT uBegin, UINT uEnd)
+			{
+				for (UINT i = uBegin; i < uEnd; ++i)
+				{
+					rasterizeStrip(i);
+				}
+			}
+		);
+
+		for (UINT uLevel = 1u; uLevel < m_aLevels.size(); ++uLevel)
+		{
+			jobSystem.ParallelFor(
+				m_aLevels[uLevel].uHeight,
+				STRIP_HEIGHT,
+				[this, uLevel](UINT uBegin, UINT uEnd)
+				{
+					downsampleRows(uLevel, uBegin, uEnd);
+				}
+			);
+		}
+
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		m_stats.uNumRasterizedTriangles = 0u;
+		for (const std::vector<OccluderTriangle>& aTriangles : m_aBatches)
+		{
+			m_stats.uNumRasterizedTriangles += static_cast<UINT>(aTriangles.size());
+		}
+		m_stats.RasterMilliseconds = std::chrono::duration<FLOAT, std::milli>(end - start).count();
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::IsOccluded
+
+	  Summary:  Projects the corners of a box and finds the pyramid
+				level where its screen rectangle spans at most
+				MAX_TEST_TEXELS texels across. The box is hidden when
+				its nearest corner is farther than the farthest
+				occluder in every one of those texels. Boxes reaching
+				in front of the near plane are never hidden.
+
+	  Args:     const MeshBounds& worldBounds
+				  World space bounds
+
+	  Returns:  BOOL
+				  TRUE if the bounds are hidden by the occluders
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL OcclusionCuller::IsOccluded(_In_ const MeshBounds& worldBounds) const
+	{
+		if (worldBounds.Radius < 0.0f || m_aDepths.empty())
+		{
+			return FALSE;
+		}
+
+		FLOAT minX = FLT_MAX;
+		FLOAT minY = FLT_MAX;
+		FLOAT maxX = -FLT_MAX;
+		FLOAT maxY = -FLT_MAX;
+		FLOAT maxInvW = 0.0f;
+		for (UINT i = 0u; i < 8u; ++i)
+		{
+			XMFLOAT4 position;
+			XMStoreFloat4(&position, XMVector4Transform(getBoxCorner(worldBounds, i), m_viewProjection));
+			if (position.z < 0.0f || position.w <= 0.0f)
+			{
+				return FALSE;
+			}
+
+			const FLOAT invW = 1.0f / position.w;
+			const FLOAT x = (position.x * invW * 0.5f + 0.5f) * static_cast<FLOAT>(m_uWidth);
+			const FLOAT y = (-position.y * invW * 0.5f + 0.5f) * static_cast<FLOAT>(m_uHeight);
+			minX = std::min(minX, x);
+			minY = std::min(minY, y);
+			maxX = std::max(maxX, x);
+			maxY = std::max(maxY, y);
+			maxInvW = std::max(maxInvW, invW);
+		}
+
+		// Every pixel the rectangle touches
+		const INT iMinX = std::max(0, static_cast<INT>(floorf(minX)));
+		const INT iMinY = std::max(0, static_cast<INT>(floorf(minY)));
+		const INT iMaxX = std::min(static_cast<INT>(m_uWidth) - 1, static_cast<INT>(ceilf(maxX)) - 1);
+		const INT iMaxY = std::min(static_cast<INT>(m_uHeight) - 1, static_cast<INT>(ceilf(maxY)) - 1);
+		if (iMinX > iMaxX || iMinY > iMaxY)
+		{
+			return FALSE;
+		}
+
+		UINT uLevel = 0u;
+		while (uLevel + 1u < m_aLevels.size()
+			&& (static_cast<UINT>((iMaxX >> uLevel) - (iMinX >> uLevel)) >= MAX_TEST_TEXELS
+				|| static_cast<UINT>((iMaxY >> uLevel) - (iMinY >> uLevel)) >= MAX_TEST_TEXELS))
+		{
+			++uLevel;
+		}
+
+		const DepthLevel& level = m_aLevels[uLevel];
+		const FLOAT threshold = maxInvW / (1.0f - DEPTH_BIAS);
+		for (INT iY = iMinY >> uLevel; iY <= iMaxY >> uLevel; ++iY)
+		{
+			const FLOAT* pRow = &m_aDepths[level.uOffset + static_cast<size_t>(iY) * level.uWidth];
+			for (INT iX = iMinX >> uLevel; iX <= iMaxX >> uLevel; ++iX)
+			{
+				if (!(pRow[iX] > threshold))
+				{
+					return FALSE;
+				}
+			}
+		}
+
+		return TRUE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::Cull
+
+	  Summary:  Tests the bounds that passed the last Cull of a
+				frustum culler on the job system, then hides the
+				occluded ones, so draws skip them as if they were
+				outside of the frustum
+
+	  Args:     FrustumCuller& frustumCuller
+				  Frustum culler, culled with the same view
+				  projection, whose visible bounds are tested
+
+	  Modifies: [m_aOccluded, m_stats, frustumCuller].
+
+	  Returns:  UINT
+				  Number of bounds hidden
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT OcclusionCuller::Cull(_Inout_ FrustumCuller& frustumCuller)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		const UINT uNumBounds = frustumCuller.GetNumBounds();
+		m_aOccluded.assign(uNumBounds, FALSE);
+		JobSystem::GetInstance().ParallelFor(
+			uNumBounds,
+			BOUNDS_PER_JOB,
+			[this, &frustumCuller](UINT uBegin, UINT uEnd)
+			{
+				for (UINT i = uBegin; i < uEnd; ++i)
+				{
+					if (frustumCuller.IsVisible(i))
+					{
+						m_aOccluded[i] = IsOccluded(frustumCuller.GetBounds(i));
+					}
+				}
+			}
+		);
+
+		m_stats.uNumTestedBounds = frustumCuller.GetNumVisible();
+		m_stats.uNumOccludedBounds = 0u;
+		for (UINT i = 0u; i < uNumBounds; ++i)
+		{
+			if (m_aOccluded[i])
+			{
+				frustumCuller.Hide(i);
+				++m_stats.uNumOccludedBounds;
+			}
+		}
+
+		const auto end = std::chrono::high_resolution_clock::now();
+		m_stats.TestMilliseconds = std::chrono::duration<FLOAT, std::milli>(end - start).count();
+
+		return m_stats.uNumOccludedBounds;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::GetWidth
+
+	  Summary:  Returns the width of the depth buffer
+
+	  Returns:  UINT
+				  Width in texels
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT OcclusionCuller::GetWidth() const
+	{
+		return m_uWidth;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::GetHeight
+
+	  Summary:  Returns the height of the depth buffer
+
+	  Returns:  UINT
+				  Height in texels
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT OcclusionCuller::GetHeight() const
+	{
+		return m_uHeight;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::GetNumLevels
+
+	  Summary:  Returns the number of levels of the pyramid, the depth
+				buffer being level zero
+
+	  Returns:  UINT
+				  Number of levels
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT OcclusionCuller::GetNumLevels() const
+	{
+		return static_cast<UINT>(m_aLevels.size());
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::GetDepth
+
+	  Summary:  Returns a texel of a level of the pyramid
+
+	  Args:     UINT uLevel
+				  Level, zero for the depth buffer
+				UINT uX
+				  Column of the texel
+				UINT uY
+				  Row of the texel
+
+	  Returns:  FLOAT
+				  1/w of the farthest occluder in the texel, zero
+				  where there is none
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	FLOAT OcclusionCuller::GetDepth(_In_ UINT uLevel, _In_ UINT uX, _In_ UINT uY) const
+	{
+		const DepthLevel& level = m_aLevels[uLevel];
+		return m_aDepths[level.uOffset + static_cast<size_t>(uY) * level.uWidth + uX];
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::GetStats
+
+	  Summary:  Returns the work done by the last Rasterize and Cull
+
+	  Returns:  const OcclusionStats&
+				  Counts and times
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const OcclusionStats& OcclusionCuller::GetStats() const
+	{
+		return m_stats;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::BuildTerrainHulls
+
+	  Summary:  Merges the cells of a voxel grid into boxes that are
+				solid everywhere, to be drawn as occluders. The grid
+				is found from the first cell, and each column keeps
+				the run of cells below its top. Square tiles of
+				columns become one box from the highest bottom to the
+				lowest top when every column is present and their
+				tops are within HULL_HEIGHT_TOLERANCE; other tiles are
+				split in four down to single columns. Every box lies
+				inside the cells, so an occluder never hides what the
+				terrain does not.
+
+	  Args:     const std::vector<MeshBounds>& aCells
+				  World space boxes of equally sized cells on a grid
+				UINT uColumnsPerHull
+				  Columns along each side of the largest box, rounded
+				  down to a power of two
+				std::vector<MeshBounds>& aOutHulls
+				  Receives the boxes
+
+	  Modifies: [aOutHulls].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void OcclusionCuller::BuildTerrainHulls(_In_ const std::vector<MeshBounds>& aCells, _In_ UINT uColumnsPerHull, _Out_ std::vector<MeshBounds>& aOutHulls)
+	{
+		aOutHulls.clear();
+		if (aCells.empty())
+		{
+			return;
+		}
+
+		const XMFLOAT3 origin = aCells[0].Center;
+		const XMFLOAT3 size(aCells[0].Extents.x * 2.0f, aCells[0].Extents.y * 2.0f, aCells[0].Extents.z * 2.0f);
+		if (!(size.x > 0.0f && size.y > 0.0f && size.z > 0.0f))
+		{
+			return;
+		}
+
+		auto toGrid = [](FLOAT value, FLOAT start, FLOAT step)
+		{
+			return static_cast<INT>(floorf((value - start) / step + 0.5f));
+		};
+
+		std::unordered_map<UINT64, std::vector<INT>> cellsByColumn;
+		INT iMinX = INT_MAX;
+		INT iMinZ = INT_MAX;
+		INT iMaxX = INT_MIN;
+		INT iMaxZ = INT_MIN;
+		for (const MeshBounds& cell : aCells)
+		{
+			const INT iX = toGrid(cell.Center.x, origin.x, size.x);
+			const INT iZ = toGrid(cell.Center.z, origin.z, size.z);
+			cellsByColumn[getColumnKey(iX, iZ)].push_back(toGrid(cell.Center.y, origin.y, size.y));
+			iMinX = std::min(iMinX, iX);
+			iMinZ = std::min(iMinZ, iZ);
+			iMaxX = std::max(iMaxX, iX);
+			iMaxZ = std::max(iMaxZ, iZ);
+		}
+
+		// Bottom and top of the run of cells under the top of each column
+		std::unordered_map<UINT64, std::pair<INT, INT>> columns;
+		for (auto& pair : cellsByColumn)
+		{
+			std::vector<INT>& aHeights = pair.second;
+			std::sort(aHeights.begin(), aHeights.end());
+
+			size_t uBottom = aHeights.size() - 1u;
+			while (uBottom > 0u && aHeights[uBottom - 1u] >= aHeights[uBottom] - 1)
+			{
+				--uBottom;
+			}
+			columns[pair.first] = { aHeights[uBottom], aHeights.back() };
+		}
+
+		INT iTileSize = 1;
+		while (static_cast<UINT>(iTileSize) * 2u <= uColumnsPerHull)
+		{
+			iTileSize *= 2;
+		}
+
+		auto addHull = [&](INT iX, INT iZ, INT iNumColumns, INT iBottom, INT iTop)
+		{
+			const XMVECTOR minimum = XMVectorSet(
+				origin.x + (static_cast<FLOAT>(iX) - 0.5f) * size.x,
+				origin.y + (static_cast<FLOAT>(iBottom) - 0.5f) * size.y,
+				origin.z + (static_cast<FLOAT>(iZ) - 0.5f) * size.z,
+				0.0f
+			);
+			const XMVECTOR maximum = XMVectorSet(
+				origin.x + (static_cast<FLOAT>(iX + iNumColumns) - 0.5f) * size.x,
+				origin.y + (static_cast<FLOAT>(iTop) + 0.5f) * size.y,
+				origin.z + (static_cast<FLOAT>(iZ + iNumColumns) - 0.5f) * size.z,
+				0.0f
+			);
+			aOutHulls.push_back(makeBox(minimum, maximum));
+		};
+
+		auto mergeTile = [&](auto& self, INT iX, INT iZ, INT iNumColumns) -> void
+		{
+			INT iBottom = INT_MIN;
+			INT iMinTop = INT_MAX;
+			INT iMaxTop = INT_MIN;
+			BOOL bIsComplete = TRUE;
+			for (INT iColumnZ = iZ; iColumnZ < iZ + iNumColumns && bIsComplete; ++iColumnZ)
+			{
+				for (INT iColumnX = iX; iColumnX < iX + iNumColumns; ++iColumnX)
+				{
+					const auto it = columns.find(getColumnKey(iColumnX, iColumnZ));
+					if (it == columns.end())
+					{
+						bIsComplete = FALSE;
+						break;
+					}
+
+					iBottom = std::max(iBottom, it->second.first);
+					iMinTop = std::min(iMinTop, it->second.second);
+					iMaxTop = std::max(iMaxTop, it->second.second);
+				}
+			}
+
+			if (bIsComplete && iBottom <= iMinTop && iMaxTop - iMinTop <= HULL_HEIGHT_TOLERANCE)
+			{
+				addHull(iX, iZ, iNumColumns, iBottom, iMinTop);
+				return;
+			}
+			if (iNumColumns == 1)
+			{
+				return;
+			}
+
+			const INT iHalf = iNumColumns / 2;
+			self(self, iX, iZ, iHalf);
+			self(self, iX + iHalf, iZ, iHalf);
+			self(self, iX, iZ + iHalf, iHalf);
+			self(self, iX + iHalf, iZ + iHalf, iHalf);
+		};
+
+		for (INT iZ = iMinZ; iZ <= iMaxZ; iZ += iTileSize)
+		{
+			for (INT iX = iMinX; iX <= iMaxX; iX += iTileSize)
+			{
+				mergeTile(mergeTile, iX, iZ, iTileSize);
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::setupBatch
+
+	  Summary:  Culls the triangles of a batch outside of the view
+				volume, and sets up the others, clipping those that
+				cross the near plane or leave the guard band
+
+	  Args:     UINT uBatch
+				  Index of the batch
+
+	  Modifies: [m_aBatches].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void OcclusionCuller::setupBatch(_In_ UINT uBatch)
+	{
+		std::vector<OccluderTriangle>& aTriangles = m_aBatches[uBatch];
+		aTriangles.clear();
+
+		const size_t uFirstIndex = static_cast<size_t>(uBatch) * TRIANGLES_PER_BATCH * 3u;
+		const size_t uEndIndex = std::min(uFirstIndex + TRIANGLES_PER_BATCH * 3u, m_aIndices.size() / 3u * 3u);
+		for (size_t i = uFirstIndex; i < uEndIndex; i += 3u)
+		{
+			const XMFLOAT4& p0 = m_aClipPositions[m_aIndices[i]];
+			const XMFLOAT4& p1 = m_aClipPositions[m_aIndices[i + 1u]];
+			const XMFLOAT4& p2 = m_aClipPositions[m_aIndices[i + 2u]];
+			if ((getOutCode(p0) & getOutCode(p1) & getOutCode(p2)) != 0u)
+			{
+				continue;
+			}
+
+			if (isInsideGuardBand(p0) && isInsideGuardBand(p1) && isInsideGuardBand(p2))
+			{
+				setupTriangle(aTriangles, p0, p1, p2);
+			}
+			else
+			{
+				clipTriangle(aTriangles, p0, p1, p2);
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::setupTriangle
+
+	  Summary:  Projects a triangle to the depth buffer, culls it when
+				it is a back face, and sets up its edge functions, its
+				1/w at each vertex and the pixels its bounds cover
+
+	  Args:     std::vector<OccluderTriangle>& aTriangles
+				  Triangles of the batch
+				const XMFLOAT4& p0
+				  First clip space position
+				const XMFLOAT4& p1
+				  Second clip space position
+				const XMFLOAT4& p2
+				  Third clip space position
+
+	  Modifies: [aTriangles].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void OcclusionCuller::setupTriangle(_Inout_ std::vector<OccluderTriangle>& aTriangles, _In_ const XMFLOAT4& p0, _In_ const XMFLOAT4& p1, _In_ const XMFLOAT4& p2) const
+	{
+		const XMFLOAT4* apPositions[3] = { &p0, &p1, &p2 };
+
+		OccluderTriangle triangle;
+		FLOAT aX[3];
+		FLOAT aY[3];
+		for (UINT i = 0u; i < 3u; ++i)
+		{
+			const XMFLOAT4& position = *apPositions[i];
+			if (position.w <= 0.0f)
+			{
+				return;
+			}
+
+			const FLOAT invW = 1.0f / position.w;
+			aX[i] = (position.x * invW * 0.5f + 0.5f) * static_cast<FLOAT>(m_uWidth);
+			aY[i] = (-position.y * invW * 0.5f + 0.5f) * static_cast<FLOAT>(m_uHeight);
+			triangle.aInvW[i] = invW;
+		}
+
+		const FLOAT area = (aX[1] - aX[0]) * (aY[2] - aY[0]) - (aX[2] - aX[0]) * (aY[1] - aY[0]);
+		if (!(area > 0.0f))
+		{
+			return;
+		}
+
+		// Pixels whose centers are inside of the bounds
+		triangle.iMinX = std::max(0, static_cast<INT>(ceilf(std::min({ aX[0], aX[1], aX[2] }) - 0.5f)));
+		triangle.iMinY = std::max(0, static_cast<INT>(ceilf(std::min({ aY[0], aY[1], aY[2] }) - 0.5f)));
+		triangle.iMaxX = std::min(static_cast<INT>(m_uWidth), static_cast<INT>(floorf(std::max({ aX[0], aX[1], aX[2] }) - 0.5f)) + 1);
+		triangle.iMaxY = std::min(static_cast<INT>(m_uHeight), static_cast<INT>(floorf(std::max({ aY[0], aY[1], aY[2] }) - 0.5f)) + 1);
+		if (triangle.iMinX >= triangle.iMaxX || triangle.iMinY >= triangle.iMaxY)
+		{
+			return;
+		}
+
+		for (UINT i = 0u; i < 3u; ++i)
+		{
+			// Positive inside and equal to the area at vertex i
+			const UINT j = (i + 1u) % 3u;
+			const UINT k = (i + 2u) % 3u;
+			triangle.aEdgeA[i] = -(aY[k] - aY[j]);
+			triangle.aEdgeB[i] = aX[k] - aX[j];
+			triangle.aEdgeC[i] = -(triangle.aEdgeA[i] * aX[j] + triangle.aEdgeB[i] * aY[j]);
+		}
+		triangle.fInvArea = 1.0f / area;
+
+		aTriangles.push_back(triangle);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::clipTriangle
+
+	  Summary:  Clips a triangle against the near plane and the
+				guard band, then sets up the fan of the polygon left
+
+	  Args:     std::vector<OccluderTriangle>& aTriangles
+				  Triangles of the batch
+				const XMFLOAT4& p0
+				  First clip space position
+				const XMFLOAT4& p1
+				  Second clip space position
+				const XMFLOAT4& p2
+				  Third clip space position
+
+	  Modifies: [aTriangles].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void OcclusionCuller::clipTriangle(_Inout_ std::vector<OccluderTriangle>& aTriangles, _In_ const XMFLOAT4& p0, _In_ const XMFLOAT4& p1, _In_ const XMFLOAT4& p2) const
+	{
+		XMFLOAT4 aPolygons[2][MAX_CLIPPED_VERTICES];
+		aPolygons[0][0] = p0;
+		aPolygons[0][1] = p1;
+		aPolygons[0][2] = p2;
+		UINT uNumVertices = 3u;
+		UINT uCurrent = 0u;
+
+		for (const XMFLOAT4& plane : CLIP_PLANES)
+		{
+			const XMFLOAT4* aInput = aPolygons[uCurrent];
+			XMFLOAT4* aOutput = aPolygons[1u - uCurrent];
+			UINT uNumOutput = 0u;
+
+			for (UINT i = 0u; i < uNumVertices; ++i)
+			{
+				const XMFLOAT4& a = aInput[i];
+				const XMFLOAT4& b = aInput[(i + 1u) % uNumVertices];
+				const FLOAT distanceA = getClipDistance(plane, a);
+				const FLOAT distanceB = getClipDistance(plane, b);
+
+				if (distanceA >= 0.0f)
+				{
+					aOutput[uNumOutput++] = a;
+				}
+				if ((distanceA >= 0.0f) != (distanceB >= 0.0f))
+				{
+					XMStoreFloat4(&aOutput[uNumOutput++], XMVectorLerp(XMLoadFloat4(&a), XMLoadFloat4(&b), distanceA / (distanceA - distanceB)));
+				}
+			}
+
+			uNumVertices = uNumOutput;
+			uCurrent = 1u - uCurrent;
+			if (uNumVertices < 3u)
+			{
+				return;
+			}
+		}
+
+		const XMFLOAT4* aPolygon = aPolygons[uCurrent];
+		for (UINT i = 1u; i + 1u < uNumVertices; ++i)
+		{
+			setupTriangle(aTriangles, aPolygon[0], aPolygon[i], aPolygon[i + 1u]);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::rasterizeStrip
+
+	  Summary:  Clears STRIP_HEIGHT rows of the depth buffer and draws
+				every triangle that reaches them, keeping the nearest
+				1/w of the pixels whose centers they cover. Strips
+				share no pixel, so they are drawn in parallel.
+
+	  Args:     UINT uStrip
+				  Index of the strip
+
+	  Modifies: [m_aDepths].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void OcclusionCuller::rasterizeStrip(_In_ UINT uStrip)
+	{
+		const INT iBeginY = static_cast<INT>(uStrip * STRIP_HEIGHT);
+		const INT iEndY = std::min(iBeginY + static_cast<INT>(STRIP_HEIGHT), static_cast<INT>(m_uHeight));
+
+		FLOAT* pDepths = m_aDepths.data();
+		std::fill(pDepths + static_cast<size_t>(iBeginY) * m_uWidth, pDepths + static_cast<size_t>(iEndY) * m_uWidth, 0.0f);
+
+		for (const std::vector<OccluderTriangle>& aTriangles : m_aBatches)
+		{
+			for (const OccluderTriangle& triangle : aTriangles)
+			{
+				if (triangle.iMaxY <= iBeginY || triangle.iMinY >= iEndY)
+				{
+					continue;
+				}
+
+				const FLOAT startX = static_cast<FLOAT>(triangle.iMinX) + 0.5f;
+				for (INT iY = std::max(triangle.iMinY, iBeginY); iY < std::min(triangle.iMaxY, iEndY); ++iY)
+				{
+					const FLOAT y = static_cast<FLOAT>(iY) + 0.5f;
+					FLOAT aEdges[3];
+					for (UINT i = 0u; i < 3u; ++i)
+					{
+						aEdges[i] = triangle.aEdgeA[i] * startX + triangle.aEdgeB[i] * y + triangle.aEdgeC[i];
+					}
+
+					FLOAT* pRow = pDepths + static_cast<size_t>(iY) * m_uWidth;
+					for (INT iX = triangle.iMinX; iX < triangle.iMaxX; ++iX)
+					{
+						if (aEdges[0] >= 0.0f && aEdges[1] >= 0.0f && aEdges[2] >= 0.0f)
+						{
+							const FLOAT invW = (aEdges[0] * triangle.aInvW[0] + aEdges[1] * triangle.aInvW[1] + aEdges[2] * triangle.aInvW[2]) * triangle.fInvArea;
+							pRow[iX] = std::max(pRow[iX], invW);
+						}
+
+						aEdges[0] += triangle.aEdgeA[0];
+						aEdges[1] += triangle.aEdgeA[1];
+						aEdges[2] += triangle.aEdgeA[2];
+					}
+				}
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   OcclusionCuller::downsampleRows
+
+	  Summary:  Fills rows of a pyramid level with the farthest depth
+				of the two by two texels below each, repeating the
+				last row and column of a level of odd size
+
+	  Args:     UINT uLevel
+				  Level to fill, at least one
+				UINT uBeginY
+				  First row
+				UINT uEndY
+				  Row after the last
+
+	  Modifies: [m_aDepths].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void OcclusionCuller::downsampleRows(_In_ UINT uLevel, _In_ UINT uBeginY, _In_ UINT uEndY)
+	{
+		const DepthLevel& source = m_aLevels[uLevel - 1u];
+		const DepthLevel& destination = m_aLevels[uLevel];
+
+		for (UINT uY = uBeginY; uY < uEndY; ++uY)
+		{
+			const FLOAT* pRow0 = &m_aDepths[source.uOffset + static_cast<size_t>(uY * 2u) * source.uWidth];
+			const FLOAT* pRow1 = &m_aDepths[source.uOffset + static_cast<size_t>(std::min(uY * 2u + 1u, source.uHeight - 1u)) * source.uWidth];
+			FLOAT* pDestination = &m_aDepths[destination.uOffset + static_cast<size_t>(uY) * destination.uWidth];
+
+			for (UINT uX = 0u; uX < destination.uWidth; ++uX)
+			{
+				const UINT uX0 = uX * 2u;
+				const UINT uX1 = std::min(uX0 + 1u, source.uWidth - 1u);
+				pDestination[uX] = std::min({ pRow0[uX0], pRow0[uX1], pRow1[uX0], pRow1[uX1] });
+			}
+		}
+	}
+}
@@ -0,0 +1,197 @@
+/*+===================================================================
+  File:      OCCLUSIONCULLER.H
+
+  Summary:   OcclusionCuller header file contains declarations of
+			 OcclusionCuller class that rasterizes large occluders
+			 into a small depth buffer on the CPU and hides bounds
+			 that lie entirely behind them.
+
+  Classes: OcclusionCuller
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Job/JobSystem.h"
+#include "Renderer/DataTypes.h"
+#include "Renderer/FrustumCuller.h"
+
+namespace library
+{
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+	  Struct:   OcclusionStats
+
+	  Summary:  Work done by the last Rasterize and Cull
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct OcclusionStats
+	{
+		UINT uNumOccluders;
+		UINT uNumOccluderTriangles;
+		UINT uNumRasterizedTriangles;
+		UINT uNumTestedBounds;
+		UINT uNumOccludedBounds;
+		FLOAT RasterMilliseconds;
+		FLOAT TestMilliseconds;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    OcclusionCuller
+
+	  Summary:  Collects occluders, boxes and simplified meshes in
+				world space, and rasterizes their front faces into a
+				low resolution depth buffer on the job system, rows of
+				the buffer in parallel. The buffer keeps 1/w, cleared
+				to zero with the nearest occluder keeping the largest
+				value, so the result does not depend on the order the
+				triangles are drawn in. A hierarchical Z pyramid is
+				then built where each texel keeps the farthest depth
+				of the four below it. Bounds are tested by projecting
+				their box and comparing its nearest depth with the
+				farthest occluder depth of the few texels of the
+				pyramid level that its screen rectangle covers; the
+				bounds are hidden only if every texel is nearer.
+
+	  Methods:  Initialize
+				  Creates the depth buffer and its pyramid
+				SetViewProjection
+				  Sets the matrix occluders are projected with
+				Reset
+				  Removes every occluder
+				AddOccluderBox
+				  Adds the twelve triangles of a box
+				AddOccluderMesh
+				  Adds the triangles of a mesh
+				Rasterize
+				  Draws the occluders and builds the pyramid
+				IsOccluded
+				  Returns whether world space bounds are hidden
+				Cull
+				  Hides the occluded bounds a frustum culler passed
+				GetWidth
+				  Returns the width of the depth buffer
+				GetHeight
+				  Returns the height of the depth buffer
+				GetNumLevels
+				  Returns the number of pyramid levels
+				GetDepth
+				  Returns a texel of a pyramid level
+				GetStats
+				  Returns the work done by the last frame
+				BuildTerrainHulls
+				  Merges voxel cells into solid occluder boxes
+				OcclusionCuller
+				  Constructor.
+				~OcclusionCuller
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class OcclusionCuller final
+	{
+	public:
+		static constexpr UINT DEFAULT_WIDTH = 256u;
+		static constexpr UINT DEFAULT_HEIGHT = 128u;
+
+		// Columns along each side of the largest terrain hull
+		static constexpr UINT DEFAULT_COLUMNS_PER_HULL = 8u;
+
+		// Rows of the depth buffer rasterized by one job
+		static constexpr UINT STRIP_HEIGHT = 8u;
+
+		// Occluder triangles set up by one job
+		static constexpr UINT TRIANGLES_PER_BATCH = 1024u;
+
+		// A test reads the level where bounds cover at most this many texels across
+		static constexpr UINT MAX_TEST_TEXELS = 4u;
+
+		// Bounds must be this much farther, relative to 1/w, to be hidden
+		static constexpr FLOAT DEPTH_BIAS = 0.0001f;
+
+	public:
+		OcclusionCuller();
+		OcclusionCuller(const OcclusionCuller& other) = delete;
+		OcclusionCuller(OcclusionCuller&& other) = delete;
+		OcclusionCuller& operator=(const OcclusionCuller& other) = delete;
+		OcclusionCuller& operator=(OcclusionCuller&& other) = delete;
+		~OcclusionCuller() = default;
+
+		HRESULT Initialize(_In_ UINT uWidth, _In_ UINT uHeight);
+		void SetViewProjection(_In_ FXMMATRIX viewProjection);
+
+		void Reset();
+		void AddOccluderBox(_In_ const MeshBounds& box, _In_ FXMMATRIX world);
+		void AddOccluderMesh(
+			_In_reads_(uNumVertices) const SimpleVertex* pVertices,
+			_In_ UINT uNumVertices,
+			_In_reads_(uNumIndices) const WORD* pIndices,
+			_In_ UINT uNumIndices,
+			_In_ UINT uBaseVertex,
+			_In_ FXMMATRIX world
+		);
+		HRESULT Rasterize();
+
+		BOOL IsOccluded(_In_ const MeshBounds& worldBounds) const;
+		UINT Cull(_Inout_ FrustumCuller& frustumCuller);
+
+		UINT GetWidth() const;
+		UINT GetHeight() const;
+		UINT GetNumLevels() const;
+		FLOAT GetDepth(_In_ UINT uLevel, _In_ UINT uX, _In_ UINT uY) const;
+		const OcclusionStats& GetStats() const;
+
+		static void BuildTerrainHulls(_In_ const std::vector<MeshBounds>& aCells, _In_ UINT uColumnsPerHull, _Out_ std::vector<MeshBounds>& aOutHulls);
+
+	private:
+		/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		  Struct:   OccluderTriangle
+
+		  Summary:  A triangle set up for rasterization, with edge i
+					opposite vertex i written as A*x + B*y + C
+		S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+		struct OccluderTriangle
+		{
+			FLOAT aEdgeA[3];
+			FLOAT aEdgeB[3];
+			FLOAT aEdgeC[3];
+			FLOAT aInvW[3];
+			FLOAT fInvArea;
+			INT iMinX;
+			INT iMinY;
+			INT iMaxX;
+			INT iMaxY;
+		};
+
+		/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		  Struct:   DepthLevel
+
+		  Summary:  Size of a level of the pyramid and where its texels
+					start in the depth array
+		S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+		struct DepthLevel
+		{
+			UINT uWidth;
+			UINT uHeight;
+			size_t uOffset;
+		};
+
+	private:
+		void setupBatch(_In_ UINT uBatch);
+		void setupTriangle(_Inout_ std::vector<OccluderTriangle>& aTriangles, _In_ const XMFLOAT4& p0, _In_ const XMFLOAT4& p1, _In_ const XMFLOAT4& p2) const;
+		void clipTriangle(_Inout_ std::vector<OccluderTriangle>& aTriangles, _In_ const XMFLOAT4& p0, _In_ const XMFLOAT4& p1, _In_ const XMFLOAT4& p2) const;
+		void rasterizeStrip(_In_ UINT uStrip);
+		void downsampleRows(_In_ UINT uLevel, _In_ UINT uBeginY, _In_ UINT uEndY);
+
+	private:
+		XMMATRIX m_viewProjection;
+		UINT m_uWidth;
+		UINT m_uHeight;
+		std::vector<DepthLevel> m_aLevels;
+		std::vector<FLOAT> m_aDepths;
+		std::vector<XMFLOAT3> m_aVertices;
+		std::vector<UINT> m_aIndices;
+		std::vector<XMFLOAT4> m_aClipPositions;
+		std::vector<std::vector<OccluderTriangle>> m_aBatches;
+		std::vector<BOOL> m_aOccluded;
+		OcclusionStats m_stats;
+	};
+}
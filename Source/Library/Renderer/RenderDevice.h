@@ -0,0 +1,271 @@
+/*+===================================================================
+  File:      RENDERDEVICE.H
+
+  Summary:   RenderDevice header file contains declarations of the
+			 interfaces the renderer records its frames through:
+			 IRenderContext, the device context calls a frame makes,
+			 IRenderCommandList, what a deferred context recorded,
+			 and IRenderDevice, which creates deferred contexts.
+			 Objects are passed as opaque handles, so the interfaces
+			 and their null implementation need no Direct3D header.
+
+  Classes: IRenderContext, IRenderCommandList, IRenderDevice
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Portable.h"
+
+#include <dxgiformat.h>
+
+namespace library
+{
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+	  Struct:   GpuResource
+
+	  Summary:  Handles of the objects a backend created. They are
+				never dereferenced, a backend turns them back into its
+				own objects. Only the resources are defined, empty, so
+				a buffer or texture handle converts to a GpuResource
+				handle the way the Direct3D interfaces do.
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct GpuResource {};
+	struct GpuBuffer : GpuResource {};
+	struct GpuTexture2D : GpuResource {};
+	struct GpuInputLayout;
+	struct GpuVertexShader;
+	struct GpuPixelShader;
+	struct GpuShaderResourceView;
+	struct GpuSamplerState;
+	struct GpuRenderTargetView;
+	struct GpuDepthStencilView;
+
+	/*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+	  Enum:     ePrimitiveTopology
+
+	  Summary:  Primitive topologies, numbered as in Direct3D
+	E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+	enum class ePrimitiveTopology : UINT
+	{
+		UNDEFINED = 0,
+		POINT_LIST = 1,
+		LINE_LIST = 2,
+		LINE_STRIP = 3,
+		TRIANGLE_LIST = 4,
+		TRIANGLE_STRIP = 5,
+	};
+
+	/*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+	  Enum:     eMapType
+
+	  Summary:  How a mapped resource is written, numbered as in
+				Direct3D
+	E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+	enum class eMapType : UINT
+	{
+		WRITE_DISCARD = 4,
+		WRITE_NO_OVERWRITE = 5,
+	};
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+	  Struct:   GpuViewport
+
+	  Summary:  A viewport, laid out as D3D11_VIEWPORT
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct GpuViewport
+	{
+		FLOAT TopLeftX;
+		FLOAT TopLeftY;
+		FLOAT Width;
+		FLOAT Height;
+		FLOAT MinDepth;
+		FLOAT MaxDepth;
+	};
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+	  Struct:   GpuBox
+
+	  Summary:  A region of a subresource, laid out as D3D11_BOX
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct GpuBox
+	{
+		UINT left;
+		UINT top;
+		UINT front;
+		UINT right;
+		UINT bottom;
+		UINT back;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    IRenderCommandList
+
+	  Summary:  What a deferred context recorded, executed by the
+				immediate context of the same backend
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class IRenderCommandList
+	{
+	public:
+		virtual ~IRenderCommandList() = default;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    IRenderContext
+
+	  Summary:  The device context calls the renderer records a frame
+				with, named and ordered as on ID3D11DeviceContext1.
+				The immediate context executes command lists, a
+				deferred one finishes them. Calls on one context must
+				come from one thread at a time.
+
+	  Methods:  IASetInputLayout
+				  Binds an input layout
+				IASetVertexBuffers
+				  Binds vertex buffers
+				IASetIndexBuffer
+				  Binds an index buffer
+				IASetPrimitiveTopology
+				  Sets the primitive topology
+				VSSetShader
+				  Binds a vertex shader
+				PSSetShader
+				  Binds a pixel shader
+				VSSetConstantBuffers
+				  Binds vertex shader constant buffers
+				PSSetConstantBuffers
+				  Binds pixel shader constant buffers
+				VSSetConstantBuffers1
+				  Binds vertex shader constant buffer ranges
+				PSSetConstantBuffers1
+				  Binds pixel shader constant buffer ranges
+				VSSetShaderResources
+				  Binds vertex shader resource views
+				PSSetShaderResources
+				  Binds pixel shader resource views
+				PSSetSamplers
+				  Binds pixel shader samplers
+				OMSetRenderTargets
+				  Binds render targets
+				RSSetViewports
+				  Sets viewports
+				ClearRenderTargetView
+				  Clears a render target
+				ClearDepthStencilView
+				  Clears a depth stencil target
+				UpdateSubresource
+				  Copies data into a resource
+				Map
+				  Maps a resource for writing
+				Unmap
+				  Unmaps a resource
+				DrawIndexed
+				  Draws indexed primitives
+				DrawIndexedInstanced
+				  Draws instances of indexed primitives
+				HasConstantBufferOffsets
+				  Returns whether constant buffer ranges can be bound
+				FinishCommandList
+				  Turns what a deferred context recorded into a list
+				ExecuteCommandList
+				  Executes a command list
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class IRenderContext
+	{
+	public:
+		static constexpr UINT MAX_VERTEX_BUFFERS = 32u;
+		static constexpr UINT MAX_CONSTANT_BUFFERS = 14u;
+		static constexpr UINT MAX_SHADER_RESOURCES = 128u;
+		static constexpr UINT MAX_SAMPLERS = 16u;
+		static constexpr UINT MAX_RENDER_TARGETS = 8u;
+		static constexpr UINT MAX_VIEWPORTS = 16u;
+		static constexpr UINT CLEAR_DEPTH = 0x1u;
+		static constexpr UINT CLEAR_STENCIL = 0x2u;
+
+	public:
+		virtual ~IRenderContext() = default;
+
+		virtual void IASetInputLayout(_In_opt_ GpuInputLayout* pInputLayout) = 0;
+		virtual void IASetVertexBuffers(
+			_In_ UINT uStartSlot,
+			_In_ UINT uNumBuffers,
+			_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppVertexBuffers,
+			_In_reads_opt_(uNumBuffers) const UINT* puStrides,
+			_In_reads_opt_(uNumBuffers) const UINT* puOffsets
+		) = 0;
+		virtual void IASetIndexBuffer(_In_opt_ GpuBuffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset) = 0;
+		virtual void IASetPrimitiveTopology(_In_ ePrimitiveTopology topology) = 0;
+
+		virtual void VSSetShader(_In_opt_ GpuVertexShader* pVertexShader) = 0;
+		virtual void PSSetShader(_In_opt_ GpuPixelShader* pPixelShader) = 0;
+
+		virtual void VSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers) = 0;
+		virtual void PSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers) = 0;
+		virtual void VSSetConstantBuffers1(
+			_In_ UINT uStartSlot,
+			_In_ UINT uNumBuffers,
+			_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers,
+			_In_reads_opt_(uNumBuffers) const UINT* puFirstConstant,
+			_In_reads_opt_(uNumBuffers) const UINT* puNumConstants
+		) = 0;
+		virtual void PSSetConstantBuffers1(
+			_In_ UINT uStartSlot,
+			_In_ UINT uNumBuffers,
+			_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers,
+			_In_reads_opt_(uNumBuffers) const UINT* puFirstConstant,
+			_In_reads_opt_(uNumBuffers) const UINT* puNumConstants
+		) = 0;
+		virtual void VSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuShaderResourceView* const* ppShaderResourceViews) = 0;
+		virtual void PSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuShaderResourceView* const* ppShaderResourceViews) = 0;
+		virtual void PSSetSamplers(_In_ UINT uStartSlot, _In_ UINT uNumSamplers, _In_reads_opt_(uNumSamplers) GpuSamplerState* const* ppSamplers) = 0;
+
+		virtual void OMSetRenderTargets(_In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuRenderTargetView* const* ppRenderTargetViews, _In_opt_ GpuDepthStencilView* pDepthStencilView) = 0;
+		virtual void RSSetViewports(_In_ UINT uNumViewports, _In_reads_opt_(uNumViewports) const GpuViewport* pViewports) = 0;
+		virtual void ClearRenderTargetView(_In_ GpuRenderTargetView* pRenderTargetView, _In_ const FLOAT colorRGBA[4]) = 0;
+		virtual void ClearDepthStencilView(_In_ GpuDepthStencilView* pDepthStencilView, _In_ UINT uClearFlags, _In_ FLOAT depth, _In_ UINT8 stencil) = 0;
+
+		virtual void UpdateSubresource(
+			_In_ GpuResource* pDstResource,
+			_In_ UINT uDstSubresource,
+			_In_opt_ const GpuBox* pDstBox,
+			_In_ const void* pSrcData,
+			_In_ UINT uSrcRowPitch,
+			_In_ UINT uSrcDepthPitch
+		) = 0;
+		virtual HRESULT Map(_In_ GpuResource* pResource, _In_ UINT uSubresource, _In_ eMapType mapType, _Out_ void** ppData) = 0;
+		virtual void Unmap(_In_ GpuResource* pResource, _In_ UINT uSubresource) = 0;
+
+		virtual void DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndexLocation, _In_ INT baseVertexLocation) = 0;
+		virtual void DrawIndexedInstanced(
+			_In_ UINT uIndexCountPerInstance,
+			_In_ UINT uInstanceCount,
+			_In_ UINT uStartIndexLocation,
+			_In_ INT baseVertexLocation,
+			_In_ UINT uStartInstanceLocation
+		) = 0;
+
+		virtual BOOL HasConstantBufferOffsets() const = 0;
+		virtual HRESULT FinishCommandList(_Out_ std::unique_ptr<IRenderCommandList>& outList) = 0;
+		virtual void ExecuteCommandList(_In_ IRenderCommandList& list) = 0;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    IRenderDevice
+
+	  Summary:  Creates the deferred contexts frames are recorded on
+				from worker threads. May be called from any thread.
+
+	  Methods:  CreateDeferredContext
+				  Creates a deferred context
+				HasDriverCommandLists
+				  Returns whether the driver records natively
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class IRenderDevice
+	{
+	public:
+		virtual ~IRenderDevice() = default;
+
+		virtual HRESULT CreateDeferredContext(_Out_ std::unique_ptr<IRenderContext>& outContext) = 0;
+		virtual BOOL HasDriverCommandLists() const = 0;
+	};
+}
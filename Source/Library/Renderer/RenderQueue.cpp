@@ -0,0 +1,334 @@
+#include "Renderer/RenderQueue.h"
+
+#include <algorithm>
+
+namespace library
+{
+	namespace
+	{
+		constexpr UINT RADIX_BITS = 11u;
+		constexpr UINT RADIX_SIZE = 1u << RADIX_BITS;
+		constexpr UINT MAX_NUM_RADIX_PASSES = (64u + RADIX_BITS - 1u) / RADIX_BITS;
+		constexpr UINT64 INDEX_MASK = (1ull << RenderQueue::INDEX_BITS) - 1ull;
+
+		constexpr UINT PASS_SHIFT = 62u;
+		constexpr UINT VERTEX_SHADER_SHIFT = 57u;
+		constexpr UINT PIXEL_SHADER_SHIFT = 52u;
+		constexpr UINT MATERIAL_SHIFT = 42u;
+		constexpr UINT DEPTH_SHIFT = 31u;
+
+		constexpr UINT64 PASS_MASK = 0x3ull;
+		constexpr UINT64 SHADER_MASK = 0x1Full;
+		constexpr UINT64 MATERIAL_MASK = 0x3FFull;
+		constexpr UINT64 DEPTH_MASK = 0x7FFull;
+
+		constexpr UINT NUM_SORT_PASSES = (64u - DEPTH_SHIFT + RADIX_BITS - 1u) / RADIX_BITS;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RenderQueue::RenderQueue
+
+	  Summary:  Constructor
+
+	  Modifies: [m_aPackets, m_aSortKeys, m_aScratch, m_aHistograms,
+				 m_stateIds].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	RenderQueue::RenderQueue()
+		: m_aPackets()
+		, m_aSortKeys()
+		, m_aScratch()
+		, m_aHistograms(static_cast<size_t>(NUM_SORT_PASSES) * RADIX_SIZE, 0u)
+		, m_stateIds()
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RenderQueue::MakeKey
+
+	  Summary:  Packs a sort key. Ids beyond their bits wrap around,
+				which only makes the sort group less state; the draws
+				are still bound correctly.
+
+	  Args:     eRenderPass pass
+				  Pass of the draw
+				UINT uVertexShaderId
+				  Id of the vertex shader from GetStateId
+				UINT uPixelShaderId
+				  Id of the pixel shader from GetStateId
+				UINT uMaterialId
+				  Id of the material from GetStateId
+				FLOAT depth
+				  View depth from 0, near, to 1, far. Clamped.
+
+	  Returns:  UINT64
+				  Sort key
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT64 RenderQueue::MakeKey(
+		_In_ eRenderPass pass,
+		_In_ UINT uVertexShaderId,
+		_In_ UINT uPixelShaderId,
+		_In_ UINT uMaterialId,
+		_In_ FLOAT depth
+	)
+	{
+		depth = std::min<FLOAT>(std::max<FLOAT>(depth, 0.0f), 1.0f);
+		const UINT64 ullDepth = static_cast<UINT64>(depth * static_cast<FLOAT>(DEPTH_MASK));
+
+		return ((static_cast<UINT64>(pass) & PASS_MASK) << PASS_SHIFT)
+			| ((static_cast<UINT64>(uVertexShaderId) & SHADER_MASK) << VERTEX_SHADER_SHIFT)
+			| ((static_cast<UINT64>(uPixelShaderId) & SHADER_MASK) << PIXEL_SHADER_SHIFT)
+			| ((static_cast<UINT64>(uMaterialId) & MATERIAL_MASK) << MATERIAL_SHIFT)
+			| ((ullDepth & DEPTH_MASK) << DEPTH_SHIFT);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RenderQueue::GetStateId
+
+	  Summary:  Returns the id of a shader, texture view or other
+				state object, given in the order they are first seen
+				and kept across frames so keys stay stable
+
+	  Args:     const void* pState
+				  State object, or nullptr
+
+	  Modifies: [m_stateIds].
+
+	  Returns:  UINT
+				  Id of the state, 0 for nullptr
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT RenderQueue::GetStateId(_In_opt_ const void* pState)
+	{
+		if (!pState)
+		{
+			return 0u;
+		}
+
+		auto it = m_stateIds.find(pState);
+		if (it == m_stateIds.end())
+		{
+			it = m_stateIds.emplace(pState, static_cast<UINT>(m_stateIds.size()) + 1u).first;
+		}
+
+		return it->second;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RenderQueue::Reset
+
+	  Summary:  Removes every packet, keeping the memory for the next
+				frame
+
+	  Modifies: [m_aPackets, m_aSortKeys, m_aHistograms].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void RenderQueue::Reset()
+	{
+		m_aPackets.clear();
+		m_aSortKeys.clear();
+		std::fill(m_aHistograms.begin(), m_aHistograms.end(), 0u);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RenderQueue::Push
+
+	  Summary:  Adds a packet with its sort key. The low INDEX_BITS of
+				the key are replaced by the index of the packet. The
+				digits of the key are counted here, while the key is
+				at hand, so Sort does not read the keys an extra time.
+
+	  Args:     UINT64 ullKey
+				  Key from MakeKey
+				const DrawPacket& packet
+				  Mesh to draw
+
+	  Modifies: [m_aPackets, m_aSortKeys, m_aHistograms].
+
+	  Returns:  BOOL
+				  FALSE if the queue already holds MAX_NUM_PACKETS
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL RenderQueue::Push(_In_ UINT64 ullKey, _In_ const DrawPacket& packet)
+	{
+		if (m_aPackets.size() >= MAX_NUM_PACKETS)
+		{
+			return FALSE;
+		}
+
+		m_aSortKeys.push_back((ullKey & ~INDEX_MASK) | static_cast<UINT64>(m_aPackets.size()));
+		m_aPackets.push_back(packet);
+
+		UINT64 ullDigits = ullKey >> DEPTH_SHIFT;
+		for (UINT uPass = 0u; uPass < NUM_SORT_PASSES; ++uPass)
+		{
+			++m_aHistograms[uPass * RADIX_SIZE + static_cast<UINT>(ullDigits & (RADIX_SIZE - 1u))];
+			ullDigits >>= RADIX_BITS;
+		}
+
+		return TRUE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RenderQueue::Sort
+
+	  Summary:  Sorts the packets by key. Packets with equal keys keep
+				the order they were pushed in.
+
+	  Modifies: [m_aSortKeys, m_aScratch].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void RenderQueue::Sort()
+	{
+		sortCounted(m_aSortKeys, m_aScratch, m_aHistograms.data(), DEPTH_SHIFT, NUM_SORT_PASSES);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RenderQueue::GetNumPackets
+
+	  Summary:  Returns the number of packets pushed since Reset
+
+	  Returns:  UINT
+				  Number of packets
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT RenderQueue::GetNumPackets() const
+	{
+		return static_cast<UINT>(m_aPackets.size());
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RenderQueue::GetPacket
+
+	  Summary:  Returns a packet in the order of the last Sort
+
+	  Args:     UINT uIndex
+				  Position in the sorted order
+
+	  Returns:  const DrawPacket&
+				  Packet
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const DrawPacket& RenderQueue::GetPacket(_In_ UINT uIndex) const
+	{
+		return m_aPackets[static_cast<size_t>(m_aSortKeys[uIndex] & INDEX_MASK)];
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RenderQueue::GetQueuedPacket
+
+	  Summary:  Returns a packet in the order it was pushed, whether
+				or not the packets were sorted since
+
+	  Args:     UINT uIndex
+				  Position in the push order
+
+	  Returns:  const DrawPacket&
+				  Packet
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const DrawPacket& RenderQueue::GetQueuedPacket(_In_ UINT uIndex) const
+	{
+		return m_aPackets[uIndex];
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RenderQueue::RadixSort
+
+	  Summary:  Stable least significant digit radix sort of 11 bit
+				digits from uFirstBit up. The histograms of every
+				digit are counted in one read, and digits every key
+				shares, like a single pass, are skipped.
+
+	  Args:     std::vector<UINT64>& aKeys
+				  Keys to sort, sorted on return
+				std::vector<UINT64>& aScratch
+				  Scratch memory, resized as needed
+				UINT uFirstBit
+				  Lowest bit that takes part in the order
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void RenderQueue::RadixSort(_Inout_ std::vector<UINT64>& aKeys, _Inout_ std::vector<UINT64>& aScratch, _In_ UINT uFirstBit)
+	{
+		if (aKeys.size() < 2u || uFirstBit >= 64u)
+		{
+			return;
+		}
+
+		const UINT uNumPasses = (64u - uFirstBit + RADIX_BITS - 1u) / RADIX_BITS;
+
+		std::vector<UINT> aHistograms(static_cast<size_t>(MAX_NUM_RADIX_PASSES) * RADIX_SIZE, 0u);
+		for (const UINT64 ullKey : aKeys)
+		{
+			UINT64 ullDigits = ullKey >> uFirstBit;
+			for (UINT uPass = 0u; uPass < uNumPasses; ++uPass)
+			{
+				++aHistograms[uPass * RADIX_SIZE + static_cast<UINT>(ullDigits & (RADIX_SIZE - 1u))];
+				ullDigits >>= RADIX_BITS;
+			}
+		}
+
+		sortCounted(aKeys, aScratch, aHistograms.data(), uFirstBit, uNumPasses);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RenderQueue::sortCounted
+
+	  Summary:  Moves the keys digit by digit given the counts of
+				every digit. Digits every key shares are skipped.
+				After an odd number of moves the keys and the scratch
+				memory trade places instead of being copied back.
+
+	  Args:     std::vector<UINT64>& aKeys
+				  Keys to sort, sorted on return
+				std::vector<UINT64>& aScratch
+				  Scratch memory, resized as needed
+				const UINT* aHistograms
+				  Counts of the 11 bit digits of each pass, one after
+				  the other
+				UINT uFirstBit
+				  Lowest bit that takes part in the order
+				UINT uNumPasses
+				  Number of digits from uFirstBit
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void RenderQueue::sortCounted(
+		_Inout_ std::vector<UINT64>& aKeys,
+		_Inout_ std::vector<UINT64>& aScratch,
+		_In_ const UINT* aHistograms,
+		_In_ UINT uFirstBit,
+		_In_ UINT uNumPasses
+	)
+	{
+		const size_t uNumKeys = aKeys.size();
+		if (uNumKeys < 2u)
+		{
+			return;
+		}
+
+		aScratch.resize(uNumKeys);
+		UINT64* pSource = aKeys.data();
+		UINT64* pDestination = aScratch.data();
+
+		for (UINT uPass = 0u; uPass < uNumPasses; ++uPass)
+		{
+			const UINT* aHistogram = &aHistograms[uPass * RADIX_SIZE];
+			const UINT uShift = uFirstBit + uPass * RADIX_BITS;
+
+			if (aHistogram[(pSource[0] >> uShift) & (RADIX_SIZE - 1u)] == uNumKeys)
+			{
+				continue;
+			}
+
+			UINT aOffsets[RADIX_SIZE];
+			UINT uOffset = 0u;
+			for (UINT uDigit = 0u; uDigit < RADIX_SIZE; ++uDigit)
+			{
+				aOffsets[uDigit] = uOffset;
+				uOffset += aHistogram[uDigit];
+			}
+
+			for (size_t i = 0u; i < uNumKeys; ++i)
+			{
+				pDestination[aOffsets[(pSource[i] >> uShift) & (RADIX_SIZE - 1u)]++] = pSource[i];
+			}
+
+			std::swap(pSource, pDestination);
+		}
+
+		if (pSource != aKeys.data())
+		{
+			aKeys.swap(aScratch);
+		}
+	}
+}
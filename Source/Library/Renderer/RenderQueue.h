@@ -0,0 +1,156 @@
+/*+===================================================================
+  File:      RENDERQUEUE.H
+
+  Summary:   RenderQueue header file contains declarations of
+			 DrawPacket struct and RenderQueue class that sorts the
+			 draws of a frame by their state before they are issued.
+
+  Classes: RenderQueue
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/Renderable.h"
+
+namespace library
+{
+	/*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+		Enum:     eRenderPass
+
+		Summary:  Enumeration of the passes of a frame, drawn in order
+	E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+	enum class eRenderPass : UINT
+	{
+		OPAQUE_PASS = 0,
+		SKY_PASS,
+		COUNT,
+	};
+
+	/*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+		Enum:     eDrawPacketType
+
+		Summary:  Enumeration of the kinds of renderables a draw packet
+				  can come from, each bound differently
+	E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+	enum class eDrawPacketType : UINT
+	{
+		RENDERABLE = 0,
+		VOXEL,
+		MODEL,
+		SKYBOX,
+		COUNT,
+	};
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   DrawPacket
+
+		Summary:  One mesh of a renderable to draw. Voxel packets also
+				  name their visible instance ranges in the ranges of
+				  the frame. The first constants locate the constants
+				  of the renderable in the constant ring, and are
+				  ConstantRing::NO_OFFSET when the constants are in
+				  the constant buffers of the renderable.
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct DrawPacket
+	{
+		Renderable* pRenderable;
+		UINT uMeshIndex;
+		UINT uFirstRange;
+		UINT uNumRanges;
+		UINT uFirstConstant;
+		UINT uFirstSkinningConstant;
+		eDrawPacketType Type;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    RenderQueue
+
+	  Summary:  Collects the draw packets of a frame with 64 bit sort
+				keys and radix sorts them. From the most significant
+				bit, a key holds the pass, the vertex and pixel
+				shader, the material and the view depth, so draws
+				sharing shaders and textures end up next to each other
+				and opaque draws go front to back within them.
+
+				Key bits: 63-62 pass, 61-57 vertex shader, 56-52
+				pixel shader, 51-42 material, 41-31 depth, 30-0
+				unused. The queue packs the packet index in the low
+				bits, so an item is 8 bytes, and sorts the top 33 bits
+				in three 11 bit passes whose digits Push counts.
+
+	  Methods:  MakeKey
+				  Packs a sort key
+				GetStateId
+				  Returns a small id for a shader or material
+				Reset
+				  Removes every packet
+				Push
+				  Adds a packet
+				Sort
+				  Sorts the packets by key
+				GetNumPackets
+				  Returns the number of packets
+				GetPacket
+				  Returns a packet in sorted order
+				GetQueuedPacket
+				  Returns a packet in the order it was pushed
+				RadixSort
+				  Sorts keys by their upper bits
+				RenderQueue
+				  Constructor.
+				~RenderQueue
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class RenderQueue final
+	{
+	public:
+		static constexpr UINT INDEX_BITS = 20u;
+		static constexpr UINT MAX_NUM_PACKETS = 1u << INDEX_BITS;
+
+	public:
+		RenderQueue();
+		RenderQueue(const RenderQueue& other) = delete;
+		RenderQueue(RenderQueue&& other) = delete;
+		RenderQueue& operator=(const RenderQueue& other) = delete;
+		RenderQueue& operator=(RenderQueue&& other) = delete;
+		~RenderQueue() = default;
+
+		static UINT64 MakeKey(
+			_In_ eRenderPass pass,
+			_In_ UINT uVertexShaderId,
+			_In_ UINT uPixelShaderId,
+			_In_ UINT uMaterialId,
+			_In_ FLOAT depth
+		);
+		UINT GetStateId(_In_opt_ const void* pState);
+
+		void Reset();
+		BOOL Push(_In_ UINT64 ullKey, _In_ const DrawPacket& packet);
+		void Sort();
+
+		UINT GetNumPackets() const;
+		const DrawPacket& GetPacket(_In_ UINT uIndex) const;
+		const DrawPacket& GetQueuedPacket(_In_ UINT uIndex) const;
+
+		static void RadixSort(_Inout_ std::vector<UINT64>& aKeys, _Inout_ std::vector<UINT64>& aScratch, _In_ UINT uFirstBit);
+
+	private:
+		static void sortCounted(
+			_Inout_ std::vector<UINT64>& aKeys,
+			_Inout_ std::vector<UINT64>& aScratch,
+			_In_ const UINT* aHistograms,
+			_In_ UINT uFirstBit,
+			_In_ UINT uNumPasses
+		);
+
+	private:
+		std::vector<DrawPacket> m_aPackets;
+		std::vector<UINT64> m_aSortKeys;
+		std::vector<UINT64> m_aScratch;
+		std::vector<UINT> m_aHistograms;
+		std::unordered_map<const void*, UINT> m_stateIds;
+	};
+}
@@ -1,5 +1,7 @@
 #include "Renderer/Renderable.h"
 
+#include <algorithm>
+
 #include "assimp/Importer.hpp"	// C++ importer interface
 #include "assimp/scene.h"		// output data structure
 #include "assimp/postprocess.h"	// post processing flags
@@ -17,7 +19,7 @@ namespace library
 	  Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer,
 				 m_normalBuffer, m_aMeshes, m_aMaterials, m_vertexShader,
 				 m_pixelShader, m_outputColor, m_world, m_bHasNormalMap
-				 m_aNormalData].
+				 m_aNormalData, m_boundingRadius].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	Renderable::Renderable(_In_ const XMFLOAT4& outputColor) :
 		m_vertexBuffer(),
@@ -30,14 +32,17 @@ namespace library
 		m_outputColor(outputColor),
 		m_padding(),
 		m_world(XMMatrixIdentity()),
-		m_bHasNormalMap()
+		m_bHasNormalMap(),
+		m_boundingRadius(0.0f)
 	{
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Renderable::initialize
 
-	  Summary:  Initializes the buffers and the world matrix
+	  Summary:  Initializes the buffers and the world matrix, and
+				measures the bounding radius of the vertices and the
+				bounds of each mesh for frustum culling
 
 	  Args:     ID3D11Device* pDevice
 				  The Direct3D device to create the buffers
@@ -47,7 +52,7 @@ namespace library
 				  File name of the texture to usen
 
 	  Modifies: [m_vertexBuffer, m_normalBuffer, m_indexBuffer
-				 m_constantBuffer].
+				 m_constantBuffer, m_boundingRadius, m_aMeshes].
 
 	  Returns:  HRESULT
 				  Status code
@@ -75,6 +80,23 @@ namespace library
 		hr = pDevice->CreateBuffer(&vBufferDesc, &vData, &m_vertexBuffer);
 		if (FAILED(hr)) return hr;
 
+		const SimpleVertex* pVertices = getVertices();
+		FLOAT radiusSq = 0.0f;
+		for (UINT i = 0u; i < GetNumVertices(); ++i)
+		{
+			const XMFLOAT3& position = pVertices[i].Position;
+			radiusSq = std::max<FLOAT>(radiusSq, position.x * position.x + position.y * position.y + position.z * position.z);
+		}
+		m_boundingRadius = sqrtf(radiusSq);
+
+		for (BasicMeshEntry& mesh : m_aMeshes)
+		{
+			if (mesh.uBaseIndex + mesh.uNumIndices <= GetNumIndices())
+			{
+				mesh.Bounds = FrustumCuller::ComputeBounds(&pVertices[0].Position, sizeof(SimpleVertex), GetNumVertices(), getIndices() + mesh.uBaseIndex, mesh.uNumIndices, mesh.uBaseVertex);
+			}
+		}
+
 		if (m_aNormalData.empty())
 		{
 			calculateNormalMapVectors();
@@ -429,6 +451,20 @@ namespace library
 		return m_world;
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderable::GetBoundingRadius
+
+	  Summary:  Returns the radius, in object space, of the sphere
+				around the origin that holds every vertex
+
+	  Returns:  FLOAT
+				  Bounding radius, 0 before initialization
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	FLOAT Renderable::GetBoundingRadius() const
+	{
+		return m_boundingRadius;
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Renderable::GetOutputColor
 
@@ -568,6 +604,34 @@ namespace library
 		m_world *= XMMatrixTranslationFromVector(offset);
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderable::GetVertices
+
+	  Summary:  Returns the vertices the vertex buffer was created
+				from, for drawing without a device
+
+	  Returns:  const SimpleVertex*
+				  GetNumVertices vertices
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const SimpleVertex* Renderable::GetVertices() const
+	{
+		return getVertices();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderable::GetIndices
+
+	  Summary:  Returns the indices the index buffer was created
+				from, for drawing without a device
+
+	  Returns:  const WORD*
+				  GetNumIndices indices
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const WORD* Renderable::GetIndices() const
+	{
+		return getIndices();
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Renderable::GetNumMeshes
 
@@ -605,4 +669,28 @@ namespace library
 	{
 		return m_bHasNormalMap;
 	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderable::HasTwoChannelNormalMap
+
+	  Summary:  Return whether a loaded normal map of the renderable
+				only stores x and y, so shaders rebuild z. One flag
+				covers every mesh: rebuilding z of an RGB normal map
+				only renormalizes it, while sampling z of a BC5 one
+				would flatten the surface.
+
+	  Returns:  BOOL
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL Renderable::HasTwoChannelNormalMap() const
+	{
+		for (const std::shared_ptr<Material>& material : m_aMaterials)
+		{
+			if (material && material->pNormal && material->pNormal->IsTwoChannel())
+			{
+				return TRUE;
+			}
+		}
+
+		return FALSE;
+	}
 }
@@ -14,6 +14,7 @@
 #include "Common.h"
 
 #include "Renderer/DataTypes.h"
+#include "Renderer/FrustumCuller.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
 #include "Texture/Material.h"
@@ -39,12 +40,18 @@ namespace library
 				  Returns the constant buffer
 				GetWorldMatrix
 				  Returns the world matrix
+				GetBoundingRadius
+				  Returns the radius of the vertices around the origin
 				GetNumVertices
 				  Pure virtual function that returns the number of
 				  vertices
 				GetNumIndices
 				  Pure virtual function that returns the number of
 				  indices
+				GetVertices
+				  Returns the vertices kept in system memory
+				GetIndices
+				  Returns the indices kept in system memory
 				Renderable
 				  Constructor.
 				~Renderable
@@ -63,6 +70,7 @@ namespace library
 				, uBaseVertex(0u)
 				, uBaseIndex(0u)
 				, uMaterialIndex(INVALID_MATERIAL)
+				, Bounds{ .Center = XMFLOAT3(0.0f, 0.0f, 0.0f), .Extents = XMFLOAT3(0.0f, 0.0f, 0.0f), .Radius = -1.0f }
 			{
 			}
 
@@ -70,6 +78,7 @@ namespace library
 			UINT uBaseVertex;
 			UINT uBaseIndex;
 			UINT uMaterialIndex;
+			MeshBounds Bounds;
 		};
 
 	public:
@@ -98,6 +107,7 @@ namespace library
 		ComPtr<ID3D11Buffer>& GetNormalBuffer();
 
 		const XMMATRIX& GetWorldMatrix() const;
+		FLOAT GetBoundingRadius() const;
 		const XMFLOAT4& GetOutputColor() const;
 		BOOL HasTexture() const;
 		const std::shared_ptr<Material>& GetMaterial(UINT uIndex) const;
@@ -113,9 +123,12 @@ namespace library
 		virtual UINT GetNumVertices() const = 0;
 		virtual UINT GetNumIndices() const = 0;
 
+		const SimpleVertex* GetVertices() const;
+		const WORD* GetIndices() const;
 		UINT GetNumMeshes() const;
 		UINT GetNumMaterials() const;
 		BOOL HasNormalMap() const;
+		BOOL HasTwoChannelNormalMap() const;
 
 	protected:
 		const virtual SimpleVertex* getVertices() const = 0;
@@ -145,5 +158,6 @@ namespace library
 		BYTE m_padding[8];
 		XMMATRIX m_world;
 		BOOL m_bHasNormalMap;
+		FLOAT m_boundingRadius;
 	};
 }
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "Renderer/Renderer.h"
 
+#include <algorithm>
+#include <atomic>
+
 namespace library
 {
 
@@ -9,12 +12,27 @@ namespace library
 	  Summary:  Constructor
 
 	  Modifies: [m_driverType, m_featureLevel, m_d3dDevice, m_d3dDevice1,
-				  m_immediateContext, m_immediateContext1, m_swapChain,
-				  m_swapChain1, m_renderTargetView, m_depthStencil,
-				  m_depthStencilView, m_cbChangeOnResize, m_cbShadowMatrix,
+				  m_immediateContext, m_immediateContext1, m_renderDevice,
+				  m_renderContext, m_stateCache, m_unsortedContext,
+				  m_unsortedCache, m_constantRing,
+				  m_bonePalette, m_deferredBackend,
+				  m_commandRecorder, m_swapChain, m_swapChain1,
+				  m_renderTargetView, m_depthStencil, m_depthStencilView,
+				  m_viewport, m_cbChangeOnResize, m_cbShadowMatrix,
 				  m_pszMainSceneName, m_camera, m_projection, m_scenes
 				  m_invalidTexture, m_shadowMapTexture, m_shadowVertexShader,
-				  m_shadowPixelShader].
+				  m_shadowPixelShader, m_frustumCuller, m_lightFrustum,
+				  m_aQueriedProxies, m_horizonCuller, m_occlusionCuller,
+				  m_aTerrainHulls, m_aInstanceRanges,
+				  m_aVisibleRanges, m_renderQueue, m_aShadowDraws,
+				  m_bParallelSubmission,
+				  m_bOcclusionCulling, m_bCpuSkinning, m_uNumDrawnMeshes,
+				  m_uNumCulledMeshes, m_uNumOccludedMeshes,
+				  m_uNumUnsortedBinds, m_uNumStateBinds,
+				  m_uNumSavedBinds, m_uNumDeferredFilteredBinds,
+				  m_modelsLoaded,
+				  m_initializeStart, m_bFirstFrameReported,
+				  m_bModelsLoadedReported, m_uNumFramesSinceReport].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	Renderer::Renderer()
 		: m_driverType(D3D_DRIVER_TYPE_NULL)
@@ -23,21 +41,56 @@ namespace library
 		, m_d3dDevice1()
 		, m_immediateContext()
 		, m_immediateContext1()
+		, m_renderDevice()
+		, m_renderContext()
+		, m_stateCache()
+		, m_unsortedContext()
+		, m_unsortedCache()
+		, m_constantRing()
+		, m_bonePalette()
+		, m_deferredBackend()
+		, m_commandRecorder()
 		, m_swapChain()
 		, m_swapChain1()
 		, m_renderTargetView()
 		, m_depthStencil()
 		, m_depthStencilView()
+		, m_viewport()
 		, m_cbChangeOnResize()
 		, m_pszMainSceneName(nullptr)
 		, m_padding{ '\0' }
 		, m_camera(XMVectorSet(0.0f, 3.0f, -6.0f, 0.0f))
 		, m_projection()
 		, m_scenes()
-		, m_invalidTexture(std::make_shared<Texture>(L"Content/Common/InvalidTexture.png"))
+		, m_invalidTexture(TextureCache::GetInstance().GetOrCreate(L"Content/Common/InvalidTexture.png"))
 		, m_shadowMapTexture()
 		, m_shadowVertexShader()
 		, m_shadowPixelShader()
+		, m_frustumCuller()
+		, m_lightFrustum()
+		, m_aQueriedProxies()
+		, m_horizonCuller()
+		, m_occlusionCuller()
+		, m_aTerrainHulls()
+		, m_aInstanceRanges()
+		, m_aVisibleRanges()
+		, m_renderQueue()
+		, m_aShadowDraws()
+		, m_bParallelSubmission(FALSE)
+		, m_bOcclusionCulling(TRUE)
+		, m_bCpuSkinning(TRUE)
+		, m_uNumDrawnMeshes(0u)
+		, m_uNumCulledMeshes(0u)
+		, m_uNumOccludedMeshes(0u)
+		, m_uNumUnsortedBinds(0u)
+		, m_uNumStateBinds(0u)
+		, m_uNumSavedBinds(0u)
+		, m_uNumDeferredFilteredBinds(0u)
+		, m_modelsLoaded()
+		, m_initializeStart()
+		, m_bFirstFrameReported(FALSE)
+		, m_bModelsLoadedReported(FALSE)
+		, m_uNumFramesSinceReport(0u)
 	{
 	}
 
@@ -51,10 +104,14 @@ namespace library
 				  Handle to the window
 
 	  Modifies: [m_d3dDevice, m_featureLevel, m_immediateContext,
-				  m_d3dDevice1, m_immediateContext1, m_swapChain1,
+				  m_d3dDevice1, m_immediateContext1, m_renderDevice,
+				  m_renderContext, m_swapChain1,
 				  m_swapChain, m_renderTargetView, m_vertexShader,
 				  m_vertexLayout, m_pixelShader, m_vertexBuffer
-				  m_cbShadowMatrix].
+				  m_cbShadowMatrix, m_stateCache, m_unsortedCache,
+				  m_constantRing,
+				  m_deferredBackend, m_commandRecorder, m_viewport,
+				  m_horizonCuller, m_occlusionCuller, m_aTerrainHulls].
 
 	  Returns:  HRESULT
 				  Status code
@@ -113,6 +170,10 @@ namespace library
 			return hr;
 		}
 
+		// Frames are recorded through the render device interface
+		m_renderDevice.Initialize(m_d3dDevice.Get());
+		m_renderContext.Initialize(m_immediateContext.Get());
+
 		// Obtain DXGI factory from device (since we used nullptr for pAdapter above)
 		ComPtr<IDXGIFactory1> dxgiFactory;
 		{
@@ -233,10 +294,27 @@ namespace library
 			return hr;
 		}
 
-		m_immediateContext->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
+		m_renderContext.OMSetRenderTargets(1, ToGpu(m_renderTargetView.GetAddressOf()), ToGpu(m_depthStencilView.Get()));
+
+		// Per frame binds go through the state cache
+		m_stateCache.SetContext(&m_renderContext);
+
+		// The unsorted draws are only counted, never executed
+		m_unsortedCache.SetContext(&m_unsortedContext);
+
+		// Per draw constants go through the constant ring on 11.1 devices
+		hr = m_constantRing.Initialize(m_d3dDevice.Get(), m_immediateContext1.Get());
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		// Draws may also be recorded on worker threads into deferred contexts
+		m_deferredBackend.Initialize(&m_renderDevice, &m_renderContext);
+		m_commandRecorder.SetBackend(&m_deferredBackend);
 
 		// Setup the viewport
-		D3D11_VIEWPORT vp =
+		m_viewport =
 		{
 			.TopLeftX = 0.0f,
 			.TopLeftY = 0.0f,
@@ -245,10 +323,10 @@ namespace library
 			.MinDepth = 0.0f,
 			.MaxDepth = 1.0f,
 		};
-		m_immediateContext->RSSetViewports(1, &vp);
+		m_renderContext.RSSetViewports(1, &m_viewport);
 
 		// Set primitive topology
-		m_immediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		m_renderContext.IASetPrimitiveTopology(ePrimitiveTopology::TRIANGLE_LIST);
 
 		// Projection Constant Buffer
 		D3D11_BUFFER_DESC bd =
@@ -268,15 +346,15 @@ namespace library
 			XM_PIDIV4,
 			static_cast<FLOAT>(uWidth) / static_cast<FLOAT>(uHeight),
 			0.01f,
-			1000.0f
+			FAR_DISTANCE
 		);
 
 		CBChangeOnResize cbChangesOnResize =
 		{
 			.Projection = XMMatrixTranspose(m_projection)
 		};
-		m_immediateContext->UpdateSubresource(m_cbChangeOnResize.Get(), 0, nullptr, &cbChangesOnResize, 0, 0);
-		m_immediateContext->VSSetConstantBuffers(1, 1, m_cbChangeOnResize.GetAddressOf());
+		m_renderContext.UpdateSubresource(ToGpu(m_cbChangeOnResize.Get()), 0, nullptr, &cbChangesOnResize, 0, 0);
+		m_renderContext.VSSetConstantBuffers(1, 1, ToGpu(m_cbChangeOnResize.GetAddressOf()));
 
 		// Light Constant Buffer
 		bd.ByteWidth = sizeof(CBLights);
@@ -290,8 +368,8 @@ namespace library
 			return hr;
 		}
 
-		m_immediateContext->VSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
-		m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
+		m_renderContext.VSSetConstantBuffers(3, 1, ToGpu(m_cbLights.GetAddressOf()));
+		m_renderContext.PSSetConstantBuffers(3, 1, ToGpu(m_cbLights.GetAddressOf()));
 
 		// Shadow Constant Buffer
 		bd.ByteWidth = sizeof(CBShadowMatrix);
@@ -322,12 +400,38 @@ namespace library
 
 		const auto& mainScene = m_scenes[m_pszMainSceneName];
 
-		hr = mainScene->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
+		// Models keep loading on the job system while the first frames are drawn
+		m_initializeStart = std::chrono::high_resolution_clock::now();
+		hr = mainScene->InitializeAsync(m_d3dDevice.Get(), m_immediateContext.Get(), m_modelsLoaded);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		// Voxels do not move, their columns give the horizon and their cells are merged into occluders once
+		m_horizonCuller.SetHeightField(mainScene->GetHeightField());
+
+		hr = m_occlusionCuller.Initialize(OcclusionCuller::DEFAULT_WIDTH, OcclusionCuller::DEFAULT_HEIGHT);
 		if (FAILED(hr))
 		{
 			return hr;
 		}
 
+		std::vector<MeshBounds> aCells;
+		for (const auto& vox : mainScene->GetVoxels())
+		{
+			if (vox->GetNumMeshes() == 0u)
+			{
+				continue;
+			}
+
+			for (const InstanceData& instance : vox->GetInstanceData())
+			{
+				aCells.push_back(FrustumCuller::TransformBounds(vox->GetMesh(0u).Bounds, instance.Transformation * vox->GetWorldMatrix()));
+			}
+		}
+		OcclusionCuller::BuildTerrainHulls(aCells, OcclusionCuller::DEFAULT_COLUMNS_PER_HULL, m_aTerrainHulls);
+
 		for (UINT i = 0u; i < NUM_LIGHTS; i++)
 		{
 			mainScene->GetPointLight(i)->Initialize(uWidth, uHeight);
@@ -436,6 +540,80 @@ namespace library
 		m_shadowPixelShader = move(pixelShader);
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::SetBonePaletteFormat
+
+	  Summary:  Sets how the bones of skinned models are uploaded,
+				as full matrices, affine 3x4 matrices or dual
+				quaternions, from the next frame on
+
+	  Args:     eBonePaletteFormat eFormat
+				  Format of the bone palette
+
+	  Modifies: [m_bonePalette].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::SetBonePaletteFormat(_In_ eBonePaletteFormat eFormat)
+	{
+		m_bonePalette.SetFormat(eFormat);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::SetParallelSubmission
+
+	  Summary:  Sets whether the shadow and main passes are recorded
+				on the job system workers into deferred contexts and
+				executed as command lists, or drawn on the immediate
+				context. Drivers without command list support still
+				work, the runtime then records them itself.
+
+	  Args:     BOOL bParallelSubmission
+				  Whether draws are recorded on worker threads
+
+	  Modifies: [m_bParallelSubmission].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::SetParallelSubmission(_In_ BOOL bParallelSubmission)
+	{
+		m_bParallelSubmission = bParallelSubmission;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::SetOcclusionCulling
+
+	  Summary:  Sets whether meshes that passed frustum culling are
+				also tested against the horizon of the terrain
+				columns, then against the terrain and the large
+				renderables drawn into a small depth buffer on the
+				CPU, and skipped when hidden behind them
+
+	  Args:     BOOL bOcclusionCulling
+				  Whether hidden meshes are culled
+
+	  Modifies: [m_bOcclusionCulling].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::SetOcclusionCulling(_In_ BOOL bOcclusionCulling)
+	{
+		m_bOcclusionCulling = bOcclusionCulling;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::SetCpuSkinning
+
+	  Summary:  Sets whether the models of the main scene are skinned
+				on the CPU, so the shadow pass, which has no bone
+				palette, casts their animated pose. When off, skinned
+				models are skinned in the vertex shader of the main
+				pass and cast their bind pose. On by default.
+
+	  Args:     BOOL bCpuSkinning
+				  Whether skinned models are skinned on the CPU
+
+	  Modifies: [m_bCpuSkinning].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::SetCpuSkinning(_In_ BOOL bCpuSkinning)
+	{
+		m_bCpuSkinning = bCpuSkinning;
+	}
+
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Renderer::HandleInput
@@ -455,13 +633,20 @@ namespace library
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Renderer::Update
 
-	  Summary:  Update the renderables each frame
+	  Summary:  Update the renderables each frame. The skinning
+				option is handed to the models first, so a model loaded
+				during the frame is skinned the same way as the others.
 
 	  Args:     FLOAT deltaTime
 				  Time difference of a frame
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	void Renderer::Update(_In_ FLOAT deltaTime)
 	{
+		for (auto& pair : m_scenes[m_pszMainSceneName]->GetModels())
+		{
+			pair.second->SetCpuSkinning(m_bCpuSkinning);
+		}
+
 		m_scenes[m_pszMainSceneName]->Update(deltaTime);
 
 		m_camera.Update(deltaTime);
@@ -475,14 +660,42 @@ namespace library
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	void Renderer::Render()
 	{
-		RenderSceneToTexture();
+		m_scenes[m_pszMainSceneName]->ProcessDeviceTasks(MAX_NUM_DEVICE_TASKS_PER_FRAME);
+
+		TextureStreamer& textureStreamer = TextureStreamer::GetInstance();
+		if (textureStreamer.IsEnabled())
+		{
+			requestTextureScreenSizes();
+			textureStreamer.Update();
+		}
+
+		// Skinned vertices are uploaded once and shared by the shadow and main passes
+		for (auto& pair : m_scenes[m_pszMainSceneName]->GetModels())
+		{
+			if (!pair.second->IsReady())
+			{
+				continue;
+			}
+
+			pair.second->UploadSkinnedVertices(m_d3dDevice.Get(), m_renderContext);
+		}
 
-		// Clear the backbuffer
-		constexpr float clearColor[4] = { 0.0f, 0.125f, 0.6f, 1.0f }; // RGBA
-		m_immediateContext->ClearRenderTargetView(m_renderTargetView.Get(), clearColor);
+		// Anything may have been bound on the context since last frame
+		m_stateCache.Invalidate();
+		m_stateCache.ResetCounters();
 
-		// Clear the depth buffer to 1.0 (maximum depth)
-		m_immediateContext->ClearDepthStencilView(m_depthStencilView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+		// Every constant of the frame is written before its first draw
+		m_constantRing.BeginFrame();
+
+		// Recorded lists draw the shadow map later, only its constants are written now
+		if (m_bParallelSubmission)
+		{
+			queueShadowDraws();
+		}
+		else
+		{
+			RenderSceneToTexture();
+		}
 
 		// Create camera constant buffer and update
 		XMFLOAT4 camPos;
@@ -492,19 +705,20 @@ namespace library
 			.CameraPosition = camPos,
 		};
 
-		m_immediateContext->UpdateSubresource(
-			m_camera.GetConstantBuffer().Get(),
+		m_renderContext.UpdateSubresource(
+			ToGpu(m_camera.GetConstantBuffer().Get()),
 			0u,
 			nullptr,
 			&cbCamera,
 			0u,
 			0u
 		);
-		m_immediateContext->VSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
-		m_immediateContext->PSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
 
 		const auto& mainScene = m_scenes[m_pszMainSceneName];
 
+		// Bounds are added in the order queueDrawPackets reads them
+		cullMeshes();
+
 		// Create light constant buffer and update
 		CBLights cbLights = { };
 
@@ -528,8 +742,8 @@ namespace library
 			);
 		}
 
-		m_immediateContext->UpdateSubresource(
-			m_cbLights.Get(),
+		m_renderContext.UpdateSubresource(
+			ToGpu(m_cbLights.Get()),
 			0u,
 			nullptr,
 			&cbLights,
@@ -537,557 +751,1331 @@ namespace library
 			0u
 		);
 
-		m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
+		// Every voxel type samples its own slice of the block texture arrays
+		const std::shared_ptr<BlockTextureArray>& blockTextures = mainScene->GetBlockTextures();
+		const BOOL bHasBlockTextures = blockTextures && blockTextures->GetDiffuseView();
 
-		// Shadow texture and sampler state
-		m_immediateContext->PSSetShaderResources(2, 1, m_shadowMapTexture->GetShaderResourceView().GetAddressOf());
-		m_immediateContext->PSSetSamplers(2, 1, m_shadowMapTexture->GetSamplerState().GetAddressOf());
+		// Draws are sorted by pass, shaders, material and depth, so
+		// neighbouring draws skip the state they share
+		queueDrawPackets(bHasBlockTextures);
+		countUnsortedBinds(bHasBlockTextures);
+		m_renderQueue.Sort();
 
-		// Env texture and sampler state
-		const auto& skybox = mainScene->GetSkyBox();
-		if (skybox)
+		if (m_bParallelSubmission)
 		{
-			const auto& material = skybox->GetMaterial(0);
-			const auto& envTexView = material->pDiffuse->GetTextureResourceView();
-			const auto& envSampler = Texture::s_samplers[static_cast<size_t>(material->pDiffuse->GetSamplerType())];
-
-			m_immediateContext->PSSetShaderResources(3, 1, envTexView.GetAddressOf());
-			m_immediateContext->PSSetSamplers(3, 1, envSampler.GetAddressOf());
+			submitParallel(bHasBlockTextures);
 		}
-
-		// For each renderables
-		for (const auto& pair : mainScene->GetRenderables())
+		else
 		{
-			const auto& renderable = pair.second;
+			submitDrawPackets(bHasBlockTextures);
+		}
 
-			// Set the vertex buffer
-			UINT stride = sizeof(SimpleVertex);
-			UINT offset = 0;
+		// Present
+		m_swapChain->Present(0, 0);
 
-			m_immediateContext->IASetVertexBuffers(
-				0,												// the first input slot for binding
-				1,												// the number of buffers in the array
-				renderable->GetVertexBuffer().GetAddressOf(),	// the array of vertex buffers
-				&stride,										// array of stride values, one for each buffer
-				&offset
-			);
+		reportLoadTimes();
+		reportStatistics();
 
-			// Set the normal buffer
-			UINT norStride = sizeof(NormalData);
-			UINT norOffset = 0;
+		// Set Render Target View again (Present call for DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL unbinds backbuffer 0)
+		m_renderContext.OMSetRenderTargets(1, ToGpu(m_renderTargetView.GetAddressOf()), ToGpu(m_depthStencilView.Get()));
 
-			m_immediateContext->IASetVertexBuffers(
-				1, // second slot
-				1,
-				renderable->GetNormalBuffer().GetAddressOf(),
-				&norStride,
-				&norOffset
-			);
+		// Unbind shadow texture so fake render can write to it
+		GpuShaderResourceView* nullSRV[1] = { nullptr };
+		m_stateCache.PSSetShaderResources(2, 1, nullSRV);
 
-			// Set the index buffer
-			m_immediateContext->IASetIndexBuffer(renderable->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+		// Unbind vertex slots so RenderSceneToTexture doesn't complain
+		GpuBuffer* nullVB[3] = { nullptr, nullptr, nullptr };
+		UINT zeros[3] = { 0u, 0u, 0u };
+		m_stateCache.IASetVertexBuffers(
+			0,
+			3,
+			nullVB,
+			zeros,
+			zeros
+		);
+	}
 
-			// Set the input layout
-			m_immediateContext->IASetInputLayout(renderable->GetVertexLayout().Get());
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::RenderSceneToTexture
 
-			// Create and update renderable constant buffer
-			CBChangesEveryFrame cbRenderable = {
-				.World = XMMatrixTranspose(renderable->GetWorldMatrix()),
-				.OutputColor = renderable->GetOutputColor(),
-				.HasNormalMap = renderable->HasNormalMap()
-			};
+	  Summary:  Render scene to the texture
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::RenderSceneToTexture()
+	{
+		queueShadowDraws();
+		recordShadowDraws(m_stateCache, 0u, static_cast<UINT>(m_aShadowDraws.size()));
 
-			m_immediateContext->UpdateSubresource(
-				renderable->GetConstantBuffer().Get(),
-				0u,
-				nullptr,
-				&cbRenderable,
-				0u,
-				0u
-			);
+		// Reset RT back to original back buffer
+		m_renderContext.OMSetRenderTargets(1, ToGpu(m_renderTargetView.GetAddressOf()), ToGpu(m_depthStencilView.Get()));
+	}
 
-			// Set shaders
-			m_immediateContext->VSSetShader(renderable->GetVertexShader().Get(), nullptr, 0);
-			m_immediateContext->PSSetShader(renderable->GetPixelShader().Get(), nullptr, 0);
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::RenderSoftware
 
-			// Set renderable constant buffer
-			m_immediateContext->VSSetConstantBuffers(2, 1, renderable->GetConstantBuffer().GetAddressOf());
-			m_immediateContext->PSSetConstantBuffers(2, 1, renderable->GetConstantBuffer().GetAddressOf());
+	  Summary:  Renders the main scene from the camera into a software
+				rasterizer, cleared to the back buffer clear color, so
+				the frame can be saved or compared without a device.
+				Textures, normal maps, shadows and the skybox are not
+				drawn.
 
-			const UINT numOfMesh = renderable->GetNumMeshes();
-			for (UINT i = 0; i < numOfMesh; i++)
-			{
-				const auto& mesh = renderable->GetMesh(i);
+	  Args:     SoftwareRasterizer& rasterizer
+				  Initialized rasterizer the frame is rendered into
 
-				if (renderable->HasTexture())
-				{
-					const auto& material = renderable->GetMaterial(mesh.uMaterialIndex);
+	  Returns:  HRESULT
+				  Status code, E_FAIL without a main scene
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::RenderSoftware(_Inout_ SoftwareRasterizer& rasterizer)
+	{
+		if (!m_scenes.contains(m_pszMainSceneName))
+		{
+			return E_FAIL;
+		}
 
-					const auto& diffuseView = material->pDiffuse->GetTextureResourceView();
-					const auto& diffuseSampler = Texture::s_samplers[static_cast<size_t>(material->pDiffuse->GetSamplerType())];
+		rasterizer.SetCamera(m_camera.GetView(), m_projection, m_camera.GetEye());
+		rasterizer.Reset();
+		rasterizer.AddScene(*m_scenes[m_pszMainSceneName]);
+		rasterizer.Clear(XMFLOAT4(0.0f, 0.125f, 0.6f, 1.0f));
 
-					m_immediateContext->PSSetShaderResources(0, 1, diffuseView.GetAddressOf());
-					m_immediateContext->PSSetSamplers(0, 1, diffuseSampler.GetAddressOf());
+		return rasterizer.Render();
+	}
 
-					if (renderable->HasNormalMap())
-					{
-						const auto& normalView = material->pNormal->GetTextureResourceView();
-						const auto& normalSampler = Texture::s_samplers[static_cast<size_t>(material->pNormal->GetSamplerType())];
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetDriverType
 
-						m_immediateContext->PSSetShaderResources(1, 1, normalView.GetAddressOf());
-						m_immediateContext->PSSetSamplers(1, 1, normalSampler.GetAddressOf());
-					}
-				}
+	  Summary:  Returns the Direct3D driver type
 
-				m_immediateContext->DrawIndexed(mesh.uNumIndices, mesh.uBaseIndex, static_cast<INT>(mesh.uBaseVertex));
-			}
-		}
+	  Returns:  D3D_DRIVER_TYPE
+				  The Direct3D driver type used
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	D3D_DRIVER_TYPE Renderer::GetDriverType() const
+	{
+		return m_driverType;
+	}
 
-		for (auto& vox : mainScene->GetVoxels())
-		{
-			// Set the vertex buffer
-			UINT vtxStride = sizeof(SimpleVertex);
-			UINT vtxOffset = 0;
-
-			m_immediateContext->IASetVertexBuffers(
-				0,										// the first input slot
-				1,										// the number of buffers
-				vox->GetVertexBuffer().GetAddressOf(),
-				&vtxStride,								// array of stride values, one for each buffer
-				&vtxOffset
-			);
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumDrawnMeshes
 
-			// Set the normal buffer
-			UINT norStride = sizeof(NormalData);
-			UINT norOffset = 0;
+	  Summary:  Returns the meshes of renderables and models, and the
+				voxel chunks, that passed frustum culling last frame
 
-			m_immediateContext->IASetVertexBuffers(
-				1, // second slot
-				1,
-				vox->GetNormalBuffer().GetAddressOf(),
-				&norStride,
-				&norOffset
-			);
+	  Returns:  UINT
+				  Number of drawn meshes
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumDrawnMeshes() const
+	{
+		return m_uNumDrawnMeshes;
+	}
 
-			// Set the instance buffer
-			UINT insStride = sizeof(InstanceData);
-			UINT insOffset = 0;
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumCulledMeshes
 
-			m_immediateContext->IASetVertexBuffers(
-				2, // third slot
-				1,
-				vox->GetInstanceBuffer().GetAddressOf(),
-				&insStride,
-				&insOffset
-			);
+	  Summary:  Returns the meshes of renderables and models, and the
+				voxel chunks, skipped by frustum culling last frame
 
-			// Set the index buffer
-			m_immediateContext->IASetIndexBuffer(vox->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+	  Returns:  UINT
+				  Number of culled meshes
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumCulledMeshes() const
+	{
+		return m_uNumCulledMeshes;
+	}
 
-			// Set the input layout
-			m_immediateContext->IASetInputLayout(vox->GetVertexLayout().Get());
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumOccludedMeshes
 
-			// Create and update voxel constant buffer
-			CBChangesEveryFrame cbVoxel = {
-				.World = XMMatrixTranspose(vox->GetWorldMatrix()),
-				.OutputColor = vox->GetOutputColor(),
-				.HasNormalMap = vox->HasNormalMap()
-			};
+	  Summary:  Returns the meshes and voxel chunks inside of the
+				frustum that the horizon of the terrain or the
+				occluders hid last frame, counted among the culled
+				meshes
 
-			m_immediateContext->UpdateSubresource(
-				vox->GetConstantBuffer().Get(),
-				0u,
-				nullptr,
-				&cbVoxel,
-				0u,
-				0u
-			);
+	  Returns:  UINT
+				  Number of occluded meshes
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumOccludedMeshes() const
+	{
+		return m_uNumOccludedMeshes;
+	}
 
-			// Set shaders
-			m_immediateContext->VSSetShader(vox->GetVertexShader().Get(), nullptr, 0);
-			m_immediateContext->PSSetShader(vox->GetPixelShader().Get(), nullptr, 0);
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumStateBinds
+
+	  Summary:  Returns the buffer, shader, texture and sampler binds
+				the sorted draws of last frame issued
+
+	  Returns:  UINT
+				  Number of state binds
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumStateBinds() const
+	{
+		return m_uNumStateBinds;
+	}
 
-			// Set constant buffer
-			m_immediateContext->VSSetConstantBuffers(2, 1, vox->GetConstantBuffer().GetAddressOf());
-			m_immediateContext->PSSetConstantBuffers(2, 1, vox->GetConstantBuffer().GetAddressOf());
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumSavedBinds
 
+	  Summary:  Returns how many fewer binds last frame issued than
+				drawing the same packets in the order they were
+				queued, through the same state cache, would have
 
-			const UINT numOfMesh = vox->GetNumMeshes();
-			for (UINT i = 0; i < numOfMesh; i++)
-			{
-				const auto& mesh = vox->GetMesh(i);
+	  Returns:  UINT
+				  Number of saved state binds
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumSavedBinds() const
+	{
+		return m_uNumSavedBinds;
+	}
 
-				if (vox->HasTexture())
-				{
-					const auto& material = vox->GetMaterial(mesh.uMaterialIndex);
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumFilteredBinds
 
-					const auto& diffuseView = material->pDiffuse->GetTextureResourceView();
-					const auto& diffuseSampler = Texture::s_samplers[static_cast<size_t>(material->pDiffuse->GetSamplerType())];
+	  Summary:  Returns the binds of last frame the state caches of
+				the immediate and deferred contexts dropped because
+				they would not change what is bound
 
-					m_immediateContext->PSSetShaderResources(0, 1, diffuseView.GetAddressOf());
-					m_immediateContext->PSSetSamplers(0, 1, diffuseSampler.GetAddressOf());
+	  Returns:  UINT
+				  Number of filtered binds
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumFilteredBinds() const
+	{
+		return m_stateCache.GetNumFilteredCalls() + m_uNumDeferredFilteredBinds;
+	}
 
-					if (vox->HasNormalMap())
-					{
-						const auto& normalView = material->pNormal->GetTextureResourceView();
-						const auto& normalSampler = Texture::s_samplers[static_cast<size_t>(material->pNormal->GetSamplerType())];
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumUploadedBoneBytes
 
-						m_immediateContext->PSSetShaderResources(1, 1, normalView.GetAddressOf());
-						m_immediateContext->PSSetSamplers(1, 1, normalSampler.GetAddressOf());
-					}
-				}
+	  Summary:  Returns the bytes of bone transforms last frame
+				uploaded into the bone palette
 
-				m_immediateContext->DrawIndexedInstanced(
-					mesh.uNumIndices,
-					vox->GetNumInstances(),
-					mesh.uBaseIndex,
-					static_cast<INT>(mesh.uBaseVertex),
-					0
-				);
-			}
-		}
+	  Returns:  UINT
+				  Number of uploaded bytes
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumUploadedBoneBytes() const
+	{
+		return m_bonePalette.GetNumUploadedBytes();
+	}
 
-		for (auto& pair : mainScene->GetModels())
-		{
-			auto& model = pair.second;
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumFixedPaletteBytes
 
-			// Set the vertex buffer
+	  Summary:  Returns the bytes of bone transforms last frame would
+				have uploaded with a full 256 bone constant buffer per
+				skinned model
 
-			// First slot
-			UINT stride0 = sizeof(SimpleVertex);
-			UINT offset0 = 0;
-			m_immediateContext->IASetVertexBuffers(
-				0,
-				1,
-				model->GetVertexBuffer().GetAddressOf(),
-				&stride0,
-				&offset0
-			);
+	  Returns:  UINT
+				  Number of bytes
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumFixedPaletteBytes() const
+	{
+		return m_bonePalette.GetNumFixedPaletteBytes();
+	}
 
-			// Second slot
-			UINT stride1 = sizeof(NormalData);
-			UINT offset1 = 0;
-			m_immediateContext->IASetVertexBuffers(
-				1,
-				1,
-				model->GetNormalBuffer().GetAddressOf(),
-				&stride1,
-				&offset1
-			);
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetNumCommandLists
 
-			// Third slot
-			UINT stride2 = sizeof(AnimationData);
-			UINT offset2 = 0;
-			m_immediateContext->IASetVertexBuffers(
-				2,
-				1,
-				model->GetAnimationBuffer().GetAddressOf(),
-				&stride2,
-				&offset2
-			);
+	  Summary:  Returns the command lists last frame executed, zero
+				when it drew on the immediate context
 
-			// Set the index buffer
-			m_immediateContext->IASetIndexBuffer(model->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+	  Returns:  UINT
+				  Number of command lists
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetNumCommandLists() const
+	{
+		return m_bParallelSubmission ? m_commandRecorder.GetNumExecutedLists() : 0u;
+	}
 
-			// Set the input layout
-			m_immediateContext->IASetInputLayout(model->GetVertexLayout().Get());
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::reportLoadTimes
 
-			// Create and update renderable constant buffer
-			CBChangesEveryFrame cbRenderable = {
-				.World = XMMatrixTranspose(model->GetWorldMatrix()),
-				.OutputColor = model->GetOutputColor(),
-				.HasNormalMap = model->HasNormalMap()
-			};
+	  Summary:  Logs the time from Initialize to the first presented
+				frame, and to the frame where every model of the main
+				scene became ready
 
-			m_immediateContext->UpdateSubresource(
-				model->GetConstantBuffer().Get(),
-				0u,
-				nullptr,
-				&cbRenderable,
-				0u,
-				0u
-			);
+	  Modifies: [m_bFirstFrameReported, m_bModelsLoadedReported].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::reportLoadTimes()
+	{
+		if (m_bFirstFrameReported && m_bModelsLoadedReported)
+		{
+			return;
+		}
 
-			// Create and update skinning constant buffer
-			CBSkinning cbSkinning = {};
-			auto& transforms = model->GetBoneTransforms();
-			for (UINT i = 0u; i < transforms.size(); i++)
+		FLOAT milliseconds = std::chrono::duration<FLOAT, std::milli>(std::chrono::high_resolution_clock::now() - m_initializeStart).count();
+		WCHAR szMessage[128];
+
+		if (!m_bFirstFrameReported)
+		{
+			UINT uNumReady = 0u;
+			const auto& models = m_scenes[m_pszMainSceneName]->GetModels();
+			for (const auto& pair : models)
 			{
-				cbSkinning.BoneTransforms[i] = transforms[i];
+				uNumReady += pair.second->IsReady() ? 1u : 0u;
 			}
 
-			m_immediateContext->UpdateSubresource(
-				model->GetSkinningConstantBuffer().Get(),
-				0u,
-				nullptr,
-				&cbSkinning,
-				0u,
-				0u
+			swprintf_s(
+				szMessage,
+				L"Renderer: first frame after %.1f ms, %u of %u model(s) ready\n",
+				milliseconds,
+				uNumReady,
+				static_cast<UINT>(models.size())
 			);
+			OutputDebugString(szMessage);
 
-			// Set shaders
-			m_immediateContext->VSSetShader(model->GetVertexShader().Get(), nullptr, 0);
-			m_immediateContext->PSSetShader(model->GetPixelShader().Get(), nullptr, 0);
+			m_bFirstFrameReported = TRUE;
+		}
 
-			// Set renderable constant buffer
-			m_immediateContext->VSSetConstantBuffers(2, 1, model->GetConstantBuffer().GetAddressOf());
-			m_immediateContext->VSSetConstantBuffers(4, 1, model->GetSkinningConstantBuffer().GetAddressOf());
-			m_immediateContext->PSSetConstantBuffers(2, 1, model->GetConstantBuffer().GetAddressOf());
+		if (!m_bModelsLoadedReported && m_modelsLoaded.valid()
+			&& m_modelsLoaded.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			HRESULT hr = m_modelsLoaded.get();
+			swprintf_s(
+				szMessage,
+				L"Renderer: models loaded after %.1f ms, status 0x%08X\n",
+				milliseconds,
+				static_cast<UINT>(hr)
+			);
+			OutputDebugString(szMessage);
 
+			m_bModelsLoadedReported = TRUE;
+		}
+	}
 
-			const UINT numOfMesh = model->GetNumMeshes();
-			for (UINT i = 0; i < numOfMesh; i++)
-			{
-				const auto& mesh = model->GetMesh(i);
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::reportStatistics
 
-				if (model->HasTexture())
-				{
-					const auto& material = model->GetMaterial(mesh.uMaterialIndex);
+	  Summary:  Logs what frustum and occlusion culling, sorting and
+				the bone palette did to the last frame, once every
+				STATISTICS_REPORT_FRAMES frames
 
-					const auto& diffuseView = material->pDiffuse->GetTextureResourceView();
-					const auto& diffuseSampler = Texture::s_samplers[static_cast<size_t>(material->pDiffuse->GetSamplerType())];
+	  Modifies: [m_uNumFramesSinceReport].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::reportStatistics()
+	{
+		if (++m_uNumFramesSinceReport < STATISTICS_REPORT_FRAMES)
+		{
+			return;
+		}
+		m_uNumFramesSinceReport = 0u;
+
+		WCHAR szMessage[256];
+		swprintf_s(
+			szMessage,
+			L"Renderer: %u mesh(es) drawn, %u culled of which %u occluded; %u state bind(s), %u saved by sorting; %.1f KB of bones uploaded, %.1f KB with fixed palettes\n",
+			GetNumDrawnMeshes(),
+			GetNumCulledMeshes(),
+			GetNumOccludedMeshes(),
+			GetNumStateBinds(),
+			GetNumSavedBinds(),
+			static_cast<FLOAT>(GetNumUploadedBoneBytes()) / 1024.0f,
+			static_cast<FLOAT>(GetNumFixedPaletteBytes()) / 1024.0f
+		);
+		OutputDebugString(szMessage);
+	}
 
-					m_immediateContext->PSSetShaderResources(0, 1, diffuseView.GetAddressOf());
-					m_immediateContext->PSSetSamplers(0, 1, diffuseSampler.GetAddressOf());
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::requestTextureScreenSizes
+
+	  Summary:  Tells the texture streamer how many pixels across the
+				textures of each renderable and model cover: the
+				diameter of its bounding sphere projected at the
+				distance of its origin, or the whole screen height
+				once the camera is inside the sphere
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::requestTextureScreenSizes()
+	{
+		D3D11_TEXTURE2D_DESC depthDesc = {};
+		m_depthStencil->GetDesc(&depthDesc);
+
+		// Pixels covered by one unit one unit away from the camera
+		const FLOAT pixelsPerUnit = XMVectorGetY(m_projection.r[1]) * static_cast<FLOAT>(depthDesc.Height) * 0.5f;
 
-					if (model->HasNormalMap())
+		TextureStreamer& textureStreamer = TextureStreamer::GetInstance();
+		auto requestRenderable = [&](const Renderable& renderable)
+		{
+			const XMMATRIX& world = renderable.GetWorldMatrix();
+			FLOAT scale = std::max<FLOAT>(
+				XMVectorGetX(XMVector3Length(world.r[0])),
+				std::max<FLOAT>(XMVectorGetX(XMVector3Length(world.r[1])), XMVectorGetX(XMVector3Length(world.r[2])))
+			);
+			FLOAT radius = renderable.GetBoundingRadius() * scale;
+			FLOAT distance = XMVectorGetX(XMVector3Length(world.r[3] - m_camera.GetEye()));
+			if (radius <= 0.0f)
+			{
+				return;
+			}
+			FLOAT screenSize = std::min<FLOAT>(2.0f * radius * pixelsPerUnit / std::max<FLOAT>(distance, radius), static_cast<FLOAT>(depthDesc.Height));
+
+			for (UINT i = 0u; i < renderable.GetNumMaterials(); ++i)
+			{
+				const std::shared_ptr<Material>& material = renderable.GetMaterial(i);
+				if (!material)
+				{
+					continue;
+				}
+
+				for (const std::shared_ptr<Texture>& texture : { material->pDiffuse, material->pSpecularExponent, material->pNormal })
+				{
+					if (texture)
 					{
-						const auto& normalView = material->pNormal->GetTextureResourceView();
-						const auto& normalSampler = Texture::s_samplers[static_cast<size_t>(material->pNormal->GetSamplerType())];
+						textureStreamer.RequestScreenSize(texture.get(), screenSize);
+					}
+				}
+			}
+		};
+
+		for (const auto& pair : m_scenes[m_pszMainSceneName]->GetRenderables())
+		{
+			requestRenderable(*pair.second);
+		}
+
+		for (const auto& pair : m_scenes[m_pszMainSceneName]->GetModels())
+		{
+			if (pair.second->IsReady())
+			{
+				requestRenderable(*pair.second);
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::queryRenderables
+
+	  Summary:  Collects the renderables and models of the scene tree
+				whose box is inside a frustum, for isOutsideQuery
+
+	  Args:     const Scene& scene
+				  Scene whose renderable tree is queried
+				const XMFLOAT4A* aPlanes
+				  Frustum planes, as given by FrustumCuller::GetPlanes
+
+	  Modifies: [m_aQueriedProxies].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::queryRenderables(_In_ const Scene& scene, _In_reads_(FrustumCuller::NUM_PLANES) const XMFLOAT4A* aPlanes)
+	{
+		m_aQueriedProxies.clear();
+		scene.GetRenderableTree().QueryFrustum(aPlanes, m_aQueriedProxies);
+		std::sort(m_aQueriedProxies.begin(), m_aQueriedProxies.end());
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::isOutsideQuery
+
+	  Summary:  Returns whether the last queryRenderables left out a
+				renderable. Renderables not in the tree yet are never
+				left out.
+
+	  Args:     const Scene& scene
+				  Scene that was queried
+				const Renderable& renderable
+				  Renderable or model of the scene
+
+	  Returns:  BOOL
+				  TRUE if the box of the renderable is outside the
+				  queried frustum
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL Renderer::isOutsideQuery(_In_ const Scene& scene, _In_ const Renderable& renderable) const
+	{
+		const UINT uProxy = scene.GetRenderableProxy(&renderable);
+		return uProxy != AabbTree::NULL_NODE && !std::binary_search(m_aQueriedProxies.begin(), m_aQueriedProxies.end(), uProxy);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::cullMeshes
+
+	  Summary:  Queries the renderable tree of the scene with the
+				camera frustum, so renderables and models outside it
+				are culled whole without touching their meshes, then
+				tests the world space bounds of every mesh of the
+				others, every voxel chunk and every mesh of the ready
+				models against the frustum, in the order
+				queueDrawPackets reads them. Skinned models are always
+				drawn, as their bounds are measured in the bind pose.
+				The meshes that pass are then tested against the
+				horizon of the terrain columns, which is cheap, and
+				those left against the terrain hulls and the large,
+				simple renderable meshes drawn as occluders.
+
+	  Modifies: [m_frustumCuller, m_aQueriedProxies, m_horizonCuller,
+				 m_occlusionCuller, m_uNumDrawnMeshes,
+				 m_uNumCulledMeshes, m_uNumOccludedMeshes].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::cullMeshes()
+	{
+		constexpr MeshBounds UNBOUNDED = { .Center = XMFLOAT3(0.0f, 0.0f, 0.0f), .Extents = XMFLOAT3(0.0f, 0.0f, 0.0f), .Radius = -1.0f };
+
+		m_frustumCuller.SetViewProjection(m_camera.GetView() * m_projection);
+		m_frustumCuller.Reset();
+
+		const auto& mainScene = m_scenes[m_pszMainSceneName];
+		queryRenderables(*mainScene, m_frustumCuller.GetPlanes());
+
+		for (const auto& pair : mainScene->GetRenderables())
+		{
+			const auto& renderable = pair.second;
+			if (isOutsideQuery(*mainScene, *renderable))
+			{
+				m_frustumCuller.AddHidden(renderable->GetNumMeshes());
+				continue;
+			}
+
+			for (UINT i = 0u; i < renderable->GetNumMeshes(); ++i)
+			{
+				m_frustumCuller.AddBounds(renderable->GetMesh(i).Bounds, renderable->GetWorldMatrix());
+			}
+		}
+
+		for (const auto& vox : mainScene->GetVoxels())
+		{
+			for (const InstanceChunk& chunk : vox->GetChunks())
+			{
+				m_frustumCuller.AddBounds(chunk.Bounds, vox->GetWorldMatrix());
+			}
+		}
+
+		for (const auto& pair : mainScene->GetModels())
+		{
+			const auto& model = pair.second;
+			if (!model->IsReady())
+			{
+				continue;
+			}
 
-						m_immediateContext->PSSetShaderResources(1, 1, normalView.GetAddressOf());
-						m_immediateContext->PSSetSamplers(1, 1, normalSampler.GetAddressOf());
+			const BOOL bIsSkinned = !model->GetBoneTransforms().empty();
+			if (!bIsSkinned && isOutsideQuery(*mainScene, *model))
+			{
+				m_frustumCuller.AddHidden(model->GetNumMeshes());
+				continue;
+			}
+
+			for (UINT i = 0u; i < model->GetNumMeshes(); ++i)
+			{
+				m_frustumCuller.AddBounds(bIsSkinned ? UNBOUNDED : model->GetMesh(i).Bounds, model->GetWorldMatrix());
+			}
+		}
+
+		m_uNumDrawnMeshes = m_frustumCuller.Cull();
+		m_uNumOccludedMeshes = 0u;
+
+		if (m_bOcclusionCulling)
+		{
+			m_horizonCuller.SetCamera(m_camera.GetEye(), m_camera.GetView() * m_projection);
+			m_uNumOccludedMeshes = m_horizonCuller.Cull(m_frustumCuller);
+
+			m_occlusionCuller.SetViewProjection(m_camera.GetView() * m_projection);
+			m_occlusionCuller.Reset();
+			for (const MeshBounds& hull : m_aTerrainHulls)
+			{
+				m_occlusionCuller.AddOccluderBox(hull, XMMatrixIdentity());
+			}
+
+			for (const auto& pair : mainScene->GetRenderables())
+			{
+				const auto& renderable = pair.second;
+				if (!renderable->GetVertices() || !renderable->GetIndices())
+				{
+					continue;
+				}
+
+				for (UINT i = 0u; i < renderable->GetNumMeshes(); ++i)
+				{
+					const auto& mesh = renderable->GetMesh(i);
+					if (mesh.Bounds.Radius >= OCCLUDER_MIN_RADIUS && mesh.uNumIndices <= MAX_OCCLUDER_INDICES)
+					{
+						m_occlusionCuller.AddOccluderMesh(
+							renderable->GetVertices(),
+							renderable->GetNumVertices(),
+							renderable->GetIndices() + mesh.uBaseIndex,
+							mesh.uNumIndices,
+							mesh.uBaseVertex,
+							renderable->GetWorldMatrix()
+						);
 					}
 				}
+			}
 
-				m_immediateContext->DrawIndexed(mesh.uNumIndices, mesh.uBaseIndex, static_cast<INT>(mesh.uBaseVertex));
+			if (SUCCEEDED(m_occlusionCuller.Rasterize()))
+			{
+				m_uNumOccludedMeshes += m_occlusionCuller.Cull(m_frustumCuller);
 			}
+			m_uNumDrawnMeshes -= m_uNumOccludedMeshes;
 		}
 
-		const auto& skyBox = mainScene->GetSkyBox();
-		if (skyBox)
+		m_uNumCulledMeshes = m_frustumCuller.GetNumBounds() - m_uNumDrawnMeshes;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::queueDrawPackets
+
+	  Summary:  Updates the constant buffers of every visible
+				renderable, voxel, model and the skybox, uploads the
+				bones of the visible models into the bone palette, and
+				queues a draw packet for each of their visible meshes
+
+	  Args:     BOOL bHasBlockTextures
+				  Whether voxels sample the block texture arrays
+				  instead of their own materials
+
+	  Modifies: [m_renderQueue, m_aInstanceRanges, m_aVisibleRanges,
+				 m_bonePalette].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::queueDrawPackets(_In_ BOOL bHasBlockTextures)
+	{
+		m_renderQueue.Reset();
+		m_aInstanceRanges.clear();
+		m_bonePalette.Reset();
+
+		const auto& mainScene = m_scenes[m_pszMainSceneName];
+		UINT uBoundsIndex = 0u;
+
+		for (const auto& pair : mainScene->GetRenderables())
 		{
-			// Set the vertex buffer
-			UINT stride = sizeof(SimpleVertex);
-			UINT offset = 0;
+			const auto& renderable = pair.second;
 
-			m_immediateContext->IASetVertexBuffers(
-				0,												// the first input slot for binding
-				1,												// the number of buffers in the array
-				skyBox->GetVertexBuffer().GetAddressOf(),	// the array of vertex buffers
-				&stride,										// array of stride values, one for each buffer
-				&offset
-			);
+			const UINT uFirstBounds = uBoundsIndex;
+			uBoundsIndex += renderable->GetNumMeshes();
+			if (!m_frustumCuller.IsAnyVisible(uFirstBounds, renderable->GetNumMeshes()))
+			{
+				continue;
+			}
 
-			// Set the index buffer
-			m_immediateContext->IASetIndexBuffer(skyBox->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+			// Create and update renderable constant buffer
+			CBChangesEveryFrame cbRenderable = {
+				.World = XMMatrixTranspose(renderable->GetWorldMatrix()),
+				.OutputColor = renderable->GetOutputColor(),
+				.HasNormalMap = renderable->HasNormalMap(),
+				.HasTwoChannelNormalMap = renderable->HasTwoChannelNormalMap()
+			};
+
+			const DrawPacket object = {
+				.pRenderable = renderable.get(),
+				.uFirstConstant = writeConstants(renderable->GetConstantBuffer().Get(), &cbRenderable, sizeof(cbRenderable), sizeof(cbRenderable)),
+				.uFirstSkinningConstant = ConstantRing::NO_OFFSET,
+				.Type = eDrawPacketType::RENDERABLE
+			};
+
+			queueMeshes(object, uFirstBounds, renderable->HasTexture());
+		}
+
+		for (const auto& vox : mainScene->GetVoxels())
+		{
+			// Every chunk of instances was culled on its own, neighbouring
+			// visible chunks are drawn together
+			const UINT uFirstBounds = uBoundsIndex;
+			uBoundsIndex += static_cast<UINT>(vox->GetChunks().size());
+			if (InstanceChunker::GetVisibleRanges(m_frustumCuller, uFirstBounds, vox->GetChunks(), m_aVisibleRanges) == 0u)
+			{
+				continue;
+			}
+
+			const UINT uFirstRange = static_cast<UINT>(m_aInstanceRanges.size());
+			m_aInstanceRanges.insert(m_aInstanceRanges.end(), m_aVisibleRanges.begin(), m_aVisibleRanges.end());
+
+			// Create and update voxel constant buffer
+			CBChangesEveryFrame cbVoxel = {
+				.World = XMMatrixTranspose(vox->GetWorldMatrix()),
+				.OutputColor = vox->GetOutputColor(),
+				.HasNormalMap = vox->HasNormalMap(),
+				.HasTwoChannelNormalMap = vox->HasTwoChannelNormalMap(),
+				.HasBlockTextures = bHasBlockTextures
+			};
+
+			const DrawPacket object = {
+				.pRenderable = vox.get(),
+				.uFirstRange = uFirstRange,
+				.uNumRanges = static_cast<UINT>(m_aVisibleRanges.size()),
+				.uFirstConstant = writeConstants(vox->GetConstantBuffer().Get(), &cbVoxel, sizeof(cbVoxel), sizeof(cbVoxel)),
+				.uFirstSkinningConstant = ConstantRing::NO_OFFSET,
+				.Type = eDrawPacketType::VOXEL
+			};
+
+			queueMeshes(object, NO_BOUNDS, vox->HasTexture() && !bHasBlockTextures);
+		}
+
+		for (const auto& pair : mainScene->GetModels())
+		{
+			const auto& model = pair.second;
+			if (!model->IsReady())
+			{
+				continue;
+			}
+
+			const UINT uFirstBounds = uBoundsIndex;
+			uBoundsIndex += model->GetNumMeshes();
+			if (!m_frustumCuller.IsAnyVisible(uFirstBounds, model->GetNumMeshes()))
+			{
+				continue;
+			}
 
-			// Set the input layout
-			m_immediateContext->IASetInputLayout(skyBox->GetVertexLayout().Get());
+			// Create and update renderable constant buffer
+			CBChangesEveryFrame cbRenderable = {
+				.World = XMMatrixTranspose(model->GetWorldMatrix()),
+				.OutputColor = model->GetOutputColor(),
+				.HasNormalMap = model->HasNormalMap(),
+				.HasTwoChannelNormalMap = model->HasTwoChannelNormalMap()
+			};
 
+			// Only the live bones go into the palette, CPU skinned models get none and stay in their bind pose
+			CBSkinning cbSkinning = {};
+			const auto& transforms = model->GetBoneTransforms();
+			if (!model->IsCpuSkinned() && !transforms.empty())
+			{
+				cbSkinning.NumBones = static_cast<UINT>(transforms.size());
+				cbSkinning.BoneOffset = m_bonePalette.Add(transforms.data(), cbSkinning.NumBones);
+				cbSkinning.BoneFormat = static_cast<UINT>(m_bonePalette.GetFormat());
+			}
+
+			const DrawPacket object = {
+				.pRenderable = model.get(),
+				.uFirstConstant = writeConstants(model->GetConstantBuffer().Get(), &cbRenderable, sizeof(cbRenderable), sizeof(cbRenderable)),
+				.uFirstSkinningConstant = writeConstants(model->GetSkinningConstantBuffer().Get(), &cbSkinning, sizeof(cbSkinning), sizeof(cbSkinning)),
+				.Type = eDrawPacketType::MODEL
+			};
+
+			queueMeshes(object, uFirstBounds, model->HasTexture());
+		}
+
+		const auto& skyBox = mainScene->GetSkyBox();
+		if (skyBox)
+		{
 			// Create and update renderable constant buffer
 			XMMATRIX world = skyBox->GetWorldMatrix();
 			world = world * XMMatrixTranslationFromVector(m_camera.GetEye());
 			CBChangesEveryFrame cbRenderable = {
 				.World = XMMatrixTranspose(world),
 				.OutputColor = skyBox->GetOutputColor(),
-				.HasNormalMap = skyBox->HasNormalMap()
+				.HasNormalMap = skyBox->HasNormalMap(),
+				.HasTwoChannelNormalMap = skyBox->HasTwoChannelNormalMap()
 			};
 
-			m_immediateContext->UpdateSubresource(
-				skyBox->GetConstantBuffer().Get(),
-				0u,
-				nullptr,
-				&cbRenderable,
-				0u,
-				0u
-			);
+			const DrawPacket object = {
+				.pRenderable = skyBox.get(),
+				.uFirstConstant = writeConstants(skyBox->GetConstantBuffer().Get(), &cbRenderable, sizeof(cbRenderable), sizeof(cbRenderable)),
+				.uFirstSkinningConstant = ConstantRing::NO_OFFSET,
+				.Type = eDrawPacketType::SKYBOX
+			};
 
-			// Set shaders
-			m_immediateContext->VSSetShader(skyBox->GetVertexShader().Get(), nullptr, 0);
-			m_immediateContext->PSSetShader(skyBox->GetPixelShader().Get(), nullptr, 0);
+			queueMeshes(object, NO_BOUNDS, skyBox->HasTexture());
+		}
 
-			// Set renderable constant buffer
-			m_immediateContext->VSSetConstantBuffers(2, 1, skyBox->GetConstantBuffer().GetAddressOf());
-			m_immediateContext->PSSetConstantBuffers(2, 1, skyBox->GetConstantBuffer().GetAddressOf());
+		HRESULT hr = m_bonePalette.Upload(m_d3dDevice.Get(), m_renderContext);
+		if (FAILED(hr))
+		{
+			WCHAR szMessage[256];
+			swprintf_s(szMessage, L"Bone palette upload of %u bones failed: 0x%08X\n", m_bonePalette.GetNumBones(), static_cast<UINT>(hr));
+			OutputDebugString(szMessage);
+		}
+	}
 
-			const UINT numOfMesh = skyBox->GetNumMeshes();
-			for (UINT i = 0; i < numOfMesh; i++)
-			{
-				const auto& mesh = skyBox->GetMesh(i);
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::queueMeshes
+
+	  Summary:  Queues a draw packet for each visible mesh of a
+				renderable, keyed by its shaders, material and view
+				depth
+
+	  Args:     const DrawPacket& object
+				  Packet of the renderable, its type, instance ranges
+				  and constants, every mesh is queued as a copy
+				UINT uFirstBounds
+				  Culling bounds of the first mesh, NO_BOUNDS when
+				  every mesh is drawn
+				BOOL bUsesMaterials
+				  Whether the meshes bind their material textures
+
+	  Modifies: [m_renderQueue].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::queueMeshes(_In_ const DrawPacket& object, _In_ UINT uFirstBounds, _In_ BOOL bUsesMaterials)
+	{
+		Renderable& renderable = *object.pRenderable;
+		const eDrawPacketType type = object.Type;
+		const eRenderPass pass = type == eDrawPacketType::SKYBOX ? eRenderPass::SKY_PASS : eRenderPass::OPAQUE_PASS;
 
-				if (skyBox->HasTexture())
-				{
-					const auto& material = skyBox->GetMaterial(mesh.uMaterialIndex);
+		const UINT uVertexShaderId = m_renderQueue.GetStateId(renderable.GetVertexShader().Get());
+		const UINT uPixelShaderId = m_renderQueue.GetStateId(renderable.GetPixelShader().Get());
 
-					const auto& diffuseView = material->pDiffuse->GetTextureResourceView();
-					const auto& diffuseSampler = Texture::s_samplers[static_cast<size_t>(material->pDiffuse->GetSamplerType())];
+		// The skybox is drawn last regardless of its depth
+		FLOAT depth = 0.0f;
+		if (type != eDrawPacketType::SKYBOX)
+		{
+			const XMVECTOR viewPosition = XMVector3Transform(renderable.GetWorldMatrix().r[3], m_camera.GetView());
+			depth = XMVectorGetZ(viewPosition) / FAR_DISTANCE;
+		}
 
-					m_immediateContext->PSSetShaderResources(0, 1, diffuseView.GetAddressOf());
-					m_immediateContext->PSSetSamplers(0, 1, diffuseSampler.GetAddressOf());
-				}
+		for (UINT i = 0u; i < renderable.GetNumMeshes(); ++i)
+		{
+			if (uFirstBounds != NO_BOUNDS && !m_frustumCuller.IsVisible(uFirstBounds + i))
+			{
+				continue;
+			}
 
-				m_immediateContext->DrawIndexed(mesh.uNumIndices, mesh.uBaseIndex, static_cast<INT>(mesh.uBaseVertex));
+			UINT uMaterialId = 0u;
+			if (bUsesMaterials)
+			{
+				uMaterialId = m_renderQueue.GetStateId(renderable.GetMaterial(renderable.GetMesh(i).uMaterialIndex).get());
 			}
+
+			DrawPacket packet = object;
+			packet.uMeshIndex = i;
+
+			m_renderQueue.Push(RenderQueue::MakeKey(pass, uVertexShaderId, uPixelShaderId, uMaterialId, depth), packet);
 		}
+	}
 
-		// Present
-		m_swapChain->Present(0, 0);
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::queueShadowDraws
+
+	  Summary:  Writes the light matrices of every renderable and
+				ready model inside the light frustum into the constant
+				ring and queues their shadow map draws. The renderable
+				tree of the scene is queried with the light frustum,
+				skinned models are always drawn as their boxes are
+				measured in the bind pose. Without the ring all draws
+				share one constant buffer, so their constants are kept
+				to be updated on the recording context instead.
+
+	  Modifies: [m_aShadowDraws, m_lightFrustum, m_aQueriedProxies].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::queueShadowDraws()
+	{
+		m_aShadowDraws.clear();
 
-		// Set Render Target View again (Present call for DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL unbinds backbuffer 0)
-		m_immediateContext->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
+		const auto& scene = m_scenes[m_pszMainSceneName];
+		const auto& light = scene->GetPointLight(0);
 
-		// Unbind shadow texture so fake render can write to it
-		ID3D11ShaderResourceView* nullSRV[1] = { nullptr };
-		m_immediateContext->PSSetShaderResources(2, 1, nullSRV);
+		auto queue = [&](Renderable* pRenderable, ID3D11Buffer* pVertexBuffer)
+		{
+			ShadowDraw& draw = m_aShadowDraws.emplace_back();
+			draw.Constants =
+			{
+				.World = XMMatrixTranspose(pRenderable->GetWorldMatrix()),
+				.View = XMMatrixTranspose(light->GetViewMatrix()),
+				.Projection = XMMatrixTranspose(light->GetProjectionMatrix()),
+				.IsVoxel = false
+			};
+			draw.pRenderable = pRenderable;
+			draw.pVertexBuffer = pVertexBuffer;
+			draw.uFirstConstant = m_constantRing.Write(m_renderContext, &draw.Constants, sizeof(draw.Constants), sizeof(draw.Constants));
+		};
 
-		// Unbind vertex slots so RenderSceneToTexture doesn't complain
-		ID3D11Buffer* nullVB[3] = { nullptr, nullptr, nullptr };
-		UINT zero = 0;
-		m_immediateContext->IASetVertexBuffers(
-			0,
-			3,
-			nullVB,
-			&zero,
-			&zero
-		);
+		m_lightFrustum.SetViewProjection(light->GetViewMatrix() * light->GetProjectionMatrix());
+		queryRenderables(*scene, m_lightFrustum.GetPlanes());
+
+		for (const auto& pair : scene->GetRenderables())
+		{
+			if (!isOutsideQuery(*scene, *pair.second))
+			{
+				queue(pair.second.get(), pair.second->GetVertexBuffer().Get());
+			}
+		}
+
+		for (const auto& pair : scene->GetModels())
+		{
+			const auto& model = pair.second;
+			if (!model->IsReady() || (model->GetBoneTransforms().empty() && isOutsideQuery(*scene, *model)))
+			{
+				continue;
+			}
+
+			// The shadow VS has no palette so skinned models cast their CPU skinned pose
+			queue(model.get(), model->IsCpuSkinned() ? model->GetSkinnedVertexBuffer().Get() : model->GetVertexBuffer().Get());
+		}
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderer::RenderSceneToTexture
+	  Method:   Renderer::bindDrawPacket
 
-	  Summary:  Render scene to the texture
+	  Summary:  Binds the vertex, normal, instance and animation
+				buffers, the index buffer, the input layout and the
+				constant buffers of the renderable of a packet
+
+	  Args:     StateCache& cache
+				  State cache of the context the packet is drawn on
+				const DrawPacket& packet
+				  Packet whose renderable is bound
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	void Renderer::RenderSceneToTexture()
+	void Renderer::bindDrawPacket(_Inout_ StateCache& cache, _In_ const DrawPacket& packet)
 	{
-		m_immediateContext->OMSetRenderTargets(
-			1,
-			m_shadowMapTexture->GetRenderTargetView().GetAddressOf(),
-			m_depthStencilView.Get()
+		Renderable& renderable = *packet.pRenderable;
+
+		// Set the vertex buffer, skinned on the CPU when enabled
+		const BOOL bIsCpuSkinned = packet.Type == eDrawPacketType::MODEL && static_cast<Model&>(renderable).IsCpuSkinned();
+		UINT vtxStride = sizeof(SimpleVertex);
+		UINT vtxOffset = 0;
+
+		cache.IASetVertexBuffers(
+			0,												// the first input slot for binding
+			1,												// the number of buffers in the array
+			ToGpu(bIsCpuSkinned ? static_cast<Model&>(renderable).GetSkinnedVertexBuffer().GetAddressOf() : renderable.GetVertexBuffer().GetAddressOf()),
+			&vtxStride,										// array of stride values, one for each buffer
+			&vtxOffset
 		);
 
-		m_immediateContext->ClearRenderTargetView(m_shadowMapTexture->GetRenderTargetView().Get(), Colors::White);
-		m_immediateContext->ClearDepthStencilView(m_depthStencilView.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
-
-		const auto& scene = m_scenes[m_pszMainSceneName];
-
-		// Set shaders
-		m_immediateContext->VSSetShader(m_shadowVertexShader->GetVertexShader().Get(), nullptr, 0);
-		m_immediateContext->PSSetShader(m_shadowPixelShader->GetPixelShader().Get(), nullptr, 0);
+		// Set the normal buffer, skinned along with the vertices
+		if (packet.Type != eDrawPacketType::SKYBOX)
+		{
+			UINT norStride = sizeof(NormalData);
+			UINT norOffset = 0;
 
-		const auto& light = m_scenes[m_pszMainSceneName]->GetPointLight(0);
+			cache.IASetVertexBuffers(
+				1, // second slot
+				1,
+				ToGpu(bIsCpuSkinned ? static_cast<Model&>(renderable).GetSkinnedNormalBuffer().GetAddressOf() : renderable.GetNormalBuffer().GetAddressOf()),
+				&norStride,
+				&norOffset
+			);
+		}
 
-		for (const auto& pair : scene->GetRenderables())
+		// Set the instance or animation buffer
+		if (packet.Type == eDrawPacketType::VOXEL)
 		{
-			const auto& renderable = pair.second;
+			UINT insStride = sizeof(InstanceData);
+			UINT insOffset = 0;
 
-			// Set the vertex buffer
-			UINT stride = sizeof(SimpleVertex);
-			UINT offset = 0;
+			cache.IASetVertexBuffers(
+				2, // third slot
+				1,
+				ToGpu(static_cast<InstancedRenderable&>(renderable).GetInstanceBuffer().GetAddressOf()),
+				&insStride,
+				&insOffset
+			);
+		}
+		else if (packet.Type == eDrawPacketType::MODEL)
+		{
+			UINT aniStride = sizeof(AnimationData);
+			UINT aniOffset = 0;
 
-			m_immediateContext->IASetVertexBuffers(
-				0,
+			cache.IASetVertexBuffers(
+				2, // third slot
 				1,
-				renderable->GetVertexBuffer().GetAddressOf(),
-				&stride,
-				&offset
+				ToGpu(static_cast<Model&>(renderable).GetAnimationBuffer().GetAddressOf()),
+				&aniStride,
+				&aniOffset
 			);
+		}
 
-			// Set the index buffer
-			m_immediateContext->IASetIndexBuffer(renderable->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+		// Set the index buffer
+		cache.IASetIndexBuffer(ToGpu(renderable.GetIndexBuffer().Get()), DXGI_FORMAT_R16_UINT, 0);
 
-			// Set the input layout
-			m_immediateContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
+		// Set the input layout
+		cache.IASetInputLayout(ToGpu(renderable.GetVertexLayout().Get()));
 
-			// Shadow constant buffer
-			CBShadowMatrix cbShadow = {
-				.World = XMMatrixTranspose(renderable->GetWorldMatrix()),
-				.View = XMMatrixTranspose(light->GetViewMatrix()),
-				.Projection = XMMatrixTranspose(light->GetProjectionMatrix()),
-				.IsVoxel = false
-			};
+		// Set renderable constant buffer
+		bindConstants(cache, 2, renderable.GetConstantBuffer().Get(), packet.uFirstConstant, sizeof(CBChangesEveryFrame), TRUE);
+		if (packet.Type == eDrawPacketType::MODEL)
+		{
+			bindConstants(cache, 4, static_cast<Model&>(renderable).GetSkinningConstantBuffer().Get(), packet.uFirstSkinningConstant, sizeof(CBSkinning), FALSE);
+		}
+	}
 
-			m_immediateContext->UpdateSubresource(
-				m_cbShadowMatrix.Get(),
-				0u,
-				nullptr,
-				&cbShadow,
-				0u,
-				0u
-			);
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::bindMainPassState
+
+	  Summary:  Binds the render target, viewport, camera, lights,
+				shadow map, environment map, block textures and bone
+				palette every packet of the main pass reads. Each
+				context records them, deferred contexts start from
+				the default state.
+
+	  Args:     StateCache& cache
+				  State cache of the context the pass is drawn on
+				BOOL bHasBlockTextures
+				  Whether voxels sample the block texture arrays
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::bindMainPassState(_Inout_ StateCache& cache, _In_ BOOL bHasBlockTextures)
+	{
+		IRenderContext* pContext = cache.GetContext();
+		pContext->OMSetRenderTargets(1, ToGpu(m_renderTargetView.GetAddressOf()), ToGpu(m_depthStencilView.Get()));
+		pContext->RSSetViewports(1, &m_viewport);
+		cache.IASetPrimitiveTopology(ePrimitiveTopology::TRIANGLE_LIST);
+
+		// Camera, projection and light constant buffers
+		cache.VSSetConstantBuffers(0, 1, ToGpu(m_camera.GetConstantBuffer().GetAddressOf()));
+		cache.PSSetConstantBuffers(0, 1, ToGpu(m_camera.GetConstantBuffer().GetAddressOf()));
+		cache.VSSetConstantBuffers(1, 1, ToGpu(m_cbChangeOnResize.GetAddressOf()));
+		cache.VSSetConstantBuffers(3, 1, ToGpu(m_cbLights.GetAddressOf()));
+		cache.PSSetConstantBuffers(3, 1, ToGpu(m_cbLights.GetAddressOf()));
 
-			m_immediateContext->VSSetConstantBuffers(0, 1, m_cbShadowMatrix.GetAddressOf());
+		// Shadow texture and sampler state
+		cache.PSSetShaderResources(2, 1, ToGpu(m_shadowMapTexture->GetShaderResourceView().GetAddressOf()));
+		cache.PSSetSamplers(2, 1, ToGpu(m_shadowMapTexture->GetSamplerState().GetAddressOf()));
 
-			const UINT numOfMesh = renderable->GetNumMeshes();
-			for (UINT i = 0; i < numOfMesh; i++)
+		const auto& mainScene = m_scenes.at(m_pszMainSceneName);
+
+		// Env texture and sampler state
+		const auto& skybox = mainScene->GetSkyBox();
+		if (skybox)
+		{
+			const auto& material = skybox->GetMaterial(0);
+			const auto& envTexView = material->pDiffuse->GetTextureResourceView();
+			const auto& envSampler = Texture::s_samplers[static_cast<size_t>(material->pDiffuse->GetSamplerType())];
+
+			cache.PSSetShaderResources(3, 1, ToGpu(envTexView.GetAddressOf()));
+			cache.PSSetSamplers(3, 1, ToGpu(envSampler.GetAddressOf()));
+		}
+
+		if (bHasBlockTextures)
+		{
+			const std::shared_ptr<BlockTextureArray>& blockTextures = mainScene->GetBlockTextures();
+			ID3D11ShaderResourceView* aBlockViews[] = { blockTextures->GetDiffuseView().Get(), blockTextures->GetNormalView().Get() };
+
+			cache.PSSetShaderResources(4, ARRAYSIZE(aBlockViews), ToGpu(aBlockViews));
+		}
+
+		// Bones of every skinned model, read by offset
+		cache.VSSetShaderResources(6, 1, ToGpu(m_bonePalette.GetShaderResourceView().GetAddressOf()));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::writeConstants
+
+	  Summary:  Writes constants into the constant ring, or into their
+				own constant buffer when the ring is disabled or full
+
+	  Args:     ID3D11Buffer* pBuffer
+				  Constant buffer to update without the ring, must
+				  hold uReservedSize bytes
+				const void* pData
+				  Constants to write
+				UINT uDataSize
+				  Bytes to write into the ring
+				UINT uReservedSize
+				  Bytes the shader reads, all of them are copied into
+				  the constant buffer
+
+	  Returns:  UINT
+				  First constant in the ring, ConstantRing::NO_OFFSET
+				  if the constant buffer was updated instead
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::writeConstants(_In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uReservedSize) const void* pData, _In_ UINT uDataSize, _In_ UINT uReservedSize)
+	{
+		const UINT uFirstConstant = m_constantRing.Write(m_renderContext, pData, uDataSize, uReservedSize);
+		if (uFirstConstant == ConstantRing::NO_OFFSET)
+		{
+			m_renderContext.UpdateSubresource(ToGpu(pBuffer), 0u, nullptr, pData, 0u, 0u);
+		}
+
+		return uFirstConstant;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::bindConstants
+
+	  Summary:  Binds constants written by writeConstants, a range of
+				the constant ring by offset or else their own buffer
+
+	  Args:     StateCache& cache
+				  State cache of the context the constants are bound on
+				UINT uSlot
+				  Constant buffer slot
+				ID3D11Buffer* pBuffer
+				  Constant buffer used without the ring
+				UINT uFirstConstant
+				  First constant in the ring, ConstantRing::NO_OFFSET
+				  to bind pBuffer
+				UINT uSize
+				  Bytes the shader reads
+				BOOL bBindPixelShader
+				  Whether the pixel shader reads the constants too
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::bindConstants(_Inout_ StateCache& cache, _In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer, _In_ UINT uFirstConstant, _In_ UINT uSize, _In_ BOOL bBindPixelShader)
+	{
+		if (uFirstConstant == ConstantRing::NO_OFFSET)
+		{
+			cache.VSSetConstantBuffers(uSlot, 1, ToGpu(&pBuffer));
+			if (bBindPixelShader)
 			{
-				const auto& mesh = renderable->GetMesh(i);
-				m_immediateContext->DrawIndexed(mesh.uNumIndices, mesh.uBaseIndex, static_cast<INT>(mesh.uBaseVertex));
+				cache.PSSetConstantBuffers(uSlot, 1, ToGpu(&pBuffer));
 			}
+
+			return;
 		}
 
-		for (auto& pair : scene->GetModels())
+		// Every range differs, so there is nothing for the state cache to filter
+		IRenderContext* pContext = cache.GetContext();
+		const UINT uNumConstants = ConstantRing::GetNumConstants(uSize);
+		pContext->VSSetConstantBuffers1(uSlot, 1, ToGpu(m_constantRing.GetBuffer().GetAddressOf()), &uFirstConstant, &uNumConstants);
+		if (bBindPixelShader)
 		{
-			auto& model = pair.second;
+			pContext->PSSetConstantBuffers1(uSlot, 1, ToGpu(m_constantRing.GetBuffer().GetAddressOf()), &uFirstConstant, &uNumConstants);
+		}
+
+		cache.InvalidateConstantBuffers(uSlot, 1);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::recordShadowDraws
+
+	  Summary:  Draws a range of the queued shadow draws into the
+				shadow map. The first range clears it and the depth
+				buffer.
+
+	  Args:     StateCache& cache
+				  State cache of the context the range is drawn on
+				UINT uBegin
+				  First shadow draw
+				UINT uEnd
+				  One past the last shadow draw
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::recordShadowDraws(_Inout_ StateCache& cache, _In_ UINT uBegin, _In_ UINT uEnd)
+	{
+		IRenderContext* pContext = cache.GetContext();
+		pContext->OMSetRenderTargets(
+			1,
+			ToGpu(m_shadowMapTexture->GetRenderTargetView().GetAddressOf()),
+			ToGpu(m_depthStencilView.Get())
+		);
+		pContext->RSSetViewports(1, &m_viewport);
+
+		if (uBegin == 0u)
+		{
+			pContext->ClearRenderTargetView(ToGpu(m_shadowMapTexture->GetRenderTargetView().Get()), Colors::White);
+			pContext->ClearDepthStencilView(ToGpu(m_depthStencilView.Get()), IRenderContext::CLEAR_DEPTH, 1.0f, 0);
+		}
+
+		// Set shaders and the input layout
+		cache.IASetPrimitiveTopology(ePrimitiveTopology::TRIANGLE_LIST);
+		cache.VSSetShader(ToGpu(m_shadowVertexShader->GetVertexShader().Get()));
+		cache.PSSetShader(ToGpu(m_shadowPixelShader->GetPixelShader().Get()));
+		cache.IASetInputLayout(ToGpu(m_shadowVertexShader->GetVertexLayout().Get()));
+
+		for (UINT uDraw = uBegin; uDraw < uEnd; ++uDraw)
+		{
+			const ShadowDraw& draw = m_aShadowDraws[uDraw];
+			Renderable& renderable = *draw.pRenderable;
 
 			// Set the vertex buffer
-			UINT stride0 = sizeof(SimpleVertex);
-			UINT offset0 = 0;
-			m_immediateContext->IASetVertexBuffers(
-				0,
-				1,
-				model->GetVertexBuffer().GetAddressOf(),
-				&stride0,
-				&offset0
-			);
+			UINT stride = sizeof(SimpleVertex);
+			UINT offset = 0;
+			cache.IASetVertexBuffers(0, 1, ToGpu(&draw.pVertexBuffer), &stride, &offset);
 
 			// Set the index buffer
-			m_immediateContext->IASetIndexBuffer(model->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+			cache.IASetIndexBuffer(ToGpu(renderable.GetIndexBuffer().Get()), DXGI_FORMAT_R16_UINT, 0);
 
-			// Set the input layout
-			m_immediateContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
+			// Shadow constant buffer, shared by every draw without the ring
+			if (draw.uFirstConstant == ConstantRing::NO_OFFSET)
+			{
+				pContext->UpdateSubresource(ToGpu(m_cbShadowMatrix.Get()), 0u, nullptr, &draw.Constants, 0u, 0u);
+			}
+			bindConstants(cache, 0, m_cbShadowMatrix.Get(), draw.uFirstConstant, sizeof(draw.Constants), FALSE);
 
-			// Shadow constant buffer
-			CBShadowMatrix cbShadow = {
-				.World = XMMatrixTranspose(model->GetWorldMatrix()),
-				.View = XMMatrixTranspose(light->GetViewMatrix()),
-				.Projection = XMMatrixTranspose(light->GetProjectionMatrix()),
-				.IsVoxel = false
-			};
+			const UINT numOfMesh = renderable.GetNumMeshes();
+			for (UINT i = 0; i < numOfMesh; i++)
+			{
+				const auto& mesh = renderable.GetMesh(i);
+				pContext->DrawIndexed(mesh.uNumIndices, mesh.uBaseIndex, static_cast<INT>(mesh.uBaseVertex));
+			}
+		}
+	}
 
-			m_immediateContext->UpdateSubresource(
-				m_cbShadowMatrix.Get(),
-				0u,
-				nullptr,
-				&cbShadow,
-				0u,
-				0u
-			);
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::recordDrawPackets
+
+	  Summary:  Draws a range of the sorted packets through a state
+				cache, so a shader, texture or sampler is bound only
+				when it differs from the one the previous packet left
+				bound. The first range clears the back buffer and the
+				depth buffer.
+
+	  Args:     StateCache& cache
+				  State cache of the context the range is drawn on
+				UINT uBegin
+				  First packet
+				UINT uEnd
+				  One past the last packet
+				BOOL bHasBlockTextures
+				  Whether voxels sample the block texture arrays
+				  instead of their own materials
+				BOOL bIsSorted
+				  Whether the packets are drawn in sorted order or in
+				  the order they were queued
+
+	  Returns:  UINT
+				  State binds the packets of the range issued
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::recordDrawPackets(_Inout_ StateCache& cache, _In_ UINT uBegin, _In_ UINT uEnd, _In_ BOOL bHasBlockTextures, _In_ BOOL bIsSorted)
+	{
+		IRenderContext* pContext = cache.GetContext();
+		if (uBegin == 0u)
+		{
+			// Clear the backbuffer
+			constexpr float clearColor[4] = { 0.0f, 0.125f, 0.6f, 1.0f }; // RGBA
+			pContext->ClearRenderTargetView(ToGpu(m_renderTargetView.Get()), clearColor);
 
-			m_immediateContext->VSSetConstantBuffers(0, 1, m_cbShadowMatrix.GetAddressOf());
+			// Clear the depth buffer to 1.0 (maximum depth)
+			pContext->ClearDepthStencilView(ToGpu(m_depthStencilView.Get()), IRenderContext::CLEAR_DEPTH | IRenderContext::CLEAR_STENCIL, 1.0f, 0);
+		}
 
-			const UINT numOfMesh = model->GetNumMeshes();
-			for (UINT i = 0; i < numOfMesh; i++)
+		bindMainPassState(cache, bHasBlockTextures);
+
+		const Renderable* pBoundRenderable = nullptr;
+		const UINT uFirstForwardedCall = cache.GetNumForwardedCalls();
+
+		for (UINT uPacket = uBegin; uPacket < uEnd; ++uPacket)
+		{
+			const DrawPacket& packet = bIsSorted ? m_renderQueue.GetPacket(uPacket) : m_renderQueue.GetQueuedPacket(uPacket);
+			Renderable& renderable = *packet.pRenderable;
+			const auto& mesh = renderable.GetMesh(packet.uMeshIndex);
+
+			// Packets of one renderable are mostly next to each other,
+			// so its buffers are not even offered to the state cache again
+			if (packet.pRenderable != pBoundRenderable)
+			{
+				bindDrawPacket(cache, packet);
+				pBoundRenderable = packet.pRenderable;
+			}
+
+			// Set shaders
+			cache.VSSetShader(ToGpu(renderable.GetVertexShader().Get()));
+			cache.PSSetShader(ToGpu(renderable.GetPixelShader().Get()));
+
+			if (packet.Type == eDrawPacketType::VOXEL && bHasBlockTextures)
 			{
-				const auto& mesh = model->GetMesh(i);
-				m_immediateContext->DrawIndexed(mesh.uNumIndices, mesh.uBaseIndex, static_cast<INT>(mesh.uBaseVertex));
+				cache.PSSetSamplers(0, 1, ToGpu(Texture::s_samplers[static_cast<size_t>(eTextureSamplerType::TRILINEAR_WRAP)].GetAddressOf()));
+			}
+			else if (renderable.HasTexture())
+			{
+				const auto& material = renderable.GetMaterial(mesh.uMaterialIndex);
+
+				const auto& diffuseView = material->pDiffuse->GetTextureResourceView();
+				const auto& diffuseSampler = Texture::s_samplers[static_cast<size_t>(material->pDiffuse->GetSamplerType())];
+
+				cache.PSSetShaderResources(0, 1, ToGpu(diffuseView.GetAddressOf()));
+				cache.PSSetSamplers(0, 1, ToGpu(diffuseSampler.GetAddressOf()));
+
+				if (renderable.HasNormalMap() && packet.Type != eDrawPacketType::SKYBOX)
+				{
+					const auto& normalView = material->pNormal->GetTextureResourceView();
+					const auto& normalSampler = Texture::s_samplers[static_cast<size_t>(material->pNormal->GetSamplerType())];
+
+					cache.PSSetShaderResources(1, 1, ToGpu(normalView.GetAddressOf()));
+					cache.PSSetSamplers(1, 1, ToGpu(normalSampler.GetAddressOf()));
+				}
+			}
+
+			if (packet.Type == eDrawPacketType::VOXEL)
+			{
+				for (UINT i = 0u; i < packet.uNumRanges; ++i)
+				{
+					const InstanceRange& range = m_aInstanceRanges[packet.uFirstRange + i];
+					pContext->DrawIndexedInstanced(
+						mesh.uNumIndices,
+						range.uNumInstances,
+						mesh.uBaseIndex,
+						static_cast<INT>(mesh.uBaseVertex),
+						range.uStartInstance
+					);
+				}
+			}
+			else
+			{
+				pContext->DrawIndexed(mesh.uNumIndices, mesh.uBaseIndex, static_cast<INT>(mesh.uBaseVertex));
 			}
 		}
 
-		// Reset RT back to original back buffer
-		m_immediateContext->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
+		return cache.GetNumForwardedCalls() - uFirstForwardedCall;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderer::GetDriverType
+	  Method:   Renderer::countUnsortedBinds
 
-	  Summary:  Returns the Direct3D driver type
+	  Summary:  Records the packets in the order they were queued on
+				a null context through a state cache of its own, to
+				count the binds drawing them unsorted would take. The
+				saved binds are measured against this count.
 
-	  Returns:  D3D_DRIVER_TYPE
-				  The Direct3D driver type used
+	  Args:     BOOL bHasBlockTextures
+				  Whether voxels sample the block texture arrays
+				  instead of their own materials
+
+	  Modifies: [m_unsortedContext, m_unsortedCache,
+				 m_uNumUnsortedBinds].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	D3D_DRIVER_TYPE Renderer::GetDriverType() const
+	void Renderer::countUnsortedBinds(_In_ BOOL bHasBlockTextures)
 	{
-		return m_driverType;
+		m_unsortedContext.Clear();
+		m_unsortedCache.Invalidate();
+		m_unsortedCache.ResetCounters();
+
+		m_uNumUnsortedBinds = recordDrawPackets(m_unsortedCache, 0u, m_renderQueue.GetNumPackets(), bHasBlockTextures, FALSE);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::submitDrawPackets
+
+	  Summary:  Draws the sorted packets on the immediate context
+
+	  Args:     BOOL bHasBlockTextures
+				  Whether voxels sample the block texture arrays
+				  instead of their own materials
+
+	  Modifies: [m_uNumStateBinds, m_uNumSavedBinds,
+				  m_uNumDeferredFilteredBinds].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::submitDrawPackets(_In_ BOOL bHasBlockTextures)
+	{
+		m_uNumStateBinds = recordDrawPackets(m_stateCache, 0u, m_renderQueue.GetNumPackets(), bHasBlockTextures, TRUE);
+		m_uNumSavedBinds = m_uNumUnsortedBinds > m_uNumStateBinds ? m_uNumUnsortedBinds - m_uNumStateBinds : 0u;
+		m_uNumDeferredFilteredBinds = 0u;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::submitParallel
+
+	  Summary:  Records the shadow pass and contiguous ranges of the
+				sorted packets on the job system workers, each into
+				its own deferred context with its own state cache,
+				then executes the command lists in order. Every list
+				binds the pass state it needs, so the output matches
+				drawing the packets on the immediate context.
+
+	  Args:     BOOL bHasBlockTextures
+				  Whether voxels sample the block texture arrays
+				  instead of their own materials
+
+	  Modifies: [m_commandRecorder, m_stateCache, m_uNumStateBinds,
+				  m_uNumSavedBinds, m_uNumDeferredFilteredBinds].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::submitParallel(_In_ BOOL bHasBlockTextures)
+	{
+		std::atomic<UINT> uNumStateBinds(0u);
+		std::atomic<UINT> uNumFilteredBinds(0u);
+
+		// The shadow map must be drawn before the main pass samples it
+		HRESULT hr = m_commandRecorder.Record(static_cast<UINT>(m_aShadowDraws.size()), 1u,
+			[this, &uNumFilteredBinds](DeferredContext& context, UINT uBegin, UINT uEnd)
+			{
+				context.Cache.ResetCounters();
+				recordShadowDraws(context.Cache, uBegin, uEnd);
+				uNumFilteredBinds += context.Cache.GetNumFilteredCalls();
+			});
+
+		// One range per thread at most, and none too short to pay for its list
+		const UINT uNumPackets = m_renderQueue.GetNumPackets();
+		const UINT uNumRanges = std::min(JobSystem::GetInstance().GetNumWorkers() + 1u, (uNumPackets + MIN_PACKETS_PER_LIST - 1u) / MIN_PACKETS_PER_LIST);
+		if (SUCCEEDED(hr))
+		{
+			hr = m_commandRecorder.Record(uNumPackets, uNumRanges,
+				[this, bHasBlockTextures, &uNumStateBinds, &uNumFilteredBinds](DeferredContext& context, UINT uBegin, UINT uEnd)
+				{
+					context.Cache.ResetCounters();
+					uNumStateBinds += recordDrawPackets(context.Cache, uBegin, uEnd, bHasBlockTextures, TRUE);
+					uNumFilteredBinds += context.Cache.GetNumFilteredCalls();
+				});
+		}
+
+		// Executes whatever was recorded even if a range failed
+		const HRESULT hrExecute = m_commandRecorder.Execute();
+		if (FAILED(hr) || FAILED(hrExecute))
+		{
+			WCHAR szMessage[256];
+			swprintf_s(szMessage, L"Recording draws failed: 0x%08X, executing them: 0x%08X\n", static_cast<UINT>(hr), static_cast<UINT>(hrExecute));
+			OutputDebugString(szMessage);
+		}
+
+		// Executing a command list resets the immediate context to its default state
+		m_stateCache.Invalidate();
+
+		m_uNumStateBinds = uNumStateBinds;
+		m_uNumSavedBinds = m_uNumUnsortedBinds > m_uNumStateBinds ? m_uNumUnsortedBinds - m_uNumStateBinds : 0u;
+		m_uNumDeferredFilteredBinds = uNumFilteredBinds;
 	}
 }
\ No newline at end of file
@@ -13,16 +13,32 @@
 
 #include "Common.h"
 
+#include <chrono>
+#include <future>
+
 #include "Camera/Camera.h"
 #include "Light/PointLight.h"
 #include "Model/Model.h"
+#include "Renderer/BonePalette.h"
+#include "Renderer/CommandRecorder.h"
+#include "Renderer/ConstantRing.h"
+#include "Renderer/D3D11Backend.h"
 #include "Renderer/DataTypes.h"
+#include "Renderer/HorizonCuller.h"
+#include "Renderer/InstanceChunker.h"
+#include "Renderer/NullBackend.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/RenderQueue.h"
+#include "Renderer/SoftwareRasterizer.h"
+#include "Renderer/StateCache.h"
 #include "Scene/Scene.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
 #include "Window/MainWindow.h"
 #include "Texture/RenderTexture.h"
+#include "Texture/TextureCache.h"
+#include "Texture/TextureStreamer.h"
 #include "Shader/ShadowVertexShader.h"
 
 namespace library
@@ -41,8 +57,38 @@ namespace library
 				  Update the renderables each frame
 				Render
 				  Renders the frame
+				RenderSoftware
+				  Renders the frame on the CPU into a software
+				  rasterizer
+				SetBonePaletteFormat
+				  Sets how skinned models store their bones
+				SetParallelSubmission
+				  Sets whether draws are recorded on worker threads
+				SetOcclusionCulling
+				  Sets whether meshes hidden by occluders are culled
+				SetCpuSkinning
+				  Sets whether skinned models are skinned on the CPU
 				GetDriverType
 				  Returns the Direct3D driver type
+				GetNumDrawnMeshes
+				  Returns the meshes drawn by the last frame
+				GetNumCulledMeshes
+				  Returns the meshes culled by the last frame
+				GetNumOccludedMeshes
+				  Returns the culled meshes hidden by the terrain
+				  or by occluders
+				GetNumStateBinds
+				  Returns the state binds issued by the last frame
+				GetNumSavedBinds
+				  Returns the state binds sorting saved last frame
+				GetNumFilteredBinds
+				  Returns the redundant binds dropped last frame
+				GetNumUploadedBoneBytes
+				  Returns the bone bytes uploaded by the last frame
+				GetNumFixedPaletteBytes
+				  Returns the bone bytes full palettes would upload
+				GetNumCommandLists
+				  Returns the command lists executed last frame
 				Renderer
 				  Constructor.
 				~Renderer
@@ -64,13 +110,77 @@ namespace library
 		std::shared_ptr<Scene> GetSceneOrNull(_In_ PCWSTR pszSceneName);
 		HRESULT SetMainScene(_In_ PCWSTR pszSceneName);
 		void SetShadowMapShaders(_In_ std::shared_ptr<ShadowVertexShader> vertexShader, _In_ std::shared_ptr<PixelShader> pixelShader);
+		void SetBonePaletteFormat(_In_ eBonePaletteFormat eFormat);
+		void SetParallelSubmission(_In_ BOOL bParallelSubmission);
+		void SetOcclusionCulling(_In_ BOOL bOcclusionCulling);
+		void SetCpuSkinning(_In_ BOOL bCpuSkinning);
 
 		void HandleInput(_In_ const DirectionsInput& directions, _In_ const MouseRelativeMovement& mouseRelativeMovement, _In_ FLOAT deltaTime);
 		void Update(_In_ FLOAT deltaTime);
 		void Render();
 		void RenderSceneToTexture();
+		HRESULT RenderSoftware(_Inout_ SoftwareRasterizer& rasterizer);
 
 		D3D_DRIVER_TYPE GetDriverType() const;
+		UINT GetNumDrawnMeshes() const;
+		UINT GetNumCulledMeshes() const;
+		UINT GetNumOccludedMeshes() const;
+		UINT GetNumStateBinds() const;
+		UINT GetNumSavedBinds() const;
+		UINT GetNumFilteredBinds() const;
+		UINT GetNumUploadedBoneBytes() const;
+		UINT GetNumFixedPaletteBytes() const;
+		UINT GetNumCommandLists() const;
+
+	private:
+		/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		  Struct:   ShadowDraw
+
+		  Summary:  Constants and buffers of a renderable drawn into the
+					shadow map, queued before the pass is recorded
+		S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+		struct ShadowDraw
+		{
+			CBShadowMatrix Constants;
+			Renderable* pRenderable;
+			ID3D11Buffer* pVertexBuffer;
+			UINT uFirstConstant;
+		};
+
+	private:
+		void reportLoadTimes();
+		void reportStatistics();
+		void requestTextureScreenSizes();
+		void queryRenderables(_In_ const Scene& scene, _In_reads_(FrustumCuller::NUM_PLANES) const XMFLOAT4A* aPlanes);
+		BOOL isOutsideQuery(_In_ const Scene& scene, _In_ const Renderable& renderable) const;
+		void cullMeshes();
+		void queueDrawPackets(_In_ BOOL bHasBlockTextures);
+		void queueMeshes(_In_ const DrawPacket& object, _In_ UINT uFirstBounds, _In_ BOOL bUsesMaterials);
+		void queueShadowDraws();
+		void bindDrawPacket(_Inout_ StateCache& cache, _In_ const DrawPacket& packet);
+		void bindMainPassState(_Inout_ StateCache& cache, _In_ BOOL bHasBlockTextures);
+		UINT writeConstants(_In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uReservedSize) const void* pData, _In_ UINT uDataSize, _In_ UINT uReservedSize);
+		void bindConstants(_Inout_ StateCache& cache, _In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer, _In_ UINT uFirstConstant, _In_ UINT uSize, _In_ BOOL bBindPixelShader);
+		void recordShadowDraws(_Inout_ StateCache& cache, _In_ UINT uBegin, _In_ UINT uEnd);
+		UINT recordDrawPackets(_Inout_ StateCache& cache, _In_ UINT uBegin, _In_ UINT uEnd, _In_ BOOL bHasBlockTextures, _In_ BOOL bIsSorted);
+		void countUnsortedBinds(_In_ BOOL bHasBlockTextures);
+		void submitDrawPackets(_In_ BOOL bHasBlockTextures);
+		void submitParallel(_In_ BOOL bHasBlockTextures);
+
+	private:
+		static constexpr UINT MAX_NUM_DEVICE_TASKS_PER_FRAME = 1u;
+		static constexpr FLOAT FAR_DISTANCE = 1000.0f;
+		static constexpr UINT NO_BOUNDS = UINT_MAX;
+
+		// Renderable meshes this large and this simple are drawn as occluders
+		static constexpr FLOAT OCCLUDER_MIN_RADIUS = 2.0f;
+		static constexpr UINT MAX_OCCLUDER_INDICES = 36u * 8u;
+
+		// Fewer packets than this are not worth a command list of their own
+		static constexpr UINT MIN_PACKETS_PER_LIST = 64u;
+
+		// About ten seconds at 60 frames per second
+		static constexpr UINT STATISTICS_REPORT_FRAMES = 600u;
 
 	private:
 		D3D_DRIVER_TYPE m_driverType;
@@ -79,11 +189,21 @@ namespace library
 		ComPtr<ID3D11Device1> m_d3dDevice1;
 		ComPtr<ID3D11DeviceContext> m_immediateContext;
 		ComPtr<ID3D11DeviceContext1> m_immediateContext1;
+		D3D11RenderDevice m_renderDevice;
+		D3D11RenderContext m_renderContext;
+		StateCache m_stateCache;
+		NullContext m_unsortedContext;
+		StateCache m_unsortedCache;
+		ConstantRing m_constantRing;
+		BonePalette m_bonePalette;
+		DeferredContextBackend m_deferredBackend;
+		CommandRecorder m_commandRecorder;
 		ComPtr<IDXGISwapChain> m_swapChain;
 		ComPtr<IDXGISwapChain1> m_swapChain1;
 		ComPtr<ID3D11RenderTargetView> m_renderTargetView;
 		ComPtr<ID3D11Texture2D> m_depthStencil;
 		ComPtr<ID3D11DepthStencilView> m_depthStencilView;
+		GpuViewport m_viewport;
 		ComPtr<ID3D11Buffer> m_cbChangeOnResize;
 		ComPtr<ID3D11Buffer> m_cbLights;
 		ComPtr<ID3D11Buffer> m_cbShadowMatrix;
@@ -97,5 +217,31 @@ namespace library
 		std::shared_ptr<RenderTexture> m_shadowMapTexture;
 		std::shared_ptr<ShadowVertexShader> m_shadowVertexShader;
 		std::shared_ptr<PixelShader> m_shadowPixelShader;
+		FrustumCuller m_frustumCuller;
+		FrustumCuller m_lightFrustum;
+		std::vector<UINT> m_aQueriedProxies;
+		HorizonCuller m_horizonCuller;
+		OcclusionCuller m_occlusionCuller;
+		std::vector<MeshBounds> m_aTerrainHulls;
+		std::vector<InstanceRange> m_aInstanceRanges;
+		std::vector<InstanceRange> m_aVisibleRanges;
+		RenderQueue m_renderQueue;
+		std::vector<ShadowDraw> m_aShadowDraws;
+		BOOL m_bParallelSubmission;
+		BOOL m_bOcclusionCulling;
+		BOOL m_bCpuSkinning;
+		UINT m_uNumDrawnMeshes;
+		UINT m_uNumCulledMeshes;
+		UINT m_uNumOccludedMeshes;
+		UINT m_uNumUnsortedBinds;
+		UINT m_uNumStateBinds;
+		UINT m_uNumSavedBinds;
+		UINT m_uNumDeferredFilteredBinds;
+
+		std::shared_future<HRESULT> m_modelsLoaded;
+		std::chrono::high_resolution_clock::time_point m_initializeStart;
+		BOOL m_bFirstFrameReported;
+		BOOL m_bModelsLoadedReported;
+		UINT m_uNumFramesSinceReport;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "Renderer/RingAllocator.h"
+
+#include <algorithm>
+
+namespace library
+{
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RingAllocator::RingAllocator
+
+	  Summary:  Constructor of an empty ring
+
+	  Modifies: [m_uSize, m_uAlignment, m_uHead, m_bMustWrap].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	RingAllocator::RingAllocator()
+		: m_uSize(0u)
+		, m_uAlignment(1u)
+		, m_uHead(0u)
+		, m_bMustWrap(TRUE)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RingAllocator::Reset
+
+	  Summary:  Sets the size and alignment of the ring and makes the
+				next range wrap
+
+	  Args:     UINT uSize
+				  Size of the ring in bytes
+				UINT uAlignment
+				  Alignment of offsets and sizes, a power of two
+
+	  Modifies: [m_uSize, m_uAlignment, m_uHead, m_bMustWrap].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void RingAllocator::Reset(_In_ UINT uSize, _In_ UINT uAlignment)
+	{
+		assert(uAlignment != 0u && (uAlignment & (uAlignment - 1u)) == 0u);
+
+		m_uAlignment = uAlignment;
+		m_uSize = uSize & ~(uAlignment - 1u);
+		Restart();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RingAllocator::Restart
+
+	  Summary:  Makes the next range wrap, whether or not it fits
+				and whether or not its caller allows wrapping
+
+	  Modifies: [m_uHead, m_bMustWrap].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void RingAllocator::Restart()
+	{
+		m_uHead = m_uSize;
+		m_bMustWrap = TRUE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RingAllocator::Allocate
+
+	  Summary:  Hands out the next aligned range, starting over from
+				the beginning when it does not fit before the end and
+				wrapping is allowed
+
+	  Args:     UINT uSize
+				  Size of the range in bytes, rounded up to the
+				  alignment
+				BOOL bCanWrap
+				  Whether a range that does not fit may start the
+				  ring over. The first range after a reset or
+				  restart wraps regardless.
+				UINT& uOutOffset
+				  Offset of the range in bytes
+				BOOL& bOutWrapped
+				  Whether the range starts the ring over
+
+	  Modifies: [m_uHead, m_bMustWrap].
+
+	  Returns:  BOOL
+				  FALSE if the range is larger than the ring, or does
+				  not fit before the end and may not wrap
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL RingAllocator::Allocate(_In_ UINT uSize, _In_ BOOL bCanWrap, _Out_ UINT& uOutOffset, _Out_ BOOL& bOutWrapped)
+	{
+		uOutOffset = 0u;
+		bOutWrapped = FALSE;
+
+		const UINT uAlignedSize = (std::max<UINT>(uSize, 1u) + m_uAlignment - 1u) & ~(m_uAlignment - 1u);
+		if (uAlignedSize > m_uSize || uAlignedSize < uSize)
+		{
+			return FALSE;
+		}
+
+		if (m_bMustWrap || uAlignedSize > m_uSize - m_uHead)
+		{
+			if (!m_bMustWrap && !bCanWrap)
+			{
+				return FALSE;
+			}
+
+			m_uHead = 0u;
+			m_bMustWrap = FALSE;
+			bOutWrapped = TRUE;
+		}
+
+		uOutOffset = m_uHead;
+		m_uHead += uAlignedSize;
+
+		return TRUE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RingAllocator::GetSize
+
+	  Summary:  Returns the size of the ring
+
+	  Returns:  UINT
+				  Size of the ring in bytes
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT RingAllocator::GetSize() const
+	{
+		return m_uSize;
+	}
+}
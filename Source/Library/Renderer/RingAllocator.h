@@ -0,0 +1,62 @@
+/*+===================================================================
+  File:      RINGALLOCATOR.H
+
+  Summary:   RingAllocator header file contains declarations of
+			 RingAllocator class that hands out aligned ranges of a
+			 ring.
+
+  Classes: RingAllocator
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Portable.h"
+
+namespace library
+{
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    RingAllocator
+
+	  Summary:  Hands out aligned ranges from the front of a ring and
+				starts over from the beginning when a range no longer
+				fits, if the caller allows it. A range that starts over
+				is flagged as wrapped, so its owner discards the memory
+				behind the ring before writing. The first range after
+				a reset or restart always wraps.
+
+	  Methods:  Reset
+				  Sets the size and alignment and forces a wrap
+				Restart
+				  Forces a wrap
+				Allocate
+				  Hands out a range
+				GetSize
+				  Returns the size of the ring
+				RingAllocator
+				  Constructor.
+				~RingAllocator
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class RingAllocator final
+	{
+	public:
+		RingAllocator();
+		RingAllocator(const RingAllocator& other) = delete;
+		RingAllocator(RingAllocator&& other) = delete;
+		RingAllocator& operator=(const RingAllocator& other) = delete;
+		RingAllocator& operator=(RingAllocator&& other) = delete;
+		~RingAllocator() = default;
+
+		void Reset(_In_ UINT uSize, _In_ UINT uAlignment);
+		void Restart();
+		BOOL Allocate(_In_ UINT uSize, _In_ BOOL bCanWrap, _Out_ UINT& uOutOffset, _Out_ BOOL& bOutWrapped);
+		UINT GetSize() const;
+
+	private:
+		UINT m_uSize;
+		UINT m_uAlignment;
+		UINT m_uHead;
+		BOOL m_bMustWrap;
+	};
+}
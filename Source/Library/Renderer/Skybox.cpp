@@ -1,5 +1,7 @@
 #include "Renderer/Skybox.h"
 
+#include "Texture/TextureCache.h"
+
 #include "assimp/Importer.hpp"	// C++ importer interface
 #include "assimp/scene.h"		// output data structure
 #include "assimp/postprocess.h"	// post processing flags
@@ -38,14 +40,14 @@ namespace library
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	HRESULT Skybox::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
 	{
-		HRESULT hr = Model::Initialize(pDevice, pImmediateContext);
+		HRESULT hr = Model::Load(pDevice, pImmediateContext);
 		if (FAILED(hr)) return hr;
 
 		m_world = XMMatrixScaling(m_scale, m_scale, m_scale);
 
 		m_aMeshes[0].uMaterialIndex = 0;
 
-		m_aMaterials[0]->pDiffuse = std::make_shared<Texture>(m_cubeMapFileName);
+		m_aMaterials[0]->pDiffuse = TextureCache::GetInstance().GetOrCreate(m_cubeMapFileName);
 
 		hr = m_aMaterials[0]->Initialize(pDevice, pImmediateContext);
 		if (FAILED(hr)) return hr;
@@ -0,0 +1,1330 @@
+#include "Renderer/SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+
+namespace library
+{
+	namespace
+	{
+		// Triangles are only clipped against the sides when they reach
+		// this far outside of the screen, so that snapped coordinates
+		// keep their precision
+		constexpr FLOAT GUARD_BAND = 8.0f;
+
+		// Near plane first, then the guard band, as distances a*x + b*y + c*z + d*w
+		constexpr UINT NUM_CLIP_PLANES = 5u;
+		const XMFLOAT4 CLIP_PLANES[NUM_CLIP_PLANES] =
+		{
+			XMFLOAT4(0.0f, 0.0f, 1.0f, 0.0f),
+			XMFLOAT4(1.0f, 0.0f, 0.0f, GUARD_BAND),
+			XMFLOAT4(-1.0f, 0.0f, 0.0f, GUARD_BAND),
+			XMFLOAT4(0.0f, 1.0f, 0.0f, GUARD_BAND),
+			XMFLOAT4(0.0f, -1.0f, 0.0f, GUARD_BAND),
+		};
+		constexpr UINT MAX_CLIPPED_VERTICES = 3u + NUM_CLIP_PLANES;
+
+		constexpr FLOAT SHININESS = 20.0f;
+		constexpr FLOAT ATTENUATION_EPSILON = 0.000001f;
+
+		FLOAT getClipDistance(_In_ const XMFLOAT4& plane, _In_ const XMFLOAT4& position)
+		{
+			return plane.x * position.x + plane.y * position.y + plane.z * position.z + plane.w * position.w;
+		}
+
+		/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+		  Function: getOutCode
+
+		  Summary:  Sets a bit for every side of the view volume a clip
+					space position is outside of
+
+		  Args:     const XMFLOAT4& position
+					  Clip space position
+
+		  Returns:  UINT
+					  Bits of the sides, left, right, bottom, top, near
+					  and far
+		F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+		UINT getOutCode(_In_ const XMFLOAT4& position)
+		{
+			return (position.x < -position.w ? 1u : 0u)
+				| (position.x > position.w ? 2u : 0u)
+				| (position.y < -position.w ? 4u : 0u)
+				| (position.y > position.w ? 8u : 0u)
+				| (position.z < 0.0f ? 16u : 0u)
+				| (position.z > position.w ? 32u : 0u);
+		}
+
+		BOOL isInsideGuardBand(_In_ const XMFLOAT4& position)
+		{
+			return position.z >= 0.0f
+				&& fabsf(position.x) <= GUARD_BAND * position.w
+				&& fabsf(position.y) <= GUARD_BAND * position.w;
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::SoftwareRasterizer
+
+	  Summary:  Constructor
+
+	  Modifies: [m_view, m_projection, m_cameraPosition, m_light,
+				 m_uWidth, m_uHeight, m_uNumTilesX, m_uNumTilesY,
+				 m_uPitch, m_aColors, m_aDepths, m_aDraws,
+				 m_aWorkItems, m_aBatches, m_aTileCoveredPixels,
+				 m_aTileShadedPixels, m_stats].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SoftwareRasterizer::SoftwareRasterizer()
+		: m_view(XMMatrixIdentity())
+		, m_projection(XMMatrixIdentity())
+		, m_cameraPosition(0.0f, 0.0f, 0.0f, 1.0f)
+		, m_light()
+		, m_uWidth(0u)
+		, m_uHeight(0u)
+		, m_uNumTilesX(0u)
+		, m_uNumTilesY(0u)
+		, m_uPitch(0u)
+		, m_aColors()
+		, m_aDepths()
+		, m_aDraws()
+		, m_aWorkItems()
+		, m_aBatches()
+		, m_aTileCoveredPixels()
+		, m_aTileShadedPixels()
+		, m_stats()
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::Initialize
+
+	  Summary:  Creates the color and depth targets, padded to whole
+				tiles so that four pixels can always be read at once
+
+	  Args:     UINT uWidth
+				  Width of the targets
+				UINT uHeight
+				  Height of the targets
+
+	  Modifies: [m_uWidth, m_uHeight, m_uNumTilesX, m_uNumTilesY,
+				 m_uPitch, m_aColors, m_aDepths, m_aTileCoveredPixels,
+				 m_aTileShadedPixels].
+
+	  Returns:  HRESULT
+				  Status code, E_INVALIDARG for an empty target
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT SoftwareRasterizer::Initialize(_In_ UINT uWidth, _In_ UINT uHeight)
+	{
+		if (uWidth == 0u || uHeight == 0u)
+		{
+			return E_INVALIDARG;
+		}
+
+		m_uWidth = uWidth;
+		m_uHeight = uHeight;
+		m_uNumTilesX = (uWidth + TILE_SIZE - 1u) / TILE_SIZE;
+		m_uNumTilesY = (uHeight + TILE_SIZE - 1u) / TILE_SIZE;
+		m_uPitch = m_uNumTilesX * TILE_SIZE;
+
+		m_aColors.assign(static_cast<size_t>(m_uPitch) * m_uNumTilesY * TILE_SIZE, 0u);
+		m_aDepths.assign(m_aColors.size(), 1.0f);
+		m_aTileCoveredPixels.assign(static_cast<size_t>(m_uNumTilesX) * m_uNumTilesY, 0ull);
+		m_aTileShadedPixels.assign(m_aTileCoveredPixels.size(), 0ull);
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::SetCamera
+
+	  Summary:  Sets the view and projection matrices and the camera
+				position the specular term is lit from
+
+	  Args:     FXMMATRIX view
+				  View matrix
+				CXMMATRIX projection
+				  Projection matrix
+				const XMVECTOR& cameraPosition
+				  World space camera position
+
+	  Modifies: [m_view, m_projection, m_cameraPosition].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SoftwareRasterizer::SetCamera(_In_ FXMMATRIX view, _In_ CXMMATRIX projection, _In_ const XMVECTOR& cameraPosition)
+	{
+		m_view = view;
+		m_projection = projection;
+		XMStoreFloat4(&m_cameraPosition, cameraPosition);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::SetLight
+
+	  Summary:  Sets the point light, filled as for the light
+				constant buffer
+
+	  Args:     const PointLightData& light
+				  Point light
+
+	  Modifies: [m_light].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SoftwareRasterizer::SetLight(_In_ const PointLightData& light)
+	{
+		m_light = light;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::Reset
+
+	  Summary:  Removes every draw. Draws are kept between renders
+				until then, so a frame can be rendered repeatedly.
+
+	  Modifies: [m_aDraws].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SoftwareRasterizer::Reset()
+	{
+		m_aDraws.clear();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::AddDraw
+
+	  Summary:  Adds a draw. Its vertices, indices and instances are
+				read by Render, so they have to outlive it.
+
+	  Args:     const SoftwareDraw& draw
+				  The draw
+
+	  Modifies: [m_aDraws].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SoftwareRasterizer::AddDraw(_In_ const SoftwareDraw& draw)
+	{
+		m_aDraws.push_back(draw);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::AddRenderable
+
+	  Summary:  Adds a draw per mesh of a renderable from the
+				vertices and indices it keeps in system memory
+
+	  Args:     const Renderable& renderable
+				  The renderable
+				eSoftwareShading shading
+				  Pixel shader its meshes are shaded with
+				const InstanceData* pInstances
+				  Instances to draw, nullptr to draw it once
+				UINT uNumInstances
+				  Number of instances
+
+	  Modifies: [m_aDraws].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SoftwareRasterizer::AddRenderable(_In_ const Renderable& renderable, _In_ eSoftwareShading shading, _In_opt_ const InstanceData* pInstances, _In_ UINT uNumInstances)
+	{
+		for (UINT i = 0u; i < renderable.GetNumMeshes(); ++i)
+		{
+			const auto& mesh = renderable.GetMesh(i);
+			AddDraw(
+				{
+					.World = renderable.GetWorldMatrix(),
+					.Albedo = renderable.GetOutputColor(),
+					.pVertices = renderable.GetVertices(),
+					.uNumVertices = renderable.GetNumVertices(),
+					.pIndices = renderable.GetIndices() + mesh.uBaseIndex,
+					.uNumIndices = mesh.uNumIndices,
+					.uBaseVertex = mesh.uBaseVertex,
+					.pInstances = pInstances,
+					.uNumInstances = uNumInstances,
+					.Shading = shading
+				}
+			);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::AddScene
+
+	  Summary:  Adds the renderables and models of a scene shaded as
+				by PSPhong and its voxels shaded as by PSVoxel, in the
+				order the renderer draws them, and lights them with
+				its first point light. CPU skinned models are drawn
+				in their skinned pose, the others in their bind pose.
+
+	  Args:     Scene& scene
+				  The scene
+
+	  Modifies: [m_aDraws, m_light].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SoftwareRasterizer::AddScene(_In_ Scene& scene)
+	{
+		const auto& light = scene.GetPointLight(0);
+		if (light)
+		{
+			const FLOAT attDist = light->GetAttenuationDistance();
+			const FLOAT sqrAttDist = attDist * attDist;
+			SetLight(
+				{
+					.Position = light->GetPosition(),
+					.Color = light->GetColor(),
+					.View = XMMatrixTranspose(light->GetViewMatrix()),
+					.Projection = XMMatrixTranspose(light->GetProjectionMatrix()),
+					.AttenuationDistance = XMFLOAT4(attDist, attDist, sqrAttDist, sqrAttDist)
+				}
+			);
+		}
+
+		for (const auto& pair : scene.GetRenderables())
+		{
+			AddRenderable(*pair.second, eSoftwareShading::PHONG, nullptr, 0u);
+		}
+
+		for (const auto& vox : scene.GetVoxels())
+		{
+			const std::vector<InstanceData>& aInstances = vox->GetInstanceData();
+			if (aInstances.empty())
+			{
+				continue;
+			}
+
+			AddRenderable(*vox, eSoftwareShading::VOXEL, aInstances.data(), static_cast<UINT>(aInstances.size()));
+		}
+
+		for (const auto& pair : scene.GetModels())
+		{
+			const auto& model = pair.second;
+			if (!model->IsReady())
+			{
+				continue;
+			}
+
+			const size_t uFirstDraw = m_aDraws.size();
+			AddRenderable(*model, eSoftwareShading::PHONG, nullptr, 0u);
+
+			if (model->IsCpuSkinned() && model->GetSkinnedVertices().size() == model->GetNumVertices())
+			{
+				for (size_t i = uFirstDraw; i < m_aDraws.size(); ++i)
+				{
+					m_aDraws[i].pVertices = model->GetSkinnedVertices().data();
+				}
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::Clear
+
+	  Summary:  Clears the color target to a color and the depth
+				target to the far plane
+
+	  Args:     const XMFLOAT4& color
+				  Clear color
+
+	  Modifies: [m_aColors, m_aDepths].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SoftwareRasterizer::Clear(_In_ const XMFLOAT4& color)
+	{
+		std::fill(m_aColors.begin(), m_aColors.end(), PackColor(XMLoadFloat4(&color)));
+		std::fill(m_aDepths.begin(), m_aDepths.end(), 1.0f);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::Render
+
+	  Summary:  Sets up and bins the triangles of every draw, a job
+				per batch, then rasterizes every tile, a job per
+				tile. Tiles own their pixels, so the raster pass
+				needs no synchronization.
+
+	  Modifies: [m_aWorkItems, m_aBatches, m_aColors, m_aDepths,
+				 m_aTileCoveredPixels, m_aTileShadedPixels, m_stats].
+
+	  Returns:  HRESULT
+				  Status code, E_FAIL before Initialize
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT SoftwareRasterizer::Render()
+	{
+		if (m_aColors.empty())
+		{
+			OutputDebugString(L"SoftwareRasterizer: rendered before Initialize\n");
+			return E_FAIL;
+		}
+
+		m_stats = {};
+		m_stats.uNumDraws = static_cast<UINT>(m_aDraws.size());
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		splitWork();
+		JobSystem::GetInstance().ParallelFor(
+			static_cast<UINT>(m_aBatches.size()),
+			1u,
+			[this](UINT uBegin, UINT uEnd)
+			{
+				for (UINT i = uBegin; i < uEnd; ++i)
+				{
+					processBatch(m_aBatches[i]);
+					binTriangles(m_aBatches[i]);
+				}
+			}
+		);
+
+		const auto binned = std::chrono::high_resolution_clock::now();
+
+		JobSystem::GetInstance().ParallelFor(
+			m_uNumTilesX * m_uNumTilesY,
+			1u,
+			[this](UINT uBegin, UINT uEnd)
+			{
+				for (UINT i = uBegin; i < uEnd; ++i)
+				{
+					rasterizeTile(i);
+				}
+			}
+		);
+
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		m_stats.uNumBatches = static_cast<UINT>(m_aBatches.size());
+		for (const GeometryBatch& batch : m_aBatches)
+		{
+			m_stats.uNumInputTriangles += batch.uNumInputTriangles;
+			m_stats.uNumCulledTriangles += batch.uNumCulledTriangles;
+			m_stats.uNumClippedTriangles += batch.uNumClippedTriangles;
+			m_stats.uNumRasterizedTriangles += static_cast<UINT>(batch.aTriangles.size());
+			m_stats.uNumBinnedTriangles += static_cast<UINT>(batch.aBinnedTriangles.size());
+		}
+		for (size_t i = 0u; i < m_aTileCoveredPixels.size(); ++i)
+		{
+			m_stats.uNumCoveredPixels += m_aTileCoveredPixels[i];
+			m_stats.uNumShadedPixels += m_aTileShadedPixels[i];
+		}
+		m_stats.GeometryMilliseconds = std::chrono::duration<FLOAT, std::milli>(binned - start).count();
+		m_stats.RasterMilliseconds = std::chrono::duration<FLOAT, std::milli>(end - binned).count();
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::GetWidth
+
+	  Summary:  Returns the width of the targets
+
+	  Returns:  UINT
+				  Width in pixels
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT SoftwareRasterizer::GetWidth() const
+	{
+		return m_uWidth;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::GetHeight
+
+	  Summary:  Returns the height of the targets
+
+	  Returns:  UINT
+				  Height in pixels
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT SoftwareRasterizer::GetHeight() const
+	{
+		return m_uHeight;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::GetPixel
+
+	  Summary:  Returns a pixel of the color target
+
+	  Args:     UINT uX
+				  Column, from the left
+				UINT uY
+				  Row, from the top
+
+	  Returns:  UINT
+				  RGBA8 color, 0 outside of the target
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT SoftwareRasterizer::GetPixel(_In_ UINT uX, _In_ UINT uY) const
+	{
+		if (uX >= m_uWidth || uY >= m_uHeight)
+		{
+			return 0u;
+		}
+
+		return m_aColors[static_cast<size_t>(uY) * m_uPitch + uX];
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::GetDepth
+
+	  Summary:  Returns a depth of the depth target
+
+	  Args:     UINT uX
+				  Column, from the left
+				UINT uY
+				  Row, from the top
+
+	  Returns:  FLOAT
+				  Depth, 1 outside of the target
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	FLOAT SoftwareRasterizer::GetDepth(_In_ UINT uX, _In_ UINT uY) const
+	{
+		if (uX >= m_uWidth || uY >= m_uHeight)
+		{
+			return 1.0f;
+		}
+
+		return m_aDepths[static_cast<size_t>(uY) * m_uPitch + uX];
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::ReadPixels
+
+	  Summary:  Copies the color target without its padding, row by
+				row from the top
+
+	  Args:     std::vector<UINT>& aOutPixels
+				  Receives Width * Height RGBA8 colors
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SoftwareRasterizer::ReadPixels(_Out_ std::vector<UINT>& aOutPixels) const
+	{
+		aOutPixels.resize(static_cast<size_t>(m_uWidth) * m_uHeight);
+		for (UINT y = 0u; y < m_uHeight; ++y)
+		{
+			const auto row = m_aColors.begin() + static_cast<ptrdiff_t>(y) * m_uPitch;
+			std::copy(row, row + m_uWidth, aOutPixels.begin() + static_cast<ptrdiff_t>(y) * m_uWidth);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::GetStats
+
+	  Summary:  Returns the work done by the last Render
+
+	  Returns:  const SoftwareRasterStats&
+				  Counts and timings
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const SoftwareRasterStats& SoftwareRasterizer::GetStats() const
+	{
+		return m_stats;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::CountDifferentPixels
+
+	  Summary:  Compares the color target with a reference image, as
+				a golden image test would
+
+	  Args:     const std::vector<UINT>& aReference
+				  Width * Height RGBA8 colors, as ReadPixels returns
+				UINT uTolerance
+				  Largest difference of a channel still counted as
+				  the same
+
+	  Returns:  UINT
+				  Number of pixels with a channel differing by more
+				  than the tolerance, every pixel if the sizes differ
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT SoftwareRasterizer::CountDifferentPixels(_In_ const std::vector<UINT>& aReference, _In_ UINT uTolerance) const
+	{
+		if (aReference.size() != static_cast<size_t>(m_uWidth) * m_uHeight)
+		{
+			return m_uWidth * m_uHeight;
+		}
+
+		UINT uNumDifferent = 0u;
+		for (UINT y = 0u; y < m_uHeight; ++y)
+		{
+			for (UINT x = 0u; x < m_uWidth; ++x)
+			{
+				const UINT uColor = m_aColors[static_cast<size_t>(y) * m_uPitch + x];
+				const UINT uReference = aReference[static_cast<size_t>(y) * m_uWidth + x];
+				for (UINT uShift = 0u; uShift < 32u; uShift += 8u)
+				{
+					const INT iDifference = static_cast<INT>((uColor >> uShift) & 0xFFu) - static_cast<INT>((uReference >> uShift) & 0xFFu);
+					if (static_cast<UINT>(abs(iDifference)) > uTolerance)
+					{
+						++uNumDifferent;
+						break;
+					}
+				}
+			}
+		}
+
+		return uNumDifferent;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::SaveBitmap
+
+	  Summary:  Writes the color target to an uncompressed 32 bit
+				bitmap file, bottom row first
+
+	  Args:     const std::filesystem::path& filePath
+				  Path of the file
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT SoftwareRasterizer::SaveBitmap(_In_ const std::filesystem::path& filePath) const
+	{
+		const DWORD uImageSize = m_uWidth * m_uHeight * 4u;
+
+		BITMAPINFOHEADER infoHeader = {};
+		infoHeader.biSize = sizeof(BITMAPINFOHEADER);
+		infoHeader.biWidth = static_cast<LONG>(m_uWidth);
+		infoHeader.biHeight = static_cast<LONG>(m_uHeight);
+		infoHeader.biPlanes = 1u;
+		infoHeader.biBitCount = 32u;
+		infoHeader.biCompression = BI_RGB;
+		infoHeader.biSizeImage = uImageSize;
+
+		BITMAPFILEHEADER fileHeader = {};
+		fileHeader.bfType = 0x4D42u;
+		fileHeader.bfOffBits = sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER);
+		fileHeader.bfSize = fileHeader.bfOffBits + uImageSize;
+
+		std::ofstream file(filePath, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+		file.write(reinterpret_cast<const char*>(&infoHeader), sizeof(infoHeader));
+
+		std::vector<UINT> aRow(m_uWidth);
+		for (UINT y = m_uHeight; y-- > 0u;)
+		{
+			for (UINT x = 0u; x < m_uWidth; ++x)
+			{
+				// RGBA to BGRA
+				const UINT uColor = m_aColors[static_cast<size_t>(y) * m_uPitch + x];
+				aRow[x] = (uColor & 0xFF00FF00u) | ((uColor & 0xFFu) << 16u) | ((uColor >> 16u) & 0xFFu);
+			}
+			file.write(reinterpret_cast<const char*>(aRow.data()), static_cast<std::streamsize>(aRow.size() * sizeof(UINT)));
+		}
+
+		if (!file)
+		{
+			WCHAR szMessage[256];
+			swprintf_s(szMessage, L"SoftwareRasterizer: could not write %s\n", filePath.c_str());
+			OutputDebugString(szMessage);
+			return E_FAIL;
+		}
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::ReadBitmap
+
+	  Summary:  Reads an uncompressed 32 bit bitmap file, as
+				SaveBitmap writes them, to compare against
+
+	  Args:     const std::filesystem::path& filePath
+				  Path of the file
+				std::vector<UINT>& aOutPixels
+				  Receives the RGBA8 colors, row by row from the top
+				UINT& uOutWidth
+				  Receives the width
+				UINT& uOutHeight
+				  Receives the height
+
+	  Returns:  HRESULT
+				  Status code, E_FAIL for other formats
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT SoftwareRasterizer::ReadBitmap(_In_ const std::filesystem::path& filePath, _Out_ std::vector<UINT>& aOutPixels, _Out_ UINT& uOutWidth, _Out_ UINT& uOutHeight)
+	{
+		aOutPixels.clear();
+		uOutWidth = 0u;
+		uOutHeight = 0u;
+
+		BITMAPFILEHEADER fileHeader = {};
+		BITMAPINFOHEADER infoHeader = {};
+
+		std::ifstream file(filePath, std::ios::binary);
+		file.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader));
+		file.read(reinterpret_cast<char*>(&infoHeader), sizeof(infoHeader));
+		if (!file
+			|| fileHeader.bfType != 0x4D42u
+			|| infoHeader.biBitCount != 32u
+			|| infoHeader.biCompression != BI_RGB
+			|| infoHeader.biWidth <= 0
+			|| infoHeader.biHeight == 0)
+		{
+			WCHAR szMessage[256];
+			swprintf_s(szMessage, L"SoftwareRasterizer: %s is not a 32 bit bitmap\n", filePath.c_str());
+			OutputDebugString(szMessage);
+			return E_FAIL;
+		}
+
+		// Negative heights are stored top row first
+		const BOOL bIsTopDown = infoHeader.biHeight < 0;
+		const UINT uWidth = static_cast<UINT>(infoHeader.biWidth);
+		const UINT uHeight = static_cast<UINT>(bIsTopDown ? -infoHeader.biHeight : infoHeader.biHeight);
+
+		aOutPixels.resize(static_cast<size_t>(uWidth) * uHeight);
+		file.seekg(fileHeader.bfOffBits);
+		for (UINT uRow = 0u; uRow < uHeight; ++uRow)
+		{
+			UINT* pRow = aOutPixels.data() + static_cast<size_t>(bIsTopDown ? uRow : uHeight - 1u - uRow) * uWidth;
+			file.read(reinterpret_cast<char*>(pRow), static_cast<std::streamsize>(uWidth * sizeof(UINT)));
+			for (UINT x = 0u; x < uWidth; ++x)
+			{
+				pRow[x] = (pRow[x] & 0xFF00FF00u) | ((pRow[x] & 0xFFu) << 16u) | ((pRow[x] >> 16u) & 0xFFu);
+			}
+		}
+
+		if (!file)
+		{
+			aOutPixels.clear();
+			return E_FAIL;
+		}
+
+		uOutWidth = uWidth;
+		uOutHeight = uHeight;
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::PackColor
+
+	  Summary:  Packs a color as an R8G8B8A8_UNORM target stores it
+
+	  Args:     FXMVECTOR color
+				  Color, saturated before it is packed
+
+	  Returns:  UINT
+				  Red in the lowest byte, alpha in the highest
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT SoftwareRasterizer::PackColor(_In_ FXMVECTOR color)
+	{
+		XMFLOAT4 scaled;
+		XMStoreFloat4(&scaled, XMVectorRound(XMVectorScale(XMVectorSaturate(color), 255.0f)));
+
+		return static_cast<UINT>(scaled.x)
+			| (static_cast<UINT>(scaled.y) << 8u)
+			| (static_cast<UINT>(scaled.z) << 16u)
+			| (static_cast<UINT>(scaled.w) << 24u);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::splitWork
+
+	  Summary:  Splits the draws into work items of about
+				TRIANGLES_PER_ITEM triangles, large draws by index
+				range and small instanced draws by instance range,
+				then groups neighbouring items into batches. The
+				split only depends on the draws.
+
+	  Modifies: [m_aWorkItems, m_aBatches].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SoftwareRasterizer::splitWork()
+	{
+		m_aWorkItems.clear();
+
+		for (UINT uDraw = 0u; uDraw < static_cast<UINT>(m_aDraws.size()); ++uDraw)
+		{
+			const SoftwareDraw& draw = m_aDraws[uDraw];
+			const UINT uNumTriangles = draw.uNumIndices / 3u;
+			const UINT uNumInstances = draw.pInstances ? draw.uNumInstances : 1u;
+			if (uNumTriangles == 0u || uNumInstances == 0u || !draw.pVertices || !draw.pIndices)
+			{
+				continue;
+			}
+
+			if (uNumTriangles >= TRIANGLES_PER_ITEM)
+			{
+				for (UINT uInstance = 0u; uInstance < uNumInstances; ++uInstance)
+				{
+					for (UINT uFirst = 0u; uFirst < uNumTriangles; uFirst += TRIANGLES_PER_ITEM)
+					{
+						m_aWorkItems.push_back({ uDraw, uInstance, 1u, uFirst * 3u, std::min(TRIANGLES_PER_ITEM, uNumTriangles - uFirst) * 3u });
+					}
+				}
+			}
+			else
+			{
+				const UINT uInstancesPerItem = TRIANGLES_PER_ITEM / uNumTriangles;
+				for (UINT uInstance = 0u; uInstance < uNumInstances; uInstance += uInstancesPerItem)
+				{
+					m_aWorkItems.push_back({ uDraw, uInstance, std::min(uInstancesPerItem, uNumInstances - uInstance), 0u, uNumTriangles * 3u });
+				}
+			}
+		}
+
+		UINT uNumBatches = 0u;
+		UINT uNumBatchTriangles = 0u;
+		for (UINT i = 0u; i < static_cast<UINT>(m_aWorkItems.size()); ++i)
+		{
+			const UINT uNumItemTriangles = m_aWorkItems[i].uNumInstances * (m_aWorkItems[i].uNumIndices / 3u);
+			if (uNumBatches == 0u || uNumBatchTriangles + uNumItemTriangles > TRIANGLES_PER_ITEM)
+			{
+				if (m_aBatches.size() <= uNumBatches)
+				{
+					m_aBatches.emplace_back();
+				}
+				m_aBatches[uNumBatches].uFirstItem = i;
+				++uNumBatches;
+				uNumBatchTriangles = 0u;
+			}
+
+			m_aBatches[uNumBatches - 1u].uEndItem = i + 1u;
+			uNumBatchTriangles += uNumItemTriangles;
+		}
+
+		m_aBatches.resize(uNumBatches);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::processBatch
+
+	  Summary:  Runs the vertex stage of the items of a batch, as
+				VSPhong and VSVoxel do, transforming every vertex once
+				per instance. Triangles outside of a side of the view
+				volume are rejected, triangles reaching behind the
+				near plane or out of the guard band are clipped, the
+				rest are set up directly.
+
+	  Args:     GeometryBatch& batch
+				  The batch
+
+	  Modifies: [batch].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SoftwareRasterizer::processBatch(_Inout_ GeometryBatch& batch)
+	{
+		batch.aTriangles.clear();
+		batch.uNumInputTriangles = 0u;
+		batch.uNumCulledTriangles = 0u;
+		batch.uNumClippedTriangles = 0u;
+
+		const XMMATRIX viewProjection = XMMatrixMultiply(m_view, m_projection);
+
+		// Vertices transformed for the current instance carry its stamp
+		std::fill(batch.aVertexStamps.begin(), batch.aVertexStamps.end(), 0u);
+		UINT uStamp = 0u;
+
+		for (UINT uItem = batch.uFirstItem; uItem < batch.uEndItem; ++uItem)
+		{
+			const WorkItem& item = m_aWorkItems[uItem];
+			const SoftwareDraw& draw = m_aDraws[item.uDraw];
+			if (batch.aVertices.size() < draw.uNumVertices)
+			{
+				batch.aVertices.resize(draw.uNumVertices);
+				batch.aVertexStamps.resize(draw.uNumVertices, 0u);
+			}
+
+			for (UINT uInstance = item.uFirstInstance; uInstance < item.uFirstInstance + item.uNumInstances; ++uInstance)
+			{
+				++uStamp;
+				const XMMATRIX world = draw.pInstances ? XMMatrixMultiply(draw.pInstances[uInstance].Transformation, draw.World) : draw.World;
+				const XMMATRIX worldViewProjection = XMMatrixMultiply(world, viewProjection);
+
+				auto getVertex = [&](WORD uIndex) -> const ShadedVertex*
+				{
+					const UINT uVertex = draw.uBaseVertex + uIndex;
+					if (uVertex >= draw.uNumVertices)
+					{
+						return nullptr;
+					}
+
+					ShadedVertex& vertex = batch.aVertices[uVertex];
+					if (batch.aVertexStamps[uVertex] != uStamp)
+					{
+						batch.aVertexStamps[uVertex] = uStamp;
+
+						const SimpleVertex& input = draw.pVertices[uVertex];
+						const XMVECTOR position = XMVectorSet(input.Position.x, input.Position.y, input.Position.z, 1.0f);
+						XMStoreFloat4(&vertex.Position, XMVector4Transform(position, worldViewProjection));
+						XMStoreFloat3(&vertex.WorldPosition, XMVector4Transform(position, world));
+
+						// VSVoxel transforms its normal as a point by the voxel world matrix alone
+						const XMVECTOR normal = draw.Shading == eSoftwareShading::VOXEL
+							? XMVector3Normalize(XMVector4Transform(XMVectorSet(input.Normal.x, input.Normal.y, input.Normal.z, 1.0f), draw.World))
+							: XMVector4Transform(XMVectorSet(input.Normal.x, input.Normal.y, input.Normal.z, 0.0f), world);
+						XMStoreFloat3(&vertex.Normal, normal);
+					}
+
+					return &vertex;
+				};
+
+				for (UINT uIndex = item.uFirstIndex; uIndex + 2u < item.uFirstIndex + item.uNumIndices; uIndex += 3u)
+				{
+					++batch.uNumInputTriangles;
+
+					const ShadedVertex* pV0 = getVertex(draw.pIndices[uIndex]);
+					const ShadedVertex* pV1 = getVertex(draw.pIndices[uIndex + 1u]);
+					const ShadedVertex* pV2 = getVertex(draw.pIndices[uIndex + 2u]);
+					if (!pV0 || !pV1 || !pV2
+						|| (getOutCode(pV0->Position) & getOutCode(pV1->Position) & getOutCode(pV2->Position)) != 0u)
+					{
+						++batch.uNumCulledTriangles;
+						continue;
+					}
+
+					if (isInsideGuardBand(pV0->Position) && isInsideGuardBand(pV1->Position) && isInsideGuardBand(pV2->Position))
+					{
+						setupTriangle(batch, *pV0, *pV1, *pV2, item.uDraw);
+					}
+					else
+					{
+						++batch.uNumClippedTriangles;
+						clipTriangle(batch, *pV0, *pV1, *pV2, item.uDraw);
+					}
+				}
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::setupTriangle
+
+	  Summary:  Projects a triangle to snapped screen coordinates,
+				culls it when it is a back face, clockwise being the
+				front as in the default rasterizer state, and sets up
+				its edge functions and bounding box
+
+	  Args:     GeometryBatch& batch
+				  Batch the triangle is added to
+				const ShadedVertex& v0
+				  First vertex
+				const ShadedVertex& v1
+				  Second vertex
+				const ShadedVertex& v2
+				  Third vertex
+				UINT uDraw
+				  Draw of the triangle
+
+	  Modifies: [batch].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SoftwareRasterizer::setupTriangle(_Inout_ GeometryBatch& batch, _In_ const ShadedVertex& v0, _In_ const ShadedVertex& v1, _In_ const ShadedVertex& v2, _In_ UINT uDraw)
+	{
+		const ShadedVertex* apVertices[3] = { &v0, &v1, &v2 };
+
+		RasterTriangle triangle;
+		FLOAT aX[3];
+		FLOAT aY[3];
+		for (UINT i = 0u; i < 3u; ++i)
+		{
+			const XMFLOAT4& position = apVertices[i]->Position;
+			if (position.w <= 0.0f)
+			{
+				++batch.uNumCulledTriangles;
+				return;
+			}
+
+			const FLOAT invW = 1.0f / position.w;
+			aX[i] = roundf((position.x * invW * 0.5f + 0.5f) * static_cast<FLOAT>(m_uWidth) * SUBPIXEL_STEPS) / SUBPIXEL_STEPS;
+			aY[i] = roundf((-position.y * invW * 0.5f + 0.5f) * static_cast<FLOAT>(m_uHeight) * SUBPIXEL_STEPS) / SUBPIXEL_STEPS;
+			triangle.aDepth[i] = position.z * invW;
+			triangle.aInvW[i] = invW;
+			triangle.aWorldPositions[i] = apVertices[i]->WorldPosition;
+			triangle.aNormals[i] = apVertices[i]->Normal;
+		}
+
+		const FLOAT area = (aX[1] - aX[0]) * (aY[2] - aY[0]) - (aX[2] - aX[0]) * (aY[1] - aY[0]);
+		if (!(area > 0.0f))
+		{
+			++batch.uNumCulledTriangles;
+			return;
+		}
+
+		// Pixels whose centers are inside of the bounds
+		triangle.iMinX = std::max(0, static_cast<INT>(ceilf(std::min({ aX[0], aX[1], aX[2] }) - 0.5f)));
+		triangle.iMinY = std::max(0, static_cast<INT>(ceilf(std::min({ aY[0], aY[1], aY[2] }) - 0.5f)));
+		triangle.iMaxX = std::min(static_cast<INT>(m_uWidth), static_cast<INT>(floorf(std::max({ aX[0], aX[1], aX[2] }) - 0.5f)) + 1);
+		triangle.iMaxY = std::min(static_cast<INT>(m_uHeight), static_cast<INT>(floorf(std::max({ aY[0], aY[1], aY[2] }) - 0.5f)) + 1);
+		if (triangle.iMinX >= triangle.iMaxX || triangle.iMinY >= triangle.iMaxY)
+		{
+			return;
+		}
+
+		for (UINT i = 0u; i < 3u; ++i)
+		{
+			const UINT j = (i + 1u) % 3u;
+			const UINT k = (i + 2u) % 3u;
+
+			// Positive inside and equal to the area at vertex i. Taking
+			// the lower endpoint as the origin makes the neighbour across
+			// the edge compute exactly the negated value.
+			const UINT uOrigin = aX[j] < aX[k] || (aX[j] == aX[k] && aY[j] < aY[k]) ? j : k;
+			triangle.aEdgeA[i] = -(aY[k] - aY[j]);
+			triangle.aEdgeB[i] = aX[k] - aX[j];
+			triangle.aEdgeX[i] = aX[uOrigin];
+			triangle.aEdgeY[i] = aY[uOrigin];
+			triangle.abTopLeft[i] = triangle.aEdgeA[i] > 0.0f || (triangle.aEdgeA[i] == 0.0f && triangle.aEdgeB[i] > 0.0f);
+		}
+		triangle.fInvArea = 1.0f / area;
+		triangle.uDraw = uDraw;
+
+		batch.aTriangles.push_back(triangle);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::clipTriangle
+
+	  Summary:  Clips a triangle against the near plane and the
+				guard band, then sets up the fan of the polygon left
+
+	  Args:     GeometryBatch& batch
+				  Batch the triangles are added to
+				const ShadedVertex& v0
+				  First vertex
+				const ShadedVertex& v1
+				  Second vertex
+				const ShadedVertex& v2
+				  Third vertex
+				UINT uDraw
+				  Draw of the triangle
+
+	  Modifies: [batch].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SoftwareRasterizer::clipTriangle(_Inout_ GeometryBatch& batch, _In_ const ShadedVertex& v0, _In_ const ShadedVertex& v1, _In_ const ShadedVertex& v2, _In_ UINT uDraw)
+	{
+		ShadedVertex aPolygons[2][MAX_CLIPPED_VERTICES];
+		aPolygons[0][0] = v0;
+		aPolygons[0][1] = v1;
+		aPolygons[0][2] = v2;
+		UINT uNumVertices = 3u;
+		UINT uCurrent = 0u;
+
+		for (const XMFLOAT4& plane : CLIP_PLANES)
+		{
+			const ShadedVertex* aInput = aPolygons[uCurrent];
+			ShadedVertex* aOutput = aPolygons[1u - uCurrent];
+			UINT uNumOutput = 0u;
+
+			for (UINT i = 0u; i < uNumVertices; ++i)
+			{
+				const ShadedVertex& a = aInput[i];
+				const ShadedVertex& b = aInput[(i + 1u) % uNumVertices];
+				const FLOAT distanceA = getClipDistance(plane, a.Position);
+				const FLOAT distanceB = getClipDistance(plane, b.Position);
+
+				if (distanceA >= 0.0f)
+				{
+					aOutput[uNumOutput++] = a;
+				}
+				if ((distanceA >= 0.0f) != (distanceB >= 0.0f))
+				{
+					aOutput[uNumOutput++] = lerpVertex(a, b, distanceA / (distanceA - distanceB));
+				}
+			}
+
+			uNumVertices = uNumOutput;
+			uCurrent = 1u - uCurrent;
+			if (uNumVertices < 3u)
+			{
+				return;
+			}
+		}
+
+		const ShadedVertex* aPolygon = aPolygons[uCurrent];
+		for (UINT i = 1u; i + 1u < uNumVertices; ++i)
+		{
+			setupTriangle(batch, aPolygon[0], aPolygon[i], aPolygon[i + 1u], uDraw);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::binTriangles
+
+	  Summary:  Sorts the triangles of a batch into the tiles their
+				bounds touch, counting first so that the bins are one
+				array. A tile is skipped when an edge is negative at
+				the pixel of the tile it is largest at, with a margin
+				for rounding so no covered pixel is lost.
+
+	  Args:     GeometryBatch& batch
+				  The batch
+
+	  Modifies: [batch].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SoftwareRasterizer::binTriangles(_Inout_ GeometryBatch& batch) const
+	{
+		const UINT uNumTiles = m_uNumTilesX * m_uNumTilesY;
+
+		auto forEachTile = [this](const RasterTriangle& triangle, auto&& visit)
+		{
+			const INT iTileSize = static_cast<INT>(TILE_SIZE);
+			const INT iFirstTileX = triangle.iMinX / iTileSize;
+			const INT iFirstTileY = triangle.iMinY / iTileSize;
+			const INT iLastTileX = (triangle.iMaxX - 1) / iTileSize;
+			const INT iLastTileY = (triangle.iMaxY - 1) / iTileSize;
+
+			for (INT iTileY = iFirstTileY; iTileY <= iLastTileY; ++iTileY)
+			{
+				for (INT iTileX = iFirstTileX; iTileX <= iLastTileX; ++iTileX)
+				{
+					const UINT uTile = static_cast<UINT>(iTileY) * m_uNumTilesX + static_cast<UINT>(iTileX);
+					if (iFirstTileX == iLastTileX && iFirstTileY == iLastTileY)
+					{
+						visit(uTile);
+						continue;
+					}
+
+					const FLOAT left = static_cast<FLOAT>(std::max(triangle.iMinX, iTileX * iTileSize)) + 0.5f;
+					const FLOAT right = static_cast<FLOAT>(std::min(triangle.iMaxX, (iTileX + 1) * iTileSize) - 1) + 0.5f;
+					const FLOAT top = static_cast<FLOAT>(std::max(triangle.iMinY, iTileY * iTileSize)) + 0.5f;
+					const FLOAT bottom = static_cast<FLOAT>(std::min(triangle.iMaxY, (iTileY + 1) * iTileSize) - 1) + 0.5f;
+
+					BOOL bIsOutside = FALSE;
+					for (UINT i = 0u; i < 3u && !bIsOutside; ++i)
+					{
+						const FLOAT dx = (triangle.aEdgeA[i] >= 0.0f ? right : left) - triangle.aEdgeX[i];
+						const FLOAT dy = (triangle.aEdgeB[i] >= 0.0f ? bottom : top) - triangle.aEdgeY[i];
+						const FLOAT edge = triangle.aEdgeA[i] * dx + triangle.aEdgeB[i] * dy;
+						const FLOAT margin = (fabsf(triangle.aEdgeA[i] * dx) + fabsf(triangle.aEdgeB[i] * dy)) * 1e-5f;
+						bIsOutside = edge < -margin;
+					}
+
+					if (!bIsOutside)
+					{
+						visit(uTile);
+					}
+				}
+			}
+		};
+
+		batch.aTileOffsets.assign(uNumTiles + 1u, 0u);
+		for (const RasterTriangle& triangle : batch.aTriangles)
+		{
+			forEachTile(triangle, [&batch](UINT uTile) { ++batch.aTileOffsets[uTile]; });
+		}
+
+		UINT uNumBinned = 0u;
+		for (UINT uTile = 0u; uTile <= uNumTiles; ++uTile)
+		{
+			const UINT uCount = batch.aTileOffsets[uTile];
+			batch.aTileOffsets[uTile] = uNumBinned;
+			uNumBinned += uCount;
+		}
+
+		// Offsets move to the end of their bin while filling, then back
+		batch.aBinnedTriangles.resize(uNumBinned);
+		for (UINT uTriangle = 0u; uTriangle < static_cast<UINT>(batch.aTriangles.size()); ++uTriangle)
+		{
+			forEachTile(batch.aTriangles[uTriangle], [&batch, uTriangle](UINT uTile) { batch.aBinnedTriangles[batch.aTileOffsets[uTile]++] = uTriangle; });
+		}
+		for (UINT uTile = uNumTiles; uTile > 0u; --uTile)
+		{
+			batch.aTileOffsets[uTile] = batch.aTileOffsets[uTile - 1u];
+		}
+		batch.aTileOffsets[0] = 0u;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::rasterizeTile
+
+	  Summary:  Rasterizes the triangles binned into a tile, batch
+				by batch, four pixels of a row at a time. A pixel is
+				covered when its center is inside of every edge or on
+				a top or left one. Covered pixels nearer than the
+				depth target are shaded with perspective correct
+				attributes.
+
+	  Args:     UINT uTile
+				  Index of the tile
+
+	  Modifies: [m_aColors, m_aDepths, m_aTileCoveredPixels,
+				 m_aTileShadedPixels].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void SoftwareRasterizer::rasterizeTile(_In_ UINT uTile)
+	{
+		const INT iTileX = static_cast<INT>((uTile % m_uNumTilesX) * TILE_SIZE);
+		const INT iTileY = static_cast<INT>((uTile / m_uNumTilesX) * TILE_SIZE);
+		const XMVECTOR laneOffsets = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+		const XMVECTOR zero = XMVectorZero();
+
+		UINT64 uNumCovered = 0ull;
+		UINT64 uNumShaded = 0ull;
+
+		for (const GeometryBatch& batch : m_aBatches)
+		{
+			for (UINT uBin = batch.aTileOffsets[uTile]; uBin < batch.aTileOffsets[uTile + 1u]; ++uBin)
+			{
+				const RasterTriangle& triangle = batch.aTriangles[batch.aBinnedTriangles[uBin]];
+				const SoftwareDraw& draw = m_aDraws[triangle.uDraw];
+
+				const INT iMinX = std::max(triangle.iMinX, iTileX);
+				const INT iMaxX = std::min(triangle.iMaxX, iTileX + static_cast<INT>(TILE_SIZE));
+				const INT iMinY = std::max(triangle.iMinY, iTileY);
+				const INT iMaxY = std::min(triangle.iMaxY, iTileY + static_cast<INT>(TILE_SIZE));
+
+				XMVECTOR aEdgeA[3];
+				XMVECTOR aEdgeB[3];
+				XMVECTOR aEdgeX[3];
+				XMVECTOR aTopLeft[3];
+				XMVECTOR aWorldPositions[3];
+				XMVECTOR aNormals[3];
+				for (UINT i = 0u; i < 3u; ++i)
+				{
+					aEdgeA[i] = XMVectorReplicate(triangle.aEdgeA[i]);
+					aEdgeB[i] = XMVectorReplicate(triangle.aEdgeB[i]);
+					aEdgeX[i] = XMVectorReplicate(triangle.aEdgeX[i]);
+					aTopLeft[i] = triangle.abTopLeft[i] ? XMVectorTrueInt() : XMVectorFalseInt();
+					aWorldPositions[i] = XMLoadFloat3(&triangle.aWorldPositions[i]);
+					aNormals[i] = XMLoadFloat3(&triangle.aNormals[i]);
+				}
+				const XMVECTOR invArea = XMVectorReplicate(triangle.fInvArea);
+				const XMVECTOR minX = XMVectorReplicate(static_cast<FLOAT>(iMinX));
+				const XMVECTOR maxX = XMVectorReplicate(static_cast<FLOAT>(iMaxX));
+
+				for (INT y = iMinY; y < iMaxY; ++y)
+				{
+					XMVECTOR aEdgeRow[3];
+					for (UINT i = 0u; i < 3u; ++i)
+					{
+						aEdgeRow[i] = XMVectorReplicate(triangle.aEdgeB[i] * (static_cast<FLOAT>(y) + 0.5f - triangle.aEdgeY[i]));
+					}
+
+					// Rows are padded to whole tiles, so aligned groups never leave the target
+					for (INT x = iMinX & ~3; x < iMaxX; x += 4)
+					{
+						const XMVECTOR centers = XMVectorAdd(XMVectorReplicate(static_cast<FLOAT>(x)), laneOffsets);
+						XMVECTOR coverage = XMVectorAndInt(XMVectorGreater(centers, minX), XMVectorLess(centers, maxX));
+
+						XMVECTOR aEdges[3];
+						for (UINT i = 0u; i < 3u; ++i)
+						{
+							aEdges[i] = XMVectorMultiplyAdd(aEdgeA[i], XMVectorSubtract(centers, aEdgeX[i]), aEdgeRow[i]);
+							const XMVECTOR inside = XMVectorOrInt(XMVectorGreater(aEdges[i], zero), XMVectorAndInt(XMVectorEqual(aEdges[i], zero), aTopLeft[i]));
+							coverage = XMVectorAndInt(coverage, inside);
+						}
+
+						if (XMVector4EqualInt(coverage, XMVectorFalseInt()))
+						{
+							continue;
+						}
+
+						const XMVECTOR weight0 = XMVectorMultiply(aEdges[0], invArea);
+						const XMVECTOR weight1 = XMVectorMultiply(aEdges[1], invArea);
+						const XMVECTOR weight2 = XMVectorMultiply(aEdges[2], invArea);
+						const XMVECTOR depth = XMVectorMultiplyAdd(
+							weight2,
+							XMVectorReplicate(triangle.aDepth[2]),
+							XMVectorMultiplyAdd(weight1, XMVectorReplicate(triangle.aDepth[1]), XMVectorScale(weight0, triangle.aDepth[0]))
+						);
+
+						const size_t uOffset = static_cast<size_t>(y) * m_uPitch + static_cast<size_t>(x);
+						XMFLOAT4* pDepths = reinterpret_cast<XMFLOAT4*>(&m_aDepths[uOffset]);
+						const XMVECTOR target = XMLoadFloat4(pDepths);
+						const XMVECTOR passed = XMVectorAndInt(coverage, XMVectorLess(depth, target));
+						XMStoreFloat4(pDepths, XMVectorSelect(target, depth, passed));
+
+						// Lane masks are stored as raw bits, XMStoreUInt4 would convert them as floats
+						UINT aCoverageMask[4];
+						UINT aPassedMask[4];
+						XMFLOAT4 aWeights[3];
+						XMStoreInt4(aCoverageMask, coverage);
+						XMStoreInt4(aPassedMask, passed);
+						XMStoreFloat4(&aWeights[0], weight0);
+						XMStoreFloat4(&aWeights[1], weight1);
+						XMStoreFloat4(&aWeights[2], weight2);
+
+						for (UINT uLane = 0u; uLane < 4u; ++uLane)
+						{
+							uNumCovered += aCoverageMask[uLane] ? 1ull : 0ull;
+							if (!aPassedMask[uLane])
+							{
+								continue;
+							}
+
+							// Weights divided by w interpolate as the GPU does
+							FLOAT aPerspective[3];
+							for (UINT i = 0u; i < 3u; ++i)
+							{
+								aPerspective[i] = (&aWeights[i].x)[uLane] * triangle.aInvW[i];
+							}
+							const FLOAT invSum = 1.0f / (aPerspective[0] + aPerspective[1] + aPerspective[2]);
+							auto interpolate = [&aPerspective, invSum](const XMVECTOR* aValues)
+							{
+								return XMVectorScale(
+									XMVectorMultiplyAdd(
+										XMVectorReplicate(aPerspective[2]),
+										aValues[2],
+										XMVectorMultiplyAdd(XMVectorReplicate(aPerspective[1]), aValues[1], XMVectorScale(aValues[0], aPerspective[0]))
+									),
+									invSum
+								);
+							};
+
+							m_aColors[uOffset + uLane] = shadePixel(draw, interpolate(aWorldPositions), interpolate(aNormals));
+							++uNumShaded;
+						}
+					}
+				}
+			}
+		}
+
+		m_aTileCoveredPixels[uTile] = uNumCovered;
+		m_aTileShadedPixels[uTile] = uNumShaded;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::shadePixel
+
+	  Summary:  Lights a pixel as PSPhong or PSVoxel does with their
+				textures, normal maps and shadow map left out. Phong
+				lights attenuate with the squared distance, voxel
+				lights do not.
+
+	  Args:     const SoftwareDraw& draw
+				  Draw of the pixel
+				FXMVECTOR worldPosition
+				  Interpolated world position
+				FXMVECTOR normal
+				  Interpolated normal
+
+	  Returns:  UINT
+				  RGBA8 color
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT SoftwareRasterizer::shadePixel(_In_ const SoftwareDraw& draw, _In_ FXMVECTOR worldPosition, _In_ FXMVECTOR normal) const
+	{
+		const XMVECTOR unitNormal = XMVector3Normalize(normal);
+		const XMVECTOR toView = XMVector3Normalize(XMVectorSubtract(XMLoadFloat4(&m_cameraPosition), worldPosition));
+		const XMVECTOR fromLightVector = XMVectorSubtract(worldPosition, XMLoadFloat4(&m_light.Position));
+		const XMVECTOR fromLight = XMVector3Normalize(fromLightVector);
+		const XMVECTOR albedo = XMLoadFloat4(&draw.Albedo);
+
+		XMVECTOR lightColor = XMLoadFloat4(&m_light.Color);
+		if (draw.Shading == eSoftwareShading::PHONG)
+		{
+			const FLOAT sqrDistance = XMVectorGetX(XMVector3LengthSq(fromLightVector));
+			lightColor = XMVectorScale(lightColor, m_light.AttenuationDistance.z / (sqrDistance + ATTENUATION_EPSILON));
+		}
+
+		const FLOAT diffuse = std::max(XMVectorGetX(XMVector3Dot(unitNormal, XMVectorNegate(fromLight))), 0.0f);
+		const FLOAT specular = powf(std::max(XMVectorGetX(XMVector3Dot(XMVector3Reflect(fromLight, unitNormal), toView)), 0.0f), SHININESS);
+		const XMVECTOR light = XMVectorMultiplyAdd(lightColor, XMVectorReplicate(diffuse + specular), XMVectorReplicate(AMBIENT));
+
+		const XMVECTOR color = draw.Shading == eSoftwareShading::PHONG
+			? XMVectorMultiply(XMVectorSetW(light, 1.0f), albedo)
+			: XMVectorSetW(XMVectorMultiply(light, albedo), 1.0f);
+
+		return PackColor(color);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   SoftwareRasterizer::lerpVertex
+
+	  Summary:  Interpolates two clip space vertices linearly, as
+				clipping does
+
+	  Args:     const ShadedVertex& a
+				  Vertex at 0
+				const ShadedVertex& b
+				  Vertex at 1
+				FLOAT t
+				  Position between them
+
+	  Returns:  ShadedVertex
+				  Interpolated vertex
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SoftwareRasterizer::ShadedVertex SoftwareRasterizer::lerpVertex(_In_ const ShadedVertex& a, _In_ const ShadedVertex& b, _In_ FLOAT t)
+	{
+		ShadedVertex vertex;
+		XMStoreFloat4(&vertex.Position, XMVectorLerp(XMLoadFloat4(&a.Position), XMLoadFloat4(&b.Position), t));
+		XMStoreFloat3(&vertex.WorldPosition, XMVectorLerp(XMLoadFloat3(&a.WorldPosition), XMLoadFloat3(&b.WorldPosition), t));
+		XMStoreFloat3(&vertex.Normal, XMVectorLerp(XMLoadFloat3(&a.Normal), XMLoadFloat3(&b.Normal), t));
+
+		return vertex;
+	}
+}
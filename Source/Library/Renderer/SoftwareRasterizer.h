@@ -0,0 +1,296 @@
+/*+===================================================================
+  File:      SOFTWARERASTERIZER.H
+
+  Summary:   SoftwareRasterizer header file contains declarations of
+			 SoftwareDraw struct and SoftwareRasterizer class that
+			 draws scenes on the CPU, binned into screen tiles that
+			 are rasterized on the job system, so the output of the
+			 renderer can be checked and measured without a GPU.
+
+  Classes: SoftwareRasterizer
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Job/JobSystem.h"
+#include "Renderer/DataTypes.h"
+#include "Renderer/Renderable.h"
+#include "Scene/Scene.h"
+
+namespace library
+{
+	/*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+	  Enum:     eSoftwareShading
+
+	  Summary:  Pixel shaders a software draw is shaded with, ports of
+				PSPhong and PSVoxel
+	E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+	enum class eSoftwareShading : UINT
+	{
+		PHONG = 0,
+		VOXEL,
+		COUNT,
+	};
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+	  Struct:   SoftwareDraw
+
+	  Summary:  An indexed draw of system memory vertices, instanced
+				when it has instance data. Textures are not sampled,
+				Albedo stands in for the diffuse texture.
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct SoftwareDraw
+	{
+		XMMATRIX World;
+		XMFLOAT4 Albedo;
+		const SimpleVertex* pVertices;
+		UINT uNumVertices;
+		const WORD* pIndices;
+		UINT uNumIndices;
+		UINT uBaseVertex;
+		const InstanceData* pInstances;
+		UINT uNumInstances;
+		eSoftwareShading Shading;
+	};
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+	  Struct:   SoftwareRasterStats
+
+	  Summary:  Work done by the last Render, triangles counted per
+				instance
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct SoftwareRasterStats
+	{
+		UINT uNumDraws;
+		UINT uNumBatches;
+		UINT uNumInputTriangles;
+		UINT uNumCulledTriangles;
+		UINT uNumClippedTriangles;
+		UINT uNumRasterizedTriangles;
+		UINT uNumBinnedTriangles;
+		UINT64 uNumCoveredPixels;
+		UINT64 uNumShadedPixels;
+		FLOAT GeometryMilliseconds;
+		FLOAT RasterMilliseconds;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    SoftwareRasterizer
+
+	  Summary:  Draws indexed triangles into a color and a depth
+				target in system memory. Render runs in two passes on
+				the job system. The geometry pass splits the draws
+				into batches that transform their vertices, clip to
+				the near plane, cull back faces and bin the triangles
+				into the screen tiles they touch, each batch into its
+				own bins. The raster pass then walks every tile on its
+				own, the bins of the batches in order, evaluating the
+				edge functions for four pixels at a time, testing
+				depth and shading the pixels that pass. A tile sees
+				its triangles in submission order whatever thread
+				binned them, so the image does not depend on the
+				number of workers. Edges follow the top-left rule
+				with snapped vertices, so pixels on a shared edge are
+				drawn exactly once.
+
+	  Methods:  Initialize
+				  Creates the targets
+				SetCamera
+				  Sets the view, projection and camera position
+				SetLight
+				  Sets the point light
+				Reset
+				  Removes every draw
+				AddDraw
+				  Adds a draw
+				AddRenderable
+				  Adds a draw per mesh of a renderable
+				AddScene
+				  Adds the renderables, voxels and models of a scene
+				  and sets its light
+				Clear
+				  Clears the color and depth targets
+				Render
+				  Draws every added draw into the targets
+				GetWidth
+				  Returns the width of the targets
+				GetHeight
+				  Returns the height of the targets
+				GetPixel
+				  Returns a pixel of the color target
+				GetDepth
+				  Returns a depth of the depth target
+				ReadPixels
+				  Copies the color target
+				GetStats
+				  Returns the work done by the last Render
+				CountDifferentPixels
+				  Compares the color target with a reference image
+				SaveBitmap
+				  Writes the color target to a bitmap file
+				ReadBitmap
+				  Reads a bitmap file SaveBitmap wrote
+				PackColor
+				  Packs a color into an RGBA8 pixel
+				SoftwareRasterizer
+				  Constructor.
+				~SoftwareRasterizer
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class SoftwareRasterizer final
+	{
+	public:
+		static constexpr UINT TILE_SIZE = 32u;
+
+		// Instances times triangles of a unit of geometry work
+		static constexpr UINT TRIANGLES_PER_ITEM = 4096u;
+
+		// Vertices are snapped to 1/256 of a pixel, as on the GPU
+		static constexpr FLOAT SUBPIXEL_STEPS = 256.0f;
+
+		// Ambient term of the ported pixel shaders
+		static constexpr FLOAT AMBIENT = 0.1f;
+
+	public:
+		SoftwareRasterizer();
+		SoftwareRasterizer(const SoftwareRasterizer& other) = delete;
+		SoftwareRasterizer(SoftwareRasterizer&& other) = delete;
+		SoftwareRasterizer& operator=(const SoftwareRasterizer& other) = delete;
+		SoftwareRasterizer& operator=(SoftwareRasterizer&& other) = delete;
+		~SoftwareRasterizer() = default;
+
+		HRESULT Initialize(_In_ UINT uWidth, _In_ UINT uHeight);
+		void SetCamera(_In_ FXMMATRIX view, _In_ CXMMATRIX projection, _In_ const XMVECTOR& cameraPosition);
+		void SetLight(_In_ const PointLightData& light);
+
+		void Reset();
+		void AddDraw(_In_ const SoftwareDraw& draw);
+		void AddRenderable(_In_ const Renderable& renderable, _In_ eSoftwareShading shading, _In_opt_ const InstanceData* pInstances, _In_ UINT uNumInstances);
+		void AddScene(_In_ Scene& scene);
+
+		void Clear(_In_ const XMFLOAT4& color);
+		HRESULT Render();
+
+		UINT GetWidth() const;
+		UINT GetHeight() const;
+		UINT GetPixel(_In_ UINT uX, _In_ UINT uY) const;
+		FLOAT GetDepth(_In_ UINT uX, _In_ UINT uY) const;
+		void ReadPixels(_Out_ std::vector<UINT>& aOutPixels) const;
+		const SoftwareRasterStats& GetStats() const;
+		UINT CountDifferentPixels(_In_ const std::vector<UINT>& aReference, _In_ UINT uTolerance) const;
+
+		HRESULT SaveBitmap(_In_ const std::filesystem::path& filePath) const;
+		static HRESULT ReadBitmap(_In_ const std::filesystem::path& filePath, _Out_ std::vector<UINT>& aOutPixels, _Out_ UINT& uOutWidth, _Out_ UINT& uOutHeight);
+
+		static UINT PackColor(_In_ FXMVECTOR color);
+
+	private:
+		/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		  Struct:   ShadedVertex
+
+		  Summary:  Output of the vertex stage, in clip space
+		S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+		struct ShadedVertex
+		{
+			XMFLOAT4 Position;
+			XMFLOAT3 WorldPosition;
+			XMFLOAT3 Normal;
+		};
+
+		/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		  Struct:   RasterTriangle
+
+		  Summary:  A triangle set up for rasterization. Edge i is the
+					edge opposite vertex i, evaluated relative to its
+					lower endpoint so that both triangles of a shared
+					edge get exactly opposite values.
+		S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+		struct RasterTriangle
+		{
+			FLOAT aEdgeA[3];
+			FLOAT aEdgeB[3];
+			FLOAT aEdgeX[3];
+			FLOAT aEdgeY[3];
+			BOOL abTopLeft[3];
+			FLOAT fInvArea;
+			FLOAT aDepth[3];
+			FLOAT aInvW[3];
+			XMFLOAT3 aWorldPositions[3];
+			XMFLOAT3 aNormals[3];
+			INT iMinX;
+			INT iMinY;
+			INT iMaxX;
+			INT iMaxY;
+			UINT uDraw;
+		};
+
+		/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		  Struct:   WorkItem
+
+		  Summary:  Instances and an index range of a draw, processed
+					by one batch of the geometry pass
+		S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+		struct WorkItem
+		{
+			UINT uDraw;
+			UINT uFirstInstance;
+			UINT uNumInstances;
+			UINT uFirstIndex;
+			UINT uNumIndices;
+		};
+
+		/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		  Struct:   GeometryBatch
+
+		  Summary:  Work items of the geometry pass run as one job, the
+					triangles they set up and their tile bins, stored
+					as a triangle list per tile in TileOffsets order
+		S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+		struct GeometryBatch
+		{
+			UINT uFirstItem;
+			UINT uEndItem;
+			std::vector<RasterTriangle> aTriangles;
+			std::vector<UINT> aTileOffsets;
+			std::vector<UINT> aBinnedTriangles;
+			std::vector<ShadedVertex> aVertices;
+			std::vector<UINT> aVertexStamps;
+			UINT uNumInputTriangles;
+			UINT uNumCulledTriangles;
+			UINT uNumClippedTriangles;
+		};
+
+	private:
+		void splitWork();
+		void processBatch(_Inout_ GeometryBatch& batch);
+		void setupTriangle(_Inout_ GeometryBatch& batch, _In_ const ShadedVertex& v0, _In_ const ShadedVertex& v1, _In_ const ShadedVertex& v2, _In_ UINT uDraw);
+		void clipTriangle(_Inout_ GeometryBatch& batch, _In_ const ShadedVertex& v0, _In_ const ShadedVertex& v1, _In_ const ShadedVertex& v2, _In_ UINT uDraw);
+		void binTriangles(_Inout_ GeometryBatch& batch) const;
+		void rasterizeTile(_In_ UINT uTile);
+		UINT shadePixel(_In_ const SoftwareDraw& draw, _In_ FXMVECTOR worldPosition, _In_ FXMVECTOR normal) const;
+
+		static ShadedVertex lerpVertex(_In_ const ShadedVertex& a, _In_ const ShadedVertex& b, _In_ FLOAT t);
+
+	private:
+		XMMATRIX m_view;
+		XMMATRIX m_projection;
+		XMFLOAT4 m_cameraPosition;
+		PointLightData m_light;
+		UINT m_uWidth;
+		UINT m_uHeight;
+		UINT m_uNumTilesX;
+		UINT m_uNumTilesY;
+		UINT m_uPitch;
+		std::vector<UINT> m_aColors;
+		std::vector<FLOAT> m_aDepths;
+		std::vector<SoftwareDraw> m_aDraws;
+		std::vector<WorkItem> m_aWorkItems;
+		std::vector<GeometryBatch> m_aBatches;
+		std::vector<UINT64> m_aTileCoveredPixels;
+		std::vector<UINT64> m_aTileShadedPixels;
+		SoftwareRasterStats m_stats;
+	};
+}
@@ -0,0 +1,746 @@
+/*+===================================================================
+  File:      STATECACHE.H
+
+  Summary:   StateCache header file contains declarations of
+			 BasicStateCache class template that drops pipeline state
+			 binds which would not change what is bound.
+
+  Classes: BasicStateCache<ContextType>
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Portable.h"
+
+#include "Renderer/RenderDevice.h"
+
+namespace library
+{
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    BasicStateCache
+
+	  Summary:  Wraps a device context and remembers the shaders,
+				input layout, topology, vertex and index buffers,
+				constant buffers, shader resource views and samplers
+				it bound. A bind of exactly what is already bound is
+				dropped, anything else is forwarded to the context.
+				Slots start out unknown and become unknown again on
+				Invalidate, which must be called whenever something
+				else may have bound state on the context. The context
+				is a template argument so any type with the same
+				methods, such as a counting context, can stand in.
+
+	  Methods:  SetContext
+				  Sets the wrapped context and invalidates the cache
+				GetContext
+				  Returns the wrapped context
+				Invalidate
+				  Forgets every bound state
+				InvalidateConstantBuffers
+				  Forgets the constant buffers of some slots
+				IASetInputLayout
+				  Binds an input layout
+				IASetVertexBuffers
+				  Binds vertex buffers
+				IASetIndexBuffer
+				  Binds an index buffer
+				IASetPrimitiveTopology
+				  Sets the primitive topology
+				VSSetShader
+				  Binds a vertex shader
+				PSSetShader
+				  Binds a pixel shader
+				VSSetConstantBuffers
+				  Binds vertex shader constant buffers
+				PSSetConstantBuffers
+				  Binds pixel shader constant buffers
+				VSSetShaderResources
+				  Binds vertex shader resource views
+				PSSetShaderResources
+				  Binds pixel shader resource views
+				PSSetSamplers
+				  Binds pixel shader samplers
+				GetNumForwardedCalls
+				  Returns the binds forwarded to the context
+				GetNumFilteredCalls
+				  Returns the binds dropped as redundant
+				ResetCounters
+				  Zeroes the forwarded and filtered counts
+				BasicStateCache
+				  Constructor.
+				~BasicStateCache
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	template <class ContextType>
+	class BasicStateCache final
+	{
+	public:
+		static constexpr UINT MAX_VERTEX_BUFFERS = 8u;
+		static constexpr UINT MAX_CONSTANT_BUFFERS = 14u;
+		static constexpr UINT MAX_SHADER_RESOURCES = 16u;
+		static constexpr UINT MAX_SAMPLERS = 16u;
+
+	public:
+		BasicStateCache();
+		BasicStateCache(const BasicStateCache& other) = delete;
+		BasicStateCache(BasicStateCache&& other) = delete;
+		BasicStateCache& operator=(const BasicStateCache& other) = delete;
+		BasicStateCache& operator=(BasicStateCache&& other) = delete;
+		~BasicStateCache() = default;
+
+		void SetContext(_In_opt_ ContextType* pContext);
+		ContextType* GetContext() const;
+		void Invalidate();
+		void InvalidateConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers);
+
+		void IASetInputLayout(_In_opt_ GpuInputLayout* pInputLayout);
+		void IASetVertexBuffers(
+			_In_ UINT uStartSlot,
+			_In_ UINT uNumBuffers,
+			_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppVertexBuffers,
+			_In_reads_opt_(uNumBuffers) const UINT* puStrides,
+			_In_reads_opt_(uNumBuffers) const UINT* puOffsets
+		);
+		void IASetIndexBuffer(_In_opt_ GpuBuffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset);
+		void IASetPrimitiveTopology(_In_ ePrimitiveTopology topology);
+
+		void VSSetShader(_In_opt_ GpuVertexShader* pVertexShader);
+		void PSSetShader(_In_opt_ GpuPixelShader* pPixelShader);
+
+		void VSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers);
+		void PSSetConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers, _In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers);
+		void VSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuShaderResourceView* const* ppShaderResourceViews);
+		void PSSetShaderResources(_In_ UINT uStartSlot, _In_ UINT uNumViews, _In_reads_opt_(uNumViews) GpuShaderResourceView* const* ppShaderResourceViews);
+		void PSSetSamplers(_In_ UINT uStartSlot, _In_ UINT uNumSamplers, _In_reads_opt_(uNumSamplers) GpuSamplerState* const* ppSamplers);
+
+		UINT GetNumForwardedCalls() const;
+		UINT GetNumFilteredCalls() const;
+		void ResetCounters();
+
+	private:
+		struct VertexBufferSlot
+		{
+			GpuBuffer* pBuffer;
+			UINT uStride;
+			UINT uOffset;
+
+			bool operator==(const VertexBufferSlot& other) const = default;
+		};
+
+		template <class SlotType>
+		BOOL isBound(
+			_In_ UINT uStartSlot,
+			_In_ UINT uNumSlots,
+			_In_reads_(uNumSlots) const SlotType* aSlots,
+			_Inout_updates_(uMaxSlots) SlotType* aBoundSlots,
+			_In_ UINT uMaxSlots,
+			_Inout_ UINT& uKnownSlots
+		);
+		BOOL filter(_In_ BOOL bIsBound);
+
+	private:
+		static constexpr UINT KNOWN_INPUT_LAYOUT = 1u << 0u;
+		static constexpr UINT KNOWN_INDEX_BUFFER = 1u << 1u;
+		static constexpr UINT KNOWN_TOPOLOGY = 1u << 2u;
+		static constexpr UINT KNOWN_VERTEX_SHADER = 1u << 3u;
+		static constexpr UINT KNOWN_PIXEL_SHADER = 1u << 4u;
+
+		ContextType* m_pContext;
+		GpuInputLayout* m_pInputLayout;
+		GpuBuffer* m_pIndexBuffer;
+		DXGI_FORMAT m_indexFormat;
+		UINT m_uIndexOffset;
+		ePrimitiveTopology m_topology;
+		GpuVertexShader* m_pVertexShader;
+		GpuPixelShader* m_pPixelShader;
+		VertexBufferSlot m_aVertexBuffers[MAX_VERTEX_BUFFERS];
+		GpuBuffer* m_apVSConstantBuffers[MAX_CONSTANT_BUFFERS];
+		GpuBuffer* m_apPSConstantBuffers[MAX_CONSTANT_BUFFERS];
+		GpuShaderResourceView* m_apVSShaderResources[MAX_SHADER_RESOURCES];
+		GpuShaderResourceView* m_apPSShaderResources[MAX_SHADER_RESOURCES];
+		GpuSamplerState* m_apPSSamplers[MAX_SAMPLERS];
+		UINT m_uKnownStates;
+		UINT m_uKnownVertexBuffers;
+		UINT m_uKnownVSConstantBuffers;
+		UINT m_uKnownPSConstantBuffers;
+		UINT m_uKnownVSShaderResources;
+		UINT m_uKnownPSShaderResources;
+		UINT m_uKnownPSSamplers;
+		UINT m_uNumForwardedCalls;
+		UINT m_uNumFilteredCalls;
+	};
+
+	using StateCache = BasicStateCache<IRenderContext>;
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::BasicStateCache
+
+	  Summary:  Constructor
+
+	  Modifies: [m_pContext, m_pInputLayout, m_pIndexBuffer,
+				 m_indexFormat, m_uIndexOffset, m_topology,
+				 m_pVertexShader, m_pPixelShader, m_aVertexBuffers,
+				 m_apVSConstantBuffers, m_apPSConstantBuffers,
+				 m_apVSShaderResources, m_apPSShaderResources,
+				 m_apPSSamplers, m_uKnownStates, m_uKnownVertexBuffers,
+				 m_uKnownVSConstantBuffers, m_uKnownPSConstantBuffers,
+				 m_uKnownVSShaderResources, m_uKnownPSShaderResources,
+				 m_uKnownPSSamplers, m_uNumForwardedCalls,
+				 m_uNumFilteredCalls].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	BasicStateCache<ContextType>::BasicStateCache()
+		: m_pContext(nullptr)
+		, m_pInputLayout(nullptr)
+		, m_pIndexBuffer(nullptr)
+		, m_indexFormat(DXGI_FORMAT_UNKNOWN)
+		, m_uIndexOffset(0u)
+		, m_topology(ePrimitiveTopology::UNDEFINED)
+		, m_pVertexShader(nullptr)
+		, m_pPixelShader(nullptr)
+		, m_aVertexBuffers()
+		, m_apVSConstantBuffers()
+		, m_apPSConstantBuffers()
+		, m_apVSShaderResources()
+		, m_apPSShaderResources()
+		, m_apPSSamplers()
+		, m_uKnownStates(0u)
+		, m_uKnownVertexBuffers(0u)
+		, m_uKnownVSConstantBuffers(0u)
+		, m_uKnownPSConstantBuffers(0u)
+		, m_uKnownVSShaderResources(0u)
+		, m_uKnownPSShaderResources(0u)
+		, m_uKnownPSSamplers(0u)
+		, m_uNumForwardedCalls(0u)
+		, m_uNumFilteredCalls(0u)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::SetContext
+
+	  Summary:  Sets the wrapped context and invalidates the cache
+
+	  Args:     ContextType* pContext
+				  Context the binds are forwarded to
+
+	  Modifies: [m_pContext].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::SetContext(_In_opt_ ContextType* pContext)
+	{
+		m_pContext = pContext;
+		Invalidate();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::GetContext
+
+	  Summary:  Returns the wrapped context
+
+	  Returns:  ContextType*
+				  Context the binds are forwarded to
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	ContextType* BasicStateCache<ContextType>::GetContext() const
+	{
+		return m_pContext;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::Invalidate
+
+	  Summary:  Forgets every bound state, so the next bind of each
+				slot is forwarded
+
+	  Modifies: [m_uKnownStates, m_uKnownVertexBuffers,
+				 m_uKnownVSConstantBuffers, m_uKnownPSConstantBuffers,
+				 m_uKnownVSShaderResources, m_uKnownPSShaderResources,
+				 m_uKnownPSSamplers].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::Invalidate()
+	{
+		m_uKnownStates = 0u;
+		m_uKnownVertexBuffers = 0u;
+		m_uKnownVSConstantBuffers = 0u;
+		m_uKnownPSConstantBuffers = 0u;
+		m_uKnownVSShaderResources = 0u;
+		m_uKnownPSShaderResources = 0u;
+		m_uKnownPSSamplers = 0u;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::InvalidateConstantBuffers
+
+	  Summary:  Forgets the vertex and pixel shader constant buffers
+				of some slots, after they were bound on the context
+				directly, for example by offset
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumBuffers
+				  Number of slots
+
+	  Modifies: [m_uKnownVSConstantBuffers, m_uKnownPSConstantBuffers].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::InvalidateConstantBuffers(_In_ UINT uStartSlot, _In_ UINT uNumBuffers)
+	{
+		for (UINT uSlot = uStartSlot; uSlot < uStartSlot + uNumBuffers && uSlot < MAX_CONSTANT_BUFFERS; ++uSlot)
+		{
+			m_uKnownVSConstantBuffers &= ~(1u << uSlot);
+			m_uKnownPSConstantBuffers &= ~(1u << uSlot);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::IASetInputLayout
+
+	  Summary:  Binds an input layout unless it is already bound
+
+	  Args:     GpuInputLayout* pInputLayout
+				  Input layout to bind
+
+	  Modifies: [m_pInputLayout, m_uKnownStates].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::IASetInputLayout(_In_opt_ GpuInputLayout* pInputLayout)
+	{
+		if (filter((m_uKnownStates & KNOWN_INPUT_LAYOUT) && m_pInputLayout == pInputLayout))
+		{
+			return;
+		}
+
+		m_pInputLayout = pInputLayout;
+		m_uKnownStates |= KNOWN_INPUT_LAYOUT;
+		m_pContext->IASetInputLayout(pInputLayout);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::IASetVertexBuffers
+
+	  Summary:  Binds vertex buffers unless every slot already holds
+				the same buffer, stride and offset
+
+	  Args:     UINT uStartSlot
+				  First input slot
+				UINT uNumBuffers
+				  Number of buffers
+				GpuBuffer* const* ppVertexBuffers
+				  Buffers to bind
+				const UINT* puStrides
+				  Stride of each buffer
+				const UINT* puOffsets
+				  Offset of each buffer
+
+	  Modifies: [m_aVertexBuffers, m_uKnownVertexBuffers].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::IASetVertexBuffers(
+		_In_ UINT uStartSlot,
+		_In_ UINT uNumBuffers,
+		_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppVertexBuffers,
+		_In_reads_opt_(uNumBuffers) const UINT* puStrides,
+		_In_reads_opt_(uNumBuffers) const UINT* puOffsets
+	)
+	{
+		VertexBufferSlot aSlots[MAX_VERTEX_BUFFERS] = {};
+		const BOOL bIsTracked = ppVertexBuffers && puStrides && puOffsets && uNumBuffers <= MAX_VERTEX_BUFFERS;
+		if (bIsTracked)
+		{
+			for (UINT i = 0u; i < uNumBuffers; ++i)
+			{
+				aSlots[i] = { .pBuffer = ppVertexBuffers[i], .uStride = puStrides[i], .uOffset = puOffsets[i] };
+			}
+		}
+		else
+		{
+			m_uKnownVertexBuffers = 0u;
+		}
+
+		if (filter(bIsTracked && isBound(uStartSlot, uNumBuffers, aSlots, m_aVertexBuffers, MAX_VERTEX_BUFFERS, m_uKnownVertexBuffers)))
+		{
+			return;
+		}
+
+		m_pContext->IASetVertexBuffers(uStartSlot, uNumBuffers, ppVertexBuffers, puStrides, puOffsets);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::IASetIndexBuffer
+
+	  Summary:  Binds an index buffer unless it is already bound with
+				the same format and offset
+
+	  Args:     GpuBuffer* pIndexBuffer
+				  Index buffer to bind
+				DXGI_FORMAT format
+				  Format of the indices
+				UINT uOffset
+				  Offset of the first index in bytes
+
+	  Modifies: [m_pIndexBuffer, m_indexFormat, m_uIndexOffset,
+				 m_uKnownStates].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::IASetIndexBuffer(_In_opt_ GpuBuffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset)
+	{
+		if (filter((m_uKnownStates & KNOWN_INDEX_BUFFER) && m_pIndexBuffer == pIndexBuffer && m_indexFormat == format && m_uIndexOffset == uOffset))
+		{
+			return;
+		}
+
+		m_pIndexBuffer = pIndexBuffer;
+		m_indexFormat = format;
+		m_uIndexOffset = uOffset;
+		m_uKnownStates |= KNOWN_INDEX_BUFFER;
+		m_pContext->IASetIndexBuffer(pIndexBuffer, format, uOffset);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::IASetPrimitiveTopology
+
+	  Summary:  Sets the primitive topology unless it is already set
+
+	  Args:     ePrimitiveTopology topology
+				  Topology to set
+
+	  Modifies: [m_topology, m_uKnownStates].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::IASetPrimitiveTopology(_In_ ePrimitiveTopology topology)
+	{
+		if (filter((m_uKnownStates & KNOWN_TOPOLOGY) && m_topology == topology))
+		{
+			return;
+		}
+
+		m_topology = topology;
+		m_uKnownStates |= KNOWN_TOPOLOGY;
+		m_pContext->IASetPrimitiveTopology(topology);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::VSSetShader
+
+	  Summary:  Binds a vertex shader unless it is already bound
+
+	  Args:     GpuVertexShader* pVertexShader
+				  Vertex shader to bind
+
+	  Modifies: [m_pVertexShader, m_uKnownStates].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::VSSetShader(_In_opt_ GpuVertexShader* pVertexShader)
+	{
+		if (filter((m_uKnownStates & KNOWN_VERTEX_SHADER) && m_pVertexShader == pVertexShader))
+		{
+			return;
+		}
+
+		m_pVertexShader = pVertexShader;
+		m_uKnownStates |= KNOWN_VERTEX_SHADER;
+		m_pContext->VSSetShader(pVertexShader);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::PSSetShader
+
+	  Summary:  Binds a pixel shader unless it is already bound
+
+	  Args:     GpuPixelShader* pPixelShader
+				  Pixel shader to bind
+
+	  Modifies: [m_pPixelShader, m_uKnownStates].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::PSSetShader(_In_opt_ GpuPixelShader* pPixelShader)
+	{
+		if (filter((m_uKnownStates & KNOWN_PIXEL_SHADER) && m_pPixelShader == pPixelShader))
+		{
+			return;
+		}
+
+		m_pPixelShader = pPixelShader;
+		m_uKnownStates |= KNOWN_PIXEL_SHADER;
+		m_pContext->PSSetShader(pPixelShader);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::VSSetConstantBuffers
+
+	  Summary:  Binds vertex shader constant buffers unless every slot
+				already holds the same buffer
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumBuffers
+				  Number of buffers
+				GpuBuffer* const* ppConstantBuffers
+				  Buffers to bind
+
+	  Modifies: [m_apVSConstantBuffers, m_uKnownVSConstantBuffers].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::VSSetConstantBuffers(
+		_In_ UINT uStartSlot,
+		_In_ UINT uNumBuffers,
+		_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers
+	)
+	{
+		if (filter(ppConstantBuffers && isBound(uStartSlot, uNumBuffers, ppConstantBuffers, m_apVSConstantBuffers, MAX_CONSTANT_BUFFERS, m_uKnownVSConstantBuffers)))
+		{
+			return;
+		}
+
+		m_pContext->VSSetConstantBuffers(uStartSlot, uNumBuffers, ppConstantBuffers);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::PSSetConstantBuffers
+
+	  Summary:  Binds pixel shader constant buffers unless every slot
+				already holds the same buffer
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumBuffers
+				  Number of buffers
+				GpuBuffer* const* ppConstantBuffers
+				  Buffers to bind
+
+	  Modifies: [m_apPSConstantBuffers, m_uKnownPSConstantBuffers].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::PSSetConstantBuffers(
+		_In_ UINT uStartSlot,
+		_In_ UINT uNumBuffers,
+		_In_reads_opt_(uNumBuffers) GpuBuffer* const* ppConstantBuffers
+	)
+	{
+		if (filter(ppConstantBuffers && isBound(uStartSlot, uNumBuffers, ppConstantBuffers, m_apPSConstantBuffers, MAX_CONSTANT_BUFFERS, m_uKnownPSConstantBuffers)))
+		{
+			return;
+		}
+
+		m_pContext->PSSetConstantBuffers(uStartSlot, uNumBuffers, ppConstantBuffers);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::VSSetShaderResources
+
+	  Summary:  Binds vertex shader resource views unless every slot
+				already holds the same view
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumViews
+				  Number of views
+				GpuShaderResourceView* const* ppShaderResourceViews
+				  Views to bind
+
+	  Modifies: [m_apVSShaderResources, m_uKnownVSShaderResources].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::VSSetShaderResources(
+		_In_ UINT uStartSlot,
+		_In_ UINT uNumViews,
+		_In_reads_opt_(uNumViews) GpuShaderResourceView* const* ppShaderResourceViews
+	)
+	{
+		if (filter(ppShaderResourceViews && isBound(uStartSlot, uNumViews, ppShaderResourceViews, m_apVSShaderResources, MAX_SHADER_RESOURCES, m_uKnownVSShaderResources)))
+		{
+			return;
+		}
+
+		m_pContext->VSSetShaderResources(uStartSlot, uNumViews, ppShaderResourceViews);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::PSSetShaderResources
+
+	  Summary:  Binds pixel shader resource views unless every slot
+				already holds the same view
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumViews
+				  Number of views
+				GpuShaderResourceView* const* ppShaderResourceViews
+				  Views to bind
+
+	  Modifies: [m_apPSShaderResources, m_uKnownPSShaderResources].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::PSSetShaderResources(
+		_In_ UINT uStartSlot,
+		_In_ UINT uNumViews,
+		_In_reads_opt_(uNumViews) GpuShaderResourceView* const* ppShaderResourceViews
+	)
+	{
+		if (filter(ppShaderResourceViews && isBound(uStartSlot, uNumViews, ppShaderResourceViews, m_apPSShaderResources, MAX_SHADER_RESOURCES, m_uKnownPSShaderResources)))
+		{
+			return;
+		}
+
+		m_pContext->PSSetShaderResources(uStartSlot, uNumViews, ppShaderResourceViews);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::PSSetSamplers
+
+	  Summary:  Binds pixel shader samplers unless every slot already
+				holds the same sampler
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumSamplers
+				  Number of samplers
+				GpuSamplerState* const* ppSamplers
+				  Samplers to bind
+
+	  Modifies: [m_apPSSamplers, m_uKnownPSSamplers].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::PSSetSamplers(
+		_In_ UINT uStartSlot,
+		_In_ UINT uNumSamplers,
+		_In_reads_opt_(uNumSamplers) GpuSamplerState* const* ppSamplers
+	)
+	{
+		if (filter(ppSamplers && isBound(uStartSlot, uNumSamplers, ppSamplers, m_apPSSamplers, MAX_SAMPLERS, m_uKnownPSSamplers)))
+		{
+			return;
+		}
+
+		m_pContext->PSSetSamplers(uStartSlot, uNumSamplers, ppSamplers);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::GetNumForwardedCalls
+
+	  Summary:  Returns the binds forwarded to the context since the
+				counters were last reset
+
+	  Returns:  UINT
+				  Number of forwarded binds
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	UINT BasicStateCache<ContextType>::GetNumForwardedCalls() const
+	{
+		return m_uNumForwardedCalls;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::GetNumFilteredCalls
+
+	  Summary:  Returns the binds dropped as redundant since the
+				counters were last reset
+
+	  Returns:  UINT
+				  Number of filtered binds
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	UINT BasicStateCache<ContextType>::GetNumFilteredCalls() const
+	{
+		return m_uNumFilteredCalls;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::ResetCounters
+
+	  Summary:  Zeroes the forwarded and filtered counts
+
+	  Modifies: [m_uNumForwardedCalls, m_uNumFilteredCalls].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	void BasicStateCache<ContextType>::ResetCounters()
+	{
+		m_uNumForwardedCalls = 0u;
+		m_uNumFilteredCalls = 0u;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::isBound
+
+	  Summary:  Tells whether every slot of a range already holds the
+				given value. If not, the range is recorded as bound.
+				Slots past the tracked ones are never known.
+
+	  Args:     UINT uStartSlot
+				  First slot
+				UINT uNumSlots
+				  Number of slots
+				const SlotType* aSlots
+				  Values to bind
+				SlotType* aBoundSlots
+				  Tracked values
+				UINT uMaxSlots
+				  Number of tracked slots
+				UINT& uKnownSlots
+				  Bit mask of the tracked slots holding a known value
+
+	  Returns:  BOOL
+				  TRUE if the bind would change nothing
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	template <class SlotType>
+	BOOL BasicStateCache<ContextType>::isBound(
+		_In_ UINT uStartSlot,
+		_In_ UINT uNumSlots,
+		_In_reads_(uNumSlots) const SlotType* aSlots,
+		_Inout_updates_(uMaxSlots) SlotType* aBoundSlots,
+		_In_ UINT uMaxSlots,
+		_Inout_ UINT& uKnownSlots
+	)
+	{
+		BOOL bIsBound = uStartSlot < uMaxSlots && uNumSlots <= uMaxSlots - uStartSlot;
+		for (UINT i = 0u; bIsBound && i < uNumSlots; ++i)
+		{
+			const UINT uSlot = uStartSlot + i;
+			bIsBound = (uKnownSlots & (1u << uSlot)) && aBoundSlots[uSlot] == aSlots[i];
+		}
+
+		if (bIsBound)
+		{
+			return TRUE;
+		}
+
+		for (UINT i = 0u; i < uNumSlots && uStartSlot + i < uMaxSlots; ++i)
+		{
+			const UINT uSlot = uStartSlot + i;
+			aBoundSlots[uSlot] = aSlots[i];
+			uKnownSlots |= 1u << uSlot;
+		}
+
+		return FALSE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BasicStateCache<ContextType>::filter
+
+	  Summary:  Counts a bind as filtered or forwarded
+
+	  Args:     BOOL bIsBound
+				  Whether the bind would change nothing
+
+	  Modifies: [m_uNumForwardedCalls, m_uNumFilteredCalls].
+
+	  Returns:  BOOL
+				  TRUE if the bind should be dropped
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	template <class ContextType>
+	BOOL BasicStateCache<ContextType>::filter(_In_ BOOL bIsBound)
+	{
+		if (bIsBound)
+		{
+			++m_uNumFilteredCalls;
+			return TRUE;
+		}
+
+		++m_uNumForwardedCalls;
+		return FALSE;
+	}
+}
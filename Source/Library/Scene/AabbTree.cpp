@@ -0,0 +1,877 @@
+#include "Scene/AabbTree.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace library
+{
+	namespace
+	{
+		constexpr UINT INSIDE_BIT = 0x80000000u;
+
+		Aabb combine(_In_ const Aabb& a, _In_ const Aabb& b)
+		{
+			return Aabb
+			{
+				.Min = XMFLOAT3(std::min<FLOAT>(a.Min.x, b.Min.x), std::min<FLOAT>(a.Min.y, b.Min.y), std::min<FLOAT>(a.Min.z, b.Min.z)),
+				.Max = XMFLOAT3(std::max<FLOAT>(a.Max.x, b.Max.x), std::max<FLOAT>(a.Max.y, b.Max.y), std::max<FLOAT>(a.Max.z, b.Max.z))
+			};
+		}
+
+		FLOAT surfaceArea(_In_ const Aabb& box)
+		{
+			const FLOAT x = box.Max.x - box.Min.x;
+			const FLOAT y = box.Max.y - box.Min.y;
+			const FLOAT z = box.Max.z - box.Min.z;
+			return 2.0f * (x * y + y * z + z * x);
+		}
+
+		BOOL contains(_In_ const Aabb& outer, _In_ const Aabb& inner)
+		{
+			return outer.Min.x <= inner.Min.x && outer.Min.y <= inner.Min.y && outer.Min.z <= inner.Min.z
+				&& inner.Max.x <= outer.Max.x && inner.Max.y <= outer.Max.y && inner.Max.z <= outer.Max.z;
+		}
+
+		BOOL overlaps(_In_ const Aabb& a, _In_ const Aabb& b)
+		{
+			return a.Min.x <= b.Max.x && b.Min.x <= a.Max.x
+				&& a.Min.y <= b.Max.y && b.Min.y <= a.Max.y
+				&& a.Min.z <= b.Max.z && b.Min.z <= a.Max.z;
+		}
+
+		BOOL overlapsSphere(_In_ const Aabb& box, _In_ const XMFLOAT3& center, _In_ FLOAT radius)
+		{
+			const FLOAT dx = std::max<FLOAT>(std::max<FLOAT>(box.Min.x - center.x, center.x - box.Max.x), 0.0f);
+			const FLOAT dy = std::max<FLOAT>(std::max<FLOAT>(box.Min.y - center.y, center.y - box.Max.y), 0.0f);
+			const FLOAT dz = std::max<FLOAT>(std::max<FLOAT>(box.Min.z - center.z, center.z - box.Max.z), 0.0f);
+			return dx * dx + dy * dy + dz * dz <= radius * radius;
+		}
+
+		/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+		  Function: classifyFrustum
+
+		  Summary:  Tests a box against the frustum planes
+
+		  Args:     const XMFLOAT4A* aPlanes
+					  Frustum planes, normals pointing inside
+					const Aabb& box
+					  Box to test
+
+		  Returns:  INT
+					  -1 if the box is behind a plane, 1 if it is in
+					  front of every plane, 0 if it crosses one
+		F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+		INT classifyFrustum(_In_reads_(FrustumCuller::NUM_PLANES) const XMFLOAT4A* aPlanes, _In_ const Aabb& box)
+		{
+			const XMFLOAT3 center((box.Min.x + box.Max.x) * 0.5f, (box.Min.y + box.Max.y) * 0.5f, (box.Min.z + box.Max.z) * 0.5f);
+			const XMFLOAT3 extents((box.Max.x - box.Min.x) * 0.5f, (box.Max.y - box.Min.y) * 0.5f, (box.Max.z - box.Min.z) * 0.5f);
+
+			INT iResult = 1;
+			for (UINT i = 0u; i < FrustumCuller::NUM_PLANES; ++i)
+			{
+				const XMFLOAT4A& plane = aPlanes[i];
+				const FLOAT distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+				const FLOAT projectedRadius = fabsf(plane.x) * extents.x + fabsf(plane.y) * extents.y + fabsf(plane.z) * extents.z;
+				if (distance + projectedRadius < 0.0f)
+				{
+					return -1;
+				}
+				if (distance - projectedRadius < 0.0f)
+				{
+					iResult = 0;
+				}
+			}
+
+			return iResult;
+		}
+
+		/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+		  Function: intersectRay
+
+		  Summary:  Slab test of a ray against a box
+
+		  Args:     const Aabb& box
+					  Box to test
+					const XMFLOAT3& origin
+					  Start of the ray
+					const XMFLOAT3& invDirection
+					  Reciprocal of the unit direction of the ray
+					FLOAT maxDistance
+					  Farthest distance that counts as a hit
+					FLOAT& outDistance
+					  Distance the ray enters the box, 0 if it starts
+					  inside
+
+		  Returns:  BOOL
+					  TRUE if the ray enters the box within maxDistance
+		F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+		BOOL intersectRay(
+			_In_ const Aabb& box,
+			_In_ const XMFLOAT3& origin,
+			_In_ const XMFLOAT3& invDirection,
+			_In_ FLOAT maxDistance,
+			_Out_ FLOAT& outDistance
+		)
+		{
+			FLOAT tMin = 0.0f;
+			FLOAT tMax = maxDistance;
+
+			const FLOAT aMin[3] = { box.Min.x, box.Min.y, box.Min.z };
+			const FLOAT aMax[3] = { box.Max.x, box.Max.y, box.Max.z };
+			const FLOAT aOrigin[3] = { origin.x, origin.y, origin.z };
+			const FLOAT aInvDirection[3] = { invDirection.x, invDirection.y, invDirection.z };
+			for (UINT i = 0u; i < 3u; ++i)
+			{
+				const FLOAT t1 = (aMin[i] - aOrigin[i]) * aInvDirection[i];
+				const FLOAT t2 = (aMax[i] - aOrigin[i]) * aInvDirection[i];
+				tMin = std::max<FLOAT>(tMin, std::min<FLOAT>(t1, t2));
+				tMax = std::min<FLOAT>(tMax, std::max<FLOAT>(t1, t2));
+			}
+
+			outDistance = tMin;
+			return tMin <= tMax;
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::AabbTree
+
+	  Summary:  Constructor with the default margin
+
+	  Modifies: [m_aNodes, m_uRoot, m_uFreeList, m_uNumProxies,
+				 m_margin].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	AabbTree::AabbTree()
+		: AabbTree(DEFAULT_MARGIN)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::AabbTree
+
+	  Summary:  Constructor
+
+	  Args:     FLOAT margin
+				  Distance the fat box of a proxy extends past its
+				  exact box on every side
+
+	  Modifies: [m_aNodes, m_uRoot, m_uFreeList, m_uNumProxies,
+				 m_margin].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	AabbTree::AabbTree(_In_ FLOAT margin)
+		: m_aNodes()
+		, m_uRoot(NULL_NODE)
+		, m_uFreeList(NULL_NODE)
+		, m_uNumProxies(0u)
+		, m_margin(margin)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::Insert
+
+	  Summary:  Adds a leaf holding the box, fattened by the margin
+
+	  Args:     const Aabb& box
+				  World space box of the object
+				void* pUserData
+				  Pointer returned by GetUserData, usually the object
+
+	  Modifies: [m_aNodes, m_uRoot, m_uFreeList, m_uNumProxies].
+
+	  Returns:  UINT
+				  Proxy of the object, valid until it is removed
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT AabbTree::Insert(_In_ const Aabb& box, _In_opt_ void* pUserData)
+	{
+		const UINT uProxy = allocateNode();
+
+		Node& node = m_aNodes[uProxy];
+		node.Tight = box;
+		node.Box = Aabb
+		{
+			.Min = XMFLOAT3(box.Min.x - m_margin, box.Min.y - m_margin, box.Min.z - m_margin),
+			.Max = XMFLOAT3(box.Max.x + m_margin, box.Max.y + m_margin, box.Max.z + m_margin)
+		};
+		node.pUserData = pUserData;
+		node.iHeight = 0;
+
+		insertLeaf(uProxy);
+		++m_uNumProxies;
+
+		return uProxy;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::Remove
+
+	  Summary:  Removes the leaf of a proxy from the tree
+
+	  Args:     UINT uProxy
+				  Proxy returned by Insert
+
+	  Modifies: [m_aNodes, m_uRoot, m_uFreeList, m_uNumProxies].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void AabbTree::Remove(_In_ UINT uProxy)
+	{
+		removeLeaf(uProxy);
+		freeNode(uProxy);
+		--m_uNumProxies;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::Move
+
+	  Summary:  Updates the exact box of a proxy. The tree is only
+				changed when the box leaves the fat box of the leaf,
+				in which case the leaf is inserted again with a new
+				fat box.
+
+	  Args:     UINT uProxy
+				  Proxy returned by Insert
+				const Aabb& box
+				  New world space box of the object
+
+	  Modifies: [m_aNodes, m_uRoot].
+
+	  Returns:  BOOL
+				  TRUE if the leaf was inserted again
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL AabbTree::Move(_In_ UINT uProxy, _In_ const Aabb& box)
+	{
+		m_aNodes[uProxy].Tight = box;
+		if (contains(m_aNodes[uProxy].Box, box))
+		{
+			return FALSE;
+		}
+
+		removeLeaf(uProxy);
+		m_aNodes[uProxy].Box = Aabb
+		{
+			.Min = XMFLOAT3(box.Min.x - m_margin, box.Min.y - m_margin, box.Min.z - m_margin),
+			.Max = XMFLOAT3(box.Max.x + m_margin, box.Max.y + m_margin, box.Max.z + m_margin)
+		};
+		insertLeaf(uProxy);
+
+		return TRUE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::GetUserData
+
+	  Summary:  Returns the pointer stored with a proxy
+
+	  Args:     UINT uProxy
+				  Proxy returned by Insert
+
+	  Returns:  void*
+				  Pointer given to Insert
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void* AabbTree::GetUserData(_In_ UINT uProxy) const
+	{
+		return m_aNodes[uProxy].pUserData;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::GetBounds
+
+	  Summary:  Returns the exact box of a proxy
+
+	  Args:     UINT uProxy
+				  Proxy returned by Insert
+
+	  Returns:  const Aabb&
+				  Box last given to Insert or Move
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const Aabb& AabbTree::GetBounds(_In_ UINT uProxy) const
+	{
+		return m_aNodes[uProxy].Tight;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::GetNumProxies
+
+	  Summary:  Returns the number of proxies in the tree
+
+	  Returns:  UINT
+				  Number of proxies
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT AabbTree::GetNumProxies() const
+	{
+		return m_uNumProxies;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::GetHeight
+
+	  Summary:  Returns the height of the root, 0 for a single leaf
+
+	  Returns:  INT
+				  Height of the tree, -1 if it is empty
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	INT AabbTree::GetHeight() const
+	{
+		return m_uRoot == NULL_NODE ? -1 : m_aNodes[m_uRoot].iHeight;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::IsValid
+
+	  Summary:  Walks the tree checking the links, heights and boxes
+				of every node and the number of leaves
+
+	  Returns:  BOOL
+				  TRUE if the tree is consistent
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL AabbTree::IsValid() const
+	{
+		if (m_uRoot == NULL_NODE)
+		{
+			return m_uNumProxies == 0u;
+		}
+		if (m_aNodes[m_uRoot].uParent != NULL_NODE)
+		{
+			return FALSE;
+		}
+
+		std::vector<UINT> aStack = { m_uRoot };
+		UINT uNumLeaves = 0u;
+		while (!aStack.empty())
+		{
+			const UINT uNode = aStack.back();
+			aStack.pop_back();
+			const Node& node = m_aNodes[uNode];
+
+			if (node.iHeight == 0)
+			{
+				if (!contains(node.Box, node.Tight))
+				{
+					return FALSE;
+				}
+				++uNumLeaves;
+				continue;
+			}
+
+			const Node& child1 = m_aNodes[node.uChild1];
+			const Node& child2 = m_aNodes[node.uChild2];
+			if (child1.uParent != uNode || child2.uParent != uNode
+				|| node.iHeight != 1 + std::max<INT>(child1.iHeight, child2.iHeight)
+				|| !contains(node.Box, child1.Box) || !contains(node.Box, child2.Box))
+			{
+				return FALSE;
+			}
+
+			aStack.push_back(node.uChild1);
+			aStack.push_back(node.uChild2);
+		}
+
+		return uNumLeaves == m_uNumProxies;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::QueryFrustum
+
+	  Summary:  Appends the proxies whose box is not behind any plane
+				of the frustum. Subtrees entirely inside the frustum
+				are collected without testing their leaves.
+
+	  Args:     const XMFLOAT4A* aPlanes
+				  Frustum planes, normals pointing inside, as given
+				  by FrustumCuller::GetPlanes
+				std::vector<UINT>& aOutProxies
+				  Proxies found
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void AabbTree::QueryFrustum(
+		_In_reads_(FrustumCuller::NUM_PLANES) const XMFLOAT4A* aPlanes,
+		_Inout_ std::vector<UINT>& aOutProxies
+	) const
+	{
+		if (m_uRoot == NULL_NODE)
+		{
+			return;
+		}
+
+		UINT aStack[MAX_STACK_SIZE];
+		UINT uStackSize = 0u;
+		aStack[uStackSize++] = m_uRoot;
+
+		while (uStackSize > 0u)
+		{
+			const UINT uEntry = aStack[--uStackSize];
+			const UINT uNode = uEntry & ~INSIDE_BIT;
+			const Node& node = m_aNodes[uNode];
+
+			BOOL bIsInside = (uEntry & INSIDE_BIT) != 0u;
+			if (!bIsInside)
+			{
+				const INT iClass = classifyFrustum(aPlanes, node.iHeight == 0 ? node.Tight : node.Box);
+				if (iClass < 0)
+				{
+					continue;
+				}
+				bIsInside = iClass > 0;
+			}
+
+			if (node.iHeight == 0)
+			{
+				aOutProxies.push_back(uNode);
+			}
+			else if (uStackSize + 2u <= MAX_STACK_SIZE)
+			{
+				const UINT uFlag = bIsInside ? INSIDE_BIT : 0u;
+				aStack[uStackSize++] = node.uChild1 | uFlag;
+				aStack[uStackSize++] = node.uChild2 | uFlag;
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::QuerySphere
+
+	  Summary:  Appends the proxies whose box overlaps a sphere
+
+	  Args:     const XMFLOAT3& center
+				  Center of the sphere
+				FLOAT radius
+				  Radius of the sphere
+				std::vector<UINT>& aOutProxies
+				  Proxies found
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void AabbTree::QuerySphere(_In_ const XMFLOAT3& center, _In_ FLOAT radius, _Inout_ std::vector<UINT>& aOutProxies) const
+	{
+		if (m_uRoot == NULL_NODE)
+		{
+			return;
+		}
+
+		UINT aStack[MAX_STACK_SIZE];
+		UINT uStackSize = 0u;
+		aStack[uStackSize++] = m_uRoot;
+
+		while (uStackSize > 0u)
+		{
+			const UINT uNode = aStack[--uStackSize];
+			const Node& node = m_aNodes[uNode];
+
+			if (node.iHeight == 0)
+			{
+				if (overlapsSphere(node.Tight, center, radius))
+				{
+					aOutProxies.push_back(uNode);
+				}
+			}
+			else if (overlapsSphere(node.Box, center, radius) && uStackSize + 2u <= MAX_STACK_SIZE)
+			{
+				aStack[uStackSize++] = node.uChild1;
+				aStack[uStackSize++] = node.uChild2;
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::QueryAabb
+
+	  Summary:  Appends the proxies whose box overlaps a box
+
+	  Args:     const Aabb& box
+				  World space box
+				std::vector<UINT>& aOutProxies
+				  Proxies found
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void AabbTree::QueryAabb(_In_ const Aabb& box, _Inout_ std::vector<UINT>& aOutProxies) const
+	{
+		if (m_uRoot == NULL_NODE)
+		{
+			return;
+		}
+
+		UINT aStack[MAX_STACK_SIZE];
+		UINT uStackSize = 0u;
+		aStack[uStackSize++] = m_uRoot;
+
+		while (uStackSize > 0u)
+		{
+			const UINT uNode = aStack[--uStackSize];
+			const Node& node = m_aNodes[uNode];
+
+			if (node.iHeight == 0)
+			{
+				if (overlaps(node.Tight, box))
+				{
+					aOutProxies.push_back(uNode);
+				}
+			}
+			else if (overlaps(node.Box, box) && uStackSize + 2u <= MAX_STACK_SIZE)
+			{
+				aStack[uStackSize++] = node.uChild1;
+				aStack[uStackSize++] = node.uChild2;
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::RayCast
+
+	  Summary:  Finds the proxy whose box the ray enters first. Nodes
+				entered farther than the nearest hit so far are
+				skipped.
+
+	  Args:     const XMFLOAT3& origin
+				  Start of the ray
+				const XMFLOAT3& direction
+				  Direction of the ray, need not be normalized
+				FLOAT maxDistance
+				  Length of the ray
+				UINT& uOutProxy
+				  Nearest proxy hit, NULL_NODE if none
+				FLOAT& outDistance
+				  Distance to the nearest hit, 0 if the ray starts
+				  inside the box
+
+	  Returns:  BOOL
+				  TRUE if a proxy was hit
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL AabbTree::RayCast(
+		_In_ const XMFLOAT3& origin,
+		_In_ const XMFLOAT3& direction,
+		_In_ FLOAT maxDistance,
+		_Out_ UINT& uOutProxy,
+		_Out_ FLOAT& outDistance
+	) const
+	{
+		uOutProxy = NULL_NODE;
+		outDistance = maxDistance;
+
+		const FLOAT length = sqrtf(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+		if (m_uRoot == NULL_NODE || length <= 0.0f)
+		{
+			return FALSE;
+		}
+
+		// Reciprocals of zero are infinite, which the slab test handles
+		const XMFLOAT3 invDirection(length / direction.x, length / direction.y, length / direction.z);
+
+		UINT aStack[MAX_STACK_SIZE];
+		UINT uStackSize = 0u;
+		aStack[uStackSize++] = m_uRoot;
+
+		while (uStackSize > 0u)
+		{
+			const UINT uNode = aStack[--uStackSize];
+			const Node& node = m_aNodes[uNode];
+
+			FLOAT distance = 0.0f;
+			if (!intersectRay(node.iHeight == 0 ? node.Tight : node.Box, origin, invDirection, outDistance, distance))
+			{
+				continue;
+			}
+
+			if (node.iHeight == 0)
+			{
+				if (uOutProxy == NULL_NODE || distance < outDistance)
+				{
+					uOutProxy = uNode;
+					outDistance = distance;
+				}
+			}
+			else if (uStackSize + 2u <= MAX_STACK_SIZE)
+			{
+				aStack[uStackSize++] = node.uChild1;
+				aStack[uStackSize++] = node.uChild2;
+			}
+		}
+
+		return uOutProxy != NULL_NODE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::ToAabb
+
+	  Summary:  Returns the box of mesh bounds
+
+	  Args:     const MeshBounds& bounds
+				  Bounds, usually in world space
+
+	  Returns:  Aabb
+				  Box from the center minus to the center plus the
+				  extents
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	Aabb AabbTree::ToAabb(_In_ const MeshBounds& bounds)
+	{
+		return Aabb
+		{
+			.Min = XMFLOAT3(bounds.Center.x - bounds.Extents.x, bounds.Center.y - bounds.Extents.y, bounds.Center.z - bounds.Extents.z),
+			.Max = XMFLOAT3(bounds.Center.x + bounds.Extents.x, bounds.Center.y + bounds.Extents.y, bounds.Center.z + bounds.Extents.z)
+		};
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::allocateNode
+
+	  Summary:  Takes a node from the free list, growing the nodes
+				when it is empty
+
+	  Modifies: [m_aNodes, m_uFreeList].
+
+	  Returns:  UINT
+				  Index of the node, with no parent or children
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT AabbTree::allocateNode()
+	{
+		UINT uNode = m_uFreeList;
+		if (uNode == NULL_NODE)
+		{
+			uNode = static_cast<UINT>(m_aNodes.size());
+			m_aNodes.emplace_back();
+		}
+		else
+		{
+			m_uFreeList = m_aNodes[uNode].uParent;
+		}
+
+		Node& node = m_aNodes[uNode];
+		node.pUserData = nullptr;
+		node.uParent = NULL_NODE;
+		node.uChild1 = NULL_NODE;
+		node.uChild2 = NULL_NODE;
+		node.iHeight = 0;
+
+		return uNode;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::freeNode
+
+	  Summary:  Returns a node to the free list, linked through its
+				parent
+
+	  Args:     UINT uNode
+				  Index of the node
+
+	  Modifies: [m_aNodes, m_uFreeList].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void AabbTree::freeNode(_In_ UINT uNode)
+	{
+		m_aNodes[uNode].uParent = m_uFreeList;
+		m_aNodes[uNode].iHeight = -1;
+		m_uFreeList = uNode;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::insertLeaf
+
+	  Summary:  Descends from the root towards the sibling whose box
+				grows the least in surface area, pairs the leaf with
+				it under a new node and refits the ancestors
+
+	  Args:     UINT uLeaf
+				  Index of a leaf not in the tree
+
+	  Modifies: [m_aNodes, m_uRoot].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void AabbTree::insertLeaf(_In_ UINT uLeaf)
+	{
+		if (m_uRoot == NULL_NODE)
+		{
+			m_uRoot = uLeaf;
+			m_aNodes[uLeaf].uParent = NULL_NODE;
+			return;
+		}
+
+		const Aabb leafBox = m_aNodes[uLeaf].Box;
+
+		UINT uSibling = m_uRoot;
+		while (m_aNodes[uSibling].iHeight > 0)
+		{
+			const Node& node = m_aNodes[uSibling];
+			const FLOAT area = surfaceArea(node.Box);
+			const FLOAT combinedArea = surfaceArea(combine(node.Box, leafBox));
+
+			// Pairing here adds a node the size of both, descending makes
+			// this node grow anyway
+			const FLOAT cost = 2.0f * combinedArea;
+			const FLOAT inheritanceCost = 2.0f * (combinedArea - area);
+
+			auto childCost = [this, &leafBox, inheritanceCost](UINT uChild)
+			{
+				const Node& child = m_aNodes[uChild];
+				const FLOAT childArea = surfaceArea(combine(leafBox, child.Box));
+				return (child.iHeight == 0 ? childArea : childArea - surfaceArea(child.Box)) + inheritanceCost;
+			};
+
+			const FLOAT cost1 = childCost(node.uChild1);
+			const FLOAT cost2 = childCost(node.uChild2);
+			if (cost < cost1 && cost < cost2)
+			{
+				break;
+			}
+
+			uSibling = cost1 < cost2 ? node.uChild1 : node.uChild2;
+		}
+
+		// Indices only from here, allocating may move the nodes
+		const UINT uOldParent = m_aNodes[uSibling].uParent;
+		const UINT uNewParent = allocateNode();
+		m_aNodes[uNewParent].uParent = uOldParent;
+		m_aNodes[uNewParent].Box = combine(leafBox, m_aNodes[uSibling].Box);
+		m_aNodes[uNewParent].iHeight = m_aNodes[uSibling].iHeight + 1;
+		m_aNodes[uNewParent].uChild1 = uSibling;
+		m_aNodes[uNewParent].uChild2 = uLeaf;
+		m_aNodes[uSibling].uParent = uNewParent;
+		m_aNodes[uLeaf].uParent = uNewParent;
+
+		if (uOldParent == NULL_NODE)
+		{
+			m_uRoot = uNewParent;
+		}
+		else if (m_aNodes[uOldParent].uChild1 == uSibling)
+		{
+			m_aNodes[uOldParent].uChild1 = uNewParent;
+		}
+		else
+		{
+			m_aNodes[uOldParent].uChild2 = uNewParent;
+		}
+
+		refit(uOldParent);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::removeLeaf
+
+	  Summary:  Unlinks a leaf, replacing its parent with its sibling,
+				and refits the ancestors
+
+	  Args:     UINT uLeaf
+				  Index of a leaf in the tree
+
+	  Modifies: [m_aNodes, m_uRoot, m_uFreeList].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void AabbTree::removeLeaf(_In_ UINT uLeaf)
+	{
+		if (uLeaf == m_uRoot)
+		{
+			m_uRoot = NULL_NODE;
+			return;
+		}
+
+		const UINT uParent = m_aNodes[uLeaf].uParent;
+		const UINT uGrandParent = m_aNodes[uParent].uParent;
+		const UINT uSibling = m_aNodes[uParent].uChild1 == uLeaf ? m_aNodes[uParent].uChild2 : m_aNodes[uParent].uChild1;
+
+		m_aNodes[uSibling].uParent = uGrandParent;
+		if (uGrandParent == NULL_NODE)
+		{
+			m_uRoot = uSibling;
+		}
+		else if (m_aNodes[uGrandParent].uChild1 == uParent)
+		{
+			m_aNodes[uGrandParent].uChild1 = uSibling;
+		}
+		else
+		{
+			m_aNodes[uGrandParent].uChild2 = uSibling;
+		}
+
+		freeNode(uParent);
+		refit(uGrandParent);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::balance
+
+	  Summary:  Rotates the taller child of a node above it when the
+				heights of its children differ by more than one
+
+	  Args:     UINT uNode
+				  Index of an internal node whose children are
+				  balanced and fitted
+
+	  Modifies: [m_aNodes, m_uRoot].
+
+	  Returns:  UINT
+				  Index of the node now at the position of uNode
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT AabbTree::balance(_In_ UINT uNode)
+	{
+		const UINT uA = uNode;
+		if (m_aNodes[uA].iHeight < 2)
+		{
+			return uA;
+		}
+
+		const UINT uB = m_aNodes[uA].uChild1;
+		const UINT uC = m_aNodes[uA].uChild2;
+		const INT iBalance = m_aNodes[uC].iHeight - m_aNodes[uB].iHeight;
+		if (iBalance >= -1 && iBalance <= 1)
+		{
+			return uA;
+		}
+
+		// The taller child takes the place of A, and A keeps the shorter
+		// child and the shorter grandchild
+		const UINT uUp = iBalance > 1 ? uC : uB;
+		const UINT uKept = iBalance > 1 ? uB : uC;
+		const UINT uF = m_aNodes[uUp].uChild1;
+		const UINT uG = m_aNodes[uUp].uChild2;
+		const BOOL bIsFTaller = m_aNodes[uF].iHeight > m_aNodes[uG].iHeight;
+		const UINT uTall = bIsFTaller ? uF : uG;
+		const UINT uShort = bIsFTaller ? uG : uF;
+
+		const UINT uParent = m_aNodes[uA].uParent;
+		m_aNodes[uUp].uParent = uParent;
+		m_aNodes[uA].uParent = uUp;
+		if (uParent == NULL_NODE)
+		{
+			m_uRoot = uUp;
+		}
+		else if (m_aNodes[uParent].uChild1 == uA)
+		{
+			m_aNodes[uParent].uChild1 = uUp;
+		}
+		else
+		{
+			m_aNodes[uParent].uChild2 = uUp;
+		}
+
+		m_aNodes[uUp].uChild1 = uA;
+		m_aNodes[uUp].uChild2 = uTall;
+		m_aNodes[uA].uChild1 = uKept;
+		m_aNodes[uA].uChild2 = uShort;
+		m_aNodes[uShort].uParent = uA;
+
+		m_aNodes[uA].Box = combine(m_aNodes[uKept].Box, m_aNodes[uShort].Box);
+		m_aNodes[uA].iHeight = 1 + std::max<INT>(m_aNodes[uKept].iHeight, m_aNodes[uShort].iHeight);
+		m_aNodes[uUp].Box = combine(m_aNodes[uA].Box, m_aNodes[uTall].Box);
+		m_aNodes[uUp].iHeight = 1 + std::max<INT>(m_aNodes[uA].iHeight, m_aNodes[uTall].iHeight);
+
+		return uUp;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   AabbTree::refit
+
+	  Summary:  Balances a node and its ancestors and recomputes their
+				boxes and heights up to the root
+
+	  Args:     UINT uNode
+				  Index of the lowest node to refit, may be NULL_NODE
+
+	  Modifies: [m_aNodes, m_uRoot].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void AabbTree::refit(_In_ UINT uNode)
+	{
+		while (uNode != NULL_NODE)
+		{
+			uNode = balance(uNode);
+
+			Node& node = m_aNodes[uNode];
+			const Node& child1 = m_aNodes[node.uChild1];
+			const Node& child2 = m_aNodes[node.uChild2];
+			node.Box = combine(child1.Box, child2.Box);
+			node.iHeight = 1 + std::max<INT>(child1.iHeight, child2.iHeight);
+
+			uNode = node.uParent;
+		}
+	}
+}
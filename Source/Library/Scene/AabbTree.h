@@ -0,0 +1,146 @@
+/*+===================================================================
+  File:      AABBTREE.H
+
+  Summary:   AabbTree header file contains declarations of Aabb
+			 struct and AabbTree class, a dynamic bounding volume
+			 hierarchy the scene keeps its objects in for frustum,
+			 sphere, box and ray queries.
+
+  Classes: AabbTree
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/FrustumCuller.h"
+
+namespace library
+{
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   Aabb
+
+		Summary:  World space axis aligned box from its minimum to its
+				  maximum corner
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct Aabb
+	{
+		XMFLOAT3 Min;
+		XMFLOAT3 Max;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    AabbTree
+
+	  Summary:  Dynamic bounding volume hierarchy of boxes. Every
+				object is a leaf, called a proxy, holding its exact
+				box and a box fattened by a margin. Moving an object
+				within its fat box costs nothing; moving it out of
+				the box removes the leaf and inserts it again next to
+				the sibling that grows the tree the least, refitting
+				and rebalancing the ancestors on the way up. Queries
+				descend only into nodes their shape overlaps and test
+				the exact boxes of the leaves.
+
+	  Methods:  Insert
+				  Adds a box and returns its proxy
+				Remove
+				  Removes a proxy
+				Move
+				  Updates the box of a proxy
+				GetUserData
+				  Returns the pointer stored with a proxy
+				GetBounds
+				  Returns the exact box of a proxy
+				GetNumProxies
+				  Returns the number of proxies
+				GetHeight
+				  Returns the height of the tree
+				IsValid
+				  Checks the links, heights and boxes of the tree
+				QueryFrustum
+				  Collects the proxies inside a frustum
+				QuerySphere
+				  Collects the proxies overlapping a sphere
+				QueryAabb
+				  Collects the proxies overlapping a box
+				RayCast
+				  Finds the nearest proxy hit by a ray
+				ToAabb
+				  Returns the box of mesh bounds
+				AabbTree
+				  Constructor.
+				~AabbTree
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class AabbTree final
+	{
+	public:
+		static constexpr UINT NULL_NODE = UINT_MAX;
+		static constexpr FLOAT DEFAULT_MARGIN = 0.5f;
+
+	public:
+		AabbTree();
+		explicit AabbTree(_In_ FLOAT margin);
+		AabbTree(const AabbTree& other) = delete;
+		AabbTree(AabbTree&& other) = delete;
+		AabbTree& operator=(const AabbTree& other) = delete;
+		AabbTree& operator=(AabbTree&& other) = delete;
+		~AabbTree() = default;
+
+		UINT Insert(_In_ const Aabb& box, _In_opt_ void* pUserData);
+		void Remove(_In_ UINT uProxy);
+		BOOL Move(_In_ UINT uProxy, _In_ const Aabb& box);
+
+		void* GetUserData(_In_ UINT uProxy) const;
+		const Aabb& GetBounds(_In_ UINT uProxy) const;
+		UINT GetNumProxies() const;
+		INT GetHeight() const;
+		BOOL IsValid() const;
+
+		void QueryFrustum(
+			_In_reads_(FrustumCuller::NUM_PLANES) const XMFLOAT4A* aPlanes,
+			_Inout_ std::vector<UINT>& aOutProxies
+		) const;
+		void QuerySphere(_In_ const XMFLOAT3& center, _In_ FLOAT radius, _Inout_ std::vector<UINT>& aOutProxies) const;
+		void QueryAabb(_In_ const Aabb& box, _Inout_ std::vector<UINT>& aOutProxies) const;
+		BOOL RayCast(
+			_In_ const XMFLOAT3& origin,
+			_In_ const XMFLOAT3& direction,
+			_In_ FLOAT maxDistance,
+			_Out_ UINT& uOutProxy,
+			_Out_ FLOAT& outDistance
+		) const;
+
+		static Aabb ToAabb(_In_ const MeshBounds& bounds);
+
+	private:
+		static constexpr UINT MAX_STACK_SIZE = 256u;
+
+		struct Node
+		{
+			Aabb Box;
+			Aabb Tight;
+			void* pUserData;
+			UINT uParent;
+			UINT uChild1;
+			UINT uChild2;
+			INT iHeight;
+		};
+
+		UINT allocateNode();
+		void freeNode(_In_ UINT uNode);
+		void insertLeaf(_In_ UINT uLeaf);
+		void removeLeaf(_In_ UINT uLeaf);
+		UINT balance(_In_ UINT uNode);
+		void refit(_In_ UINT uNode);
+
+	private:
+		std::vector<Node> m_aNodes;
+		UINT m_uRoot;
+		UINT m_uFreeList;
+		UINT m_uNumProxies;
+		FLOAT m_margin;
+	};
+}
@@ -1,5 +1,7 @@
 #include "Scene/Scene.h"
 
+#include <algorithm>
+
 namespace library
 {
 
@@ -26,6 +28,7 @@ namespace library
 	Scene::Scene(const std::filesystem::path& filePath)
 		: m_filePath(filePath)
 		, m_voxels()
+		, m_blockTextures()
 		, m_renderables()
 		, m_models()
 		, m_aPointLights{ nullptr }
@@ -33,6 +36,18 @@ namespace library
 		, m_pixelShaders()
 		, m_materials()
 		, m_skyBox()
+		, m_aUpdateRenderables()
+		, m_aUpdateBounds()
+		, m_aUpdateBoundsValid()
+		, m_renderableTree()
+		, m_heightField()
+		, m_renderableProxies()
+		, m_loadCounter()
+		, m_deviceTaskMutex()
+		, m_deviceTasks()
+		, m_modelsLoadedPromise()
+		, m_uNumPendingModelFiles(0u)
+		, m_modelsLoadedResult(S_OK)
 	{
 		std::ifstream inputFile;
 		inputFile.open(m_filePath.string());
@@ -92,6 +107,15 @@ namespace library
 			);
 		}
 
+		// Tops of the columns, in the space of the voxel instances
+		m_heightField.uNumColumnsX = aDimension[0];
+		m_heightField.uNumColumnsZ = aDimension[2];
+		m_heightField.CellSize = 2.0f;
+		m_heightField.MinX = 2.0f * (-static_cast<FLOAT>(aDimension[0]) / 2.0f) - 1.0f;
+		m_heightField.MinZ = 2.0f * (-static_cast<FLOAT>(aDimension[2]) / 2.0f) - 1.0f;
+		m_heightField.Bottom = 2.0f * (-static_cast<FLOAT>(aDimension[1])) + (static_cast<FLOAT>(aDimension[1]) * 0.75f) - 1.0f;
+		m_heightField.aHeights.assign(static_cast<size_t>(aDimension[0]) * static_cast<size_t>(aDimension[2]), m_heightField.Bottom);
+
 		UINT uDepthIdx = 0u;
 		UINT uWidthIdx = 0u;
 		CHAR voxelType;
@@ -111,7 +135,14 @@ namespace library
 			}
 			else if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT))
 			{
-				for (UINT heightIdx = 0; heightIdx < static_cast<UINT>(static_cast<float>(aDimension[1]) * height); ++heightIdx)
+				const UINT uNumCells = static_cast<UINT>(static_cast<float>(aDimension[1]) * height);
+				if (uNumCells > 0u)
+				{
+					FLOAT& top = m_heightField.aHeights[static_cast<size_t>(uDepthIdx) * aDimension[0] + uWidthIdx];
+					top = std::max(top, 2.0f * (static_cast<FLOAT>(uNumCells - 1u) - static_cast<FLOAT>(aDimension[1])) + (static_cast<FLOAT>(aDimension[1]) * 0.75f) + 1.0f);
+				}
+
+				for (UINT heightIdx = 0; heightIdx < uNumCells; ++heightIdx)
 				{
 					aInstanceData[static_cast<size_t>(voxelType) - static_cast<size_t>(eBlockType::GRASSLAND)].push_back(
 						InstanceData
@@ -120,7 +151,8 @@ namespace library
 								2.0f * (static_cast<FLOAT>(uWidthIdx) - static_cast<FLOAT>(aDimension[0]) / 2.0f),
 								2.0f * (static_cast<FLOAT>(heightIdx) - static_cast<FLOAT>(aDimension[1])) + (static_cast<FLOAT>(aDimension[1]) * 0.75f),
 								2.0f * (static_cast<FLOAT>(uDepthIdx) - static_cast<FLOAT>(aDimension[2]) / 2.0f)
-								)
+								),
+							.BlockSlice = BlockTextureArray::GetSlice(static_cast<eBlockType>(voxelType))
 						}
 					);
 				}
@@ -157,11 +189,22 @@ namespace library
 		}
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::~Scene
+
+	  Summary:  Destructor. Waits for the model imports still running,
+				since they hand their results back to this scene.
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	Scene::~Scene()
+	{
+		JobSystem::GetInstance().Wait(m_loadCounter);
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Scene::Initialize
 
 	  Summary:  Initializes the voxels, shaders, renderables, models,
-				and skybox
+				and skybox, and returns once every model is loaded
 
 	  Args:     ID3D11Device* pDevice
 				  The Direct3D device to create the buffers
@@ -169,6 +212,55 @@ namespace library
 				  The Direct3D context to set buffers
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	HRESULT Scene::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+	{
+		std::shared_future<HRESULT> modelsLoaded;
+		HRESULT hr = InitializeAsync(pDevice, pImmediateContext, modelsLoaded);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		while (modelsLoaded.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			if (ProcessDeviceTasks(UINT_MAX) == 0u)
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		return modelsLoaded.get();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::InitializeAsync
+
+	  Summary:  Initializes the voxels, shaders, renderables, materials
+				and skybox, then imports the model files on the job
+				system, one job per file. Each finished import queues
+				a device task that creates the buffers and textures of
+				the file and initializes its models; the render thread
+				runs those tasks with ProcessDeviceTasks, so the scene
+				can be drawn while the models are still arriving.
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the buffers
+				ID3D11DeviceContext* pImmediateContext
+				  The Direct3D context to set buffers
+				std::shared_future<HRESULT>& outModelsLoaded
+				  Becomes ready with the first error, or S_OK, once
+				  every model is ready
+
+	  Modifies: [m_loadCounter, m_deviceTasks, m_modelsLoadedPromise,
+				 m_uNumPendingModelFiles, m_modelsLoadedResult].
+
+	  Returns:  HRESULT
+				  Status code of the synchronous part
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Scene::InitializeAsync(
+		_In_ ID3D11Device* pDevice,
+		_In_ ID3D11DeviceContext* pImmediateContext,
+		_Out_ std::shared_future<HRESULT>& outModelsLoaded
+	)
 	{
 		for (auto voxel : m_voxels)
 		{
@@ -179,16 +271,16 @@ namespace library
 			}
 		}
 
-		for (auto it = m_vertexShaders.begin(); it != m_vertexShaders.end(); ++it)
+		if (m_blockTextures)
 		{
-			HRESULT hr = it->second->Initialize(pDevice);
+			HRESULT hr = m_blockTextures->Initialize(pDevice);
 			if (FAILED(hr))
 			{
 				return hr;
 			}
 		}
 
-		for (auto it = m_pixelShaders.begin(); it != m_pixelShaders.end(); ++it)
+		for (auto it = m_vertexShaders.begin(); it != m_vertexShaders.end(); ++it)
 		{
 			HRESULT hr = it->second->Initialize(pDevice);
 			if (FAILED(hr))
@@ -197,33 +289,25 @@ namespace library
 			}
 		}
 
-		for (auto it = m_renderables.begin(); it != m_renderables.end(); ++it)
+		for (auto it = m_pixelShaders.begin(); it != m_pixelShaders.end(); ++it)
 		{
-			HRESULT hr = it->second->Initialize(pDevice, pImmediateContext);
+			HRESULT hr = it->second->Initialize(pDevice);
 			if (FAILED(hr))
 			{
 				return hr;
 			}
 		}
 
-		for (auto it = m_models.begin(); it != m_models.end(); ++it)
+		for (auto it = m_renderables.begin(); it != m_renderables.end(); ++it)
 		{
 			HRESULT hr = it->second->Initialize(pDevice, pImmediateContext);
 			if (FAILED(hr))
 			{
 				return hr;
 			}
-
-			for (UINT i = 0u; i < it->second->GetNumMaterials(); ++i)
-			{
-				hr = AddMaterial(it->second->GetMaterial(i));
-				if (FAILED(hr))
-				{
-					return hr;
-				}
-			}
 		}
 
+		// Materials of the models are initialized with their model
 		for (auto it = m_materials.begin(); it != m_materials.end(); ++it)
 		{
 			HRESULT hr = it->second->Initialize(pDevice, pImmediateContext);
@@ -242,9 +326,117 @@ namespace library
 			}
 		}
 
+		// Models placed from the same file wait for a single import
+		std::unordered_map<std::wstring, std::vector<std::shared_ptr<Model>>> modelsByFile;
+		for (auto it = m_models.begin(); it != m_models.end(); ++it)
+		{
+			modelsByFile[it->second->GetFilePath().lexically_normal().wstring()].push_back(it->second);
+		}
+
+		m_modelsLoadedPromise = std::promise<HRESULT>();
+		outModelsLoaded = m_modelsLoadedPromise.get_future().share();
+		m_uNumPendingModelFiles = static_cast<UINT>(modelsByFile.size());
+		m_modelsLoadedResult = S_OK;
+
+		if (modelsByFile.empty())
+		{
+			m_modelsLoadedPromise.set_value(S_OK);
+			return S_OK;
+		}
+
+		for (auto it = modelsByFile.begin(); it != modelsByFile.end(); ++it)
+		{
+			std::vector<std::shared_ptr<Model>> aModels = std::move(it->second);
+
+			JobSystem::GetInstance().SubmitBackground(
+				[this, pDevice, pImmediateContext, aModels]()
+				{
+					std::shared_ptr<Model> source;
+					HRESULT hr = ModelCache::GetInstance().GetOrImport(aModels.front()->GetFilePath(), source);
+
+					pushDeviceTask(
+						[this, pDevice, pImmediateContext, aModels, source, hr]()
+						{
+							HRESULT hrDevice = hr;
+							if (SUCCEEDED(hrDevice))
+							{
+								hrDevice = source->CreateDeviceObjects(pDevice, pImmediateContext);
+							}
+
+							for (const std::shared_ptr<Model>& model : aModels)
+							{
+								if (FAILED(hrDevice))
+								{
+									break;
+								}
+
+								hrDevice = model->InitializeInstance(pDevice, source);
+							}
+
+							for (UINT i = 0u; SUCCEEDED(hrDevice) && i < source->GetNumMaterials(); ++i)
+							{
+								// Instances of the same file share their materials
+								const std::shared_ptr<Material>& material = source->GetMaterial(i);
+								if (m_materials.contains(material->GetName()) && m_materials[material->GetName()] == material)
+								{
+									continue;
+								}
+
+								hrDevice = AddMaterial(material);
+							}
+
+							finishModelFile(hrDevice);
+						}
+					);
+				},
+				m_loadCounter
+			);
+		}
+
 		return S_OK;
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::ProcessDeviceTasks
+
+	  Summary:  Runs device tasks queued by finished model imports.
+				Must be called from the thread that owns the immediate
+				context.
+
+	  Args:     UINT uMaxNumTasks
+				  Maximum number of tasks to run
+
+	  Modifies: [m_deviceTasks].
+
+	  Returns:  UINT
+				  Number of tasks run
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Scene::ProcessDeviceTasks(_In_ UINT uMaxNumTasks)
+	{
+		UINT uNumTasks = 0u;
+
+		while (uNumTasks < uMaxNumTasks)
+		{
+			std::function<void()> task;
+			{
+				std::lock_guard<std::mutex> lock(m_deviceTaskMutex);
+
+				if (m_deviceTasks.empty())
+				{
+					break;
+				}
+
+				task = std::move(m_deviceTasks.front());
+				m_deviceTasks.pop_front();
+			}
+
+			task();
+			++uNumTasks;
+		}
+
+		return uNumTasks;
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Scene::AddVoxel
 
@@ -441,27 +633,63 @@ namespace library
 	  Method:   Scene::Update
 
 	  Summary:  Update the renderables, models, point lights, skybox
-				each frame
+				each frame. Renderables, models and point lights only
+				write their own state in Update, so they are updated
+				in parallel on the job system with the same result as
+				updating them one after another. The world bounds of
+				the renderables are computed in the same jobs, then
+				the spatial index is updated on this thread.
 
 	  Args:     FLOAT deltaTime
 				  Time difference of a frame
+
+	  Modifies: [m_aUpdateRenderables, m_aUpdateBounds,
+				 m_aUpdateBoundsValid].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	void Scene::Update(_In_ FLOAT deltaTime)
 	{
+		m_aUpdateRenderables.clear();
+		m_aUpdateRenderables.reserve(m_renderables.size() + m_models.size());
+
 		for (auto it = m_renderables.begin(); it != m_renderables.end(); ++it)
 		{
-			it->second->Update(deltaTime);
+			m_aUpdateRenderables.push_back(it->second.get());
 		}
 
 		for (auto it = m_models.begin(); it != m_models.end(); ++it)
 		{
-			it->second->Update(deltaTime);
+			m_aUpdateRenderables.push_back(it->second.get());
 		}
 
-		for (UINT lightIdx = 0; lightIdx < NUM_LIGHTS; ++lightIdx)
-		{
-			m_aPointLights[lightIdx]->Update(deltaTime);
-		}
+		JobSystem& jobSystem = JobSystem::GetInstance();
+
+		const UINT uNumRenderables = static_cast<UINT>(m_aUpdateRenderables.size());
+		const UINT uNumItems = uNumRenderables + NUM_LIGHTS;
+		m_aUpdateBounds.resize(uNumRenderables);
+		m_aUpdateBoundsValid.resize(uNumRenderables);
+
+		// A few ranges per thread keeps the load balanced without paying a job per cube
+		UINT uGrainSize = uNumItems / ((jobSystem.GetNumWorkers() + 1u) * 4u);
+		uGrainSize = uGrainSize > 0u ? uGrainSize : 1u;
+
+		jobSystem.ParallelFor(uNumItems, uGrainSize, [this, uNumRenderables, deltaTime](UINT uBegin, UINT uEnd)
+			{
+				for (UINT i = uBegin; i < uEnd; ++i)
+				{
+					if (i < uNumRenderables)
+					{
+						m_aUpdateRenderables[i]->Update(deltaTime);
+						m_aUpdateBoundsValid[i] = getWorldBounds(*m_aUpdateRenderables[i], m_aUpdateBounds[i]);
+					}
+					else if (m_aPointLights[i - uNumRenderables])
+					{
+						m_aPointLights[i - uNumRenderables]->Update(deltaTime);
+					}
+				}
+			}
+		);
+
+		updateSpatialIndex();
 
 		if (m_skyBox)
 			m_skyBox->Update(deltaTime);
@@ -480,6 +708,19 @@ namespace library
 		return m_voxels;
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::GetBlockTextures
+
+	  Summary:  Returns the block texture arrays of the voxels
+
+	  Returns:  std::shared_ptr<BlockTextureArray>&
+				  Block texture arrays. Could be a nullptr
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	std::shared_ptr<BlockTextureArray>& Scene::GetBlockTextures()
+	{
+		return m_blockTextures;
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Scene::GetRenderables
 
@@ -524,6 +765,57 @@ namespace library
 		return m_aPointLights[index];
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::GetRenderableTree
+
+	  Summary:  Returns the spatial index of the renderables and ready
+				models, as of the last Update. The user data of every
+				proxy is the Renderable. Voxels are not in it, their
+				chunks are culled by the renderer.
+
+	  Returns:  const AabbTree&
+				  World space boxes of the renderables
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const AabbTree& Scene::GetRenderableTree() const
+	{
+		return m_renderableTree;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::GetRenderableProxy
+
+	  Summary:  Returns the proxy of a renderable or model in the
+				renderable tree, so a query result can be matched to
+				the objects the renderer walks
+
+	  Args:     const Renderable* pRenderable
+				  Renderable or model of the scene
+
+	  Returns:  UINT
+				  Proxy of the renderable, AabbTree::NULL_NODE if it
+				  has had no bounds in an Update yet
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Scene::GetRenderableProxy(_In_ const Renderable* pRenderable) const
+	{
+		auto it = m_renderableProxies.find(pRenderable);
+		return it == m_renderableProxies.end() ? AabbTree::NULL_NODE : it->second;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::GetHeightField
+
+	  Summary:  Returns the top of every column of voxels read from
+				the height map, for culling against the terrain
+				without looking at its cells
+
+	  Returns:  const HeightField&
+				  Column tops, empty without a height map
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const HeightField& Scene::GetHeightField() const
+	{
+		return m_heightField;
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Scene::GetVertexShaders
 
@@ -747,6 +1039,132 @@ namespace library
 		return S_OK;
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::SetBlockTexturesOfVoxel
+
+	  Summary:  Sets the texture arrays the voxels sample by block
+				type, initialized with the scene. Voxels then ignore
+				the textures of their material.
+
+	  Args:     const std::shared_ptr<BlockTextureArray>& blockTextures
+				  Block texture arrays, or nullptr to use the material
+
+	  Modifies: [m_blockTextures].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::SetBlockTexturesOfVoxel(_In_ const std::shared_ptr<BlockTextureArray>& blockTextures)
+	{
+		m_blockTextures = blockTextures;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::getWorldBounds
+
+	  Summary:  Merges the world space bounds of the meshes of a
+				renderable into one box. Skinned models use their
+				bind pose bounds.
+
+	  Args:     const Renderable& renderable
+				  Renderable to measure
+				Aabb& outBox
+				  World space box
+
+	  Returns:  BOOL
+				  FALSE if no mesh has bounds yet, as for models
+				  still loading
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL Scene::getWorldBounds(_In_ const Renderable& renderable, _Out_ Aabb& outBox)
+	{
+		MeshBounds merged = { .Center = XMFLOAT3(0.0f, 0.0f, 0.0f), .Extents = XMFLOAT3(0.0f, 0.0f, 0.0f), .Radius = -1.0f };
+		for (UINT i = 0u; i < renderable.GetNumMeshes(); ++i)
+		{
+			const MeshBounds& bounds = renderable.GetMesh(i).Bounds;
+			if (bounds.Radius >= 0.0f)
+			{
+				merged = FrustumCuller::MergeBounds(merged, FrustumCuller::TransformBounds(bounds, renderable.GetWorldMatrix()));
+			}
+		}
+
+		outBox = AabbTree::ToAabb(merged);
+		return merged.Radius >= 0.0f;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::updateSpatialIndex
+
+	  Summary:  Inserts the renderables that have bounds for the first
+				time and moves the others to the bounds of this frame.
+				Only objects leaving the fat box of their leaf are
+				inserted again.
+
+	  Modifies: [m_renderableTree, m_renderableProxies].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::updateSpatialIndex()
+	{
+		for (size_t i = 0u; i < m_aUpdateRenderables.size(); ++i)
+		{
+			if (!m_aUpdateBoundsValid[i])
+			{
+				continue;
+			}
+
+			Renderable* pRenderable = m_aUpdateRenderables[i];
+			auto it = m_renderableProxies.find(pRenderable);
+			if (it == m_renderableProxies.end())
+			{
+				m_renderableProxies.emplace(pRenderable, m_renderableTree.Insert(m_aUpdateBounds[i], pRenderable));
+			}
+			else
+			{
+				m_renderableTree.Move(it->second, m_aUpdateBounds[i]);
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::finishModelFile
+
+	  Summary:  Records the result of one model file and completes the
+				models loaded future after the last one
+
+	  Args:     HRESULT hr
+				  Status code of the file
+
+	  Modifies: [m_uNumPendingModelFiles, m_modelsLoadedResult,
+				 m_modelsLoadedPromise].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::finishModelFile(_In_ HRESULT hr)
+	{
+		if (FAILED(hr) && SUCCEEDED(m_modelsLoadedResult))
+		{
+			m_modelsLoadedResult = hr;
+		}
+
+		if (--m_uNumPendingModelFiles == 0u)
+		{
+			ModelCache::GetInstance().ReportStatistics();
+			TextureCache::GetInstance().ReportStatistics();
+			m_modelsLoadedPromise.set_value(m_modelsLoadedResult);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Scene::pushDeviceTask
+
+	  Summary:  Queues a task for the render thread. Called by the
+				import jobs.
+
+	  Args:     std::function<void()> task
+				  Task that uses the device or the immediate context
+
+	  Modifies: [m_deviceTasks].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Scene::pushDeviceTask(_In_ std::function<void()> task)
+	{
+		std::lock_guard<std::mutex> lock(m_deviceTaskMutex);
+
+		m_deviceTasks.push_back(std::move(task));
+	}
+
 	FLOAT Scene::getNoise2(UINT x, UINT y)
 	{
 		UINT temp = ms_aHashes[y % 256u];
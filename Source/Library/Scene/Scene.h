@@ -13,13 +13,24 @@
 
 #include "Common.h"
 
+#include <chrono>
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <mutex>
 
+#include "Job/JobSystem.h"
 #include "Model/Model.h"
+#include "Model/ModelCache.h"
 #include "Light/PointLight.h"
+#include "Renderer/HorizonCuller.h"
 #include "Renderer/Skybox.h"
 #include "Renderer/Renderable.h"
+#include "Scene/AabbTree.h"
 #include "Scene/Voxel.h"
+#include "Texture/BlockTextureArray.h"
+#include "Texture/TextureCache.h"
 
 namespace library
 {
@@ -34,9 +45,15 @@ namespace library
 		Scene(Scene&& other) = delete;
 		Scene& operator=(const Scene& other) = delete;
 		Scene& operator=(Scene&& other) = delete;
-		virtual ~Scene() = default;
+		virtual ~Scene();
 
 		virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+		HRESULT InitializeAsync(
+			_In_ ID3D11Device* pDevice,
+			_In_ ID3D11DeviceContext* pImmediateContext,
+			_Out_ std::shared_future<HRESULT>& outModelsLoaded
+		);
+		UINT ProcessDeviceTasks(_In_ UINT uMaxNumTasks);
 
 		HRESULT AddVoxel(_In_ const std::shared_ptr<Voxel>& voxel);
 		HRESULT AddRenderable(_In_ PCWSTR pszRenderableName, _In_ const std::shared_ptr<Renderable>& renderable);
@@ -50,6 +67,7 @@ namespace library
 		void Update(_In_ FLOAT deltaTime);
 
 		std::vector<std::shared_ptr<Voxel>>& GetVoxels();
+		std::shared_ptr<BlockTextureArray>& GetBlockTextures();
 		std::unordered_map<std::wstring, std::shared_ptr<Renderable>>& GetRenderables();
 		std::unordered_map<std::wstring, std::shared_ptr<Model>>& GetModels();
 		std::shared_ptr<PointLight>& GetPointLight(_In_ size_t index);
@@ -57,6 +75,9 @@ namespace library
 		std::unordered_map<std::wstring, std::shared_ptr<PixelShader>>& GetPixelShaders();
 		std::unordered_map<std::wstring, std::shared_ptr<Material>>& GetMaterials();
 		std::shared_ptr<Skybox>& GetSkyBox();
+		const AabbTree& GetRenderableTree() const;
+		UINT GetRenderableProxy(_In_ const Renderable* pRenderable) const;
+		const HeightField& GetHeightField() const;
 
 		const std::filesystem::path& GetFilePath() const;
 		PCWSTR GetFileName() const;
@@ -70,6 +91,7 @@ namespace library
 		HRESULT SetVertexShaderOfVoxel(_In_ PCWSTR pszVertexShaderName);
 		HRESULT SetPixelShaderOfVoxel(_In_ PCWSTR pszPixelShaderName);
 		HRESULT SetMaterialOfVoxel(_In_ PCWSTR pszMaterialName);
+		void SetBlockTexturesOfVoxel(_In_ const std::shared_ptr<BlockTextureArray>& blockTextures);
 
 
 	private:
@@ -77,6 +99,12 @@ namespace library
 		static FLOAT getNoise2d(FLOAT x, FLOAT y);
 		static FLOAT lerp(FLOAT x, FLOAT y, FLOAT s);
 		static FLOAT smoothLerp(FLOAT x, FLOAT y, FLOAT s);
+		static BOOL getWorldBounds(_In_ const Renderable& renderable, _Out_ Aabb& outBox);
+
+		void updateSpatialIndex();
+
+		void finishModelFile(_In_ HRESULT hr);
+		void pushDeviceTask(_In_ std::function<void()> task);
 
 	private:
 		static constexpr const UINT ms_aHashes[] =
@@ -98,6 +126,7 @@ namespace library
 	private:
 		std::filesystem::path m_filePath;
 		std::vector<std::shared_ptr<Voxel>> m_voxels{};
+		std::shared_ptr<BlockTextureArray> m_blockTextures;
 		std::unordered_map<std::wstring, std::shared_ptr<Renderable>> m_renderables;
 		std::unordered_map<std::wstring, std::shared_ptr<Model>> m_models;
 		std::shared_ptr<PointLight> m_aPointLights[NUM_LIGHTS];
@@ -105,5 +134,18 @@ namespace library
 		std::unordered_map<std::wstring, std::shared_ptr<PixelShader>> m_pixelShaders;
 		std::unordered_map<std::wstring, std::shared_ptr<Material>> m_materials;
 		std::shared_ptr<Skybox> m_skyBox;
+		std::vector<Renderable*> m_aUpdateRenderables;
+		std::vector<Aabb> m_aUpdateBounds;
+		std::vector<BOOL> m_aUpdateBoundsValid;
+		AabbTree m_renderableTree;
+		HeightField m_heightField;
+		std::unordered_map<const Renderable*, UINT> m_renderableProxies;
+
+		JobCounter m_loadCounter;
+		std::mutex m_deviceTaskMutex;
+		std::deque<std::function<void()>> m_deviceTasks;
+		std::promise<HRESULT> m_modelsLoadedPromise;
+		UINT m_uNumPendingModelFiles;
+		HRESULT m_modelsLoadedResult;
 	};
 }
\ No newline at end of file
@@ -131,6 +131,15 @@ namespace library
 				D3D11_INPUT_PER_INSTANCE_DATA,
 				1
 			},
+			{
+				"INSTANCE_BLOCK",
+				0,
+				DXGI_FORMAT_R32_UINT,
+				2,
+				D3D11_APPEND_ALIGNED_ELEMENT,
+				D3D11_INPUT_PER_INSTANCE_DATA,
+				1
+			},
 		};
 		const UINT numElements = ARRAYSIZE(layout);
 
@@ -0,0 +1,1002 @@
+#include "Texture/BlockCompressor.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+
+#include "Job/JobSystem.h"
+
+namespace library
+{
+	namespace
+	{
+		constexpr UINT NUM_TEXELS_PER_BLOCK = 16u;
+		constexpr UINT NUM_BLOCK_ROWS_PER_JOB = 4u;
+		constexpr BYTE BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+		  Class:    BitWriter
+
+		  Summary:  Writes fields least significant bit first into a
+					zeroed block
+		C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+		class BitWriter final
+		{
+		public:
+			explicit BitWriter(_Out_writes_bytes_(uSize) BYTE* pBlock, _In_ UINT uSize)
+				: m_pBlock(pBlock)
+				, m_uPosition(0u)
+			{
+				std::fill(pBlock, pBlock + uSize, static_cast<BYTE>(0u));
+			}
+
+			void Write(_In_ UINT uValue, _In_ UINT uNumBits)
+			{
+				for (UINT i = 0u; i < uNumBits; ++i, ++m_uPosition)
+				{
+					m_pBlock[m_uPosition >> 3u] |= static_cast<BYTE>(((uValue >> i) & 1u) << (m_uPosition & 7u));
+				}
+			}
+
+		private:
+			BYTE* m_pBlock;
+			UINT m_uPosition;
+		};
+
+		/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+		  Class:    BitReader
+
+		  Summary:  Reads fields least significant bit first
+		C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+		class BitReader final
+		{
+		public:
+			explicit BitReader(_In_ const BYTE* pBlock)
+				: m_pBlock(pBlock)
+				, m_uPosition(0u)
+			{
+			}
+
+			UINT Read(_In_ UINT uNumBits)
+			{
+				UINT uValue = 0u;
+				for (UINT i = 0u; i < uNumBits; ++i, ++m_uPosition)
+				{
+					uValue |= ((m_pBlock[m_uPosition >> 3u] >> (m_uPosition & 7u)) & 1u) << i;
+				}
+
+				return uValue;
+			}
+
+		private:
+			const BYTE* m_pBlock;
+			UINT m_uPosition;
+		};
+
+		/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+		  Function: computeEndpoints
+
+		  Summary:  Places two endpoints on the principal axis of the
+					block, at its extreme texels, found by power
+					iteration on the covariance of the first channels
+
+		  Args:     const BYTE* aTexels
+					  16 RGBA texels
+					UINT uNumChannels
+					  Number of channels to fit, 3 or 4
+					FLOAT* aOutEndpoint0
+					  Endpoint at the largest projection
+					FLOAT* aOutEndpoint1
+					  Endpoint at the smallest projection
+		F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+		void computeEndpoints(_In_reads_(64) const BYTE* aTexels, _In_ UINT uNumChannels, _Out_writes_(4) FLOAT* aOutEndpoint0, _Out_writes_(4) FLOAT* aOutEndpoint1)
+		{
+			FLOAT aMean[4] = { 0.0f, };
+			for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+			{
+				for (UINT c = 0u; c < uNumChannels; ++c)
+				{
+					aMean[c] += aTexels[i * 4u + c];
+				}
+			}
+			for (UINT c = 0u; c < uNumChannels; ++c)
+			{
+				aMean[c] /= static_cast<FLOAT>(NUM_TEXELS_PER_BLOCK);
+			}
+
+			FLOAT aCovariance[4][4] = { { 0.0f, }, };
+			for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+			{
+				for (UINT a = 0u; a < uNumChannels; ++a)
+				{
+					for (UINT b = 0u; b < uNumChannels; ++b)
+					{
+						aCovariance[a][b] += (aTexels[i * 4u + a] - aMean[a]) * (aTexels[i * 4u + b] - aMean[b]);
+					}
+				}
+			}
+
+			// Start from the covariance row of the channel that varies most
+			UINT uWidest = 0u;
+			for (UINT c = 1u; c < uNumChannels; ++c)
+			{
+				if (aCovariance[c][c] > aCovariance[uWidest][uWidest])
+				{
+					uWidest = c;
+				}
+			}
+
+			FLOAT aAxis[4] = { 0.0f, };
+			std::copy(aCovariance[uWidest], aCovariance[uWidest] + uNumChannels, aAxis);
+			for (UINT uIteration = 0u; uIteration < 8u; ++uIteration)
+			{
+				FLOAT aNext[4] = { 0.0f, };
+				FLOAT length = 0.0f;
+				for (UINT a = 0u; a < uNumChannels; ++a)
+				{
+					for (UINT b = 0u; b < uNumChannels; ++b)
+					{
+						aNext[a] += aCovariance[a][b] * aAxis[b];
+					}
+					length = std::max<FLOAT>(length, std::abs(aNext[a]));
+				}
+
+				if (length <= 0.0f)
+				{
+					break;
+				}
+
+				for (UINT c = 0u; c < uNumChannels; ++c)
+				{
+					aAxis[c] = aNext[c] / length;
+				}
+			}
+
+			FLOAT lengthSquared = 0.0f;
+			for (UINT c = 0u; c < uNumChannels; ++c)
+			{
+				lengthSquared += aAxis[c] * aAxis[c];
+			}
+			FLOAT inverseLength = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+
+			FLOAT minProjection = 0.0f;
+			FLOAT maxProjection = 0.0f;
+			for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+			{
+				FLOAT projection = 0.0f;
+				for (UINT c = 0u; c < uNumChannels; ++c)
+				{
+					projection += (aTexels[i * 4u + c] - aMean[c]) * aAxis[c] * inverseLength;
+				}
+				minProjection = std::min<FLOAT>(minProjection, projection);
+				maxProjection = std::max<FLOAT>(maxProjection, projection);
+			}
+
+			for (UINT c = 0u; c < 4u; ++c)
+			{
+				FLOAT direction = c < uNumChannels ? aAxis[c] * inverseLength : 0.0f;
+				aOutEndpoint0[c] = std::clamp<FLOAT>(aMean[c] + direction * maxProjection, 0.0f, 255.0f);
+				aOutEndpoint1[c] = std::clamp<FLOAT>(aMean[c] + direction * minProjection, 0.0f, 255.0f);
+			}
+		}
+
+		/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+		  Function: refineEndpoints
+
+		  Summary:  Solves for the endpoints that best reproduce the
+					block, by least squares, given the position of each
+					texel between them
+
+		  Args:     const BYTE* aTexels
+					  16 RGBA texels
+					const FLOAT* aWeights
+					  Position of each texel, 0 at endpoint 0 and 1 at
+					  endpoint 1
+					UINT uNumChannels
+					  Number of channels to fit
+					FLOAT* aOutEndpoint0
+					  First endpoint
+					FLOAT* aOutEndpoint1
+					  Second endpoint
+
+		  Returns:  BOOL
+					  FALSE when every texel sits at the same position
+		F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+		BOOL refineEndpoints(
+			_In_reads_(64) const BYTE* aTexels,
+			_In_reads_(16) const FLOAT* aWeights,
+			_In_ UINT uNumChannels,
+			_Out_writes_(4) FLOAT* aOutEndpoint0,
+			_Out_writes_(4) FLOAT* aOutEndpoint1
+		)
+		{
+			FLOAT aa = 0.0f;
+			FLOAT ab = 0.0f;
+			FLOAT bb = 0.0f;
+			FLOAT aAx[4] = { 0.0f, };
+			FLOAT aBx[4] = { 0.0f, };
+			for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+			{
+				FLOAT b = aWeights[i];
+				FLOAT a = 1.0f - b;
+				aa += a * a;
+				ab += a * b;
+				bb += b * b;
+				for (UINT c = 0u; c < uNumChannels; ++c)
+				{
+					aAx[c] += a * aTexels[i * 4u + c];
+					aBx[c] += b * aTexels[i * 4u + c];
+				}
+			}
+
+			FLOAT determinant = aa * bb - ab * ab;
+			if (std::abs(determinant) < 1e-6f)
+			{
+				return FALSE;
+			}
+
+			for (UINT c = 0u; c < uNumChannels; ++c)
+			{
+				aOutEndpoint0[c] = std::clamp<FLOAT>((bb * aAx[c] - ab * aBx[c]) / determinant, 0.0f, 255.0f);
+				aOutEndpoint1[c] = std::clamp<FLOAT>((aa * aBx[c] - ab * aAx[c]) / determinant, 0.0f, 255.0f);
+			}
+
+			return TRUE;
+		}
+
+		UINT16 packRgb565(_In_reads_(3) const FLOAT* aColor)
+		{
+			UINT uRed = static_cast<UINT>(std::lround(aColor[0] * 31.0f / 255.0f));
+			UINT uGreen = static_cast<UINT>(std::lround(aColor[1] * 63.0f / 255.0f));
+			UINT uBlue = static_cast<UINT>(std::lround(aColor[2] * 31.0f / 255.0f));
+
+			return static_cast<UINT16>((uRed << 11u) | (uGreen << 5u) | uBlue);
+		}
+
+		void unpackRgb565(_In_ UINT uColor, _Out_writes_(3) INT* aOutColor)
+		{
+			UINT uRed = (uColor >> 11u) & 31u;
+			UINT uGreen = (uColor >> 5u) & 63u;
+			UINT uBlue = uColor & 31u;
+
+			aOutColor[0] = static_cast<INT>((uRed << 3u) | (uRed >> 2u));
+			aOutColor[1] = static_cast<INT>((uGreen << 2u) | (uGreen >> 4u));
+			aOutColor[2] = static_cast<INT>((uBlue << 3u) | (uBlue >> 2u));
+		}
+
+		/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+		  Function: evaluateBc1
+
+		  Summary:  Orders two 565 endpoints for the four color mode and
+					picks the nearest palette entry of every texel
+
+		  Args:     const BYTE* aTexels
+					  16 RGBA texels
+					UINT16& uColor0
+					  First endpoint, swapped to be the larger one
+					UINT16& uColor1
+					  Second endpoint
+					UINT& uOutIndices
+					  2 bit index of every texel
+
+		  Returns:  UINT
+					  Sum of squared errors
+		F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+		UINT evaluateBc1(_In_reads_(64) const BYTE* aTexels, _Inout_ UINT16& uColor0, _Inout_ UINT16& uColor1, _Out_ UINT& uOutIndices)
+		{
+			if (uColor0 < uColor1)
+			{
+				std::swap(uColor0, uColor1);
+			}
+
+			INT aPalette[4][3];
+			unpackRgb565(uColor0, aPalette[0]);
+			unpackRgb565(uColor1, aPalette[1]);
+			for (UINT c = 0u; c < 3u; ++c)
+			{
+				aPalette[2][c] = (2 * aPalette[0][c] + aPalette[1][c]) / 3;
+				aPalette[3][c] = (aPalette[0][c] + 2 * aPalette[1][c]) / 3;
+			}
+
+			// Equal endpoints select the three color mode, where only index 0 is the same color
+			const UINT uNumEntries = uColor0 == uColor1 ? 1u : 4u;
+
+			UINT uError = 0u;
+			uOutIndices = 0u;
+			for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+			{
+				UINT uBest = 0u;
+				UINT uBestError = UINT_MAX;
+				for (UINT k = 0u; k < uNumEntries; ++k)
+				{
+					UINT uEntryError = 0u;
+					for (UINT c = 0u; c < 3u; ++c)
+					{
+						INT iDelta = aTexels[i * 4u + c] - aPalette[k][c];
+						uEntryError += static_cast<UINT>(iDelta * iDelta);
+					}
+					if (uEntryError < uBestError)
+					{
+						uBestError = uEntryError;
+						uBest = k;
+					}
+				}
+
+				uError += uBestError;
+				uOutIndices |= uBest << (2u * i);
+			}
+
+			return uError;
+		}
+
+		/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+		  Function: evaluateBc7
+
+		  Summary:  Picks the nearest of the 16 mode 6 palette entries of
+					every texel
+
+		  Args:     const BYTE* aTexels
+					  16 RGBA texels
+					const UINT* aEndpoint0
+					  First endpoint, 7 bits per channel
+					UINT uParity0
+					  P-bit of the first endpoint
+					const UINT* aEndpoint1
+					  Second endpoint, 7 bits per channel
+					UINT uParity1
+					  P-bit of the second endpoint
+					BYTE* aOutIndices
+					  4 bit index of every texel
+
+		  Returns:  UINT
+					  Sum of squared errors
+		F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+		UINT evaluateBc7(
+			_In_reads_(64) const BYTE* aTexels,
+			_In_reads_(4) const UINT* aEndpoint0,
+			_In_ UINT uParity0,
+			_In_reads_(4) const UINT* aEndpoint1,
+			_In_ UINT uParity1,
+			_Out_writes_(16) BYTE* aOutIndices
+		)
+		{
+			INT aPalette[16][4];
+			for (UINT c = 0u; c < 4u; ++c)
+			{
+				INT iFirst = static_cast<INT>((aEndpoint0[c] << 1u) | uParity0);
+				INT iSecond = static_cast<INT>((aEndpoint1[c] << 1u) | uParity1);
+				for (UINT k = 0u; k < 16u; ++k)
+				{
+					aPalette[k][c] = ((64 - BC7_WEIGHTS[k]) * iFirst + BC7_WEIGHTS[k] * iSecond + 32) >> 6;
+				}
+			}
+
+			UINT uError = 0u;
+			for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+			{
+				UINT uBest = 0u;
+				UINT uBestError = UINT_MAX;
+				for (UINT k = 0u; k < 16u; ++k)
+				{
+					UINT uEntryError = 0u;
+					for (UINT c = 0u; c < 4u; ++c)
+					{
+						INT iDelta = aTexels[i * 4u + c] - aPalette[k][c];
+						uEntryError += static_cast<UINT>(iDelta * iDelta);
+					}
+					if (uEntryError < uBestError)
+					{
+						uBestError = uEntryError;
+						uBest = k;
+					}
+				}
+
+				uError += uBestError;
+				aOutIndices[i] = static_cast<BYTE>(uBest);
+			}
+
+			return uError;
+		}
+
+		/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+		  Function: quantizeBc7Endpoint
+
+		  Summary:  Rounds an endpoint to 7 bits per channel and the P-bit
+					shared by its channels that comes closest
+
+		  Args:     const FLOAT* aEndpoint
+					  Endpoint in 8 bit range
+					UINT* aOutEndpoint
+					  7 bits per channel
+					UINT& uOutParity
+					  P-bit
+		F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+		void quantizeBc7Endpoint(_In_reads_(4) const FLOAT* aEndpoint, _Out_writes_(4) UINT* aOutEndpoint, _Out_ UINT& uOutParity)
+		{
+			FLOAT bestError = FLT_MAX;
+			uOutParity = 0u;
+			for (UINT uParity = 0u; uParity < 2u; ++uParity)
+			{
+				UINT aQuantized[4];
+				FLOAT error = 0.0f;
+				for (UINT c = 0u; c < 4u; ++c)
+				{
+					aQuantized[c] = static_cast<UINT>(std::clamp<LONG>(std::lround((aEndpoint[c] - static_cast<FLOAT>(uParity)) / 2.0f), 0, 127));
+					FLOAT delta = static_cast<FLOAT>((aQuantized[c] << 1u) | uParity) - aEndpoint[c];
+					error += delta * delta;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					uOutParity = uParity;
+					std::copy(aQuantized, aQuantized + 4, aOutEndpoint);
+				}
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockCompressor::CompressImage
+
+	  Summary:  Encodes the image to blocks in row major order. Blocks
+				that cross the right or bottom edge repeat the edge
+				texels.
+
+	  Args:     const ImageData& image
+				  RGBA image
+				eBlockFormat format
+				  Format of the blocks
+				std::vector<BYTE>& aOutBlocks
+				  Encoded blocks
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT BlockCompressor::CompressImage(_In_ const ImageData& image, _In_ eBlockFormat format, _Out_ std::vector<BYTE>& aOutBlocks)
+	{
+		if (image.uWidth == 0u || image.uHeight == 0u || image.aPixels.size() != static_cast<SIZE_T>(image.uWidth) * image.uHeight * 4u || format >= eBlockFormat::COUNT)
+		{
+			return E_INVALIDARG;
+		}
+
+		const UINT uNumBlocksX = (image.uWidth + 3u) / 4u;
+		const UINT uNumBlocksY = (image.uHeight + 3u) / 4u;
+		const UINT uBlockSize = GetBlockSize(format);
+		aOutBlocks.resize(static_cast<SIZE_T>(uNumBlocksX) * uNumBlocksY * uBlockSize);
+
+		JobSystem::GetInstance().ParallelFor(
+			uNumBlocksY,
+			NUM_BLOCK_ROWS_PER_JOB,
+			[&](UINT uBegin, UINT uEnd)
+			{
+				BYTE aTexels[NUM_TEXELS_PER_BLOCK * 4u];
+				for (UINT uBlockY = uBegin; uBlockY < uEnd; ++uBlockY)
+				{
+					for (UINT uBlockX = 0u; uBlockX < uNumBlocksX; ++uBlockX)
+					{
+						for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+						{
+							UINT x = std::min<UINT>(uBlockX * 4u + (i & 3u), image.uWidth - 1u);
+							UINT y = std::min<UINT>(uBlockY * 4u + (i >> 2u), image.uHeight - 1u);
+							const BYTE* pTexel = image.aPixels.data() + (static_cast<SIZE_T>(y) * image.uWidth + x) * 4u;
+							std::copy(pTexel, pTexel + 4, aTexels + i * 4u);
+						}
+
+						BYTE* pBlock = aOutBlocks.data() + (static_cast<SIZE_T>(uBlockY) * uNumBlocksX + uBlockX) * uBlockSize;
+						switch (format)
+						{
+						case eBlockFormat::BC1:
+							encodeBc1Block(aTexels, pBlock);
+							break;
+						case eBlockFormat::BC3:
+							encodeBc4Block(aTexels, 3u, pBlock);
+							encodeBc1Block(aTexels, pBlock + 8);
+							break;
+						case eBlockFormat::BC5:
+							encodeBc4Block(aTexels, 0u, pBlock);
+							encodeBc4Block(aTexels, 1u, pBlock + 8);
+							break;
+						default:
+							encodeBc7Block(aTexels, pBlock);
+							break;
+						}
+					}
+				}
+			}
+		);
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockCompressor::DecompressImage
+
+	  Summary:  Decodes blocks written by CompressImage. BC5 leaves blue
+				at zero, and BC7 blocks of modes other than 6 decode as
+				transparent black.
+
+	  Args:     const BYTE* pBlocks
+				  Encoded blocks in row major order
+				SIZE_T uSize
+				  Size of the blocks in bytes
+				UINT uWidth
+				  Width of the image
+				UINT uHeight
+				  Height of the image
+				eBlockFormat format
+				  Format of the blocks
+				ImageData& outImage
+				  RGBA image
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT BlockCompressor::DecompressImage(
+		_In_reads_bytes_(uSize) const BYTE* pBlocks,
+		_In_ SIZE_T uSize,
+		_In_ UINT uWidth,
+		_In_ UINT uHeight,
+		_In_ eBlockFormat format,
+		_Out_ ImageData& outImage
+	)
+	{
+		const UINT uNumBlocksX = (uWidth + 3u) / 4u;
+		const UINT uNumBlocksY = (uHeight + 3u) / 4u;
+		const UINT uBlockSize = format < eBlockFormat::COUNT ? GetBlockSize(format) : 0u;
+		if (uBlockSize == 0u || uSize < static_cast<SIZE_T>(uNumBlocksX) * uNumBlocksY * uBlockSize)
+		{
+			return E_INVALIDARG;
+		}
+
+		outImage.uWidth = uWidth;
+		outImage.uHeight = uHeight;
+		outImage.aPixels.assign(static_cast<SIZE_T>(uWidth) * uHeight * 4u, 0u);
+
+		BYTE aTexels[NUM_TEXELS_PER_BLOCK * 4u];
+		for (UINT uBlockY = 0u; uBlockY < uNumBlocksY; ++uBlockY)
+		{
+			for (UINT uBlockX = 0u; uBlockX < uNumBlocksX; ++uBlockX)
+			{
+				const BYTE* pBlock = pBlocks + (static_cast<SIZE_T>(uBlockY) * uNumBlocksX + uBlockX) * uBlockSize;
+				switch (format)
+				{
+				case eBlockFormat::BC1:
+					decodeBc1Block(pBlock, FALSE, aTexels);
+					break;
+				case eBlockFormat::BC3:
+					decodeBc1Block(pBlock + 8, TRUE, aTexels);
+					decodeBc4Block(pBlock, 3u, aTexels);
+					break;
+				case eBlockFormat::BC5:
+					std::fill(std::begin(aTexels), std::end(aTexels), static_cast<BYTE>(0u));
+					decodeBc4Block(pBlock, 0u, aTexels);
+					decodeBc4Block(pBlock + 8, 1u, aTexels);
+					for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+					{
+						aTexels[i * 4u + 3u] = 0xFFu;
+					}
+					break;
+				default:
+					decodeBc7Block(pBlock, aTexels);
+					break;
+				}
+
+				for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+				{
+					UINT x = uBlockX * 4u + (i & 3u);
+					UINT y = uBlockY * 4u + (i >> 2u);
+					if (x < uWidth && y < uHeight)
+					{
+						std::copy(aTexels + i * 4u, aTexels + i * 4u + 4u, outImage.aPixels.data() + (static_cast<SIZE_T>(y) * uWidth + x) * 4u);
+					}
+				}
+			}
+		}
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockCompressor::ComputePsnr
+
+	  Summary:  Returns the peak signal to noise ratio of an image
+				against its reference, over the channels the format
+				stores: RGB for BC1, RG for BC5 and RGBA otherwise
+
+	  Args:     const ImageData& reference
+				  Original image
+				const ImageData& image
+				  Decoded image of the same size
+				eBlockFormat format
+				  Format the image went through
+
+	  Returns:  FLOAT
+				  Ratio in decibels, 100 for identical images
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	FLOAT BlockCompressor::ComputePsnr(_In_ const ImageData& reference, _In_ const ImageData& image, _In_ eBlockFormat format)
+	{
+		if (reference.aPixels.size() != image.aPixels.size() || reference.aPixels.empty())
+		{
+			return 0.0f;
+		}
+
+		const UINT uNumChannels = format == eBlockFormat::BC1 ? 3u : format == eBlockFormat::BC5 ? 2u : 4u;
+
+		DOUBLE sumSquaredError = 0.0;
+		for (SIZE_T i = 0u; i < reference.aPixels.size(); i += 4u)
+		{
+			for (UINT c = 0u; c < uNumChannels; ++c)
+			{
+				DOUBLE delta = static_cast<DOUBLE>(reference.aPixels[i + c]) - static_cast<DOUBLE>(image.aPixels[i + c]);
+				sumSquaredError += delta * delta;
+			}
+		}
+
+		DOUBLE meanSquaredError = sumSquaredError / (static_cast<DOUBLE>(reference.aPixels.size() / 4u) * uNumChannels);
+		if (meanSquaredError <= 1e-10)
+		{
+			return 100.0f;
+		}
+
+		return static_cast<FLOAT>(10.0 * std::log10(255.0 * 255.0 / meanSquaredError));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockCompressor::GetBlockSize
+
+	  Summary:  Returns the bytes per 4x4 block of a format
+
+	  Args:     eBlockFormat format
+				  Block format
+
+	  Returns:  UINT
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT BlockCompressor::GetBlockSize(_In_ eBlockFormat format)
+	{
+		return format == eBlockFormat::BC1 ? 8u : 16u;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockCompressor::GetDxgiFormat
+
+	  Summary:  Returns the DXGI format of a block format
+
+	  Args:     eBlockFormat format
+				  Block format
+
+	  Returns:  DXGI_FORMAT
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	DXGI_FORMAT BlockCompressor::GetDxgiFormat(_In_ eBlockFormat format)
+	{
+		switch (format)
+		{
+		case eBlockFormat::BC1:
+			return DXGI_FORMAT_BC1_UNORM;
+		case eBlockFormat::BC3:
+			return DXGI_FORMAT_BC3_UNORM;
+		case eBlockFormat::BC5:
+			return DXGI_FORMAT_BC5_UNORM;
+		case eBlockFormat::BC7:
+			return DXGI_FORMAT_BC7_UNORM;
+		default:
+			return DXGI_FORMAT_UNKNOWN;
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockCompressor::decodeBc1Block
+
+	  Summary:  Decodes a BC1 color block
+
+	  Args:     const BYTE* pBlock
+				  8 byte block
+				BOOL bAlwaysFourColors
+				  Whether the block is the color half of a BC3 block
+				BYTE* aTexels
+				  16 RGBA texels
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void BlockCompressor::decodeBc1Block(_In_reads_bytes_(8) const BYTE* pBlock, _In_ BOOL bAlwaysFourColors, _Out_writes_(64) BYTE* aTexels)
+	{
+		UINT uColor0 = pBlock[0] | (pBlock[1] << 8u);
+		UINT uColor1 = pBlock[2] | (pBlock[3] << 8u);
+		UINT uIndices = pBlock[4] | (pBlock[5] << 8u) | (pBlock[6] << 16u) | (static_cast<UINT>(pBlock[7]) << 24u);
+
+		INT aPalette[4][4];
+		unpackRgb565(uColor0, aPalette[0]);
+		unpackRgb565(uColor1, aPalette[1]);
+		aPalette[0][3] = 255;
+		aPalette[1][3] = 255;
+		aPalette[2][3] = 255;
+
+		const BOOL bFourColors = bAlwaysFourColors || uColor0 > uColor1;
+		for (UINT c = 0u; c < 3u; ++c)
+		{
+			aPalette[2][c] = bFourColors ? (2 * aPalette[0][c] + aPalette[1][c]) / 3 : (aPalette[0][c] + aPalette[1][c]) / 2;
+			aPalette[3][c] = bFourColors ? (aPalette[0][c] + 2 * aPalette[1][c]) / 3 : 0;
+		}
+		aPalette[3][3] = bFourColors ? 255 : 0;
+
+		for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+		{
+			const INT* pEntry = aPalette[(uIndices >> (2u * i)) & 3u];
+			for (UINT c = 0u; c < 4u; ++c)
+			{
+				aTexels[i * 4u + c] = static_cast<BYTE>(pEntry[c]);
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockCompressor::decodeBc4Block
+
+	  Summary:  Decodes a single channel block, the alpha half of BC3
+				or either half of BC5
+
+	  Args:     const BYTE* pBlock
+				  8 byte block
+				UINT uChannel
+				  Channel of the texels to write
+				BYTE* aTexels
+				  16 RGBA texels
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void BlockCompressor::decodeBc4Block(_In_reads_bytes_(8) const BYTE* pBlock, _In_ UINT uChannel, _Out_writes_(64) BYTE* aTexels)
+	{
+		INT aPalette[8];
+		aPalette[0] = pBlock[0];
+		aPalette[1] = pBlock[1];
+		if (aPalette[0] > aPalette[1])
+		{
+			for (INT i = 2; i < 8; ++i)
+			{
+				aPalette[i] = ((8 - i) * aPalette[0] + (i - 1) * aPalette[1]) / 7;
+			}
+		}
+		else
+		{
+			for (INT i = 2; i < 6; ++i)
+			{
+				aPalette[i] = ((6 - i) * aPalette[0] + (i - 1) * aPalette[1]) / 5;
+			}
+			aPalette[6] = 0;
+			aPalette[7] = 255;
+		}
+
+		UINT64 uIndices = 0ull;
+		for (UINT i = 0u; i < 6u; ++i)
+		{
+			uIndices |= static_cast<UINT64>(pBlock[2u + i]) << (8u * i);
+		}
+
+		for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+		{
+			aTexels[i * 4u + uChannel] = static_cast<BYTE>(aPalette[(uIndices >> (3u * i)) & 7u]);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockCompressor::decodeBc7Block
+
+	  Summary:  Decodes a BC7 mode 6 block
+
+	  Args:     const BYTE* pBlock
+				  16 byte block
+				BYTE* aTexels
+				  16 RGBA texels
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void BlockCompressor::decodeBc7Block(_In_reads_bytes_(16) const BYTE* pBlock, _Out_writes_(64) BYTE* aTexels)
+	{
+		BitReader reader(pBlock);
+		if (reader.Read(7u) != 0x40u)
+		{
+			std::fill(aTexels, aTexels + NUM_TEXELS_PER_BLOCK * 4u, static_cast<BYTE>(0u));
+			return;
+		}
+
+		UINT aEndpoints[2][4];
+		for (UINT c = 0u; c < 4u; ++c)
+		{
+			aEndpoints[0][c] = reader.Read(7u);
+			aEndpoints[1][c] = reader.Read(7u);
+		}
+		UINT uParity0 = reader.Read(1u);
+		UINT uParity1 = reader.Read(1u);
+
+		for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+		{
+			UINT uIndex = reader.Read(i == 0u ? 3u : 4u);
+			for (UINT c = 0u; c < 4u; ++c)
+			{
+				INT iFirst = static_cast<INT>((aEndpoints[0][c] << 1u) | uParity0);
+				INT iSecond = static_cast<INT>((aEndpoints[1][c] << 1u) | uParity1);
+				aTexels[i * 4u + c] = static_cast<BYTE>(((64 - BC7_WEIGHTS[uIndex]) * iFirst + BC7_WEIGHTS[uIndex] * iSecond + 32) >> 6);
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockCompressor::encodeBc1Block
+
+	  Summary:  Encodes the color of a block in the four color mode
+
+	  Args:     const BYTE* aTexels
+				  16 RGBA texels
+				BYTE* pBlock
+				  8 byte block
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void BlockCompressor::encodeBc1Block(_In_reads_(64) const BYTE* aTexels, _Out_writes_bytes_(8) BYTE* pBlock)
+	{
+		FLOAT aEndpoint0[4];
+		FLOAT aEndpoint1[4];
+		computeEndpoints(aTexels, 3u, aEndpoint0, aEndpoint1);
+
+		UINT16 uColor0 = packRgb565(aEndpoint0);
+		UINT16 uColor1 = packRgb565(aEndpoint1);
+		UINT uIndices = 0u;
+		UINT uError = evaluateBc1(aTexels, uColor0, uColor1, uIndices);
+
+		static constexpr FLOAT s_aPositions[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+		FLOAT aWeights[NUM_TEXELS_PER_BLOCK];
+		for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+		{
+			aWeights[i] = s_aPositions[(uIndices >> (2u * i)) & 3u];
+		}
+
+		if (refineEndpoints(aTexels, aWeights, 3u, aEndpoint0, aEndpoint1))
+		{
+			UINT16 uRefinedColor0 = packRgb565(aEndpoint0);
+			UINT16 uRefinedColor1 = packRgb565(aEndpoint1);
+			UINT uRefinedIndices = 0u;
+			if (evaluateBc1(aTexels, uRefinedColor0, uRefinedColor1, uRefinedIndices) < uError)
+			{
+				uColor0 = uRefinedColor0;
+				uColor1 = uRefinedColor1;
+				uIndices = uRefinedIndices;
+			}
+		}
+
+		pBlock[0] = static_cast<BYTE>(uColor0 & 0xFFu);
+		pBlock[1] = static_cast<BYTE>(uColor0 >> 8u);
+		pBlock[2] = static_cast<BYTE>(uColor1 & 0xFFu);
+		pBlock[3] = static_cast<BYTE>(uColor1 >> 8u);
+		for (UINT i = 0u; i < 4u; ++i)
+		{
+			pBlock[4u + i] = static_cast<BYTE>(uIndices >> (8u * i));
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockCompressor::encodeBc4Block
+
+	  Summary:  Encodes one channel of a block in the eight value mode
+				between its smallest and largest texel
+
+	  Args:     const BYTE* aTexels
+				  16 RGBA texels
+				UINT uChannel
+				  Channel to encode
+				BYTE* pBlock
+				  8 byte block
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void BlockCompressor::encodeBc4Block(_In_reads_(64) const BYTE* aTexels, _In_ UINT uChannel, _Out_writes_bytes_(8) BYTE* pBlock)
+	{
+		INT iMin = 255;
+		INT iMax = 0;
+		for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+		{
+			iMin = std::min<INT>(iMin, aTexels[i * 4u + uChannel]);
+			iMax = std::max<INT>(iMax, aTexels[i * 4u + uChannel]);
+		}
+
+		INT aPalette[8] = { iMax, iMin, };
+		for (INT i = 2; i < 8; ++i)
+		{
+			aPalette[i] = ((8 - i) * iMax + (i - 1) * iMin) / 7;
+		}
+
+		UINT64 uIndices = 0ull;
+		if (iMax > iMin)
+		{
+			for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+			{
+				INT iValue = aTexels[i * 4u + uChannel];
+				UINT uBest = 0u;
+				for (UINT k = 1u; k < 8u; ++k)
+				{
+					if (std::abs(aPalette[k] - iValue) < std::abs(aPalette[uBest] - iValue))
+					{
+						uBest = k;
+					}
+				}
+				uIndices |= static_cast<UINT64>(uBest) << (3u * i);
+			}
+		}
+
+		pBlock[0] = static_cast<BYTE>(iMax);
+		pBlock[1] = static_cast<BYTE>(iMin);
+		for (UINT i = 0u; i < 6u; ++i)
+		{
+			pBlock[2u + i] = static_cast<BYTE>(uIndices >> (8u * i));
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockCompressor::encodeBc7Block
+
+	  Summary:  Encodes a block in BC7 mode 6: one subset, 7 bit RGBA
+				endpoints with a P-bit each and 4 bit indices
+
+	  Args:     const BYTE* aTexels
+				  16 RGBA texels
+				BYTE* pBlock
+				  16 byte block
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void BlockCompressor::encodeBc7Block(_In_reads_(64) const BYTE* aTexels, _Out_writes_bytes_(16) BYTE* pBlock)
+	{
+		FLOAT aEndpoint0[4];
+		FLOAT aEndpoint1[4];
+		computeEndpoints(aTexels, 4u, aEndpoint0, aEndpoint1);
+
+		UINT aQuantized0[4];
+		UINT aQuantized1[4];
+		UINT uParity0 = 0u;
+		UINT uParity1 = 0u;
+		quantizeBc7Endpoint(aEndpoint0, aQuantized0, uParity0);
+		quantizeBc7Endpoint(aEndpoint1, aQuantized1, uParity1);
+
+		BYTE aIndices[NUM_TEXELS_PER_BLOCK];
+		UINT uError = evaluateBc7(aTexels, aQuantized0, uParity0, aQuantized1, uParity1, aIndices);
+
+		FLOAT aWeights[NUM_TEXELS_PER_BLOCK];
+		for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+		{
+			aWeights[i] = BC7_WEIGHTS[aIndices[i]] / 64.0f;
+		}
+
+		if (refineEndpoints(aTexels, aWeights, 4u, aEndpoint0, aEndpoint1))
+		{
+			UINT aRefined0[4];
+			UINT aRefined1[4];
+			UINT uRefinedParity0 = 0u;
+			UINT uRefinedParity1 = 0u;
+			BYTE aRefinedIndices[NUM_TEXELS_PER_BLOCK];
+			quantizeBc7Endpoint(aEndpoint0, aRefined0, uRefinedParity0);
+			quantizeBc7Endpoint(aEndpoint1, aRefined1, uRefinedParity1);
+
+			if (evaluateBc7(aTexels, aRefined0, uRefinedParity0, aRefined1, uRefinedParity1, aRefinedIndices) < uError)
+			{
+				std::copy(aRefined0, aRefined0 + 4, aQuantized0);
+				std::copy(aRefined1, aRefined1 + 4, aQuantized1);
+				uParity0 = uRefinedParity0;
+				uParity1 = uRefinedParity1;
+				std::copy(aRefinedIndices, aRefinedIndices + NUM_TEXELS_PER_BLOCK, aIndices);
+			}
+		}
+
+		// The anchor index is stored without its top bit, so it must be below 8
+		if (aIndices[0] >= 8u)
+		{
+			std::swap_ranges(aQuantized0, aQuantized0 + 4, aQuantized1);
+			std::swap(uParity0, uParity1);
+			for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+			{
+				aIndices[i] = static_cast<BYTE>(15u - aIndices[i]);
+			}
+		}
+
+		BitWriter writer(pBlock, 16u);
+		writer.Write(0x40u, 7u);
+		for (UINT c = 0u; c < 4u; ++c)
+		{
+			writer.Write(aQuantized0[c], 7u);
+			writer.Write(aQuantized1[c], 7u);
+		}
+		writer.Write(uParity0, 1u);
+		writer.Write(uParity1, 1u);
+		for (UINT i = 0u; i < NUM_TEXELS_PER_BLOCK; ++i)
+		{
+			writer.Write(aIndices[i], i == 0u ? 3u : 4u);
+		}
+	}
+}
@@ -0,0 +1,81 @@
+/*+===================================================================
+  File:      BLOCKCOMPRESSOR.H
+
+  Summary:   BlockCompressor header file contains declarations of
+			 BlockCompressor class that encodes and decodes the BC
+			 texture formats on the CPU.
+
+  Classes: BlockCompressor
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/ImageDecoder.h"
+
+namespace library
+{
+	enum class eBlockFormat : size_t
+	{
+		BC1 = 0,
+		BC3,
+		BC5,
+		BC7,
+		COUNT,
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    BlockCompressor
+
+	  Summary:  Encodes RGBA images to 4x4 blocks of BC1 (opaque color),
+				BC3 (color and alpha), BC5 (two channels, for normal
+				maps) or BC7 (color and alpha, mode 6 only). Endpoints
+				come from the principal axis of each block and are
+				refined once by least squares. Images are encoded one
+				row of blocks per job.
+
+	  Methods:  CompressImage
+				  Encodes an image to blocks
+				DecompressImage
+				  Decodes blocks back to an image
+				ComputePsnr
+				  Returns the peak signal to noise ratio of two images
+				GetBlockSize
+				  Returns the bytes per block of a format
+				GetDxgiFormat
+				  Returns the DXGI format of a block format
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class BlockCompressor final
+	{
+	public:
+		BlockCompressor() = delete;
+		BlockCompressor(const BlockCompressor& other) = delete;
+		BlockCompressor(BlockCompressor&& other) = delete;
+		BlockCompressor& operator=(const BlockCompressor& other) = delete;
+		BlockCompressor& operator=(BlockCompressor&& other) = delete;
+		~BlockCompressor() = delete;
+
+		static HRESULT CompressImage(_In_ const ImageData& image, _In_ eBlockFormat format, _Out_ std::vector<BYTE>& aOutBlocks);
+		static HRESULT DecompressImage(
+			_In_reads_bytes_(uSize) const BYTE* pBlocks,
+			_In_ SIZE_T uSize,
+			_In_ UINT uWidth,
+			_In_ UINT uHeight,
+			_In_ eBlockFormat format,
+			_Out_ ImageData& outImage
+		);
+		static FLOAT ComputePsnr(_In_ const ImageData& reference, _In_ const ImageData& image, _In_ eBlockFormat format);
+		static UINT GetBlockSize(_In_ eBlockFormat format);
+		static DXGI_FORMAT GetDxgiFormat(_In_ eBlockFormat format);
+
+	private:
+		static void decodeBc1Block(_In_reads_bytes_(8) const BYTE* pBlock, _In_ BOOL bAlwaysFourColors, _Out_writes_(64) BYTE* aTexels);
+		static void decodeBc4Block(_In_reads_bytes_(8) const BYTE* pBlock, _In_ UINT uChannel, _Out_writes_(64) BYTE* aTexels);
+		static void decodeBc7Block(_In_reads_bytes_(16) const BYTE* pBlock, _Out_writes_(64) BYTE* aTexels);
+		static void encodeBc1Block(_In_reads_(64) const BYTE* aTexels, _Out_writes_bytes_(8) BYTE* pBlock);
+		static void encodeBc4Block(_In_reads_(64) const BYTE* aTexels, _In_ UINT uChannel, _Out_writes_bytes_(8) BYTE* pBlock);
+		static void encodeBc7Block(_In_reads_(64) const BYTE* aTexels, _Out_writes_bytes_(16) BYTE* pBlock);
+	};
+}
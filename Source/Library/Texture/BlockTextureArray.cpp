@@ -0,0 +1,535 @@
+#include "Texture/BlockTextureArray.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Job/JobSystem.h"
+
+namespace library
+{
+	namespace
+	{
+		constexpr BYTE WHITE[4] = { 255u, 255u, 255u, 255u };
+		constexpr BYTE FLAT_NORMAL[4] = { 128u, 128u, 255u, 255u };
+
+		FLOAT srgbToLinear(_In_ FLOAT value)
+		{
+			return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		FLOAT linearToSrgb(_In_ FLOAT value)
+		{
+			return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockTextureArray::BlockTextureArray
+
+	  Summary:  Constructor
+
+	  Args:     UINT uSliceSize
+				  Width and height of every slice
+
+	  Modifies: [m_aDiffusePaths, m_aNormalPaths, m_uSliceSize,
+				 m_aDiffuseSlices, m_aNormalSlices, m_diffuseView,
+				 m_normalView].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BlockTextureArray::BlockTextureArray(_In_opt_ UINT uSliceSize)
+		: m_aDiffusePaths()
+		, m_aNormalPaths()
+		, m_uSliceSize(std::max<UINT>(1u, uSliceSize))
+		, m_aDiffuseSlices()
+		, m_aNormalSlices()
+		, m_diffuseView()
+		, m_normalView()
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockTextureArray::SetBlockTextures
+
+	  Summary:  Sets the texture files of a block type, before Pack
+
+	  Args:     eBlockType blockType
+				  Block type whose slice the files fill
+				const std::filesystem::path& diffusePath
+				  PNG or JPEG diffuse texture, empty for white
+				const std::filesystem::path& normalPath
+				  PNG or JPEG normal map, empty for a flat normal
+
+	  Modifies: [m_aDiffusePaths, m_aNormalPaths].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void BlockTextureArray::SetBlockTextures(
+		_In_ eBlockType blockType,
+		_In_ const std::filesystem::path& diffusePath,
+		_In_opt_ const std::filesystem::path& normalPath
+	)
+	{
+		UINT uSlice = GetSlice(blockType);
+		if (uSlice >= NUM_SLICES)
+		{
+			return;
+		}
+
+		m_aDiffusePaths[uSlice] = diffusePath;
+		m_aNormalPaths[uSlice] = normalPath;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockTextureArray::Pack
+
+	  Summary:  Decodes every texture file, one file per job, and packs
+				the diffuse and normal slices. A file that cannot be
+				decoded is logged and its slice filled like a missing
+				one, so one bad file does not leave the terrain
+				untextured.
+
+	  Modifies: [m_aDiffuseSlices, m_aNormalSlices].
+
+	  Returns:  HRESULT
+				  S_OK, S_FALSE if some files could not be decoded, or
+				  an error code if packing failed
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT BlockTextureArray::Pack()
+	{
+		std::vector<ImageData> aImages(NUM_SLICES * 2u);
+		std::vector<HRESULT> aResults(NUM_SLICES * 2u, S_OK);
+
+		JobSystem::GetInstance().ParallelFor(
+			NUM_SLICES * 2u,
+			1u,
+			[this, &aImages, &aResults](UINT uBegin, UINT uEnd)
+			{
+				for (UINT i = uBegin; i < uEnd; ++i)
+				{
+					const std::filesystem::path& filePath = i < NUM_SLICES ? m_aDiffusePaths[i] : m_aNormalPaths[i - NUM_SLICES];
+					if (!filePath.empty())
+					{
+						aResults[i] = ImageDecoder::DecodeFile(filePath, aImages[i]);
+						if (FAILED(aResults[i]))
+						{
+							aImages[i] = ImageData();
+						}
+					}
+				}
+			}
+		);
+
+		HRESULT hr = S_OK;
+		for (UINT i = 0u; i < NUM_SLICES * 2u; ++i)
+		{
+			if (FAILED(aResults[i]))
+			{
+				OutputDebugString(L"BlockTextureArray: can't decode \"");
+				OutputDebugString((i < NUM_SLICES ? m_aDiffusePaths[i] : m_aNormalPaths[i - NUM_SLICES]).c_str());
+				OutputDebugString(L"\", the slice is filled instead\n");
+				hr = S_FALSE;
+			}
+		}
+
+		std::vector<ImageData> aNormalImages(std::make_move_iterator(aImages.begin() + NUM_SLICES), std::make_move_iterator(aImages.end()));
+		aImages.resize(NUM_SLICES);
+
+		HRESULT packResult = PackSlices(aImages, m_uSliceSize, TRUE, WHITE, m_aDiffuseSlices);
+		if (SUCCEEDED(packResult))
+		{
+			packResult = PackSlices(aNormalImages, m_uSliceSize, FALSE, FLAT_NORMAL, m_aNormalSlices);
+		}
+
+		return FAILED(packResult) ? packResult : hr;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockTextureArray::Initialize
+
+	  Summary:  Packs the slices if Pack has not been called, creates
+				the immutable diffuse and normal texture arrays and
+				releases the CPU copy. Later calls do nothing.
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the texture arrays
+
+	  Modifies: [m_aDiffuseSlices, m_aNormalSlices, m_diffuseView,
+				 m_normalView].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT BlockTextureArray::Initialize(_In_ ID3D11Device* pDevice)
+	{
+		if (m_diffuseView)
+		{
+			return S_OK;
+		}
+
+		HRESULT hr = S_OK;
+		if (m_aDiffuseSlices.empty())
+		{
+			hr = Pack();
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+		}
+
+		hr = createArray(pDevice, m_aDiffuseSlices, m_diffuseView);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		hr = createArray(pDevice, m_aNormalSlices, m_normalView);
+		if (FAILED(hr))
+		{
+			m_diffuseView.Reset();
+			return hr;
+		}
+
+		m_aDiffuseSlices = std::vector<std::vector<ImageData>>();
+		m_aNormalSlices = std::vector<std::vector<ImageData>>();
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockTextureArray::GetDiffuseView
+
+	  Summary:  Returns the view of the diffuse texture array
+
+	  Returns:  ComPtr<ID3D11ShaderResourceView>&
+				  Texture2DArray view, null before Initialize
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	ComPtr<ID3D11ShaderResourceView>& BlockTextureArray::GetDiffuseView()
+	{
+		return m_diffuseView;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockTextureArray::GetNormalView
+
+	  Summary:  Returns the view of the normal texture array
+
+	  Returns:  ComPtr<ID3D11ShaderResourceView>&
+				  Texture2DArray view, null before Initialize
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	ComPtr<ID3D11ShaderResourceView>& BlockTextureArray::GetNormalView()
+	{
+		return m_normalView;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockTextureArray::GetSliceSize
+
+	  Summary:  Returns the width and height of a slice
+
+	  Returns:  UINT
+				  Slice size in texels
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT BlockTextureArray::GetSliceSize() const
+	{
+		return m_uSliceSize;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockTextureArray::GetSlice
+
+	  Summary:  Returns the slice of a block type, the index voxels
+				store in their instance data
+
+	  Args:     eBlockType blockType
+				  Block type
+
+	  Returns:  UINT
+				  Slice index, NUM_SLICES or more for invalid types
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT BlockTextureArray::GetSlice(_In_ eBlockType blockType)
+	{
+		return static_cast<UINT>(static_cast<INT>(blockType) - static_cast<INT>(eBlockType::GRASSLAND));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockTextureArray::PackSlices
+
+	  Summary:  Turns each image into a slice, one slice per job:
+				resized to uSliceSize squared and given the full mip
+				chain, so every slice has the same size and mips.
+				Empty images become slices of the fill color.
+
+	  Args:     const std::vector<ImageData>& aImages
+				  Top mips of the slices, empty for missing ones
+				UINT uSliceSize
+				  Width and height of every slice
+				BOOL bIsSrgb
+				  Whether the color channels are sRGB encoded
+				const BYTE aFillColor[4]
+				  RGBA of the slices without an image
+				std::vector<std::vector<ImageData>>& aOutSlices
+				  Mip chain of every slice
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT BlockTextureArray::PackSlices(
+		_In_ const std::vector<ImageData>& aImages,
+		_In_ UINT uSliceSize,
+		_In_ BOOL bIsSrgb,
+		_In_reads_(4) const BYTE aFillColor[4],
+		_Out_ std::vector<std::vector<ImageData>>& aOutSlices
+	)
+	{
+		aOutSlices.assign(aImages.size(), std::vector<ImageData>());
+		if (uSliceSize == 0u)
+		{
+			return E_INVALIDARG;
+		}
+
+		std::vector<HRESULT> aResults(aImages.size(), S_OK);
+		JobSystem::GetInstance().ParallelFor(
+			static_cast<UINT>(aImages.size()),
+			1u,
+			[&](UINT uBegin, UINT uEnd)
+			{
+				for (UINT i = uBegin; i < uEnd; ++i)
+				{
+					aResults[i] = packSlice(aImages[i], uSliceSize, bIsSrgb, aFillColor, aOutSlices[i]);
+				}
+			}
+		);
+
+		for (HRESULT hr : aResults)
+		{
+			if (FAILED(hr))
+			{
+				aOutSlices.clear();
+				return hr;
+			}
+		}
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockTextureArray::packSlice
+
+	  Summary:  Resizes one image to the slice size and builds its mip
+				chain, or fills the slice if the image is empty
+
+	  Args:     const ImageData& image
+				  Top mip, may be empty
+				UINT uSliceSize
+				  Width and height of the slice
+				BOOL bIsSrgb
+				  Whether the color channels are sRGB encoded
+				const BYTE aFillColor[4]
+				  RGBA of an empty slice
+				std::vector<ImageData>& aOutMips
+				  Mip chain of the slice
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT BlockTextureArray::packSlice(
+		_In_ const ImageData& image,
+		_In_ UINT uSliceSize,
+		_In_ BOOL bIsSrgb,
+		_In_reads_(4) const BYTE aFillColor[4],
+		_Out_ std::vector<ImageData>& aOutMips
+	)
+	{
+		aOutMips.assign(1u, ImageData());
+		ImageData& top = aOutMips[0];
+
+		if (image.aPixels.empty())
+		{
+			top.uWidth = uSliceSize;
+			top.uHeight = uSliceSize;
+			top.aPixels.resize(static_cast<SIZE_T>(uSliceSize) * uSliceSize * 4u);
+			for (SIZE_T i = 0u; i < top.aPixels.size(); i += 4u)
+			{
+				std::copy(aFillColor, aFillColor + 4, &top.aPixels[i]);
+			}
+		}
+		else if (image.uWidth == uSliceSize && image.uHeight == uSliceSize)
+		{
+			top = image;
+		}
+		else
+		{
+			resizeImage(image, uSliceSize, bIsSrgb, top);
+		}
+
+		return MipGenerator::GenerateMipChain(aOutMips, bIsSrgb);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockTextureArray::resizeImage
+
+	  Summary:  Resizes an image to uSize squared with a bilinear
+				filter that wraps around, since block textures tile.
+				Images more than twice the size are first reduced with
+				their box filtered mip chain, so the bilinear taps
+				never skip texels.
+
+	  Args:     const ImageData& source
+				  Image to resize
+				UINT uSize
+				  Width and height of the result
+				BOOL bIsSrgb
+				  Whether the color channels are sRGB encoded
+				ImageData& outImage
+				  Resized image
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void BlockTextureArray::resizeImage(_In_ const ImageData& source, _In_ UINT uSize, _In_ BOOL bIsSrgb, _Out_ ImageData& outImage)
+	{
+		std::vector<ImageData> aMips(1u, source);
+		if (source.uWidth > 2u * uSize || source.uHeight > 2u * uSize)
+		{
+			MipGenerator::GenerateMipChain(aMips, bIsSrgb);
+		}
+
+		// Smallest mip that is still at least the size in both directions, or close to it
+		const ImageData* pSource = &aMips[0];
+		for (const ImageData& mip : aMips)
+		{
+			if (mip.uWidth < uSize && mip.uHeight < uSize)
+			{
+				break;
+			}
+			if (mip.uWidth * 2u > uSize && mip.uHeight * 2u > uSize)
+			{
+				pSource = &mip;
+			}
+		}
+
+		FLOAT aToLinear[256];
+		for (UINT i = 0u; i < 256u; ++i)
+		{
+			aToLinear[i] = bIsSrgb ? srgbToLinear(i / 255.0f) : i / 255.0f;
+		}
+
+		outImage.uWidth = uSize;
+		outImage.uHeight = uSize;
+		outImage.aPixels.resize(static_cast<SIZE_T>(uSize) * uSize * 4u);
+
+		const UINT uWidth = pSource->uWidth;
+		const UINT uHeight = pSource->uHeight;
+		const FLOAT scaleX = static_cast<FLOAT>(uWidth) / static_cast<FLOAT>(uSize);
+		const FLOAT scaleY = static_cast<FLOAT>(uHeight) / static_cast<FLOAT>(uSize);
+
+		for (UINT y = 0u; y < uSize; ++y)
+		{
+			const FLOAT sourceY = (static_cast<FLOAT>(y) + 0.5f) * scaleY - 0.5f;
+			const FLOAT floorY = std::floor(sourceY);
+			const FLOAT weightY = sourceY - floorY;
+			const UINT y0 = static_cast<UINT>(static_cast<INT>(floorY) + static_cast<INT>(uHeight)) % uHeight;
+			const UINT y1 = (y0 + 1u) % uHeight;
+
+			for (UINT x = 0u; x < uSize; ++x)
+			{
+				const FLOAT sourceX = (static_cast<FLOAT>(x) + 0.5f) * scaleX - 0.5f;
+				const FLOAT floorX = std::floor(sourceX);
+				const FLOAT weightX = sourceX - floorX;
+				const UINT x0 = static_cast<UINT>(static_cast<INT>(floorX) + static_cast<INT>(uWidth)) % uWidth;
+				const UINT x1 = (x0 + 1u) % uWidth;
+
+				const BYTE* p00 = &pSource->aPixels[(static_cast<SIZE_T>(y0) * uWidth + x0) * 4u];
+				const BYTE* p01 = &pSource->aPixels[(static_cast<SIZE_T>(y0) * uWidth + x1) * 4u];
+				const BYTE* p10 = &pSource->aPixels[(static_cast<SIZE_T>(y1) * uWidth + x0) * 4u];
+				const BYTE* p11 = &pSource->aPixels[(static_cast<SIZE_T>(y1) * uWidth + x1) * 4u];
+				BYTE* pOut = &outImage.aPixels[(static_cast<SIZE_T>(y) * uSize + x) * 4u];
+
+				for (UINT c = 0u; c < 4u; ++c)
+				{
+					const BOOL bIsColor = bIsSrgb && c < 3u;
+					auto load = [&](const BYTE* pTexel) { return bIsColor ? aToLinear[pTexel[c]] : pTexel[c] / 255.0f; };
+
+					FLOAT value = (load(p00) * (1.0f - weightX) + load(p01) * weightX) * (1.0f - weightY)
+						+ (load(p10) * (1.0f - weightX) + load(p11) * weightX) * weightY;
+					value = std::clamp(value, 0.0f, 1.0f);
+					if (bIsColor)
+					{
+						value = linearToSrgb(value);
+					}
+					pOut[c] = static_cast<BYTE>(std::lround(value * 255.0f));
+				}
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   BlockTextureArray::createArray
+
+	  Summary:  Creates an immutable Texture2DArray with every slice
+				and mip as initial data and its shader resource view
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the texture
+				const std::vector<std::vector<ImageData>>& aSlices
+				  Mip chain of every slice, all of the same size
+				ComPtr<ID3D11ShaderResourceView>& outView
+				  View of the whole array
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT BlockTextureArray::createArray(
+		_In_ ID3D11Device* pDevice,
+		_In_ const std::vector<std::vector<ImageData>>& aSlices,
+		_Out_ ComPtr<ID3D11ShaderResourceView>& outView
+	)
+	{
+		if (aSlices.empty() || aSlices[0].empty())
+		{
+			return E_FAIL;
+		}
+
+		const UINT uNumMips = static_cast<UINT>(aSlices[0].size());
+
+		// Subresources are ordered by slice, then by mip
+		std::vector<D3D11_SUBRESOURCE_DATA> aInitialData;
+		aInitialData.reserve(aSlices.size() * uNumMips);
+		for (const std::vector<ImageData>& aMips : aSlices)
+		{
+			if (aMips.size() != uNumMips)
+			{
+				return E_INVALIDARG;
+			}
+
+			for (const ImageData& mip : aMips)
+			{
+				aInitialData.push_back(
+					D3D11_SUBRESOURCE_DATA
+					{
+						.pSysMem = mip.aPixels.data(),
+						.SysMemPitch = mip.uWidth * 4u,
+						.SysMemSlicePitch = 0u
+					}
+				);
+			}
+		}
+
+		D3D11_TEXTURE2D_DESC desc =
+		{
+			.Width = aSlices[0][0].uWidth,
+			.Height = aSlices[0][0].uHeight,
+			.MipLevels = uNumMips,
+			.ArraySize = static_cast<UINT>(aSlices.size()),
+			.Format = DXGI_FORMAT_R8G8B8A8_UNORM,
+			.SampleDesc = {.Count = 1u, .Quality = 0u },
+			.Usage = D3D11_USAGE_IMMUTABLE,
+			.BindFlags = D3D11_BIND_SHADER_RESOURCE,
+			.CPUAccessFlags = 0u,
+			.MiscFlags = 0u
+		};
+
+		ComPtr<ID3D11Texture2D> texture;
+		HRESULT hr = pDevice->CreateTexture2D(&desc, aInitialData.data(), texture.GetAddressOf());
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		return pDevice->CreateShaderResourceView(texture.Get(), nullptr, outView.ReleaseAndGetAddressOf());
+	}
+}
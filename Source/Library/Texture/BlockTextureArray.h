@@ -0,0 +1,102 @@
+/*+===================================================================
+  File:      BLOCKTEXTUREARRAY.H
+
+  Summary:   BlockTextureArray header file contains declarations of
+			 BlockTextureArray class that packs the diffuse and
+			 normal textures of every block type into texture arrays.
+
+  Classes: BlockTextureArray
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/MipGenerator.h"
+
+namespace library
+{
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    BlockTextureArray
+
+	  Summary:  Packs one diffuse and one normal texture per block type
+				into two Texture2DArrays, one slice per type, so voxels
+				of every type are drawn with a single bind and pick
+				their slice from the block type in their instance data.
+				Every slice is resized to the same square size and gets
+				the same mip chain. Types without a texture get a white
+				diffuse slice and a flat normal slice. Packing runs on
+				the job system without the device.
+
+	  Methods:  SetBlockTextures
+				  Sets the texture files of a block type
+				Pack
+				  Decodes and packs the texture files
+				Initialize
+				  Packs if needed and creates the texture arrays
+				GetDiffuseView
+				  Returns the view of the diffuse texture array
+				GetNormalView
+				  Returns the view of the normal texture array
+				GetSliceSize
+				  Returns the width and height of a slice
+				GetSlice
+				  Returns the slice of a block type
+				PackSlices
+				  Resizes images to one size and builds their mips
+				BlockTextureArray
+				  Constructor.
+				~BlockTextureArray
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class BlockTextureArray final
+	{
+	public:
+		static constexpr UINT NUM_SLICES = static_cast<UINT>(eBlockType::COUNT) - static_cast<UINT>(eBlockType::GRASSLAND);
+		static constexpr UINT DEFAULT_SLICE_SIZE = 256u;
+
+	public:
+		BlockTextureArray(_In_opt_ UINT uSliceSize = DEFAULT_SLICE_SIZE);
+		BlockTextureArray(const BlockTextureArray& other) = delete;
+		BlockTextureArray(BlockTextureArray&& other) = delete;
+		BlockTextureArray& operator=(const BlockTextureArray& other) = delete;
+		BlockTextureArray& operator=(BlockTextureArray&& other) = delete;
+		~BlockTextureArray() = default;
+
+		void SetBlockTextures(
+			_In_ eBlockType blockType,
+			_In_ const std::filesystem::path& diffusePath,
+			_In_opt_ const std::filesystem::path& normalPath = std::filesystem::path()
+		);
+		HRESULT Pack();
+		HRESULT Initialize(_In_ ID3D11Device* pDevice);
+
+		ComPtr<ID3D11ShaderResourceView>& GetDiffuseView();
+		ComPtr<ID3D11ShaderResourceView>& GetNormalView();
+		UINT GetSliceSize() const;
+
+		static UINT GetSlice(_In_ eBlockType blockType);
+		static HRESULT PackSlices(
+			_In_ const std::vector<ImageData>& aImages,
+			_In_ UINT uSliceSize,
+			_In_ BOOL bIsSrgb,
+			_In_reads_(4) const BYTE aFillColor[4],
+			_Out_ std::vector<std::vector<ImageData>>& aOutSlices
+		);
+
+	private:
+		static HRESULT packSlice(_In_ const ImageData& image, _In_ UINT uSliceSize, _In_ BOOL bIsSrgb, _In_reads_(4) const BYTE aFillColor[4], _Out_ std::vector<ImageData>& aOutMips);
+		static void resizeImage(_In_ const ImageData& source, _In_ UINT uSize, _In_ BOOL bIsSrgb, _Out_ ImageData& outImage);
+		static HRESULT createArray(_In_ ID3D11Device* pDevice, _In_ const std::vector<std::vector<ImageData>>& aSlices, _Out_ ComPtr<ID3D11ShaderResourceView>& outView);
+
+	private:
+		std::filesystem::path m_aDiffusePaths[NUM_SLICES];
+		std::filesystem::path m_aNormalPaths[NUM_SLICES];
+		UINT m_uSliceSize;
+		std::vector<std::vector<ImageData>> m_aDiffuseSlices;
+		std::vector<std::vector<ImageData>> m_aNormalSlices;
+		ComPtr<ID3D11ShaderResourceView> m_diffuseView;
+		ComPtr<ID3D11ShaderResourceView> m_normalView;
+	};
+}
@@ -0,0 +1,178 @@
+//--------------------------------------------------------------------------------------
+// File: DDSLayout.h
+//
+// DDS file structures, header validation and surface layout shared by the DDS loader
+// and the texture cooker. Nothing here depends on Direct3D, only on DXGI_FORMAT, so it
+// also builds on Linux against the DirectX-Headers WSL adapter.
+//
+// Split out of DDSTextureLoader11.cpp.
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+// http://go.microsoft.com/fwlink/?LinkId=248929
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <wsl/winadapter.h>
+#endif
+
+#include <dxgiformat.h>
+
+#include <cstddef>
+#include <cstdint>
+
+//--------------------------------------------------------------------------------------
+// Macros
+//--------------------------------------------------------------------------------------
+#ifndef MAKEFOURCC
+#define MAKEFOURCC(ch0, ch1, ch2, ch3)                              \
+                ((uint32_t)(uint8_t)(ch0) | ((uint32_t)(uint8_t)(ch1) << 8) |       \
+                ((uint32_t)(uint8_t)(ch2) << 16) | ((uint32_t)(uint8_t)(ch3) << 24 ))
+#endif /* defined(MAKEFOURCC) */
+
+namespace DirectX
+{
+	//--------------------------------------------------------------------------------------
+	// DDS file structure definitions
+	//
+	// See DDS.h in the 'Texconv' sample and the 'DirectXTex' library
+	//--------------------------------------------------------------------------------------
+#pragma pack(push,1)
+
+	constexpr uint32_t DDS_MAGIC = 0x20534444; // "DDS "
+
+	struct DDS_PIXELFORMAT
+	{
+		uint32_t    size;
+		uint32_t    flags;
+		uint32_t    fourCC;
+		uint32_t    RGBBitCount;
+		uint32_t    RBitMask;
+		uint32_t    GBitMask;
+		uint32_t    BBitMask;
+		uint32_t    ABitMask;
+	};
+
+#define DDS_FOURCC      0x00000004  // DDPF_FOURCC
+#define DDS_RGB         0x00000040  // DDPF_RGB
+#define DDS_LUMINANCE   0x00020000  // DDPF_LUMINANCE
+#define DDS_ALPHA       0x00000002  // DDPF_ALPHA
+#define DDS_BUMPDUDV    0x00080000  // DDPF_BUMPDUDV
+
+#define DDS_HEADER_FLAGS_TEXTURE        0x00001007  // DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT
+#define DDS_HEADER_FLAGS_MIPMAP         0x00020000  // DDSD_MIPMAPCOUNT
+#define DDS_HEADER_FLAGS_VOLUME         0x00800000  // DDSD_DEPTH
+#define DDS_HEADER_FLAGS_LINEARSIZE     0x00080000  // DDSD_LINEARSIZE
+
+#define DDS_HEIGHT 0x00000002 // DDSD_HEIGHT
+
+#define DDS_SURFACE_FLAGS_TEXTURE 0x00001000 // DDSCAPS_TEXTURE
+#define DDS_SURFACE_FLAGS_MIPMAP  0x00400008 // DDSCAPS_COMPLEX | DDSCAPS_MIPMAP
+
+#define DDS_CUBEMAP_POSITIVEX 0x00000600 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_POSITIVEX
+#define DDS_CUBEMAP_NEGATIVEX 0x00000a00 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_NEGATIVEX
+#define DDS_CUBEMAP_POSITIVEY 0x00001200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_POSITIVEY
+#define DDS_CUBEMAP_NEGATIVEY 0x00002200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_NEGATIVEY
+#define DDS_CUBEMAP_POSITIVEZ 0x00004200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_POSITIVEZ
+#define DDS_CUBEMAP_NEGATIVEZ 0x00008200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_NEGATIVEZ
+
+#define DDS_CUBEMAP_ALLFACES ( DDS_CUBEMAP_POSITIVEX | DDS_CUBEMAP_NEGATIVEX |\
+                               DDS_CUBEMAP_POSITIVEY | DDS_CUBEMAP_NEGATIVEY |\
+                               DDS_CUBEMAP_POSITIVEZ | DDS_CUBEMAP_NEGATIVEZ )
+
+#define DDS_CUBEMAP 0x00000200 // DDSCAPS2_CUBEMAP
+
+	enum DDS_MISC_FLAGS2
+	{
+		DDS_MISC_FLAGS2_ALPHA_MODE_MASK = 0x7L,
+	};
+
+	struct DDS_HEADER
+	{
+		uint32_t        size;
+		uint32_t        flags;
+		uint32_t        height;
+		uint32_t        width;
+		uint32_t        pitchOrLinearSize;
+		uint32_t        depth; // only if DDS_HEADER_FLAGS_VOLUME is set in flags
+		uint32_t        mipMapCount;
+		uint32_t        reserved1[11];
+		DDS_PIXELFORMAT ddspf;
+		uint32_t        caps;
+		uint32_t        caps2;
+		uint32_t        caps3;
+		uint32_t        caps4;
+		uint32_t        reserved2;
+	};
+
+	struct DDS_HEADER_DXT10
+	{
+		DXGI_FORMAT     dxgiFormat;
+		uint32_t        resourceDimension;
+		uint32_t        miscFlag; // see D3D11_RESOURCE_MISC_FLAG
+		uint32_t        arraySize;
+		uint32_t        miscFlags2;
+	};
+
+#pragma pack(pop)
+
+	static_assert(sizeof(DDS_HEADER) == 124, "DDS Header size mismatch");
+	static_assert(sizeof(DDS_HEADER_DXT10) == 20, "DDS DX10 Extended Header size mismatch");
+
+	// Validates the magic number and headers of a DDS file in memory and points to its
+	// headers and surface data, without copying anything
+	HRESULT ParseDDSHeader(
+		_In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
+		_In_ size_t ddsDataSize,
+		_Outptr_ const DDS_HEADER** header,
+		_Outptr_ const uint8_t** bitData,
+		_Out_ size_t* bitSize) noexcept;
+
+	// Returns the bits per pixel of a format, 0 for formats the loader does not support
+	size_t BitsPerPixel(_In_ DXGI_FORMAT fmt) noexcept;
+
+	// Returns the size, row pitch and number of rows of one surface
+	HRESULT GetSurfaceInfo(
+		_In_ size_t width,
+		_In_ size_t height,
+		_In_ DXGI_FORMAT fmt,
+		_Out_opt_ size_t* outNumBytes,
+		_Out_opt_ size_t* outRowBytes,
+		_Out_opt_ size_t* outNumRows) noexcept;
+
+	// Returns the format described by a legacy DDS pixel format
+	DXGI_FORMAT GetDXGIFormat(_In_ const DDS_PIXELFORMAT& ddpf) noexcept;
+
+	// Where a mip of an array slice starts in the surface data, and its pitches
+	struct DDS_SUBRESOURCE_LAYOUT
+	{
+		size_t offset;
+		size_t rowPitch;
+		size_t slicePitch;
+	};
+
+	// Lays out the mips of every array slice one after another in the surface data, the
+	// way the loader points its subresources at them. Mips larger than maxsize, when it
+	// is not 0, are skipped; returns the size of the first mip kept and how many were
+	// skipped. Fills one layout per mip kept of each slice.
+	HRESULT GetSubresourceLayout(
+		_In_ size_t width,
+		_In_ size_t height,
+		_In_ size_t depth,
+		_In_ size_t mipCount,
+		_In_ size_t arraySize,
+		_In_ DXGI_FORMAT fmt,
+		_In_ size_t maxsize,
+		_In_ size_t bitSize,
+		_Out_ size_t& twidth,
+		_Out_ size_t& theight,
+		_Out_ size_t& tdepth,
+		_Out_ size_t& skipMip,
+		_Out_writes_(mipCount* arraySize) DDS_SUBRESOURCE_LAYOUT* layouts) noexcept;
+}
@@ -0,0 +1,1436 @@
+#include "Texture/ImageDecoder.h"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cmath>
+#include <cwctype>
+#include <fstream>
+
+namespace library
+{
+	namespace
+	{
+		/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+		  Class:    InflateStream
+
+		  Summary:  Decompresses a raw deflate stream (RFC 1951). Huffman
+					codes up to FAST_BITS long are decoded with a single
+					table lookup, longer ones bit by bit.
+
+		  Methods:  Inflate
+					  Appends the decompressed bytes to the output
+		C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+		class InflateStream final
+		{
+		public:
+			InflateStream(_In_reads_bytes_(uSize) const BYTE* pData, _In_ SIZE_T uSize)
+				: m_pData(pData)
+				, m_uSize(uSize)
+				, m_uPos(0u)
+				, m_uBits(0ull)
+				, m_uNumBits(0u)
+				, m_uNumPadBytes(0u)
+			{
+			}
+
+			HRESULT Inflate(_Inout_ std::vector<BYTE>& aOut)
+			{
+				BOOL bFinal = FALSE;
+				while (!bFinal)
+				{
+					bFinal = static_cast<BOOL>(getBits(1u));
+					UINT uType = getBits(2u);
+
+					HRESULT hr = S_OK;
+					switch (uType)
+					{
+					case 0u:
+						hr = inflateStored(aOut);
+						break;
+					case 1u:
+						buildFixedTables();
+						hr = inflateCodes(aOut);
+						break;
+					case 2u:
+						hr = buildDynamicTables();
+						if (SUCCEEDED(hr))
+						{
+							hr = inflateCodes(aOut);
+						}
+						break;
+					default:
+						hr = E_FAIL;
+						break;
+					}
+
+					if (FAILED(hr))
+					{
+						return hr;
+					}
+				}
+
+				return S_OK;
+			}
+
+		private:
+			static constexpr UINT FAST_BITS = 10u;
+			static constexpr UINT MAX_CODE_LENGTH = 15u;
+			static constexpr UINT MAX_PAD_BYTES = 16u;
+
+			struct Huffman
+			{
+				UINT16 aFast[1u << FAST_BITS];
+				UINT16 aCounts[MAX_CODE_LENGTH + 1u];
+				UINT16 aSymbols[288];
+			};
+
+			HRESULT buildHuffman(_In_reads_(uNumSymbols) const BYTE* aLengths, _In_ UINT uNumSymbols, _Out_ Huffman& outHuffman)
+			{
+				std::fill(std::begin(outHuffman.aFast), std::end(outHuffman.aFast), static_cast<UINT16>(0u));
+				std::fill(std::begin(outHuffman.aCounts), std::end(outHuffman.aCounts), static_cast<UINT16>(0u));
+
+				for (UINT i = 0u; i < uNumSymbols; ++i)
+				{
+					++outHuffman.aCounts[aLengths[i]];
+				}
+				outHuffman.aCounts[0] = 0u;
+
+				INT iLeft = 1;
+				for (UINT uLength = 1u; uLength <= MAX_CODE_LENGTH; ++uLength)
+				{
+					iLeft <<= 1;
+					iLeft -= outHuffman.aCounts[uLength];
+					if (iLeft < 0)
+					{
+						return E_FAIL;
+					}
+				}
+
+				UINT16 aOffsets[MAX_CODE_LENGTH + 2u] = { 0u, };
+				for (UINT uLength = 1u; uLength <= MAX_CODE_LENGTH; ++uLength)
+				{
+					aOffsets[uLength + 1u] = aOffsets[uLength] + outHuffman.aCounts[uLength];
+				}
+
+				for (UINT i = 0u; i < uNumSymbols; ++i)
+				{
+					if (aLengths[i] != 0u)
+					{
+						outHuffman.aSymbols[aOffsets[aLengths[i]]++] = static_cast<UINT16>(i);
+					}
+				}
+
+				// Canonical codes are stored most significant bit first, the stream is read least significant bit first
+				UINT uCode = 0u;
+				UINT uIndex = 0u;
+				for (UINT uLength = 1u; uLength <= MAX_CODE_LENGTH; ++uLength)
+				{
+					for (UINT k = 0u; k < outHuffman.aCounts[uLength]; ++k, ++uIndex, ++uCode)
+					{
+						if (uLength > FAST_BITS)
+						{
+							continue;
+						}
+
+						UINT uReversed = 0u;
+						for (UINT uBit = 0u; uBit < uLength; ++uBit)
+						{
+							uReversed |= ((uCode >> uBit) & 1u) << (uLength - 1u - uBit);
+						}
+
+						UINT16 uEntry = static_cast<UINT16>((outHuffman.aSymbols[uIndex] << 4u) | uLength);
+						for (UINT j = uReversed; j < (1u << FAST_BITS); j += 1u << uLength)
+						{
+							outHuffman.aFast[j] = uEntry;
+						}
+					}
+					uCode <<= 1u;
+				}
+
+				return S_OK;
+			}
+
+			void buildFixedTables()
+			{
+				BYTE aLengths[288 + 30];
+				std::fill(aLengths, aLengths + 144, static_cast<BYTE>(8u));
+				std::fill(aLengths + 144, aLengths + 256, static_cast<BYTE>(9u));
+				std::fill(aLengths + 256, aLengths + 280, static_cast<BYTE>(7u));
+				std::fill(aLengths + 280, aLengths + 288, static_cast<BYTE>(8u));
+				std::fill(aLengths + 288, aLengths + 318, static_cast<BYTE>(5u));
+
+				buildHuffman(aLengths, 288u, m_literals);
+				buildHuffman(aLengths + 288, 30u, m_distances);
+			}
+
+			HRESULT buildDynamicTables()
+			{
+				static constexpr BYTE s_aOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+				UINT uNumLiterals = getBits(5u) + 257u;
+				UINT uNumDistances = getBits(5u) + 1u;
+				UINT uNumCodeLengths = getBits(4u) + 4u;
+				if (uNumLiterals > 286u || uNumDistances > 30u)
+				{
+					return E_FAIL;
+				}
+
+				BYTE aCodeLengths[19] = { 0u, };
+				for (UINT i = 0u; i < uNumCodeLengths; ++i)
+				{
+					aCodeLengths[s_aOrder[i]] = static_cast<BYTE>(getBits(3u));
+				}
+
+				Huffman codeLengths;
+				HRESULT hr = buildHuffman(aCodeLengths, 19u, codeLengths);
+				if (FAILED(hr))
+				{
+					return hr;
+				}
+
+				BYTE aLengths[286 + 30] = { 0u, };
+				UINT uNumLengths = uNumLiterals + uNumDistances;
+				for (UINT i = 0u; i < uNumLengths;)
+				{
+					INT iSymbol = decode(codeLengths);
+					if (iSymbol < 0)
+					{
+						return E_FAIL;
+					}
+
+					if (iSymbol < 16)
+					{
+						aLengths[i++] = static_cast<BYTE>(iSymbol);
+						continue;
+					}
+
+					BYTE uValue = 0u;
+					UINT uRepeat = 0u;
+					if (iSymbol == 16)
+					{
+						if (i == 0u)
+						{
+							return E_FAIL;
+						}
+						uValue = aLengths[i - 1u];
+						uRepeat = 3u + getBits(2u);
+					}
+					else if (iSymbol == 17)
+					{
+						uRepeat = 3u + getBits(3u);
+					}
+					else
+					{
+						uRepeat = 11u + getBits(7u);
+					}
+
+					if (i + uRepeat > uNumLengths)
+					{
+						return E_FAIL;
+					}
+
+					std::fill(aLengths + i, aLengths + i + uRepeat, uValue);
+					i += uRepeat;
+				}
+
+				hr = buildHuffman(aLengths, uNumLiterals, m_literals);
+				if (FAILED(hr))
+				{
+					return hr;
+				}
+
+				return buildHuffman(aLengths + uNumLiterals, uNumDistances, m_distances);
+			}
+
+			INT decode(_In_ const Huffman& huffman)
+			{
+				refill();
+
+				UINT uEntry = huffman.aFast[m_uBits & ((1u << FAST_BITS) - 1u)];
+				if (uEntry != 0u)
+				{
+					consume(uEntry & 15u);
+					return static_cast<INT>(uEntry >> 4u);
+				}
+
+				UINT64 uBits = m_uBits;
+				INT iCode = 0;
+				INT iFirst = 0;
+				INT iIndex = 0;
+				for (UINT uLength = 1u; uLength <= MAX_CODE_LENGTH; ++uLength)
+				{
+					iCode |= static_cast<INT>(uBits & 1u);
+					uBits >>= 1u;
+
+					INT iCount = huffman.aCounts[uLength];
+					if (iCode - iFirst < iCount)
+					{
+						consume(uLength);
+						return huffman.aSymbols[iIndex + iCode - iFirst];
+					}
+
+					iIndex += iCount;
+					iFirst += iCount;
+					iFirst <<= 1;
+					iCode <<= 1;
+				}
+
+				return -1;
+			}
+
+			HRESULT inflateCodes(_Inout_ std::vector<BYTE>& aOut)
+			{
+				static constexpr UINT16 s_aLengthBases[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+				static constexpr BYTE s_aLengthExtras[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+				static constexpr UINT16 s_aDistanceBases[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+				static constexpr BYTE s_aDistanceExtras[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+				for (;;)
+				{
+					if (m_uNumPadBytes > MAX_PAD_BYTES)
+					{
+						return E_FAIL;
+					}
+
+					INT iSymbol = decode(m_literals);
+					if (iSymbol < 0)
+					{
+						return E_FAIL;
+					}
+
+					if (iSymbol < 256)
+					{
+						aOut.push_back(static_cast<BYTE>(iSymbol));
+						continue;
+					}
+
+					if (iSymbol == 256)
+					{
+						return S_OK;
+					}
+
+					iSymbol -= 257;
+					if (iSymbol >= 29)
+					{
+						return E_FAIL;
+					}
+					UINT uLength = s_aLengthBases[iSymbol] + getBits(s_aLengthExtras[iSymbol]);
+
+					INT iDistanceSymbol = decode(m_distances);
+					if (iDistanceSymbol < 0 || iDistanceSymbol >= 30)
+					{
+						return E_FAIL;
+					}
+					SIZE_T uDistance = s_aDistanceBases[iDistanceSymbol] + getBits(s_aDistanceExtras[iDistanceSymbol]);
+					if (uDistance > aOut.size())
+					{
+						return E_FAIL;
+					}
+
+					// The copy may overlap the bytes it produces, so it goes byte by byte
+					SIZE_T uFrom = aOut.size() - uDistance;
+					for (UINT i = 0u; i < uLength; ++i)
+					{
+						aOut.push_back(aOut[uFrom + i]);
+					}
+				}
+			}
+
+			HRESULT inflateStored(_Inout_ std::vector<BYTE>& aOut)
+			{
+				consume(m_uNumBits & 7u);
+
+				UINT uLength = getBits(16u);
+				UINT uComplement = getBits(16u);
+				if ((uLength ^ 0xFFFFu) != uComplement)
+				{
+					return E_FAIL;
+				}
+
+				for (UINT i = 0u; i < uLength; ++i)
+				{
+					aOut.push_back(static_cast<BYTE>(getBits(8u)));
+				}
+
+				return m_uNumPadBytes > MAX_PAD_BYTES ? E_FAIL : S_OK;
+			}
+
+			UINT getBits(_In_ UINT uNumBits)
+			{
+				if (uNumBits == 0u)
+				{
+					return 0u;
+				}
+
+				refill();
+
+				UINT uValue = static_cast<UINT>(m_uBits & ((1ull << uNumBits) - 1ull));
+				consume(uNumBits);
+
+				return uValue;
+			}
+
+			void consume(_In_ UINT uNumBits)
+			{
+				m_uBits >>= uNumBits;
+				m_uNumBits -= uNumBits;
+			}
+
+			void refill()
+			{
+				// Past the end the stream reads as zeros, a truncated file fails on the pad byte count
+				while (m_uNumBits <= 56u)
+				{
+					BYTE uByte = 0u;
+					if (m_uPos < m_uSize)
+					{
+						uByte = m_pData[m_uPos];
+					}
+					else
+					{
+						++m_uNumPadBytes;
+					}
+
+					++m_uPos;
+					m_uBits |= static_cast<UINT64>(uByte) << m_uNumBits;
+					m_uNumBits += 8u;
+				}
+			}
+
+		private:
+			const BYTE* m_pData;
+			SIZE_T m_uSize;
+			SIZE_T m_uPos;
+			UINT64 m_uBits;
+			UINT m_uNumBits;
+			UINT m_uNumPadBytes;
+			Huffman m_literals;
+			Huffman m_distances;
+		};
+
+		/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+		  Class:    JpegBitReader
+
+		  Summary:  Reads the entropy coded segment of a JPEG scan most
+					significant bit first, removing the stuffed zero
+					bytes and stopping at the next marker
+
+		  Methods:  Reset
+					  Starts reading at the given byte
+					SkipRestartMarker
+					  Moves past the next restart marker
+					Decode
+					  Decodes a Huffman symbol
+					ReceiveExtend
+					  Reads a signed coefficient of the given size
+		C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+		class JpegBitReader final
+		{
+		public:
+			struct Huffman
+			{
+				UINT16 aFast[1u << 9u];
+				INT aMaxCodes[18];
+				INT aValueOffsets[17];
+				BYTE aValues[256];
+				BOOL bDefined;
+			};
+
+			static constexpr UINT FAST_BITS = 9u;
+
+			JpegBitReader(_In_reads_bytes_(uSize) const BYTE* pData, _In_ SIZE_T uSize)
+				: m_pData(pData)
+				, m_uSize(uSize)
+				, m_uPos(0u)
+				, m_uBits(0u)
+				, m_iNumBits(0)
+				, m_bMarkerHit(FALSE)
+			{
+			}
+
+			static HRESULT BuildHuffman(_In_reads_(16) const BYTE* aCounts, _In_reads_(256) const BYTE* aValues, _Out_ Huffman& outHuffman)
+			{
+				std::fill(std::begin(outHuffman.aFast), std::end(outHuffman.aFast), static_cast<UINT16>(0u));
+
+				UINT uNumValues = 0u;
+				for (UINT i = 0u; i < 16u; ++i)
+				{
+					uNumValues += aCounts[i];
+				}
+				if (uNumValues > 256u)
+				{
+					return E_FAIL;
+				}
+				std::copy(aValues, aValues + uNumValues, outHuffman.aValues);
+
+				INT iCode = 0;
+				INT iIndex = 0;
+				for (UINT uLength = 1u; uLength <= 16u; ++uLength)
+				{
+					outHuffman.aValueOffsets[uLength] = iIndex - iCode;
+					for (UINT k = 0u; k < aCounts[uLength - 1u]; ++k, ++iIndex, ++iCode)
+					{
+						if (uLength <= FAST_BITS)
+						{
+							UINT uFirst = static_cast<UINT>(iCode) << (FAST_BITS - uLength);
+							UINT uCount = 1u << (FAST_BITS - uLength);
+							for (UINT j = 0u; j < uCount; ++j)
+							{
+								outHuffman.aFast[uFirst + j] = static_cast<UINT16>((uLength << 8u) | outHuffman.aValues[iIndex]);
+							}
+						}
+					}
+					outHuffman.aMaxCodes[uLength] = aCounts[uLength - 1u] > 0u ? iCode - 1 : -1;
+					iCode <<= 1;
+				}
+				outHuffman.aMaxCodes[17] = INT_MAX;
+				outHuffman.bDefined = TRUE;
+
+				return S_OK;
+			}
+
+			void Reset(_In_ SIZE_T uPos)
+			{
+				m_uPos = uPos;
+				m_uBits = 0u;
+				m_iNumBits = 0;
+				m_bMarkerHit = FALSE;
+			}
+
+			SIZE_T GetPosition() const
+			{
+				return m_uPos;
+			}
+
+			void SkipRestartMarker()
+			{
+				while (m_uPos + 1u < m_uSize && !(m_pData[m_uPos] == 0xFFu && m_pData[m_uPos + 1u] >= 0xD0u && m_pData[m_uPos + 1u] <= 0xD7u))
+				{
+					++m_uPos;
+				}
+				Reset(std::min<SIZE_T>(m_uPos + 2u, m_uSize));
+			}
+
+			INT Decode(_In_ const Huffman& huffman)
+			{
+				fill();
+
+				UINT uEntry = huffman.aFast[m_uBits >> (32u - FAST_BITS)];
+				if (uEntry != 0u)
+				{
+					consume(static_cast<INT>(uEntry >> 8u));
+					return static_cast<INT>(uEntry & 0xFFu);
+				}
+
+				INT iCode = static_cast<INT>(m_uBits >> (32u - FAST_BITS));
+				for (UINT uLength = FAST_BITS + 1u; uLength <= 16u; ++uLength)
+				{
+					iCode = static_cast<INT>(m_uBits >> (32u - uLength));
+					if (iCode <= huffman.aMaxCodes[uLength])
+					{
+						consume(static_cast<INT>(uLength));
+						return huffman.aValues[huffman.aValueOffsets[uLength] + iCode];
+					}
+				}
+
+				return -1;
+			}
+
+			INT ReceiveExtend(_In_ UINT uSize)
+			{
+				if (uSize == 0u)
+				{
+					return 0;
+				}
+
+				fill();
+
+				INT iValue = static_cast<INT>(m_uBits >> (32u - uSize));
+				consume(static_cast<INT>(uSize));
+
+				if (iValue < (1 << (uSize - 1u)))
+				{
+					iValue += static_cast<INT>((~0u) << uSize) + 1;
+				}
+
+				return iValue;
+			}
+
+		private:
+			void fill()
+			{
+				while (m_iNumBits <= 24)
+				{
+					UINT uByte = 0u;
+					if (!m_bMarkerHit && m_uPos < m_uSize)
+					{
+						uByte = m_pData[m_uPos];
+						if (uByte == 0xFFu)
+						{
+							UINT uNext = m_uPos + 1u < m_uSize ? m_pData[m_uPos + 1u] : 0u;
+							if (uNext == 0x00u)
+							{
+								m_uPos += 2u;
+							}
+							else
+							{
+								m_bMarkerHit = TRUE;
+								uByte = 0u;
+							}
+						}
+						else
+						{
+							++m_uPos;
+						}
+					}
+
+					m_uBits |= uByte << (24 - m_iNumBits);
+					m_iNumBits += 8;
+				}
+			}
+
+			void consume(_In_ INT iNumBits)
+			{
+				m_uBits <<= iNumBits;
+				m_iNumBits -= iNumBits;
+			}
+
+		private:
+			const BYTE* m_pData;
+			SIZE_T m_uSize;
+			SIZE_T m_uPos;
+			UINT32 m_uBits;
+			INT m_iNumBits;
+			BOOL m_bMarkerHit;
+		};
+
+		/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+		  Function: inverseDct
+
+		  Summary:  Separable float inverse DCT of a dequantized 8x8
+					block, level shifted and clamped to 8 bits
+
+		  Args:     const FLOAT* aCoefficients
+					  64 coefficients in natural order
+					BYTE* pOut
+					  Top left texel of the block
+					SIZE_T uStride
+					  Bytes between two rows of the output
+		F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+		void inverseDct(_In_reads_(64) const FLOAT* aCoefficients, _Out_ BYTE* pOut, _In_ SIZE_T uStride)
+		{
+			static const struct CosineTable
+			{
+				CosineTable()
+				{
+					for (UINT x = 0u; x < 8u; ++x)
+					{
+						for (UINT u = 0u; u < 8u; ++u)
+						{
+							FLOAT scale = u == 0u ? 1.0f / std::sqrt(2.0f) : 1.0f;
+							aValues[x][u] = 0.5f * scale * std::cos(static_cast<FLOAT>((2u * x + 1u) * u) * 3.14159265358979f / 16.0f);
+						}
+					}
+				}
+
+				FLOAT aValues[8][8];
+			} s_cosines;
+
+			FLOAT aRows[64];
+			for (UINT v = 0u; v < 8u; ++v)
+			{
+				for (UINT x = 0u; x < 8u; ++x)
+				{
+					FLOAT sum = 0.0f;
+					for (UINT u = 0u; u < 8u; ++u)
+					{
+						sum += s_cosines.aValues[x][u] * aCoefficients[v * 8u + u];
+					}
+					aRows[v * 8u + x] = sum;
+				}
+			}
+
+			for (UINT y = 0u; y < 8u; ++y)
+			{
+				for (UINT x = 0u; x < 8u; ++x)
+				{
+					FLOAT sum = 128.0f;
+					for (UINT v = 0u; v < 8u; ++v)
+					{
+						sum += s_cosines.aValues[y][v] * aRows[v * 8u + x];
+					}
+					pOut[y * uStride + x] = static_cast<BYTE>(std::clamp<FLOAT>(std::round(sum), 0.0f, 255.0f));
+				}
+			}
+		}
+
+		UINT readBigEndian16(_In_reads_bytes_(2) const BYTE* p)
+		{
+			return (static_cast<UINT>(p[0]) << 8u) | p[1];
+		}
+
+		UINT readBigEndian32(_In_reads_bytes_(4) const BYTE* p)
+		{
+			return (static_cast<UINT>(p[0]) << 24u) | (static_cast<UINT>(p[1]) << 16u) | (static_cast<UINT>(p[2]) << 8u) | p[3];
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ImageDecoder::DecodeFile
+
+	  Summary:  Reads the whole file and decodes it
+
+	  Args:     const std::filesystem::path& filePath
+				  Path to the image
+				ImageData& outImage
+				  Decoded RGBA pixels
+
+	  Returns:  HRESULT
+				  Status code, E_NOTIMPL for files to load otherwise
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT ImageDecoder::DecodeFile(_In_ const std::filesystem::path& filePath, _Out_ ImageData& outImage)
+	{
+		std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			return E_FAIL;
+		}
+
+		std::streamsize size = file.tellg();
+		if (size <= 0)
+		{
+			return E_FAIL;
+		}
+
+		std::vector<BYTE> aData(static_cast<SIZE_T>(size));
+		file.seekg(0, std::ios::beg);
+		if (!file.read(reinterpret_cast<CHAR*>(aData.data()), size))
+		{
+			return E_FAIL;
+		}
+
+		return DecodeMemory(aData.data(), aData.size(), outImage);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ImageDecoder::DecodeMemory
+
+	  Summary:  Decodes a PNG or JPEG file image by its signature
+
+	  Args:     const BYTE* pData
+				  File contents
+				SIZE_T uSize
+				  Size of the file in bytes
+				ImageData& outImage
+				  Decoded RGBA pixels
+
+	  Returns:  HRESULT
+				  Status code, E_NOTIMPL for files to load otherwise
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT ImageDecoder::DecodeMemory(_In_reads_bytes_(uSize) const BYTE* pData, _In_ SIZE_T uSize, _Out_ ImageData& outImage)
+	{
+		static constexpr BYTE s_aPngSignature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+
+		outImage = ImageData{ .uWidth = 0u, .uHeight = 0u, .aPixels = {} };
+
+		if (uSize >= sizeof(s_aPngSignature) && std::equal(s_aPngSignature, s_aPngSignature + sizeof(s_aPngSignature), pData))
+		{
+			return decodePng(pData, uSize, outImage);
+		}
+
+		if (uSize >= 2u && pData[0] == 0xFFu && pData[1] == 0xD8u)
+		{
+			return decodeJpeg(pData, uSize, outImage);
+		}
+
+		return E_NOTIMPL;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ImageDecoder::IsSupportedExtension
+
+	  Summary:  Returns whether the file extension is png, jpg or jpeg
+
+	  Args:     const std::filesystem::path& filePath
+				  Path to the image
+
+	  Returns:  BOOL
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL ImageDecoder::IsSupportedExtension(_In_ const std::filesystem::path& filePath)
+	{
+		std::wstring szExtension = filePath.extension().wstring();
+		std::transform(szExtension.begin(), szExtension.end(), szExtension.begin(), [](WCHAR c) { return static_cast<WCHAR>(towlower(c)); });
+
+		return szExtension == L".png" || szExtension == L".jpg" || szExtension == L".jpeg";
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ImageDecoder::decodeJpeg
+
+	  Summary:  Decodes a baseline JPEG with one interleaved scan.
+				Chroma is upsampled by replication.
+
+	  Args:     const BYTE* pData
+				  File contents
+				SIZE_T uSize
+				  Size of the file in bytes
+				ImageData& outImage
+				  Decoded RGBA pixels
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT ImageDecoder::decodeJpeg(_In_reads_bytes_(uSize) const BYTE* pData, _In_ SIZE_T uSize, _Out_ ImageData& outImage)
+	{
+		static constexpr BYTE s_aZigZag[64] =
+		{
+			0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5,
+			12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+			35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+			58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+		};
+
+		struct Component
+		{
+			UINT uId;
+			UINT uH;
+			UINT uV;
+			UINT uQuantTable;
+			UINT uDcTable;
+			UINT uAcTable;
+			INT iDcPrediction;
+			UINT uPlaneWidth;
+			UINT uPlaneHeight;
+			std::vector<BYTE> aPlane;
+		};
+
+		auto quantTables = std::make_unique<std::array<std::array<UINT16, 64>, 4>>();
+		auto dcTables = std::make_unique<std::array<JpegBitReader::Huffman, 4>>();
+		auto acTables = std::make_unique<std::array<JpegBitReader::Huffman, 4>>();
+		for (UINT i = 0u; i < 4u; ++i)
+		{
+			(*dcTables)[i].bDefined = FALSE;
+			(*acTables)[i].bDefined = FALSE;
+		}
+
+		std::vector<Component> aComponents;
+		UINT uWidth = 0u;
+		UINT uHeight = 0u;
+		UINT uRestartInterval = 0u;
+		SIZE_T uPos = 2u;
+
+		for (;;)
+		{
+			// Markers may be padded with any number of 0xFF bytes
+			while (uPos < uSize && pData[uPos] != 0xFFu)
+			{
+				++uPos;
+			}
+			while (uPos < uSize && pData[uPos] == 0xFFu)
+			{
+				++uPos;
+			}
+			if (uPos + 2u >= uSize)
+			{
+				return E_FAIL;
+			}
+
+			UINT uMarker = pData[uPos++];
+			if (uMarker == 0xD9u)
+			{
+				return E_FAIL;
+			}
+			if (uMarker == 0x01u || (uMarker >= 0xD0u && uMarker <= 0xD7u))
+			{
+				continue;
+			}
+
+			UINT uLength = readBigEndian16(pData + uPos);
+			if (uLength < 2u || uPos + uLength > uSize)
+			{
+				return E_FAIL;
+			}
+			const BYTE* pSegment = pData + uPos + 2u;
+			const UINT uSegmentLength = uLength - 2u;
+			uPos += uLength;
+
+			switch (uMarker)
+			{
+			case 0xC0u:
+			case 0xC1u:
+			{
+				if (uSegmentLength < 6u || pSegment[0] != 8u)
+				{
+					return E_NOTIMPL;
+				}
+
+				uHeight = readBigEndian16(pSegment + 1u);
+				uWidth = readBigEndian16(pSegment + 3u);
+				UINT uNumComponents = pSegment[5];
+				if (uWidth == 0u || uHeight == 0u || (uNumComponents != 1u && uNumComponents != 3u) || uSegmentLength < 6u + 3u * uNumComponents)
+				{
+					return E_NOTIMPL;
+				}
+
+				aComponents.resize(uNumComponents);
+				for (UINT i = 0u; i < uNumComponents; ++i)
+				{
+					const BYTE* p = pSegment + 6u + 3u * i;
+					aComponents[i].uId = p[0];
+					aComponents[i].uH = std::max<UINT>(1u, p[1] >> 4u);
+					aComponents[i].uV = std::max<UINT>(1u, p[1] & 15u);
+					aComponents[i].uQuantTable = p[2] & 3u;
+				}
+				break;
+			}
+			case 0xC4u:
+			{
+				for (UINT uOffset = 0u; uOffset + 17u <= uSegmentLength;)
+				{
+					UINT uClass = pSegment[uOffset] >> 4u;
+					UINT uIndex = pSegment[uOffset] & 3u;
+					const BYTE* aCounts = pSegment + uOffset + 1u;
+
+					UINT uNumValues = 0u;
+					for (UINT i = 0u; i < 16u; ++i)
+					{
+						uNumValues += aCounts[i];
+					}
+					if (uOffset + 17u + uNumValues > uSegmentLength)
+					{
+						return E_FAIL;
+					}
+
+					BYTE aValues[256] = { 0u, };
+					std::copy(aCounts + 16u, aCounts + 16u + std::min<UINT>(uNumValues, 256u), aValues);
+
+					HRESULT hr = JpegBitReader::BuildHuffman(aCounts, aValues, uClass == 0u ? (*dcTables)[uIndex] : (*acTables)[uIndex]);
+					if (FAILED(hr))
+					{
+						return hr;
+					}
+
+					uOffset += 17u + uNumValues;
+				}
+				break;
+			}
+			case 0xDBu:
+			{
+				for (UINT uOffset = 0u; uOffset < uSegmentLength;)
+				{
+					UINT uPrecision = pSegment[uOffset] >> 4u;
+					UINT uIndex = pSegment[uOffset] & 3u;
+					UINT uTableSize = uPrecision ? 128u : 64u;
+					if (uOffset + 1u + uTableSize > uSegmentLength)
+					{
+						return E_FAIL;
+					}
+
+					for (UINT k = 0u; k < 64u; ++k)
+					{
+						(*quantTables)[uIndex][k] = static_cast<UINT16>(uPrecision ? readBigEndian16(pSegment + uOffset + 1u + 2u * k) : pSegment[uOffset + 1u + k]);
+					}
+
+					uOffset += 1u + uTableSize;
+				}
+				break;
+			}
+			case 0xDDu:
+			{
+				if (uSegmentLength < 2u)
+				{
+					return E_FAIL;
+				}
+				uRestartInterval = readBigEndian16(pSegment);
+				break;
+			}
+			case 0xDAu:
+			{
+				if (aComponents.empty() || uSegmentLength < 1u)
+				{
+					return E_FAIL;
+				}
+
+				// Only a single scan with every component is supported
+				UINT uNumScanComponents = pSegment[0];
+				if (uNumScanComponents != aComponents.size() || uSegmentLength < 1u + 2u * uNumScanComponents)
+				{
+					return E_NOTIMPL;
+				}
+
+				for (UINT i = 0u; i < uNumScanComponents; ++i)
+				{
+					const BYTE* p = pSegment + 1u + 2u * i;
+					auto it = std::find_if(aComponents.begin(), aComponents.end(), [p](const Component& component) { return component.uId == p[0]; });
+					if (it == aComponents.end())
+					{
+						return E_FAIL;
+					}
+					it->uDcTable = p[1] >> 4u & 3u;
+					it->uAcTable = p[1] & 3u;
+					if (!(*dcTables)[it->uDcTable].bDefined || !(*acTables)[it->uAcTable].bDefined)
+					{
+						return E_FAIL;
+					}
+				}
+
+				UINT uMaxH = 1u;
+				UINT uMaxV = 1u;
+				for (const Component& component : aComponents)
+				{
+					uMaxH = std::max<UINT>(uMaxH, component.uH);
+					uMaxV = std::max<UINT>(uMaxV, component.uV);
+				}
+
+				// A single component scan is not interleaved, its blocks do not follow the sampling factors
+				const BOOL bInterleaved = aComponents.size() > 1u;
+				if (!bInterleaved)
+				{
+					aComponents[0].uH = 1u;
+					aComponents[0].uV = 1u;
+					uMaxH = 1u;
+					uMaxV = 1u;
+				}
+
+				const UINT uNumMcusX = (uWidth + 8u * uMaxH - 1u) / (8u * uMaxH);
+				const UINT uNumMcusY = (uHeight + 8u * uMaxV - 1u) / (8u * uMaxV);
+				for (Component& component : aComponents)
+				{
+					component.uPlaneWidth = uNumMcusX * component.uH * 8u;
+					component.uPlaneHeight = uNumMcusY * component.uV * 8u;
+					component.aPlane.assign(static_cast<SIZE_T>(component.uPlaneWidth) * component.uPlaneHeight, 0u);
+					component.iDcPrediction = 0;
+				}
+
+				JpegBitReader reader(pData, uSize);
+				reader.Reset(uPos);
+
+				FLOAT aCoefficients[64];
+				UINT uNumMcusLeft = uRestartInterval;
+				for (UINT uMcuY = 0u; uMcuY < uNumMcusY; ++uMcuY)
+				{
+					for (UINT uMcuX = 0u; uMcuX < uNumMcusX; ++uMcuX)
+					{
+						if (uRestartInterval > 0u)
+						{
+							if (uNumMcusLeft == 0u)
+							{
+								reader.SkipRestartMarker();
+								for (Component& component : aComponents)
+								{
+									component.iDcPrediction = 0;
+								}
+								uNumMcusLeft = uRestartInterval;
+							}
+							--uNumMcusLeft;
+						}
+
+						for (Component& component : aComponents)
+						{
+							const auto& quantTable = (*quantTables)[component.uQuantTable];
+							const auto& dcTable = (*dcTables)[component.uDcTable];
+							const auto& acTable = (*acTables)[component.uAcTable];
+
+							for (UINT v = 0u; v < component.uV; ++v)
+							{
+								for (UINT h = 0u; h < component.uH; ++h)
+								{
+									std::fill(std::begin(aCoefficients), std::end(aCoefficients), 0.0f);
+
+									INT iDcSize = reader.Decode(dcTable);
+									if (iDcSize < 0 || iDcSize > 11)
+									{
+										return E_FAIL;
+									}
+									component.iDcPrediction += reader.ReceiveExtend(static_cast<UINT>(iDcSize));
+									aCoefficients[0] = static_cast<FLOAT>(component.iDcPrediction * quantTable[0]);
+
+									for (UINT k = 1u; k < 64u;)
+									{
+										INT iRunSize = reader.Decode(acTable);
+										if (iRunSize < 0)
+										{
+											return E_FAIL;
+										}
+
+										UINT uRun = static_cast<UINT>(iRunSize) >> 4u;
+										UINT uAcSize = static_cast<UINT>(iRunSize) & 15u;
+										if (uAcSize == 0u)
+										{
+											if (uRun != 15u)
+											{
+												break;
+											}
+											k += 16u;
+											continue;
+										}
+
+										k += uRun;
+										if (k > 63u)
+										{
+											return E_FAIL;
+										}
+										aCoefficients[s_aZigZag[k]] = static_cast<FLOAT>(reader.ReceiveExtend(uAcSize) * quantTable[k]);
+										++k;
+									}
+
+									UINT uBlockX = (uMcuX * component.uH + h) * 8u;
+									UINT uBlockY = (uMcuY * component.uV + v) * 8u;
+									inverseDct(
+										aCoefficients,
+										component.aPlane.data() + static_cast<SIZE_T>(uBlockY) * component.uPlaneWidth + uBlockX,
+										component.uPlaneWidth
+									);
+								}
+							}
+						}
+					}
+				}
+
+				outImage.uWidth = uWidth;
+				outImage.uHeight = uHeight;
+				outImage.aPixels.resize(static_cast<SIZE_T>(uWidth) * uHeight * 4u);
+
+				for (UINT y = 0u; y < uHeight; ++y)
+				{
+					BYTE* pOut = outImage.aPixels.data() + static_cast<SIZE_T>(y) * uWidth * 4u;
+
+					if (aComponents.size() == 1u)
+					{
+						const BYTE* pLuma = aComponents[0].aPlane.data() + static_cast<SIZE_T>(y) * aComponents[0].uPlaneWidth;
+						for (UINT x = 0u; x < uWidth; ++x, pOut += 4)
+						{
+							pOut[0] = pLuma[x];
+							pOut[1] = pLuma[x];
+							pOut[2] = pLuma[x];
+							pOut[3] = 0xFFu;
+						}
+						continue;
+					}
+
+					const Component& luma = aComponents[0];
+					const Component& blue = aComponents[1];
+					const Component& red = aComponents[2];
+					const BYTE* pLuma = luma.aPlane.data() + static_cast<SIZE_T>(y * luma.uV / uMaxV) * luma.uPlaneWidth;
+					const BYTE* pBlue = blue.aPlane.data() + static_cast<SIZE_T>(y * blue.uV / uMaxV) * blue.uPlaneWidth;
+					const BYTE* pRed = red.aPlane.data() + static_cast<SIZE_T>(y * red.uV / uMaxV) * red.uPlaneWidth;
+
+					for (UINT x = 0u; x < uWidth; ++x, pOut += 4)
+					{
+						FLOAT lumaValue = static_cast<FLOAT>(pLuma[x * luma.uH / uMaxH]);
+						FLOAT blueValue = static_cast<FLOAT>(pBlue[x * blue.uH / uMaxH]) - 128.0f;
+						FLOAT redValue = static_cast<FLOAT>(pRed[x * red.uH / uMaxH]) - 128.0f;
+
+						pOut[0] = static_cast<BYTE>(std::clamp<FLOAT>(std::round(lumaValue + 1.402f * redValue), 0.0f, 255.0f));
+						pOut[1] = static_cast<BYTE>(std::clamp<FLOAT>(std::round(lumaValue - 0.344136f * blueValue - 0.714136f * redValue), 0.0f, 255.0f));
+						pOut[2] = static_cast<BYTE>(std::clamp<FLOAT>(std::round(lumaValue + 1.772f * blueValue), 0.0f, 255.0f));
+						pOut[3] = 0xFFu;
+					}
+				}
+
+				return S_OK;
+			}
+			case 0xC2u:
+			case 0xC3u:
+			case 0xC5u:
+			case 0xC6u:
+			case 0xC7u:
+			case 0xC9u:
+			case 0xCAu:
+			case 0xCBu:
+			case 0xCDu:
+			case 0xCEu:
+			case 0xCFu:
+				// Progressive, lossless and arithmetic coded files
+				return E_NOTIMPL;
+			default:
+				break;
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   ImageDecoder::decodePng
+
+	  Summary:  Decodes a non-interlaced PNG of any color type and bit
+				depth. 16 bit channels keep their most significant
+				byte, transparency chunks become the alpha channel.
+
+	  Args:     const BYTE* pData
+				  File contents
+				SIZE_T uSize
+				  Size of the file in bytes
+				ImageData& outImage
+				  Decoded RGBA pixels
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT ImageDecoder::decodePng(_In_reads_bytes_(uSize) const BYTE* pData, _In_ SIZE_T uSize, _Out_ ImageData& outImage)
+	{
+		UINT uWidth = 0u;
+		UINT uHeight = 0u;
+		UINT uBitDepth = 0u;
+		UINT uColorType = 0u;
+		BYTE aPalette[256][4] = { { 0u, }, };
+		UINT uNumPaletteEntries = 0u;
+		BOOL bHasColorKey = FALSE;
+		UINT aColorKey[3] = { 0u, };
+		std::vector<BYTE> aCompressed;
+
+		for (SIZE_T uPos = 8u; uPos + 12u <= uSize;)
+		{
+			UINT uLength = readBigEndian32(pData + uPos);
+			const BYTE* pType = pData + uPos + 4u;
+			const BYTE* pChunk = pData + uPos + 8u;
+			if (uLength > uSize - uPos - 12u)
+			{
+				return E_FAIL;
+			}
+			uPos += 12u + uLength;
+
+			if (std::equal(pType, pType + 4, "IHDR"))
+			{
+				if (uLength < 13u)
+				{
+					return E_FAIL;
+				}
+
+				uWidth = readBigEndian32(pChunk);
+				uHeight = readBigEndian32(pChunk + 4u);
+				uBitDepth = pChunk[8];
+				uColorType = pChunk[9];
+				if (pChunk[12] != 0u)
+				{
+					return E_NOTIMPL;
+				}
+			}
+			else if (std::equal(pType, pType + 4, "PLTE"))
+			{
+				uNumPaletteEntries = std::min<UINT>(uLength / 3u, 256u);
+				for (UINT i = 0u; i < uNumPaletteEntries; ++i)
+				{
+					aPalette[i][0] = pChunk[3u * i];
+					aPalette[i][1] = pChunk[3u * i + 1u];
+					aPalette[i][2] = pChunk[3u * i + 2u];
+					aPalette[i][3] = 0xFFu;
+				}
+			}
+			else if (std::equal(pType, pType + 4, "tRNS"))
+			{
+				if (uColorType == 3u)
+				{
+					for (UINT i = 0u; i < std::min<UINT>(uLength, 256u); ++i)
+					{
+						aPalette[i][3] = pChunk[i];
+					}
+				}
+				else if (uColorType == 0u && uLength >= 2u)
+				{
+					bHasColorKey = TRUE;
+					aColorKey[0] = readBigEndian16(pChunk);
+				}
+				else if (uColorType == 2u && uLength >= 6u)
+				{
+					bHasColorKey = TRUE;
+					aColorKey[0] = readBigEndian16(pChunk);
+					aColorKey[1] = readBigEndian16(pChunk + 2u);
+					aColorKey[2] = readBigEndian16(pChunk + 4u);
+				}
+			}
+			else if (std::equal(pType, pType + 4, "IDAT"))
+			{
+				aCompressed.insert(aCompressed.end(), pChunk, pChunk + uLength);
+			}
+			else if (std::equal(pType, pType + 4, "IEND"))
+			{
+				break;
+			}
+		}
+
+		UINT uNumChannels = 0u;
+		switch (uColorType)
+		{
+		case 0u: uNumChannels = 1u; break;
+		case 2u: uNumChannels = 3u; break;
+		case 3u: uNumChannels = 1u; break;
+		case 4u: uNumChannels = 2u; break;
+		case 6u: uNumChannels = 4u; break;
+		default: return E_FAIL;
+		}
+
+		const BOOL bValidDepth = uColorType == 0u ? (uBitDepth == 1u || uBitDepth == 2u || uBitDepth == 4u || uBitDepth == 8u || uBitDepth == 16u)
+			: uColorType == 3u ? (uBitDepth == 1u || uBitDepth == 2u || uBitDepth == 4u || uBitDepth == 8u)
+			: (uBitDepth == 8u || uBitDepth == 16u);
+		if (!bValidDepth || uWidth == 0u || uHeight == 0u || aCompressed.size() < 2u)
+		{
+			return E_FAIL;
+		}
+
+		// zlib header: deflate with no preset dictionary
+		if ((aCompressed[0] & 15u) != 8u || (aCompressed[1] & 0x20u) != 0u || ((aCompressed[0] << 8u) | aCompressed[1]) % 31u != 0u)
+		{
+			return E_FAIL;
+		}
+
+		const UINT uBitsPerPixel = uNumChannels * uBitDepth;
+		const SIZE_T uStride = (static_cast<SIZE_T>(uWidth) * uBitsPerPixel + 7u) / 8u;
+		const SIZE_T uFilterBytes = std::max<SIZE_T>(1u, uBitsPerPixel / 8u);
+
+		std::vector<BYTE> aFiltered;
+		aFiltered.reserve((uStride + 1u) * uHeight);
+
+		InflateStream inflateStream(aCompressed.data() + 2u, aCompressed.size() - 2u);
+		HRESULT hr = inflateStream.Inflate(aFiltered);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+		if (aFiltered.size() < (uStride + 1u) * uHeight)
+		{
+			return E_FAIL;
+		}
+
+		std::vector<BYTE> aRows(uStride * uHeight);
+		for (UINT y = 0u; y < uHeight; ++y)
+		{
+			const BYTE* pIn = aFiltered.data() + y * (uStride + 1u);
+			BYTE* pRow = aRows.data() + y * uStride;
+			const BYTE* pPrev = y > 0u ? pRow - uStride : nullptr;
+			const UINT uFilter = *pIn++;
+
+			for (SIZE_T i = 0u; i < uStride; ++i)
+			{
+				INT a = i >= uFilterBytes ? pRow[i - uFilterBytes] : 0;
+				INT b = pPrev ? pPrev[i] : 0;
+				INT c = pPrev && i >= uFilterBytes ? pPrev[i - uFilterBytes] : 0;
+
+				INT iPredictor = 0;
+				switch (uFilter)
+				{
+				case 0u:
+					break;
+				case 1u:
+					iPredictor = a;
+					break;
+				case 2u:
+					iPredictor = b;
+					break;
+				case 3u:
+					iPredictor = (a + b) >> 1;
+					break;
+				case 4u:
+				{
+					INT p = a + b - c;
+					INT pa = std::abs(p - a);
+					INT pb = std::abs(p - b);
+					INT pc = std::abs(p - c);
+					iPredictor = pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+					break;
+				}
+				default:
+					return E_FAIL;
+				}
+
+				pRow[i] = static_cast<BYTE>(pIn[i] + iPredictor);
+			}
+		}
+
+		auto readSample = [uBitDepth](const BYTE* pRow, UINT uIndex) -> UINT
+		{
+			switch (uBitDepth)
+			{
+			case 8u:
+				return pRow[uIndex];
+			case 16u:
+				return readBigEndian16(pRow + 2u * uIndex);
+			default:
+			{
+				UINT uBit = uIndex * uBitDepth;
+				return (pRow[uBit >> 3u] >> (8u - uBitDepth - (uBit & 7u))) & ((1u << uBitDepth) - 1u);
+			}
+			}
+		};
+
+		auto toByte = [uBitDepth](UINT uSample) -> BYTE
+		{
+			switch (uBitDepth)
+			{
+			case 8u:
+				return static_cast<BYTE>(uSample);
+			case 16u:
+				return static_cast<BYTE>(uSample >> 8u);
+			default:
+				return static_cast<BYTE>(uSample * 255u / ((1u << uBitDepth) - 1u));
+			}
+		};
+
+		outImage.uWidth = uWidth;
+		outImage.uHeight = uHeight;
+		outImage.aPixels.resize(static_cast<SIZE_T>(uWidth) * uHeight * 4u);
+
+		for (UINT y = 0u; y < uHeight; ++y)
+		{
+			const BYTE* pRow = aRows.data() + y * uStride;
+			BYTE* pOut = outImage.aPixels.data() + static_cast<SIZE_T>(y) * uWidth * 4u;
+
+			if (uColorType == 6u && uBitDepth == 8u)
+			{
+				std::copy(pRow, pRow + static_cast<SIZE_T>(uWidth) * 4u, pOut);
+				continue;
+			}
+
+			for (UINT x = 0u; x < uWidth; ++x, pOut += 4)
+			{
+				switch (uColorType)
+				{
+				case 0u:
+				{
+					UINT uGray = readSample(pRow, x);
+					pOut[0] = pOut[1] = pOut[2] = toByte(uGray);
+					pOut[3] = bHasColorKey && uGray == aColorKey[0] ? 0u : 0xFFu;
+					break;
+				}
+				case 2u:
+				{
+					UINT uRed = readSample(pRow, 3u * x);
+					UINT uGreen = readSample(pRow, 3u * x + 1u);
+					UINT uBlue = readSample(pRow, 3u * x + 2u);
+					pOut[0] = toByte(uRed);
+					pOut[1] = toByte(uGreen);
+					pOut[2] = toByte(uBlue);
+					pOut[3] = bHasColorKey && uRed == aColorKey[0] && uGreen == aColorKey[1] && uBlue == aColorKey[2] ? 0u : 0xFFu;
+					break;
+				}
+				case 3u:
+				{
+					UINT uIndex = readSample(pRow, x);
+					if (uIndex >= uNumPaletteEntries)
+					{
+						return E_FAIL;
+					}
+					std::copy(aPalette[uIndex], aPalette[uIndex] + 4, pOut);
+					break;
+				}
+				case 4u:
+				{
+					pOut[0] = pOut[1] = pOut[2] = toByte(readSample(pRow, 2u * x));
+					pOut[3] = toByte(readSample(pRow, 2u * x + 1u));
+					break;
+				}
+				default:
+				{
+					for (UINT k = 0u; k < 4u; ++k)
+					{
+						pOut[k] = toByte(readSample(pRow, 4u * x + k));
+					}
+					break;
+				}
+				}
+			}
+		}
+
+		return S_OK;
+	}
+}
@@ -0,0 +1,67 @@
+/*+===================================================================
+  File:      IMAGEDECODER.H
+
+  Summary:   ImageDecoder header file contains declarations of
+			 ImageDecoder class that decodes PNG and JPEG files to
+			 RGBA pixels without WIC, so the decoding can run on any
+			 thread and any platform.
+
+  Classes: ImageDecoder
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Portable.h"
+
+#include <filesystem>
+
+namespace library
+{
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   ImageData
+
+		Summary:  Decoded top mip of an image, 4 bytes per texel in
+				  R, G, B, A order, rows tightly packed
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct ImageData
+	{
+		UINT uWidth;
+		UINT uHeight;
+		std::vector<BYTE> aPixels;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    ImageDecoder
+
+	  Summary:  Decodes non-interlaced PNG files of any color type and
+				baseline JPEG files. Other files, such as interlaced
+				PNG, progressive JPEG or DDS, return E_NOTIMPL so the
+				caller can fall back to the WIC and DDS loaders.
+
+	  Methods:  DecodeFile
+				  Reads and decodes an image file
+				DecodeMemory
+				  Decodes an image already in memory
+				IsSupportedExtension
+				  Returns whether the extension names a PNG or JPEG
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class ImageDecoder final
+	{
+	public:
+		ImageDecoder() = delete;
+		ImageDecoder(const ImageDecoder& other) = delete;
+		ImageDecoder(ImageDecoder&& other) = delete;
+		ImageDecoder& operator=(const ImageDecoder& other) = delete;
+		ImageDecoder& operator=(ImageDecoder&& other) = delete;
+		~ImageDecoder() = delete;
+
+		static HRESULT DecodeFile(_In_ const std::filesystem::path& filePath, _Out_ ImageData& outImage);
+		static HRESULT DecodeMemory(_In_reads_bytes_(uSize) const BYTE* pData, _In_ SIZE_T uSize, _Out_ ImageData& outImage);
+		static BOOL IsSupportedExtension(_In_ const std::filesystem::path& filePath);
+
+	private:
+		static HRESULT decodeJpeg(_In_reads_bytes_(uSize) const BYTE* pData, _In_ SIZE_T uSize, _Out_ ImageData& outImage);
+		static HRESULT decodePng(_In_reads_bytes_(uSize) const BYTE* pData, _In_ SIZE_T uSize, _Out_ ImageData& outImage);
+	};
+}
@@ -1,5 +1,7 @@
 #include "Material.h"
 
+#include "Texture/TextureStreamer.h"
+
 namespace library
 {
 	Material::Material(_In_ std::wstring szName)
@@ -17,7 +19,7 @@ namespace library
 
 		if (pDiffuse)
 		{
-			hr = pDiffuse->Initialize(pDevice, pImmediateContext);
+			hr = initializeTexture(pDiffuse, TRUE, pDevice, pImmediateContext);
 			if (FAILED(hr))
 			{
 				return hr;
@@ -26,7 +28,7 @@ namespace library
 
 		if (pSpecularExponent)
 		{
-			hr = pSpecularExponent->Initialize(pDevice, pImmediateContext);
+			hr = initializeTexture(pSpecularExponent, FALSE, pDevice, pImmediateContext);
 			if (FAILED(hr))
 			{
 				return hr;
@@ -35,7 +37,7 @@ namespace library
 
 		if (pNormal)
 		{
-			hr = pNormal->Initialize(pDevice, pImmediateContext);
+			hr = initializeTexture(pNormal, FALSE, pDevice, pImmediateContext);
 			if (FAILED(hr))
 			{
 				return hr;
@@ -50,4 +52,21 @@ namespace library
 		return m_szName;
 	}
 
+	HRESULT Material::initializeTexture(_In_ const std::shared_ptr<Texture>& texture, _In_ BOOL bIsSrgb, _In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+	{
+		TextureStreamer& textureStreamer = TextureStreamer::GetInstance();
+		if (!textureStreamer.IsEnabled() || !texture->IsStreamable())
+		{
+			return texture->Initialize(pDevice, pImmediateContext);
+		}
+
+		HRESULT hr = texture->InitializeStreaming(pDevice, pImmediateContext, bIsSrgb);
+		if (hr == S_OK)
+		{
+			textureStreamer.Register(texture);
+		}
+
+		return SUCCEEDED(hr) ? S_OK : hr;
+	}
+
 }
\ No newline at end of file
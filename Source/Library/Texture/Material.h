@@ -31,6 +31,9 @@ namespace library
 
 		std::wstring GetName() const;
 
+	private:
+		static HRESULT initializeTexture(_In_ const std::shared_ptr<Texture>& texture, _In_ BOOL bIsSrgb, _In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+
 	private:
 		BYTE m_padding[4];
 		std::wstring m_szName;
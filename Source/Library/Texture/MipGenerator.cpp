@@ -0,0 +1,427 @@
+#include "Texture/MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+namespace library
+{
+	namespace
+	{
+		constexpr UINT NUM_ENCODE_STEPS = 4096u;
+
+		DOUBLE srgbToLinear(_In_ DOUBLE value)
+		{
+			return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+		}
+
+		DOUBLE linearToSrgb(_In_ DOUBLE value)
+		{
+			return value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+		}
+
+		/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+		  Function: besselI0
+
+		  Summary:  Zeroth order modified Bessel function of the first
+					kind, summed until the terms stop adding precision
+
+		  Args:     DOUBLE x
+					  Argument
+
+		  Returns:  DOUBLE
+		-----------------------------------------------------------------F-F*/
+		DOUBLE besselI0(_In_ DOUBLE x)
+		{
+			DOUBLE sum = 1.0;
+			DOUBLE term = 1.0;
+			const DOUBLE quarterSquare = x * x * 0.25;
+			for (UINT k = 1u; term > sum * 1e-12; ++k)
+			{
+				term *= quarterSquare / (static_cast<DOUBLE>(k) * k);
+				sum += term;
+			}
+
+			return sum;
+		}
+
+		/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+		  Function: kaiser
+
+		  Summary:  Sinc windowed by a Kaiser window of the given radius
+
+		  Args:     DOUBLE t
+					  Distance in texels of the smaller level
+					DOUBLE radius
+					  Distance where the window reaches zero
+					DOUBLE alpha
+					  Shape of the window
+
+		  Returns:  DOUBLE
+		-----------------------------------------------------------------F-F*/
+		DOUBLE kaiser(_In_ DOUBLE t, _In_ DOUBLE radius, _In_ DOUBLE alpha)
+		{
+			if (std::abs(t) >= radius)
+			{
+				return 0.0;
+			}
+
+			const DOUBLE ratio = t / radius;
+			const DOUBLE window = besselI0(alpha * std::sqrt(1.0 - ratio * ratio)) / besselI0(alpha);
+			const DOUBLE sinc = t == 0.0 ? 1.0 : std::sin(XM_PI * t) / (XM_PI * t);
+			return sinc * window;
+		}
+
+		/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+			Struct:   ColorTables
+
+			Summary:  Lookup tables from 8 bit sRGB to linear and from
+					  linear, in NUM_ENCODE_STEPS steps, back to 8 bit sRGB
+		S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+		struct ColorTables
+		{
+			ColorTables()
+			{
+				for (UINT i = 0u; i < 256u; ++i)
+				{
+					aToLinear[i] = static_cast<FLOAT>(srgbToLinear(i / 255.0));
+				}
+
+				for (UINT i = 0u; i < NUM_ENCODE_STEPS; ++i)
+				{
+					aToSrgb[i] = static_cast<BYTE>(std::lround(linearToSrgb(i / static_cast<DOUBLE>(NUM_ENCODE_STEPS - 1u)) * 255.0));
+				}
+			}
+
+			FLOAT aToLinear[256];
+			BYTE aToSrgb[NUM_ENCODE_STEPS];
+		};
+
+		const ColorTables& getColorTables()
+		{
+			static const ColorTables s_tables;
+			return s_tables;
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   MipGenerator::GenerateMipChain
+
+	  Summary:  Filters every mip below the top level with SIMD
+				vectors and appends it to the chain
+
+	  Args:     std::vector<ImageData>& aMips
+				  Chain holding only the top level, receives the rest
+				BOOL bIsSrgb
+				  Whether the color channels are sRGB encoded
+				eMipFilter filter
+				  Filter each level is reduced with
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT MipGenerator::GenerateMipChain(_Inout_ std::vector<ImageData>& aMips, _In_ BOOL bIsSrgb, _In_opt_ eMipFilter filter)
+	{
+		if (aMips.size() != 1u || aMips[0].aPixels.size() != static_cast<SIZE_T>(aMips[0].uWidth) * aMips[0].uHeight * 4u || aMips[0].aPixels.empty()
+			|| filter >= eMipFilter::COUNT)
+		{
+			return E_INVALIDARG;
+		}
+
+		const ColorTables& tables = getColorTables();
+		const UINT uNumMips = GetNumMips(aMips[0].uWidth, aMips[0].uHeight);
+		aMips.reserve(uNumMips);
+
+		UINT uWidth = aMips[0].uWidth;
+		UINT uHeight = aMips[0].uHeight;
+
+		std::vector<XMFLOAT4A> aLinear(static_cast<SIZE_T>(uWidth) * uHeight);
+		const BYTE* pTop = aMips[0].aPixels.data();
+		for (SIZE_T i = 0u; i < aLinear.size(); ++i, pTop += 4)
+		{
+			aLinear[i] = bIsSrgb
+				? XMFLOAT4A(tables.aToLinear[pTop[0]], tables.aToLinear[pTop[1]], tables.aToLinear[pTop[2]], pTop[3] / 255.0f)
+				: XMFLOAT4A(pTop[0] / 255.0f, pTop[1] / 255.0f, pTop[2] / 255.0f, pTop[3] / 255.0f);
+		}
+
+		std::vector<Tap> aColumnTaps;
+		std::vector<Tap> aRowTaps;
+		std::vector<FLOAT> aColumnWeights;
+		std::vector<FLOAT> aRowWeights;
+		std::vector<XMFLOAT4A> aRows;
+		std::vector<XMFLOAT4A> aNext;
+
+		const XMVECTOR encodeScale = bIsSrgb
+			? XMVectorSet(NUM_ENCODE_STEPS - 1.0f, NUM_ENCODE_STEPS - 1.0f, NUM_ENCODE_STEPS - 1.0f, 255.0f)
+			: XMVectorReplicate(255.0f);
+		const XMVECTOR half = XMVectorReplicate(0.5f);
+
+		for (UINT uMip = 1u; uMip < uNumMips; ++uMip)
+		{
+			const UINT uNextWidth = std::max<UINT>(1u, uWidth / 2u);
+			const UINT uNextHeight = std::max<UINT>(1u, uHeight / 2u);
+			computeTaps(uWidth, uNextWidth, filter, aColumnTaps, aColumnWeights);
+			computeTaps(uHeight, uNextHeight, filter, aRowTaps, aRowWeights);
+
+			// Horizontal pass, every source row to the next width
+			aRows.resize(static_cast<SIZE_T>(uNextWidth) * uHeight);
+			for (UINT y = 0u; y < uHeight; ++y)
+			{
+				filterRow(
+					aLinear.data() + static_cast<SIZE_T>(y) * uWidth,
+					aColumnTaps.data(),
+					aColumnWeights.data(),
+					uNextWidth,
+					aRows.data() + static_cast<SIZE_T>(y) * uNextWidth
+				);
+			}
+
+			// Vertical pass, whole rows at a time so the reads stay sequential
+			aNext.assign(static_cast<SIZE_T>(uNextWidth) * uNextHeight, XMFLOAT4A(0.0f, 0.0f, 0.0f, 0.0f));
+			for (UINT y = 0u; y < uNextHeight; ++y)
+			{
+				const Tap& tap = aRowTaps[y];
+				XMFLOAT4A* pOut = aNext.data() + static_cast<SIZE_T>(y) * uNextWidth;
+
+				for (UINT k = 0u; k < tap.uNumTaps; ++k)
+				{
+					accumulateRow(aRows.data() + static_cast<SIZE_T>(tap.uFirst + k) * uNextWidth, aRowWeights[tap.uFirstWeight + k], uNextWidth, pOut);
+				}
+			}
+
+			ImageData mip =
+			{
+				.uWidth = uNextWidth,
+				.uHeight = uNextHeight,
+				.aPixels = std::vector<BYTE>(static_cast<SIZE_T>(uNextWidth) * uNextHeight * 4u)
+			};
+
+			BYTE* pOut = mip.aPixels.data();
+			for (SIZE_T i = 0u; i < aNext.size(); ++i, pOut += 4)
+			{
+				XMUINT4 encoded;
+				XMStoreUInt4(&encoded, XMVectorMultiplyAdd(XMVectorSaturate(XMLoadFloat4A(&aNext[i])), encodeScale, half));
+
+				if (bIsSrgb)
+				{
+					pOut[0] = tables.aToSrgb[std::min<UINT>(encoded.x, NUM_ENCODE_STEPS - 1u)];
+					pOut[1] = tables.aToSrgb[std::min<UINT>(encoded.y, NUM_ENCODE_STEPS - 1u)];
+					pOut[2] = tables.aToSrgb[std::min<UINT>(encoded.z, NUM_ENCODE_STEPS - 1u)];
+				}
+				else
+				{
+					pOut[0] = static_cast<BYTE>(std::min<UINT>(encoded.x, 255u));
+					pOut[1] = static_cast<BYTE>(std::min<UINT>(encoded.y, 255u));
+					pOut[2] = static_cast<BYTE>(std::min<UINT>(encoded.z, 255u));
+				}
+				pOut[3] = static_cast<BYTE>(std::min<UINT>(encoded.w, 255u));
+			}
+
+			aMips.push_back(std::move(mip));
+			aLinear.swap(aNext);
+			uWidth = uNextWidth;
+			uHeight = uNextHeight;
+		}
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   MipGenerator::GetNumMips
+
+	  Summary:  Returns the number of mips from the given size down to
+				1x1, halving and rounding down like Direct3D
+
+	  Args:     UINT uWidth
+				  Width of the top level
+				UINT uHeight
+				  Height of the top level
+
+	  Returns:  UINT
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT MipGenerator::GetNumMips(_In_ UINT uWidth, _In_ UINT uHeight)
+	{
+		UINT uNumMips = 1u;
+		while (uWidth > 1u || uHeight > 1u)
+		{
+			uWidth = std::max<UINT>(1u, uWidth / 2u);
+			uHeight = std::max<UINT>(1u, uHeight / 2u);
+			++uNumMips;
+		}
+
+		return uNumMips;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   MipGenerator::computeTaps
+
+	  Summary:  Computes the filter taps of one direction. With the box
+				filter texel d of the destination covers [d, d + 1) *
+				source size / destination size of the source, and
+				each source texel is weighted by how much of it lies
+				inside. With the Kaiser filter each source texel is
+				weighted by the filter at the distance between its
+				center and the center of texel d, in destination
+				texels; texels past an edge fold onto the edge texel
+				and the weights are normalized to add up to one.
+
+	  Args:     UINT uSourceSize
+				  Number of source texels
+				UINT uDestinationSize
+				  Number of destination texels
+				eMipFilter filter
+				  Filter to compute the taps of
+				std::vector<Tap>& aOutTaps
+				  One entry per destination texel
+				std::vector<FLOAT>& aOutWeights
+				  Weights of every tap
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void MipGenerator::computeTaps(_In_ UINT uSourceSize, _In_ UINT uDestinationSize, _In_ eMipFilter filter, _Out_ std::vector<Tap>& aOutTaps, _Out_ std::vector<FLOAT>& aOutWeights)
+	{
+		aOutTaps.resize(uDestinationSize);
+		aOutWeights.clear();
+
+		if (filter == eMipFilter::KAISER)
+		{
+			const DOUBLE scale = static_cast<DOUBLE>(uSourceSize) / uDestinationSize;
+			const INT iLastSource = static_cast<INT>(uSourceSize) - 1;
+			std::vector<DOUBLE> aSums;
+
+			for (UINT d = 0u; d < uDestinationSize; ++d)
+			{
+				const DOUBLE center = (d + 0.5) * scale;
+				const INT iBegin = static_cast<INT>(std::floor(center - KAISER_RADIUS * scale - 0.5));
+				const INT iEnd = static_cast<INT>(std::ceil(center + KAISER_RADIUS * scale - 0.5));
+				const UINT uFirst = static_cast<UINT>(std::clamp(iBegin, 0, iLastSource));
+				const UINT uLast = static_cast<UINT>(std::clamp(iEnd, 0, iLastSource));
+
+				aSums.assign(uLast - uFirst + 1u, 0.0);
+				DOUBLE total = 0.0;
+				for (INT i = iBegin; i <= iEnd; ++i)
+				{
+					const DOUBLE weight = kaiser((i + 0.5 - center) / scale, KAISER_RADIUS, KAISER_ALPHA);
+					aSums[static_cast<UINT>(std::clamp(i, 0, iLastSource)) - uFirst] += weight;
+					total += weight;
+				}
+
+				aOutTaps[d] = { .uFirst = uFirst, .uNumTaps = static_cast<UINT>(aSums.size()), .uFirstWeight = static_cast<UINT>(aOutWeights.size()) };
+				for (DOUBLE sum : aSums)
+				{
+					aOutWeights.push_back(static_cast<FLOAT>(sum / total));
+				}
+			}
+
+			return;
+		}
+
+		// Positions are scaled by the destination size so the weights are exact
+		for (UINT d = 0u; d < uDestinationSize; ++d)
+		{
+			UINT64 uBegin = static_cast<UINT64>(d) * uSourceSize;
+			UINT64 uEnd = uBegin + uSourceSize;
+			UINT uFirst = static_cast<UINT>(uBegin / uDestinationSize);
+			UINT uLast = static_cast<UINT>((uEnd + uDestinationSize - 1u) / uDestinationSize);
+
+			aOutTaps[d] = { .uFirst = uFirst, .uNumTaps = uLast - uFirst, .uFirstWeight = static_cast<UINT>(aOutWeights.size()) };
+			for (UINT k = uFirst; k < uLast; ++k)
+			{
+				UINT64 uCellBegin = static_cast<UINT64>(k) * uDestinationSize;
+				UINT64 uCellEnd = uCellBegin + uDestinationSize;
+				UINT64 uCovered = std::min<UINT64>(uEnd, uCellEnd) - std::max<UINT64>(uBegin, uCellBegin);
+				aOutWeights.push_back(static_cast<FLOAT>(uCovered) / static_cast<FLOAT>(uSourceSize));
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   MipGenerator::filterRow
+
+	  Summary:  Filters one row to the destination width. With AVX two
+				source texels are weighted per register and the two
+				halves are added at the end.
+
+	  Args:     const XMFLOAT4A* pSource
+				  Row of the larger level
+				const Tap* pTaps
+				  Taps of every destination texel
+				const FLOAT* pWeights
+				  Weights the taps point into
+				UINT uNumTexels
+				  Destination width
+				XMFLOAT4A* pOut
+				  Receives the filtered row
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void MipGenerator::filterRow(_In_ const XMFLOAT4A* pSource, _In_reads_(uNumTexels) const Tap* pTaps, _In_ const FLOAT* pWeights, _In_ UINT uNumTexels, _Out_writes_(uNumTexels) XMFLOAT4A* pOut)
+	{
+		for (UINT x = 0u; x < uNumTexels; ++x)
+		{
+			const Tap& tap = pTaps[x];
+			const XMFLOAT4A* pTexels = pSource + tap.uFirst;
+			const FLOAT* pTapWeights = pWeights + tap.uFirstWeight;
+			UINT k = 0u;
+
+#if defined(__AVX__)
+			__m256 pairSum = _mm256_setzero_ps();
+			for (; k + 2u <= tap.uNumTaps; k += 2u)
+			{
+				const __m256 weights = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(pTapWeights[k])), _mm_set1_ps(pTapWeights[k + 1u]), 1);
+				pairSum = _mm256_add_ps(pairSum, _mm256_mul_ps(_mm256_loadu_ps(&pTexels[k].x), weights));
+			}
+
+			__m128 sum = _mm_add_ps(_mm256_castps256_ps128(pairSum), _mm256_extractf128_ps(pairSum, 1));
+			for (; k < tap.uNumTaps; ++k)
+			{
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(&pTexels[k].x), _mm_set1_ps(pTapWeights[k])));
+			}
+			_mm_store_ps(&pOut[x].x, sum);
+#else
+			XMVECTOR sum = XMVectorZero();
+			for (; k < tap.uNumTaps; ++k)
+			{
+				sum = XMVectorMultiplyAdd(XMLoadFloat4A(&pTexels[k]), XMVectorReplicate(pTapWeights[k]), sum);
+			}
+			XMStoreFloat4A(&pOut[x], sum);
+#endif
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   MipGenerator::accumulateRow
+
+	  Summary:  Adds a weighted row to a destination row, two texels
+				per register with AVX
+
+	  Args:     const XMFLOAT4A* pRow
+				  Row of the horizontal pass
+				FLOAT weight
+				  Weight of the row
+				UINT uNumTexels
+				  Width of both rows
+				XMFLOAT4A* pOut
+				  Destination row
+
+	  Modifies: [pOut].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void MipGenerator::accumulateRow(_In_reads_(uNumTexels) const XMFLOAT4A* pRow, _In_ FLOAT weight, _In_ UINT uNumTexels, _Inout_updates_(uNumTexels) XMFLOAT4A* pOut)
+	{
+		UINT x = 0u;
+
+#if defined(__AVX__)
+		const __m256 pairWeight = _mm256_set1_ps(weight);
+		for (; x + 2u <= uNumTexels; x += 2u)
+		{
+			_mm256_storeu_ps(&pOut[x].x, _mm256_add_ps(_mm256_loadu_ps(&pOut[x].x), _mm256_mul_ps(_mm256_loadu_ps(&pRow[x].x), pairWeight)));
+		}
+		if (x < uNumTexels)
+		{
+			_mm_store_ps(&pOut[x].x, _mm_add_ps(_mm_load_ps(&pOut[x].x), _mm_mul_ps(_mm_load_ps(&pRow[x].x), _mm256_castps256_ps128(pairWeight))));
+		}
+#else
+		const XMVECTOR texelWeight = XMVectorReplicate(weight);
+		for (; x < uNumTexels; ++x)
+		{
+			XMStoreFloat4A(&pOut[x], XMVectorMultiplyAdd(XMLoadFloat4A(&pRow[x]), texelWeight, XMLoadFloat4A(&pOut[x])));
+		}
+#endif
+	}
+}
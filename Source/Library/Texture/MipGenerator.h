@@ -0,0 +1,95 @@
+/*+===================================================================
+  File:      MIPGENERATOR.H
+
+  Summary:   MipGenerator header file contains declarations of
+			 MipGenerator class that builds mip chains of decoded
+			 images on the CPU.
+
+  Classes: MipGenerator
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/ImageDecoder.h"
+
+namespace library
+{
+	/*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+		Enum:     eMipFilter
+
+		Summary:  Enumeration of the filters a mip is reduced with.
+				  BOX averages the source texels a texel covers and
+				  keeps edges soft. KAISER is a windowed sinc that
+				  keeps more detail at the cost of slight ringing.
+	E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+	enum class eMipFilter : UINT
+	{
+		BOX = 0,
+		KAISER,
+		COUNT,
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    MipGenerator
+
+	  Summary:  Builds the full mip chain of an RGBA image down to 1x1
+				with a box or a Kaiser filter. Each level is filtered
+				from the linear float copy of the level above, one
+				texel per vector, or two texels per 256-bit register
+				when the library is compiled with /arch:AVX2, so
+				quantization does not add up. Color images are
+				averaged in linear space and alpha is averaged as is.
+				Odd sizes use fractional weights, so a texel of a
+				non-power-of-two level covers up to three source
+				texels in each direction with the box filter. The
+				Kaiser filter spans KAISER_RADIUS texels of the
+				smaller level on each side and clamps at the edges.
+
+	  Methods:  GenerateMipChain
+				  Appends every mip below the top level
+				GetNumMips
+				  Returns the number of mips of a full chain
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class MipGenerator final
+	{
+	public:
+		// Half width of the Kaiser filter in texels of the smaller level
+		static constexpr FLOAT KAISER_RADIUS = 3.0f;
+
+		// Shape of the Kaiser window, larger is smoother
+		static constexpr FLOAT KAISER_ALPHA = 4.0f;
+
+	public:
+		MipGenerator() = delete;
+		MipGenerator(const MipGenerator& other) = delete;
+		MipGenerator(MipGenerator&& other) = delete;
+		MipGenerator& operator=(const MipGenerator& other) = delete;
+		MipGenerator& operator=(MipGenerator&& other) = delete;
+		~MipGenerator() = delete;
+
+		static HRESULT GenerateMipChain(_Inout_ std::vector<ImageData>& aMips, _In_ BOOL bIsSrgb, _In_opt_ eMipFilter filter = eMipFilter::BOX);
+		static UINT GetNumMips(_In_ UINT uWidth, _In_ UINT uHeight);
+
+	private:
+		/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		  Struct:   Tap
+
+		  Summary:  Source texels a destination texel reads, and where
+					their weights start in the weight array
+		S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+		struct Tap
+		{
+			UINT uFirst;
+			UINT uNumTaps;
+			UINT uFirstWeight;
+		};
+
+	private:
+		static void computeTaps(_In_ UINT uSourceSize, _In_ UINT uDestinationSize, _In_ eMipFilter filter, _Out_ std::vector<Tap>& aOutTaps, _Out_ std::vector<FLOAT>& aOutWeights);
+		static void filterRow(_In_ const XMFLOAT4A* pSource, _In_reads_(uNumTexels) const Tap* pTaps, _In_ const FLOAT* pWeights, _In_ UINT uNumTexels, _Out_writes_(uNumTexels) XMFLOAT4A* pOut);
+		static void accumulateRow(_In_reads_(uNumTexels) const XMFLOAT4A* pRow, _In_ FLOAT weight, _In_ UINT uNumTexels, _Inout_updates_(uNumTexels) XMFLOAT4A* pOut);
+	};
+}
@@ -1,6 +1,11 @@
 #include "Texture.h"
 
+#include <algorithm>
+#include <fstream>
+
+#include "Texture/DDSLayout.h"
 #include "Texture/DDSTextureLoader.h"
+#include "Texture/TextureCooker.h"
 #include "Texture/WICTextureLoader.h"
 
 namespace library
@@ -17,35 +22,135 @@ namespace library
 				eTextureSamplerType textureSamplerType
 				  Texture sampler type of this texture
 
-	  Modifies: [m_filePath, m_textureRV, m_textureSamplerType].
+	  Modifies: [m_filePath, m_textureRV, m_textureSamplerType,
+				 m_uNumBytes, m_format, m_decodeMutex, m_aMips,
+				 m_decodeResult, m_bIsDecoded, m_streamingDevice,
+				 m_streamingContext, m_streamingTexture,
+				 m_streamingFormat, m_streamingPath, m_aMipOffsets,
+				 m_aStreamedMips, m_bIsSrgb, m_bIsStreaming].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	Texture::Texture(_In_ const std::filesystem::path& filePath, _In_opt_ eTextureSamplerType textureSamplerType) :
 		m_filePath(filePath),
 		m_textureRV(),
-		m_textureSamplerType(textureSamplerType)
+		m_textureSamplerType(textureSamplerType),
+		m_uNumBytes(0u),
+		m_format(DXGI_FORMAT_UNKNOWN),
+		m_decodeMutex(),
+		m_aMips(),
+		m_decodeResult(E_PENDING),
+		m_bIsDecoded(FALSE),
+		m_streamingDevice(),
+		m_streamingContext(),
+		m_streamingTexture(),
+		m_streamingFormat(DXGI_FORMAT_UNKNOWN),
+		m_streamingPath(),
+		m_aMipOffsets(),
+		m_aStreamedMips(),
+		m_bIsSrgb(TRUE),
+		m_bIsStreaming(FALSE)
 	{ }
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Texture::Decode
+
+	  Summary:  Decodes PNG and JPEG files to RGBA pixels and builds
+				their mip chain without the device, so it can run on
+				the job system. Only the first call decodes, later
+				calls return its result. Other formats, and textures
+				with an up to date cooked DDS file, return E_NOTIMPL
+				and are loaded by Initialize instead.
+
+	  Args:     BOOL bIsSrgb
+				  Whether the texels are colors, filtered in linear
+				  space, rather than data such as normals
+
+	  Modifies: [m_aMips, m_decodeResult, m_bIsDecoded].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Texture::Decode(_In_opt_ BOOL bIsSrgb)
+	{
+		std::lock_guard<std::mutex> lock(m_decodeMutex);
+
+		if (m_bIsDecoded)
+		{
+			return m_decodeResult;
+		}
+
+		m_bIsDecoded = TRUE;
+
+		if (!ImageDecoder::IsSupportedExtension(m_filePath) || !TextureCooker::GetCookedPath(m_filePath).empty())
+		{
+			m_decodeResult = E_NOTIMPL;
+			return m_decodeResult;
+		}
+
+		m_aMips.resize(1u);
+		m_decodeResult = ImageDecoder::DecodeFile(m_filePath, m_aMips[0]);
+		if (SUCCEEDED(m_decodeResult))
+		{
+			m_decodeResult = MipGenerator::GenerateMipChain(m_aMips, bIsSrgb);
+		}
+
+		if (FAILED(m_decodeResult))
+		{
+			m_aMips.clear();
+		}
+
+		return m_decodeResult;
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Texture::Initialize
 
-	  Summary:  Initializes the texture and samplers if not initialized
+	  Summary:  Initializes the texture and samplers if not initialized.
+				Textures shared through the texture cache are loaded
+				by the first material only. A cooked DDS file is
+				preferred, decoded pixels are uploaded with their mip
+				chain, other files go through WIC or DDS. Textures the
+				texture streamer loads are left to it.
 
 	  Args:     ID3D11Device* pDevice
 				  The Direct3D device to create the buffers
 				ID3D11DeviceContext* pImmediateContext
 				  The Direct3D context to set buffers
 
-	  Modifies: [m_textureRV].
+	  Modifies: [m_textureRV, m_uNumBytes, m_format, m_aMips].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	HRESULT Texture::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
 	{
-		HRESULT hr = CreateWICTextureFromFile(
-			pDevice,
-			pImmediateContext,
-			m_filePath.c_str(),
-			nullptr,
-			m_textureRV.GetAddressOf()
-		);
+		if (m_textureRV || m_bIsStreaming)
+		{
+			return S_OK;
+		}
+
+		HRESULT hr = E_FAIL;
+		std::filesystem::path cookedPath = TextureCooker::GetCookedPath(m_filePath);
+		if (!cookedPath.empty())
+		{
+			hr = CreateDDSTextureFromFile(pDevice, cookedPath.c_str(), nullptr, m_textureRV.GetAddressOf());
+		}
+
+		if (FAILED(hr))
+		{
+			hr = Decode();
+			if (SUCCEEDED(hr))
+			{
+				hr = createFromMips(pDevice);
+			}
+		}
+
+		if (FAILED(hr))
+		{
+			hr = CreateWICTextureFromFile(
+				pDevice,
+				pImmediateContext,
+				m_filePath.c_str(),
+				nullptr,
+				m_textureRV.GetAddressOf()
+			);
+		}
 		if (FAILED(hr))
 		{
 			hr = CreateDDSTextureFromFile(pDevice, m_filePath.c_str(), nullptr, m_textureRV.GetAddressOf());
@@ -58,46 +163,374 @@ namespace library
 			}
 		}
 
-		// Create the sample state
-		if (!s_samplers[static_cast<size_t>(eTextureSamplerType::TRILINEAR_WRAP)].Get())
+		m_uNumBytes = computeNumBytes(m_textureRV.Get());
+
+		D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+		m_textureRV->GetDesc(&srvDesc);
+		m_format = srvDesc.Format;
+
+		return createSamplers(pDevice);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Texture::IsStreamable
+
+	  Summary:  Returns whether the texture streamer can load the
+				texture: PNG and JPEG files, decoded on the CPU, and
+				their cooked DDS files
+
+	  Returns:  BOOL
+				  TRUE if the file can be streamed
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL Texture::IsStreamable() const
+	{
+		return ImageDecoder::IsSupportedExtension(m_filePath);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Texture::InitializeStreaming
+
+	  Summary:  Creates the samplers and keeps the device for the
+				texture streamer, which creates and fills the texture
+				later. The texture has no resource view until its mip
+				tail has been uploaded.
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the texture
+				ID3D11DeviceContext* pImmediateContext
+				  The Direct3D context to upload the mips
+				BOOL bIsSrgb
+				  Whether the texels are colors, used when the mip
+				  chain is built on the CPU
+
+	  Modifies: [m_streamingDevice, m_streamingContext, m_bIsSrgb,
+				 m_bIsStreaming].
+
+	  Returns:  HRESULT
+				  S_OK if the texture should be registered with the
+				  streamer, S_FALSE if it is already loaded or
+				  streaming
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Texture::InitializeStreaming(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ BOOL bIsSrgb)
+	{
+		if (m_textureRV || m_bIsStreaming)
 		{
-			D3D11_SAMPLER_DESC sampDesc =
-			{
-				.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR,
-				.AddressU = D3D11_TEXTURE_ADDRESS_WRAP,
-				.AddressV = D3D11_TEXTURE_ADDRESS_WRAP,
-				.AddressW = D3D11_TEXTURE_ADDRESS_WRAP,
-				.ComparisonFunc = D3D11_COMPARISON_ALWAYS,
-				.MinLOD = 0,
-				.MaxLOD = D3D11_FLOAT32_MAX
-			};
-			hr = pDevice->CreateSamplerState(&sampDesc, s_samplers[static_cast<size_t>(eTextureSamplerType::TRILINEAR_WRAP)].GetAddressOf());
+			return S_FALSE;
+		}
+
+		HRESULT hr = createSamplers(pDevice);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		m_streamingDevice = pDevice;
+		m_streamingContext = pImmediateContext;
+		m_bIsSrgb = bIsSrgb;
+		m_bIsStreaming = TRUE;
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Texture::PrepareStreaming
+
+	  Summary:  Describes the mip chain, on a background job. A cooked
+				DDS file only has its headers read, and its mips are
+				read from the file later; other files are decoded and
+				their mips built now.
+
+	  Args:     std::vector<StreamedMipDesc>& aOutMips
+				  Size and layout of every mip
+
+	  Modifies: [m_streamingFormat, m_streamingPath, m_aMipOffsets,
+				 m_aStreamedMips, m_aMips].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Texture::PrepareStreaming(_Out_ std::vector<StreamedMipDesc>& aOutMips)
+	{
+		aOutMips.clear();
+
+		std::filesystem::path cookedPath = TextureCooker::GetCookedPath(m_filePath);
+		if (cookedPath.empty())
+		{
+			HRESULT hr = Decode(m_bIsSrgb);
 			if (FAILED(hr))
 			{
 				return hr;
 			}
+
+			for (const ImageData& mip : m_aMips)
+			{
+				aOutMips.push_back(
+					StreamedMipDesc
+					{
+						.uWidth = mip.uWidth,
+						.uHeight = mip.uHeight,
+						.uNumRows = mip.uHeight,
+						.uRowPitch = mip.uWidth * 4u
+					}
+				);
+			}
+
+			m_streamingFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+			m_aStreamedMips = aOutMips;
+
+			return S_OK;
 		}
 
-		if (!s_samplers[static_cast<size_t>(eTextureSamplerType::TRILINEAR_CLAMP)].Get())
+		std::ifstream file(cookedPath, std::ios::binary | std::ios::ate);
+		if (!file)
 		{
-			D3D11_SAMPLER_DESC sampDesc =
+			return E_FAIL;
+		}
+		SIZE_T uFileSize = static_cast<SIZE_T>(file.tellg());
+
+		BYTE aHeaders[sizeof(UINT32) + sizeof(DirectX::DDS_HEADER) + sizeof(DirectX::DDS_HEADER_DXT10)] = {};
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(aHeaders), static_cast<std::streamsize>(std::min<SIZE_T>(sizeof(aHeaders), uFileSize)));
+
+		// Only the headers are looked at, the file size just has to cover them
+		const DirectX::DDS_HEADER* pHeader = nullptr;
+		const uint8_t* pBitData = nullptr;
+		size_t uBitSize = 0u;
+		HRESULT hr = DirectX::ParseDDSHeader(aHeaders, std::min<SIZE_T>(sizeof(aHeaders), uFileSize), &pHeader, &pBitData, &uBitSize);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		DXGI_FORMAT format = DirectX::GetDXGIFormat(pHeader->ddspf);
+		if ((pHeader->ddspf.flags & DDS_FOURCC) && pHeader->ddspf.fourCC == MAKEFOURCC('D', 'X', '1', '0'))
+		{
+			const DirectX::DDS_HEADER_DXT10* pDx10Header = reinterpret_cast<const DirectX::DDS_HEADER_DXT10*>(pHeader + 1);
+			if (pDx10Header->arraySize != 1u)
 			{
-				.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR,
-				.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP,
-				.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP,
-				.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP,
-				.ComparisonFunc = D3D11_COMPARISON_ALWAYS,
-				.MinLOD = 0,
-				.MaxLOD = D3D11_FLOAT32_MAX
-			};
-			hr = pDevice->CreateSamplerState(&sampDesc, s_samplers[static_cast<size_t>(eTextureSamplerType::TRILINEAR_CLAMP)].GetAddressOf());
+				return E_NOTIMPL;
+			}
+			format = pDx10Header->dxgiFormat;
+		}
+
+		if (DirectX::BitsPerPixel(format) == 0u || (pHeader->caps2 & DDS_CUBEMAP) || (pHeader->flags & DDS_HEADER_FLAGS_VOLUME))
+		{
+			return E_NOTIMPL;
+		}
+
+		UINT64 uOffset = static_cast<UINT64>(pBitData - aHeaders);
+		UINT uNumMips = std::max<UINT>(1u, pHeader->mipMapCount);
+		m_aMipOffsets.clear();
+		for (UINT uMip = 0u; uMip < uNumMips; ++uMip)
+		{
+			UINT uWidth = std::max<UINT>(1u, pHeader->width >> uMip);
+			UINT uHeight = std::max<UINT>(1u, pHeader->height >> uMip);
+
+			SIZE_T uNumBytes = 0u;
+			SIZE_T uRowBytes = 0u;
+			SIZE_T uNumRows = 0u;
+			hr = DirectX::GetSurfaceInfo(uWidth, uHeight, format, &uNumBytes, &uRowBytes, &uNumRows);
 			if (FAILED(hr))
 			{
 				return hr;
 			}
+
+			aOutMips.push_back(
+				StreamedMipDesc
+				{
+					.uWidth = uWidth,
+					.uHeight = uHeight,
+					.uNumRows = static_cast<UINT>(uNumRows),
+					.uRowPitch = static_cast<UINT>(uRowBytes)
+				}
+			);
+			m_aMipOffsets.push_back(uOffset);
+			uOffset += uNumBytes;
 		}
 
-		return hr;
+		if (uOffset > uFileSize)
+		{
+			aOutMips.clear();
+			return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+		}
+
+		m_streamingFormat = format;
+		m_streamingPath = cookedPath;
+		m_aStreamedMips = aOutMips;
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Texture::LoadMip
+
+	  Summary:  Reads one mip, on a background job: from the cooked
+				file, or by handing over the decoded pixels
+
+	  Args:     UINT uMip
+				  Mip to read
+				std::vector<BYTE>& aOutData
+				  Rows of the mip, without padding
+
+	  Modifies: [m_aMips].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Texture::LoadMip(_In_ UINT uMip, _Out_ std::vector<BYTE>& aOutData)
+	{
+		if (uMip >= m_aStreamedMips.size())
+		{
+			return E_INVALIDARG;
+		}
+
+		if (m_aMipOffsets.empty())
+		{
+			std::lock_guard<std::mutex> lock(m_decodeMutex);
+
+			aOutData = std::move(m_aMips[uMip].aPixels);
+			return aOutData.empty() ? E_FAIL : S_OK;
+		}
+
+		const StreamedMipDesc& mip = m_aStreamedMips[uMip];
+		aOutData.resize(static_cast<SIZE_T>(mip.uNumRows) * mip.uRowPitch);
+
+		std::ifstream file(m_streamingPath, std::ios::binary);
+		file.seekg(static_cast<std::streamoff>(m_aMipOffsets[uMip]));
+		file.read(reinterpret_cast<char*>(aOutData.data()), static_cast<std::streamsize>(aOutData.size()));
+		if (!file)
+		{
+			aOutData.clear();
+			return E_FAIL;
+		}
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Texture::CreateStreamingResource
+
+	  Summary:  Creates the texture with its whole mip chain and no
+				data; shaders do not see it before the mip tail is
+				uploaded
+
+	  Args:     const std::vector<StreamedMipDesc>& aMips
+				  Mip chain described by PrepareStreaming
+
+	  Modifies: [m_streamingTexture].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Texture::CreateStreamingResource(_In_ const std::vector<StreamedMipDesc>& aMips)
+	{
+		D3D11_TEXTURE2D_DESC desc =
+		{
+			.Width = aMips[0].uWidth,
+			.Height = aMips[0].uHeight,
+			.MipLevels = static_cast<UINT>(aMips.size()),
+			.ArraySize = 1u,
+			.Format = m_streamingFormat,
+			.SampleDesc = {.Count = 1u, .Quality = 0u },
+			.Usage = D3D11_USAGE_DEFAULT,
+			.BindFlags = D3D11_BIND_SHADER_RESOURCE,
+			.CPUAccessFlags = 0u,
+			.MiscFlags = 0u
+		};
+
+		return m_streamingDevice->CreateTexture2D(&desc, nullptr, m_streamingTexture.ReleaseAndGetAddressOf());
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Texture::UploadRows
+
+	  Summary:  Copies rows of a mip to the texture. A row of a block
+				compressed mip covers four texel rows, and the last
+				one stops at the edge of the mip.
+
+	  Args:     UINT uMip
+				  Mip to write
+				UINT uFirstRow
+				  First row to write
+				UINT uNumRows
+				  Number of rows to write
+				const BYTE* pRows
+				  Rows, uRowPitch bytes apart
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Texture::UploadRows(_In_ UINT uMip, _In_ UINT uFirstRow, _In_ UINT uNumRows, _In_ const BYTE* pRows)
+	{
+		if (!m_streamingTexture || uMip >= m_aStreamedMips.size())
+		{
+			return E_UNEXPECTED;
+		}
+
+		const StreamedMipDesc& mip = m_aStreamedMips[uMip];
+		UINT uRowHeight = mip.uNumRows == mip.uHeight ? 1u : 4u;
+
+		D3D11_BOX box =
+		{
+			.left = 0u,
+			.top = uFirstRow * uRowHeight,
+			.front = 0u,
+			.right = mip.uWidth,
+			.bottom = std::min<UINT>(mip.uHeight, (uFirstRow + uNumRows) * uRowHeight),
+			.back = 1u
+		};
+
+		m_streamingContext->UpdateSubresource(
+			m_streamingTexture.Get(),
+			D3D11CalcSubresource(uMip, 0u, static_cast<UINT>(m_aStreamedMips.size())),
+			&box,
+			pRows,
+			mip.uRowPitch,
+			0u
+		);
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Texture::SetMostDetailedMip
+
+	  Summary:  Recreates the resource view so shaders sample from the
+				mip down, every one of them being uploaded
+
+	  Args:     UINT uMip
+				  Most detailed resident mip
+
+	  Modifies: [m_textureRV, m_uNumBytes, m_format].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Texture::SetMostDetailedMip(_In_ UINT uMip)
+	{
+		D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc =
+		{
+			.Format = m_streamingFormat,
+			.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D,
+			.Texture2D = {.MostDetailedMip = uMip, .MipLevels = static_cast<UINT>(-1) }
+		};
+
+		ComPtr<ID3D11ShaderResourceView> textureRV;
+		HRESULT hr = m_streamingDevice->CreateShaderResourceView(m_streamingTexture.Get(), &srvDesc, textureRV.GetAddressOf());
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+		m_textureRV = textureRV;
+		m_format = m_streamingFormat;
+
+		m_uNumBytes = 0u;
+		for (UINT uResidentMip = uMip; uResidentMip < m_aStreamedMips.size(); ++uResidentMip)
+		{
+			m_uNumBytes += static_cast<SIZE_T>(m_aStreamedMips[uResidentMip].uNumRows) * m_aStreamedMips[uResidentMip].uRowPitch;
+		}
+
+		return S_OK;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -125,4 +558,201 @@ namespace library
 	{
 		return m_textureSamplerType;
 	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Texture::GetNumBytes
+
+	  Summary:  Returns the size of the loaded texture in video memory
+
+	  Returns:  SIZE_T
+				  Size in bytes, 0 before Initialize
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T Texture::GetNumBytes() const
+	{
+		return m_uNumBytes;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Texture::IsTwoChannel
+
+	  Summary:  Returns whether the loaded texture only stores red and
+				green, like the BC5 normal maps of the texture cooker
+
+	  Returns:  BOOL
+				  TRUE if BC5, FALSE otherwise and before Initialize
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL Texture::IsTwoChannel() const
+	{
+		return m_format == DXGI_FORMAT_BC5_TYPELESS || m_format == DXGI_FORMAT_BC5_UNORM || m_format == DXGI_FORMAT_BC5_SNORM;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Texture::createFromMips
+
+	  Summary:  Creates an immutable texture with every decoded mip as
+				initial data, in a single upload, and releases the CPU
+				copy
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the texture
+
+	  Modifies: [m_textureRV, m_aMips].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Texture::createFromMips(_In_ ID3D11Device* pDevice)
+	{
+		if (m_aMips.empty())
+		{
+			return E_FAIL;
+		}
+
+		std::vector<D3D11_SUBRESOURCE_DATA> aInitialData;
+		aInitialData.reserve(m_aMips.size());
+		for (const ImageData& mip : m_aMips)
+		{
+			aInitialData.push_back(
+				D3D11_SUBRESOURCE_DATA
+				{
+					.pSysMem = mip.aPixels.data(),
+					.SysMemPitch = mip.uWidth * 4u,
+					.SysMemSlicePitch = 0u
+				}
+			);
+		}
+
+		D3D11_TEXTURE2D_DESC desc =
+		{
+			.Width = m_aMips[0].uWidth,
+			.Height = m_aMips[0].uHeight,
+			.MipLevels = static_cast<UINT>(m_aMips.size()),
+			.ArraySize = 1u,
+			.Format = DXGI_FORMAT_R8G8B8A8_UNORM,
+			.SampleDesc = {.Count = 1u, .Quality = 0u },
+			.Usage = D3D11_USAGE_IMMUTABLE,
+			.BindFlags = D3D11_BIND_SHADER_RESOURCE,
+			.CPUAccessFlags = 0u,
+			.MiscFlags = 0u
+		};
+
+		ComPtr<ID3D11Texture2D> texture;
+		HRESULT hr = pDevice->CreateTexture2D(&desc, aInitialData.data(), texture.GetAddressOf());
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		hr = pDevice->CreateShaderResourceView(texture.Get(), nullptr, m_textureRV.ReleaseAndGetAddressOf());
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		m_aMips = std::vector<ImageData>();
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Texture::computeNumBytes
+
+	  Summary:  Adds up the size of every mip and array slice of the
+				2D texture behind a shader resource view
+
+	  Args:     ID3D11ShaderResourceView* pTextureRV
+				  Shader resource view of the texture
+
+	  Returns:  SIZE_T
+				  Size in bytes, 0 for other resource types
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T Texture::computeNumBytes(_In_ ID3D11ShaderResourceView* pTextureRV)
+	{
+		ComPtr<ID3D11Resource> resource;
+		pTextureRV->GetResource(resource.GetAddressOf());
+
+		ComPtr<ID3D11Texture2D> texture2d;
+		if (FAILED(resource.As(&texture2d)))
+		{
+			return 0u;
+		}
+
+		D3D11_TEXTURE2D_DESC desc = {};
+		texture2d->GetDesc(&desc);
+
+		SIZE_T uNumBytes = 0u;
+		for (UINT uMip = 0u; uMip < desc.MipLevels; ++uMip)
+		{
+			SIZE_T uWidth = std::max<SIZE_T>(1u, desc.Width >> uMip);
+			SIZE_T uHeight = std::max<SIZE_T>(1u, desc.Height >> uMip);
+
+			SIZE_T uMipBytes = 0u;
+			if (SUCCEEDED(DirectX::GetSurfaceInfo(uWidth, uHeight, desc.Format, &uMipBytes, nullptr, nullptr)))
+			{
+				uNumBytes += uMipBytes;
+			}
+		}
+
+		return uNumBytes * desc.ArraySize;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Texture::createSamplers
+
+	  Summary:  Creates the samplers shared by every texture, the first
+				time only
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the samplers
+
+	  Modifies: [s_samplers].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Texture::createSamplers(_In_ ID3D11Device* pDevice)
+	{
+		HRESULT hr = S_OK;
+
+		// Create the sample state
+		if (!s_samplers[static_cast<size_t>(eTextureSamplerType::TRILINEAR_WRAP)].Get())
+		{
+			D3D11_SAMPLER_DESC sampDesc =
+			{
+				.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR,
+				.AddressU = D3D11_TEXTURE_ADDRESS_WRAP,
+				.AddressV = D3D11_TEXTURE_ADDRESS_WRAP,
+				.AddressW = D3D11_TEXTURE_ADDRESS_WRAP,
+				.ComparisonFunc = D3D11_COMPARISON_ALWAYS,
+				.MinLOD = 0,
+				.MaxLOD = D3D11_FLOAT32_MAX
+			};
+			hr = pDevice->CreateSamplerState(&sampDesc, s_samplers[static_cast<size_t>(eTextureSamplerType::TRILINEAR_WRAP)].GetAddressOf());
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+		}
+
+		if (!s_samplers[static_cast<size_t>(eTextureSamplerType::TRILINEAR_CLAMP)].Get())
+		{
+			D3D11_SAMPLER_DESC sampDesc =
+			{
+				.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR,
+				.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP,
+				.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP,
+				.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP,
+				.ComparisonFunc = D3D11_COMPARISON_ALWAYS,
+				.MinLOD = 0,
+				.MaxLOD = D3D11_FLOAT32_MAX
+			};
+			hr = pDevice->CreateSamplerState(&sampDesc, s_samplers[static_cast<size_t>(eTextureSamplerType::TRILINEAR_CLAMP)].GetAddressOf());
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+		}
+
+		return hr;
+	}
 }
\ No newline at end of file
@@ -12,6 +12,11 @@
 
 #include "Common.h"
 
+#include <mutex>
+
+#include "Texture/MipGenerator.h"
+#include "Texture/TextureStreamer.h"
+
 namespace library
 {
 	enum class eTextureSamplerType : size_t
@@ -21,7 +26,7 @@ namespace library
 		COUNT,
 	};
 
-	class Texture
+	class Texture : public StreamableTexture
 	{
 	public:
 		Texture() = delete;
@@ -32,11 +37,31 @@ namespace library
 		Texture& operator=(Texture&& other) = delete;
 		virtual ~Texture() = default;
 
-		// Should be called once to load the texture
+		// Decodes the file and its mip chain to CPU pixels, safe to call from any thread
+		HRESULT Decode(_In_opt_ BOOL bIsSrgb = TRUE);
+
+		// Loads the texture on the first call, later calls do nothing
 		virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
 
+		// Creates the samplers and lets the texture streamer load the texture, S_FALSE if already loaded
+		BOOL IsStreamable() const;
+		HRESULT InitializeStreaming(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ BOOL bIsSrgb);
+
+		HRESULT PrepareStreaming(_Out_ std::vector<StreamedMipDesc>& aOutMips) override;
+		HRESULT LoadMip(_In_ UINT uMip, _Out_ std::vector<BYTE>& aOutData) override;
+		HRESULT CreateStreamingResource(_In_ const std::vector<StreamedMipDesc>& aMips) override;
+		HRESULT UploadRows(_In_ UINT uMip, _In_ UINT uFirstRow, _In_ UINT uNumRows, _In_ const BYTE* pRows) override;
+		HRESULT SetMostDetailedMip(_In_ UINT uMip) override;
+
 		ComPtr<ID3D11ShaderResourceView>& GetTextureResourceView();
 		eTextureSamplerType GetSamplerType() const;
+		SIZE_T GetNumBytes() const;
+		BOOL IsTwoChannel() const;
+
+	protected:
+		HRESULT createFromMips(_In_ ID3D11Device* pDevice);
+		static SIZE_T computeNumBytes(_In_ ID3D11ShaderResourceView* pTextureRV);
+		static HRESULT createSamplers(_In_ ID3D11Device* pDevice);
 
 	public:
 		static ComPtr<ID3D11SamplerState> s_samplers[static_cast<size_t>(eTextureSamplerType::COUNT)];
@@ -45,5 +70,20 @@ namespace library
 		std::filesystem::path m_filePath;
 		ComPtr<ID3D11ShaderResourceView> m_textureRV;
 		eTextureSamplerType m_textureSamplerType;
+		SIZE_T m_uNumBytes;
+		DXGI_FORMAT m_format;
+		std::mutex m_decodeMutex;
+		std::vector<ImageData> m_aMips;
+		HRESULT m_decodeResult;
+		BOOL m_bIsDecoded;
+		ComPtr<ID3D11Device> m_streamingDevice;
+		ComPtr<ID3D11DeviceContext> m_streamingContext;
+		ComPtr<ID3D11Texture2D> m_streamingTexture;
+		DXGI_FORMAT m_streamingFormat;
+		std::filesystem::path m_streamingPath;
+		std::vector<UINT64> m_aMipOffsets;
+		std::vector<StreamedMipDesc> m_aStreamedMips;
+		BOOL m_bIsSrgb;
+		BOOL m_bIsStreaming;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "Texture/TextureCache.h"
+
+namespace library
+{
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCache::GetInstance
+
+	  Summary:  Returns the process-wide texture cache
+
+	  Returns:  TextureCache&
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	TextureCache& TextureCache::GetInstance()
+	{
+		static TextureCache s_instance;
+		return s_instance;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCache::TextureCache
+
+	  Summary:  Constructor
+
+	  Modifies: [m_mutex, m_entries, m_uNumHits, m_uNumMisses].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	TextureCache::TextureCache()
+		: m_mutex()
+		, m_entries()
+		, m_uNumHits(0u)
+		, m_uNumMisses(0u)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCache::GetOrCreate
+
+	  Summary:  Returns the texture of the file and sampler type. The
+				texture is created, but not initialized, on the first
+				request; initializing it again after it has been
+				loaded does nothing.
+
+	  Args:     const std::filesystem::path& filePath
+				  Path to the image file
+				eTextureSamplerType textureSamplerType
+				  Sampler type of the texture
+
+	  Modifies: [m_entries, m_uNumHits, m_uNumMisses].
+
+	  Returns:  std::shared_ptr<Texture>
+				  Shared texture object
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	std::shared_ptr<Texture> TextureCache::GetOrCreate(
+		_In_ const std::filesystem::path& filePath,
+		_In_opt_ eTextureSamplerType textureSamplerType
+	)
+	{
+		std::wstring szKey = makeKey(filePath, textureSamplerType);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		Entry& entry = m_entries[szKey];
+
+		std::shared_ptr<Texture> texture = entry.Shared.lock();
+		if (texture)
+		{
+			++entry.uNumHits;
+			++m_uNumHits;
+
+			return texture;
+		}
+
+		texture = std::make_shared<Texture>(filePath, textureSamplerType);
+		entry.Shared = texture;
+		entry.uNumHits = 0u;
+		++m_uNumMisses;
+
+		return texture;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCache::Trim
+
+	  Summary:  Removes the entries of the textures that have been
+				released by every material
+
+	  Modifies: [m_entries].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void TextureCache::Trim()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		std::erase_if(m_entries, [](const auto& pair) { return pair.second.Shared.expired(); });
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCache::ReportStatistics
+
+	  Summary:  Logs the number of textures created and shared, their
+				references and the memory that the hits did not spend
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void TextureCache::ReportStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		UINT uNumLive = 0u;
+		UINT uNumReferences = 0u;
+		for (const auto& pair : m_entries)
+		{
+			LONG lUseCount = pair.second.Shared.use_count();
+			uNumLive += lUseCount > 0 ? 1u : 0u;
+			uNumReferences += static_cast<UINT>(lUseCount);
+		}
+
+		WCHAR szMessage[256];
+		swprintf_s(
+			szMessage,
+			L"TextureCache: %u miss(es), %u hit(s), %u live texture(s) with %u reference(s), %.2f MB saved\n",
+			m_uNumMisses,
+			m_uNumHits,
+			uNumLive,
+			uNumReferences,
+			static_cast<FLOAT>(getNumBytesSaved()) / (1024.0f * 1024.0f)
+		);
+		OutputDebugString(szMessage);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCache::GetNumHits
+
+	  Summary:  Returns the number of requests served from the cache
+
+	  Returns:  UINT
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT TextureCache::GetNumHits() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		return m_uNumHits;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCache::GetNumMisses
+
+	  Summary:  Returns the number of textures created
+
+	  Returns:  UINT
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT TextureCache::GetNumMisses() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		return m_uNumMisses;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCache::GetNumBytesSaved
+
+	  Summary:  Returns the GPU bytes that the hits on loaded textures
+				did not allocate again
+
+	  Returns:  SIZE_T
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T TextureCache::GetNumBytesSaved() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		return getNumBytesSaved();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCache::makeKey
+
+	  Summary:  Returns the key of a file path and sampler type, so
+				different spellings of the same file share one entry
+
+	  Args:     const std::filesystem::path& filePath
+				  Path to the image file
+				eTextureSamplerType textureSamplerType
+				  Sampler type of the texture
+
+	  Returns:  std::wstring
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	std::wstring TextureCache::makeKey(_In_ const std::filesystem::path& filePath, _In_ eTextureSamplerType textureSamplerType)
+	{
+		std::error_code errorCode;
+		std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filePath, errorCode);
+		if (errorCode)
+		{
+			canonicalPath = filePath.lexically_normal();
+		}
+
+		return canonicalPath.wstring() + L"|" + std::to_wstring(static_cast<size_t>(textureSamplerType));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCache::getNumBytesSaved
+
+	  Summary:  Sums the size of every live texture times its hits.
+				The caller holds the mutex.
+
+	  Returns:  SIZE_T
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T TextureCache::getNumBytesSaved() const
+	{
+		SIZE_T uNumBytes = 0u;
+		for (const auto& pair : m_entries)
+		{
+			std::shared_ptr<Texture> texture = pair.second.Shared.lock();
+			if (texture)
+			{
+				uNumBytes += texture->GetNumBytes() * pair.second.uNumHits;
+			}
+		}
+
+		return uNumBytes;
+	}
+}
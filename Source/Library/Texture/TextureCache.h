@@ -0,0 +1,92 @@
+/*+===================================================================
+  File:      TEXTURECACHE.H
+
+  Summary:   TextureCache header file contains declarations of
+			 TextureCache class that shares one texture object per
+			 image file and sampler type.
+
+  Classes: TextureCache
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <mutex>
+
+#include "Texture/Texture.h"
+
+namespace library
+{
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    TextureCache
+
+	  Summary:  Hands out one texture per canonical file path and
+				sampler type, so an image referenced by several
+				materials is decoded and uploaded once. The cache only
+				keeps weak references: a texture is released with the
+				last material that uses it, and the next request loads
+				it again.
+
+	  Methods:  GetInstance
+				  Returns the process-wide texture cache
+				GetOrCreate
+				  Returns the texture of the file, creating it on the
+				  first request
+				Trim
+				  Forgets the textures nobody references anymore
+				ReportStatistics
+				  Logs hits, misses and the memory saved
+				GetNumHits
+				  Returns the number of requests served from the cache
+				GetNumMisses
+				  Returns the number of textures created
+				GetNumBytesSaved
+				  Returns the texture bytes not duplicated by hits
+				TextureCache
+				  Constructor.
+				~TextureCache
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class TextureCache final
+	{
+	public:
+		static TextureCache& GetInstance();
+
+		TextureCache();
+		TextureCache(const TextureCache& other) = delete;
+		TextureCache(TextureCache&& other) = delete;
+		TextureCache& operator=(const TextureCache& other) = delete;
+		TextureCache& operator=(TextureCache&& other) = delete;
+		~TextureCache() = default;
+
+		std::shared_ptr<Texture> GetOrCreate(
+			_In_ const std::filesystem::path& filePath,
+			_In_opt_ eTextureSamplerType textureSamplerType = eTextureSamplerType::TRILINEAR_WRAP
+		);
+		void Trim();
+		void ReportStatistics() const;
+
+		UINT GetNumHits() const;
+		UINT GetNumMisses() const;
+		SIZE_T GetNumBytesSaved() const;
+
+	private:
+		struct Entry
+		{
+			std::weak_ptr<Texture> Shared;
+			UINT uNumHits;
+		};
+
+		static std::wstring makeKey(_In_ const std::filesystem::path& filePath, _In_ eTextureSamplerType textureSamplerType);
+
+		SIZE_T getNumBytesSaved() const;
+
+	private:
+		mutable std::mutex m_mutex;
+		std::unordered_map<std::wstring, Entry> m_entries;
+		UINT m_uNumHits;
+		UINT m_uNumMisses;
+	};
+}
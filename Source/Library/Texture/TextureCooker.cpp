@@ -0,0 +1,338 @@
+#include "Texture/TextureCooker.h"
+
+#include <algorithm>
+#include <cwctype>
+#include <fstream>
+
+#include "Job/JobSystem.h"
+#include "Texture/DDSLayout.h"
+#include "Texture/MipGenerator.h"
+
+namespace library
+{
+	namespace
+	{
+		constexpr UINT32 DDS_DIMENSION_TEXTURE2D = 3u;		// D3D11_RESOURCE_DIMENSION_TEXTURE2D
+
+		constexpr PCWSTR FORMAT_NAMES[static_cast<size_t>(eBlockFormat::COUNT)] = { L"BC1", L"BC3", L"BC5", L"BC7" };
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCooker::CookDirectory
+
+	  Summary:  Cooks every PNG and JPEG file under the directory, one
+				file per job, and logs each result and the totals
+
+	  Args:     const std::filesystem::path& directory
+				  Directory to search recursively
+				BOOL bUseBc7
+				  Whether color textures use BC7 instead of BC1 and BC3
+
+	  Returns:  std::vector<CookResult>
+				  One result per file
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	std::vector<CookResult> TextureCooker::CookDirectory(_In_ const std::filesystem::path& directory, _In_ BOOL bUseBc7)
+	{
+		std::vector<std::filesystem::path> aSourcePaths;
+		std::error_code errorCode;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, errorCode))
+		{
+			if (entry.is_regular_file() && ImageDecoder::IsSupportedExtension(entry.path()))
+			{
+				aSourcePaths.push_back(entry.path());
+			}
+		}
+
+		std::vector<CookResult> aResults(aSourcePaths.size());
+		JobSystem::GetInstance().ParallelFor(
+			static_cast<UINT>(aSourcePaths.size()),
+			1u,
+			[&](UINT uBegin, UINT uEnd)
+			{
+				for (UINT i = uBegin; i < uEnd; ++i)
+				{
+					aResults[i] = CookFile(aSourcePaths[i], bUseBc7);
+				}
+			}
+		);
+
+		UINT uNumFailed = 0u;
+		UINT64 uUncompressedBytes = 0ull;
+		UINT64 uCookedBytes = 0ull;
+		for (const CookResult& result : aResults)
+		{
+			ReportResult(result);
+
+			if (FAILED(result.Result))
+			{
+				++uNumFailed;
+				continue;
+			}
+			uUncompressedBytes += result.uUncompressedBytes;
+			uCookedBytes += result.uCookedBytes;
+		}
+
+		WCHAR szMessage[256];
+		swprintf_s(
+			szMessage,
+			L"TextureCooker: %u texture(s), %u failed, %.2f MB uncompressed, %.2f MB cooked\n",
+			static_cast<UINT>(aResults.size()),
+			uNumFailed,
+			static_cast<FLOAT>(uUncompressedBytes) / (1024.0f * 1024.0f),
+			static_cast<FLOAT>(uCookedBytes) / (1024.0f * 1024.0f)
+		);
+		OutputDebugString(szMessage);
+
+		return aResults;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCooker::CookFile
+
+	  Summary:  Decodes the texture, builds its mip chain with the
+				Kaiser filter, compresses every mip and writes
+				"<file>.dds". The PSNR is measured on the top mip.
+
+	  Args:     const std::filesystem::path& sourcePath
+				  PNG or JPEG file
+				BOOL bUseBc7
+				  Whether color textures use BC7 instead of BC1 and BC3
+
+	  Returns:  CookResult
+				  Sizes, quality and status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	CookResult TextureCooker::CookFile(_In_ const std::filesystem::path& sourcePath, _In_ BOOL bUseBc7)
+	{
+		CookResult result =
+		{
+			.SourcePath = sourcePath,
+			.Format = eBlockFormat::BC1,
+			.uWidth = 0u,
+			.uHeight = 0u,
+			.uNumMips = 0u,
+			.uSourceBytes = 0ull,
+			.uUncompressedBytes = 0ull,
+			.uCookedBytes = 0ull,
+			.Psnr = 0.0f,
+			.Result = S_OK
+		};
+
+		std::vector<ImageData> aMips(1u);
+		result.Result = ImageDecoder::DecodeFile(sourcePath, aMips[0]);
+		if (FAILED(result.Result))
+		{
+			return result;
+		}
+
+		std::error_code errorCode;
+		result.uSourceBytes = std::filesystem::file_size(sourcePath, errorCode);
+		result.uWidth = aMips[0].uWidth;
+		result.uHeight = aMips[0].uHeight;
+
+		const BOOL bIsNormalMap = IsNormalMap(sourcePath);
+		BOOL bHasAlpha = FALSE;
+		for (SIZE_T i = 3u; i < aMips[0].aPixels.size() && !bHasAlpha; i += 4u)
+		{
+			bHasAlpha = aMips[0].aPixels[i] != 0xFFu;
+		}
+
+		result.Format = bIsNormalMap ? eBlockFormat::BC5
+			: bUseBc7 ? eBlockFormat::BC7
+			: bHasAlpha ? eBlockFormat::BC3
+			: eBlockFormat::BC1;
+
+		result.Result = MipGenerator::GenerateMipChain(aMips, !bIsNormalMap, eMipFilter::KAISER);
+		if (FAILED(result.Result))
+		{
+			return result;
+		}
+		result.uNumMips = static_cast<UINT>(aMips.size());
+
+		std::vector<std::vector<BYTE>> aBlocks(aMips.size());
+		for (SIZE_T uMip = 0u; uMip < aMips.size(); ++uMip)
+		{
+			result.uUncompressedBytes += aMips[uMip].aPixels.size();
+
+			result.Result = BlockCompressor::CompressImage(aMips[uMip], result.Format, aBlocks[uMip]);
+			if (FAILED(result.Result))
+			{
+				return result;
+			}
+		}
+
+		ImageData decoded;
+		result.Result = BlockCompressor::DecompressImage(aBlocks[0].data(), aBlocks[0].size(), result.uWidth, result.uHeight, result.Format, decoded);
+		if (FAILED(result.Result))
+		{
+			return result;
+		}
+		result.Psnr = BlockCompressor::ComputePsnr(aMips[0], decoded, result.Format);
+
+		std::filesystem::path cookedPath = sourcePath;
+		cookedPath += L".dds";
+		result.Result = writeDds(cookedPath, result.Format, aMips, aBlocks, result.uCookedBytes);
+
+		return result;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCooker::GetCookedPath
+
+	  Summary:  Returns "<file>.dds" when it exists and is not older
+				than the texture
+
+	  Args:     const std::filesystem::path& sourcePath
+				  Path to the texture
+
+	  Returns:  std::filesystem::path
+				  Cooked file, empty when there is none to use
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	std::filesystem::path TextureCooker::GetCookedPath(_In_ const std::filesystem::path& sourcePath)
+	{
+		std::filesystem::path cookedPath = sourcePath;
+		cookedPath += L".dds";
+
+		std::error_code errorCode;
+		auto cookedTime = std::filesystem::last_write_time(cookedPath, errorCode);
+		if (errorCode)
+		{
+			return std::filesystem::path();
+		}
+
+		auto sourceTime = std::filesystem::last_write_time(sourcePath, errorCode);
+		if (!errorCode && cookedTime < sourceTime)
+		{
+			return std::filesystem::path();
+		}
+
+		return cookedPath;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCooker::IsNormalMap
+
+	  Summary:  Returns whether the file name follows one of the normal
+				map conventions of the content: "normal", "_ddn",
+				"_nrm" or a "_n" suffix
+
+	  Args:     const std::filesystem::path& sourcePath
+				  Path to the texture
+
+	  Returns:  BOOL
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL TextureCooker::IsNormalMap(_In_ const std::filesystem::path& sourcePath)
+	{
+		std::wstring szStem = sourcePath.stem().wstring();
+		std::transform(szStem.begin(), szStem.end(), szStem.begin(), [](WCHAR c) { return static_cast<WCHAR>(towlower(c)); });
+
+		return szStem.find(L"normal") != std::wstring::npos
+			|| szStem.find(L"_ddn") != std::wstring::npos
+			|| szStem.find(L"_nrm") != std::wstring::npos
+			|| (szStem.size() > 2u && szStem.compare(szStem.size() - 2u, 2u, L"_n") == 0);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCooker::ReportResult
+
+	  Summary:  Logs the format, sizes and PSNR of a cooked texture
+
+	  Args:     const CookResult& result
+				  Outcome of CookFile
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void TextureCooker::ReportResult(_In_ const CookResult& result)
+	{
+		WCHAR szMessage[512];
+		if (FAILED(result.Result))
+		{
+			swprintf_s(szMessage, L"TextureCooker: %s failed (0x%08X)\n", result.SourcePath.c_str(), static_cast<UINT>(result.Result));
+		}
+		else
+		{
+			swprintf_s(
+				szMessage,
+				L"TextureCooker: %s %s %ux%u, %u mip(s), %.2f MB file, %.2f MB uncompressed, %.2f MB cooked, PSNR %.2f dB\n",
+				result.SourcePath.c_str(),
+				FORMAT_NAMES[static_cast<size_t>(result.Format)],
+				result.uWidth,
+				result.uHeight,
+				result.uNumMips,
+				static_cast<FLOAT>(result.uSourceBytes) / (1024.0f * 1024.0f),
+				static_cast<FLOAT>(result.uUncompressedBytes) / (1024.0f * 1024.0f),
+				static_cast<FLOAT>(result.uCookedBytes) / (1024.0f * 1024.0f),
+				result.Psnr
+			);
+		}
+		OutputDebugString(szMessage);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureCooker::writeDds
+
+	  Summary:  Writes the blocks of every mip to a DDS file with a DX10
+				header, as read by CreateDDSTextureFromFile
+
+	  Args:     const std::filesystem::path& filePath
+				  Path of the DDS file
+				eBlockFormat format
+				  Format of the blocks
+				const std::vector<ImageData>& aMips
+				  Mip chain, for the sizes
+				const std::vector<std::vector<BYTE>>& aBlocks
+				  Blocks of every mip
+				UINT64& uOutNumBytes
+				  Size of the written file
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT TextureCooker::writeDds(
+		_In_ const std::filesystem::path& filePath,
+		_In_ eBlockFormat format,
+		_In_ const std::vector<ImageData>& aMips,
+		_In_ const std::vector<std::vector<BYTE>>& aBlocks,
+		_Out_ UINT64& uOutNumBytes
+	)
+	{
+		uOutNumBytes = 0ull;
+
+		DirectX::DDS_HEADER header = {};
+		header.size = sizeof(DirectX::DDS_HEADER);
+		header.flags = DDS_HEADER_FLAGS_TEXTURE | DDS_HEADER_FLAGS_MIPMAP | DDS_HEADER_FLAGS_LINEARSIZE;
+		header.height = aMips[0].uHeight;
+		header.width = aMips[0].uWidth;
+		header.pitchOrLinearSize = static_cast<UINT32>(aBlocks[0].size());
+		header.mipMapCount = static_cast<UINT32>(aMips.size());
+		header.ddspf.size = sizeof(DirectX::DDS_PIXELFORMAT);
+		header.ddspf.flags = DDS_FOURCC;
+		header.ddspf.fourCC = MAKEFOURCC('D', 'X', '1', '0');
+		header.caps = DDS_SURFACE_FLAGS_TEXTURE | DDS_SURFACE_FLAGS_MIPMAP;
+
+		DirectX::DDS_HEADER_DXT10 headerDx10 =
+		{
+			.dxgiFormat = BlockCompressor::GetDxgiFormat(format),
+			.resourceDimension = DDS_DIMENSION_TEXTURE2D,
+			.miscFlag = 0u,
+			.arraySize = 1u,
+			.miscFlags2 = 0u
+		};
+
+		std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			return E_FAIL;
+		}
+
+		file.write(reinterpret_cast<const CHAR*>(&DirectX::DDS_MAGIC), sizeof(DirectX::DDS_MAGIC));
+		file.write(reinterpret_cast<const CHAR*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const CHAR*>(&headerDx10), sizeof(headerDx10));
+		uOutNumBytes = sizeof(DirectX::DDS_MAGIC) + sizeof(header) + sizeof(headerDx10);
+
+		for (const std::vector<BYTE>& aMipBlocks : aBlocks)
+		{
+			file.write(reinterpret_cast<const CHAR*>(aMipBlocks.data()), static_cast<std::streamsize>(aMipBlocks.size()));
+			uOutNumBytes += aMipBlocks.size();
+		}
+
+		return file ? S_OK : E_FAIL;
+	}
+}
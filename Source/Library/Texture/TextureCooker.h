@@ -0,0 +1,87 @@
+/*+===================================================================
+  File:      TEXTURECOOKER.H
+
+  Summary:   TextureCooker header file contains declarations of
+			 TextureCooker class that converts PNG and JPEG textures
+			 to block compressed DDS files with mip chains.
+
+  Classes: TextureCooker
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/BlockCompressor.h"
+
+namespace library
+{
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   CookResult
+
+		Summary:  Outcome of cooking one texture
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct CookResult
+	{
+		std::filesystem::path SourcePath;
+		eBlockFormat Format;
+		UINT uWidth;
+		UINT uHeight;
+		UINT uNumMips;
+		UINT64 uSourceBytes;
+		UINT64 uUncompressedBytes;
+		UINT64 uCookedBytes;
+		FLOAT Psnr;
+		HRESULT Result;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    TextureCooker
+
+	  Summary:  Cooks each texture to "<file>.dds" next to it, so the
+				original file name in the model keeps working:
+				Texture loads the cooked file whenever it is at least as
+				new as the source. Normal maps, recognized by name,
+				become BC5; textures with transparent texels BC3 or
+				BC7; the rest BC1 or BC7. Files are cooked one per job
+				and each file compresses its blocks on the job system.
+
+	  Methods:  CookDirectory
+				  Cooks every PNG and JPEG under a directory
+				CookFile
+				  Cooks one texture
+				GetCookedPath
+				  Returns the cooked file of a texture if it is up to
+				  date
+				IsNormalMap
+				  Returns whether the file name marks a normal map
+				ReportResult
+				  Logs the size and quality of a cooked texture
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class TextureCooker final
+	{
+	public:
+		TextureCooker() = delete;
+		TextureCooker(const TextureCooker& other) = delete;
+		TextureCooker(TextureCooker&& other) = delete;
+		TextureCooker& operator=(const TextureCooker& other) = delete;
+		TextureCooker& operator=(TextureCooker&& other) = delete;
+		~TextureCooker() = delete;
+
+		static std::vector<CookResult> CookDirectory(_In_ const std::filesystem::path& directory, _In_ BOOL bUseBc7);
+		static CookResult CookFile(_In_ const std::filesystem::path& sourcePath, _In_ BOOL bUseBc7);
+		static std::filesystem::path GetCookedPath(_In_ const std::filesystem::path& sourcePath);
+		static BOOL IsNormalMap(_In_ const std::filesystem::path& sourcePath);
+		static void ReportResult(_In_ const CookResult& result);
+
+	private:
+		static HRESULT writeDds(
+			_In_ const std::filesystem::path& filePath,
+			_In_ eBlockFormat format,
+			_In_ const std::vector<ImageData>& aMips,
+			_In_ const std::vector<std::vector<BYTE>>& aBlocks,
+			_Out_ UINT64& uOutNumBytes
+		);
+	};
+}
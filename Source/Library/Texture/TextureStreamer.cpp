@@ -0,0 +1,631 @@
+#include "Texture/TextureStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace library
+{
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::GetInstance
+
+	  Summary:  Returns the process-wide texture streamer
+
+	  Returns:  TextureStreamer&
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	TextureStreamer& TextureStreamer::GetInstance()
+	{
+		static TextureStreamer s_instance;
+		return s_instance;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::TextureStreamer
+
+	  Summary:  Constructor. Creates the job system first, so it is
+				destroyed after the streamer has waited for its loads.
+
+	  Modifies: [m_bIsEnabled, m_uUploadBudget, m_uNumBytesUploaded,
+				 m_entries, m_completionMutex, m_aCompletions,
+				 m_loadCounter].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	TextureStreamer::TextureStreamer()
+		: m_bIsEnabled(FALSE)
+		, m_uUploadBudget(DEFAULT_UPLOAD_BUDGET)
+		, m_uNumBytesUploaded(0u)
+		, m_entries()
+		, m_completionMutex()
+		, m_aCompletions()
+		, m_loadCounter()
+	{
+		JobSystem::GetInstance();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::~TextureStreamer
+
+	  Summary:  Destructor. Waits for the loads still running, they
+				report back to this object.
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	TextureStreamer::~TextureStreamer()
+	{
+		JobSystem::GetInstance().Wait(m_loadCounter);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::SetEnabled
+
+	  Summary:  Turns texture streaming on or off for the materials
+				initialized afterwards
+
+	  Args:     BOOL bIsEnabled
+				  Whether materials stream their textures
+
+	  Modifies: [m_bIsEnabled].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void TextureStreamer::SetEnabled(_In_ BOOL bIsEnabled)
+	{
+		m_bIsEnabled = bIsEnabled;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::IsEnabled
+
+	  Summary:  Returns whether materials stream their textures
+
+	  Returns:  BOOL
+				  TRUE if streaming is on
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL TextureStreamer::IsEnabled() const
+	{
+		return m_bIsEnabled;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::SetUploadBudget
+
+	  Summary:  Sets the bytes uploaded per frame. The budget is at
+				least MIN_UPLOAD_BUDGET, one row of the widest texture
+				Direct3D 11 allows.
+
+	  Args:     SIZE_T uNumBytes
+				  Bytes uploaded per frame
+
+	  Modifies: [m_uUploadBudget].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void TextureStreamer::SetUploadBudget(_In_ SIZE_T uNumBytes)
+	{
+		m_uUploadBudget = std::max<SIZE_T>(uNumBytes, MIN_UPLOAD_BUDGET);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::GetUploadBudget
+
+	  Summary:  Returns the bytes uploaded per frame
+
+	  Returns:  SIZE_T
+				  Upload budget in bytes
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T TextureStreamer::GetUploadBudget() const
+	{
+		return m_uUploadBudget;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::Register
+
+	  Summary:  Starts streaming a texture. Its mip chain is described
+				on a background job and nothing is resident until the
+				mip tail has been uploaded. Registering a texture again
+				does nothing.
+
+	  Args:     const std::shared_ptr<StreamableTexture>& texture
+				  Texture to stream, kept alive while it streams
+
+	  Modifies: [m_entries, m_loadCounter].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void TextureStreamer::Register(_In_ const std::shared_ptr<StreamableTexture>& texture)
+	{
+		if (!texture || m_entries.contains(texture.get()))
+		{
+			return;
+		}
+
+		m_entries.emplace(
+			texture.get(),
+			Entry
+			{
+				.Texture = texture,
+				.aMips = {},
+				.aMipData = {},
+				.Result = S_OK,
+				.uTailMip = 0u,
+				.uResidentMip = 0u,
+				.uNumRowsUploaded = 0u,
+				.uWantedMip = 0u,
+				.ScreenSize = 0.0f,
+				.Priority = 0.0f,
+				.bIsPrepared = FALSE,
+				.bIsLoading = TRUE
+			}
+		);
+
+		StreamableTexture* pTexture = texture.get();
+		JobSystem::GetInstance().SubmitBackground(
+			[this, pTexture]()
+			{
+				Completion completion =
+				{
+					.pTexture = pTexture,
+					.aMips = {},
+					.aMipData = {},
+					.uFirstMip = 0u,
+					.Result = S_OK
+				};
+				completion.Result = pTexture->PrepareStreaming(completion.aMips);
+
+				std::lock_guard<std::mutex> lock(m_completionMutex);
+				m_aCompletions.push_back(std::move(completion));
+			},
+			m_loadCounter
+		);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::RequestScreenSize
+
+	  Summary:  Reports how many pixels across a texture covers this
+				frame. The largest request of the frame decides which
+				mip the texture wants and how soon it gets it.
+				Textures nobody reports keep the mip they wanted last
+				and stream when nothing else needs the budget.
+
+	  Args:     const StreamableTexture* pTexture
+				  Texture drawn this frame, unregistered ones are
+				  ignored
+				FLOAT screenSize
+				  Pixels covered along the larger side
+
+	  Modifies: [m_entries].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void TextureStreamer::RequestScreenSize(_In_ const StreamableTexture* pTexture, _In_ FLOAT screenSize)
+	{
+		auto it = m_entries.find(pTexture);
+		if (it != m_entries.end())
+		{
+			it->second.ScreenSize = std::max<FLOAT>(it->second.ScreenSize, screenSize);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::Update
+
+	  Summary:  Called once per frame on the render thread, after the
+				screen sizes have been reported. Applies the loads that
+				finished, turns screen sizes into wanted mips, starts
+				the loads they need and uploads within the budget.
+				Textures only the streamer still references are
+				forgotten.
+
+	  Modifies: [m_entries, m_aCompletions, m_uNumBytesUploaded].
+
+	  Returns:  SIZE_T
+				  Bytes uploaded this frame
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T TextureStreamer::Update()
+	{
+		applyCompletions();
+
+		for (auto it = m_entries.begin(); it != m_entries.end();)
+		{
+			Entry& entry = it->second;
+			if (entry.Texture.use_count() == 1 && !entry.bIsLoading)
+			{
+				it = m_entries.erase(it);
+				continue;
+			}
+
+			if (entry.bIsPrepared && entry.ScreenSize > 0.0f)
+			{
+				entry.uWantedMip = computeWantedMip(entry, entry.ScreenSize);
+			}
+			entry.Priority = entry.ScreenSize;
+			entry.ScreenSize = 0.0f;
+
+			++it;
+		}
+
+		startLoads();
+
+		m_uNumBytesUploaded = uploadWithinBudget();
+
+		return m_uNumBytesUploaded;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::GetNumBytesUploaded
+
+	  Summary:  Returns the bytes uploaded by the last update
+
+	  Returns:  SIZE_T
+				  Bytes uploaded, never more than the budget
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T TextureStreamer::GetNumBytesUploaded() const
+	{
+		return m_uNumBytesUploaded;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::GetNumStreaming
+
+	  Summary:  Returns the textures still being described or short of
+				their wanted mip. Failed textures are not counted.
+
+	  Returns:  UINT
+				  Number of textures
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT TextureStreamer::GetNumStreaming() const
+	{
+		UINT uNumStreaming = 0u;
+		for (const auto& [pTexture, entry] : m_entries)
+		{
+			if (SUCCEEDED(entry.Result) && (!entry.bIsPrepared || isStreaming(entry)))
+			{
+				++uNumStreaming;
+			}
+		}
+
+		return uNumStreaming;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::GetResidentMip
+
+	  Summary:  Returns the most detailed mip of a texture whose data,
+				and that of every smaller mip, has been uploaded
+
+	  Args:     const StreamableTexture* pTexture
+				  Registered texture
+
+	  Returns:  UINT
+				  Mip index, the number of mips while nothing is
+				  resident, UINT_MAX for textures not described yet
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT TextureStreamer::GetResidentMip(_In_ const StreamableTexture* pTexture) const
+	{
+		auto it = m_entries.find(pTexture);
+		if (it == m_entries.end() || !it->second.bIsPrepared)
+		{
+			return UINT_MAX;
+		}
+
+		return it->second.uResidentMip;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::GetNumPendingLoads
+
+	  Summary:  Returns the load jobs that have not finished yet. The
+				streamer has settled when this and GetNumStreaming
+				are both zero.
+
+	  Returns:  UINT
+				  Number of running or queued load jobs
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT TextureStreamer::GetNumPendingLoads() const
+	{
+		return m_loadCounter.uNumPending.load();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::applyCompletions
+
+	  Summary:  Takes the results of the finished jobs. A described
+				texture gets its resource created, with no mip
+				resident; loaded mips wait for their upload.
+
+	  Modifies: [m_entries, m_aCompletions].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void TextureStreamer::applyCompletions()
+	{
+		std::vector<Completion> aCompletions;
+		{
+			std::lock_guard<std::mutex> lock(m_completionMutex);
+			aCompletions.swap(m_aCompletions);
+		}
+
+		for (Completion& completion : aCompletions)
+		{
+			auto it = m_entries.find(completion.pTexture);
+			if (it == m_entries.end())
+			{
+				continue;
+			}
+
+			Entry& entry = it->second;
+			entry.bIsLoading = FALSE;
+			entry.Result = completion.Result;
+
+			if (SUCCEEDED(entry.Result) && !entry.bIsPrepared)
+			{
+				for (const StreamedMipDesc& mip : completion.aMips)
+				{
+					if (mip.uNumRows == 0u || mip.uRowPitch == 0u || mip.uRowPitch > MIN_UPLOAD_BUDGET)
+					{
+						entry.Result = E_INVALIDARG;
+					}
+				}
+
+				if (completion.aMips.empty())
+				{
+					entry.Result = E_INVALIDARG;
+				}
+
+				if (SUCCEEDED(entry.Result))
+				{
+					entry.Result = entry.Texture->CreateStreamingResource(completion.aMips);
+				}
+
+				if (SUCCEEDED(entry.Result))
+				{
+					const UINT uNumMips = static_cast<UINT>(completion.aMips.size());
+
+					// The tail starts at the first mip that fits, or is the last mip of a short chain
+					entry.uTailMip = uNumMips - 1u;
+					for (UINT uMip = 0u; uMip < uNumMips; ++uMip)
+					{
+						if (std::max<UINT>(completion.aMips[uMip].uWidth, completion.aMips[uMip].uHeight) <= MIP_TAIL_SIZE)
+						{
+							entry.uTailMip = uMip;
+							break;
+						}
+					}
+
+					entry.aMips = std::move(completion.aMips);
+					entry.aMipData.resize(uNumMips);
+					entry.uResidentMip = uNumMips;
+					entry.uWantedMip = 0u;
+					entry.bIsPrepared = TRUE;
+				}
+			}
+			else if (SUCCEEDED(entry.Result))
+			{
+				for (UINT i = 0u; i < completion.aMipData.size(); ++i)
+				{
+					const StreamedMipDesc& mip = entry.aMips[completion.uFirstMip + i];
+					if (completion.aMipData[i].size() != static_cast<SIZE_T>(mip.uNumRows) * mip.uRowPitch)
+					{
+						entry.Result = E_FAIL;
+						break;
+					}
+					entry.aMipData[completion.uFirstMip + i] = std::move(completion.aMipData[i]);
+				}
+			}
+
+			if (FAILED(entry.Result))
+			{
+				WCHAR szMessage[256];
+				swprintf_s(szMessage, L"TextureStreamer: streaming a texture failed with 0x%08X, it keeps its resident mips\n", static_cast<UINT>(entry.Result));
+				OutputDebugString(szMessage);
+
+				entry.aMipData.clear();
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::startLoads
+
+	  Summary:  Starts one load per texture that needs data: the whole
+				mip tail at once, then each larger mip on its own. The
+				mip after the one being uploaded is loaded ahead, so
+				uploads do not wait on the disk, but no further, so a
+				texture never holds more than two mips in memory.
+
+	  Modifies: [m_entries].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void TextureStreamer::startLoads()
+	{
+		for (auto& [pTexture, entry] : m_entries)
+		{
+			if (!entry.bIsPrepared || entry.bIsLoading || FAILED(entry.Result))
+			{
+				continue;
+			}
+
+			const UINT uNumMips = static_cast<UINT>(entry.aMips.size());
+			if (entry.uResidentMip == uNumMips)
+			{
+				if (entry.aMipData[entry.uTailMip].empty())
+				{
+					loadMips(entry, entry.uTailMip, uNumMips - 1u);
+				}
+				continue;
+			}
+
+			for (UINT uMip = entry.uResidentMip; uMip > entry.uWantedMip && uMip + 2u > entry.uResidentMip; --uMip)
+			{
+				if (entry.aMipData[uMip - 1u].empty())
+				{
+					loadMips(entry, uMip - 1u, uMip - 1u);
+					break;
+				}
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::uploadWithinBudget
+
+	  Summary:  Uploads loaded mips, from the smallest up, in whole
+				rows until the budget is spent. Textures without their
+				mip tail go first, then those covering more of the
+				screen. A texture whose next rows do not fit is
+				skipped for one with smaller rows. Shaders see a mip
+				once it and every smaller mip are complete.
+
+	  Modifies: [m_entries].
+
+	  Returns:  SIZE_T
+				  Bytes uploaded
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	SIZE_T TextureStreamer::uploadWithinBudget()
+	{
+		std::vector<Entry*> aCandidates;
+		for (auto& [pTexture, entry] : m_entries)
+		{
+			if (isStreaming(entry) && !entry.aMipData[entry.uResidentMip - 1u].empty())
+			{
+				aCandidates.push_back(&entry);
+			}
+		}
+
+		std::sort(aCandidates.begin(), aCandidates.end(),
+			[](const Entry* pA, const Entry* pB)
+			{
+				BOOL bIsTailA = pA->uResidentMip > pA->uTailMip;
+				BOOL bIsTailB = pB->uResidentMip > pB->uTailMip;
+				if (bIsTailA != bIsTailB)
+				{
+					return bIsTailA > bIsTailB;
+				}
+				return pA->Priority > pB->Priority;
+			}
+		);
+
+		SIZE_T uNumBytesLeft = m_uUploadBudget;
+		for (Entry* pEntry : aCandidates)
+		{
+			Entry& entry = *pEntry;
+			while (isStreaming(entry))
+			{
+				const UINT uMip = entry.uResidentMip - 1u;
+				std::vector<BYTE>& aData = entry.aMipData[uMip];
+				if (aData.empty())
+				{
+					break;
+				}
+
+				const StreamedMipDesc& mip = entry.aMips[uMip];
+				UINT uNumRows = static_cast<UINT>(std::min<SIZE_T>(mip.uNumRows - entry.uNumRowsUploaded, uNumBytesLeft / mip.uRowPitch));
+				if (uNumRows == 0u)
+				{
+					break;
+				}
+
+				entry.Result = entry.Texture->UploadRows(uMip, entry.uNumRowsUploaded, uNumRows, aData.data() + static_cast<SIZE_T>(entry.uNumRowsUploaded) * mip.uRowPitch);
+				if (FAILED(entry.Result))
+				{
+					break;
+				}
+
+				uNumBytesLeft -= static_cast<SIZE_T>(uNumRows) * mip.uRowPitch;
+				entry.uNumRowsUploaded += uNumRows;
+				if (entry.uNumRowsUploaded < mip.uNumRows)
+				{
+					break;
+				}
+
+				aData = std::vector<BYTE>();
+				entry.uResidentMip = uMip;
+				entry.uNumRowsUploaded = 0u;
+
+				if (uMip <= entry.uTailMip)
+				{
+					entry.Result = entry.Texture->SetMostDetailedMip(uMip);
+					if (FAILED(entry.Result))
+					{
+						break;
+					}
+				}
+			}
+		}
+
+		return m_uUploadBudget - uNumBytesLeft;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::loadMips
+
+	  Summary:  Reads mips [uFirstMip, uLastMip] of a texture on a
+				background job
+
+	  Args:     Entry& entry
+				  Texture to load
+				UINT uFirstMip
+				  Most detailed mip to read
+				UINT uLastMip
+				  Least detailed mip to read
+
+	  Modifies: [m_loadCounter].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void TextureStreamer::loadMips(_Inout_ Entry& entry, _In_ UINT uFirstMip, _In_ UINT uLastMip)
+	{
+		entry.bIsLoading = TRUE;
+
+		StreamableTexture* pTexture = entry.Texture.get();
+		JobSystem::GetInstance().SubmitBackground(
+			[this, pTexture, uFirstMip, uLastMip]()
+			{
+				Completion completion =
+				{
+					.pTexture = pTexture,
+					.aMips = {},
+					.aMipData = std::vector<std::vector<BYTE>>(uLastMip - uFirstMip + 1u),
+					.uFirstMip = uFirstMip,
+					.Result = S_OK
+				};
+				for (UINT uMip = uFirstMip; uMip <= uLastMip && SUCCEEDED(completion.Result); ++uMip)
+				{
+					completion.Result = pTexture->LoadMip(uMip, completion.aMipData[uMip - uFirstMip]);
+				}
+
+				std::lock_guard<std::mutex> lock(m_completionMutex);
+				m_aCompletions.push_back(std::move(completion));
+			},
+			m_loadCounter
+		);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::computeWantedMip
+
+	  Summary:  Picks the largest mip that still has at least one
+				texel per covered pixel, never smaller than the tail
+
+	  Args:     const Entry& entry
+				  Described texture
+				FLOAT screenSize
+				  Pixels covered along the larger side
+
+	  Returns:  UINT
+				  Wanted mip
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT TextureStreamer::computeWantedMip(_In_ const Entry& entry, _In_ FLOAT screenSize)
+	{
+		FLOAT size = static_cast<FLOAT>(std::max<UINT>(entry.aMips[0].uWidth, entry.aMips[0].uHeight));
+		if (screenSize >= size)
+		{
+			return 0u;
+		}
+
+		UINT uMip = static_cast<UINT>(std::floor(std::log2(size / screenSize)));
+		return std::min<UINT>(uMip, entry.uTailMip);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TextureStreamer::isStreaming
+
+	  Summary:  Returns whether a texture still has mips to upload
+
+	  Args:     const Entry& entry
+				  Registered texture
+
+	  Returns:  BOOL
+				  TRUE if described, not failed and short of its mip
+				  tail or wanted mip
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL TextureStreamer::isStreaming(_In_ const Entry& entry)
+	{
+		return entry.bIsPrepared && SUCCEEDED(entry.Result) && entry.uResidentMip > std::min<UINT>(entry.uWantedMip, entry.uTailMip);
+	}
+}
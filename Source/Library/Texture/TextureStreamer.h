@@ -0,0 +1,187 @@
+/*+===================================================================
+  File:      TEXTURESTREAMER.H
+
+  Summary:   TextureStreamer header file contains declarations of
+			 StreamableTexture interface and TextureStreamer class
+			 that makes textures resident mip by mip, from the
+			 smallest up, within a per-frame upload budget.
+
+  Classes: StreamableTexture, TextureStreamer
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <mutex>
+
+#include "Job/JobSystem.h"
+
+namespace library
+{
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   StreamedMipDesc
+
+		Summary:  Size and layout of one mip of a streamed texture.
+				  Rows are texel rows, or rows of 4x4 blocks for block
+				  compressed formats, and the data of a mip is
+				  uNumRows * uRowPitch bytes with no padding.
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct StreamedMipDesc
+	{
+		UINT uWidth;
+		UINT uHeight;
+		UINT uNumRows;
+		UINT uRowPitch;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    StreamableTexture
+
+	  Summary:  What the texture streamer needs from a texture.
+				PrepareStreaming and LoadMip run on background jobs,
+				one at a time per texture; the rest is called on the
+				render thread from TextureStreamer::Update.
+
+	  Methods:  PrepareStreaming
+				  Describes the mip chain
+				LoadMip
+				  Reads the data of one mip
+				CreateStreamingResource
+				  Creates the texture with no mip resident
+				UploadRows
+				  Copies rows of a mip to the texture
+				SetMostDetailedMip
+				  Lets shaders sample from the mip down
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class StreamableTexture
+	{
+	public:
+		virtual ~StreamableTexture() = default;
+
+		virtual HRESULT PrepareStreaming(_Out_ std::vector<StreamedMipDesc>& aOutMips) = 0;
+		virtual HRESULT LoadMip(_In_ UINT uMip, _Out_ std::vector<BYTE>& aOutData) = 0;
+
+		virtual HRESULT CreateStreamingResource(_In_ const std::vector<StreamedMipDesc>& aMips) = 0;
+		virtual HRESULT UploadRows(_In_ UINT uMip, _In_ UINT uFirstRow, _In_ UINT uNumRows, _In_ const BYTE* pRows) = 0;
+		virtual HRESULT SetMostDetailedMip(_In_ UINT uMip) = 0;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    TextureStreamer
+
+	  Summary:  Streams registered textures so the scene can render
+				before their detail is loaded. The mip tail, every mip
+				no larger than MIP_TAIL_SIZE, is loaded and uploaded
+				first, then larger mips follow one at a time while
+				the screen size asks for them. Each frame uploads at
+				most the budget, in whole rows: mip tails first, then
+				the texture covering most of the screen. All methods
+				but the background jobs run on the render thread.
+
+	  Methods:  GetInstance
+				  Returns the process-wide texture streamer
+				SetEnabled
+				  Turns texture streaming on or off
+				IsEnabled
+				  Returns whether materials stream their textures
+				SetUploadBudget
+				  Sets the bytes uploaded per frame
+				GetUploadBudget
+				  Returns the bytes uploaded per frame
+				Register
+				  Starts streaming a texture
+				RequestScreenSize
+				  Reports how many pixels a texture covers this frame
+				Update
+				  Applies finished loads, starts new ones and uploads
+				  within the budget
+				GetNumBytesUploaded
+				  Returns the bytes uploaded by the last update
+				GetNumStreaming
+				  Returns the textures short of their wanted mip
+				GetResidentMip
+				  Returns the most detailed resident mip of a texture
+				GetNumPendingLoads
+				  Returns the load jobs that have not finished yet
+				TextureStreamer
+				  Constructor.
+				~TextureStreamer
+				  Destructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class TextureStreamer final
+	{
+	public:
+		static constexpr UINT MIP_TAIL_SIZE = 64u;
+		static constexpr SIZE_T DEFAULT_UPLOAD_BUDGET = 2u * 1024u * 1024u;
+		static constexpr SIZE_T MIN_UPLOAD_BUDGET = 64u * 1024u;
+
+	public:
+		static TextureStreamer& GetInstance();
+
+		TextureStreamer();
+		TextureStreamer(const TextureStreamer& other) = delete;
+		TextureStreamer(TextureStreamer&& other) = delete;
+		TextureStreamer& operator=(const TextureStreamer& other) = delete;
+		TextureStreamer& operator=(TextureStreamer&& other) = delete;
+		~TextureStreamer();
+
+		void SetEnabled(_In_ BOOL bIsEnabled);
+		BOOL IsEnabled() const;
+		void SetUploadBudget(_In_ SIZE_T uNumBytes);
+		SIZE_T GetUploadBudget() const;
+
+		void Register(_In_ const std::shared_ptr<StreamableTexture>& texture);
+		void RequestScreenSize(_In_ const StreamableTexture* pTexture, _In_ FLOAT screenSize);
+		SIZE_T Update();
+
+		SIZE_T GetNumBytesUploaded() const;
+		UINT GetNumStreaming() const;
+		UINT GetResidentMip(_In_ const StreamableTexture* pTexture) const;
+		UINT GetNumPendingLoads() const;
+
+	private:
+		struct Entry
+		{
+			std::shared_ptr<StreamableTexture> Texture;
+			std::vector<StreamedMipDesc> aMips;
+			std::vector<std::vector<BYTE>> aMipData;
+			HRESULT Result;
+			UINT uTailMip;
+			UINT uResidentMip;
+			UINT uNumRowsUploaded;
+			UINT uWantedMip;
+			FLOAT ScreenSize;
+			FLOAT Priority;
+			BOOL bIsPrepared;
+			BOOL bIsLoading;
+		};
+
+		struct Completion
+		{
+			const StreamableTexture* pTexture;
+			std::vector<StreamedMipDesc> aMips;
+			std::vector<std::vector<BYTE>> aMipData;
+			UINT uFirstMip;
+			HRESULT Result;
+		};
+
+		void applyCompletions();
+		void startLoads();
+		SIZE_T uploadWithinBudget();
+		void loadMips(_Inout_ Entry& entry, _In_ UINT uFirstMip, _In_ UINT uLastMip);
+
+		static UINT computeWantedMip(_In_ const Entry& entry, _In_ FLOAT screenSize);
+		static BOOL isStreaming(_In_ const Entry& entry);
+
+	private:
+		BOOL m_bIsEnabled;
+		SIZE_T m_uUploadBudget;
+		SIZE_T m_uNumBytesUploaded;
+		std::unordered_map<const StreamableTexture*, Entry> m_entries;
+		std::mutex m_completionMutex;
+		std::vector<Completion> m_aCompletions;
+		JobCounter m_loadCounter;
+	};
+}
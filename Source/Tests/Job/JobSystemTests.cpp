@@ -0,0 +1,86 @@
+/*+===================================================================
+  File:      JOBSYSTEMTESTS.CPP
+
+  Summary:   Restarts the job system while jobs are still queued and
+			 checks that every one of them runs and releases its
+			 counter.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include "Job/JobSystem.h"
+
+namespace
+{
+	constexpr UINT NUM_JOBS = 256u;
+	constexpr UINT NUM_BACKGROUND_JOBS = 16u;
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: RestartWithQueuedJobs
+
+	  Summary:  Queues regular and background jobs, half of which
+				submit another job, then restarts the job system with
+				the given worker count before waiting on them
+
+	  Args:     UINT uNumWorkers
+				  Worker count of the queueing and of the restart
+				std::atomic<UINT>& uOutNumRun
+				  Incremented by every job that runs
+				JobCounter& counter
+				  Counter of all the jobs
+	-----------------------------------------------------------------F-F*/
+	void RestartWithQueuedJobs(_In_ UINT uNumWorkers, _Inout_ std::atomic<UINT>& uOutNumRun, _Inout_ library::JobCounter& counter)
+	{
+		library::JobSystem& jobSystem = library::JobSystem::GetInstance();
+		jobSystem.Initialize(uNumWorkers);
+
+		for (UINT i = 0u; i < NUM_JOBS; ++i)
+		{
+			jobSystem.Submit([&jobSystem, &uOutNumRun, &counter, i]()
+				{
+					if (i % 2u == 0u)
+					{
+						jobSystem.Submit([&uOutNumRun]() { uOutNumRun.fetch_add(1u, std::memory_order_relaxed); }, counter);
+					}
+					uOutNumRun.fetch_add(1u, std::memory_order_relaxed);
+				},
+				counter
+			);
+		}
+		for (UINT i = 0u; i < NUM_BACKGROUND_JOBS; ++i)
+		{
+			jobSystem.SubmitBackground([&uOutNumRun]() { uOutNumRun.fetch_add(1u, std::memory_order_relaxed); }, counter);
+		}
+
+		jobSystem.Initialize(uNumWorkers);
+	}
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: JobSystemRestartRunsQueuedJobs
+
+  Summary:  Jobs queued when Initialize restarts the pool, including
+			the ones they submit while being drained, all run before
+			the new workers start, with and without workers
+-----------------------------------------------------------------F-F*/
+TEST_CASE(JobSystemRestartRunsQueuedJobs)
+{
+	library::JobSystem& jobSystem = library::JobSystem::GetInstance();
+	const UINT uPrevNumWorkers = jobSystem.GetNumWorkers();
+	const UINT aNumWorkers[] = { 0u, 1u, 3u };
+
+	for (UINT uNumWorkers : aNumWorkers)
+	{
+		std::atomic<UINT> uNumRun{ 0u };
+		library::JobCounter counter;
+		RestartWithQueuedJobs(uNumWorkers, uNumRun, counter);
+
+		const UINT uNumExpected = NUM_JOBS + NUM_JOBS / 2u + NUM_BACKGROUND_JOBS;
+		context.Check(counter.uNumPending.load() == 0u, L"%u worker(s): %u job(s) still pending after the restart", uNumWorkers, counter.uNumPending.load());
+		context.Check(uNumRun.load() == uNumExpected, L"%u worker(s): %u job(s) ran, expected %u", uNumWorkers, uNumRun.load(), uNumExpected);
+	}
+
+	jobSystem.Initialize(uPrevNumWorkers);
+}
@@ -0,0 +1,87 @@
+/*+===================================================================
+  File:      MAIN.CPP
+
+  Summary:   This console application runs the test cases of the
+			 Library project, and its benchmarks when asked for, and
+			 fails when a check fails. The project runs it after
+			 every build.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <cstring>
+#include <filesystem>
+
+#include "Job/JobSystem.h"
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: main
+
+  Summary:  Entry point to the tests. Runs every registered test, or
+			every benchmark with --bench, whose name contains one of
+			the other arguments, then prints the totals.
+
+  Args:     INT argc
+			  Number of arguments
+			CHAR* argv[]
+			  Arguments: an optional "--bench" to run the benchmarks
+			  instead of the tests, and names to filter the cases
+
+  Returns:  INT
+			  0 if every check passed, 1 otherwise.
+-----------------------------------------------------------------F-F*/
+INT main(_In_ INT argc, _In_reads_(argc) CHAR* argv[])
+{
+	tests::eTestKind kind = tests::eTestKind::TEST;
+	std::vector<std::wstring> aFilters;
+	for (INT i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--bench") == 0)
+		{
+			kind = tests::eTestKind::BENCHMARK;
+		}
+		else
+		{
+			aFilters.push_back(std::filesystem::path(argv[i]).wstring());
+		}
+	}
+
+	// Cases that use the job system run on the same workers as the engine
+	library::JobSystem::GetInstance();
+
+	UINT uNumRun = 0u;
+	UINT uNumFailed = 0u;
+	for (const tests::TestCase& testCase : tests::GetTestCases())
+	{
+		if (testCase.Kind != kind)
+		{
+			continue;
+		}
+		if (!aFilters.empty() && std::none_of(aFilters.begin(), aFilters.end(), [&testCase](const std::wstring& filter) { return wcsstr(testCase.pszName, filter.c_str()) != nullptr; }))
+		{
+			continue;
+		}
+
+		wprintf(L"%ls\n", testCase.pszName);
+
+		tests::TestContext context(testCase.pszName);
+		DOUBLE milliseconds = tests::MeasureMilliseconds(1u, [&testCase, &context]() { testCase.pfnRun(context); });
+
+		++uNumRun;
+		if (context.GetNumFailures() > 0u)
+		{
+			++uNumFailed;
+			wprintf(L"  FAILED with %u failed check(s)\n", context.GetNumFailures());
+		}
+		else
+		{
+			wprintf(L"  passed in %.1f ms\n", milliseconds);
+		}
+	}
+
+	wprintf(L"%u of %u case(s) passed\n", uNumRun - uNumFailed, uNumRun);
+
+	return uNumFailed > 0u ? 1 : 0;
+}
@@ -0,0 +1,167 @@
+/*+===================================================================
+  File:      MODELCACHETESTS.CPP
+
+  Summary:   Requests the same model file from several threads at
+			 once and checks that the cache imports it a single
+			 time, shares the result and forgets failed imports.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <filesystem>
+#include <fstream>
+#include <latch>
+#include <thread>
+
+#include "Model/Model.h"
+#include "Model/ModelCache.h"
+
+namespace
+{
+	constexpr UINT NUM_THREADS = 8u;
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: WriteQuad
+
+	  Summary:  Writes a two triangle OBJ file without materials
+
+	  Args:     const std::filesystem::path& filePath
+				  Path of the file to write
+
+	  Returns:  BOOL
+				  Whether the file was written
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	BOOL WriteQuad(_In_ const std::filesystem::path& filePath)
+	{
+		std::ofstream file(filePath);
+		file <<
+			"v -1 -1 0\n" "v 1 -1 0\n" "v 1 1 0\n" "v -1 1 0\n"
+			"vt 0 0\n" "vt 1 0\n" "vt 1 1\n" "vt 0 1\n"
+			"vn 0 0 1\n"
+			"f 1/1/1 2/2/1 3/3/1\n" "f 1/1/1 3/3/1 4/4/1\n";
+
+		return file.good();
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: ImportConcurrently
+
+	  Summary:  Releases NUM_THREADS threads at once, each requesting
+				the same file from the cache
+
+	  Args:     const std::filesystem::path& filePath
+				  Path to the model file
+				HRESULT* aOutResults
+				  Result of each thread
+				std::shared_ptr<Model>* aOutModels
+				  Model returned to each thread
+	-----------------------------------------------------------------F-F*/
+	void ImportConcurrently(_In_ const std::filesystem::path& filePath, _Out_writes_(NUM_THREADS) HRESULT* aOutResults, _Out_writes_(NUM_THREADS) std::shared_ptr<library::Model>* aOutModels)
+	{
+		std::latch start(NUM_THREADS);
+		std::vector<std::thread> aThreads;
+		for (UINT i = 0u; i < NUM_THREADS; ++i)
+		{
+			aThreads.emplace_back(
+				[&, i]()
+				{
+					start.arrive_and_wait();
+					aOutResults[i] = library::ModelCache::GetInstance().GetOrImport(filePath, aOutModels[i]);
+				}
+			);
+		}
+
+		for (std::thread& thread : aThreads)
+		{
+			thread.join();
+		}
+	}
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: ModelCacheImportsOnce
+
+  Summary:  Concurrent requests for one file wait for a single import
+			and are counted as hits that save its geometry arrays.
+			Nothing is created on the device, so no buffer bytes are
+			saved.
+-----------------------------------------------------------------F-F*/
+TEST_CASE(ModelCacheImportsOnce)
+{
+	const std::filesystem::path filePath = std::filesystem::temp_directory_path() / L"ModelCacheImportsOnce.obj";
+	if (!context.Check(WriteQuad(filePath), L"could not write %ls", filePath.c_str()))
+	{
+		return;
+	}
+
+	library::ModelCache& cache = library::ModelCache::GetInstance();
+	cache.Clear();
+	const UINT uNumLoads = cache.GetNumLoads();
+	const UINT uNumHits = cache.GetNumHits();
+
+	HRESULT aResults[NUM_THREADS] = {};
+	std::shared_ptr<library::Model> aModels[NUM_THREADS];
+	ImportConcurrently(filePath, aResults, aModels);
+
+	for (UINT i = 0u; i < NUM_THREADS; ++i)
+	{
+		context.Check(SUCCEEDED(aResults[i]), L"thread %u failed with 0x%08x", i, static_cast<UINT>(aResults[i]));
+		context.Check(aModels[i] && aModels[i] == aModels[0], L"thread %u got a different model", i);
+	}
+	context.Check(cache.GetNumLoads() - uNumLoads == 1u, L"%u import(s), expected 1", cache.GetNumLoads() - uNumLoads);
+	context.Check(cache.GetNumHits() - uNumHits == NUM_THREADS - 1u, L"%u hit(s), expected %u", cache.GetNumHits() - uNumHits, NUM_THREADS - 1u);
+
+	if (aModels[0])
+	{
+		const SIZE_T uNumCpuBytes = aModels[0]->GetNumSharedCpuBytes();
+		context.Check(uNumCpuBytes > 0u, L"the model shares no geometry arrays");
+		context.Check(cache.GetNumCpuBytesSaved() == uNumCpuBytes * (NUM_THREADS - 1u), L"%zu array byte(s) saved, expected %zu", cache.GetNumCpuBytesSaved(), uNumCpuBytes * (NUM_THREADS - 1u));
+		context.Check(cache.GetNumGpuBytesSaved() == 0u, L"%zu buffer byte(s) saved without device objects", cache.GetNumGpuBytesSaved());
+	}
+
+	cache.Clear();
+	std::error_code errorCode;
+	std::filesystem::remove(filePath, errorCode);
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: ModelCacheForgetsFailedImports
+
+  Summary:  Every concurrent request for a missing file fails with
+			the importer's result, and the file is imported again
+			once it exists
+-----------------------------------------------------------------F-F*/
+TEST_CASE(ModelCacheForgetsFailedImports)
+{
+	const std::filesystem::path filePath = std::filesystem::temp_directory_path() / L"ModelCacheForgetsFailedImports.obj";
+	std::error_code errorCode;
+	std::filesystem::remove(filePath, errorCode);
+
+	library::ModelCache& cache = library::ModelCache::GetInstance();
+	cache.Clear();
+	const UINT uNumLoads = cache.GetNumLoads();
+
+	HRESULT aResults[NUM_THREADS] = {};
+	std::shared_ptr<library::Model> aModels[NUM_THREADS];
+	ImportConcurrently(filePath, aResults, aModels);
+
+	for (UINT i = 0u; i < NUM_THREADS; ++i)
+	{
+		context.Check(FAILED(aResults[i]) && !aModels[i], L"thread %u imported a missing file", i);
+	}
+	context.Check(cache.GetNumLoads() == uNumLoads, L"a failed import was counted as a load");
+
+	if (!context.Check(WriteQuad(filePath), L"could not write %ls", filePath.c_str()))
+	{
+		return;
+	}
+
+	std::shared_ptr<library::Model> model;
+	context.Check(SUCCEEDED(cache.GetOrImport(filePath, model)) && model, L"the failed import was cached");
+	context.Check(cache.GetNumLoads() - uNumLoads == 1u, L"%u import(s) after the file was written, expected 1", cache.GetNumLoads() - uNumLoads);
+
+	cache.Clear();
+	std::filesystem::remove(filePath, errorCode);
+}
@@ -0,0 +1,465 @@
+/*+===================================================================
+  File:      SKELETONTESTS.CPP
+
+  Summary:   Compares the bone palettes of the flattened skeleton
+			 with a scalar recursive walk of the node hierarchy, the
+			 per-node palette the skeleton replaced, on synthetic
+			 animated hierarchies, and times both.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "assimp/scene.h"
+
+#include "Model/Skeleton.h"
+
+namespace
+{
+	constexpr FLOAT TOLERANCE = 1e-4f;
+	constexpr DOUBLE ANIMATION_DURATION = 100.0;
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   SkeletonScene
+
+		Summary:  Synthetic animated scene with the bone data a model
+				  would extract from its meshes
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct SkeletonScene
+	{
+		std::unique_ptr<aiScene> pScene;
+		std::unordered_map<std::string, UINT> boneNameToIndexMap;
+		std::vector<XMMATRIX> aBoneOffsets;
+		XMMATRIX globalInverseTransform;
+	};
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: ConvertMatrix
+
+	  Summary:  Converts a row vector assimp matrix to XMMATRIX
+
+	  Returns:  XMMATRIX
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	XMMATRIX ConvertMatrix(_In_ const aiMatrix4x4& matrix)
+	{
+		return XMMATRIX(
+			matrix.a1, matrix.b1, matrix.c1, matrix.d1,
+			matrix.a2, matrix.b2, matrix.c2, matrix.d2,
+			matrix.a3, matrix.b3, matrix.c3, matrix.d3,
+			matrix.a4, matrix.b4, matrix.c4, matrix.d4
+		);
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: RandomQuaternion
+
+	  Summary:  Returns a random unit quaternion
+
+	  Returns:  aiQuaternion
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	aiQuaternion RandomQuaternion(_Inout_ std::mt19937& generator)
+	{
+		std::normal_distribution<FLOAT> distribution(0.0f, 1.0f);
+		aiQuaternion quaternion(distribution(generator), distribution(generator), distribution(generator), distribution(generator));
+		return quaternion.Normalize();
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: RandomTransform
+
+	  Summary:  Returns a random scale * rotation * translation matrix
+				in assimp layout
+
+	  Returns:  aiMatrix4x4
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	aiMatrix4x4 RandomTransform(_Inout_ std::mt19937& generator)
+	{
+		std::uniform_real_distribution<FLOAT> scale(0.5f, 1.5f);
+		std::uniform_real_distribution<FLOAT> translation(-2.0f, 2.0f);
+
+		return aiMatrix4x4(
+			aiVector3D(scale(generator), scale(generator), scale(generator)),
+			RandomQuaternion(generator),
+			aiVector3D(translation(generator), translation(generator), translation(generator))
+		);
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: MakeVectorKeys
+
+	  Summary:  Allocates uNumKeys keys at increasing times spread over
+				the animation, with values in [minValue, maxValue)
+
+	  Returns:  aiVectorKey*
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	aiVectorKey* MakeVectorKeys(_Inout_ std::mt19937& generator, _In_ UINT uNumKeys, _In_ FLOAT minValue, _In_ FLOAT maxValue)
+	{
+		std::uniform_real_distribution<FLOAT> value(minValue, maxValue);
+		aiVectorKey* aKeys = new aiVectorKey[uNumKeys];
+		for (UINT i = 0u; i < uNumKeys; ++i)
+		{
+			aKeys[i].mTime = ANIMATION_DURATION * i / std::max(uNumKeys - 1u, 1u);
+			aKeys[i].mValue = aiVector3D(value(generator), value(generator), value(generator));
+		}
+
+		return aKeys;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: MakeSkeletonScene
+
+	  Summary:  Builds a random hierarchy of uNumNodes nodes where the
+				first uNumBones nodes after the root are bones and each
+				node is animated with the given probability. Channels
+				have one to six keys per component.
+
+	  Returns:  SkeletonScene
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	SkeletonScene MakeSkeletonScene(_In_ UINT uSeed, _In_ UINT uNumNodes, _In_ UINT uNumBones, _In_ FLOAT animatedProbability)
+	{
+		std::mt19937 generator(uSeed);
+		std::uniform_int_distribution<UINT> numKeys(1u, 6u);
+		std::bernoulli_distribution isAnimated(animatedProbability);
+
+		std::vector<aiNode*> apNodes(uNumNodes);
+		std::vector<std::vector<aiNode*>> aapChildren(uNumNodes);
+		for (UINT i = 0u; i < uNumNodes; ++i)
+		{
+			CHAR szName[16];
+			snprintf(szName, sizeof(szName), "Bone%03u", i);
+
+			apNodes[i] = new aiNode(szName);
+			apNodes[i]->mTransformation = RandomTransform(generator);
+			if (i > 0u)
+			{
+				UINT uParent = std::uniform_int_distribution<UINT>(0u, i - 1u)(generator);
+				apNodes[i]->mParent = apNodes[uParent];
+				aapChildren[uParent].push_back(apNodes[i]);
+			}
+		}
+
+		for (UINT i = 0u; i < uNumNodes; ++i)
+		{
+			if (!aapChildren[i].empty())
+			{
+				apNodes[i]->mNumChildren = static_cast<UINT>(aapChildren[i].size());
+				apNodes[i]->mChildren = new aiNode*[aapChildren[i].size()];
+				std::copy(aapChildren[i].begin(), aapChildren[i].end(), apNodes[i]->mChildren);
+			}
+		}
+
+		std::vector<aiNodeAnim*> apChannels;
+		for (UINT i = 0u; i < uNumNodes; ++i)
+		{
+			if (!isAnimated(generator))
+			{
+				continue;
+			}
+
+			aiNodeAnim* pNodeAnim = new aiNodeAnim();
+			pNodeAnim->mNodeName = apNodes[i]->mName;
+			pNodeAnim->mNumPositionKeys = numKeys(generator);
+			pNodeAnim->mPositionKeys = MakeVectorKeys(generator, pNodeAnim->mNumPositionKeys, -2.0f, 2.0f);
+			pNodeAnim->mNumScalingKeys = numKeys(generator);
+			pNodeAnim->mScalingKeys = MakeVectorKeys(generator, pNodeAnim->mNumScalingKeys, 0.5f, 1.5f);
+			pNodeAnim->mNumRotationKeys = numKeys(generator);
+			pNodeAnim->mRotationKeys = new aiQuatKey[pNodeAnim->mNumRotationKeys];
+			for (UINT k = 0u; k < pNodeAnim->mNumRotationKeys; ++k)
+			{
+				pNodeAnim->mRotationKeys[k].mTime = ANIMATION_DURATION * k / std::max(pNodeAnim->mNumRotationKeys - 1u, 1u);
+				pNodeAnim->mRotationKeys[k].mValue = RandomQuaternion(generator);
+			}
+			apChannels.push_back(pNodeAnim);
+		}
+
+		SkeletonScene scene;
+		scene.pScene = std::make_unique<aiScene>();
+		scene.pScene->mRootNode = apNodes[0];
+
+		aiAnimation* pAnimation = new aiAnimation();
+		pAnimation->mDuration = ANIMATION_DURATION;
+		pAnimation->mNumChannels = static_cast<UINT>(apChannels.size());
+		pAnimation->mChannels = new aiNodeAnim*[apChannels.size()];
+		std::copy(apChannels.begin(), apChannels.end(), pAnimation->mChannels);
+		scene.pScene->mNumAnimations = 1u;
+		scene.pScene->mAnimations = new aiAnimation*[1] { pAnimation };
+
+		for (UINT i = 0u; i < uNumBones; ++i)
+		{
+			scene.boneNameToIndexMap[apNodes[i + 1u]->mName.C_Str()] = i;
+			scene.aBoneOffsets.push_back(ConvertMatrix(RandomTransform(generator)));
+		}
+		scene.globalInverseTransform = XMMatrixInverse(nullptr, ConvertMatrix(apNodes[0]->mTransformation));
+
+		return scene;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: FindKey
+
+	  Summary:  Returns the key right before the given time by scanning
+				from the first key, as the per-node palette did
+
+	  Returns:  UINT
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	template <class KEY>
+	UINT FindKey(_In_ FLOAT animationTimeTicks, _In_reads_(uNumKeys) const KEY* aKeys, _In_ UINT uNumKeys)
+	{
+		for (UINT i = 0u; i < uNumKeys - 1u; ++i)
+		{
+			if (animationTimeTicks < static_cast<FLOAT>(aKeys[i + 1u].mTime))
+			{
+				return i;
+			}
+		}
+
+		return 0u;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: InterpolateVector
+
+	  Summary:  Linearly interpolates vector keys at the given time
+
+	  Returns:  aiVector3D
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	aiVector3D InterpolateVector(_In_ FLOAT animationTimeTicks, _In_reads_(uNumKeys) const aiVectorKey* aKeys, _In_ UINT uNumKeys)
+	{
+		if (uNumKeys == 1u)
+		{
+			return aKeys[0].mValue;
+		}
+
+		UINT uKey = FindKey(animationTimeTicks, aKeys, uNumKeys);
+		FLOAT t1 = static_cast<FLOAT>(aKeys[uKey].mTime);
+		FLOAT t2 = static_cast<FLOAT>(aKeys[uKey + 1u].mTime);
+		FLOAT factor = (animationTimeTicks - t1) / (t2 - t1);
+
+		return aKeys[uKey].mValue + factor * (aKeys[uKey + 1u].mValue - aKeys[uKey].mValue);
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: InterpolateRotation
+
+	  Summary:  Spherically interpolates rotation keys at the given
+				time
+
+	  Returns:  aiQuaternion
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	aiQuaternion InterpolateRotation(_In_ FLOAT animationTimeTicks, _In_reads_(uNumKeys) const aiQuatKey* aKeys, _In_ UINT uNumKeys)
+	{
+		if (uNumKeys == 1u)
+		{
+			return aKeys[0].mValue;
+		}
+
+		UINT uKey = FindKey(animationTimeTicks, aKeys, uNumKeys);
+		FLOAT t1 = static_cast<FLOAT>(aKeys[uKey].mTime);
+		FLOAT t2 = static_cast<FLOAT>(aKeys[uKey + 1u].mTime);
+		FLOAT factor = (animationTimeTicks - t1) / (t2 - t1);
+
+		aiQuaternion result;
+		aiQuaternion::Interpolate(result, aKeys[uKey].mValue, aKeys[uKey + 1u].mValue, factor);
+		return result;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: ReadNodeHierarchy
+
+	  Summary:  Computes the palette recursively with a channel search
+				per node and the global inverse applied per bone, the
+				way Model computed it before the skeleton
+
+	  Args:     const SkeletonScene& scene
+				  Scene to sample
+				FLOAT animationTimeTicks
+				  Animation time
+				const aiNode* pNode
+				  Node to visit
+				const XMMATRIX& parentTransform
+				  Global transform of the parent
+				XMMATRIX* aOutPalette
+				  Bone palette
+	-----------------------------------------------------------------F-F*/
+	void ReadNodeHierarchy(_In_ const SkeletonScene& scene, _In_ FLOAT animationTimeTicks, _In_ const aiNode* pNode, _In_ const XMMATRIX& parentTransform, _Out_ XMMATRIX* aOutPalette)
+	{
+		XMMATRIX nodeTransform = ConvertMatrix(pNode->mTransformation);
+
+		const aiAnimation* pAnimation = scene.pScene->mAnimations[0];
+		for (UINT i = 0u; i < pAnimation->mNumChannels; ++i)
+		{
+			const aiNodeAnim* pNodeAnim = pAnimation->mChannels[i];
+			if (pNodeAnim->mNodeName != pNode->mName)
+			{
+				continue;
+			}
+
+			aiVector3D scale = InterpolateVector(animationTimeTicks, pNodeAnim->mScalingKeys, pNodeAnim->mNumScalingKeys);
+			aiQuaternion rotation = InterpolateRotation(animationTimeTicks, pNodeAnim->mRotationKeys, pNodeAnim->mNumRotationKeys);
+			aiVector3D translation = InterpolateVector(animationTimeTicks, pNodeAnim->mPositionKeys, pNodeAnim->mNumPositionKeys);
+
+			nodeTransform = XMMatrixMultiply(
+				XMMatrixMultiply(XMMatrixScaling(scale.x, scale.y, scale.z), XMMatrixRotationQuaternion(XMVectorSet(rotation.x, rotation.y, rotation.z, rotation.w))),
+				XMMatrixTranslation(translation.x, translation.y, translation.z)
+			);
+			break;
+		}
+
+		const XMMATRIX globalTransform = XMMatrixMultiply(nodeTransform, parentTransform);
+
+		auto itBone = scene.boneNameToIndexMap.find(pNode->mName.C_Str());
+		if (itBone != scene.boneNameToIndexMap.end())
+		{
+			aOutPalette[itBone->second] = XMMatrixMultiply(XMMatrixMultiply(scene.aBoneOffsets[itBone->second], globalTransform), scene.globalInverseTransform);
+		}
+
+		for (UINT i = 0u; i < pNode->mNumChildren; ++i)
+		{
+			ReadNodeHierarchy(scene, animationTimeTicks, pNode->mChildren[i], globalTransform, aOutPalette);
+		}
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: MaxRelativeError
+
+	  Summary:  Returns the largest |a - b| / (1 + |b|) over every
+				element of two palettes
+
+	  Returns:  FLOAT
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	FLOAT MaxRelativeError(_In_ const std::vector<XMMATRIX>& aPalette, _In_ const std::vector<XMMATRIX>& aReference)
+	{
+		FLOAT maxError = 0.0f;
+		for (size_t i = 0u; i < aPalette.size(); ++i)
+		{
+			XMFLOAT4X4 matrix;
+			XMFLOAT4X4 reference;
+			XMStoreFloat4x4(&matrix, aPalette[i]);
+			XMStoreFloat4x4(&reference, aReference[i]);
+
+			for (UINT uRow = 0u; uRow < 4u; ++uRow)
+			{
+				for (UINT uColumn = 0u; uColumn < 4u; ++uColumn)
+				{
+					FLOAT error = std::abs(matrix.m[uRow][uColumn] - reference.m[uRow][uColumn]) / (1.0f + std::abs(reference.m[uRow][uColumn]));
+					maxError = std::max(maxError, error);
+				}
+			}
+		}
+
+		return maxError;
+	}
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: SkeletonMatchesNodeHierarchy
+
+  Summary:  Samples random hierarchies at increasing times and after
+			backward jumps, which reset the key cursors, and checks
+			every palette element against the recursive walk
+-----------------------------------------------------------------F-F*/
+TEST_CASE(SkeletonMatchesNodeHierarchy)
+{
+	struct Shape
+	{
+		UINT uNumNodes;
+		UINT uNumBones;
+		FLOAT animatedProbability;
+	};
+	const Shape aShapes[] =
+	{
+		{ 1u, 0u, 1.0f },
+		{ 5u, 3u, 0.5f },
+		{ 150u, 130u, 0.8f },
+		{ 67u, 66u, 1.0f },
+	};
+	const FLOAT aTimes[] = { 0.0f, 3.5f, 17.0f, 17.0f, 49.9f, 50.0f, 99.0f, 12.0f, 0.0f, 75.25f, 33.3f, 99.99f };
+
+	for (UINT uShape = 0u; uShape < ARRAYSIZE(aShapes); ++uShape)
+	{
+		const Shape& shape = aShapes[uShape];
+		SkeletonScene scene = MakeSkeletonScene(uShape + 1u, shape.uNumNodes, shape.uNumBones, shape.animatedProbability);
+
+		library::Skeleton skeleton;
+		if (!context.Check(SUCCEEDED(skeleton.Initialize(scene.pScene.get(), scene.boneNameToIndexMap, scene.aBoneOffsets, scene.globalInverseTransform)), L"shape %u failed to initialize", uShape))
+		{
+			continue;
+		}
+		context.Check(skeleton.GetNumNodes() == shape.uNumNodes, L"shape %u has %u node(s), expected %u", uShape, skeleton.GetNumNodes(), shape.uNumNodes);
+		context.Check(skeleton.GetNumBones() == shape.uNumBones, L"shape %u has %u bone(s), expected %u", uShape, skeleton.GetNumBones(), shape.uNumBones);
+		context.Check(skeleton.GetNumAnimatedNodes() == scene.pScene->mAnimations[0]->mNumChannels, L"shape %u has %u animated node(s), expected %u", uShape, skeleton.GetNumAnimatedNodes(), scene.pScene->mAnimations[0]->mNumChannels);
+
+		library::SkeletonPose pose;
+		skeleton.InitializePose(pose);
+
+		std::vector<XMMATRIX> aPalette(shape.uNumBones, XMMatrixIdentity());
+		std::vector<XMMATRIX> aReference(shape.uNumBones, XMMatrixIdentity());
+		for (FLOAT time : aTimes)
+		{
+			skeleton.ComputePalette(time, pose, aPalette.data());
+			ReadNodeHierarchy(scene, time, scene.pScene->mRootNode, XMMatrixIdentity(), aReference.data());
+
+			FLOAT maxError = MaxRelativeError(aPalette, aReference);
+			context.Check(maxError <= TOLERANCE, L"shape %u at %.2f ticks differs by %g", uShape, time, maxError);
+		}
+	}
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: SkeletonPalette
+
+  Summary:  Times a thousand frames of a fully animated 128 bone
+			skeleton against the recursive walk and reports the
+			microseconds per palette of both
+-----------------------------------------------------------------F-F*/
+BENCHMARK_CASE(SkeletonPalette)
+{
+	constexpr UINT NUM_BONES = 128u;
+	constexpr UINT NUM_FRAMES = 1000u;
+
+	SkeletonScene scene = MakeSkeletonScene(128u, NUM_BONES + 1u, NUM_BONES, 1.0f);
+
+	library::Skeleton skeleton;
+	if (!context.Check(SUCCEEDED(skeleton.Initialize(scene.pScene.get(), scene.boneNameToIndexMap, scene.aBoneOffsets, scene.globalInverseTransform)), L"skeleton failed to initialize"))
+	{
+		return;
+	}
+
+	library::SkeletonPose pose;
+	skeleton.InitializePose(pose);
+
+	std::vector<XMMATRIX> aPalette(NUM_BONES);
+	std::vector<XMMATRIX> aReference(NUM_BONES);
+	const FLOAT timeStep = static_cast<FLOAT>(ANIMATION_DURATION) / NUM_FRAMES;
+
+	const DOUBLE skeletonMilliseconds = tests::MeasureMilliseconds(5u, [&]()
+	{
+		for (UINT uFrame = 0u; uFrame < NUM_FRAMES; ++uFrame)
+		{
+			skeleton.ComputePalette(uFrame * timeStep, pose, aPalette.data());
+		}
+	});
+	const DOUBLE referenceMilliseconds = tests::MeasureMilliseconds(5u, [&]()
+	{
+		for (UINT uFrame = 0u; uFrame < NUM_FRAMES; ++uFrame)
+		{
+			ReadNodeHierarchy(scene, uFrame * timeStep, scene.pScene->mRootNode, XMMatrixIdentity(), aReference.data());
+		}
+	});
+
+	context.Log(
+		L"%u bone(s), %u animated node(s), skeleton %.2f us, node hierarchy %.2f us per palette, %.1fx",
+		skeleton.GetNumBones(),
+		skeleton.GetNumAnimatedNodes(),
+		skeletonMilliseconds * 1000.0 / NUM_FRAMES,
+		referenceMilliseconds * 1000.0 / NUM_FRAMES,
+		skeletonMilliseconds > 0.0 ? referenceMilliseconds / skeletonMilliseconds : 0.0
+	);
+
+	FLOAT maxError = MaxRelativeError(aPalette, aReference);
+	context.Check(maxError <= TOLERANCE, L"last palettes differ by %g", maxError);
+}
@@ -0,0 +1,303 @@
+/*+===================================================================
+  File:      SKINNINGENGINETESTS.CPP
+
+  Summary:   Skins random vertices with random palettes and compares
+			 positions, normals, tangents and bitangents with a
+			 scalar blend of the bone matrices, then reports the
+			 vertices skinned per second on one thread and on the
+			 job system.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "Job/JobSystem.h"
+#include "Model/SkinningEngine.h"
+
+namespace
+{
+	constexpr FLOAT TOLERANCE = 1e-4f;
+	constexpr UINT NUM_BONES = 64u;
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   SkinningInput
+
+		Summary:  Bind pose streams of a synthetic skinned mesh and the
+				  palette of one frame
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct SkinningInput
+	{
+		std::vector<library::SimpleVertex> aVertices;
+		std::vector<library::NormalData> aNormalData;
+		std::vector<library::AnimationData> aAnimationData;
+		std::vector<XMMATRIX> aPalette;
+	};
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: RandomUnitVector
+
+	  Summary:  Returns a random unit vector
+
+	  Returns:  XMFLOAT3
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	XMFLOAT3 RandomUnitVector(_Inout_ std::mt19937& generator)
+	{
+		std::normal_distribution<FLOAT> distribution(0.0f, 1.0f);
+		FLOAT x = distribution(generator), y = distribution(generator), z = distribution(generator);
+		FLOAT invLength = 1.0f / std::sqrt(x * x + y * y + z * z + 1e-12f);
+
+		return XMFLOAT3(x * invLength, y * invLength, z * invLength);
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: MakeSkinningInput
+
+	  Summary:  Builds uNumVertices random vertices, each weighted to
+				four random bones, and a palette of random scale *
+				rotation * translation matrices. One vertex in eight
+				has no tangent frame, like meshes imported without
+				tangents.
+
+	  Returns:  SkinningInput
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	SkinningInput MakeSkinningInput(_In_ UINT uSeed, _In_ UINT uNumVertices)
+	{
+		std::mt19937 generator(uSeed);
+		std::uniform_real_distribution<FLOAT> coordinate(-2.0f, 2.0f);
+		std::uniform_real_distribution<FLOAT> scale(0.5f, 1.5f);
+		std::uniform_real_distribution<FLOAT> angle(-3.14159265f, 3.14159265f);
+		std::uniform_real_distribution<FLOAT> weight(0.0f, 1.0f);
+		std::uniform_int_distribution<UINT> bone(0u, NUM_BONES - 1u);
+
+		SkinningInput input;
+		input.aVertices.resize(uNumVertices);
+		input.aNormalData.resize(uNumVertices);
+		input.aAnimationData.resize(uNumVertices);
+
+		for (UINT i = 0u; i < uNumVertices; ++i)
+		{
+			input.aVertices[i].Position = XMFLOAT3(coordinate(generator), coordinate(generator), coordinate(generator));
+			input.aVertices[i].TexCoord = XMFLOAT2(weight(generator), weight(generator));
+			input.aVertices[i].Normal = RandomUnitVector(generator);
+
+			if (i % 8u != 7u)
+			{
+				input.aNormalData[i].Tangent = RandomUnitVector(generator);
+				input.aNormalData[i].Bitangent = RandomUnitVector(generator);
+			}
+			else
+			{
+				input.aNormalData[i].Tangent = XMFLOAT3(0.0f, 0.0f, 0.0f);
+				input.aNormalData[i].Bitangent = XMFLOAT3(0.0f, 0.0f, 0.0f);
+			}
+
+			FLOAT aWeights[4] = { weight(generator), weight(generator), weight(generator), weight(generator) };
+			FLOAT sum = aWeights[0] + aWeights[1] + aWeights[2] + aWeights[3] + 1e-6f;
+			input.aAnimationData[i].aBoneIndices = XMUINT4(bone(generator), bone(generator), bone(generator), bone(generator));
+			input.aAnimationData[i].aBoneWeights = XMFLOAT4(aWeights[0] / sum, aWeights[1] / sum, aWeights[2] / sum, aWeights[3] / sum);
+		}
+
+		for (UINT i = 0u; i < NUM_BONES; ++i)
+		{
+			input.aPalette.push_back(
+				XMMatrixMultiply(
+					XMMatrixMultiply(
+						XMMatrixScaling(scale(generator), scale(generator), scale(generator)),
+						XMMatrixRotationRollPitchYaw(angle(generator), angle(generator), angle(generator))
+					),
+					XMMatrixTranslation(coordinate(generator), coordinate(generator), coordinate(generator))
+				)
+			);
+		}
+
+		return input;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: Transform
+
+	  Summary:  Multiplies a row vector by the upper rows of a 4x4
+				matrix, with w as the weight of the last row, and
+				normalizes the result when asked
+
+	  Returns:  XMFLOAT3
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	XMFLOAT3 Transform(_In_ const XMFLOAT3& vector, _In_ DOUBLE w, _In_ const DOUBLE (&skin)[4][4], _In_ BOOL bNormalize)
+	{
+		DOUBLE aResult[3];
+		for (UINT uColumn = 0u; uColumn < 3u; ++uColumn)
+		{
+			aResult[uColumn] = vector.x * skin[0][uColumn] + vector.y * skin[1][uColumn] + vector.z * skin[2][uColumn] + w * skin[3][uColumn];
+		}
+
+		if (bNormalize)
+		{
+			DOUBLE length = std::sqrt(aResult[0] * aResult[0] + aResult[1] * aResult[1] + aResult[2] * aResult[2]);
+			for (DOUBLE& component : aResult)
+			{
+				component = length > 0.0 ? component / length : 0.0;
+			}
+		}
+
+		return XMFLOAT3(static_cast<FLOAT>(aResult[0]), static_cast<FLOAT>(aResult[1]), static_cast<FLOAT>(aResult[2]));
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: SkinReference
+
+	  Summary:  Skins one vertex in double precision, one matrix
+				element at a time
+
+	  Args:     const SkinningInput& input
+				  Streams and palette
+				UINT i
+				  Vertex to skin
+				SimpleVertex& outVertex
+				  Skinned vertex
+				NormalData& outNormalData
+				  Skinned tangent and bitangent
+	-----------------------------------------------------------------F-F*/
+	void SkinReference(_In_ const SkinningInput& input, _In_ UINT i, _Out_ library::SimpleVertex& outVertex, _Out_ library::NormalData& outNormalData)
+	{
+		const library::AnimationData& animationData = input.aAnimationData[i];
+		const UINT aBoneIndices[4] = { animationData.aBoneIndices.x, animationData.aBoneIndices.y, animationData.aBoneIndices.z, animationData.aBoneIndices.w };
+		const FLOAT aBoneWeights[4] = { animationData.aBoneWeights.x, animationData.aBoneWeights.y, animationData.aBoneWeights.z, animationData.aBoneWeights.w };
+
+		DOUBLE skin[4][4] = {};
+		for (UINT uBone = 0u; uBone < 4u; ++uBone)
+		{
+			XMFLOAT4X4 bone;
+			XMStoreFloat4x4(&bone, input.aPalette[aBoneIndices[uBone]]);
+			for (UINT uRow = 0u; uRow < 4u; ++uRow)
+			{
+				for (UINT uColumn = 0u; uColumn < 4u; ++uColumn)
+				{
+					skin[uRow][uColumn] += static_cast<DOUBLE>(bone.m[uRow][uColumn]) * aBoneWeights[uBone];
+				}
+			}
+		}
+
+		outVertex.Position = Transform(input.aVertices[i].Position, 1.0, skin, FALSE);
+		outVertex.Normal = Transform(input.aVertices[i].Normal, 0.0, skin, TRUE);
+		outVertex.TexCoord = input.aVertices[i].TexCoord;
+		outNormalData.Tangent = Transform(input.aNormalData[i].Tangent, 0.0, skin, TRUE);
+		outNormalData.Bitangent = Transform(input.aNormalData[i].Bitangent, 0.0, skin, TRUE);
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: IsClose
+
+	  Summary:  Returns whether two float3 differ by at most the
+				tolerance relative to the reference
+
+	  Returns:  BOOL
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	BOOL IsClose(_In_ const XMFLOAT3& value, _In_ const XMFLOAT3& reference)
+	{
+		return std::abs(value.x - reference.x) <= TOLERANCE * (1.0f + std::abs(reference.x)) &&
+			std::abs(value.y - reference.y) <= TOLERANCE * (1.0f + std::abs(reference.y)) &&
+			std::abs(value.z - reference.z) <= TOLERANCE * (1.0f + std::abs(reference.z));
+	}
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: SkinningEngineMatchesReference
+
+  Summary:  Skins uneven ranges on the job system and checks every
+			position, normal, tangent, bitangent and texture
+			coordinate against the double precision blend. Vertices
+			without a tangent frame keep zero vectors.
+-----------------------------------------------------------------F-F*/
+TEST_CASE(SkinningEngineMatchesReference)
+{
+	constexpr UINT NUM_VERTICES = 5000u;
+	SkinningInput input = MakeSkinningInput(28u, NUM_VERTICES);
+
+	const std::vector<library::SkinningRange> aRanges =
+	{
+		{ .uBaseVertex = 0u, .uNumVertices = 1u },
+		{ .uBaseVertex = 1u, .uNumVertices = 0u },
+		{ .uBaseVertex = 1u, .uNumVertices = 1499u },
+		{ .uBaseVertex = 1500u, .uNumVertices = 3500u },
+	};
+
+	std::vector<library::SimpleVertex> aVertices(NUM_VERTICES);
+	std::vector<library::NormalData> aNormalData(NUM_VERTICES);
+	library::SkinningEngine::SkinRanges(aRanges, input.aVertices.data(), input.aNormalData.data(), input.aAnimationData.data(), input.aPalette.data(), aVertices.data(), aNormalData.data());
+
+	UINT uNumMismatches = 0u;
+	for (UINT i = 0u; i < NUM_VERTICES; ++i)
+	{
+		library::SimpleVertex vertex;
+		library::NormalData normalData;
+		SkinReference(input, i, vertex, normalData);
+
+		BOOL bIsClose = IsClose(aVertices[i].Position, vertex.Position) &&
+			IsClose(aVertices[i].Normal, vertex.Normal) &&
+			IsClose(aNormalData[i].Tangent, normalData.Tangent) &&
+			IsClose(aNormalData[i].Bitangent, normalData.Bitangent) &&
+			aVertices[i].TexCoord.x == vertex.TexCoord.x && aVertices[i].TexCoord.y == vertex.TexCoord.y;
+
+		if (!bIsClose && uNumMismatches++ < 4u)
+		{
+			context.Check(
+				FALSE,
+				L"vertex %u: tangent (%f, %f, %f) expected (%f, %f, %f)",
+				i,
+				aNormalData[i].Tangent.x, aNormalData[i].Tangent.y, aNormalData[i].Tangent.z,
+				normalData.Tangent.x, normalData.Tangent.y, normalData.Tangent.z
+			);
+		}
+	}
+	context.Check(uNumMismatches == 0u, L"%u of %u vertices differ from the reference", uNumMismatches, NUM_VERTICES);
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: SkinningThroughput
+
+  Summary:  Skins a quarter million vertices on the calling thread
+			and in model sized ranges on the job system, and reports
+			the vertices skinned per second of both
+-----------------------------------------------------------------F-F*/
+BENCHMARK_CASE(SkinningThroughput)
+{
+	constexpr UINT NUM_VERTICES = 262144u;
+	constexpr UINT NUM_VERTICES_PER_RANGE = 16384u;
+	SkinningInput input = MakeSkinningInput(128u, NUM_VERTICES);
+
+	std::vector<library::SkinningRange> aRanges;
+	for (UINT uBegin = 0u; uBegin < NUM_VERTICES; uBegin += NUM_VERTICES_PER_RANGE)
+	{
+		aRanges.push_back({ .uBaseVertex = uBegin, .uNumVertices = std::min(NUM_VERTICES_PER_RANGE, NUM_VERTICES - uBegin) });
+	}
+
+	std::vector<library::SimpleVertex> aVertices(NUM_VERTICES);
+	std::vector<library::NormalData> aNormalData(NUM_VERTICES);
+
+	const DOUBLE serialMilliseconds = tests::MeasureMilliseconds(5u, [&]()
+	{
+		library::SkinningEngine::SkinVertices(input.aVertices.data(), input.aNormalData.data(), input.aAnimationData.data(), NUM_VERTICES, input.aPalette.data(), aVertices.data(), aNormalData.data());
+	});
+	const DOUBLE parallelMilliseconds = tests::MeasureMilliseconds(5u, [&]()
+	{
+		library::SkinningEngine::SkinRanges(aRanges, input.aVertices.data(), input.aNormalData.data(), input.aAnimationData.data(), input.aPalette.data(), aVertices.data(), aNormalData.data());
+	});
+
+	context.Log(
+		L"%u vertices in %u range(s), 1 thread %.2f Mvertices/s, %u thread(s) %.2f Mvertices/s",
+		NUM_VERTICES,
+		static_cast<UINT>(aRanges.size()),
+		serialMilliseconds > 0.0 ? NUM_VERTICES / (serialMilliseconds * 1000.0) : 0.0,
+		library::JobSystem::GetInstance().GetNumWorkers() + 1u,
+		parallelMilliseconds > 0.0 ? NUM_VERTICES / (parallelMilliseconds * 1000.0) : 0.0
+	);
+
+	library::SimpleVertex vertex;
+	library::NormalData normalData;
+	SkinReference(input, NUM_VERTICES - 2u, vertex, normalData);
+	context.Check(IsClose(aNormalData[NUM_VERTICES - 2u].Tangent, normalData.Tangent), L"a skinned tangent differs from the reference");
+}
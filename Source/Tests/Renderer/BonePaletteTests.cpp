@@ -0,0 +1,277 @@
+/*+===================================================================
+  File:      BONEPALETTETESTS.CPP
+
+  Summary:   Skins random points from the elements of bone palettes
+			 of every format, the way the skinning shader does, and
+			 compares them with blending the bone matrices.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include "Renderer/BonePalette.h"
+
+namespace
+{
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: Dot4
+
+	  Summary:  Returns the dot product of two float4
+
+	  Returns:  FLOAT
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	FLOAT Dot4(_In_ const XMFLOAT4& a, _In_ const XMFLOAT4& b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: SkinPoint
+
+	  Summary:  Skins a point from palette elements the way
+				SkinningShaders.fxh does, one float at a time
+
+	  Args:     library::eBonePaletteFormat eFormat
+				  Format of the elements
+				const XMFLOAT4* aElements
+				  Elements of the palette
+				const UINT* aBoneIndices
+				  Four bone indices
+				const FLOAT* aBoneWeights
+				  Four bone weights
+				const XMFLOAT3& position
+				  Bind pose position
+
+	  Returns:  XMFLOAT3
+				  Skinned position
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	XMFLOAT3 SkinPoint(_In_ library::eBonePaletteFormat eFormat, _In_ const XMFLOAT4* aElements, _In_reads_(4) const UINT* aBoneIndices, _In_reads_(4) const FLOAT* aBoneWeights, _In_ const XMFLOAT3& position)
+	{
+		const UINT uNumElements = library::BonePalette::GetNumElements(eFormat);
+		FLOAT skin[4][4] = {};
+
+		if (eFormat == library::eBonePaletteFormat::DUAL_QUATERNION)
+		{
+			// Weights of quaternions on the other side of the first one are flipped
+			const XMFLOAT4& firstReal = aElements[aBoneIndices[0] * uNumElements];
+			XMFLOAT4 real = { 0.0f, 0.0f, 0.0f, 0.0f };
+			XMFLOAT4 dual = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for (UINT i = 0u; i < 4u; ++i)
+			{
+				const XMFLOAT4& boneReal = aElements[aBoneIndices[i] * uNumElements];
+				const XMFLOAT4& boneDual = aElements[aBoneIndices[i] * uNumElements + 1u];
+				const FLOAT weight = Dot4(boneReal, firstReal) < 0.0f ? -aBoneWeights[i] : aBoneWeights[i];
+
+				real = { real.x + boneReal.x * weight, real.y + boneReal.y * weight, real.z + boneReal.z * weight, real.w + boneReal.w * weight };
+				dual = { dual.x + boneDual.x * weight, dual.y + boneDual.y * weight, dual.z + boneDual.z * weight, dual.w + boneDual.w * weight };
+			}
+
+			const FLOAT invLength = 1.0f / std::sqrt(Dot4(real, real));
+			const FLOAT x = real.x * invLength, y = real.y * invLength, z = real.z * invLength, w = real.w * invLength;
+			const FLOAT dx = dual.x * invLength, dy = dual.y * invLength, dz = dual.z * invLength, dw = dual.w * invLength;
+
+			const FLOAT aRows[4][4] =
+			{
+				{ 1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + z * w), 2.0f * (x * z - y * w), 0.0f },
+				{ 2.0f * (x * y - z * w), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + x * w), 0.0f },
+				{ 2.0f * (x * z + y * w), 2.0f * (y * z - x * w), 1.0f - 2.0f * (x * x + y * y), 0.0f },
+				{
+					// Translation is twice the vector part of dual * conjugate(real)
+					2.0f * (-dw * x + w * dx + (dy * -z - dz * -y)),
+					2.0f * (-dw * y + w * dy + (dz * -x - dx * -z)),
+					2.0f * (-dw * z + w * dz + (dx * -y - dy * -x)),
+					1.0f
+				}
+			};
+			memcpy(skin, aRows, sizeof(skin));
+		}
+		else
+		{
+			for (UINT i = 0u; i < 4u; ++i)
+			{
+				const XMFLOAT4* aBone = &aElements[aBoneIndices[i] * uNumElements];
+				for (UINT uRow = 0u; uRow < 4u; ++uRow)
+				{
+					FLOAT aRow[4];
+					if (eFormat == library::eBonePaletteFormat::AFFINE_3X4)
+					{
+						aRow[0] = (&aBone[0].x)[uRow];
+						aRow[1] = (&aBone[1].x)[uRow];
+						aRow[2] = (&aBone[2].x)[uRow];
+						aRow[3] = uRow == 3u ? 1.0f : 0.0f;
+					}
+					else
+					{
+						memcpy(aRow, &aBone[uRow], sizeof(aRow));
+					}
+
+					for (UINT uColumn = 0u; uColumn < 4u; ++uColumn)
+					{
+						skin[uRow][uColumn] += aRow[uColumn] * aBoneWeights[i];
+					}
+				}
+			}
+		}
+
+		const FLOAT aPosition[4] = { position.x, position.y, position.z, 1.0f };
+		FLOAT aSkinned[3] = {};
+		for (UINT uColumn = 0u; uColumn < 3u; ++uColumn)
+		{
+			for (UINT uRow = 0u; uRow < 4u; ++uRow)
+			{
+				aSkinned[uColumn] += aPosition[uRow] * skin[uRow][uColumn];
+			}
+		}
+
+		return XMFLOAT3(aSkinned[0], aSkinned[1], aSkinned[2]);
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: GetRelativeError
+
+	  Summary:  Returns the distance between a skinned and an expected
+				point relative to the length of the expected one
+
+	  Args:     const XMFLOAT3& skinned
+				  Skinned point
+				const XMFLOAT3& expected
+				  Reference point
+
+	  Returns:  FLOAT
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	FLOAT GetRelativeError(_In_ const XMFLOAT3& skinned, _In_ const XMFLOAT3& expected)
+	{
+		const FLOAT distance = std::sqrt((skinned.x - expected.x) * (skinned.x - expected.x) + (skinned.y - expected.y) * (skinned.y - expected.y) + (skinned.z - expected.z) * (skinned.z - expected.z));
+		const FLOAT length = std::sqrt(expected.x * expected.x + expected.y * expected.y + expected.z * expected.z);
+
+		return distance / (1.0f + length);
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: BonePaletteMatchesMatrices
+
+  Summary:  Skins random points with random bones in every format and
+			compares them with blending the 4x4 matrices. Affine
+			bones must match with any weights and any scale. Dual
+			quaternions must match for rigid bones each drawing a
+			point alone, and must keep the length of a point blended
+			between two bones twisted 170 degrees apart, where linear
+			blending collapses it.
+-----------------------------------------------------------------F-F*/
+TEST_CASE(BonePaletteMatchesMatrices)
+{
+	using library::eBonePaletteFormat;
+
+	constexpr UINT NUM_BONES = 64u;
+	constexpr UINT NUM_POINTS = 2000u;
+	constexpr FLOAT TOLERANCE = 1e-4f;
+
+	std::mt19937 generator(45u);
+	std::uniform_real_distribution<FLOAT> angle(-XM_PI, XM_PI);
+	std::uniform_real_distribution<FLOAT> position(-10.0f, 10.0f);
+	std::uniform_real_distribution<FLOAT> scale(0.5f, 2.0f);
+	std::uniform_real_distribution<FLOAT> weight(0.0f, 1.0f);
+	std::uniform_int_distribution<UINT> bone(0u, NUM_BONES - 1u);
+
+	// Rigid bones first, scaled ones after them
+	std::vector<XMMATRIX> aTransforms(2u * NUM_BONES);
+	for (UINT i = 0u; i < aTransforms.size(); ++i)
+	{
+		const XMMATRIX rotation = XMMatrixRotationRollPitchYaw(angle(generator), angle(generator), angle(generator));
+		const XMMATRIX translation = XMMatrixTranslation(position(generator), position(generator), position(generator));
+		const XMMATRIX scaling = i < NUM_BONES ? XMMatrixIdentity() : XMMatrixScaling(scale(generator), scale(generator), scale(generator));
+		aTransforms[i] = XMMatrixMultiply(XMMatrixMultiply(scaling, rotation), translation);
+	}
+
+	library::BonePalette aPalettes[static_cast<size_t>(eBonePaletteFormat::COUNT)];
+	for (UINT uFormat = 0u; uFormat < static_cast<UINT>(eBonePaletteFormat::COUNT); ++uFormat)
+	{
+		const eBonePaletteFormat format = static_cast<eBonePaletteFormat>(uFormat);
+		aPalettes[uFormat].SetFormat(format);
+		context.Check(aPalettes[uFormat].Add(aTransforms.data(), NUM_BONES) == 0u, L"format %u: first model does not start at bone 0", uFormat);
+		context.Check(aPalettes[uFormat].Add(aTransforms.data() + NUM_BONES, NUM_BONES) == NUM_BONES, L"format %u: second model does not start after the first", uFormat);
+		context.Check(
+			aPalettes[uFormat].GetElements().size() == 2u * NUM_BONES * library::BonePalette::GetNumElements(format),
+			L"format %u: %zu elements", uFormat, aPalettes[uFormat].GetElements().size()
+		);
+	}
+
+	const XMFLOAT4* aMatrixElements = aPalettes[static_cast<size_t>(eBonePaletteFormat::MATRIX_4X4)].GetElements().data();
+	const XMFLOAT4* aAffineElements = aPalettes[static_cast<size_t>(eBonePaletteFormat::AFFINE_3X4)].GetElements().data();
+	const XMFLOAT4* aDualQuaternionElements = aPalettes[static_cast<size_t>(eBonePaletteFormat::DUAL_QUATERNION)].GetElements().data();
+
+	FLOAT maxMatrixError = 0.0f;
+	FLOAT maxAffineError = 0.0f;
+	FLOAT maxDualQuaternionError = 0.0f;
+	for (UINT i = 0u; i < NUM_POINTS; ++i)
+	{
+		const XMFLOAT3 point(position(generator), position(generator), position(generator));
+
+		// Blended reference, any bone of either model
+		UINT aIndices[4];
+		FLOAT aWeights[4];
+		FLOAT totalWeight = 0.0f;
+		for (UINT j = 0u; j < 4u; ++j)
+		{
+			aIndices[j] = bone(generator) + (i % 2u) * NUM_BONES;
+			aWeights[j] = weight(generator);
+			totalWeight += aWeights[j];
+		}
+
+		XMMATRIX blended(XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero());
+		for (UINT j = 0u; j < 4u; ++j)
+		{
+			aWeights[j] /= totalWeight;
+			for (UINT uRow = 0u; uRow < 4u; ++uRow)
+			{
+				blended.r[uRow] = XMVectorMultiplyAdd(aTransforms[aIndices[j]].r[uRow], XMVectorReplicate(aWeights[j]), blended.r[uRow]);
+			}
+		}
+
+		XMFLOAT3 expected;
+		XMStoreFloat3(&expected, XMVector3Transform(XMLoadFloat3(&point), blended));
+
+		maxMatrixError = std::max(maxMatrixError, GetRelativeError(SkinPoint(eBonePaletteFormat::MATRIX_4X4, aMatrixElements, aIndices, aWeights, point), expected));
+		maxAffineError = std::max(maxAffineError, GetRelativeError(SkinPoint(eBonePaletteFormat::AFFINE_3X4, aAffineElements, aIndices, aWeights, point), expected));
+
+		// Dual quaternions blend differently, a rigid bone alone must match
+		const UINT aRigidIndices[4] = { aIndices[0] % NUM_BONES, 0u, 0u, 0u };
+		const FLOAT aRigidWeights[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+		XMStoreFloat3(&expected, XMVector3Transform(XMLoadFloat3(&point), aTransforms[aRigidIndices[0]]));
+		maxDualQuaternionError = std::max(maxDualQuaternionError, GetRelativeError(SkinPoint(eBonePaletteFormat::DUAL_QUATERNION, aDualQuaternionElements, aRigidIndices, aRigidWeights, point), expected));
+	}
+
+	context.Check(maxMatrixError < TOLERANCE, L"4x4 bones differ from the matrices by %g", maxMatrixError);
+	context.Check(maxAffineError < TOLERANCE, L"3x4 bones differ from the matrices by %g", maxAffineError);
+	context.Check(maxDualQuaternionError < TOLERANCE, L"dual quaternion bones differ from the rigid matrices by %g", maxDualQuaternionError);
+
+	// Half way between no twist and 170 degrees about x, a point off the axis
+	const XMMATRIX aTwist[2] = { XMMatrixIdentity(), XMMatrixRotationRollPitchYaw(XMConvertToRadians(170.0f), 0.0f, 0.0f) };
+	const XMFLOAT3 offAxis(0.0f, 1.0f, 0.0f);
+	const UINT aTwistIndices[4] = { 0u, 1u, 0u, 0u };
+	const FLOAT aTwistWeights[4] = { 0.5f, 0.5f, 0.0f, 0.0f };
+
+	library::BonePalette twistMatrices;
+	twistMatrices.Add(aTwist, 2u);
+	library::BonePalette twistDualQuaternions;
+	twistDualQuaternions.SetFormat(eBonePaletteFormat::DUAL_QUATERNION);
+	twistDualQuaternions.Add(aTwist, 2u);
+
+	const XMFLOAT3 linear = SkinPoint(eBonePaletteFormat::MATRIX_4X4, twistMatrices.GetElements().data(), aTwistIndices, aTwistWeights, offAxis);
+	const XMFLOAT3 dualQuaternion = SkinPoint(eBonePaletteFormat::DUAL_QUATERNION, twistDualQuaternions.GetElements().data(), aTwistIndices, aTwistWeights, offAxis);
+	const FLOAT linearLength = std::sqrt(linear.x * linear.x + linear.y * linear.y + linear.z * linear.z);
+	const FLOAT dualQuaternionLength = std::sqrt(dualQuaternion.x * dualQuaternion.x + dualQuaternion.y * dualQuaternion.y + dualQuaternion.z * dualQuaternion.z);
+	context.Check(std::abs(dualQuaternionLength - 1.0f) < TOLERANCE, L"dual quaternion blend of the twist has length %.3f", dualQuaternionLength);
+	context.Check(linearLength < 0.5f, L"linear blend of the twist has length %.3f and does not collapse", linearLength);
+
+	context.Log(
+		L"largest error 4x4 %g, 3x4 %g, dual quaternion %g, twisted length linear %.3f, dual quaternion %.3f",
+		maxMatrixError, maxAffineError, maxDualQuaternionError, linearLength, dualQuaternionLength
+	);
+}
@@ -0,0 +1,153 @@
+/*+===================================================================
+  File:      COMMANDRECORDERTESTS.CPP
+
+  Summary:   Records passes of numbered items on the job system
+			 through a command recorder over a stand-in backend and
+			 checks that the executed stream is the serial one,
+			 whichever thread finished which range first.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <thread>
+
+#include "Job/JobSystem.h"
+#include "Renderer/CommandRecorder.h"
+
+namespace
+{
+	constexpr UINT RANGE_MARKER = 0x80000000u;
+	constexpr UINT SECOND_PASS = 0x40000000u;
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    StreamBackend
+
+	  Summary:  Stands in for deferred contexts, a context and a
+				command list are streams of numbers and executing a
+				list appends it to one executed stream
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class StreamBackend final
+	{
+	public:
+		struct Context
+		{
+			std::vector<UINT> aCommands;
+			UINT uNumFinished = 0u;
+		};
+		using CommandList = std::vector<UINT>;
+
+		HRESULT CreateContext(Context&) { return S_OK; }
+		HRESULT FinishCommandList(Context& context, CommandList& outList)
+		{
+			outList = std::move(context.aCommands);
+			context.aCommands.clear();
+			++context.uNumFinished;
+			return S_OK;
+		}
+		void ExecuteCommandList(CommandList& list) { aExecuted.insert(aExecuted.end(), list.begin(), list.end()); }
+
+		std::vector<UINT> aExecuted;
+	};
+
+	using StreamRecorder = library::BasicCommandRecorder<StreamBackend>;
+
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: RecordItems
+
+	  Summary:  Returns a job that writes a range marker and the items
+				of its range, with uneven work in between so later
+				ranges often finish first
+
+	  Args:     UINT uPass
+				  Bit that tells the passes apart
+
+	  Returns:  StreamRecorder::RecordJob
+				  The job
+	-----------------------------------------------------------------F-F*/
+	StreamRecorder::RecordJob RecordItems(_In_ UINT uPass)
+	{
+		return [uPass](StreamBackend::Context& context, UINT uBegin, UINT uEnd)
+		{
+			context.aCommands.push_back(RANGE_MARKER | uPass | uBegin);
+			for (UINT i = uBegin; i < uEnd; ++i)
+			{
+				if ((i * 2654435761u) % 7u == 0u)
+				{
+					std::this_thread::yield();
+				}
+
+				context.aCommands.push_back(uPass | i);
+			}
+		};
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: CommandRecorderIsDeterministic
+
+  Summary:  Records a single range pass followed by a split one, for
+			many range counts and several times each. The executed
+			stream must be every item of the first pass then every
+			item of the second, in order, with a range marker in
+			front of each range.
+-----------------------------------------------------------------F-F*/
+TEST_CASE(CommandRecorderIsDeterministic)
+{
+	constexpr UINT NUM_FIRST_ITEMS = 37u;
+	constexpr UINT NUM_ITEMS = 1000u;
+	constexpr UINT NUM_REPEATS = 4u;
+
+	StreamBackend backend;
+	StreamRecorder recorder;
+	context.Check(recorder.Record(1u, 1u, RecordItems(0u)) == E_FAIL, L"recorded without a backend");
+	recorder.SetBackend(&backend);
+
+	const UINT aNumRanges[] = { 1u, 2u, 3u, 7u, 16u, 64u, NUM_ITEMS, 2u * NUM_ITEMS };
+	for (UINT uNumRanges : aNumRanges)
+	{
+		// Expected stream, as if every range had been recorded on one thread
+		const UINT uNumUsedRanges = std::min(uNumRanges, NUM_ITEMS);
+		std::vector<UINT> aExpected;
+		aExpected.push_back(RANGE_MARKER);
+		for (UINT i = 0u; i < NUM_FIRST_ITEMS; ++i)
+		{
+			aExpected.push_back(i);
+		}
+		for (UINT uRange = 0u; uRange < uNumUsedRanges; ++uRange)
+		{
+			UINT uBegin = 0u;
+			UINT uEnd = 0u;
+			StreamRecorder::GetRange(NUM_ITEMS, uNumUsedRanges, uRange, uBegin, uEnd);
+
+			aExpected.push_back(RANGE_MARKER | SECOND_PASS | uBegin);
+			for (UINT i = uBegin; i < uEnd; ++i)
+			{
+				aExpected.push_back(SECOND_PASS | i);
+			}
+		}
+
+		for (UINT uRepeat = 0u; uRepeat < NUM_REPEATS; ++uRepeat)
+		{
+			backend.aExecuted.clear();
+			context.Check(SUCCEEDED(recorder.Record(NUM_FIRST_ITEMS, 1u, RecordItems(0u))), L"%u ranges: first pass was not recorded", uNumRanges);
+			context.Check(SUCCEEDED(recorder.Record(NUM_ITEMS, uNumRanges, RecordItems(SECOND_PASS))), L"%u ranges: second pass was not recorded", uNumRanges);
+			context.Check(SUCCEEDED(recorder.Execute()), L"%u ranges: execute failed", uNumRanges);
+
+			context.Check(recorder.GetNumExecutedLists() == 1u + uNumUsedRanges, L"%u ranges: %u lists executed", uNumRanges, recorder.GetNumExecutedLists());
+			context.Check(backend.aExecuted == aExpected, L"%u ranges: executed stream differs from the serial stream", uNumRanges);
+		}
+	}
+
+	// Contexts are reused, the most one frame needed
+	context.Check(recorder.GetNumContexts() == 1u + NUM_ITEMS, L"%u contexts created", recorder.GetNumContexts());
+
+	// A pass without items still records its setup
+	backend.aExecuted.clear();
+	recorder.Record(0u, 8u, RecordItems(0u));
+	recorder.Execute();
+	context.Check(backend.aExecuted.size() == 1u && backend.aExecuted[0] == RANGE_MARKER, L"empty pass recorded no range");
+
+	context.Log(L"%u worker(s)", library::JobSystem::GetInstance().GetNumWorkers());
+}
@@ -0,0 +1,261 @@
+/*+===================================================================
+  File:      FRUSTUMCULLERTESTS.CPP
+
+  Summary:   Computes mesh bounds and culls hand placed and random
+			 bounds against a view frustum, checking the batched
+			 test against known answers and a corner by corner
+			 reference.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "Renderer/FrustumCuller.h"
+
+namespace
+{
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: IsOutsideReference
+
+	  Summary:  Tests world space bounds against planes one corner at
+				a time, the plain version of the batched test
+
+	  Args:     const XMFLOAT4A* aPlanes
+				  Frustum planes, normals pointing inside
+				const MeshBounds& bounds
+				  World space bounds
+
+	  Returns:  BOOL
+				  TRUE if the box or sphere is behind a plane
+	-----------------------------------------------------------------F-F*/
+	BOOL IsOutsideReference(_In_reads_(library::FrustumCuller::NUM_PLANES) const XMFLOAT4A* aPlanes, _In_ const library::MeshBounds& bounds)
+	{
+		for (UINT uPlane = 0u; uPlane < library::FrustumCuller::NUM_PLANES; ++uPlane)
+		{
+			const XMFLOAT4A& plane = aPlanes[uPlane];
+			auto distance = [&plane](FLOAT x, FLOAT y, FLOAT z) { return plane.x * x + plane.y * y + plane.z * z + plane.w; };
+
+			if (distance(bounds.Center.x, bounds.Center.y, bounds.Center.z) < -bounds.Radius)
+			{
+				return TRUE;
+			}
+
+			BOOL bIsAllBehind = TRUE;
+			for (UINT uCorner = 0u; uCorner < 8u; ++uCorner)
+			{
+				const FLOAT x = bounds.Center.x + (uCorner & 1u ? bounds.Extents.x : -bounds.Extents.x);
+				const FLOAT y = bounds.Center.y + (uCorner & 2u ? bounds.Extents.y : -bounds.Extents.y);
+				const FLOAT z = bounds.Center.z + (uCorner & 4u ? bounds.Extents.z : -bounds.Extents.z);
+				bIsAllBehind &= distance(x, y, z) < 0.0f;
+			}
+
+			if (bIsAllBehind)
+			{
+				return TRUE;
+			}
+		}
+
+		return FALSE;
+	}
+
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: MakeCuller
+
+	  Summary:  Points a culler down +Z from the origin with a 90
+				degree field of view, near 0.1 and far 100
+
+	  Args:     FrustumCuller& culler
+				  Culler to set up
+	-----------------------------------------------------------------F-F*/
+	void MakeCuller(_Inout_ library::FrustumCuller& culler)
+	{
+		const XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 1.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		const XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV2, 1.0f, 0.1f, 100.0f);
+		culler.SetViewProjection(view * projection);
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: FrustumCullerComputesBounds
+
+  Summary:  Checks the box and sphere of a cube, of an octahedron
+			whose sphere is tighter than its box, of positions
+			strided inside larger vertices and of no vertices
+-----------------------------------------------------------------F-F*/
+TEST_CASE(FrustumCullerComputesBounds)
+{
+	// A unit cube, corners at -1 and 1
+	XMFLOAT3 aCube[8] = {};
+	for (UINT i = 0u; i < 8u; ++i)
+	{
+		aCube[i] = XMFLOAT3(i & 1u ? 1.0f : -1.0f, i & 2u ? 1.0f : -1.0f, i & 4u ? 1.0f : -1.0f);
+	}
+	const WORD aIndices[] = { 0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u };
+	const library::MeshBounds cube = library::FrustumCuller::ComputeBounds(aCube, sizeof(XMFLOAT3), 8u, aIndices, 8u, 0u);
+	context.Check(
+		cube.Extents.x == 1.0f && cube.Extents.y == 1.0f && cube.Extents.z == 1.0f && std::fabs(cube.Radius - std::sqrt(3.0f)) < 1e-5f,
+		L"cube extents %g %g %g, radius %g", cube.Extents.x, cube.Extents.y, cube.Extents.z, cube.Radius
+	);
+
+	// An octahedron has the same box but a sphere of radius one
+	const XMFLOAT3 aOctahedron[6] =
+	{
+		XMFLOAT3(1.0f, 0.0f, 0.0f), XMFLOAT3(-1.0f, 0.0f, 0.0f),
+		XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT3(0.0f, -1.0f, 0.0f),
+		XMFLOAT3(0.0f, 0.0f, 1.0f), XMFLOAT3(0.0f, 0.0f, -1.0f),
+	};
+	const library::MeshBounds octahedron = library::FrustumCuller::ComputeBounds(aOctahedron, sizeof(XMFLOAT3), 6u, aIndices, 6u, 0u);
+	context.Check(std::fabs(octahedron.Radius - 1.0f) < 1e-5f, L"octahedron radius %g", octahedron.Radius);
+
+	// Positions inside vertices with other data, offset by a base vertex
+	struct Vertex
+	{
+		XMFLOAT3 Position;
+		FLOAT aOther[5];
+	};
+	Vertex aVertices[10] = {};
+	for (UINT i = 0u; i < 8u; ++i)
+	{
+		aVertices[i + 2u].Position = XMFLOAT3(aCube[i].x + 5.0f, aCube[i].y, aCube[i].z * 2.0f);
+		aVertices[i + 2u].aOther[0] = 1000.0f;
+	}
+	const library::MeshBounds strided = library::FrustumCuller::ComputeBounds(&aVertices[0].Position, sizeof(Vertex), 10u, aIndices, 8u, 2u);
+	context.Check(
+		strided.Center.x == 5.0f && strided.Extents.x == 1.0f && strided.Extents.z == 2.0f,
+		L"strided center %g, extents %g %g", strided.Center.x, strided.Extents.x, strided.Extents.z
+	);
+
+	const library::MeshBounds empty = library::FrustumCuller::ComputeBounds(aCube, sizeof(XMFLOAT3), 8u, aIndices, 0u, 0u);
+	context.Check(empty.Radius < 0.0f, L"bounds without vertices are not empty");
+
+	const library::MeshBounds outOfRange = library::FrustumCuller::ComputeBounds(aCube, sizeof(XMFLOAT3), 8u, aIndices, 8u, 8u);
+	context.Check(outOfRange.Radius < 0.0f, L"bounds of indices past the vertices are not empty");
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: FrustumCullerCullsKnownBounds
+
+  Summary:  Culls hand placed bounds with a known answer: in front,
+			behind, beside, beyond the far plane, straddling a plane,
+			scaled by their world matrix, never computed, and
+			outside only by their box
+-----------------------------------------------------------------F-F*/
+TEST_CASE(FrustumCullerCullsKnownBounds)
+{
+	library::FrustumCuller culler;
+	MakeCuller(culler);
+
+	const library::MeshBounds cube = { .Center = XMFLOAT3(0.0f, 0.0f, 0.0f), .Extents = XMFLOAT3(1.0f, 1.0f, 1.0f), .Radius = std::sqrt(3.0f) };
+	const library::MeshBounds octahedron = { .Center = XMFLOAT3(0.0f, 0.0f, 0.0f), .Extents = XMFLOAT3(1.0f, 1.0f, 1.0f), .Radius = 1.0f };
+	const library::MeshBounds empty = { .Center = XMFLOAT3(0.0f, 0.0f, 0.0f), .Extents = XMFLOAT3(0.0f, 0.0f, 0.0f), .Radius = -1.0f };
+
+	struct KnownCase
+	{
+		const library::MeshBounds* pBounds;
+		XMMATRIX World;
+		BOOL bIsVisible;
+		PCWSTR pszWhat;
+	};
+	const KnownCase aCases[] =
+	{
+		{ &cube, XMMatrixTranslation(0.0f, 0.0f, 10.0f), TRUE, L"cube in front" },
+		{ &cube, XMMatrixTranslation(0.0f, 0.0f, -10.0f), FALSE, L"cube behind" },
+		{ &cube, XMMatrixTranslation(50.0f, 0.0f, 10.0f), FALSE, L"cube to the right" },
+		{ &cube, XMMatrixTranslation(0.0f, -50.0f, 10.0f), FALSE, L"cube below" },
+		{ &cube, XMMatrixTranslation(0.0f, 0.0f, 150.0f), FALSE, L"cube beyond the far plane" },
+		{ &cube, XMMatrixTranslation(-10.5f, 0.0f, 10.0f), TRUE, L"cube straddling the left plane" },
+		{ &cube, XMMatrixScaling(3.0f, 3.0f, 3.0f) * XMMatrixTranslation(0.0f, 0.0f, -2.5f), TRUE, L"scaled cube around the eye" },
+		{ &cube, XMMatrixScaling(3.0f, 3.0f, 3.0f) * XMMatrixTranslation(0.0f, 0.0f, -5.0f), FALSE, L"scaled cube behind" },
+		{ &empty, XMMatrixTranslation(0.0f, 0.0f, -10.0f), TRUE, L"bounds never computed" },
+		// The box corner reaches past the right plane, the sphere does not
+		{ &octahedron, XMMatrixTranslation(11.7f, 0.0f, 10.0f), FALSE, L"octahedron outside its sphere" },
+	};
+
+	for (const KnownCase& knownCase : aCases)
+	{
+		culler.AddBounds(*knownCase.pBounds, knownCase.World);
+	}
+	culler.Cull();
+
+	for (UINT i = 0u; i < ARRAYSIZE(aCases); ++i)
+	{
+		context.Check(culler.IsVisible(i) == aCases[i].bIsVisible, L"%ls is %ls", aCases[i].pszWhat, aCases[i].bIsVisible ? L"culled" : L"drawn");
+	}
+	context.Check(culler.IsAnyVisible(1u, 4u) == FALSE && culler.IsAnyVisible(4u, 2u) == TRUE, L"ranges of bounds are wrong");
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: FrustumCullerCullsHiddenBounds
+
+  Summary:  Mixes hidden bounds, as added for objects a tree query
+			left out, with bounds in front of the eye, across batch
+			boundaries, and checks that only the hidden ones are
+			culled and that indices stay in order
+-----------------------------------------------------------------F-F*/
+TEST_CASE(FrustumCullerCullsHiddenBounds)
+{
+	library::FrustumCuller culler;
+	MakeCuller(culler);
+
+	const library::MeshBounds cube = { .Center = XMFLOAT3(0.0f, 0.0f, 0.0f), .Extents = XMFLOAT3(1.0f, 1.0f, 1.0f), .Radius = std::sqrt(3.0f) };
+	const XMMATRIX inFront = XMMatrixTranslation(0.0f, 0.0f, 10.0f);
+
+	context.Check(culler.AddBounds(cube, inFront) == 0u, L"first bounds not at 0");
+	context.Check(culler.AddHidden(6u) == 1u, L"hidden bounds not after the first bounds");
+	context.Check(culler.AddBounds(cube, inFront) == 7u, L"bounds after hidden ones not at 7");
+	context.Check(culler.AddHidden(0u) == 8u && culler.GetNumBounds() == 8u, L"adding no hidden bounds changed the count");
+
+	context.Check(culler.Cull() == 2u, L"%u bounds visible, 2 expected", culler.GetNumVisible());
+	context.Check(culler.IsVisible(0u) && culler.IsVisible(7u), L"bounds in front were culled");
+	context.Check(!culler.IsAnyVisible(1u, 6u), L"hidden bounds were drawn");
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: FrustumCullerMatchesReference
+
+  Summary:  Culls random bounds against a rotated frustum and checks
+			every one against the corner by corner reference. 1021
+			bounds, so the last batch is partial.
+-----------------------------------------------------------------F-F*/
+TEST_CASE(FrustumCullerMatchesReference)
+{
+	std::mt19937 generator(38u);
+	std::uniform_real_distribution<FLOAT> position(-120.0f, 120.0f);
+	std::uniform_real_distribution<FLOAT> size(0.0f, 20.0f);
+
+	const XMMATRIX rotatedView = XMMatrixRotationRollPitchYaw(0.3f, 1.1f, -0.2f) * XMMatrixTranslation(4.0f, -2.0f, 7.0f);
+	const XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV2, 1.0f, 0.1f, 100.0f);
+
+	library::FrustumCuller culler;
+	culler.SetViewProjection(XMMatrixInverse(nullptr, rotatedView) * projection);
+
+	std::vector<library::MeshBounds> aBounds(1021u);
+	for (library::MeshBounds& bounds : aBounds)
+	{
+		bounds.Center = XMFLOAT3(position(generator), position(generator), position(generator));
+		bounds.Extents = XMFLOAT3(size(generator), size(generator), size(generator));
+		bounds.Radius = size(generator) * 1.5f;
+		culler.AddBounds(bounds, XMMatrixIdentity());
+	}
+
+	const UINT uNumVisible = culler.Cull();
+	UINT uNumMismatches = 0u;
+	UINT uNumExpectedVisible = 0u;
+	for (UINT i = 0u; i < aBounds.size(); ++i)
+	{
+		const BOOL bIsVisible = !IsOutsideReference(culler.GetPlanes(), aBounds[i]);
+		uNumExpectedVisible += bIsVisible ? 1u : 0u;
+		uNumMismatches += culler.IsVisible(i) == bIsVisible ? 0u : 1u;
+	}
+
+	context.Check(uNumMismatches == 0u, L"%u random bounds differ from the reference", uNumMismatches);
+	context.Check(
+		uNumVisible == uNumExpectedVisible && 0u < uNumVisible && uNumVisible < aBounds.size(),
+		L"%u visible, %u expected", uNumVisible, uNumExpectedVisible
+	);
+	context.Log(L"%u of %u random bounds visible", uNumVisible, static_cast<UINT>(aBounds.size()));
+}
@@ -0,0 +1,447 @@
+/*+===================================================================
+  File:      HORIZONCULLERTESTS.CPP
+
+  Summary:   Culls bounds with a known answer behind a wall of
+			 columns, and random bounds on hilly columns seen from
+			 random cameras, against a brute force line of sight
+			 test from the eye.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "Renderer/HorizonCuller.h"
+
+namespace
+{
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: MakeBounds
+
+	  Summary:  Returns the bounds of a box around a center
+
+	  Args:     FLOAT x, FLOAT y, FLOAT z
+				  Center
+				FLOAT extentX, FLOAT extentY, FLOAT extentZ
+				  Half of the size along each axis
+
+	  Returns:  library::MeshBounds
+	-----------------------------------------------------------------F-F*/
+	library::MeshBounds MakeBounds(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z, _In_ FLOAT extentX, _In_ FLOAT extentY, _In_ FLOAT extentZ)
+	{
+		return library::MeshBounds
+		{
+			.Center = XMFLOAT3(x, y, z),
+			.Extents = XMFLOAT3(extentX, extentY, extentZ),
+			.Radius = std::sqrt(extentX * extentX + extentY * extentY + extentZ * extentZ)
+		};
+	}
+
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: IsPointInSight
+
+	  Summary:  Walks the columns a segment from the eye crosses and
+				tests whether it passes through any of them. Columns
+				under the footprint of the bounds the point belongs to
+				are skipped, as they never hide the bounds.
+
+	  Args:     const HeightField& field
+				  Columns
+				const XMFLOAT3& eye
+				  Eye position
+				const XMFLOAT3& point
+				  Point the eye looks at
+				const MeshBounds& bounds
+				  Bounds the point is on
+
+	  Returns:  BOOL
+				  TRUE if no column blocks the segment
+	-----------------------------------------------------------------F-F*/
+	BOOL IsPointInSight(_In_ const library::HeightField& field, _In_ const XMFLOAT3& eye, _In_ const XMFLOAT3& point, _In_ const library::MeshBounds& bounds)
+	{
+		const FLOAT dx = point.x - eye.x;
+		const FLOAT dy = point.y - eye.y;
+		const FLOAT dz = point.z - eye.z;
+
+		std::vector<FLOAT> aCrossings = { 0.0f, 1.0f };
+		auto addCrossings = [&aCrossings, &field](FLOAT start, FLOAT delta, FLOAT minimum, UINT uNumColumns)
+		{
+			if (delta == 0.0f)
+			{
+				return;
+			}
+			for (UINT i = 0u; i <= uNumColumns; ++i)
+			{
+				const FLOAT t = (minimum + static_cast<FLOAT>(i) * field.CellSize - start) / delta;
+				if (0.0f < t && t < 1.0f)
+				{
+					aCrossings.push_back(t);
+				}
+			}
+		};
+		addCrossings(eye.x, dx, field.MinX, field.uNumColumnsX);
+		addCrossings(eye.z, dz, field.MinZ, field.uNumColumnsZ);
+		std::sort(aCrossings.begin(), aCrossings.end());
+
+		for (size_t i = 0u; i + 1u < aCrossings.size(); ++i)
+		{
+			const FLOAT tA = aCrossings[i];
+			const FLOAT tB = aCrossings[i + 1u];
+			if (!(tB > tA))
+			{
+				continue;
+			}
+
+			const FLOAT t = (tA + tB) * 0.5f;
+			const INT iX = static_cast<INT>(std::floor((eye.x + dx * t - field.MinX) / field.CellSize));
+			const INT iZ = static_cast<INT>(std::floor((eye.z + dz * t - field.MinZ) / field.CellSize));
+			if (iX < 0 || iZ < 0 || iX >= static_cast<INT>(field.uNumColumnsX) || iZ >= static_cast<INT>(field.uNumColumnsZ))
+			{
+				continue;
+			}
+
+			const FLOAT columnMinX = field.MinX + static_cast<FLOAT>(iX) * field.CellSize;
+			const FLOAT columnMinZ = field.MinZ + static_cast<FLOAT>(iZ) * field.CellSize;
+			if (columnMinX < bounds.Center.x + bounds.Extents.x && columnMinX + field.CellSize > bounds.Center.x - bounds.Extents.x
+				&& columnMinZ < bounds.Center.z + bounds.Extents.z && columnMinZ + field.CellSize > bounds.Center.z - bounds.Extents.z)
+			{
+				continue;
+			}
+
+			const FLOAT height = field.aHeights[static_cast<size_t>(iZ) * field.uNumColumnsX + static_cast<size_t>(iX)];
+			const FLOAT yA = eye.y + dy * tA;
+			const FLOAT yB = eye.y + dy * tB;
+			if (height > field.Bottom && std::min(yA, yB) < height && std::max(yA, yB) > field.Bottom)
+			{
+				return FALSE;
+			}
+		}
+
+		return TRUE;
+	}
+
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: IsBoundsInSight
+
+	  Summary:  Tests a grid of points on each face of a box, in the
+				view, for a line of sight from the eye
+
+	  Args:     const HeightField& field
+				  Columns
+				const XMFLOAT3& eye
+				  Eye position
+				FXMMATRIX viewProjection
+				  View matrix times projection matrix
+				const MeshBounds& bounds
+				  World space bounds
+
+	  Returns:  BOOL
+				  TRUE if any point in the view is in sight
+	-----------------------------------------------------------------F-F*/
+	BOOL IsBoundsInSight(_In_ const library::HeightField& field, _In_ const XMFLOAT3& eye, _In_ FXMMATRIX viewProjection, _In_ const library::MeshBounds& bounds)
+	{
+		constexpr UINT NUM_SAMPLES = 5u;
+
+		for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+		{
+			for (FLOAT side : { -1.0f, 1.0f })
+			{
+				for (UINT i = 0u; i < NUM_SAMPLES; ++i)
+				{
+					for (UINT j = 0u; j < NUM_SAMPLES; ++j)
+					{
+						const FLOAT u = static_cast<FLOAT>(i) / static_cast<FLOAT>(NUM_SAMPLES - 1u) * 2.0f - 1.0f;
+						const FLOAT v = static_cast<FLOAT>(j) / static_cast<FLOAT>(NUM_SAMPLES - 1u) * 2.0f - 1.0f;
+						const FLOAT aOffsets[3] =
+						{
+							uAxis == 0u ? side : u,
+							uAxis == 1u ? side : (uAxis == 0u ? u : v),
+							uAxis == 2u ? side : v,
+						};
+						const XMFLOAT3 point(
+							bounds.Center.x + aOffsets[0] * bounds.Extents.x,
+							bounds.Center.y + aOffsets[1] * bounds.Extents.y,
+							bounds.Center.z + aOffsets[2] * bounds.Extents.z
+						);
+						XMFLOAT4 clip;
+						XMStoreFloat4(&clip, XMVector4Transform(XMVectorSet(point.x, point.y, point.z, 1.0f), viewProjection));
+						const FLOAT w = clip.w * 1.0001f;
+						if (std::fabs(clip.x) > w || std::fabs(clip.y) > w || clip.z < 0.0f || clip.z > w)
+						{
+							continue;
+						}
+
+						if (IsPointInSight(field, eye, point, bounds))
+						{
+							return TRUE;
+						}
+					}
+				}
+			}
+		}
+
+		return FALSE;
+	}
+
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: MakeHeightField
+
+	  Summary:  Returns a flat floor of 64 by 64 columns two units
+				wide, two units above the bottom, centered on the
+				origin
+
+	  Returns:  library::HeightField
+	-----------------------------------------------------------------F-F*/
+	library::HeightField MakeHeightField()
+	{
+		constexpr UINT SIZE = 64u;
+		return library::HeightField
+		{
+			.uNumColumnsX = SIZE,
+			.uNumColumnsZ = SIZE,
+			.MinX = -64.0f,
+			.MinZ = -64.0f,
+			.CellSize = 2.0f,
+			.Bottom = -10.0f,
+			.aHeights = std::vector<FLOAT>(static_cast<size_t>(SIZE) * SIZE, -8.0f)
+		};
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: HorizonCullerHidesKnownBounds
+
+  Summary:  Culls boxes behind, above and in front of a wall of
+			columns, checks that a narrow view sweeps few columns and
+			that an eye below the columns hides nothing
+-----------------------------------------------------------------F-F*/
+TEST_CASE(HorizonCullerHidesKnownBounds)
+{
+	library::HeightField field = MakeHeightField();
+	const UINT uSize = field.uNumColumnsX;
+
+	// A flat floor with a wall across it, the eye looking at the wall
+	for (UINT uX = 0u; uX < uSize; ++uX)
+	{
+		field.aHeights[40u * uSize + uX] = 10.0f;
+	}
+
+	library::HorizonCuller culler;
+	culler.SetHeightField(field);
+
+	struct KnownCase
+	{
+		library::MeshBounds Bounds;
+		BOOL bIsHidden;
+		PCWSTR pszWhat;
+	};
+	const KnownCase aCases[] =
+	{
+		{ MakeBounds(0.0f, -6.0f, 40.0f, 1.0f, 1.0f, 1.0f), TRUE, L"box behind the wall" },
+		{ MakeBounds(20.0f, -4.0f, 60.0f, 3.0f, 3.0f, 1.0f), TRUE, L"wide box behind the wall" },
+		{ MakeBounds(0.0f, 20.0f, 40.0f, 1.0f, 1.0f, 1.0f), FALSE, L"box above the wall" },
+		{ MakeBounds(0.0f, -6.0f, 0.0f, 1.0f, 1.0f, 1.0f), FALSE, L"box in front of the wall" },
+	};
+
+	const XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 1000.0f);
+	const XMVECTOR up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+	const XMVECTOR eye = XMVectorSet(0.0f, -4.0f, -40.0f, 1.0f);
+	const XMMATRIX viewProjection = XMMatrixLookToLH(eye, XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), up) * projection;
+
+	library::FrustumCuller frustumCuller;
+	frustumCuller.SetViewProjection(viewProjection);
+	for (const KnownCase& knownCase : aCases)
+	{
+		frustumCuller.AddBounds(knownCase.Bounds, XMMatrixIdentity());
+	}
+	frustumCuller.Cull();
+	context.Check(frustumCuller.GetNumVisible() == ARRAYSIZE(aCases), L"%u of %u known boxes in the frustum", frustumCuller.GetNumVisible(), static_cast<UINT>(ARRAYSIZE(aCases)));
+
+	culler.SetCamera(eye, viewProjection);
+	const UINT uNumHidden = culler.Cull(frustumCuller);
+	context.Check(uNumHidden == 2u, L"%u known boxes hidden, expected 2", uNumHidden);
+	for (UINT i = 0u; i < ARRAYSIZE(aCases); ++i)
+	{
+		context.Check(frustumCuller.IsVisible(i) != aCases[i].bIsHidden, L"%ls is %ls", aCases[i].pszWhat, aCases[i].bIsHidden ? L"drawn" : L"culled");
+	}
+
+	// A narrow view sweeps a narrow wedge of the columns
+	const XMMATRIX narrowViewProjection = XMMatrixLookToLH(eye, XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), up)
+		* XMMatrixPerspectiveFovLH(XM_PIDIV4 * 0.25f, 1.0f, 0.1f, 1000.0f);
+	frustumCuller.SetViewProjection(narrowViewProjection);
+	frustumCuller.Cull();
+	culler.SetCamera(eye, narrowViewProjection);
+	culler.Cull(frustumCuller);
+	context.Check(!frustumCuller.IsVisible(0u), L"box behind the wall is drawn in a narrow view");
+	context.Check(
+		culler.GetStats().uNumSweptColumns < uSize * uSize / 8u,
+		L"%u columns swept in a narrow view of %u", culler.GetStats().uNumSweptColumns, uSize * uSize
+	);
+
+	// From below the columns nothing is hidden
+	frustumCuller.SetViewProjection(viewProjection);
+	frustumCuller.Cull();
+	culler.SetCamera(XMVectorSet(0.0f, -20.0f, -40.0f, 1.0f), viewProjection);
+	const UINT uNumHiddenBelow = culler.Cull(frustumCuller);
+	context.Check(uNumHiddenBelow == 0u, L"eye below the columns hides %u bounds", uNumHiddenBelow);
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: HorizonCullerMatchesLineOfSight
+
+  Summary:  Culls random boxes standing on hilly columns with a
+			lake, and chunks of columns, seen from random cameras,
+			some looking down and one from outside of the grid.
+			Every hidden box must be out of sight by a line of sight
+			test from the eye to points on its faces, and at least
+			half of the boxes out of sight must be hidden.
+-----------------------------------------------------------------F-F*/
+TEST_CASE(HorizonCullerMatchesLineOfSight)
+{
+	constexpr UINT NUM_CAMERAS = 24u;
+
+	library::HeightField field = MakeHeightField();
+	const UINT uSize = field.uNumColumnsX;
+	for (UINT uZ = 0u; uZ < uSize; ++uZ)
+	{
+		for (UINT uX = 0u; uX < uSize; ++uX)
+		{
+			const FLOAT x = static_cast<FLOAT>(uX);
+			const FLOAT z = static_cast<FLOAT>(uZ);
+			const INT iNumCells = static_cast<INT>(6.0f + 5.0f * std::sin(x * 0.2f) * std::cos(z * 0.15f) + 3.0f * std::sin((x - z) * 0.1f));
+			const BOOL bIsLake = (x - 40.0f) * (x - 40.0f) + (z - 20.0f) * (z - 20.0f) < 30.0f;
+			field.aHeights[uZ * uSize + uX] = bIsLake ? field.Bottom : field.Bottom + 2.0f * static_cast<FLOAT>(std::max(iNumCells, 1));
+		}
+	}
+
+	library::HorizonCuller culler;
+	culler.SetHeightField(field);
+
+	std::mt19937 generator(50u);
+	std::uniform_int_distribution<UINT> column(0u, uSize - 1u);
+	std::uniform_real_distribution<FLOAT> unit(0.0f, 1.0f);
+
+	std::vector<library::MeshBounds> aBounds;
+	for (UINT i = 0u; i < 300u; ++i)
+	{
+		const UINT uX = column(generator);
+		const UINT uZ = column(generator);
+		const FLOAT extentY = 0.5f + 1.5f * unit(generator);
+		aBounds.push_back(
+			MakeBounds(
+				field.MinX + (static_cast<FLOAT>(uX) + unit(generator)) * field.CellSize,
+				field.aHeights[uZ * uSize + uX] + extentY,
+				field.MinZ + (static_cast<FLOAT>(uZ) + unit(generator)) * field.CellSize,
+				0.3f + 1.7f * unit(generator),
+				extentY,
+				0.3f + 1.7f * unit(generator)
+			)
+		);
+	}
+	for (UINT uZ = 0u; uZ < uSize; uZ += 8u)
+	{
+		for (UINT uX = 0u; uX < uSize; uX += 8u)
+		{
+			FLOAT top = field.Bottom;
+			for (UINT i = 0u; i < 64u; ++i)
+			{
+				top = std::max(top, field.aHeights[(uZ + i / 8u) * uSize + uX + i % 8u]);
+			}
+			aBounds.push_back(
+				MakeBounds(
+					field.MinX + (static_cast<FLOAT>(uX) + 4.0f) * field.CellSize,
+					(field.Bottom + top) * 0.5f,
+					field.MinZ + (static_cast<FLOAT>(uZ) + 4.0f) * field.CellSize,
+					8.0f,
+					(top - field.Bottom) * 0.5f,
+					8.0f
+				)
+			);
+		}
+	}
+
+	const XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 1000.0f);
+	const XMVECTOR up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+	library::FrustumCuller frustumCuller;
+
+	UINT uNumInFrustum = 0u;
+	UINT uNumOutOfSight = 0u;
+	UINT uNumHidden = 0u;
+	UINT uNumWrong = 0u;
+	UINT uNumSweptColumns = 0u;
+	for (UINT uCamera = 0u; uCamera < NUM_CAMERAS; ++uCamera)
+	{
+		// The last cameras look down, and from outside of the grid
+		const UINT uX = column(generator);
+		const UINT uZ = column(generator);
+		XMFLOAT3 position(
+			field.MinX + (static_cast<FLOAT>(uX) + unit(generator)) * field.CellSize,
+			field.aHeights[uZ * uSize + uX] + 1.0f + 7.0f * unit(generator),
+			field.MinZ + (static_cast<FLOAT>(uZ) + unit(generator)) * field.CellSize
+		);
+		const FLOAT yaw = XM_2PI * unit(generator);
+		FLOAT pitch = -0.6f + 0.9f * unit(generator);
+		if (uCamera == NUM_CAMERAS - 2u)
+		{
+			pitch = -1.4f;
+		}
+		else if (uCamera == NUM_CAMERAS - 1u)
+		{
+			position = XMFLOAT3(-90.0f, 0.0f, -80.0f);
+		}
+
+		const XMVECTOR eye = XMLoadFloat3(&position);
+		const XMVECTOR direction = uCamera == NUM_CAMERAS - 1u
+			? XMVectorSet(1.0f, -0.1f, 1.0f, 0.0f)
+			: XMVectorSet(std::cos(pitch) * std::cos(yaw), std::sin(pitch), std::cos(pitch) * std::sin(yaw), 0.0f);
+		const XMMATRIX viewProjection = XMMatrixLookToLH(eye, direction, up) * projection;
+
+		frustumCuller.SetViewProjection(viewProjection);
+		frustumCuller.Reset();
+		for (const library::MeshBounds& bounds : aBounds)
+		{
+			frustumCuller.AddBounds(bounds, XMMatrixIdentity());
+		}
+		frustumCuller.Cull();
+		std::vector<BOOL> aInFrustum(aBounds.size());
+		for (UINT i = 0u; i < aBounds.size(); ++i)
+		{
+			aInFrustum[i] = frustumCuller.IsVisible(i);
+		}
+
+		culler.SetCamera(eye, viewProjection);
+		uNumHidden += culler.Cull(frustumCuller);
+		uNumSweptColumns += culler.GetStats().uNumSweptColumns;
+
+		for (UINT i = 0u; i < aBounds.size(); ++i)
+		{
+			if (!aInFrustum[i])
+			{
+				continue;
+			}
+
+			++uNumInFrustum;
+			const BOOL bIsInSight = IsBoundsInSight(field, position, viewProjection, aBounds[i]);
+			uNumOutOfSight += bIsInSight ? 0u : 1u;
+			if (bIsInSight && !frustumCuller.IsVisible(i))
+			{
+				++uNumWrong;
+				context.Check(FALSE, L"camera %u hides bounds %u in sight", uCamera, i);
+			}
+		}
+	}
+
+	context.Check(uNumOutOfSight > 0u, L"no bounds of %u in the frustum are out of sight", uNumInFrustum);
+	context.Check(uNumHidden * 2u >= uNumOutOfSight, L"%u of %u bounds out of sight hidden", uNumHidden, uNumOutOfSight);
+	context.Log(
+		L"%u of %u bounds out of sight hidden, %u wrongly, %u in the frustum, %u columns swept per camera",
+		uNumHidden,
+		uNumOutOfSight,
+		uNumWrong,
+		uNumInFrustum,
+		uNumSweptColumns / NUM_CAMERAS
+	);
+}
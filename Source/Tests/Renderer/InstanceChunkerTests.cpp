@@ -0,0 +1,192 @@
+/*+===================================================================
+  File:      INSTANCECHUNKERTESTS.CPP
+
+  Summary:   Sorts a shuffled voxel terrain into instance chunks and
+			 compares the instances drawn from the visible chunks
+			 with the instances visible one by one.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "Renderer/InstanceChunker.h"
+
+namespace
+{
+	constexpr UINT NUM_COLUMNS = 64u;
+	constexpr FLOAT VOXEL_SIZE = 2.0f;
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: MakeTerrain
+
+	  Summary:  Builds columns of voxels of varying height centered on
+				the origin, in shuffled order
+
+	  Returns:  std::vector<library::InstanceData>
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	std::vector<library::InstanceData> MakeTerrain()
+	{
+		std::vector<library::InstanceData> aInstances;
+		for (UINT x = 0u; x < NUM_COLUMNS; ++x)
+		{
+			for (UINT z = 0u; z < NUM_COLUMNS; ++z)
+			{
+				const UINT uHeight = 1u + (x * 7u + z * 13u) % 10u;
+				for (UINT y = 0u; y < uHeight; ++y)
+				{
+					aInstances.push_back(
+						library::InstanceData
+						{
+							.Transformation = XMMatrixTranslation(
+								VOXEL_SIZE * (static_cast<FLOAT>(x) - NUM_COLUMNS / 2.0f),
+								VOXEL_SIZE * static_cast<FLOAT>(y),
+								VOXEL_SIZE * (static_cast<FLOAT>(z) - NUM_COLUMNS / 2.0f)
+							),
+							.BlockSlice = 0u
+						}
+					);
+				}
+			}
+		}
+		std::shuffle(aInstances.begin(), aInstances.end(), std::mt19937(39u));
+
+		return aInstances;
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: InstanceChunkerCullsByChunk
+
+  Summary:  Checks that the chunks tile the sorted instance buffer
+			and hold their instances, then, for scripted cameras,
+			that no instance visible on its own is dropped by chunk
+			culling, that a camera facing away draws nothing and
+			that one seeing the whole terrain draws everything
+-----------------------------------------------------------------F-F*/
+TEST_CASE(InstanceChunkerCullsByChunk)
+{
+	// One cube mesh, corners at -1 and 1 like Voxel
+	const std::vector<library::MeshBounds> aMeshBounds =
+	{
+		{.Center = XMFLOAT3(0.0f, 0.0f, 0.0f), .Extents = XMFLOAT3(1.0f, 1.0f, 1.0f), .Radius = sqrtf(3.0f) }
+	};
+
+	std::vector<library::InstanceData> aInstances = MakeTerrain();
+	std::vector<library::InstanceChunk> aChunks;
+	library::InstanceChunker::SortIntoChunks(aInstances, aMeshBounds, library::InstanceChunker::DEFAULT_CHUNK_SIZE, aChunks);
+
+	// Chunks tile the instance buffer in order and hold their instances
+	UINT uNextInstance = 0u;
+	for (UINT uChunk = 0u; uChunk < aChunks.size(); ++uChunk)
+	{
+		const library::InstanceChunk& chunk = aChunks[uChunk];
+		if (!context.Check(chunk.Range.uStartInstance == uNextInstance && chunk.Range.uNumInstances > 0u, L"chunk %u starts at %u, expected %u", uChunk, chunk.Range.uStartInstance, uNextInstance)
+			|| !context.Check(chunk.Range.uStartInstance + chunk.Range.uNumInstances <= aInstances.size(), L"chunk %u runs past the instances", uChunk))
+		{
+			return;
+		}
+
+		BOOL bIsInside = TRUE;
+		for (UINT i = chunk.Range.uStartInstance; i < chunk.Range.uStartInstance + chunk.Range.uNumInstances; ++i)
+		{
+			XMFLOAT3 translation;
+			XMStoreFloat3(&translation, aInstances[i].Transformation.r[3]);
+			bIsInside &= fabsf(translation.x - chunk.Bounds.Center.x) + 1.0f <= chunk.Bounds.Extents.x + 1e-3f
+				&& fabsf(translation.y - chunk.Bounds.Center.y) + 1.0f <= chunk.Bounds.Extents.y + 1e-3f
+				&& fabsf(translation.z - chunk.Bounds.Center.z) + 1.0f <= chunk.Bounds.Extents.z + 1e-3f;
+		}
+		context.Check(bIsInside, L"chunk %u does not bound its instances", uChunk);
+
+		uNextInstance += chunk.Range.uNumInstances;
+	}
+	context.Check(uNextInstance == aInstances.size(), L"chunks hold %u of %zu instances", uNextInstance, aInstances.size());
+
+	struct ScriptedCamera
+	{
+		XMFLOAT3 Eye;
+		XMFLOAT3 At;
+		INT iExpected;
+	};
+	constexpr INT ALL = -1;
+	constexpr INT ANY = -2;
+	const ScriptedCamera aCameras[] =
+	{
+		{ XMFLOAT3(0.0f, 400.0f, -1.0f), XMFLOAT3(0.0f, 0.0f, 0.0f), ALL },
+		{ XMFLOAT3(0.0f, 10.0f, 0.0f), XMFLOAT3(30.0f, 5.0f, 10.0f), ANY },
+		{ XMFLOAT3(-50.0f, 20.0f, -90.0f), XMFLOAT3(-50.0f, 0.0f, -40.0f), ANY },
+		{ XMFLOAT3(40.0f, 4.0f, -40.0f), XMFLOAT3(60.0f, 4.0f, -60.0f), ANY },
+		{ XMFLOAT3(0.0f, 60.0f, 0.0f), XMFLOAT3(0.0f, 30.0f, 50.0f), ANY },
+		{ XMFLOAT3(0.0f, 200.0f, 0.0f), XMFLOAT3(0.0f, 300.0f, 1.0f), 0 },
+	};
+	const XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 1000.0f);
+
+	library::FrustumCuller chunkCuller;
+	library::FrustumCuller instanceCuller;
+	std::vector<library::InstanceRange> aRanges;
+	for (UINT uCamera = 0u; uCamera < ARRAYSIZE(aCameras); ++uCamera)
+	{
+		const ScriptedCamera& camera = aCameras[uCamera];
+		const XMMATRIX viewProjection = XMMatrixLookAtLH(
+			XMVectorSet(camera.Eye.x, camera.Eye.y, camera.Eye.z, 1.0f),
+			XMVectorSet(camera.At.x, camera.At.y, camera.At.z, 1.0f),
+			XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)
+		) * projection;
+
+		chunkCuller.SetViewProjection(viewProjection);
+		chunkCuller.Reset();
+		for (const library::InstanceChunk& chunk : aChunks)
+		{
+			chunkCuller.AddBounds(chunk.Bounds, XMMatrixIdentity());
+		}
+		chunkCuller.Cull();
+		const UINT uNumDrawn = library::InstanceChunker::GetVisibleRanges(chunkCuller, 0u, aChunks, aRanges);
+
+		// Brute force reference, every instance culled on its own
+		instanceCuller.SetViewProjection(viewProjection);
+		instanceCuller.Reset();
+		for (const library::InstanceData& instance : aInstances)
+		{
+			instanceCuller.AddBounds(aMeshBounds[0], instance.Transformation);
+		}
+		const UINT uNumVisible = instanceCuller.Cull();
+
+		std::vector<BOOL> aIsDrawn(aInstances.size(), FALSE);
+		UINT uNumRangeInstances = 0u;
+		for (const library::InstanceRange& range : aRanges)
+		{
+			std::fill(aIsDrawn.begin() + range.uStartInstance, aIsDrawn.begin() + range.uStartInstance + range.uNumInstances, TRUE);
+			uNumRangeInstances += range.uNumInstances;
+		}
+
+		UINT uNumDropped = 0u;
+		for (UINT i = 0u; i < aInstances.size(); ++i)
+		{
+			uNumDropped += instanceCuller.IsVisible(i) && !aIsDrawn[i] ? 1u : 0u;
+		}
+
+		context.Check(uNumRangeInstances == uNumDrawn, L"camera %u: ranges hold %u instances, %u drawn", uCamera, uNumRangeInstances, uNumDrawn);
+		context.Check(uNumDropped == 0u, L"camera %u: %u visible instances are not drawn", uCamera, uNumDropped);
+		context.Check(uNumDrawn >= uNumVisible, L"camera %u: %u instances drawn, %u visible", uCamera, uNumDrawn, uNumVisible);
+		if (camera.iExpected == ALL)
+		{
+			context.Check(uNumVisible == aInstances.size() && uNumDrawn == aInstances.size(), L"camera %u: the whole terrain should be drawn", uCamera);
+		}
+		else if (camera.iExpected == ANY)
+		{
+			context.Check(0u < uNumVisible && uNumDrawn < aInstances.size(), L"camera %u: chunks should cull part of the terrain", uCamera);
+		}
+		else
+		{
+			context.Check(uNumVisible == 0u && uNumDrawn == 0u && aRanges.empty(), L"camera %u: nothing should be drawn", uCamera);
+		}
+
+		context.Log(
+			L"camera %u draws %u of %zu instances in %zu ranges, %u visible one by one",
+			uCamera, uNumDrawn, aInstances.size(), aRanges.size(), uNumVisible
+		);
+	}
+}
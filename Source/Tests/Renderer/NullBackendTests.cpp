@@ -0,0 +1,314 @@
+/*+===================================================================
+  File:      NULLBACKENDTESTS.CPP
+
+  Summary:   Records frames on the null render device and context
+			 and checks the object sizes, the recorded commands,
+			 replay and comparison of the streams, mapping and that
+			 ranges recorded on the job system execute in order.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include "Renderer/CommandRecorder.h"
+#include "Renderer/NullBackend.h"
+
+namespace
+{
+	// 4/3 of the top mip, rounded down per level
+	constexpr UINT64 MIP_CHAIN_BYTES = 262144u + 65536u + 16384u + 4096u + 1024u + 256u + 64u + 16u + 4u;
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    NullScene
+
+	  Summary:  Objects of a small frame created on a null device: a
+				constant, vertex and index buffer, a full mip chain of
+				256x256 RGBA with its views, one level of 64x64 BC1,
+				shaders, an input layout and a sampler. Records the
+				frame and the draws of a range of objects.
+
+	  Methods:  Create
+				  Creates the objects
+				RecordObjects
+				  Records the binds and draws of a range of objects
+				RecordFrame
+				  Records the targets, clears, updates and two objects
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class NullScene final
+	{
+	public:
+		HRESULT Create(_Inout_ library::NullDevice& device)
+		{
+			const BYTE aBytecode[256] = {};
+
+			HRESULT hr = device.CreateBuffer(64u, &pConstantBuffer);
+			hr = SUCCEEDED(hr) ? device.CreateBuffer(1024u, &pVertexBuffer) : hr;
+			hr = SUCCEEDED(hr) ? device.CreateBuffer(72u, &pIndexBuffer) : hr;
+
+			library::NullTextureDesc textureDesc = { .uWidth = 256u, .uHeight = 256u, .uNumMipLevels = 0u, .uArraySize = 1u, .Format = DXGI_FORMAT_R8G8B8A8_UNORM };
+			hr = SUCCEEDED(hr) ? device.CreateTexture2D(textureDesc, &pTexture) : hr;
+
+			textureDesc = { .uWidth = 64u, .uHeight = 64u, .uNumMipLevels = 1u, .uArraySize = 1u, .Format = DXGI_FORMAT_BC1_UNORM };
+			hr = SUCCEEDED(hr) ? device.CreateTexture2D(textureDesc, &pCompressedTexture) : hr;
+
+			hr = SUCCEEDED(hr) ? device.CreateVertexShader(aBytecode, 200u, &pVertexShader) : hr;
+			hr = SUCCEEDED(hr) ? device.CreatePixelShader(aBytecode, 100u, &pPixelShader) : hr;
+			hr = SUCCEEDED(hr) ? device.CreateInputLayout(1u, &pInputLayout) : hr;
+			hr = SUCCEEDED(hr) ? device.CreateSamplerState(&pSampler) : hr;
+			hr = SUCCEEDED(hr) ? device.CreateShaderResourceView(pTexture, &pView) : hr;
+			hr = SUCCEEDED(hr) ? device.CreateRenderTargetView(pTexture, &pRenderTarget) : hr;
+			hr = SUCCEEDED(hr) ? device.CreateDepthStencilView(pTexture, &pDepthStencil) : hr;
+
+			return hr;
+		}
+
+		// Binds go through the cache, so the second object only draws
+		void RecordObjects(_Inout_ library::IRenderContext& context, _Inout_ library::StateCache& cache, _In_ UINT uBegin, _In_ UINT uEnd, _In_ UINT uIndexCount) const
+		{
+			const UINT uStride = 12u;
+			const UINT uOffset = 0u;
+			const UINT uFirstConstant = 16u;
+			const UINT uNumConstants = 4u;
+
+			for (UINT i = uBegin; i < uEnd; ++i)
+			{
+				cache.IASetPrimitiveTopology(library::ePrimitiveTopology::TRIANGLE_LIST);
+				cache.IASetInputLayout(pInputLayout);
+				cache.IASetVertexBuffers(0u, 1u, &pVertexBuffer, &uStride, &uOffset);
+				cache.IASetIndexBuffer(pIndexBuffer, DXGI_FORMAT_R16_UINT, 0u);
+				cache.VSSetShader(pVertexShader);
+				cache.PSSetShader(pPixelShader);
+				cache.VSSetConstantBuffers(0u, 1u, &pConstantBuffer);
+				cache.PSSetShaderResources(0u, 1u, &pView);
+				cache.PSSetSamplers(0u, 1u, &pSampler);
+				context.VSSetConstantBuffers1(2u, 1u, &pConstantBuffer, &uFirstConstant, &uNumConstants);
+				context.VSSetShaderResources(6u, 1u, &pView);
+				context.DrawIndexed(uIndexCount, i * uIndexCount, -4);
+				context.DrawIndexedInstanced(uIndexCount, 10u, 0u, 0, 3u);
+			}
+		}
+
+		void RecordFrame(_Inout_ library::IRenderContext& context, _In_ UINT uIndexCount) const
+		{
+			const FLOAT aClearColor[4] = { 0.0f, 0.125f, 0.6f, 1.0f };
+			const library::GpuViewport viewport = { .TopLeftX = 0.0f, .TopLeftY = 0.0f, .Width = 256.0f, .Height = 256.0f, .MinDepth = 0.0f, .MaxDepth = 1.0f };
+			const BYTE aConstants[64] = { 1u, 2u, 3u };
+			const BYTE aTexels[16u * 64u] = { 4u, 5u, 6u };
+
+			library::StateCache cache;
+			cache.SetContext(&context);
+
+			context.OMSetRenderTargets(1u, &pRenderTarget, pDepthStencil);
+			context.RSSetViewports(1u, &viewport);
+			context.ClearRenderTargetView(pRenderTarget, aClearColor);
+			context.ClearDepthStencilView(pDepthStencil, library::IRenderContext::CLEAR_DEPTH, 1.0f, 0u);
+			context.UpdateSubresource(pConstantBuffer, 0u, nullptr, aConstants, 0u, 0u);
+
+			const library::GpuBox texelBox = { .left = 0u, .top = 0u, .front = 0u, .right = 16u, .bottom = 16u, .back = 1u };
+			context.UpdateSubresource(pTexture, 0u, &texelBox, aTexels, 64u, 0u);
+
+			const library::GpuBox blockBox = { .left = 0u, .top = 0u, .front = 0u, .right = 8u, .bottom = 8u, .back = 1u };
+			context.UpdateSubresource(pCompressedTexture, 0u, &blockBox, aTexels, 16u, 0u);
+
+			RecordObjects(context, cache, 0u, 2u, uIndexCount);
+		}
+
+	public:
+		library::GpuBuffer* pConstantBuffer = nullptr;
+		library::GpuBuffer* pVertexBuffer = nullptr;
+		library::GpuBuffer* pIndexBuffer = nullptr;
+		library::GpuTexture2D* pTexture = nullptr;
+		library::GpuTexture2D* pCompressedTexture = nullptr;
+		library::GpuVertexShader* pVertexShader = nullptr;
+		library::GpuPixelShader* pPixelShader = nullptr;
+		library::GpuInputLayout* pInputLayout = nullptr;
+		library::GpuSamplerState* pSampler = nullptr;
+		library::GpuShaderResourceView* pView = nullptr;
+		library::GpuRenderTargetView* pRenderTarget = nullptr;
+		library::GpuDepthStencilView* pDepthStencil = nullptr;
+	};
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: NullDeviceMeasuresObjects
+
+  Summary:  Creates the objects of a frame and checks their counts
+			and sizes, and that a view a resource cannot have fails
+-----------------------------------------------------------------F-F*/
+TEST_CASE(NullDeviceMeasuresObjects)
+{
+	library::NullDevice device;
+	NullScene scene;
+	if (!context.Check(SUCCEEDED(scene.Create(device)), L"creating the objects failed"))
+	{
+		return;
+	}
+
+	library::GpuRenderTargetView* pMissingRenderTarget = nullptr;
+	context.Check(device.CreateRenderTargetView(scene.pConstantBuffer, &pMissingRenderTarget) == E_INVALIDARG, L"render target view of a buffer was created");
+
+	// The buffers, the mip chain, 16x16 blocks of 8 bytes and the bytecode
+	context.Check(
+		device.GetNumAllocatedBytes() == 64u + 1024u + 72u + MIP_CHAIN_BYTES + 2048u + 200u + 100u,
+		L"%llu bytes allocated", static_cast<unsigned long long>(device.GetNumAllocatedBytes())
+	);
+	context.Check(
+		device.GetNumObjects(library::eNullObjectType::BUFFER) == 3u && device.GetNumObjects(library::eNullObjectType::TEXTURE_2D) == 2u,
+		L"object counts do not match"
+	);
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: NullContextRecordsFrame
+
+  Summary:  Records a frame through a state cache and checks the
+			counts and byte sizes, that replaying and appending the
+			stream gives the same commands and that a changed draw
+			is found
+-----------------------------------------------------------------F-F*/
+TEST_CASE(NullContextRecordsFrame)
+{
+	library::NullDevice device;
+	NullScene scene;
+	if (!context.Check(SUCCEEDED(scene.Create(device)), L"creating the objects failed"))
+	{
+		return;
+	}
+
+	library::NullContext recorded;
+	recorded.SetDevice(&device);
+	scene.RecordFrame(recorded, 36u);
+
+	context.Check(recorded.GetNumDraws() == 4u && recorded.GetNumIndices() == 2u * (36u + 360u), L"draws or indices do not match");
+	context.Check(recorded.GetNumCommands(library::eNullCommand::SET_VERTEX_SHADER) == 1u, L"state cache did not filter the repeated binds");
+	context.Check(recorded.GetNumCommands() == 7u + 9u + 2u * 4u, L"%u commands recorded", recorded.GetNumCommands());
+
+	// The whole constant buffer, 16 rows of texels and 2 rows of BC1 blocks
+	context.Check(
+		recorded.GetNumUploadedBytes() == 64u + 16u * 64u + 2u * 16u,
+		L"%llu bytes uploaded", static_cast<unsigned long long>(recorded.GetNumUploadedBytes())
+	);
+
+	library::NullContext replayed;
+	replayed.SetDevice(&device);
+	recorded.Replay(replayed);
+	context.Check(replayed.Compare(recorded) == library::NullContext::NO_MISMATCH, L"replayed stream differs");
+	context.Check(replayed.GetNumUploadedBytes() == recorded.GetNumUploadedBytes(), L"replayed updates copied different bytes");
+
+	library::NullContext appended;
+	appended.Append(recorded);
+	appended.Append(replayed);
+	context.Check(appended.Compare(recorded) == recorded.GetNumCommands(), L"appended stream does not start with the stream");
+	context.Check(appended.GetNumDraws() == 2u * recorded.GetNumDraws(), L"appended draws were not counted");
+
+	// Only the index count of the draws differs, the first one follows 7 frame and 11 object commands
+	library::NullContext changed;
+	changed.SetDevice(&device);
+	scene.RecordFrame(changed, 24u);
+	context.Check(changed.Compare(recorded) == 18u && recorded.Compare(changed) == 18u, L"changed draw was not found");
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: NullContextMapsBuffers
+
+  Summary:  Maps a buffer and checks that the map and unmap are
+			recorded with their arguments, that the memory spans the
+			buffer and is kept between maps, and that an unknown
+			resource fails
+-----------------------------------------------------------------F-F*/
+TEST_CASE(NullContextMapsBuffers)
+{
+	library::NullDevice device;
+	NullScene scene;
+	if (!context.Check(SUCCEEDED(scene.Create(device)), L"creating the objects failed"))
+	{
+		return;
+	}
+
+	library::NullContext recorded;
+	recorded.SetDevice(&device);
+
+	void* pMapped = nullptr;
+	if (!context.Check(SUCCEEDED(recorded.Map(scene.pVertexBuffer, 0u, library::eMapType::WRITE_DISCARD, &pMapped)) && pMapped, L"map failed"))
+	{
+		return;
+	}
+	static_cast<BYTE*>(pMapped)[1023] = 0x5Au;
+	recorded.Unmap(scene.pVertexBuffer, 0u);
+
+	void* pRemapped = nullptr;
+	recorded.Map(scene.pVertexBuffer, 0u, library::eMapType::WRITE_NO_OVERWRITE, &pRemapped);
+	context.Check(pRemapped == pMapped && static_cast<BYTE*>(pRemapped)[1023] == 0x5Au, L"mapped memory was not kept");
+	recorded.Unmap(scene.pVertexBuffer, 0u);
+
+	context.Check(
+		recorded.GetNumCommands(library::eNullCommand::MAP) == 2u && recorded.GetNumCommands(library::eNullCommand::UNMAP) == 2u,
+		L"maps were not recorded"
+	);
+	context.Check(
+		recorded.GetCommandArg(0u, 2u) == static_cast<UINT64>(library::eMapType::WRITE_DISCARD)
+			&& recorded.GetCommandArg(2u, 2u) == static_cast<UINT64>(library::eMapType::WRITE_NO_OVERWRITE),
+		L"map types were not recorded"
+	);
+
+	library::GpuBuffer unknownBuffer;
+	void* pUnknown = nullptr;
+	context.Check(recorded.Map(&unknownBuffer, 0u, library::eMapType::WRITE_DISCARD, &pUnknown) == E_INVALIDARG, L"unknown resource was mapped");
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: CommandRecorderExecutesInOrder
+
+  Summary:  Records ranges of objects into deferred null contexts on
+			the job system and checks that executing them gives the
+			stream recorded in order on one context
+-----------------------------------------------------------------F-F*/
+TEST_CASE(CommandRecorderExecutesInOrder)
+{
+	constexpr UINT NUM_OBJECTS = 23u;
+	constexpr UINT NUM_RANGES = 5u;
+
+	library::NullDevice device;
+	NullScene scene;
+	if (!context.Check(SUCCEEDED(scene.Create(device)), L"creating the objects failed"))
+	{
+		return;
+	}
+
+	library::NullContext immediateContext;
+	immediateContext.SetDevice(&device);
+
+	library::DeferredContextBackend backend;
+	backend.Initialize(&device, &immediateContext);
+
+	library::CommandRecorder recorder;
+	recorder.SetBackend(&backend);
+
+	for (UINT uFrame = 0u; uFrame < 2u; ++uFrame)
+	{
+		immediateContext.Clear();
+		recorder.Record(NUM_OBJECTS, NUM_RANGES, [&scene](library::DeferredContext& deferredContext, UINT uBegin, UINT uEnd)
+			{
+				scene.RecordObjects(*deferredContext.Context, deferredContext.Cache, uBegin, uEnd, 36u);
+			}
+		);
+		context.Check(SUCCEEDED(recorder.Execute()) && recorder.GetNumExecutedLists() == NUM_RANGES, L"frame %u: ranges were not executed", uFrame);
+
+		library::NullContext expected;
+		for (UINT uRange = 0u; uRange < NUM_RANGES; ++uRange)
+		{
+			UINT uBegin = 0u;
+			UINT uEnd = 0u;
+			library::CommandRecorder::GetRange(NUM_OBJECTS, NUM_RANGES, uRange, uBegin, uEnd);
+
+			library::StateCache cache;
+			cache.SetContext(&expected);
+			scene.RecordObjects(expected, cache, uBegin, uEnd, 36u);
+		}
+		context.Check(immediateContext.Compare(expected) == library::NullContext::NO_MISMATCH, L"frame %u: executed ranges differ from the serial stream", uFrame);
+		context.Check(immediateContext.GetNumDraws() == 2u * NUM_OBJECTS, L"frame %u: executed draws were not counted", uFrame);
+	}
+
+	context.Check(recorder.GetNumContexts() == NUM_RANGES, L"contexts were not reused");
+}
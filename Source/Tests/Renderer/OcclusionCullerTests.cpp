@@ -0,0 +1,418 @@
+/*+===================================================================
+  File:      OCCLUSIONCULLERTESTS.CPP
+
+  Summary:   Culls bounds with a known answer behind occluders drawn
+			 into the CPU depth buffer, checks that terrain hulls stay
+			 inside of their cells and reports the share of a hilly
+			 terrain hidden from the ground and the time it takes.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+#include <unordered_set>
+
+#include "Renderer/OcclusionCuller.h"
+
+namespace
+{
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: MakeBounds
+
+	  Summary:  Returns the bounds of a box around a center
+
+	  Args:     FLOAT x, FLOAT y, FLOAT z
+				  Center
+				FLOAT extentX, FLOAT extentY, FLOAT extentZ
+				  Half of the size along each axis
+
+	  Returns:  library::MeshBounds
+	-----------------------------------------------------------------F-F*/
+	library::MeshBounds MakeBounds(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z, _In_ FLOAT extentX, _In_ FLOAT extentY, _In_ FLOAT extentZ)
+	{
+		return library::MeshBounds
+		{
+			.Center = XMFLOAT3(x, y, z),
+			.Extents = XMFLOAT3(extentX, extentY, extentZ),
+			.Radius = std::sqrt(extentX * extentX + extentY * extentY + extentZ * extentZ)
+		};
+	}
+
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: MakeCell
+
+	  Summary:  Returns the bounds of a cell of two units of the
+				terrains built by the tests, offset from the origin so
+				that no cell is centered on it
+
+	  Args:     INT iX, INT iY, INT iZ
+				  Cell along each axis
+
+	  Returns:  library::MeshBounds
+	-----------------------------------------------------------------F-F*/
+	library::MeshBounds MakeCell(_In_ INT iX, _In_ INT iY, _In_ INT iZ)
+	{
+		return MakeBounds(2.0f * static_cast<FLOAT>(iX) + 3.0f, 2.0f * static_cast<FLOAT>(iY) - 7.0f, 2.0f * static_cast<FLOAT>(iZ), 1.0f, 1.0f, 1.0f);
+	}
+
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: GetCellKey
+
+	  Summary:  Returns a key of a cell made by MakeCell for a set of
+				the cells of a terrain
+
+	  Args:     INT iX, INT iY, INT iZ
+				  Cell along each axis, iY below 16
+
+	  Returns:  UINT64
+	-----------------------------------------------------------------F-F*/
+	UINT64 GetCellKey(_In_ INT iX, _In_ INT iY, _In_ INT iZ)
+	{
+		return (static_cast<UINT64>(static_cast<UINT>(iX)) << 32u) | static_cast<UINT>(iZ * 16 + iY);
+	}
+
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: GetTerrainHeight
+
+	  Summary:  Height in cells of a column of the benchmark terrain,
+				rolling hills of a few octaves so that ridges hide the
+				valleys behind them
+
+	  Args:     INT iX
+				  Column along x
+				INT iZ
+				  Column along z
+
+	  Returns:  INT
+				  Number of cells of the column, at least one
+	-----------------------------------------------------------------F-F*/
+	INT GetTerrainHeight(_In_ INT iX, _In_ INT iZ)
+	{
+		const FLOAT x = static_cast<FLOAT>(iX);
+		const FLOAT z = static_cast<FLOAT>(iZ);
+		const FLOAT height = 10.0f
+			+ 7.0f * std::sin(x * 0.09f) * std::cos(z * 0.07f)
+			+ 4.0f * std::sin((x + 2.0f * z) * 0.05f)
+			+ 1.5f * std::sin(x * 0.31f + z * 0.23f);
+
+		return std::max(1, static_cast<INT>(height));
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: OcclusionCullerHidesKnownBounds
+
+  Summary:  Culls boxes with a known answer behind a wall, beside
+			it, in front of it, around the eye and larger than it,
+			directly and through a frustum culler, then under a floor
+			that crosses the near plane and inside an occluder around
+			the eye whose faces all point away
+-----------------------------------------------------------------F-F*/
+TEST_CASE(OcclusionCullerHidesKnownBounds)
+{
+	const XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 1.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	const XMMATRIX viewProjection = view * XMMatrixPerspectiveFovLH(XM_PIDIV2, 1.0f, 0.1f, 100.0f);
+
+	library::OcclusionCuller culler;
+	if (!context.Check(culler.Initialize(64u, 64u) == S_OK, L"initializing failed"))
+	{
+		return;
+	}
+	context.Check(culler.GetNumLevels() == 7u, L"%u pyramid levels, expected 7", culler.GetNumLevels());
+	culler.SetViewProjection(viewProjection);
+
+	// A wall ten units ahead, covering the middle of the screen
+	culler.AddOccluderBox(MakeBounds(0.0f, 0.0f, 10.0f, 5.0f, 5.0f, 0.5f), XMMatrixIdentity());
+	context.Check(culler.Rasterize() == S_OK, L"rasterizing failed");
+	context.Check(culler.GetDepth(0u, 32u, 32u) > 0.0f && culler.GetDepth(0u, 1u, 1u) == 0.0f, L"wall is not drawn where it is");
+	context.Check(culler.GetDepth(culler.GetNumLevels() - 1u, 0u, 0u) == 0.0f, L"top of the pyramid is not the farthest depth");
+	context.Check(
+		culler.GetStats().uNumOccluders == 1u && culler.GetStats().uNumRasterizedTriangles == 2u,
+		L"%u occluders, %u triangles rasterized, expected the front face of the wall", culler.GetStats().uNumOccluders, culler.GetStats().uNumRasterizedTriangles
+	);
+
+	struct KnownCase
+	{
+		library::MeshBounds Bounds;
+		BOOL bIsOccluded;
+		PCWSTR pszWhat;
+	};
+	const KnownCase aCases[] =
+	{
+		{ MakeBounds(0.0f, 0.0f, 20.0f, 1.0f, 1.0f, 1.0f), TRUE, L"box behind the wall" },
+		{ MakeBounds(0.0f, 0.0f, 10.2f, 0.1f, 0.1f, 0.1f), TRUE, L"box inside the wall" },
+		{ MakeBounds(14.0f, 0.0f, 20.0f, 1.0f, 1.0f, 1.0f), FALSE, L"box beside the wall" },
+		{ MakeBounds(0.0f, 0.0f, 5.0f, 1.0f, 1.0f, 1.0f), FALSE, L"box in front of the wall" },
+		{ MakeBounds(0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f), FALSE, L"box around the eye" },
+		{ MakeBounds(0.0f, 0.0f, 20.0f, 15.0f, 1.0f, 1.0f), FALSE, L"box wider than the wall" },
+		{ { .Center = XMFLOAT3(0.0f, 0.0f, 20.0f), .Extents = XMFLOAT3(1.0f, 1.0f, 1.0f), .Radius = -1.0f }, FALSE, L"bounds never computed" },
+	};
+
+	library::FrustumCuller frustumCuller;
+	frustumCuller.SetViewProjection(viewProjection);
+	for (const KnownCase& knownCase : aCases)
+	{
+		context.Check(culler.IsOccluded(knownCase.Bounds) == knownCase.bIsOccluded, L"%ls is %ls", knownCase.pszWhat, knownCase.bIsOccluded ? L"drawn" : L"culled");
+		frustumCuller.AddBounds(knownCase.Bounds, XMMatrixIdentity());
+	}
+
+	// Through a frustum culler, with one bounds it culls itself
+	frustumCuller.AddBounds(MakeBounds(0.0f, 0.0f, -20.0f, 1.0f, 1.0f, 1.0f), XMMatrixIdentity());
+	const UINT uNumInFrustum = frustumCuller.Cull();
+	const UINT uNumOccluded = culler.Cull(frustumCuller);
+	context.Check(
+		uNumInFrustum == ARRAYSIZE(aCases) && uNumOccluded == 2u && frustumCuller.GetNumVisible() == uNumInFrustum - uNumOccluded,
+		L"%u bounds in the frustum, %u occluded, %u visible", uNumInFrustum, uNumOccluded, frustumCuller.GetNumVisible()
+	);
+	for (UINT i = 0u; i < ARRAYSIZE(aCases); ++i)
+	{
+		context.Check(frustumCuller.IsVisible(i) != aCases[i].bIsOccluded, L"%ls is %ls by the frustum culler", aCases[i].pszWhat, aCases[i].bIsOccluded ? L"drawn" : L"culled");
+	}
+	context.Check(
+		culler.GetStats().uNumTestedBounds == uNumInFrustum && !frustumCuller.IsVisible(ARRAYSIZE(aCases)),
+		L"%u bounds tested, bounds outside of the frustum are tested", culler.GetStats().uNumTestedBounds
+	);
+
+	// A floor under the eye is clipped by the near plane
+	culler.Reset();
+	culler.AddOccluderBox(MakeBounds(0.0f, -6.0f, 0.0f, 100.0f, 5.0f, 100.0f), XMMatrixIdentity());
+	culler.Rasterize();
+	context.Check(culler.IsOccluded(MakeBounds(0.0f, -20.0f, 30.0f, 1.0f, 1.0f, 1.0f)), L"box under the floor is drawn");
+	context.Check(!culler.IsOccluded(MakeBounds(0.0f, 0.0f, 30.0f, 1.0f, 1.0f, 1.0f)), L"box above the floor is culled");
+
+	// From inside a box only back faces are seen
+	culler.Reset();
+	culler.AddOccluderBox(MakeBounds(0.0f, 0.0f, 0.0f, 50.0f, 50.0f, 50.0f), XMMatrixIdentity());
+	culler.Rasterize();
+	context.Check(
+		culler.GetStats().uNumRasterizedTriangles == 0u && !culler.IsOccluded(MakeBounds(0.0f, 0.0f, 20.0f, 1.0f, 1.0f, 1.0f)),
+		L"box around the eye occludes, %u triangles rasterized", culler.GetStats().uNumRasterizedTriangles
+	);
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: OcclusionCullerBuildsTerrainHulls
+
+  Summary:  Checks that a flat terrain merges into the largest hulls
+			and that the hulls of random heights with holes and
+			floating cells stay inside of the cells
+-----------------------------------------------------------------F-F*/
+TEST_CASE(OcclusionCullerBuildsTerrainHulls)
+{
+	// A flat terrain of 16 by 16 columns, 4 cells high, merges into 4 hulls
+	std::vector<library::MeshBounds> aCells;
+	for (INT iZ = 0; iZ < 16; ++iZ)
+	{
+		for (INT iX = 0; iX < 16; ++iX)
+		{
+			for (INT iY = 0; iY < 4; ++iY)
+			{
+				aCells.push_back(MakeCell(iX, iY, iZ));
+			}
+		}
+	}
+	std::vector<library::MeshBounds> aHulls;
+	library::OcclusionCuller::BuildTerrainHulls(aCells, 8u, aHulls);
+	if (context.Check(aHulls.size() == 4u, L"%u hulls of a flat terrain, expected 4", static_cast<UINT>(aHulls.size())))
+	{
+		context.Check(
+			std::fabs(aHulls[0].Extents.x - 8.0f) < 1e-4f && std::fabs(aHulls[0].Extents.y - 4.0f) < 1e-4f,
+			L"flat terrain hull extents %g %g, expected 8 4", aHulls[0].Extents.x, aHulls[0].Extents.y
+		);
+	}
+
+	// Random heights with holes and floating cells
+	std::mt19937 generator(49u);
+	std::uniform_int_distribution<INT> height(-1, 6);
+	std::unordered_set<UINT64> cells;
+	aCells.clear();
+	for (INT iZ = 0; iZ < 24; ++iZ)
+	{
+		for (INT iX = 0; iX < 24; ++iX)
+		{
+			const INT iHeight = height(generator);
+			for (INT iY = 0; iY < iHeight; ++iY)
+			{
+				aCells.push_back(MakeCell(iX, iY, iZ));
+				cells.insert(GetCellKey(iX, iY, iZ));
+			}
+			if (iHeight == 2)
+			{
+				aCells.push_back(MakeCell(iX, 5, iZ));
+				cells.insert(GetCellKey(iX, 5, iZ));
+			}
+		}
+	}
+	library::OcclusionCuller::BuildTerrainHulls(aCells, 8u, aHulls);
+
+	UINT uNumOutside = 0u;
+	for (const library::MeshBounds& hull : aHulls)
+	{
+		// Points just inside of the corners, and the center
+		for (UINT i = 0u; i < 9u; ++i)
+		{
+			XMFLOAT3 point = hull.Center;
+			if (i < 8u)
+			{
+				point.x += (i & 1u ? 0.99f : -0.99f) * hull.Extents.x;
+				point.y += (i & 2u ? 0.99f : -0.99f) * hull.Extents.y;
+				point.z += (i & 4u ? 0.99f : -0.99f) * hull.Extents.z;
+			}
+			const INT iX = static_cast<INT>(std::floor((point.x - 3.0f) / 2.0f + 0.5f));
+			const INT iY = static_cast<INT>(std::floor((point.y + 7.0f) / 2.0f + 0.5f));
+			const INT iZ = static_cast<INT>(std::floor(point.z / 2.0f + 0.5f));
+			uNumOutside += cells.contains(GetCellKey(iX, iY, iZ)) ? 0u : 1u;
+		}
+	}
+	context.Check(!aHulls.empty() && uNumOutside == 0u, L"%u points of %u hulls reach outside of %u random cells", uNumOutside, static_cast<UINT>(aHulls.size()), static_cast<UINT>(aCells.size()));
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: OcclusionCullerTerrain
+
+  Summary:  Generates a hilly voxel terrain, splits it into chunks
+			and scatters objects on it, then walks a camera around
+			it at eye height. Each frame culls the chunks and the
+			objects against the frustum, draws the terrain hulls as
+			occluders and hides what they cover. Reports the share
+			of the bounds in the frustum hidden and the time taken;
+			the hills must hide some of them.
+-----------------------------------------------------------------F-F*/
+BENCHMARK_CASE(OcclusionCullerTerrain)
+{
+	constexpr UINT NUM_FRAMES = 64u;
+	constexpr INT TERRAIN_SIZE = 128;
+	constexpr INT CHUNK_SIZE = 8;
+	constexpr UINT NUM_OBJECTS = 1024u;
+	constexpr FLOAT CELL_SIZE = 2.0f;
+
+	auto getCellCenter = [](INT iX, INT iY, INT iZ)
+	{
+		return XMFLOAT3(
+			CELL_SIZE * static_cast<FLOAT>(iX - TERRAIN_SIZE / 2),
+			CELL_SIZE * static_cast<FLOAT>(iY),
+			CELL_SIZE * static_cast<FLOAT>(iZ - TERRAIN_SIZE / 2)
+		);
+	};
+	auto makeBox = [](const XMFLOAT3& minimum, const XMFLOAT3& maximum)
+	{
+		return MakeBounds(
+			(minimum.x + maximum.x) * 0.5f, (minimum.y + maximum.y) * 0.5f, (minimum.z + maximum.z) * 0.5f,
+			(maximum.x - minimum.x) * 0.5f, (maximum.y - minimum.y) * 0.5f, (maximum.z - minimum.z) * 0.5f
+		);
+	};
+
+	std::vector<library::MeshBounds> aCells;
+	for (INT iZ = 0; iZ < TERRAIN_SIZE; ++iZ)
+	{
+		for (INT iX = 0; iX < TERRAIN_SIZE; ++iX)
+		{
+			for (INT iY = 0; iY < GetTerrainHeight(iX, iZ); ++iY)
+			{
+				const XMFLOAT3 center = getCellCenter(iX, iY, iZ);
+				aCells.push_back(MakeBounds(center.x, center.y, center.z, CELL_SIZE * 0.5f, CELL_SIZE * 0.5f, CELL_SIZE * 0.5f));
+			}
+		}
+	}
+
+	std::vector<library::MeshBounds> aHulls;
+	library::OcclusionCuller::BuildTerrainHulls(aCells, library::OcclusionCuller::DEFAULT_COLUMNS_PER_HULL, aHulls);
+
+	// Chunks of columns as the voxel renderer draws them, and objects standing on the ground
+	std::vector<library::MeshBounds> aBounds;
+	for (INT iZ = 0; iZ < TERRAIN_SIZE; iZ += CHUNK_SIZE)
+	{
+		for (INT iX = 0; iX < TERRAIN_SIZE; iX += CHUNK_SIZE)
+		{
+			INT iTop = 0;
+			for (INT iChunkZ = iZ; iChunkZ < iZ + CHUNK_SIZE; ++iChunkZ)
+			{
+				for (INT iChunkX = iX; iChunkX < iX + CHUNK_SIZE; ++iChunkX)
+				{
+					iTop = std::max(iTop, GetTerrainHeight(iChunkX, iChunkZ) - 1);
+				}
+			}
+
+			const XMFLOAT3 first = getCellCenter(iX, 0, iZ);
+			const XMFLOAT3 last = getCellCenter(iX + CHUNK_SIZE - 1, iTop, iZ + CHUNK_SIZE - 1);
+			const FLOAT halfCell = CELL_SIZE * 0.5f;
+			aBounds.push_back(
+				makeBox(
+					XMFLOAT3(first.x - halfCell, first.y - halfCell, first.z - halfCell),
+					XMFLOAT3(last.x + halfCell, last.y + halfCell, last.z + halfCell)
+				)
+			);
+		}
+	}
+
+	std::mt19937 generator(49u);
+	std::uniform_int_distribution<INT> column(0, TERRAIN_SIZE - 1);
+	for (UINT i = 0u; i < NUM_OBJECTS; ++i)
+	{
+		const INT iX = column(generator);
+		const INT iZ = column(generator);
+		const XMFLOAT3 ground = getCellCenter(iX, GetTerrainHeight(iX, iZ), iZ);
+		aBounds.push_back(MakeBounds(ground.x, ground.y + 0.5f, ground.z, 1.0f, 1.5f, 1.0f));
+	}
+
+	const XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.01f, 1000.0f);
+
+	library::OcclusionCuller occlusionCuller;
+	if (!context.Check(occlusionCuller.Initialize(library::OcclusionCuller::DEFAULT_WIDTH, library::OcclusionCuller::DEFAULT_HEIGHT) == S_OK, L"initializing failed"))
+	{
+		return;
+	}
+	library::FrustumCuller frustumCuller;
+
+	UINT uNumInFrustum = 0u;
+	UINT uNumOccluded = 0u;
+	FLOAT rasterMilliseconds = 0.0f;
+	FLOAT testMilliseconds = 0.0f;
+	for (UINT uFrame = 0u; uFrame < NUM_FRAMES; ++uFrame)
+	{
+		// Around the middle of the terrain, looking across it
+		const FLOAT angle = XM_2PI * static_cast<FLOAT>(uFrame) / static_cast<FLOAT>(NUM_FRAMES);
+		const INT iEyeX = TERRAIN_SIZE / 2 + static_cast<INT>(40.0f * std::cos(angle));
+		const INT iEyeZ = TERRAIN_SIZE / 2 + static_cast<INT>(40.0f * std::sin(angle));
+		const XMFLOAT3 ground = getCellCenter(iEyeX, GetTerrainHeight(iEyeX, iEyeZ), iEyeZ);
+		const XMVECTOR eye = XMVectorSet(ground.x, ground.y + 3.0f, ground.z, 1.0f);
+		const XMVECTOR direction = XMVectorSet(-std::sin(angle * 3.0f), -0.1f, std::cos(angle * 3.0f), 0.0f);
+		const XMMATRIX viewProjection = XMMatrixLookToLH(eye, direction, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)) * projection;
+
+		frustumCuller.SetViewProjection(viewProjection);
+		frustumCuller.Reset();
+		for (const library::MeshBounds& bounds : aBounds)
+		{
+			frustumCuller.AddBounds(bounds, XMMatrixIdentity());
+		}
+		uNumInFrustum += frustumCuller.Cull();
+
+		occlusionCuller.SetViewProjection(viewProjection);
+		occlusionCuller.Reset();
+		for (const library::MeshBounds& hull : aHulls)
+		{
+			occlusionCuller.AddOccluderBox(hull, XMMatrixIdentity());
+		}
+		context.Check(occlusionCuller.Rasterize() == S_OK, L"rasterizing frame %u failed", uFrame);
+		uNumOccluded += occlusionCuller.Cull(frustumCuller);
+
+		rasterMilliseconds += occlusionCuller.GetStats().RasterMilliseconds;
+		testMilliseconds += occlusionCuller.GetStats().TestMilliseconds;
+	}
+
+	const FLOAT occludedRate = uNumInFrustum > 0u ? static_cast<FLOAT>(uNumOccluded) / static_cast<FLOAT>(uNumInFrustum) : 0.0f;
+	context.Log(
+		L"%u hulls for %u cells, %.1f%% of %u bounds in the frustum occluded, %.3f ms raster, %.3f ms test per frame, %u worker(s)",
+		static_cast<UINT>(aHulls.size()),
+		static_cast<UINT>(aCells.size()),
+		occludedRate * 100.0f,
+		uNumInFrustum,
+		rasterMilliseconds / static_cast<FLOAT>(NUM_FRAMES),
+		testMilliseconds / static_cast<FLOAT>(NUM_FRAMES),
+		library::JobSystem::GetInstance().GetNumWorkers()
+	);
+	context.Check(uNumOccluded > 0u, L"the hills hide none of %u bounds in the frustum", uNumInFrustum);
+}
@@ -0,0 +1,166 @@
+/*+===================================================================
+  File:      RENDERQUEUETESTS.CPP
+
+  Summary:   Compares the radix sort of the render queue with a
+			 stable sort, checks the field order of the sort keys and
+			 times sorting a frame worth of packets.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <random>
+
+#include "Renderer/RenderQueue.h"
+
+namespace
+{
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: MakePacket
+
+	  Summary:  Returns a packet of no renderable that remembers its
+				push order in the mesh index
+
+	  Args:     UINT uIndex
+				  Push order
+
+	  Returns:  library::DrawPacket
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	library::DrawPacket MakePacket(_In_ UINT uIndex)
+	{
+		return library::DrawPacket
+		{
+			.pRenderable = nullptr,
+			.uMeshIndex = uIndex,
+			.uFirstRange = 0u,
+			.uNumRanges = 0u,
+			.uFirstConstant = 0u,
+			.uFirstSkinningConstant = 0u,
+			.Type = library::eDrawPacketType::RENDERABLE
+		};
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: RenderQueueSortsByKey
+
+  Summary:  Sorts random keys, with many duplicates and with shared
+			digits, and compares the order with a stable sort of the
+			bits that take part, then checks that the fields of
+			MakeKey nest in the documented order and that packets
+			come back in key order
+-----------------------------------------------------------------F-F*/
+TEST_CASE(RenderQueueSortsByKey)
+{
+	std::mt19937 generator(41u);
+	std::uniform_int_distribution<UINT> shader(0u, 7u);
+	std::uniform_int_distribution<UINT> material(0u, 40u);
+	std::uniform_real_distribution<FLOAT> depth(-0.1f, 1.1f);
+	std::uniform_int_distribution<UINT64> any(0ull, ~0ull);
+
+	for (UINT uSize : { 0u, 1u, 2u, 100u, 5000u })
+	{
+		for (UINT uFirstBit : { 0u, 8u, library::RenderQueue::INDEX_BITS })
+		{
+			std::vector<UINT64> aKeys;
+			std::vector<UINT64> aRandomKeys;
+			for (UINT i = 0u; i < uSize; ++i)
+			{
+				const library::eRenderPass pass = i % 50u == 0u ? library::eRenderPass::SKY_PASS : library::eRenderPass::OPAQUE_PASS;
+				aKeys.push_back(library::RenderQueue::MakeKey(pass, shader(generator), shader(generator), material(generator), depth(generator)) | i % 256u);
+				aRandomKeys.push_back(any(generator) >> (i % 3u == 0u ? 40u : 0u));
+			}
+
+			auto compare = [uFirstBit](UINT64 a, UINT64 b) { return (a >> uFirstBit) < (b >> uFirstBit); };
+
+			std::vector<UINT64> aScratch;
+			for (std::vector<UINT64>* paKeys : { &aKeys, &aRandomKeys })
+			{
+				std::vector<UINT64> aExpected = *paKeys;
+				std::stable_sort(aExpected.begin(), aExpected.end(), compare);
+				library::RenderQueue::RadixSort(*paKeys, aScratch, uFirstBit);
+				context.Check(*paKeys == aExpected, L"%u keys from bit %u: radix sort differs from the stable sort", uSize, uFirstBit);
+			}
+		}
+	}
+
+	// The pass decides first, then the shaders, material and depth
+	using library::RenderQueue;
+	using library::eRenderPass;
+	context.Check(RenderQueue::MakeKey(eRenderPass::OPAQUE_PASS, 63u, 63u, 65535u, 1.0f) < RenderQueue::MakeKey(eRenderPass::SKY_PASS, 0u, 0u, 0u, 0.0f), L"pass is not the first field");
+	context.Check(RenderQueue::MakeKey(eRenderPass::OPAQUE_PASS, 1u, 0u, 9u, 0.9f) < RenderQueue::MakeKey(eRenderPass::OPAQUE_PASS, 1u, 1u, 0u, 0.0f), L"shader does not come before material");
+	context.Check(RenderQueue::MakeKey(eRenderPass::OPAQUE_PASS, 1u, 1u, 2u, 0.9f) < RenderQueue::MakeKey(eRenderPass::OPAQUE_PASS, 1u, 1u, 3u, 0.0f), L"material does not come before depth");
+	context.Check(
+		(RenderQueue::MakeKey(eRenderPass::OPAQUE_PASS, 1u, 1u, 2u, 0.25f) >> RenderQueue::INDEX_BITS) < (RenderQueue::MakeKey(eRenderPass::OPAQUE_PASS, 1u, 1u, 2u, 0.5f) >> RenderQueue::INDEX_BITS),
+		L"nearer draws do not come first"
+	);
+
+	// Packets come back in key order, equal keys in push order, and the
+	// queued order is kept for drawing them unsorted
+	RenderQueue queue;
+	const UINT64 aPushKeys[] = { 3ull << 40, 1ull << 40, 3ull << 40, 2ull << 40 };
+	for (UINT i = 0u; i < ARRAYSIZE(aPushKeys); ++i)
+	{
+		queue.Push(aPushKeys[i], MakePacket(i));
+	}
+	queue.Sort();
+
+	const UINT aExpectedMeshes[] = { 1u, 3u, 0u, 2u };
+	if (context.Check(queue.GetNumPackets() == ARRAYSIZE(aExpectedMeshes), L"%u packets queued", queue.GetNumPackets()))
+	{
+		for (UINT i = 0u; i < queue.GetNumPackets(); ++i)
+		{
+			context.Check(queue.GetPacket(i).uMeshIndex == aExpectedMeshes[i], L"packet %u is mesh %u, expected %u", i, queue.GetPacket(i).uMeshIndex, aExpectedMeshes[i]);
+			context.Check(queue.GetQueuedPacket(i).uMeshIndex == i, L"queued packet %u is mesh %u after the sort", i, queue.GetQueuedPacket(i).uMeshIndex);
+		}
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: RenderQueueSort
+
+  Summary:  Sorts packets with keys like a scene of a few shaders,
+			hundreds of materials and random depths, and reports the
+			time of a sort for growing counts. A hundred thousand
+			packets must sort within a millisecond.
+-----------------------------------------------------------------F-F*/
+BENCHMARK_CASE(RenderQueueSort)
+{
+	constexpr UINT NUM_RUNS = 50u;
+	constexpr DOUBLE TARGET_MILLISECONDS = 1.0;
+
+	std::mt19937 generator(41u);
+	std::uniform_int_distribution<UINT> shader(0u, 7u);
+	std::uniform_int_distribution<UINT> material(0u, 500u);
+	std::uniform_real_distribution<FLOAT> depth(0.0f, 1.0f);
+
+	library::RenderQueue queue;
+	for (UINT uNumPackets : { 1000u, 10000u, 100000u })
+	{
+		std::vector<UINT64> aKeys(uNumPackets);
+		for (UINT64& ullKey : aKeys)
+		{
+			ullKey = library::RenderQueue::MakeKey(library::eRenderPass::OPAQUE_PASS, shader(generator), shader(generator), material(generator), depth(generator));
+		}
+
+		DOUBLE milliseconds = 0.0;
+		for (UINT uRun = 0u; uRun < NUM_RUNS; ++uRun)
+		{
+			queue.Reset();
+			for (UINT i = 0u; i < uNumPackets; ++i)
+			{
+				queue.Push(aKeys[i], MakePacket(i));
+			}
+
+			const DOUBLE runMilliseconds = tests::MeasureMilliseconds(1u, [&]() { queue.Sort(); });
+			milliseconds = uRun == 0u ? runMilliseconds : std::min<DOUBLE>(milliseconds, runMilliseconds);
+		}
+
+		context.Log(L"%u packets: %.3f ms per sort", uNumPackets, milliseconds);
+		if (uNumPackets == 100000u)
+		{
+			context.Check(milliseconds < TARGET_MILLISECONDS, L"sorting %u packets took %.3f ms, target %.1f ms", uNumPackets, milliseconds, TARGET_MILLISECONDS);
+		}
+	}
+}
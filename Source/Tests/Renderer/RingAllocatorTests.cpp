@@ -0,0 +1,134 @@
+/*+===================================================================
+  File:      RINGALLOCATORTESTS.CPP
+
+  Summary:   Allocates ranges from a ring allocator as the constant
+			 ring does in a frame and checks where it wraps.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <utility>
+
+#include "Renderer/RingAllocator.h"
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: RingAllocatorWrapsOnlyAtFrameStart
+
+  Summary:  Fills a ring with frames of ranges that may not wrap and
+			checks that each frame wraps once, at its first range,
+			that ranges of a frame never overlap and that the range
+			that no longer fits is refused instead of wrapping
+-----------------------------------------------------------------F-F*/
+TEST_CASE(RingAllocatorWrapsOnlyAtFrameStart)
+{
+	constexpr UINT SIZE = 4096u;
+	constexpr UINT ALIGNMENT = 256u;
+	constexpr UINT NUM_FRAMES = 3u;
+
+	library::RingAllocator allocator;
+	allocator.Reset(SIZE, ALIGNMENT);
+
+	for (UINT uFrame = 0u; uFrame < NUM_FRAMES; ++uFrame)
+	{
+		allocator.Restart();
+
+		UINT uNumWraps = 0u;
+		UINT uNumRanges = 0u;
+		UINT uExpectedOffset = 0u;
+		UINT uOffset = 0u;
+		BOOL bWrapped = FALSE;
+
+		// 300 bytes take 512 of the ring, 8 ranges fit
+		while (allocator.Allocate(300u, FALSE, uOffset, bWrapped))
+		{
+			context.Check(bWrapped == (uNumRanges == 0u), L"frame %u: range %u wrapped %u", uFrame, uNumRanges, bWrapped);
+			context.Check(uOffset == uExpectedOffset, L"frame %u: range %u at %u, expected %u", uFrame, uNumRanges, uOffset, uExpectedOffset);
+
+			uNumWraps += bWrapped ? 1u : 0u;
+			uExpectedOffset += 512u;
+			++uNumRanges;
+
+			if (!context.Check(uNumRanges <= SIZE / 512u, L"frame %u: ring handed out more than it holds", uFrame))
+			{
+				return;
+			}
+		}
+
+		context.Check(uNumRanges == SIZE / 512u && uNumWraps == 1u, L"frame %u: %u ranges and %u wraps", uFrame, uNumRanges, uNumWraps);
+
+		// A range that fits still may not wrap once the ring is full
+		context.Check(!allocator.Allocate(1u, FALSE, uOffset, bWrapped), L"frame %u: full ring handed out a range", uFrame);
+	}
+
+	// Wrapping allowed, the full ring starts over
+	UINT uOffset = 0u;
+	BOOL bWrapped = FALSE;
+	context.Check(allocator.Allocate(1u, TRUE, uOffset, bWrapped) && bWrapped && uOffset == 0u, L"full ring did not wrap when allowed");
+
+	// A refused range does not use up the wrap of a restart
+	allocator.Restart();
+	context.Check(!allocator.Allocate(SIZE + 1u, FALSE, uOffset, bWrapped), L"range larger than the ring was handed out");
+	context.Check(allocator.Allocate(16u, FALSE, uOffset, bWrapped) && bWrapped && uOffset == 0u, L"first range after a refused one did not wrap");
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: RingAllocatorAlignsAndWraps
+
+  Summary:  Allocates ranges of many sizes that may wrap and checks
+			that they are aligned, inside the ring, never overlap a
+			range handed out since the last wrap, and wrap exactly
+			when the next range does not fit
+-----------------------------------------------------------------F-F*/
+TEST_CASE(RingAllocatorAlignsAndWraps)
+{
+	constexpr UINT SIZE = 4096u;
+	constexpr UINT ALIGNMENT = 256u;
+
+	library::RingAllocator allocator;
+	allocator.Reset(SIZE + 100u, ALIGNMENT);
+	context.Check(allocator.GetSize() == SIZE, L"size %u is not rounded down to the alignment", allocator.GetSize());
+
+	UINT uOffset = 0u;
+	BOOL bWrapped = FALSE;
+	context.Check(allocator.Allocate(16u, TRUE, uOffset, bWrapped) && bWrapped && uOffset == 0u, L"first range does not wrap");
+	context.Check(!allocator.Allocate(SIZE + 1u, TRUE, uOffset, bWrapped), L"range larger than the ring was handed out");
+	context.Check(!allocator.Allocate(UINT_MAX, TRUE, uOffset, bWrapped), L"overflowing range was handed out");
+
+	allocator.Reset(SIZE, ALIGNMENT);
+	UINT uExpectedHead = SIZE;
+	UINT uNumWraps = 0u;
+	std::vector<std::pair<UINT, UINT>> aLive;
+	for (UINT i = 0u; i < 1000u; ++i)
+	{
+		const UINT uSize = 1u + (i * 389u) % 1200u;
+		const UINT uAlignedSize = (uSize + ALIGNMENT - 1u) & ~(ALIGNMENT - 1u);
+		const BOOL bExpectWrap = uAlignedSize > SIZE - uExpectedHead;
+
+		if (!context.Check(allocator.Allocate(uSize, TRUE, uOffset, bWrapped), L"range %u of %u bytes that fits was refused", i, uSize))
+		{
+			return;
+		}
+
+		context.Check(bWrapped == bExpectWrap, L"range %u wrapped %u, expected %u", i, bWrapped, bExpectWrap);
+		context.Check(uOffset % ALIGNMENT == 0u, L"range %u at %u is not aligned", i, uOffset);
+		context.Check(uOffset + uAlignedSize <= SIZE, L"range %u ends at %u, past the ring", i, uOffset + uAlignedSize);
+
+		if (bWrapped)
+		{
+			aLive.clear();
+			++uNumWraps;
+		}
+
+		for (const auto& [uLiveOffset, uLiveSize] : aLive)
+		{
+			context.Check(uOffset >= uLiveOffset + uLiveSize || uOffset + uAlignedSize <= uLiveOffset, L"range %u at %u overlaps the live range at %u", i, uOffset, uLiveOffset);
+		}
+
+		aLive.emplace_back(uOffset, uAlignedSize);
+		uExpectedHead = (bExpectWrap ? 0u : uExpectedHead) + uAlignedSize;
+	}
+
+	context.Check(uNumWraps > 1u, L"ring wrapped %u time(s)", uNumWraps);
+}
@@ -0,0 +1,444 @@
+/*+===================================================================
+  File:      SOFTWARERASTERIZERTESTS.CPP
+
+  Summary:   Draws triangles with a known answer with the software
+			 rasterizer and checks the targets, and times drawing an
+			 instanced voxel terrain.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <cmath>
+#include <filesystem>
+
+#include "Job/JobSystem.h"
+#include "Renderer/SoftwareRasterizer.h"
+
+namespace
+{
+	constexpr UINT SIZE = 64u;
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: ToVertex
+
+	  Summary:  Returns a vertex facing the camera at pixel coordinates
+				of the SIZE by SIZE target, for the identity camera.
+				Exact for coordinates snapped to the subpixel grid.
+
+	  Args:     FLOAT x
+				  Column, from the left
+				FLOAT y
+				  Row, from the top
+				FLOAT z
+				  Depth
+
+	  Returns:  library::SimpleVertex
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	library::SimpleVertex ToVertex(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT z)
+	{
+		library::SimpleVertex vertex = {};
+		vertex.Position = XMFLOAT3(x / (SIZE * 0.5f) - 1.0f, 1.0f - y / (SIZE * 0.5f), z);
+		vertex.Normal = XMFLOAT3(0.0f, 0.0f, -1.0f);
+
+		return vertex;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: MakeDraw
+
+	  Summary:  Returns a Phong shaded draw of indexed vertices
+
+	  Args:     const std::vector<library::SimpleVertex>& aVertices
+				  Vertices, kept alive by the caller
+				const std::vector<WORD>& aIndices
+				  Indices, kept alive by the caller
+				const XMFLOAT4& albedo
+				  Color of the draw
+
+	  Returns:  library::SoftwareDraw
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	library::SoftwareDraw MakeDraw(
+		_In_ const std::vector<library::SimpleVertex>& aVertices,
+		_In_ const std::vector<WORD>& aIndices,
+		_In_ const XMFLOAT4& albedo
+	)
+	{
+		return library::SoftwareDraw
+		{
+			.World = XMMatrixIdentity(),
+			.Albedo = albedo,
+			.pVertices = aVertices.data(),
+			.uNumVertices = static_cast<UINT>(aVertices.size()),
+			.pIndices = aIndices.data(),
+			.uNumIndices = static_cast<UINT>(aIndices.size()),
+			.uBaseVertex = 0u,
+			.pInstances = nullptr,
+			.uNumInstances = 0u,
+			.Shading = library::eSoftwareShading::PHONG
+		};
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: CountPixels
+
+	  Summary:  Counts the pixels of the color target of a color
+
+	  Args:     const library::SoftwareRasterizer& rasterizer
+				  Rasterizer to read
+				UINT uColor
+				  RGBA8 color to count
+
+	  Returns:  UINT
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	UINT CountPixels(_In_ const library::SoftwareRasterizer& rasterizer, _In_ UINT uColor)
+	{
+		UINT uCount = 0u;
+		for (UINT y = 0u; y < rasterizer.GetHeight(); ++y)
+		{
+			for (UINT x = 0u; x < rasterizer.GetWidth(); ++x)
+			{
+				uCount += rasterizer.GetPixel(x, y) == uColor ? 1u : 0u;
+			}
+		}
+
+		return uCount;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: MakeCube
+
+	  Summary:  Builds a cube with corners at -1 and 1 like Voxel, four
+				vertices per face so every face has its own normal
+
+	  Args:     std::vector<library::SimpleVertex>& aOutVertices
+				  Receives the 24 vertices
+				std::vector<WORD>& aOutIndices
+				  Receives the 36 indices, clockwise seen from outside
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	void MakeCube(_Out_ std::vector<library::SimpleVertex>& aOutVertices, _Out_ std::vector<WORD>& aOutIndices)
+	{
+		aOutVertices.clear();
+		aOutIndices.clear();
+
+		const XMFLOAT3 aNormals[6] =
+		{
+			XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT3(0.0f, -1.0f, 0.0f),
+			XMFLOAT3(-1.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 0.0f, 0.0f),
+			XMFLOAT3(0.0f, 0.0f, -1.0f), XMFLOAT3(0.0f, 0.0f, 1.0f),
+		};
+		for (const XMFLOAT3& normal : aNormals)
+		{
+			// Two axes across the face, so that u x v points along the normal
+			const XMVECTOR n = XMLoadFloat3(&normal);
+			const XMVECTOR u = fabsf(normal.y) > 0.5f ? XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f) : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+			const XMVECTOR v = XMVector3Cross(n, u);
+
+			const WORD uFirst = static_cast<WORD>(aOutVertices.size());
+			const FLOAT aCorners[4][2] = { { -1.0f, -1.0f }, { -1.0f, 1.0f }, { 1.0f, 1.0f }, { 1.0f, -1.0f } };
+			for (const FLOAT* corner : aCorners)
+			{
+				library::SimpleVertex vertex = {};
+				XMStoreFloat3(&vertex.Position, XMVectorAdd(n, XMVectorAdd(XMVectorScale(u, corner[0]), XMVectorScale(v, corner[1]))));
+				vertex.Normal = normal;
+				aOutVertices.push_back(vertex);
+			}
+
+			aOutIndices.insert(aOutIndices.end(), { uFirst, static_cast<WORD>(uFirst + 1u), static_cast<WORD>(uFirst + 2u), uFirst, static_cast<WORD>(uFirst + 2u), static_cast<WORD>(uFirst + 3u) });
+		}
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: SoftwareRasterizerDrawsKnownTriangles
+
+  Summary:  Draws triangles with a known answer on a small target. A
+			pixel aligned quad covers exactly its pixels, a fan with
+			every triangle meeting at a pixel center has neither
+			holes nor pixels drawn twice, the nearer of two triangles
+			wins in either order, back faces and triangles behind the
+			camera are dropped, two draws tied in depth keep
+			submission order over several batches and a bitmap reads
+			back as it was written
+-----------------------------------------------------------------F-F*/
+TEST_CASE(SoftwareRasterizerDrawsKnownTriangles)
+{
+	using library::SoftwareRasterizer;
+
+	const XMFLOAT4 black(0.0f, 0.0f, 0.0f, 1.0f);
+	const XMFLOAT4 red(1.0f, 0.0f, 0.0f, 1.0f);
+	const XMFLOAT4 green(0.0f, 1.0f, 0.0f, 1.0f);
+
+	SoftwareRasterizer rasterizer;
+	context.Check(FAILED(rasterizer.Render()), L"rendered before Initialize");
+	context.Check(rasterizer.Initialize(0u, SIZE) == E_INVALIDARG, L"empty target was created");
+	if (!context.Check(SUCCEEDED(rasterizer.Initialize(SIZE, SIZE)), L"target could not be created"))
+	{
+		return;
+	}
+
+	// Identity camera and an unlit light, pixels are shaded with the ambient term only
+	const UINT uClearColor = SoftwareRasterizer::PackColor(XMLoadFloat4(&black));
+	const UINT uRed = SoftwareRasterizer::PackColor(XMVectorSet(SoftwareRasterizer::AMBIENT, 0.0f, 0.0f, 1.0f));
+	const UINT uGreen = SoftwareRasterizer::PackColor(XMVectorSet(0.0f, SoftwareRasterizer::AMBIENT, 0.0f, 1.0f));
+	rasterizer.SetCamera(XMMatrixIdentity(), XMMatrixIdentity(), XMVectorSet(0.0f, 0.0f, -1.0f, 1.0f));
+	rasterizer.SetLight({ .Position = XMFLOAT4(0.0f, 0.0f, -1.0f, 1.0f), .Color = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f) });
+
+	// A quad on pixel edges, split along its diagonal
+	const std::vector<library::SimpleVertex> aQuad = { ToVertex(16.0f, 16.0f, 0.5f), ToVertex(48.0f, 16.0f, 0.5f), ToVertex(48.0f, 48.0f, 0.5f), ToVertex(16.0f, 48.0f, 0.5f) };
+	const std::vector<WORD> aQuadIndices = { 0u, 1u, 2u, 0u, 2u, 3u };
+	rasterizer.Clear(black);
+	rasterizer.AddDraw(MakeDraw(aQuad, aQuadIndices, red));
+	rasterizer.Render();
+	context.Check(
+		rasterizer.GetStats().uNumCoveredPixels == 1024ull && rasterizer.GetStats().uNumShadedPixels == 1024ull,
+		L"quad covered %llu and shaded %llu pixels, expected 1024", rasterizer.GetStats().uNumCoveredPixels, rasterizer.GetStats().uNumShadedPixels
+	);
+	context.Check(CountPixels(rasterizer, uRed) == 1024u, L"%u quad pixels are shaded by the ambient term", CountPixels(rasterizer, uRed));
+	context.Check(rasterizer.GetPixel(16u, 16u) == uRed && rasterizer.GetPixel(47u, 47u) == uRed, L"quad corners are missing");
+	context.Check(
+		rasterizer.GetPixel(15u, 16u) == uClearColor && rasterizer.GetPixel(48u, 47u) == uClearColor && rasterizer.GetPixel(16u, 48u) == uClearColor,
+		L"pixels outside of the quad are drawn"
+	);
+
+	// The same quad facing away
+	const std::vector<WORD> aBackIndices = { 0u, 2u, 1u, 0u, 3u, 2u };
+	rasterizer.Reset();
+	rasterizer.Clear(black);
+	rasterizer.AddDraw(MakeDraw(aQuad, aBackIndices, red));
+	rasterizer.Render();
+	context.Check(rasterizer.GetStats().uNumCulledTriangles == 2u && CountPixels(rasterizer, uClearColor) == SIZE * SIZE, L"back faces are drawn");
+
+	// A fan of uneven slices around a pixel center, which every slice touches
+	constexpr UINT NUM_SLICES = 37u;
+	const FLOAT centerX = 32.5f;
+	const FLOAT centerY = 32.5f;
+	std::vector<XMFLOAT2> aRim;
+	std::vector<library::SimpleVertex> aFan = { ToVertex(centerX, centerY, 0.5f) };
+	for (UINT i = 0u; i < NUM_SLICES; ++i)
+	{
+		const FLOAT angle = XM_2PI * (static_cast<FLOAT>(i) + 0.3f * sinf(static_cast<FLOAT>(i) * 1.7f)) / NUM_SLICES;
+		const FLOAT x = roundf((centerX + 27.0f * cosf(angle)) * SoftwareRasterizer::SUBPIXEL_STEPS) / SoftwareRasterizer::SUBPIXEL_STEPS;
+		const FLOAT y = roundf((centerY + 27.0f * sinf(angle)) * SoftwareRasterizer::SUBPIXEL_STEPS) / SoftwareRasterizer::SUBPIXEL_STEPS;
+		aRim.push_back(XMFLOAT2(x, y));
+		aFan.push_back(ToVertex(x, y, 0.5f));
+	}
+	std::vector<WORD> aFanIndices;
+	for (UINT i = 0u; i < NUM_SLICES; ++i)
+	{
+		aFanIndices.insert(aFanIndices.end(), { 0u, static_cast<WORD>(1u + i), static_cast<WORD>(1u + (i + 1u) % NUM_SLICES) });
+	}
+	rasterizer.Reset();
+	rasterizer.Clear(black);
+	rasterizer.AddDraw(MakeDraw(aFan, aFanIndices, red));
+	rasterizer.Render();
+	context.Check(
+		rasterizer.GetStats().uNumCoveredPixels == rasterizer.GetStats().uNumShadedPixels,
+		L"fan covered %llu pixels but shaded %llu", rasterizer.GetStats().uNumCoveredPixels, rasterizer.GetStats().uNumShadedPixels
+	);
+	context.Check(rasterizer.GetPixel(32u, 32u) == uRed, L"fan center is missing");
+
+	// Pixels clearly inside of the rim must be drawn, pixels clearly outside must not
+	UINT uNumWrong = 0u;
+	for (UINT y = 0u; y < SIZE; ++y)
+	{
+		for (UINT x = 0u; x < SIZE; ++x)
+		{
+			FLOAT minDistance = FLT_MAX;
+			for (UINT i = 0u; i < NUM_SLICES; ++i)
+			{
+				const XMFLOAT2& a = aRim[i];
+				const XMFLOAT2& b = aRim[(i + 1u) % NUM_SLICES];
+				const FLOAT length = sqrtf((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+				const FLOAT distance = ((b.x - a.x) * (y + 0.5f - a.y) - (b.y - a.y) * (x + 0.5f - a.x)) / length;
+				minDistance = std::min(minDistance, distance);
+			}
+
+			const BOOL bIsDrawn = rasterizer.GetPixel(x, y) == uRed;
+			if ((minDistance > 0.01f && !bIsDrawn) || (minDistance < -0.01f && bIsDrawn))
+			{
+				++uNumWrong;
+			}
+		}
+	}
+	context.Check(uNumWrong == 0u, L"fan differs from the polygon it covers at %u pixels", uNumWrong);
+
+	// The nearer triangle wins whichever is drawn first
+	const std::vector<library::SimpleVertex> aNear = { ToVertex(0.0f, 0.0f, 0.3f), ToVertex(64.0f, 0.0f, 0.3f), ToVertex(0.0f, 64.0f, 0.3f) };
+	const std::vector<library::SimpleVertex> aFar = { ToVertex(0.0f, 0.0f, 0.6f), ToVertex(64.0f, 0.0f, 0.6f), ToVertex(0.0f, 64.0f, 0.6f) };
+	const std::vector<WORD> aTriangleIndices = { 0u, 1u, 2u };
+	const std::vector<WORD> aReversedIndices = { 0u, 2u, 1u };
+	for (UINT uOrder = 0u; uOrder < 2u; ++uOrder)
+	{
+		rasterizer.Reset();
+		rasterizer.Clear(black);
+		rasterizer.AddDraw(MakeDraw(uOrder == 0u ? aNear : aFar, aTriangleIndices, uOrder == 0u ? green : red));
+		rasterizer.AddDraw(MakeDraw(uOrder == 0u ? aFar : aNear, aTriangleIndices, uOrder == 0u ? red : green));
+		rasterizer.Render();
+		context.Check(rasterizer.GetPixel(10u, 10u) == uGreen && CountPixels(rasterizer, uRed) == 0u, L"order %u: farther triangle is drawn over the nearer one", uOrder);
+	}
+
+	// Two draws tied in depth, split over batches, the first one drawn must stay
+	constexpr UINT NUM_INSTANCES = 2100u;
+	std::vector<library::InstanceData> aInstances(NUM_INSTANCES);
+	for (UINT i = 0u; i < NUM_INSTANCES; ++i)
+	{
+		aInstances[i].Transformation = XMMatrixScaling(0.25f, 0.25f, 1.0f) * XMMatrixTranslation(static_cast<FLOAT>(i % 13u) * 0.11f - 0.7f, static_cast<FLOAT>(i % 11u) * 0.13f - 0.7f, 0.0f);
+	}
+	library::SoftwareDraw first = MakeDraw(aQuad, aQuadIndices, red);
+	first.pInstances = aInstances.data();
+	first.uNumInstances = NUM_INSTANCES;
+	library::SoftwareDraw second = first;
+	second.Albedo = green;
+
+	std::vector<UINT> aFirstImage;
+	rasterizer.Reset();
+	rasterizer.AddDraw(first);
+	rasterizer.AddDraw(second);
+	for (UINT uRepeat = 0u; uRepeat < 3u; ++uRepeat)
+	{
+		rasterizer.Clear(black);
+		rasterizer.Render();
+		if (uRepeat == 0u)
+		{
+			rasterizer.ReadPixels(aFirstImage);
+			context.Check(rasterizer.GetStats().uNumBatches > 2u, L"instances were split into %u batch(es)", rasterizer.GetStats().uNumBatches);
+			context.Check(CountPixels(rasterizer, uGreen) == 0u && CountPixels(rasterizer, uRed) > 0u, L"draws tied in depth are not drawn in order");
+		}
+		context.Check(rasterizer.CountDifferentPixels(aFirstImage, 0u) == 0u, L"render %u differs from the first", uRepeat);
+	}
+
+	// Behind the camera, through the near plane and far outside of the guard band
+	const std::vector<library::SimpleVertex> aCrossing = { ToVertex(0.0f, 0.0f, -5.0f), ToVertex(4000.0f, 32.0f, 10.0f), ToVertex(-4000.0f, 64.0f, 10.0f) };
+	const std::vector<library::SimpleVertex> aBehind = { ToVertex(0.0f, 0.0f, -5.0f), ToVertex(64.0f, 0.0f, -5.0f), ToVertex(0.0f, 64.0f, -4.0f) };
+	rasterizer.SetCamera(XMMatrixIdentity(), XMMatrixPerspectiveFovLH(XM_PIDIV2, 1.0f, 0.1f, 100.0f), XMVectorZero());
+	rasterizer.Reset();
+	rasterizer.Clear(black);
+	rasterizer.AddDraw(MakeDraw(aBehind, aTriangleIndices, red));
+	rasterizer.Render();
+	context.Check(rasterizer.GetStats().uNumRasterizedTriangles == 0u && CountPixels(rasterizer, uClearColor) == SIZE * SIZE, L"triangle behind the camera is drawn");
+
+	rasterizer.Reset();
+	rasterizer.Clear(black);
+	rasterizer.AddDraw(MakeDraw(aCrossing, aTriangleIndices, red));
+	rasterizer.AddDraw(MakeDraw(aCrossing, aReversedIndices, red));
+	rasterizer.Render();
+	BOOL bIsDepthInRange = TRUE;
+	for (UINT y = 0u; y < SIZE; ++y)
+	{
+		for (UINT x = 0u; x < SIZE; ++x)
+		{
+			const FLOAT depth = rasterizer.GetDepth(x, y);
+			bIsDepthInRange &= depth >= 0.0f && depth <= 1.0f;
+		}
+	}
+	context.Check(
+		rasterizer.GetStats().uNumClippedTriangles == 2u && rasterizer.GetStats().uNumShadedPixels > 0u,
+		L"%u triangle(s) through the near plane clipped", rasterizer.GetStats().uNumClippedTriangles
+	);
+	context.Check(bIsDepthInRange, L"clipped triangle wrote depths outside of the view volume");
+
+	// A bitmap reads back as it was written
+	const std::filesystem::path bitmapPath = std::filesystem::temp_directory_path() / L"SoftwareRasterizerTests.bmp";
+	std::vector<UINT> aImage;
+	std::vector<UINT> aReadImage;
+	UINT uReadWidth = 0u;
+	UINT uReadHeight = 0u;
+	rasterizer.ReadPixels(aImage);
+	context.Check(
+		SUCCEEDED(rasterizer.SaveBitmap(bitmapPath)) && SUCCEEDED(SoftwareRasterizer::ReadBitmap(bitmapPath, aReadImage, uReadWidth, uReadHeight)),
+		L"bitmap could not be written and read"
+	);
+	context.Check(uReadWidth == SIZE && uReadHeight == SIZE && aReadImage == aImage, L"bitmap differs from the target");
+	std::error_code error;
+	std::filesystem::remove(bitmapPath, error);
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: SoftwareRasterizerPixelRate
+
+  Summary:  Draws a lit voxel terrain of instanced cubes seen from
+			above its edge at growing target sizes and reports the
+			time of the geometry and raster passes and the shaded
+			pixel rate
+-----------------------------------------------------------------F-F*/
+BENCHMARK_CASE(SoftwareRasterizerPixelRate)
+{
+	constexpr UINT NUM_COLUMNS = 64u;
+	constexpr UINT NUM_FRAMES = 5u;
+	constexpr FLOAT VOXEL_SIZE = 2.0f;
+
+	std::vector<library::SimpleVertex> aVertices;
+	std::vector<WORD> aIndices;
+	MakeCube(aVertices, aIndices);
+
+	std::vector<library::InstanceData> aInstances;
+	for (UINT x = 0u; x < NUM_COLUMNS; ++x)
+	{
+		for (UINT z = 0u; z < NUM_COLUMNS; ++z)
+		{
+			const UINT uHeight = 1u + (x * 7u + z * 13u) % 10u;
+			for (UINT y = 0u; y < uHeight; ++y)
+			{
+				aInstances.push_back(
+					library::InstanceData
+					{
+						.Transformation = XMMatrixTranslation(
+							VOXEL_SIZE * (static_cast<FLOAT>(x) - NUM_COLUMNS / 2.0f),
+							VOXEL_SIZE * static_cast<FLOAT>(y),
+							VOXEL_SIZE * (static_cast<FLOAT>(z) - NUM_COLUMNS / 2.0f)
+						),
+						.BlockSlice = 0u
+					}
+				);
+			}
+		}
+	}
+
+	library::SoftwareDraw terrain = MakeDraw(aVertices, aIndices, XMFLOAT4(0.4f, 0.7f, 0.3f, 1.0f));
+	terrain.pInstances = aInstances.data();
+	terrain.uNumInstances = static_cast<UINT>(aInstances.size());
+
+	const XMVECTOR eye = XMVectorSet(0.0f, 40.0f, -90.0f, 1.0f);
+	const XMMATRIX view = XMMatrixLookAtLH(eye, XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+
+	for (const XMUINT2& size : { XMUINT2(320u, 180u), XMUINT2(640u, 360u), XMUINT2(1280u, 720u) })
+	{
+		library::SoftwareRasterizer rasterizer;
+		if (!context.Check(SUCCEEDED(rasterizer.Initialize(size.x, size.y)), L"%ux%u target could not be created", size.x, size.y))
+		{
+			return;
+		}
+
+		rasterizer.SetCamera(view, XMMatrixPerspectiveFovLH(XM_PIDIV4, static_cast<FLOAT>(size.x) / static_cast<FLOAT>(size.y), 0.1f, 1000.0f), eye);
+		rasterizer.SetLight({ .Position = XMFLOAT4(0.0f, 100.0f, -50.0f, 1.0f), .Color = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f) });
+		rasterizer.AddDraw(terrain);
+
+		FLOAT geometryMilliseconds = FLT_MAX;
+		FLOAT rasterMilliseconds = FLT_MAX;
+		const DOUBLE milliseconds = tests::MeasureMilliseconds(NUM_FRAMES, [&]()
+			{
+				rasterizer.Clear(XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+				rasterizer.Render();
+				geometryMilliseconds = std::min(geometryMilliseconds, rasterizer.GetStats().GeometryMilliseconds);
+				rasterMilliseconds = std::min(rasterMilliseconds, rasterizer.GetStats().RasterMilliseconds);
+			}
+		);
+
+		const library::SoftwareRasterStats& stats = rasterizer.GetStats();
+		context.Check(stats.uNumShadedPixels > 0ull, L"%ux%u: nothing was drawn", size.x, size.y);
+		context.Log(
+			L"%ux%u, %u worker(s): %.2f ms per frame, geometry %.2f ms, raster %.2f ms, %u of %u triangles rasterized, %.2f Mpixels/s shaded",
+			size.x,
+			size.y,
+			library::JobSystem::GetInstance().GetNumWorkers(),
+			milliseconds,
+			geometryMilliseconds,
+			rasterMilliseconds,
+			stats.uNumRasterizedTriangles,
+			stats.uNumInputTriangles,
+			static_cast<DOUBLE>(stats.uNumShadedPixels) / (milliseconds * 1000.0)
+		);
+	}
+}
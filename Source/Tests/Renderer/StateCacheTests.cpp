@@ -0,0 +1,153 @@
+/*+===================================================================
+  File:      STATECACHETESTS.CPP
+
+  Summary:   Replays binds on a state cache over a context that
+			 counts the binds reaching it and checks which of them
+			 the cache drops.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include "Renderer/StateCache.h"
+
+namespace
+{
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    CountingContext
+
+	  Summary:  Stands in for a render context and only counts the
+				binds that reach it
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class CountingContext final
+	{
+	public:
+		void IASetInputLayout(library::GpuInputLayout*) { ++uNumCalls; }
+		void IASetVertexBuffers(UINT, UINT, library::GpuBuffer* const*, const UINT*, const UINT*) { ++uNumCalls; }
+		void IASetIndexBuffer(library::GpuBuffer*, DXGI_FORMAT, UINT) { ++uNumCalls; }
+		void IASetPrimitiveTopology(library::ePrimitiveTopology) { ++uNumCalls; }
+		void VSSetShader(library::GpuVertexShader*) { ++uNumCalls; }
+		void PSSetShader(library::GpuPixelShader*) { ++uNumCalls; }
+		void VSSetConstantBuffers(UINT, UINT, library::GpuBuffer* const*) { ++uNumCalls; }
+		void PSSetConstantBuffers(UINT, UINT, library::GpuBuffer* const*) { ++uNumCalls; }
+		void VSSetShaderResources(UINT, UINT, library::GpuShaderResourceView* const*) { ++uNumCalls; }
+		void PSSetShaderResources(UINT, UINT, library::GpuShaderResourceView* const*) { ++uNumCalls; }
+		void PSSetSamplers(UINT, UINT, library::GpuSamplerState* const*) { ++uNumCalls; }
+
+		UINT uNumCalls = 0u;
+	};
+
+	using CountingStateCache = library::BasicStateCache<CountingContext>;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: StateCacheFiltersRedundantBinds
+
+  Summary:  Binds fake objects through the cache and checks the
+			number of binds that reach the context after each group,
+			and the forwarded and filtered counters
+-----------------------------------------------------------------F-F*/
+TEST_CASE(StateCacheFiltersRedundantBinds)
+{
+	CountingContext countingContext;
+	CountingStateCache cache;
+	cache.SetContext(&countingContext);
+
+	auto expect = [&](UINT uNumCalls, PCWSTR pszWhat)
+	{
+		context.Check(countingContext.uNumCalls == uNumCalls, L"%ls: %u of %u binds reached the context", pszWhat, countingContext.uNumCalls, uNumCalls);
+		countingContext.uNumCalls = 0u;
+	};
+
+	// Fake objects, only their addresses are compared
+	BYTE aObjects[8] = {};
+	library::GpuBuffer* pBufferA = reinterpret_cast<library::GpuBuffer*>(&aObjects[0]);
+	library::GpuBuffer* pBufferB = reinterpret_cast<library::GpuBuffer*>(&aObjects[1]);
+	library::GpuVertexShader* pVertexShader = reinterpret_cast<library::GpuVertexShader*>(&aObjects[2]);
+	library::GpuPixelShader* pPixelShader = reinterpret_cast<library::GpuPixelShader*>(&aObjects[3]);
+	library::GpuShaderResourceView* pViewA = reinterpret_cast<library::GpuShaderResourceView*>(&aObjects[4]);
+	library::GpuShaderResourceView* pViewB = reinterpret_cast<library::GpuShaderResourceView*>(&aObjects[5]);
+	library::GpuSamplerState* pSampler = reinterpret_cast<library::GpuSamplerState*>(&aObjects[6]);
+	library::GpuInputLayout* pInputLayout = reinterpret_cast<library::GpuInputLayout*>(&aObjects[7]);
+
+	// Unknown slots are always forwarded, even when binding null
+	library::GpuShaderResourceView* pNullView = nullptr;
+	cache.PSSetShaderResources(0u, 1u, &pNullView);
+	expect(1u, L"first bind of a slot");
+
+	cache.VSSetShader(pVertexShader);
+	cache.VSSetShader(pVertexShader);
+	cache.PSSetShader(pPixelShader);
+	cache.PSSetShader(pPixelShader);
+	cache.IASetInputLayout(pInputLayout);
+	cache.IASetInputLayout(pInputLayout);
+	cache.IASetPrimitiveTopology(library::ePrimitiveTopology::TRIANGLE_LIST);
+	cache.IASetPrimitiveTopology(library::ePrimitiveTopology::TRIANGLE_LIST);
+	expect(4u, L"repeated shader, layout and topology");
+
+	cache.IASetIndexBuffer(pBufferA, DXGI_FORMAT_R16_UINT, 0u);
+	cache.IASetIndexBuffer(pBufferA, DXGI_FORMAT_R16_UINT, 0u);
+	cache.IASetIndexBuffer(pBufferA, DXGI_FORMAT_R32_UINT, 0u);
+	expect(2u, L"index buffer format change");
+
+	// A range is dropped only when every slot matches
+	library::GpuShaderResourceView* aViews[] = { pViewA, pViewB };
+	cache.PSSetShaderResources(0u, 2u, aViews);
+	cache.PSSetShaderResources(1u, 1u, &pViewB);
+	cache.PSSetShaderResources(0u, 2u, aViews);
+	expect(1u, L"bound view range");
+
+	aViews[1] = pViewA;
+	cache.PSSetShaderResources(0u, 2u, aViews);
+	expect(1u, L"partly changed view range");
+
+	UINT aStrides[] = { 16u, 12u };
+	UINT aOffsets[] = { 0u, 0u };
+	library::GpuBuffer* aVertexBuffers[] = { pBufferA, pBufferB };
+	cache.IASetVertexBuffers(0u, 2u, aVertexBuffers, aStrides, aOffsets);
+	cache.IASetVertexBuffers(0u, 2u, aVertexBuffers, aStrides, aOffsets);
+	aStrides[1] = 24u;
+	cache.IASetVertexBuffers(0u, 2u, aVertexBuffers, aStrides, aOffsets);
+	expect(2u, L"vertex buffer stride change");
+
+	// Vertex and pixel stage slots are separate
+	cache.VSSetConstantBuffers(2u, 1u, &pBufferA);
+	cache.PSSetConstantBuffers(2u, 1u, &pBufferA);
+	cache.VSSetConstantBuffers(2u, 1u, &pBufferA);
+	cache.PSSetSamplers(0u, 1u, &pSampler);
+	cache.PSSetSamplers(0u, 1u, &pSampler);
+	expect(3u, L"constant buffers and samplers");
+
+	// Pixel shader slot 0 holds pViewA, the vertex shader one does not
+	cache.VSSetShaderResources(0u, 1u, &pViewA);
+	cache.VSSetShaderResources(0u, 1u, &pViewA);
+	expect(1u, L"vertex shader views");
+
+	// Slots past the tracked ones are never dropped
+	cache.PSSetShaderResources(CountingStateCache::MAX_SHADER_RESOURCES, 1u, &pViewA);
+	cache.PSSetShaderResources(CountingStateCache::MAX_SHADER_RESOURCES, 1u, &pViewA);
+	cache.PSSetShaderResources(CountingStateCache::MAX_SHADER_RESOURCES - 1u, 2u, aViews);
+	cache.PSSetShaderResources(CountingStateCache::MAX_SHADER_RESOURCES - 1u, 2u, aViews);
+	expect(4u, L"untracked slots");
+
+	cache.InvalidateConstantBuffers(2u, 1u);
+	cache.VSSetConstantBuffers(2u, 1u, &pBufferA);
+	cache.PSSetConstantBuffers(2u, 1u, &pBufferA);
+	cache.PSSetSamplers(0u, 1u, &pSampler);
+	expect(2u, L"constant buffers after invalidating their slot");
+
+	cache.Invalidate();
+	cache.VSSetShader(pVertexShader);
+	cache.PSSetSamplers(0u, 1u, &pSampler);
+	cache.VSSetShaderResources(0u, 1u, &pViewA);
+	expect(3u, L"binds after Invalidate");
+
+	context.Check(
+		cache.GetNumForwardedCalls() == 24u && cache.GetNumFilteredCalls() == 12u,
+		L"%u forwarded and %u filtered binds counted", cache.GetNumForwardedCalls(), cache.GetNumFilteredCalls()
+	);
+
+	cache.ResetCounters();
+	context.Check(cache.GetNumForwardedCalls() == 0u && cache.GetNumFilteredCalls() == 0u, L"counters were not reset");
+}
@@ -0,0 +1,524 @@
+/*+===================================================================
+  File:      AABBTREETESTS.CPP
+
+  Summary:   Inserts, moves and removes random boxes in the scene
+			 tree and compares its frustum, sphere, box and ray
+			 queries with linear scans of the same boxes, and times
+			 both.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "Scene/AabbTree.h"
+
+namespace
+{
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: IsInFrustum
+
+	  Summary:  Linear scan test of a box against frustum planes, by
+				the distance of its center and its projected radius
+
+	  Args:     const XMFLOAT4A* aPlanes
+				  Frustum planes, normals pointing inside
+				const library::Aabb& box
+				  Box to test
+
+	  Returns:  BOOL
+				  TRUE if the box is not behind any plane
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	BOOL IsInFrustum(_In_reads_(library::FrustumCuller::NUM_PLANES) const XMFLOAT4A* aPlanes, _In_ const library::Aabb& box)
+	{
+		const XMFLOAT3 center((box.Min.x + box.Max.x) * 0.5f, (box.Min.y + box.Max.y) * 0.5f, (box.Min.z + box.Max.z) * 0.5f);
+		const XMFLOAT3 extents((box.Max.x - box.Min.x) * 0.5f, (box.Max.y - box.Min.y) * 0.5f, (box.Max.z - box.Min.z) * 0.5f);
+
+		for (UINT i = 0u; i < library::FrustumCuller::NUM_PLANES; ++i)
+		{
+			const XMFLOAT4A& plane = aPlanes[i];
+			const FLOAT distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+			const FLOAT projectedRadius = fabsf(plane.x) * extents.x + fabsf(plane.y) * extents.y + fabsf(plane.z) * extents.z;
+			if (distance + projectedRadius < 0.0f)
+			{
+				return FALSE;
+			}
+		}
+
+		return TRUE;
+	}
+
+	BOOL Overlaps(_In_ const library::Aabb& a, _In_ const library::Aabb& b)
+	{
+		return a.Min.x <= b.Max.x && b.Min.x <= a.Max.x
+			&& a.Min.y <= b.Max.y && b.Min.y <= a.Max.y
+			&& a.Min.z <= b.Max.z && b.Min.z <= a.Max.z;
+	}
+
+	BOOL OverlapsSphere(_In_ const library::Aabb& box, _In_ const XMFLOAT3& center, _In_ FLOAT radius)
+	{
+		const FLOAT dx = std::max<FLOAT>(std::max<FLOAT>(box.Min.x - center.x, center.x - box.Max.x), 0.0f);
+		const FLOAT dy = std::max<FLOAT>(std::max<FLOAT>(box.Min.y - center.y, center.y - box.Max.y), 0.0f);
+		const FLOAT dz = std::max<FLOAT>(std::max<FLOAT>(box.Min.z - center.z, center.z - box.Max.z), 0.0f);
+		return dx * dx + dy * dy + dz * dz <= radius * radius;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: IntersectRay
+
+	  Summary:  Linear scan slab test of a ray against a box
+
+	  Args:     const library::Aabb& box
+				  Box to test
+				const XMFLOAT3& origin
+				  Start of the ray
+				const XMFLOAT3& direction
+				  Unit direction of the ray
+				FLOAT maxDistance
+				  Farthest distance that counts as a hit
+				FLOAT& outDistance
+				  Distance the ray enters the box, 0 if it starts
+				  inside
+
+	  Returns:  BOOL
+				  TRUE if the ray enters the box within maxDistance
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	BOOL IntersectRay(
+		_In_ const library::Aabb& box,
+		_In_ const XMFLOAT3& origin,
+		_In_ const XMFLOAT3& direction,
+		_In_ FLOAT maxDistance,
+		_Out_ FLOAT& outDistance
+	)
+	{
+		FLOAT tMin = 0.0f;
+		FLOAT tMax = maxDistance;
+
+		const FLOAT aMin[3] = { box.Min.x, box.Min.y, box.Min.z };
+		const FLOAT aMax[3] = { box.Max.x, box.Max.y, box.Max.z };
+		const FLOAT aOrigin[3] = { origin.x, origin.y, origin.z };
+		const FLOAT aDirection[3] = { direction.x, direction.y, direction.z };
+		for (UINT i = 0u; i < 3u; ++i)
+		{
+			const FLOAT t1 = (aMin[i] - aOrigin[i]) / aDirection[i];
+			const FLOAT t2 = (aMax[i] - aOrigin[i]) / aDirection[i];
+			tMin = std::max<FLOAT>(tMin, std::min<FLOAT>(t1, t2));
+			tMax = std::min<FLOAT>(tMax, std::max<FLOAT>(t1, t2));
+		}
+
+		outDistance = tMin;
+		return tMin <= tMax;
+	}
+
+	XMFLOAT3 RandomPoint(_Inout_ std::mt19937& generator, _In_ FLOAT worldSize)
+	{
+		std::uniform_real_distribution<FLOAT> position(-worldSize * 0.5f, worldSize * 0.5f);
+
+		return XMFLOAT3(position(generator), position(generator), position(generator));
+	}
+
+	library::Aabb RandomBox(_Inout_ std::mt19937& generator, _In_ FLOAT worldSize, _In_ FLOAT minExtent, _In_ FLOAT maxExtent)
+	{
+		std::uniform_real_distribution<FLOAT> extent(minExtent, maxExtent);
+
+		const XMFLOAT3 center = RandomPoint(generator, worldSize);
+		const XMFLOAT3 extents(extent(generator), extent(generator), extent(generator));
+		return library::Aabb
+		{
+			.Min = XMFLOAT3(center.x - extents.x, center.y - extents.y, center.z - extents.z),
+			.Max = XMFLOAT3(center.x + extents.x, center.y + extents.y, center.z + extents.z)
+		};
+	}
+
+	library::Aabb TranslateBox(_In_ const library::Aabb& box, _In_ const XMFLOAT3& offset)
+	{
+		return library::Aabb
+		{
+			.Min = XMFLOAT3(box.Min.x + offset.x, box.Min.y + offset.y, box.Min.z + offset.z),
+			.Max = XMFLOAT3(box.Max.x + offset.x, box.Max.y + offset.y, box.Max.z + offset.z)
+		};
+	}
+
+	void RandomFrustum(_Inout_ std::mt19937& generator, _In_ FLOAT worldSize, _In_ FLOAT farDistance, _Inout_ library::FrustumCuller& culler)
+	{
+		std::uniform_real_distribution<FLOAT> direction(-1.0f, 1.0f);
+
+		const XMFLOAT3 position = RandomPoint(generator, worldSize);
+		const XMVECTOR eye = XMVectorSet(position.x, position.y, position.z, 1.0f);
+		XMVECTOR forward = XMVectorSet(direction(generator), direction(generator) * 0.5f, direction(generator), 0.0f);
+		forward = XMVectorGetX(XMVector3Length(forward)) > 0.01f ? forward : XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+
+		culler.SetViewProjection(
+			XMMatrixLookAtLH(eye, XMVectorAdd(eye, forward), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f))
+			* XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, farDistance)
+		);
+	}
+
+	XMFLOAT3 RandomDirection(_Inout_ std::mt19937& generator)
+	{
+		std::uniform_real_distribution<FLOAT> direction(-1.0f, 1.0f);
+
+		XMVECTOR vector = XMVectorSet(direction(generator), direction(generator), direction(generator), 0.0f);
+		vector = XMVectorGetX(XMVector3Length(vector)) > 0.01f ? vector : XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+
+		XMFLOAT3 result;
+		XMStoreFloat3(&result, XMVector3Normalize(vector));
+		return result;
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: AabbTreeMatchesLinearScan
+
+  Summary:  Inserts, moves and removes random boxes and checks the
+			structure and balance of the tree, then compares random
+			frustum, sphere, box and ray queries with a linear scan
+			of the same boxes
+-----------------------------------------------------------------F-F*/
+TEST_CASE(AabbTreeMatchesLinearScan)
+{
+	constexpr UINT NUM_OBJECTS = 2000u;
+	constexpr UINT NUM_QUERIES = 64u;
+	constexpr UINT NUM_MOVE_FRAMES = 4u;
+	constexpr FLOAT WORLD_SIZE = 200.0f;
+
+	struct Reference
+	{
+		library::Aabb Box;
+		UINT uProxy;
+		BOOL bIsAlive;
+	};
+
+	std::mt19937 generator(40u);
+	std::uniform_real_distribution<FLOAT> step(-3.0f, 3.0f);
+
+	library::AabbTree tree;
+	std::vector<Reference> aReferences;
+	for (UINT i = 0u; i < NUM_OBJECTS; ++i)
+	{
+		const library::Aabb box = RandomBox(generator, WORLD_SIZE, 0.5f, 4.0f);
+		aReferences.push_back(Reference{ .Box = box, .uProxy = tree.Insert(box, nullptr), .bIsAlive = TRUE });
+	}
+
+	// Small steps mostly stay inside the fat boxes, a few jumps do not
+	UINT uNumReinserted = 0u;
+	for (UINT uFrame = 0u; uFrame < NUM_MOVE_FRAMES; ++uFrame)
+	{
+		for (Reference& reference : aReferences)
+		{
+			const FLOAT scale = (reference.uProxy % 16u == uFrame) ? 20.0f : 0.1f;
+			reference.Box = TranslateBox(reference.Box, XMFLOAT3(step(generator) * scale, step(generator) * scale, step(generator) * scale));
+			uNumReinserted += tree.Move(reference.uProxy, reference.Box) ? 1u : 0u;
+		}
+	}
+	context.Check(
+		0u < uNumReinserted && uNumReinserted < NUM_MOVE_FRAMES * NUM_OBJECTS / 2u,
+		L"%u of %u moves reinserted, only the leaves leaving their fat box should be", uNumReinserted, NUM_MOVE_FRAMES * NUM_OBJECTS
+	);
+
+	for (UINT i = 0u; i < aReferences.size(); i += 5u)
+	{
+		tree.Remove(aReferences[i].uProxy);
+		aReferences[i].bIsAlive = FALSE;
+	}
+	for (UINT i = 0u; i < NUM_OBJECTS / 10u; ++i)
+	{
+		const library::Aabb box = RandomBox(generator, WORLD_SIZE, 0.5f, 4.0f);
+		aReferences.push_back(Reference{ .Box = box, .uProxy = tree.Insert(box, nullptr), .bIsAlive = TRUE });
+	}
+
+	UINT uNumAlive = 0u;
+	BOOL bBoundsMatch = TRUE;
+	for (const Reference& reference : aReferences)
+	{
+		if (reference.bIsAlive)
+		{
+			const library::Aabb& bounds = tree.GetBounds(reference.uProxy);
+			bBoundsMatch &= bounds.Min.x == reference.Box.Min.x && bounds.Max.z == reference.Box.Max.z;
+			++uNumAlive;
+		}
+	}
+	context.Check(tree.IsValid(), L"the tree structure is broken");
+	context.Check(bBoundsMatch, L"proxies do not hold the boxes they were moved to");
+	context.Check(tree.GetNumProxies() == uNumAlive, L"%u proxies, %u alive", tree.GetNumProxies(), uNumAlive);
+	context.Check(
+		tree.GetHeight() <= 2 * static_cast<INT>(log2f(static_cast<FLOAT>(uNumAlive))) + 2,
+		L"height %d for %u proxies, the tree is not balanced", tree.GetHeight(), uNumAlive
+	);
+
+	std::vector<UINT> aFound;
+	std::vector<UINT> aExpected;
+	auto compare = [&](PCWSTR pszWhat, UINT uQuery)
+	{
+		std::sort(aFound.begin(), aFound.end());
+		std::sort(aExpected.begin(), aExpected.end());
+		context.Check(aFound == aExpected, L"query %u: %ls query found %zu proxies, the linear scan %zu", uQuery, pszWhat, aFound.size(), aExpected.size());
+		aFound.clear();
+		aExpected.clear();
+	};
+
+	library::FrustumCuller culler;
+	for (UINT uQuery = 0u; uQuery < NUM_QUERIES; ++uQuery)
+	{
+		RandomFrustum(generator, WORLD_SIZE, 80.0f, culler);
+		tree.QueryFrustum(culler.GetPlanes(), aFound);
+		for (const Reference& reference : aReferences)
+		{
+			if (reference.bIsAlive && IsInFrustum(culler.GetPlanes(), reference.Box))
+			{
+				aExpected.push_back(reference.uProxy);
+			}
+		}
+		compare(L"frustum", uQuery);
+
+		const XMFLOAT3 center = RandomPoint(generator, WORLD_SIZE);
+		const FLOAT radius = 5.0f + 20.0f * static_cast<FLOAT>(uQuery) / NUM_QUERIES;
+		tree.QuerySphere(center, radius, aFound);
+		for (const Reference& reference : aReferences)
+		{
+			if (reference.bIsAlive && OverlapsSphere(reference.Box, center, radius))
+			{
+				aExpected.push_back(reference.uProxy);
+			}
+		}
+		compare(L"sphere", uQuery);
+
+		const library::Aabb queryBox = RandomBox(generator, WORLD_SIZE, 2.0f, 20.0f);
+		tree.QueryAabb(queryBox, aFound);
+		for (const Reference& reference : aReferences)
+		{
+			if (reference.bIsAlive && Overlaps(reference.Box, queryBox))
+			{
+				aExpected.push_back(reference.uProxy);
+			}
+		}
+		compare(L"box", uQuery);
+
+		const XMFLOAT3 origin = RandomPoint(generator, WORLD_SIZE);
+		const XMFLOAT3 direction = RandomDirection(generator);
+		UINT uHit = library::AabbTree::NULL_NODE;
+		FLOAT hitDistance = 0.0f;
+		const BOOL bHit = tree.RayCast(origin, direction, WORLD_SIZE, uHit, hitDistance);
+
+		BOOL bExpectedHit = FALSE;
+		FLOAT expectedDistance = WORLD_SIZE;
+		for (const Reference& reference : aReferences)
+		{
+			FLOAT distance = 0.0f;
+			if (reference.bIsAlive && IntersectRay(reference.Box, origin, direction, WORLD_SIZE, distance) && distance <= expectedDistance)
+			{
+				bExpectedHit = TRUE;
+				expectedDistance = distance;
+			}
+		}
+		context.Check(
+			bHit == bExpectedHit && (!bHit || fabsf(hitDistance - expectedDistance) < 1e-3f),
+			L"query %u: ray hit %d at %.3f, the linear scan %d at %.3f", uQuery, bHit, hitDistance, bExpectedHit, expectedDistance
+		);
+	}
+
+	context.Log(L"%u proxies, height %d, %u of %u moves reinserted", tree.GetNumProxies(), tree.GetHeight(), uNumReinserted, NUM_MOVE_FRAMES * NUM_OBJECTS);
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: AabbTreeQueries
+
+  Summary:  Scatters boxes at about one per thousand cubic units for
+			growing counts and reports the cost of building the tree
+			and moving every box a little each frame, and the queries
+			per second of the tree and of a linear scan of the same
+			boxes for each kind of query. Both must find the same
+			number of boxes.
+-----------------------------------------------------------------F-F*/
+BENCHMARK_CASE(AabbTreeQueries)
+{
+	constexpr UINT NUM_QUERIES = 256u;
+	constexpr UINT NUM_MOVE_FRAMES = 8u;
+	constexpr FLOAT SPHERE_RADIUS = 10.0f;
+	const PCWSTR apszNames[] = { L"frustum", L"sphere", L"box", L"ray" };
+
+	for (UINT uNumObjects : { 1000u, 10000u, 100000u })
+	{
+		const FLOAT worldSize = 10.0f * cbrtf(static_cast<FLOAT>(uNumObjects));
+
+		std::mt19937 generator(40u);
+		std::uniform_real_distribution<FLOAT> step(-0.2f, 0.2f);
+
+		std::vector<library::Aabb> aBoxes;
+		aBoxes.reserve(uNumObjects);
+		for (UINT i = 0u; i < uNumObjects; ++i)
+		{
+			aBoxes.push_back(RandomBox(generator, worldSize, 0.5f, 2.0f));
+		}
+
+		library::AabbTree tree;
+		std::vector<UINT> aProxies;
+		aProxies.reserve(uNumObjects);
+		const DOUBLE buildMilliseconds = tests::MeasureMilliseconds(1u, [&]()
+			{
+				for (const library::Aabb& box : aBoxes)
+				{
+					aProxies.push_back(tree.Insert(box, nullptr));
+				}
+			}
+		);
+
+		// Moves every box a little each frame, like a scene of moving objects
+		std::vector<XMFLOAT3> aSteps(uNumObjects);
+		for (XMFLOAT3& offset : aSteps)
+		{
+			offset = XMFLOAT3(step(generator), step(generator), step(generator));
+		}
+
+		UINT uNumReinserted = 0u;
+		const DOUBLE moveMilliseconds = tests::MeasureMilliseconds(1u, [&]()
+			{
+				for (UINT uFrame = 0u; uFrame < NUM_MOVE_FRAMES; ++uFrame)
+				{
+					for (UINT i = 0u; i < uNumObjects; ++i)
+					{
+						aBoxes[i] = TranslateBox(aBoxes[i], aSteps[i]);
+						uNumReinserted += tree.Move(aProxies[i], aBoxes[i]) ? 1u : 0u;
+					}
+				}
+			}
+		);
+
+		context.Log(
+			L"%u objects: built in %.2f ms, height %d, %.3f us/move, %.1f%% of moves reinserted",
+			uNumObjects,
+			buildMilliseconds,
+			tree.GetHeight(),
+			1000.0 * moveMilliseconds / (static_cast<DOUBLE>(uNumObjects) * NUM_MOVE_FRAMES),
+			100.0 * uNumReinserted / (static_cast<DOUBLE>(uNumObjects) * NUM_MOVE_FRAMES)
+		);
+
+		// The same query shapes go to the tree and to the linear scan
+		std::vector<XMFLOAT4A> aFrustumPlanes;
+		std::vector<library::Aabb> aQueryBoxes;
+		std::vector<XMFLOAT3> aDirections;
+		library::FrustumCuller culler;
+		for (UINT i = 0u; i < NUM_QUERIES; ++i)
+		{
+			RandomFrustum(generator, worldSize, 50.0f, culler);
+			aFrustumPlanes.insert(aFrustumPlanes.end(), culler.GetPlanes(), culler.GetPlanes() + library::FrustumCuller::NUM_PLANES);
+			aQueryBoxes.push_back(RandomBox(generator, worldSize, 5.0f, 10.0f));
+			aDirections.push_back(RandomDirection(generator));
+		}
+
+		std::vector<UINT> aFound;
+		aFound.reserve(uNumObjects);
+
+		// Runs every query of one kind, returning the queries per second and the boxes found
+		auto timeQueries = [&](auto&& query, _Out_ UINT64& ullOutNumFound)
+		{
+			ullOutNumFound = 0ull;
+			const DOUBLE milliseconds = tests::MeasureMilliseconds(1u, [&]()
+				{
+					for (UINT i = 0u; i < NUM_QUERIES; ++i)
+					{
+						aFound.clear();
+						query(i);
+						ullOutNumFound += aFound.size();
+					}
+				}
+			);
+			return 1000.0 * NUM_QUERIES / std::max<DOUBLE>(milliseconds, 1e-6);
+		};
+
+		UINT64 aullTreeFound[4] = {};
+		const DOUBLE aTreeRates[] =
+		{
+			timeQueries([&](UINT i) { tree.QueryFrustum(&aFrustumPlanes[i * library::FrustumCuller::NUM_PLANES], aFound); }, aullTreeFound[0]),
+			timeQueries([&](UINT i) { tree.QuerySphere(aQueryBoxes[i].Min, SPHERE_RADIUS, aFound); }, aullTreeFound[1]),
+			timeQueries([&](UINT i) { tree.QueryAabb(aQueryBoxes[i], aFound); }, aullTreeFound[2]),
+			timeQueries([&](UINT i)
+				{
+					UINT uHit = library::AabbTree::NULL_NODE;
+					FLOAT distance = 0.0f;
+					if (tree.RayCast(aQueryBoxes[i].Min, aDirections[i], worldSize, uHit, distance))
+					{
+						aFound.push_back(uHit);
+					}
+				},
+				aullTreeFound[3]
+			),
+		};
+
+		UINT64 aullLinearFound[4] = {};
+		const DOUBLE aLinearRates[] =
+		{
+			timeQueries([&](UINT i)
+				{
+					for (UINT j = 0u; j < uNumObjects; ++j)
+					{
+						if (IsInFrustum(&aFrustumPlanes[i * library::FrustumCuller::NUM_PLANES], aBoxes[j]))
+						{
+							aFound.push_back(j);
+						}
+					}
+				},
+				aullLinearFound[0]
+			),
+			timeQueries([&](UINT i)
+				{
+					for (UINT j = 0u; j < uNumObjects; ++j)
+					{
+						if (OverlapsSphere(aBoxes[j], aQueryBoxes[i].Min, SPHERE_RADIUS))
+						{
+							aFound.push_back(j);
+						}
+					}
+				},
+				aullLinearFound[1]
+			),
+			timeQueries([&](UINT i)
+				{
+					for (UINT j = 0u; j < uNumObjects; ++j)
+					{
+						if (Overlaps(aBoxes[j], aQueryBoxes[i]))
+						{
+							aFound.push_back(j);
+						}
+					}
+				},
+				aullLinearFound[2]
+			),
+			timeQueries([&](UINT i)
+				{
+					UINT uHit = library::AabbTree::NULL_NODE;
+					FLOAT nearest = worldSize;
+					for (UINT j = 0u; j < uNumObjects; ++j)
+					{
+						FLOAT distance = 0.0f;
+						if (IntersectRay(aBoxes[j], aQueryBoxes[i].Min, aDirections[i], nearest, distance))
+						{
+							uHit = j;
+							nearest = distance;
+						}
+					}
+					if (uHit != library::AabbTree::NULL_NODE)
+					{
+						aFound.push_back(uHit);
+					}
+				},
+				aullLinearFound[3]
+			),
+		};
+
+		for (UINT i = 0u; i < ARRAYSIZE(apszNames); ++i)
+		{
+			context.Check(
+				aullTreeFound[i] == aullLinearFound[i],
+				L"%u objects: %ls queries found %llu boxes in the tree, %llu in the linear scan", uNumObjects, apszNames[i], aullTreeFound[i], aullLinearFound[i]
+			);
+			context.Log(
+				L"%u objects: %ls query %.0f/s, linear scan %.0f/s, %.2fx",
+				uNumObjects, apszNames[i], aTreeRates[i], aLinearRates[i], aTreeRates[i] / aLinearRates[i]
+			);
+		}
+	}
+}
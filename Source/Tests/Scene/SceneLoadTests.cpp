@@ -0,0 +1,223 @@
+/*+===================================================================
+  File:      SCENELOADTESTS.CPP
+
+  Summary:   Loads several model files into a scene through
+			 Scene::InitializeAsync on a WARP device, with and
+			 without workers, and checks that every file is imported
+			 once and every model becomes ready. Reports how soon the
+			 first frame could be drawn in both cases.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "Job/JobSystem.h"
+#include "Model/ModelCache.h"
+#include "Scene/Scene.h"
+
+namespace
+{
+	constexpr UINT NUM_FILES = 4u;
+	constexpr UINT NUM_INSTANCES = 2u;
+	constexpr UINT GRID_SIZE = 96u;
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   LoadResult
+
+		Summary:  Outcome of loading the models of one scene
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct LoadResult
+	{
+		HRESULT Result;
+		BOOL bIsFutureReady;
+		UINT uNumReady;
+		UINT uNumLoads;
+		DOUBLE FirstFrameMilliseconds;
+		DOUBLE LoadedMilliseconds;
+	};
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: WriteGrid
+
+	  Summary:  Writes an OBJ file of GRID_SIZE by GRID_SIZE quads
+				without materials, large enough for its import to
+				take a measurable time
+
+	  Args:     const std::filesystem::path& filePath
+				  Path of the file to write
+
+	  Returns:  BOOL
+				  Whether the file was written
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	BOOL WriteGrid(_In_ const std::filesystem::path& filePath)
+	{
+		std::ofstream file(filePath);
+		for (UINT y = 0u; y <= GRID_SIZE; ++y)
+		{
+			for (UINT x = 0u; x <= GRID_SIZE; ++x)
+			{
+				file << "v " << x << ' ' << y << " 0\n" << "vt " << static_cast<FLOAT>(x) / GRID_SIZE << ' ' << static_cast<FLOAT>(y) / GRID_SIZE << '\n';
+			}
+		}
+		file << "vn 0 0 1\n";
+
+		for (UINT y = 0u; y < GRID_SIZE; ++y)
+		{
+			for (UINT x = 0u; x < GRID_SIZE; ++x)
+			{
+				const UINT v0 = y * (GRID_SIZE + 1u) + x + 1u;
+				const UINT v1 = v0 + 1u;
+				const UINT v2 = v1 + GRID_SIZE + 1u;
+				const UINT v3 = v0 + GRID_SIZE + 1u;
+				file << "f " << v0 << '/' << v0 << "/1 " << v1 << '/' << v1 << "/1 " << v2 << '/' << v2 << "/1\n";
+				file << "f " << v0 << '/' << v0 << "/1 " << v2 << '/' << v2 << "/1 " << v3 << '/' << v3 << "/1\n";
+			}
+		}
+
+		return file.good();
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: LoadScene
+
+	  Summary:  Places NUM_INSTANCES models of every file in a new
+				scene and loads it with the given worker count,
+				running the device tasks on this thread like the
+				render loop does. The first frame could be drawn as
+				soon as InitializeAsync returns.
+
+	  Args:     ID3D11Device* pDevice
+				  Device the models are created on
+				ID3D11DeviceContext* pImmediateContext
+				  Immediate context of the device
+				const std::filesystem::path* aFilePaths
+				  Model files, NUM_FILES of them
+				const std::filesystem::path& sceneFilePath
+				  Empty voxel map of the scene
+				UINT uNumWorkers
+				  Worker count of the job system
+
+	  Returns:  LoadResult
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	LoadResult LoadScene(
+		_In_ ID3D11Device* pDevice,
+		_In_ ID3D11DeviceContext* pImmediateContext,
+		_In_reads_(NUM_FILES) const std::filesystem::path* aFilePaths,
+		_In_ const std::filesystem::path& sceneFilePath,
+		_In_ UINT uNumWorkers
+	)
+	{
+		library::JobSystem::GetInstance().Initialize(uNumWorkers);
+		library::ModelCache& cache = library::ModelCache::GetInstance();
+		cache.Clear();
+		const UINT uNumLoads = cache.GetNumLoads();
+
+		library::Scene scene(sceneFilePath);
+		for (UINT i = 0u; i < NUM_FILES * NUM_INSTANCES; ++i)
+		{
+			WCHAR szName[32];
+			swprintf_s(szName, L"Model%u", i);
+			scene.AddModel(szName, std::make_shared<library::Model>(aFilePaths[i % NUM_FILES]));
+		}
+
+		LoadResult result = {};
+		std::shared_future<HRESULT> modelsLoaded;
+		const auto start = std::chrono::high_resolution_clock::now();
+		result.Result = scene.InitializeAsync(pDevice, pImmediateContext, modelsLoaded);
+		result.FirstFrameMilliseconds = std::chrono::duration<DOUBLE, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		if (SUCCEEDED(result.Result))
+		{
+			while (modelsLoaded.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			{
+				if (scene.ProcessDeviceTasks(UINT_MAX) == 0u)
+				{
+					std::this_thread::yield();
+				}
+			}
+			result.LoadedMilliseconds = std::chrono::duration<DOUBLE, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			result.bIsFutureReady = TRUE;
+			result.Result = modelsLoaded.get();
+		}
+
+		for (const auto& pair : scene.GetModels())
+		{
+			result.uNumReady += pair.second->IsReady() ? 1u : 0u;
+		}
+		result.uNumLoads = cache.GetNumLoads() - uNumLoads;
+
+		cache.Clear();
+		return result;
+	}
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: SceneLoadsModelsConcurrently
+
+  Summary:  Loads NUM_FILES files placed NUM_INSTANCES times each,
+			first without workers, where every import runs inside
+			InitializeAsync like a synchronous load, then with one
+			worker, and so one importer, per file. Both loads must
+			import every file once, complete the future with S_OK
+			and leave every model ready. Logs when the first frame
+			could be drawn and when every model was ready.
+-----------------------------------------------------------------F-F*/
+TEST_CASE(SceneLoadsModelsConcurrently)
+{
+	ComPtr<ID3D11Device> device;
+	ComPtr<ID3D11DeviceContext> immediateContext;
+	HRESULT hr = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0u, nullptr, 0u, D3D11_SDK_VERSION, device.GetAddressOf(), nullptr, immediateContext.GetAddressOf());
+	if (!context.Check(SUCCEEDED(hr), L"creating a WARP device failed with 0x%08x", static_cast<UINT>(hr)))
+	{
+		return;
+	}
+
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / L"SceneLoadsModelsConcurrently";
+	std::error_code errorCode;
+	std::filesystem::create_directories(directory, errorCode);
+
+	std::filesystem::path aFilePaths[NUM_FILES];
+	for (UINT i = 0u; i < NUM_FILES; ++i)
+	{
+		aFilePaths[i] = directory / (L"Grid" + std::to_wstring(i) + L".obj");
+		if (!context.Check(WriteGrid(aFilePaths[i]), L"could not write %ls", aFilePaths[i].c_str()))
+		{
+			std::filesystem::remove_all(directory, errorCode);
+			return;
+		}
+	}
+
+	// An empty voxel map, the models are added by LoadScene
+	const std::filesystem::path sceneFilePath = directory / L"Scene.txt";
+	{
+		std::ofstream file(sceneFilePath);
+		file << "0 0 0 0\n";
+	}
+
+	library::JobSystem& jobSystem = library::JobSystem::GetInstance();
+	const UINT uPrevNumWorkers = jobSystem.GetNumWorkers();
+	const UINT aNumWorkers[] = { 0u, NUM_FILES };
+
+	for (UINT uNumWorkers : aNumWorkers)
+	{
+		const LoadResult result = LoadScene(device.Get(), immediateContext.Get(), aFilePaths, sceneFilePath, uNumWorkers);
+
+		context.Check(result.bIsFutureReady && SUCCEEDED(result.Result), L"%u worker(s): loading failed with 0x%08x", uNumWorkers, static_cast<UINT>(result.Result));
+		context.Check(result.uNumReady == NUM_FILES * NUM_INSTANCES, L"%u worker(s): %u of %u model(s) ready", uNumWorkers, result.uNumReady, NUM_FILES * NUM_INSTANCES);
+		context.Check(result.uNumLoads == NUM_FILES, L"%u worker(s): %u import(s), expected %u", uNumWorkers, result.uNumLoads, NUM_FILES);
+		context.Log(
+			L"%u worker(s): first frame after %.1f ms, every model ready after %.1f ms",
+			uNumWorkers,
+			result.FirstFrameMilliseconds,
+			result.LoadedMilliseconds
+		);
+	}
+
+	jobSystem.Initialize(uPrevNumWorkers);
+	std::filesystem::remove_all(directory, errorCode);
+}
@@ -0,0 +1,376 @@
+/*+===================================================================
+  File:      SCENEUPDATETESTS.CPP
+
+  Summary:   Fills a scene with animated, CPU skinned characters and
+			 times Scene::Update on one thread and on every larger
+			 job system, to report how the update scales.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "assimp/scene.h"
+
+#include "Job/JobSystem.h"
+#include "Model/Skeleton.h"
+#include "Model/SkinningEngine.h"
+#include "Scene/Scene.h"
+
+namespace
+{
+	constexpr UINT NUM_BONES = 64u;
+	constexpr UINT NUM_VERTICES = 1024u;
+	constexpr UINT NUM_KEYS = 8u;
+	constexpr DOUBLE ANIMATION_DURATION = 100.0;
+	constexpr FLOAT TICKS_PER_SECOND = 25.0f;
+	constexpr FLOAT TOLERANCE = 1e-4f;
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   Character
+
+		Summary:  Animated bone chain and the bind pose of a mesh
+				  skinned to it, shared by every instance like the
+				  source of a cached model
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct Character
+	{
+		std::unique_ptr<aiScene> pScene;
+		library::Skeleton Skeleton;
+		std::vector<library::SimpleVertex> aVertices;
+		std::vector<library::NormalData> aNormalData;
+		std::vector<library::AnimationData> aAnimationData;
+	};
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: InitializeCharacter
+
+	  Summary:  Builds a chain of NUM_BONES animated bones under a root
+				node and NUM_VERTICES vertices weighted to four bones
+				each
+
+	  Args:     Character& outCharacter
+				  Character to fill
+
+	  Returns:  HRESULT
+				  Status code of the skeleton
+	-----------------------------------------------------------------F-F*/
+	HRESULT InitializeCharacter(_Out_ Character& outCharacter)
+	{
+		std::mt19937 generator(26u);
+		std::uniform_real_distribution<FLOAT> coordinate(-1.0f, 1.0f);
+		std::uniform_real_distribution<FLOAT> weight(0.0f, 1.0f);
+		std::uniform_int_distribution<UINT> bone(0u, NUM_BONES - 1u);
+
+		std::vector<aiNode*> apNodes(NUM_BONES + 1u);
+		std::vector<aiNodeAnim*> apChannels;
+		std::unordered_map<std::string, UINT> boneNameToIndexMap;
+		for (UINT i = 0u; i < NUM_BONES + 1u; ++i)
+		{
+			CHAR szName[16];
+			snprintf(szName, sizeof(szName), "Bone%03u", i);
+
+			apNodes[i] = new aiNode(szName);
+			if (i == 0u)
+			{
+				continue;
+			}
+
+			apNodes[i]->mParent = apNodes[i - 1u];
+			apNodes[i - 1u]->mNumChildren = 1u;
+			apNodes[i - 1u]->mChildren = new aiNode*[1] { apNodes[i] };
+			boneNameToIndexMap[szName] = i - 1u;
+
+			aiNodeAnim* pNodeAnim = new aiNodeAnim();
+			pNodeAnim->mNodeName = apNodes[i]->mName;
+			pNodeAnim->mNumPositionKeys = NUM_KEYS;
+			pNodeAnim->mPositionKeys = new aiVectorKey[NUM_KEYS];
+			pNodeAnim->mNumRotationKeys = NUM_KEYS;
+			pNodeAnim->mRotationKeys = new aiQuatKey[NUM_KEYS];
+			pNodeAnim->mNumScalingKeys = 1u;
+			pNodeAnim->mScalingKeys = new aiVectorKey[1];
+			pNodeAnim->mScalingKeys[0].mValue = aiVector3D(1.0f, 1.0f, 1.0f);
+			for (UINT k = 0u; k < NUM_KEYS; ++k)
+			{
+				const DOUBLE time = ANIMATION_DURATION * k / (NUM_KEYS - 1u);
+				pNodeAnim->mPositionKeys[k].mTime = time;
+				pNodeAnim->mPositionKeys[k].mValue = aiVector3D(0.0f, 0.1f, 0.0f);
+				pNodeAnim->mRotationKeys[k].mTime = time;
+				pNodeAnim->mRotationKeys[k].mValue = aiQuaternion(aiVector3D(0.0f, 0.0f, 1.0f), 0.2f * coordinate(generator));
+			}
+			apChannels.push_back(pNodeAnim);
+		}
+
+		outCharacter.pScene = std::make_unique<aiScene>();
+		outCharacter.pScene->mRootNode = apNodes[0];
+
+		aiAnimation* pAnimation = new aiAnimation();
+		pAnimation->mDuration = ANIMATION_DURATION;
+		pAnimation->mTicksPerSecond = TICKS_PER_SECOND;
+		pAnimation->mNumChannels = static_cast<UINT>(apChannels.size());
+		pAnimation->mChannels = new aiNodeAnim*[apChannels.size()];
+		std::copy(apChannels.begin(), apChannels.end(), pAnimation->mChannels);
+		outCharacter.pScene->mNumAnimations = 1u;
+		outCharacter.pScene->mAnimations = new aiAnimation*[1] { pAnimation };
+
+		outCharacter.aVertices.resize(NUM_VERTICES);
+		outCharacter.aNormalData.resize(NUM_VERTICES);
+		outCharacter.aAnimationData.resize(NUM_VERTICES);
+		for (UINT i = 0u; i < NUM_VERTICES; ++i)
+		{
+			outCharacter.aVertices[i].Position = XMFLOAT3(coordinate(generator), 0.1f * NUM_BONES * weight(generator), coordinate(generator));
+			outCharacter.aVertices[i].Normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
+			outCharacter.aNormalData[i].Tangent = XMFLOAT3(1.0f, 0.0f, 0.0f);
+			outCharacter.aNormalData[i].Bitangent = XMFLOAT3(0.0f, 0.0f, 1.0f);
+
+			FLOAT aWeights[4] = { weight(generator), weight(generator), weight(generator), weight(generator) };
+			FLOAT sum = aWeights[0] + aWeights[1] + aWeights[2] + aWeights[3] + 1e-6f;
+			outCharacter.aAnimationData[i].aBoneIndices = XMUINT4(bone(generator), bone(generator), bone(generator), bone(generator));
+			outCharacter.aAnimationData[i].aBoneWeights = XMFLOAT4(aWeights[0] / sum, aWeights[1] / sum, aWeights[2] / sum, aWeights[3] / sum);
+		}
+
+		return outCharacter.Skeleton.Initialize(
+			outCharacter.pScene.get(),
+			boneNameToIndexMap,
+			std::vector<XMMATRIX>(NUM_BONES, XMMatrixIdentity()),
+			XMMatrixIdentity()
+		);
+	}
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    AnimatedRenderable
+
+	  Summary:  Instance of a character that does the CPU work of a
+				CPU skinned model in Update, without device objects:
+				it samples its own pose, skins its own vertices and
+				walks in a circle so its box moves in the scene tree.
+
+	  Methods:  Initialize
+				  Does nothing, there is no device
+				Update
+				  Advances the animation, skins and moves
+				GetAnimationTicks
+				  Returns the animation time of the last Update
+				GetPalette
+				  Returns the palette of the last Update
+				GetNumVertices
+				  Returns the number of vertices
+				GetNumIndices
+				  Returns 0
+				AnimatedRenderable
+				  Constructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class AnimatedRenderable final : public library::Renderable
+	{
+	public:
+		AnimatedRenderable(_In_ const Character& character, _In_ FLOAT animationTicks, _In_ const XMFLOAT3& center)
+			: Renderable(XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f))
+			, m_character(character)
+			, m_pose()
+			, m_aPalette(NUM_BONES, XMMatrixIdentity())
+			, m_aSkinnedVertices(NUM_VERTICES)
+			, m_aSkinnedNormalData(NUM_VERTICES)
+			, m_animationTicks(animationTicks)
+			, m_center(center)
+		{
+			m_character.Skeleton.InitializePose(m_pose);
+
+			m_aMeshes.resize(1u);
+			m_aMeshes[0].Bounds = library::MeshBounds{
+				.Center = XMFLOAT3(0.0f, 0.05f * NUM_BONES, 0.0f),
+				.Extents = XMFLOAT3(1.0f, 0.05f * NUM_BONES, 1.0f),
+				.Radius = 0.05f * NUM_BONES + 1.0f
+			};
+		}
+
+		HRESULT Initialize(_In_ ID3D11Device*, _In_ ID3D11DeviceContext*) override
+		{
+			return S_OK;
+		}
+
+		void Update(_In_ FLOAT deltaTime) override
+		{
+			m_animationTicks = std::fmod(m_animationTicks + deltaTime * TICKS_PER_SECOND, static_cast<FLOAT>(ANIMATION_DURATION));
+
+			m_character.Skeleton.ComputePalette(m_animationTicks, m_pose, m_aPalette.data());
+			library::SkinningEngine::SkinVertices(
+				m_character.aVertices.data(),
+				m_character.aNormalData.data(),
+				m_character.aAnimationData.data(),
+				NUM_VERTICES,
+				m_aPalette.data(),
+				m_aSkinnedVertices.data(),
+				m_aSkinnedNormalData.data()
+			);
+
+			const FLOAT angle = m_animationTicks * 0.0628f;
+			m_world = XMMatrixTranslation(m_center.x + 4.0f * std::cos(angle), m_center.y, m_center.z + 4.0f * std::sin(angle));
+		}
+
+		FLOAT GetAnimationTicks() const
+		{
+			return m_animationTicks;
+		}
+
+		const std::vector<XMMATRIX>& GetPalette() const
+		{
+			return m_aPalette;
+		}
+
+		UINT GetNumVertices() const override
+		{
+			return NUM_VERTICES;
+		}
+
+		UINT GetNumIndices() const override
+		{
+			return 0u;
+		}
+
+	protected:
+		const library::SimpleVertex* getVertices() const override
+		{
+			return m_aSkinnedVertices.data();
+		}
+
+		const WORD* getIndices() const override
+		{
+			return nullptr;
+		}
+
+	private:
+		const Character& m_character;
+		library::SkeletonPose m_pose;
+		std::vector<XMMATRIX> m_aPalette;
+		std::vector<library::SimpleVertex> m_aSkinnedVertices;
+		std::vector<library::NormalData> m_aSkinnedNormalData;
+		FLOAT m_animationTicks;
+		XMFLOAT3 m_center;
+	};
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: MaxRelativeError
+
+	  Summary:  Returns the largest |a - b| / (1 + |b|) over every
+				element of two palettes
+
+	  Returns:  FLOAT
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	FLOAT MaxRelativeError(_In_ const std::vector<XMMATRIX>& aPalette, _In_ const std::vector<XMMATRIX>& aReference)
+	{
+		FLOAT maxError = 0.0f;
+		for (size_t i = 0u; i < aPalette.size(); ++i)
+		{
+			XMFLOAT4X4 matrix;
+			XMFLOAT4X4 reference;
+			XMStoreFloat4x4(&matrix, aPalette[i]);
+			XMStoreFloat4x4(&reference, aReference[i]);
+
+			for (UINT uRow = 0u; uRow < 4u; ++uRow)
+			{
+				for (UINT uColumn = 0u; uColumn < 4u; ++uColumn)
+				{
+					FLOAT error = std::abs(matrix.m[uRow][uColumn] - reference.m[uRow][uColumn]) / (1.0f + std::abs(reference.m[uRow][uColumn]));
+					maxError = std::max(maxError, error);
+				}
+			}
+		}
+
+		return maxError;
+	}
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: SceneUpdateScaling
+
+  Summary:  Updates 512 animated characters with 1 to N threads,
+			restarting the job system for each count, and reports
+			the milliseconds per frame and the speedup over one
+			thread. Afterwards every character must be in the scene
+			tree with the palette of its own animation time.
+-----------------------------------------------------------------F-F*/
+BENCHMARK_CASE(SceneUpdateScaling)
+{
+	constexpr UINT NUM_MODELS = 512u;
+	constexpr UINT NUM_FRAMES = 10u;
+	constexpr FLOAT DELTA_TIME = 1.0f / 60.0f;
+
+	Character character;
+	if (!context.Check(SUCCEEDED(InitializeCharacter(character)), L"character failed to initialize"))
+	{
+		return;
+	}
+
+	// An empty voxel map, the characters are added below
+	const std::filesystem::path filePath = std::filesystem::temp_directory_path() / L"SceneUpdateScaling.txt";
+	{
+		std::ofstream file(filePath);
+		file << "0 0 0 0\n";
+	}
+	library::Scene scene(filePath);
+	std::error_code errorCode;
+	std::filesystem::remove(filePath, errorCode);
+
+	std::vector<std::shared_ptr<AnimatedRenderable>> aModels;
+	for (UINT i = 0u; i < NUM_MODELS; ++i)
+	{
+		aModels.push_back(
+			std::make_shared<AnimatedRenderable>(
+				character,
+				static_cast<FLOAT>(ANIMATION_DURATION) * i / NUM_MODELS,
+				XMFLOAT3(16.0f * static_cast<FLOAT>(i % 32u), 0.0f, 16.0f * static_cast<FLOAT>(i / 32u))
+			)
+		);
+
+		WCHAR szName[32];
+		swprintf_s(szName, L"Character%03u", i);
+		scene.AddRenderable(szName, aModels.back());
+	}
+
+	library::JobSystem& jobSystem = library::JobSystem::GetInstance();
+	const UINT uPrevNumWorkers = jobSystem.GetNumWorkers();
+	UINT uMaxNumThreads = std::thread::hardware_concurrency();
+	uMaxNumThreads = uMaxNumThreads > 0u ? uMaxNumThreads : 1u;
+
+	DOUBLE oneThreadMilliseconds = 0.0;
+	for (UINT uNumThreads = 1u; uNumThreads <= uMaxNumThreads; ++uNumThreads)
+	{
+		jobSystem.Initialize(uNumThreads - 1u);
+
+		const DOUBLE milliseconds = tests::MeasureMilliseconds(3u, [&]()
+		{
+			for (UINT uFrame = 0u; uFrame < NUM_FRAMES; ++uFrame)
+			{
+				scene.Update(DELTA_TIME);
+			}
+		}) / NUM_FRAMES;
+		oneThreadMilliseconds = uNumThreads == 1u ? milliseconds : oneThreadMilliseconds;
+
+		context.Log(
+			L"%u model(s), %u thread(s): %.3f ms/frame, %.2fx",
+			NUM_MODELS,
+			uNumThreads,
+			milliseconds,
+			milliseconds > 0.0 ? oneThreadMilliseconds / milliseconds : 0.0
+		);
+	}
+
+	jobSystem.Initialize(uPrevNumWorkers);
+
+	library::SkeletonPose pose;
+	character.Skeleton.InitializePose(pose);
+	std::vector<XMMATRIX> aReference(NUM_BONES);
+	for (UINT i = 0u; i < NUM_MODELS; ++i)
+	{
+		context.Check(scene.GetRenderableProxy(aModels[i].get()) != library::AabbTree::NULL_NODE, L"model %u is not in the scene tree", i);
+
+		character.Skeleton.ComputePalette(aModels[i]->GetAnimationTicks(), pose, aReference.data());
+		FLOAT maxError = MaxRelativeError(aModels[i]->GetPalette(), aReference);
+		context.Check(maxError <= TOLERANCE, L"model %u differs from its palette by %g", i, maxError);
+	}
+}
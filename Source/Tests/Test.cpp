@@ -0,0 +1,138 @@
+/*+===================================================================
+  File:      TEST.CPP
+
+  Summary:   Test source file contains the test context and the
+			 registry of test and benchmark cases.
+
+  Classes: TestContext, TestRegistration
+
+  Functions: GetTestCases
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+namespace tests
+{
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TestContext::TestContext
+
+	  Summary:  Constructor
+
+	  Args:     PCWSTR pszName
+				  Name of the running case, printed with its failures
+
+	  Modifies: [m_pszName, m_uNumFailures].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	TestContext::TestContext(_In_ PCWSTR pszName)
+		: m_pszName(pszName)
+		, m_uNumFailures(0u)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TestContext::Check
+
+	  Summary:  Counts a failure and prints the formatted message when
+				the condition does not hold
+
+	  Args:     BOOL bCondition
+				  Condition that has to hold
+				PCWSTR pszFormat
+				  printf-style format of the failure message, followed
+				  by its arguments
+
+	  Modifies: [m_uNumFailures].
+
+	  Returns:  BOOL
+				  The condition
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL TestContext::Check(_In_ BOOL bCondition, _In_z_ PCWSTR pszFormat, ...)
+	{
+		if (bCondition)
+		{
+			return TRUE;
+		}
+
+		++m_uNumFailures;
+
+		wprintf(L"  %ls failed: ", m_pszName);
+
+		va_list args;
+		va_start(args, pszFormat);
+		vwprintf(pszFormat, args);
+		va_end(args);
+
+		wprintf(L"\n");
+
+		return FALSE;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TestContext::Log
+
+	  Summary:  Prints a formatted message of the case
+
+	  Args:     PCWSTR pszFormat
+				  printf-style format of the message, followed by its
+				  arguments
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void TestContext::Log(_In_z_ PCWSTR pszFormat, ...)
+	{
+		wprintf(L"  ");
+
+		va_list args;
+		va_start(args, pszFormat);
+		vwprintf(pszFormat, args);
+		va_end(args);
+
+		wprintf(L"\n");
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TestContext::GetNumFailures
+
+	  Summary:  Returns the number of failed checks
+
+	  Returns:  UINT
+				  Number of failed checks
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT TestContext::GetNumFailures() const
+	{
+		return m_uNumFailures;
+	}
+
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: GetTestCases
+
+	  Summary:  Returns the registry of cases. A function-local static
+				so registrations in other translation units find it
+				constructed.
+
+	  Returns:  std::vector<TestCase>&
+				  Registered cases
+	-----------------------------------------------------------------F-F*/
+	std::vector<TestCase>& GetTestCases()
+	{
+		static std::vector<TestCase> s_aTestCases;
+		return s_aTestCases;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   TestRegistration::TestRegistration
+
+	  Summary:  Constructor. Adds the case to the registry.
+
+	  Args:     PCWSTR pszName
+				  Name of the case
+				eTestKind kind
+				  Test or benchmark
+				TestFunction pfnRun
+				  Function of the case
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	TestRegistration::TestRegistration(_In_ PCWSTR pszName, _In_ eTestKind kind, _In_ TestFunction pfnRun)
+	{
+		GetTestCases().push_back(TestCase{ .pszName = pszName, .Kind = kind, .pfnRun = pfnRun });
+	}
+}
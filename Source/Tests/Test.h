@@ -0,0 +1,154 @@
+/*+===================================================================
+  File:      TEST.H
+
+  Summary:   Test header file contains declarations of the test
+			 context, the registry of test and benchmark cases and the
+			 macros that define and register a case.
+
+  Classes: TestContext, TestRegistration
+
+  Functions: GetTestCases
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Portable.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cwchar>
+
+namespace tests
+{
+	/*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+	  Enum:     eTestKind
+
+	  Summary:  Whether a case checks behavior and runs on every build
+				or measures performance and runs when asked for
+	E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+	enum class eTestKind
+	{
+		TEST,
+		BENCHMARK,
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    TestContext
+
+	  Summary:  Passed to a running case. Counts the checks that
+				failed and prints them, and prints the measurements a
+				case reports.
+
+	  Methods:  Check
+				  Counts and prints a failure when a condition does not
+				  hold
+				Log
+				  Prints a message of the case
+				GetNumFailures
+				  Returns the number of failed checks
+				TestContext
+				  Constructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class TestContext final
+	{
+	public:
+		explicit TestContext(_In_ PCWSTR pszName);
+		TestContext(const TestContext& other) = delete;
+		TestContext(TestContext&& other) = delete;
+		TestContext& operator=(const TestContext& other) = delete;
+		TestContext& operator=(TestContext&& other) = delete;
+		~TestContext() = default;
+
+		BOOL Check(_In_ BOOL bCondition, _In_z_ PCWSTR pszFormat, ...);
+		void Log(_In_z_ PCWSTR pszFormat, ...);
+
+		UINT GetNumFailures() const;
+
+	private:
+		PCWSTR m_pszName;
+		UINT m_uNumFailures;
+	};
+
+	typedef void (*TestFunction)(_Inout_ TestContext& context);
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   TestCase
+
+		Summary:  A registered case: its name, kind and function
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct TestCase
+	{
+		PCWSTR pszName;
+		eTestKind Kind;
+		TestFunction pfnRun;
+	};
+
+	std::vector<TestCase>& GetTestCases();
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    TestRegistration
+
+	  Summary:  Static object that adds a case to the registry before
+				main runs
+
+	  Methods:  TestRegistration
+				  Constructor.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class TestRegistration final
+	{
+	public:
+		TestRegistration(_In_ PCWSTR pszName, _In_ eTestKind kind, _In_ TestFunction pfnRun);
+	};
+
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: MeasureMilliseconds
+
+	  Summary:  Runs a function a number of times and returns the
+				fastest run, so benchmarks report the time without
+				the noise of other processes
+
+	  Args:     UINT uNumRuns
+				  Number of times to run the function
+				const Function& function
+				  Function to time
+
+	  Returns:  DOUBLE
+				  Milliseconds of the fastest run
+	-----------------------------------------------------------------F-F*/
+	template <class Function>
+	DOUBLE MeasureMilliseconds(_In_ UINT uNumRuns, _In_ const Function& function)
+	{
+		DOUBLE best = DBL_MAX;
+		for (UINT uRun = 0u; uRun < uNumRuns; ++uRun)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			function();
+			auto end = std::chrono::high_resolution_clock::now();
+
+			best = std::min<DOUBLE>(best, std::chrono::duration<DOUBLE, std::milli>(end - start).count());
+		}
+
+		return best;
+	}
+}
+
+#define TESTS_WIDEN_(text) L ## text
+#define TESTS_WIDEN(text) TESTS_WIDEN_(text)
+
+#define TESTS_DEFINE_CASE_(Name, Kind) \
+	static void Name(_Inout_ tests::TestContext& context); \
+	static const tests::TestRegistration s_##Name##Registration(TESTS_WIDEN(#Name), Kind, Name); \
+	static void Name(_Inout_ tests::TestContext& context)
+
+/*--------------------------------------------------------------------
+  TEST_CASE(Name) defines a case that runs on every build and fails
+  it when a check fails. BENCHMARK_CASE(Name) defines a case that
+  runs with --bench and reports measurements; its checks still fail
+  the run.
+--------------------------------------------------------------------*/
+#define TEST_CASE(Name) TESTS_DEFINE_CASE_(Name, tests::eTestKind::TEST)
+#define BENCHMARK_CASE(Name) TESTS_DEFINE_CASE_(Name, tests::eTestKind::BENCHMARK)
@@ -0,0 +1,204 @@
+/*+===================================================================
+  File:      BLOCKCOMPRESSORTESTS.CPP
+
+  Summary:   Round-trips synthetic images and game textures through
+			 the BC1, BC3, BC5 and BC7 encoders and decoders and
+			 checks that their quality stays above a PSNR floor.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <random>
+
+#include "Texture/BlockCompressor.h"
+#include "Texture/TextureCooker.h"
+
+namespace
+{
+	// Relative to the project directory the tests run in
+	constexpr PCWSTR PSZ_CONTENT_DIRECTORY = L"../Game/Content/cyborg";
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   PsnrFloor
+
+		Summary:  Lowest PSNR a format must reach, in decibels, on the
+				  synthetic images and on the cooked game textures
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct PsnrFloor
+	{
+		library::eBlockFormat Format;
+		FLOAT Synthetic;
+		FLOAT Cooked;
+	};
+
+	// About 2 dB under what the encoders reach. BC7 is encoded with
+	// mode 6 only, one partition with 7 bit endpoints and 4 bit
+	// indices, so it is held to little more than BC3.
+	constexpr PsnrFloor A_PSNR_FLOORS[] =
+	{
+		{ library::eBlockFormat::BC1, 32.0f, 35.0f },
+		{ library::eBlockFormat::BC3, 33.0f, 35.0f },
+		{ library::eBlockFormat::BC5, 43.0f, 40.0f },
+		{ library::eBlockFormat::BC7, 35.0f, 41.0f },
+	};
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: MakeImage
+
+	  Summary:  Creates a smooth image with some noise, like a
+				photographed texture: color and alpha gradients for
+				the color formats, and the normals of a bumpy surface
+				for BC5
+
+	  Args:     UINT uWidth
+				  Width in texels
+				UINT uHeight
+				  Height in texels
+				library::eBlockFormat format
+				  Format the image is made for
+
+	  Returns:  library::ImageData
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	library::ImageData MakeImage(_In_ UINT uWidth, _In_ UINT uHeight, _In_ library::eBlockFormat format)
+	{
+		library::ImageData image =
+		{
+			.uWidth = uWidth,
+			.uHeight = uHeight,
+			.aPixels = std::vector<BYTE>(static_cast<SIZE_T>(uWidth) * uHeight * 4u)
+		};
+
+		std::mt19937 generator(uWidth * 31u + uHeight);
+		std::uniform_real_distribution<FLOAT> noise(-4.0f, 4.0f);
+		auto toByte = [](FLOAT value) { return static_cast<BYTE>(std::clamp(value, 0.0f, 255.0f) + 0.5f); };
+
+		for (UINT y = 0u; y < uHeight; ++y)
+		{
+			for (UINT x = 0u; x < uWidth; ++x)
+			{
+				const FLOAT u = static_cast<FLOAT>(x) / static_cast<FLOAT>(uWidth);
+				const FLOAT v = static_cast<FLOAT>(y) / static_cast<FLOAT>(uHeight);
+				BYTE* pTexel = &image.aPixels[(static_cast<SIZE_T>(y) * uWidth + x) * 4u];
+
+				if (format == library::eBlockFormat::BC5)
+				{
+					const FLOAT dx = 0.5f * std::cos(u * 12.0f) * std::sin(v * 9.0f);
+					const FLOAT dy = 0.5f * std::sin(u * 12.0f) * std::cos(v * 9.0f);
+					const FLOAT length = std::sqrt(dx * dx + dy * dy + 1.0f);
+					pTexel[0] = toByte((dx / length * 0.5f + 0.5f) * 255.0f + noise(generator));
+					pTexel[1] = toByte((dy / length * 0.5f + 0.5f) * 255.0f + noise(generator));
+					pTexel[2] = toByte((1.0f / length * 0.5f + 0.5f) * 255.0f);
+					pTexel[3] = 255u;
+					continue;
+				}
+
+				pTexel[0] = toByte(255.0f * u + noise(generator));
+				pTexel[1] = toByte(255.0f * v + noise(generator));
+				pTexel[2] = toByte(128.0f + 96.0f * std::sin((u + v) * 6.0f) + noise(generator));
+				pTexel[3] = format == library::eBlockFormat::BC1 ? 255u : toByte(255.0f * (1.0f - v) + noise(generator));
+			}
+		}
+
+		return image;
+	}
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: BlockCompressorRoundTripsBlocks
+
+  Summary:  Encodes synthetic images to every format, one a multiple
+			of the block size and one with partial blocks, decodes
+			them and checks the block count, the size of the decoded
+			image and its PSNR against the original
+-----------------------------------------------------------------F-F*/
+TEST_CASE(BlockCompressorRoundTripsBlocks)
+{
+	const UINT aSizes[][2] = { { 64u, 64u }, { 61u, 37u } };
+
+	for (const PsnrFloor& floor : A_PSNR_FLOORS)
+	{
+		for (const auto& size : aSizes)
+		{
+			const library::ImageData image = MakeImage(size[0], size[1], floor.Format);
+
+			std::vector<BYTE> aBlocks;
+			HRESULT hr = library::BlockCompressor::CompressImage(image, floor.Format, aBlocks);
+			if (!context.Check(SUCCEEDED(hr), L"format %zu, %ux%u: encoding failed with 0x%08x", static_cast<size_t>(floor.Format), size[0], size[1], static_cast<UINT>(hr)))
+			{
+				continue;
+			}
+
+			const SIZE_T uNumBlocks = static_cast<SIZE_T>((size[0] + 3u) / 4u) * ((size[1] + 3u) / 4u);
+			context.Check(
+				aBlocks.size() == uNumBlocks * library::BlockCompressor::GetBlockSize(floor.Format),
+				L"format %zu, %ux%u: %zu bytes of blocks, expected %zu", static_cast<size_t>(floor.Format), size[0], size[1], aBlocks.size(), uNumBlocks * library::BlockCompressor::GetBlockSize(floor.Format)
+			);
+
+			library::ImageData decoded;
+			hr = library::BlockCompressor::DecompressImage(aBlocks.data(), aBlocks.size(), size[0], size[1], floor.Format, decoded);
+			if (!context.Check(SUCCEEDED(hr) && decoded.uWidth == size[0] && decoded.uHeight == size[1], L"format %zu, %ux%u: decoding failed with 0x%08x", static_cast<size_t>(floor.Format), size[0], size[1], static_cast<UINT>(hr)))
+			{
+				continue;
+			}
+
+			const FLOAT psnr = library::BlockCompressor::ComputePsnr(image, decoded, floor.Format);
+			context.Log(L"format %zu, %ux%u: %.2f dB", static_cast<size_t>(floor.Format), size[0], size[1], psnr);
+			context.Check(psnr >= floor.Synthetic, L"format %zu, %ux%u: %.2f dB, expected at least %.2f dB", static_cast<size_t>(floor.Format), size[0], size[1], psnr, floor.Synthetic);
+		}
+	}
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: TextureCookerKeepsQuality
+
+  Summary:  Cooks copies of a diffuse texture and a normal map of the
+			game content, with and without BC7, and checks the format
+			the cooker picks and the PSNR it measures for the top mip
+-----------------------------------------------------------------F-F*/
+TEST_CASE(TextureCookerKeepsQuality)
+{
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / L"TextureCookerKeepsQuality";
+	std::error_code errorCode;
+	std::filesystem::create_directories(directory, errorCode);
+
+	struct CookCase
+	{
+		PCWSTR pszFileName;
+		BOOL bUseBc7;
+		library::eBlockFormat Format;
+	};
+	const CookCase aCases[] =
+	{
+		{ L"cyborg_diffuse.png", FALSE, library::eBlockFormat::BC1 },
+		{ L"cyborg_diffuse.png", TRUE, library::eBlockFormat::BC7 },
+		{ L"cyborg_normal.png", FALSE, library::eBlockFormat::BC5 },
+	};
+
+	for (const CookCase& cookCase : aCases)
+	{
+		const std::filesystem::path sourcePath = directory / cookCase.pszFileName;
+		std::filesystem::copy_file(std::filesystem::path(PSZ_CONTENT_DIRECTORY) / cookCase.pszFileName, sourcePath, std::filesystem::copy_options::overwrite_existing, errorCode);
+		if (!context.Check(!errorCode, L"could not copy %ls", cookCase.pszFileName))
+		{
+			continue;
+		}
+
+		const library::CookResult result = library::TextureCooker::CookFile(sourcePath, cookCase.bUseBc7);
+		if (!context.Check(SUCCEEDED(result.Result), L"%ls: cooking failed with 0x%08x", cookCase.pszFileName, static_cast<UINT>(result.Result))
+			|| !context.Check(result.Format == cookCase.Format, L"%ls: cooked to format %zu, expected %zu", cookCase.pszFileName, static_cast<size_t>(result.Format), static_cast<size_t>(cookCase.Format)))
+		{
+			continue;
+		}
+
+		const PsnrFloor& floor = A_PSNR_FLOORS[static_cast<size_t>(result.Format)];
+		context.Log(L"%ls, format %zu: %.2f dB", cookCase.pszFileName, static_cast<size_t>(result.Format), result.Psnr);
+		context.Check(result.Psnr >= floor.Cooked, L"%ls, format %zu: %.2f dB, expected at least %.2f dB", cookCase.pszFileName, static_cast<size_t>(result.Format), result.Psnr, floor.Cooked);
+	}
+
+	std::filesystem::remove_all(directory, errorCode);
+}
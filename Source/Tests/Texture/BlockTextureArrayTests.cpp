@@ -0,0 +1,161 @@
+/*+===================================================================
+  File:      BLOCKTEXTUREARRAYTESTS.CPP
+
+  Summary:   Packs synthetic images of several sizes into block
+			 texture slices without a device and checks their sizes,
+			 mip chains and colors.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <cmath>
+
+#include "Texture/BlockTextureArray.h"
+
+namespace
+{
+	constexpr BYTE FLAT_NORMAL[4] = { 128u, 128u, 255u, 255u };
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: MakeImage
+
+	  Summary:  Creates an image whose texels are given by a function
+				of their position
+
+	  Args:     UINT uWidth
+				  Width in texels
+				UINT uHeight
+				  Height in texels
+				Function getTexel
+				  Writes the RGBA bytes of texel (x, y)
+
+	  Returns:  library::ImageData
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	template <class Function>
+	library::ImageData MakeImage(_In_ UINT uWidth, _In_ UINT uHeight, _In_ Function getTexel)
+	{
+		library::ImageData image =
+		{
+			.uWidth = uWidth,
+			.uHeight = uHeight,
+			.aPixels = std::vector<BYTE>(static_cast<SIZE_T>(uWidth) * uHeight * 4u)
+		};
+
+		for (UINT y = 0u; y < uHeight; ++y)
+		{
+			for (UINT x = 0u; x < uWidth; ++x)
+			{
+				getTexel(x, y, &image.aPixels[(static_cast<SIZE_T>(y) * uWidth + x) * 4u]);
+			}
+		}
+
+		return image;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: GetMeanChannel
+
+	  Summary:  Returns the mean of one channel of an image
+
+	  Args:     const library::ImageData& image
+				  Image to average
+				UINT uChannel
+				  0 to 3 for R, G, B and A
+
+	  Returns:  FLOAT
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	FLOAT GetMeanChannel(_In_ const library::ImageData& image, _In_ UINT uChannel)
+	{
+		DOUBLE sum = 0.0;
+		for (SIZE_T i = uChannel; i < image.aPixels.size(); i += 4u)
+		{
+			sum += image.aPixels[i];
+		}
+
+		return static_cast<FLOAT>(sum / (static_cast<DOUBLE>(image.uWidth) * image.uHeight));
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: BlockTextureArrayPacksSlices
+
+  Summary:  Packs images that are larger, smaller, non-square and
+			missing, in sRGB and linear, and checks that every slice
+			has the same size and full mip chain, that solid colors
+			stay exact through resizing and filtering, that the mean
+			of a gradient survives and that missing slices hold the
+			fill color
+-----------------------------------------------------------------F-F*/
+TEST_CASE(BlockTextureArrayPacksSlices)
+{
+	constexpr UINT SLICE_SIZE = 64u;
+	const BYTE aSolid[4] = { 10u, 200u, 30u, 255u };
+
+	std::vector<library::ImageData> aImages;
+	aImages.push_back(MakeImage(256u, 256u, [&](UINT, UINT, BYTE* pTexel) { std::copy(aSolid, aSolid + 4, pTexel); }));
+	aImages.push_back(MakeImage(300u, 90u, [](UINT x, UINT y, BYTE* pTexel) { pTexel[0] = static_cast<BYTE>(x * 255u / 299u); pTexel[1] = static_cast<BYTE>(y * 255u / 89u); pTexel[2] = 128u; pTexel[3] = 255u; }));
+	aImages.push_back(MakeImage(20u, 20u, [&](UINT, UINT, BYTE* pTexel) { std::copy(aSolid, aSolid + 4, pTexel); }));
+	aImages.push_back(library::ImageData());
+	aImages.push_back(MakeImage(SLICE_SIZE, SLICE_SIZE, [](UINT x, UINT y, BYTE* pTexel) { pTexel[0] = static_cast<BYTE>(x * 4u); pTexel[1] = static_cast<BYTE>(y * 4u); pTexel[2] = static_cast<BYTE>((x + y) & 1u ? 255u : 0u); pTexel[3] = 255u; }));
+
+	for (BOOL bIsSrgb : { TRUE, FALSE })
+	{
+		std::vector<std::vector<library::ImageData>> aSlices;
+		const HRESULT hr = library::BlockTextureArray::PackSlices(aImages, SLICE_SIZE, bIsSrgb, FLAT_NORMAL, aSlices);
+		if (!context.Check(SUCCEEDED(hr), L"sRGB %u: packing failed with 0x%08x", bIsSrgb, static_cast<UINT>(hr))
+			|| !context.Check(aSlices.size() == aImages.size(), L"sRGB %u: %zu slices packed", bIsSrgb, aSlices.size()))
+		{
+			return;
+		}
+
+		const UINT uNumMips = library::MipGenerator::GetNumMips(SLICE_SIZE, SLICE_SIZE);
+		for (UINT uSlice = 0u; uSlice < aSlices.size(); ++uSlice)
+		{
+			const std::vector<library::ImageData>& aMips = aSlices[uSlice];
+			context.Check(aMips.size() == uNumMips, L"sRGB %u: slice %u has %zu mips", bIsSrgb, uSlice, aMips.size());
+
+			for (UINT uMip = 0u; uMip < aMips.size(); ++uMip)
+			{
+				const UINT uSize = std::max<UINT>(1u, SLICE_SIZE >> uMip);
+				context.Check(
+					aMips[uMip].uWidth == uSize && aMips[uMip].uHeight == uSize && aMips[uMip].aPixels.size() == static_cast<SIZE_T>(uSize) * uSize * 4u,
+					L"sRGB %u: slice %u mip %u is %ux%u", bIsSrgb, uSlice, uMip, aMips[uMip].uWidth, aMips[uMip].uHeight
+				);
+			}
+		}
+
+		// Solid slices, resized down and up, and the missing one keep their color exactly
+		for (UINT uSlice : { 0u, 2u, 3u })
+		{
+			const BYTE* pExpected = uSlice == 3u ? FLAT_NORMAL : aSolid;
+			for (UINT uMip = 0u; uMip < aSlices[uSlice].size(); ++uMip)
+			{
+				const library::ImageData& mip = aSlices[uSlice][uMip];
+				BOOL bIsExact = TRUE;
+				for (SIZE_T i = 0u; i < mip.aPixels.size(); ++i)
+				{
+					bIsExact &= std::abs(static_cast<INT>(mip.aPixels[i]) - static_cast<INT>(pExpected[i % 4u])) <= 1;
+				}
+				context.Check(bIsExact, L"sRGB %u: solid slice %u changed color at mip %u", bIsSrgb, uSlice, uMip);
+			}
+		}
+
+		// A slice of the right size is used as is
+		context.Check(aSlices[4][0].aPixels == aImages[4].aPixels, L"sRGB %u: slice of the right size was resampled", bIsSrgb);
+
+		// The gradient keeps its mean through the resize and the chain
+		if (!bIsSrgb)
+		{
+			for (UINT uChannel = 0u; uChannel < 3u; ++uChannel)
+			{
+				const FLOAT sourceMean = GetMeanChannel(aImages[1], uChannel);
+				const FLOAT topMean = GetMeanChannel(aSlices[1][0], uChannel);
+				const FLOAT lastMean = GetMeanChannel(aSlices[1].back(), uChannel);
+				context.Check(std::abs(topMean - sourceMean) < 2.0f, L"channel %u: top mip mean %.2f, source %.2f", uChannel, topMean, sourceMean);
+				context.Check(std::abs(lastMean - sourceMean) < 3.0f, L"channel %u: last mip mean %.2f, source %.2f", uChannel, lastMean, sourceMean);
+			}
+		}
+	}
+}
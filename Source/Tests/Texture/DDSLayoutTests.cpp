@@ -0,0 +1,514 @@
+/*+===================================================================
+  File:      DDSLAYOUTTESTS.CPP
+
+  Summary:   Checks the row pitch, surface size and rows of every
+			 DXGI format the DDS loader supports against the layout
+			 of its texels, the offsets of every mip of every array
+			 slice and depth slice, and the parsing of DDS headers.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <cstring>
+
+#include "Texture/DDSLayout.h"
+
+namespace
+{
+	/*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+	  Enum:     eLayout
+
+	  Summary:  How the texels of a format are laid out in a row
+	E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+	enum class eLayout
+	{
+		LINEAR,
+		BLOCK,
+		PACKED,
+		PLANAR,
+		NV11,
+	};
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   FormatLayout
+
+		Summary:  Bits per pixel the loader reports for a format, and
+				  the bytes of its elements: a 4x4 block, a pair of
+				  texels, or a pair of luma texels
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct FormatLayout
+	{
+		DXGI_FORMAT Format;
+		UINT uBitsPerPixel;
+		eLayout Layout;
+		UINT uElementBytes;
+	};
+
+	// Every format the loader supports
+	constexpr FormatLayout FORMAT_LAYOUTS[] =
+	{
+		{ DXGI_FORMAT_R32G32B32A32_TYPELESS, 128u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32G32B32A32_FLOAT, 128u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32G32B32A32_UINT, 128u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32G32B32A32_SINT, 128u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32G32B32_TYPELESS, 96u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32G32B32_FLOAT, 96u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32G32B32_UINT, 96u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32G32B32_SINT, 96u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16G16B16A16_TYPELESS, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16G16B16A16_FLOAT, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16G16B16A16_UNORM, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16G16B16A16_UINT, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16G16B16A16_SNORM, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16G16B16A16_SINT, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32G32_TYPELESS, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32G32_FLOAT, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32G32_UINT, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32G32_SINT, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32G8X24_TYPELESS, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_D32_FLOAT_S8X24_UINT, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_X32_TYPELESS_G8X24_UINT, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_Y416, 64u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_Y210, 64u, eLayout::PACKED, 8u },
+		{ DXGI_FORMAT_Y216, 64u, eLayout::PACKED, 8u },
+		{ DXGI_FORMAT_R10G10B10A2_TYPELESS, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R10G10B10A2_UNORM, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R10G10B10A2_UINT, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R11G11B10_FLOAT, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8G8B8A8_TYPELESS, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8G8B8A8_UNORM, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8G8B8A8_UINT, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8G8B8A8_SNORM, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8G8B8A8_SINT, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16G16_TYPELESS, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16G16_FLOAT, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16G16_UNORM, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16G16_UINT, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16G16_SNORM, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16G16_SINT, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32_TYPELESS, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_D32_FLOAT, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32_FLOAT, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32_UINT, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R32_SINT, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R24G8_TYPELESS, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_D24_UNORM_S8_UINT, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R24_UNORM_X8_TYPELESS, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_X24_TYPELESS_G8_UINT, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R9G9B9E5_SHAREDEXP, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8G8_B8G8_UNORM, 32u, eLayout::PACKED, 4u },
+		{ DXGI_FORMAT_G8R8_G8B8_UNORM, 32u, eLayout::PACKED, 4u },
+		{ DXGI_FORMAT_B8G8R8A8_UNORM, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_B8G8R8X8_UNORM, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_B8G8R8A8_TYPELESS, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_B8G8R8A8_UNORM_SRGB, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_B8G8R8X8_TYPELESS, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_B8G8R8X8_UNORM_SRGB, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_AYUV, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_Y410, 32u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_YUY2, 32u, eLayout::PACKED, 4u },
+		{ DXGI_FORMAT_P010, 24u, eLayout::PLANAR, 4u },
+		{ DXGI_FORMAT_P016, 24u, eLayout::PLANAR, 4u },
+		{ DXGI_FORMAT_R8G8_TYPELESS, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8G8_UNORM, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8G8_UINT, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8G8_SNORM, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8G8_SINT, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16_TYPELESS, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16_FLOAT, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_D16_UNORM, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16_UNORM, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16_UINT, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16_SNORM, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R16_SINT, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_B5G6R5_UNORM, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_B5G5R5A1_UNORM, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_A8P8, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_B4G4R4A4_UNORM, 16u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_NV12, 12u, eLayout::PLANAR, 2u },
+		{ DXGI_FORMAT_420_OPAQUE, 12u, eLayout::PLANAR, 2u },
+		{ DXGI_FORMAT_NV11, 12u, eLayout::NV11, 4u },
+		{ DXGI_FORMAT_R8_TYPELESS, 8u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8_UNORM, 8u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8_UINT, 8u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8_SNORM, 8u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R8_SINT, 8u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_A8_UNORM, 8u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_BC1_TYPELESS, 4u, eLayout::BLOCK, 8u },
+		{ DXGI_FORMAT_BC1_UNORM, 4u, eLayout::BLOCK, 8u },
+		{ DXGI_FORMAT_BC1_UNORM_SRGB, 4u, eLayout::BLOCK, 8u },
+		{ DXGI_FORMAT_BC2_TYPELESS, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_BC2_UNORM, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_BC2_UNORM_SRGB, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_BC3_TYPELESS, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_BC3_UNORM, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_BC3_UNORM_SRGB, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_BC4_TYPELESS, 4u, eLayout::BLOCK, 8u },
+		{ DXGI_FORMAT_BC4_UNORM, 4u, eLayout::BLOCK, 8u },
+		{ DXGI_FORMAT_BC4_SNORM, 4u, eLayout::BLOCK, 8u },
+		{ DXGI_FORMAT_BC5_TYPELESS, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_BC5_UNORM, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_BC5_SNORM, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_BC6H_TYPELESS, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_BC6H_UF16, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_BC6H_SF16, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_BC7_TYPELESS, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_BC7_UNORM, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_BC7_UNORM_SRGB, 8u, eLayout::BLOCK, 16u },
+		{ DXGI_FORMAT_AI44, 8u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_IA44, 8u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_P8, 8u, eLayout::LINEAR, 0u },
+		{ DXGI_FORMAT_R1_UNORM, 1u, eLayout::LINEAR, 0u },
+	};
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   SurfaceSize
+
+		Summary:  Size, row pitch and number of rows of a surface
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct SurfaceSize
+	{
+		size_t uNumBytes;
+		size_t uRowBytes;
+		size_t uNumRows;
+	};
+
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: GetReferenceSize
+
+	  Summary:  Returns the size of a surface from the layout of the
+				texels of its format: blocks of 4x4 texels at least
+				one block across, pairs of texels, a luma plane with a
+				half size chroma plane below it, or a row of texels
+				rounded up to a byte
+
+	  Args:     const FormatLayout& format
+				  Format
+				size_t uWidth
+				  Width in texels
+				size_t uHeight
+				  Height in texels
+
+	  Returns:  SurfaceSize
+	-----------------------------------------------------------------F-F*/
+	SurfaceSize GetReferenceSize(_In_ const FormatLayout& format, _In_ size_t uWidth, _In_ size_t uHeight)
+	{
+		switch (format.Layout)
+		{
+		case eLayout::BLOCK:
+		{
+			const size_t uNumBlocksWide = std::max<size_t>(1u, (uWidth + 3u) / 4u);
+			const size_t uNumBlocksHigh = std::max<size_t>(1u, (uHeight + 3u) / 4u);
+			return { uNumBlocksWide * uNumBlocksHigh * format.uElementBytes, uNumBlocksWide * format.uElementBytes, uNumBlocksHigh };
+		}
+		case eLayout::PACKED:
+		{
+			const size_t uRowBytes = (uWidth + 1u) / 2u * format.uElementBytes;
+			return { uRowBytes * uHeight, uRowBytes, uHeight };
+		}
+		case eLayout::PLANAR:
+		{
+			const size_t uRowBytes = (uWidth + 1u) / 2u * format.uElementBytes;
+			const size_t uLumaBytes = uRowBytes * uHeight;
+			return { uLumaBytes + (uLumaBytes + 1u) / 2u, uRowBytes, uHeight + (uHeight + 1u) / 2u };
+		}
+		case eLayout::NV11:
+		{
+			const size_t uRowBytes = (uWidth + 3u) / 4u * format.uElementBytes;
+			return { uRowBytes * uHeight * 2u, uRowBytes, uHeight * 2u };
+		}
+		default:
+		{
+			const size_t uRowBytes = (uWidth * format.uBitsPerPixel + 7u) / 8u;
+			return { uRowBytes * uHeight, uRowBytes, uHeight };
+		}
+		}
+	}
+
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: FindFormat
+
+	  Summary:  Returns the layout of a format, nullptr when the
+				loader does not support it
+
+	  Args:     DXGI_FORMAT format
+				  Format
+
+	  Returns:  const FormatLayout*
+	-----------------------------------------------------------------F-F*/
+	const FormatLayout* FindFormat(_In_ DXGI_FORMAT format)
+	{
+		for (const FormatLayout& formatLayout : FORMAT_LAYOUTS)
+		{
+			if (formatLayout.Format == format)
+			{
+				return &formatLayout;
+			}
+		}
+
+		return nullptr;
+	}
+
+	/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	  Function: MakeDDSFile
+
+	  Summary:  Returns a DDS file of a texture in memory: the magic
+				number, a header, a DX10 header when the pixel format
+				asks for one, and zeroed surface data
+
+	  Args:     const DDS_PIXELFORMAT& pixelFormat
+				  Pixel format of the header
+				size_t uNumDataBytes
+				  Bytes of surface data after the headers
+
+	  Returns:  std::vector<uint8_t>
+	-----------------------------------------------------------------F-F*/
+	std::vector<uint8_t> MakeDDSFile(_In_ const DirectX::DDS_PIXELFORMAT& pixelFormat, _In_ size_t uNumDataBytes)
+	{
+		DirectX::DDS_HEADER header = {};
+		header.size = sizeof(DirectX::DDS_HEADER);
+		header.flags = DDS_HEADER_FLAGS_TEXTURE;
+		header.width = 8u;
+		header.height = 8u;
+		header.mipMapCount = 1u;
+		header.ddspf = pixelFormat;
+		header.caps = DDS_SURFACE_FLAGS_TEXTURE;
+
+		const BOOL bHasDx10Header = (pixelFormat.flags & DDS_FOURCC) && pixelFormat.fourCC == MAKEFOURCC('D', 'X', '1', '0');
+		std::vector<uint8_t> aFile(sizeof(uint32_t) + sizeof(header) + (bHasDx10Header ? sizeof(DirectX::DDS_HEADER_DXT10) : 0u) + uNumDataBytes, 0u);
+		memcpy(aFile.data(), &DirectX::DDS_MAGIC, sizeof(uint32_t));
+		memcpy(aFile.data() + sizeof(uint32_t), &header, sizeof(header));
+		if (bHasDx10Header)
+		{
+			DirectX::DDS_HEADER_DXT10 dx10Header = {};
+			dx10Header.dxgiFormat = DXGI_FORMAT_BC7_UNORM;
+			dx10Header.resourceDimension = 3u;
+			dx10Header.arraySize = 1u;
+			memcpy(aFile.data() + sizeof(uint32_t) + sizeof(header), &dx10Header, sizeof(dx10Header));
+		}
+
+		return aFile;
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: DDSLayoutMeasuresEverySupportedFormat
+
+  Summary:  Checks the bits per pixel of every supported format, and
+			the size, row pitch and rows of surfaces of odd, block
+			aligned, tiny and large sizes against the layout of the
+			texels. Every other format must be rejected.
+-----------------------------------------------------------------F-F*/
+TEST_CASE(DDSLayoutMeasuresEverySupportedFormat)
+{
+	const size_t aSizes[][2] = { { 1u, 1u }, { 2u, 2u }, { 3u, 5u }, { 4u, 4u }, { 5u, 3u }, { 17u, 9u }, { 256u, 128u }, { 1000u, 3u } };
+
+	for (const FormatLayout& format : FORMAT_LAYOUTS)
+	{
+		const size_t uBitsPerPixel = DirectX::BitsPerPixel(format.Format);
+		context.Check(uBitsPerPixel == format.uBitsPerPixel, L"format %u has %u bits per pixel, expected %u", format.Format, static_cast<UINT>(uBitsPerPixel), format.uBitsPerPixel);
+
+		for (const size_t* aSize : aSizes)
+		{
+			const SurfaceSize expected = GetReferenceSize(format, aSize[0], aSize[1]);
+			SurfaceSize size = {};
+			const HRESULT hr = DirectX::GetSurfaceInfo(aSize[0], aSize[1], format.Format, &size.uNumBytes, &size.uRowBytes, &size.uNumRows);
+			context.Check(
+				SUCCEEDED(hr) && size.uNumBytes == expected.uNumBytes && size.uRowBytes == expected.uRowBytes && size.uNumRows == expected.uNumRows,
+				L"format %u at %ux%u: %u bytes, %u per row, %u rows, expected %u, %u, %u",
+				format.Format, static_cast<UINT>(aSize[0]), static_cast<UINT>(aSize[1]),
+				static_cast<UINT>(size.uNumBytes), static_cast<UINT>(size.uRowBytes), static_cast<UINT>(size.uNumRows),
+				static_cast<UINT>(expected.uNumBytes), static_cast<UINT>(expected.uRowBytes), static_cast<UINT>(expected.uNumRows)
+			);
+		}
+	}
+
+	for (UINT uFormat = 0u; uFormat < 256u; ++uFormat)
+	{
+		const DXGI_FORMAT format = static_cast<DXGI_FORMAT>(uFormat);
+		if (FindFormat(format))
+		{
+			continue;
+		}
+
+		size_t uNumBytes = 0u;
+		context.Check(
+			DirectX::BitsPerPixel(format) == 0u && FAILED(DirectX::GetSurfaceInfo(4u, 4u, format, &uNumBytes, nullptr, nullptr)),
+			L"unsupported format %u is measured", uFormat
+		);
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: DDSLayoutPlacesSubresources
+
+  Summary:  Lays out an array of three slices with a full mip chain,
+			a volume with depth slices and the same array with its
+			largest mips skipped for every supported format, and
+			checks the offset and pitches of every subresource and
+			that surface data one byte short is rejected
+-----------------------------------------------------------------F-F*/
+TEST_CASE(DDSLayoutPlacesSubresources)
+{
+	struct LayoutCase
+	{
+		size_t uWidth;
+		size_t uHeight;
+		size_t uDepth;
+		size_t uNumMips;
+		size_t uArraySize;
+		size_t uMaxSize;
+		PCWSTR pszWhat;
+	};
+	const LayoutCase aCases[] =
+	{
+		{ 37u, 21u, 1u, 6u, 3u, 0u, L"array" },
+		{ 16u, 8u, 5u, 4u, 1u, 0u, L"volume" },
+		{ 37u, 21u, 1u, 6u, 3u, 9u, L"array with a maximum size" },
+	};
+
+	for (const FormatLayout& format : FORMAT_LAYOUTS)
+	{
+		for (const LayoutCase& layoutCase : aCases)
+		{
+			// Every mip of every slice, kept or not, one after another
+			std::vector<DirectX::DDS_SUBRESOURCE_LAYOUT> aExpected;
+			size_t uExpectedSkipped = 0u;
+			size_t uOffset = 0u;
+			for (size_t uSlice = 0u; uSlice < layoutCase.uArraySize; ++uSlice)
+			{
+				for (size_t uMip = 0u; uMip < layoutCase.uNumMips; ++uMip)
+				{
+					const size_t uWidth = std::max<size_t>(1u, layoutCase.uWidth >> uMip);
+					const size_t uHeight = std::max<size_t>(1u, layoutCase.uHeight >> uMip);
+					const size_t uDepth = std::max<size_t>(1u, layoutCase.uDepth >> uMip);
+					const SurfaceSize size = GetReferenceSize(format, uWidth, uHeight);
+					if (layoutCase.uMaxSize == 0u || (uWidth <= layoutCase.uMaxSize && uHeight <= layoutCase.uMaxSize && uDepth <= layoutCase.uMaxSize))
+					{
+						aExpected.push_back({ uOffset, size.uRowBytes, size.uNumBytes });
+					}
+					else if (uSlice == 0u)
+					{
+						++uExpectedSkipped;
+					}
+					uOffset += size.uNumBytes * uDepth;
+				}
+			}
+
+			std::vector<DirectX::DDS_SUBRESOURCE_LAYOUT> aLayouts(layoutCase.uNumMips * layoutCase.uArraySize);
+			size_t uWidth = 0u;
+			size_t uHeight = 0u;
+			size_t uDepth = 0u;
+			size_t uNumSkipped = 0u;
+			HRESULT hr = DirectX::GetSubresourceLayout(
+				layoutCase.uWidth, layoutCase.uHeight, layoutCase.uDepth, layoutCase.uNumMips, layoutCase.uArraySize,
+				format.Format, layoutCase.uMaxSize, uOffset, uWidth, uHeight, uDepth, uNumSkipped, aLayouts.data()
+			);
+			if (!context.Check(SUCCEEDED(hr) && uNumSkipped == uExpectedSkipped, L"format %u, %ls: %u mips skipped, expected %u", format.Format, layoutCase.pszWhat, static_cast<UINT>(uNumSkipped), static_cast<UINT>(uExpectedSkipped)))
+			{
+				continue;
+			}
+
+			context.Check(
+				uWidth == std::max<size_t>(1u, layoutCase.uWidth >> uNumSkipped) && uHeight == std::max<size_t>(1u, layoutCase.uHeight >> uNumSkipped) && uDepth == std::max<size_t>(1u, layoutCase.uDepth >> uNumSkipped),
+				L"format %u, %ls: first mip kept is %ux%ux%u", format.Format, layoutCase.pszWhat, static_cast<UINT>(uWidth), static_cast<UINT>(uHeight), static_cast<UINT>(uDepth)
+			);
+			for (size_t i = 0u; i < aExpected.size(); ++i)
+			{
+				context.Check(
+					aLayouts[i].offset == aExpected[i].offset && aLayouts[i].rowPitch == aExpected[i].rowPitch && aLayouts[i].slicePitch == aExpected[i].slicePitch,
+					L"format %u, %ls, subresource %u: offset %u, pitches %u %u, expected %u, %u %u",
+					format.Format, layoutCase.pszWhat, static_cast<UINT>(i),
+					static_cast<UINT>(aLayouts[i].offset), static_cast<UINT>(aLayouts[i].rowPitch), static_cast<UINT>(aLayouts[i].slicePitch),
+					static_cast<UINT>(aExpected[i].offset), static_cast<UINT>(aExpected[i].rowPitch), static_cast<UINT>(aExpected[i].slicePitch)
+				);
+			}
+
+			hr = DirectX::GetSubresourceLayout(
+				layoutCase.uWidth, layoutCase.uHeight, layoutCase.uDepth, layoutCase.uNumMips, layoutCase.uArraySize,
+				format.Format, layoutCase.uMaxSize, uOffset - 1u, uWidth, uHeight, uDepth, uNumSkipped, aLayouts.data()
+			);
+			context.Check(FAILED(hr), L"format %u, %ls: surface data one byte short is laid out", format.Format, layoutCase.pszWhat);
+		}
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: DDSLayoutParsesHeaders
+
+  Summary:  Parses files with a legacy and a DX10 header, checking
+			where the surface data starts, and rejects a wrong magic
+			number, files too short for their headers and missing
+			outputs. Maps legacy pixel formats to DXGI formats.
+-----------------------------------------------------------------F-F*/
+TEST_CASE(DDSLayoutParsesHeaders)
+{
+	DirectX::DDS_PIXELFORMAT dxt1 = {};
+	dxt1.size = sizeof(DirectX::DDS_PIXELFORMAT);
+	dxt1.flags = DDS_FOURCC;
+	dxt1.fourCC = MAKEFOURCC('D', 'X', 'T', '1');
+
+	DirectX::DDS_PIXELFORMAT dx10 = dxt1;
+	dx10.fourCC = MAKEFOURCC('D', 'X', '1', '0');
+
+	const DirectX::DDS_HEADER* pHeader = nullptr;
+	const uint8_t* pBitData = nullptr;
+	size_t uBitSize = 0u;
+
+	std::vector<uint8_t> aFile = MakeDDSFile(dxt1, 32u);
+	HRESULT hr = DirectX::ParseDDSHeader(aFile.data(), aFile.size(), &pHeader, &pBitData, &uBitSize);
+	context.Check(
+		SUCCEEDED(hr) && pBitData == aFile.data() + 128u && uBitSize == 32u && pHeader->width == 8u,
+		L"legacy header: data at %d, %u bytes", SUCCEEDED(hr) ? static_cast<INT>(pBitData - aFile.data()) : -1, static_cast<UINT>(uBitSize)
+	);
+	context.Check(SUCCEEDED(hr) && DirectX::GetDXGIFormat(pHeader->ddspf) == DXGI_FORMAT_BC1_UNORM, L"DXT1 is not BC1");
+
+	aFile = MakeDDSFile(dx10, 64u);
+	hr = DirectX::ParseDDSHeader(aFile.data(), aFile.size(), &pHeader, &pBitData, &uBitSize);
+	context.Check(
+		SUCCEEDED(hr) && pBitData == aFile.data() + 148u && uBitSize == 64u
+			&& reinterpret_cast<const DirectX::DDS_HEADER_DXT10*>(pHeader + 1)->dxgiFormat == DXGI_FORMAT_BC7_UNORM,
+		L"DX10 header: data at %d, %u bytes", SUCCEEDED(hr) ? static_cast<INT>(pBitData - aFile.data()) : -1, static_cast<UINT>(uBitSize)
+	);
+	context.Check(FAILED(DirectX::ParseDDSHeader(aFile.data(), 140u, &pHeader, &pBitData, &uBitSize)), L"file shorter than its DX10 header is parsed");
+	context.Check(DirectX::ParseDDSHeader(aFile.data(), aFile.size(), nullptr, &pBitData, &uBitSize) == E_POINTER, L"missing header output is not E_POINTER");
+
+	aFile = MakeDDSFile(dxt1, 0u);
+	context.Check(FAILED(DirectX::ParseDDSHeader(aFile.data(), aFile.size() - 1u, &pHeader, &pBitData, &uBitSize)), L"file shorter than its header is parsed");
+	aFile[0] = 'X';
+	context.Check(FAILED(DirectX::ParseDDSHeader(aFile.data(), aFile.size(), &pHeader, &pBitData, &uBitSize)), L"wrong magic number is parsed");
+
+	struct LegacyCase
+	{
+		UINT32 uRBitMask;
+		UINT32 uGBitMask;
+		UINT32 uBBitMask;
+		UINT32 uABitMask;
+		DXGI_FORMAT Expected;
+	};
+	const LegacyCase aLegacyCases[] =
+	{
+		{ 0x000000ffu, 0x0000ff00u, 0x00ff0000u, 0xff000000u, DXGI_FORMAT_R8G8B8A8_UNORM },
+		{ 0x00ff0000u, 0x0000ff00u, 0x000000ffu, 0xff000000u, DXGI_FORMAT_B8G8R8A8_UNORM },
+		{ 0x00ff0000u, 0x0000ff00u, 0x000000ffu, 0u, DXGI_FORMAT_B8G8R8X8_UNORM },
+		{ 0x000000ffu, 0x0000ff00u, 0x00ff0000u, 0u, DXGI_FORMAT_UNKNOWN },
+	};
+	for (const LegacyCase& legacyCase : aLegacyCases)
+	{
+		DirectX::DDS_PIXELFORMAT rgb = {};
+		rgb.size = sizeof(DirectX::DDS_PIXELFORMAT);
+		rgb.flags = DDS_RGB;
+		rgb.RGBBitCount = 32u;
+		rgb.RBitMask = legacyCase.uRBitMask;
+		rgb.GBitMask = legacyCase.uGBitMask;
+		rgb.BBitMask = legacyCase.uBBitMask;
+		rgb.ABitMask = legacyCase.uABitMask;
+		const DXGI_FORMAT format = DirectX::GetDXGIFormat(rgb);
+		context.Check(format == legacyCase.Expected, L"masks %08x %08x %08x %08x map to format %u, expected %u", rgb.RBitMask, rgb.GBitMask, rgb.BBitMask, rgb.ABitMask, format, legacyCase.Expected);
+	}
+}
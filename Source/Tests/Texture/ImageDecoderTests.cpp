@@ -0,0 +1,84 @@
+/*+===================================================================
+  File:      IMAGEDECODERTESTS.CPP
+
+  Summary:   Decodes every PNG and JPEG file of the game content, on
+			 one thread and then on the job system, and reports the
+			 decoded megabytes per second of both.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <atomic>
+#include <filesystem>
+
+#include "Job/JobSystem.h"
+#include "Texture/ImageDecoder.h"
+
+namespace
+{
+	// Relative to the project directory the tests run in
+	constexpr PCWSTR PSZ_CONTENT_DIRECTORY = L"../Game/Content";
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: ImageDecoderContent
+
+  Summary:  Decodes every PNG and JPEG file under the game content,
+			first on the calling thread and then one file per job,
+			and reports the decoded megabytes per second of both.
+			Every file must decode.
+-----------------------------------------------------------------F-F*/
+BENCHMARK_CASE(ImageDecoderContent)
+{
+	std::vector<std::filesystem::path> aFilePaths;
+	std::error_code errorCode;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(PSZ_CONTENT_DIRECTORY, errorCode))
+	{
+		if (entry.is_regular_file() && library::ImageDecoder::IsSupportedExtension(entry.path()))
+		{
+			aFilePaths.push_back(entry.path());
+		}
+	}
+	if (!context.Check(!aFilePaths.empty(), L"no images found under %ls", PSZ_CONTENT_DIRECTORY))
+	{
+		return;
+	}
+
+	const UINT uNumFiles = static_cast<UINT>(aFilePaths.size());
+	std::atomic<UINT64> uNumDecodedBytes = 0ull;
+	std::atomic<UINT> uNumFailed = 0u;
+
+	auto decodeRange = [&](UINT uBegin, UINT uEnd)
+	{
+		for (UINT i = uBegin; i < uEnd; ++i)
+		{
+			library::ImageData image;
+			if (FAILED(library::ImageDecoder::DecodeFile(aFilePaths[i], image)))
+			{
+				uNumFailed.fetch_add(1u, std::memory_order_relaxed);
+				continue;
+			}
+			uNumDecodedBytes.fetch_add(image.aPixels.size(), std::memory_order_relaxed);
+		}
+	};
+
+	const DOUBLE serialMilliseconds = tests::MeasureMilliseconds(1u, [&]() { decodeRange(0u, uNumFiles); });
+	const UINT uNumSerialFailed = uNumFailed.exchange(0u);
+	uNumDecodedBytes = 0ull;
+
+	library::JobSystem& jobSystem = library::JobSystem::GetInstance();
+	const DOUBLE parallelMilliseconds = tests::MeasureMilliseconds(1u, [&]() { jobSystem.ParallelFor(uNumFiles, 1u, decodeRange); });
+
+	const DOUBLE megabytes = static_cast<DOUBLE>(uNumDecodedBytes.load()) / (1024.0 * 1024.0);
+	context.Log(
+		L"%u file(s), %.1f MB decoded, 1 thread %.1f MB/s, %u thread(s) %.1f MB/s",
+		uNumFiles,
+		megabytes,
+		serialMilliseconds > 0.0 ? megabytes * 1000.0 / serialMilliseconds : 0.0,
+		jobSystem.GetNumWorkers() + 1u,
+		parallelMilliseconds > 0.0 ? megabytes * 1000.0 / parallelMilliseconds : 0.0
+	);
+	context.Check(uNumSerialFailed == 0u && uNumFailed.load() == 0u, L"%u file(s) failed on one thread, %u on the job system", uNumSerialFailed, uNumFailed.load());
+}
@@ -0,0 +1,449 @@
+/*+===================================================================
+  File:      MIPGENERATORTESTS.CPP
+
+  Summary:   Builds mip chains of random and solid images of odd and
+			 power-of-two sizes with both filters, and compares them
+			 with a scalar double precision reference written from
+			 the definition of each filter.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <cmath>
+#include <random>
+
+#include "Texture/MipGenerator.h"
+
+namespace
+{
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   ReferenceTaps
+
+		Summary:  Source texels a destination texel reads and their
+				  weights, in double precision
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct ReferenceTaps
+	{
+		UINT uFirst;
+		std::vector<DOUBLE> aWeights;
+	};
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: MakeRandomImage
+
+	  Summary:  Creates an image of random bytes
+
+	  Args:     std::mt19937& generator
+				  Random number generator
+				UINT uWidth
+				  Width in texels
+				UINT uHeight
+				  Height in texels
+
+	  Returns:  library::ImageData
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	library::ImageData MakeRandomImage(_Inout_ std::mt19937& generator, _In_ UINT uWidth, _In_ UINT uHeight)
+	{
+		std::uniform_int_distribution<UINT> byte(0u, 255u);
+		library::ImageData image =
+		{
+			.uWidth = uWidth,
+			.uHeight = uHeight,
+			.aPixels = std::vector<BYTE>(static_cast<SIZE_T>(uWidth) * uHeight * 4u)
+		};
+
+		for (BYTE& value : image.aPixels)
+		{
+			value = static_cast<BYTE>(byte(generator));
+		}
+
+		return image;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: SrgbToLinear
+
+	  Summary:  Decodes an sRGB value with the exact curve
+
+	  Args:     DOUBLE value
+				  Value from 0 to 1
+
+	  Returns:  DOUBLE
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	DOUBLE SrgbToLinear(_In_ DOUBLE value)
+	{
+		return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: LinearToSrgb
+
+	  Summary:  Encodes a linear value with the exact curve
+
+	  Args:     DOUBLE value
+				  Value from 0 to 1
+
+	  Returns:  DOUBLE
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	DOUBLE LinearToSrgb(_In_ DOUBLE value)
+	{
+		return value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: Kaiser
+
+	  Summary:  Sinc windowed by a Kaiser window, with the Bessel
+				function summed to a fixed number of terms
+
+	  Args:     DOUBLE t
+				  Distance in texels of the smaller level
+
+	  Returns:  DOUBLE
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	DOUBLE Kaiser(_In_ DOUBLE t)
+	{
+		const DOUBLE radius = library::MipGenerator::KAISER_RADIUS;
+		const DOUBLE alpha = library::MipGenerator::KAISER_ALPHA;
+		if (std::abs(t) >= radius)
+		{
+			return 0.0;
+		}
+
+		auto besselI0 = [](DOUBLE x)
+		{
+			DOUBLE sum = 0.0;
+			DOUBLE term = 1.0;
+			for (UINT k = 1u; k <= 40u; ++k)
+			{
+				sum += term;
+				term *= x * x / (4.0 * k * k);
+			}
+			return sum;
+		};
+
+		const DOUBLE ratio = t / radius;
+		const DOUBLE sinc = t == 0.0 ? 1.0 : std::sin(3.14159265358979323846 * t) / (3.14159265358979323846 * t);
+		return sinc * besselI0(alpha * std::sqrt(1.0 - ratio * ratio)) / besselI0(alpha);
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: GetReferenceTaps
+
+	  Summary:  Returns the weights of the source texels of one
+				destination texel. A box texel covers [d, d + 1) *
+				source size / destination size of the source and
+				weights texels by the part of them it covers. A Kaiser
+				texel weights texels by the filter at the distance of
+				their centers, folds texels past the edges onto the
+				edge texels and normalizes the weights.
+
+	  Args:     UINT uSourceSize
+				  Number of source texels
+				UINT uDestinationSize
+				  Number of destination texels
+				UINT uDestination
+				  Destination texel
+				library::eMipFilter filter
+				  Filter
+
+	  Returns:  ReferenceTaps
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	ReferenceTaps GetReferenceTaps(_In_ UINT uSourceSize, _In_ UINT uDestinationSize, _In_ UINT uDestination, _In_ library::eMipFilter filter)
+	{
+		const DOUBLE scale = static_cast<DOUBLE>(uSourceSize) / uDestinationSize;
+		std::vector<DOUBLE> aWeights(uSourceSize, 0.0);
+
+		if (filter == library::eMipFilter::BOX)
+		{
+			const DOUBLE begin = uDestination * scale;
+			const DOUBLE end = begin + scale;
+			for (UINT i = 0u; i < uSourceSize; ++i)
+			{
+				aWeights[i] = std::max(0.0, std::min<DOUBLE>(end, i + 1.0) - std::max<DOUBLE>(begin, i)) / scale;
+			}
+		}
+		else
+		{
+			const DOUBLE center = (uDestination + 0.5) * scale;
+			const INT iReach = static_cast<INT>(std::ceil(library::MipGenerator::KAISER_RADIUS * scale)) + 1;
+			DOUBLE total = 0.0;
+			for (INT i = static_cast<INT>(center) - iReach; i <= static_cast<INT>(center) + iReach; ++i)
+			{
+				const DOUBLE weight = Kaiser((i + 0.5 - center) / scale);
+				aWeights[std::clamp(i, 0, static_cast<INT>(uSourceSize) - 1)] += weight;
+				total += weight;
+			}
+
+			for (DOUBLE& weight : aWeights)
+			{
+				weight /= total;
+			}
+		}
+
+		ReferenceTaps taps = { .uFirst = 0u };
+		UINT uLast = uSourceSize;
+		while (taps.uFirst < uLast && aWeights[taps.uFirst] == 0.0)
+		{
+			++taps.uFirst;
+		}
+		while (uLast > taps.uFirst && aWeights[uLast - 1u] == 0.0)
+		{
+			--uLast;
+		}
+		taps.aWeights.assign(aWeights.begin() + taps.uFirst, aWeights.begin() + uLast);
+
+		return taps;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: GenerateReferenceMipChain
+
+	  Summary:  Builds the mip chain one channel at a time in double
+				precision with the exact sRGB curves, every texel
+				summed over both directions at once
+
+	  Args:     const library::ImageData& image
+				  Top level
+				BOOL bIsSrgb
+				  Whether the color channels are sRGB encoded
+				library::eMipFilter filter
+				  Filter
+
+	  Returns:  std::vector<library::ImageData>
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	std::vector<library::ImageData> GenerateReferenceMipChain(_In_ const library::ImageData& image, _In_ BOOL bIsSrgb, _In_ library::eMipFilter filter)
+	{
+		std::vector<library::ImageData> aMips = { image };
+		UINT uWidth = image.uWidth;
+		UINT uHeight = image.uHeight;
+
+		std::vector<DOUBLE> aLinear(image.aPixels.size());
+		for (SIZE_T i = 0u; i < aLinear.size(); ++i)
+		{
+			const DOUBLE value = image.aPixels[i] / 255.0;
+			aLinear[i] = bIsSrgb && i % 4u != 3u ? SrgbToLinear(value) : value;
+		}
+
+		while (uWidth > 1u || uHeight > 1u)
+		{
+			const UINT uNextWidth = std::max<UINT>(1u, uWidth / 2u);
+			const UINT uNextHeight = std::max<UINT>(1u, uHeight / 2u);
+			std::vector<DOUBLE> aNext(static_cast<SIZE_T>(uNextWidth) * uNextHeight * 4u);
+			library::ImageData mip =
+			{
+				.uWidth = uNextWidth,
+				.uHeight = uNextHeight,
+				.aPixels = std::vector<BYTE>(aNext.size())
+			};
+
+			for (UINT y = 0u; y < uNextHeight; ++y)
+			{
+				const ReferenceTaps rowTaps = GetReferenceTaps(uHeight, uNextHeight, y, filter);
+				for (UINT x = 0u; x < uNextWidth; ++x)
+				{
+					const ReferenceTaps columnTaps = GetReferenceTaps(uWidth, uNextWidth, x, filter);
+					for (UINT c = 0u; c < 4u; ++c)
+					{
+						DOUBLE sum = 0.0;
+						for (UINT j = 0u; j < rowTaps.aWeights.size(); ++j)
+						{
+							for (UINT i = 0u; i < columnTaps.aWeights.size(); ++i)
+							{
+								const SIZE_T uSource = (static_cast<SIZE_T>(rowTaps.uFirst + j) * uWidth + columnTaps.uFirst + i) * 4u + c;
+								sum += aLinear[uSource] * rowTaps.aWeights[j] * columnTaps.aWeights[i];
+							}
+						}
+
+						const SIZE_T uDestination = (static_cast<SIZE_T>(y) * uNextWidth + x) * 4u + c;
+						aNext[uDestination] = sum;
+
+						DOUBLE encoded = std::clamp(sum, 0.0, 1.0);
+						encoded = bIsSrgb && c != 3u ? LinearToSrgb(encoded) : encoded;
+						mip.aPixels[uDestination] = static_cast<BYTE>(std::lround(encoded * 255.0));
+					}
+				}
+			}
+
+			aMips.push_back(std::move(mip));
+			aLinear.swap(aNext);
+			uWidth = uNextWidth;
+			uHeight = uNextHeight;
+		}
+
+		return aMips;
+	}
+
+	/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+	  Function: GetLargestDifference
+
+	  Summary:  Returns the largest difference of any channel of any
+				mip of two chains, or 256 when their sizes differ
+
+	  Args:     const std::vector<library::ImageData>& aMips
+				  Chain
+				const std::vector<library::ImageData>& aReferenceMips
+				  Chain to compare with
+
+	  Returns:  INT
+	F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+	INT GetLargestDifference(_In_ const std::vector<library::ImageData>& aMips, _In_ const std::vector<library::ImageData>& aReferenceMips)
+	{
+		if (aMips.size() != aReferenceMips.size())
+		{
+			return 256;
+		}
+
+		INT iLargest = 0;
+		for (SIZE_T uMip = 0u; uMip < aMips.size(); ++uMip)
+		{
+			const library::ImageData& mip = aMips[uMip];
+			const library::ImageData& reference = aReferenceMips[uMip];
+			if (mip.uWidth != reference.uWidth || mip.uHeight != reference.uHeight || mip.aPixels.size() != reference.aPixels.size())
+			{
+				return 256;
+			}
+
+			for (SIZE_T i = 0u; i < mip.aPixels.size(); ++i)
+			{
+				iLargest = std::max(iLargest, std::abs(static_cast<INT>(mip.aPixels[i]) - static_cast<INT>(reference.aPixels[i])));
+			}
+		}
+
+		return iLargest;
+	}
+
+	constexpr PCWSTR PSZ_FILTER_NAMES[] = { L"box", L"Kaiser" };
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: MipGeneratorMatchesReference
+
+  Summary:  Builds the chains of random images of power-of-two, odd,
+			one texel wide and one texel high sizes with both
+			filters, in sRGB and linear, and checks that no channel
+			is more than one step from the reference. The generator
+			encodes sRGB through a lookup table, which may round one
+			step away.
+-----------------------------------------------------------------F-F*/
+TEST_CASE(MipGeneratorMatchesReference)
+{
+	const UINT aSizes[][2] = { { 64u, 64u }, { 37u, 21u }, { 3u, 3u }, { 1u, 9u }, { 13u, 1u }, { 255u, 2u } };
+	std::mt19937 generator(33u);
+
+	for (const UINT* aSize : aSizes)
+	{
+		const library::ImageData image = MakeRandomImage(generator, aSize[0], aSize[1]);
+		for (library::eMipFilter filter : { library::eMipFilter::BOX, library::eMipFilter::KAISER })
+		{
+			for (BOOL bIsSrgb : { TRUE, FALSE })
+			{
+				std::vector<library::ImageData> aMips = { image };
+				const HRESULT hr = library::MipGenerator::GenerateMipChain(aMips, bIsSrgb, filter);
+				if (!context.Check(SUCCEEDED(hr), L"%ls, %ux%u, sRGB %u: failed with 0x%08x", PSZ_FILTER_NAMES[static_cast<UINT>(filter)], aSize[0], aSize[1], bIsSrgb, static_cast<UINT>(hr)))
+				{
+					continue;
+				}
+
+				const INT iDifference = GetLargestDifference(aMips, GenerateReferenceMipChain(image, bIsSrgb, filter));
+				context.Check(
+					aMips.size() == library::MipGenerator::GetNumMips(aSize[0], aSize[1]) && iDifference <= 1,
+					L"%ls, %ux%u, sRGB %u: %zu mips, largest difference %d",
+					PSZ_FILTER_NAMES[static_cast<UINT>(filter)], aSize[0], aSize[1], bIsSrgb, aMips.size(), iDifference
+				);
+			}
+		}
+	}
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: MipGeneratorKeepsSolidColors
+
+  Summary:  Checks that a solid image keeps its color in every mip
+			with both filters, so the weights of every texel add up
+			to one, and that a chain that does not hold exactly one
+			complete level or asks for an unknown filter is rejected
+-----------------------------------------------------------------F-F*/
+TEST_CASE(MipGeneratorKeepsSolidColors)
+{
+	const BYTE aSolid[4] = { 10u, 200u, 30u, 128u };
+	library::ImageData image =
+	{
+		.uWidth = 45u,
+		.uHeight = 7u,
+		.aPixels = std::vector<BYTE>(45u * 7u * 4u)
+	};
+	for (SIZE_T i = 0u; i < image.aPixels.size(); ++i)
+	{
+		image.aPixels[i] = aSolid[i % 4u];
+	}
+
+	for (library::eMipFilter filter : { library::eMipFilter::BOX, library::eMipFilter::KAISER })
+	{
+		std::vector<library::ImageData> aMips = { image };
+		const HRESULT hr = library::MipGenerator::GenerateMipChain(aMips, TRUE, filter);
+
+		INT iDifference = 0;
+		for (const library::ImageData& mip : aMips)
+		{
+			for (SIZE_T i = 0u; i < mip.aPixels.size(); ++i)
+			{
+				iDifference = std::max(iDifference, std::abs(static_cast<INT>(mip.aPixels[i]) - static_cast<INT>(aSolid[i % 4u])));
+			}
+		}
+		context.Check(SUCCEEDED(hr) && iDifference <= 1, L"%ls: solid color moved by %d", PSZ_FILTER_NAMES[static_cast<UINT>(filter)], iDifference);
+	}
+
+	std::vector<library::ImageData> aMips;
+	context.Check(library::MipGenerator::GenerateMipChain(aMips, TRUE) == E_INVALIDARG, L"empty chain is accepted");
+	aMips = { image, image };
+	context.Check(library::MipGenerator::GenerateMipChain(aMips, TRUE) == E_INVALIDARG, L"chain of two levels is accepted");
+	aMips = { image };
+	aMips[0].aPixels.pop_back();
+	context.Check(library::MipGenerator::GenerateMipChain(aMips, TRUE) == E_INVALIDARG, L"level with missing bytes is accepted");
+	aMips = { image };
+	context.Check(library::MipGenerator::GenerateMipChain(aMips, TRUE, library::eMipFilter::COUNT) == E_INVALIDARG, L"unknown filter is accepted");
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: MipGeneratorThroughput
+
+  Summary:  Builds the chain of a 1024x1024 sRGB image with both
+			filters, and reports the time of the generator and of
+			the reference and the megatexels per second of the
+			generator. The chains must stay within one step.
+-----------------------------------------------------------------F-F*/
+BENCHMARK_CASE(MipGeneratorThroughput)
+{
+	constexpr UINT SIZE = 1024u;
+	std::mt19937 generator(33u);
+	const library::ImageData image = MakeRandomImage(generator, SIZE, SIZE);
+
+	for (library::eMipFilter filter : { library::eMipFilter::BOX, library::eMipFilter::KAISER })
+	{
+		std::vector<library::ImageData> aMips;
+		const DOUBLE milliseconds = tests::MeasureMilliseconds(5u, [&]()
+		{
+			aMips = { image };
+			library::MipGenerator::GenerateMipChain(aMips, TRUE, filter);
+		});
+
+		std::vector<library::ImageData> aReferenceMips;
+		const DOUBLE referenceMilliseconds = tests::MeasureMilliseconds(1u, [&]() { aReferenceMips = GenerateReferenceMipChain(image, TRUE, filter); });
+
+		const INT iDifference = GetLargestDifference(aMips, aReferenceMips);
+		context.Log(
+			L"%ls, %ux%u: %.2f ms, %.1f Mtexel/s, reference %.2f ms, largest difference %d",
+			PSZ_FILTER_NAMES[static_cast<UINT>(filter)],
+			SIZE,
+			SIZE,
+			milliseconds,
+			milliseconds > 0.0 ? SIZE * SIZE / (milliseconds * 1000.0) : 0.0,
+			referenceMilliseconds,
+			iDifference
+		);
+		context.Check(iDifference <= 1, L"%ls: largest difference %d", PSZ_FILTER_NAMES[static_cast<UINT>(filter)], iDifference);
+	}
+}
@@ -0,0 +1,134 @@
+/*+===================================================================
+  File:      TEXTURECACHETESTS.CPP
+
+  Summary:   Requests textures through different spellings of one
+			 file and different samplers, and checks that the cache
+			 shares what it should, forgets released textures and
+			 counts its hits, misses and saved bytes.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <filesystem>
+
+#include "Texture/TextureCache.h"
+
+namespace
+{
+	// Relative to the project directory the tests run in
+	constexpr PCWSTR PSZ_TEXTURE_PATH = L"../Game/Content/Common/InvalidTexture.png";
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: TextureCacheSharesCanonicalPaths
+
+  Summary:  A relative, a redundant and an absolute spelling of one
+			file share a texture, counted as one miss and two hits,
+			while another sampler type gets a texture of its own
+-----------------------------------------------------------------F-F*/
+TEST_CASE(TextureCacheSharesCanonicalPaths)
+{
+	library::TextureCache& cache = library::TextureCache::GetInstance();
+	cache.Trim();
+	const UINT uNumHits = cache.GetNumHits();
+	const UINT uNumMisses = cache.GetNumMisses();
+
+	const std::filesystem::path filePath(PSZ_TEXTURE_PATH);
+	const std::filesystem::path redundantPath = filePath.parent_path() / L"." / L".." / filePath.parent_path().filename() / filePath.filename();
+
+	std::shared_ptr<library::Texture> texture = cache.GetOrCreate(filePath);
+	std::shared_ptr<library::Texture> redundantTexture = cache.GetOrCreate(redundantPath);
+	std::shared_ptr<library::Texture> absoluteTexture = cache.GetOrCreate(std::filesystem::absolute(filePath));
+
+	context.Check(texture && redundantTexture == texture, L"%ls got a texture of its own", redundantPath.c_str());
+	context.Check(texture && absoluteTexture == texture, L"the absolute path got a texture of its own");
+	context.Check(cache.GetNumMisses() - uNumMisses == 1u, L"%u miss(es) for one file, expected 1", cache.GetNumMisses() - uNumMisses);
+	context.Check(cache.GetNumHits() - uNumHits == 2u, L"%u hit(s) for one file, expected 2", cache.GetNumHits() - uNumHits);
+
+	std::shared_ptr<library::Texture> clampedTexture = cache.GetOrCreate(filePath, library::eTextureSamplerType::TRILINEAR_CLAMP);
+	context.Check(clampedTexture && clampedTexture != texture, L"another sampler type shares the texture");
+	context.Check(cache.GetNumMisses() - uNumMisses == 2u, L"%u miss(es) with another sampler type, expected 2", cache.GetNumMisses() - uNumMisses);
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: TextureCacheForgetsReleasedTextures
+
+  Summary:  The cache does not keep a texture alive: once its last
+			user releases it, the next request creates it again, and
+			Trim keeps the entries of textures that are still used
+-----------------------------------------------------------------F-F*/
+TEST_CASE(TextureCacheForgetsReleasedTextures)
+{
+	library::TextureCache& cache = library::TextureCache::GetInstance();
+	cache.Trim();
+	const UINT uNumHits = cache.GetNumHits();
+	const UINT uNumMisses = cache.GetNumMisses();
+
+	std::shared_ptr<library::Texture> texture = cache.GetOrCreate(PSZ_TEXTURE_PATH);
+	std::weak_ptr<library::Texture> released = texture;
+	texture.reset();
+	context.Check(released.expired(), L"the cache kept a released texture alive");
+
+	texture = cache.GetOrCreate(PSZ_TEXTURE_PATH);
+	context.Check(cache.GetNumMisses() - uNumMisses == 2u, L"%u miss(es) after a release, expected 2", cache.GetNumMisses() - uNumMisses);
+
+	cache.Trim();
+	std::shared_ptr<library::Texture> trimmedTexture = cache.GetOrCreate(PSZ_TEXTURE_PATH);
+	context.Check(trimmedTexture == texture, L"Trim dropped a texture still in use");
+	context.Check(cache.GetNumHits() - uNumHits == 1u, L"%u hit(s) after Trim, expected 1", cache.GetNumHits() - uNumHits);
+
+	texture.reset();
+	trimmedTexture.reset();
+	cache.Trim();
+	texture = cache.GetOrCreate(PSZ_TEXTURE_PATH);
+	context.Check(cache.GetNumMisses() - uNumMisses == 3u, L"%u miss(es) after trimming a released texture, expected 3", cache.GetNumMisses() - uNumMisses);
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: TextureCacheCountsSavedBytes
+
+  Summary:  Loads a texture on a WARP device and checks that every
+			hit on it saves its size in video memory, and that the
+			savings go away with the texture
+-----------------------------------------------------------------F-F*/
+TEST_CASE(TextureCacheCountsSavedBytes)
+{
+	ComPtr<ID3D11Device> device;
+	ComPtr<ID3D11DeviceContext> immediateContext;
+	HRESULT hr = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0u, nullptr, 0u, D3D11_SDK_VERSION, device.GetAddressOf(), nullptr, immediateContext.GetAddressOf());
+	if (!context.Check(SUCCEEDED(hr), L"creating a WARP device failed with 0x%08x", static_cast<UINT>(hr)))
+	{
+		return;
+	}
+
+	library::TextureCache& cache = library::TextureCache::GetInstance();
+	cache.Trim();
+	const SIZE_T uNumBytesSaved = cache.GetNumBytesSaved();
+
+	std::shared_ptr<library::Texture> texture = cache.GetOrCreate(PSZ_TEXTURE_PATH);
+	hr = texture->Initialize(device.Get(), immediateContext.Get());
+	if (!context.Check(SUCCEEDED(hr) && texture->GetNumBytes() > 0u, L"loading %ls failed with 0x%08x", PSZ_TEXTURE_PATH, static_cast<UINT>(hr)))
+	{
+		return;
+	}
+	context.Check(cache.GetNumBytesSaved() == uNumBytesSaved, L"a miss saved %zu byte(s)", cache.GetNumBytesSaved() - uNumBytesSaved);
+
+	constexpr UINT NUM_HITS = 3u;
+	std::shared_ptr<library::Texture> aHits[NUM_HITS];
+	for (std::shared_ptr<library::Texture>& hit : aHits)
+	{
+		hit = cache.GetOrCreate(PSZ_TEXTURE_PATH);
+	}
+
+	const SIZE_T uNumExpected = texture->GetNumBytes() * NUM_HITS;
+	context.Check(cache.GetNumBytesSaved() - uNumBytesSaved == uNumExpected, L"%zu byte(s) saved, expected %zu", cache.GetNumBytesSaved() - uNumBytesSaved, uNumExpected);
+
+	texture.reset();
+	for (std::shared_ptr<library::Texture>& hit : aHits)
+	{
+		hit.reset();
+	}
+	context.Check(cache.GetNumBytesSaved() == uNumBytesSaved, L"%zu byte(s) still saved after the release", cache.GetNumBytesSaved() - uNumBytesSaved);
+}
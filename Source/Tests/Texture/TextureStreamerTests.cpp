@@ -0,0 +1,354 @@
+/*+===================================================================
+  File:      TEXTURESTREAMERTESTS.CPP
+
+  Summary:   Streams fake textures through the texture streamer
+			 headlessly and checks the per-frame budget, the order
+			 and contents of uploads and that every texture
+			 converges to the mip its screen size asks for.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <thread>
+
+#include "Texture/TextureStreamer.h"
+
+namespace
+{
+	constexpr UINT MAX_NUM_SIMULATED_FRAMES = 100000u;
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+		Struct:   FakeDevice
+
+		Summary:  Stands in for the immediate context in the
+				  simulation, counting what is uploaded each frame and
+				  failing the test on a bad upload
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct FakeDevice
+	{
+		tests::TestContext& Context;
+		SIZE_T uNumFrameBytes;
+	};
+
+	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+	  Class:    FakeTexture
+
+	  Summary:  Texture of the simulation. Mips are generated from
+				their index and position, and every upload is
+				checked: mips arrive from the smallest up, rows in
+				order and intact, and shaders are only pointed at
+				mips that are complete.
+	C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+	class FakeTexture final : public library::StreamableTexture
+	{
+	public:
+		FakeTexture(_In_ FakeDevice& device, _In_ UINT uWidth, _In_ UINT uHeight, _In_ UINT uBlockSize, _In_ UINT uBytesPerBlock)
+			: m_device(device)
+			, m_uWidth(uWidth)
+			, m_uHeight(uHeight)
+			, m_uBlockSize(uBlockSize)
+			, m_uBytesPerBlock(uBytesPerBlock)
+			, m_aMips()
+			, m_aNumRowsReceived()
+			, m_uVisibleMip(UINT_MAX)
+		{
+		}
+
+		HRESULT PrepareStreaming(_Out_ std::vector<library::StreamedMipDesc>& aOutMips) override
+		{
+			aOutMips.clear();
+
+			UINT uWidth = m_uWidth;
+			UINT uHeight = m_uHeight;
+			for (;;)
+			{
+				aOutMips.push_back(
+					library::StreamedMipDesc
+					{
+						.uWidth = uWidth,
+						.uHeight = uHeight,
+						.uNumRows = (uHeight + m_uBlockSize - 1u) / m_uBlockSize,
+						.uRowPitch = (uWidth + m_uBlockSize - 1u) / m_uBlockSize * m_uBytesPerBlock
+					}
+				);
+
+				if (uWidth == 1u && uHeight == 1u)
+				{
+					break;
+				}
+				uWidth = std::max<UINT>(1u, uWidth / 2u);
+				uHeight = std::max<UINT>(1u, uHeight / 2u);
+			}
+
+			m_aMips = aOutMips;
+
+			return S_OK;
+		}
+
+		HRESULT LoadMip(_In_ UINT uMip, _Out_ std::vector<BYTE>& aOutData) override
+		{
+			const library::StreamedMipDesc& mip = m_aMips[uMip];
+
+			aOutData.resize(static_cast<SIZE_T>(mip.uNumRows) * mip.uRowPitch);
+			for (UINT uRow = 0u; uRow < mip.uNumRows; ++uRow)
+			{
+				for (UINT uByte = 0u; uByte < mip.uRowPitch; ++uByte)
+				{
+					aOutData[static_cast<SIZE_T>(uRow) * mip.uRowPitch + uByte] = getByte(uMip, uRow, uByte);
+				}
+			}
+
+			return S_OK;
+		}
+
+		HRESULT CreateStreamingResource(_In_ const std::vector<library::StreamedMipDesc>& aMips) override
+		{
+			if (!m_aNumRowsReceived.empty() || aMips.size() != m_aMips.size())
+			{
+				return fail(L"resource created twice or with another mip chain");
+			}
+
+			m_aNumRowsReceived.assign(aMips.size(), 0u);
+			m_uVisibleMip = static_cast<UINT>(aMips.size());
+
+			return S_OK;
+		}
+
+		HRESULT UploadRows(_In_ UINT uMip, _In_ UINT uFirstRow, _In_ UINT uNumRows, _In_ const BYTE* pRows) override
+		{
+			if (uMip >= m_aNumRowsReceived.size())
+			{
+				return fail(L"upload before the resource exists or past the last mip");
+			}
+
+			const library::StreamedMipDesc& mip = m_aMips[uMip];
+			if (uMip + 1u < m_aNumRowsReceived.size() && m_aNumRowsReceived[uMip + 1u] != m_aMips[uMip + 1u].uNumRows)
+			{
+				return fail(L"mip uploaded before the smaller ones");
+			}
+			if (uFirstRow != m_aNumRowsReceived[uMip] || uNumRows == 0u || uFirstRow + uNumRows > mip.uNumRows)
+			{
+				return fail(L"rows uploaded out of order");
+			}
+
+			for (UINT uRow = 0u; uRow < uNumRows; ++uRow)
+			{
+				for (UINT uByte = 0u; uByte < mip.uRowPitch; ++uByte)
+				{
+					if (pRows[static_cast<SIZE_T>(uRow) * mip.uRowPitch + uByte] != getByte(uMip, uFirstRow + uRow, uByte))
+					{
+						return fail(L"uploaded rows do not match the mip");
+					}
+				}
+			}
+
+			m_aNumRowsReceived[uMip] += uNumRows;
+			m_device.uNumFrameBytes += static_cast<SIZE_T>(uNumRows) * mip.uRowPitch;
+
+			return S_OK;
+		}
+
+		HRESULT SetMostDetailedMip(_In_ UINT uMip) override
+		{
+			if (uMip >= m_uVisibleMip)
+			{
+				return fail(L"most detailed mip did not get more detailed");
+			}
+
+			for (UINT uResidentMip = uMip; uResidentMip < m_aNumRowsReceived.size(); ++uResidentMip)
+			{
+				if (m_aNumRowsReceived[uResidentMip] != m_aMips[uResidentMip].uNumRows)
+				{
+					return fail(L"shaders pointed at an incomplete mip");
+				}
+			}
+
+			m_uVisibleMip = uMip;
+
+			return S_OK;
+		}
+
+		UINT GetVisibleMip() const
+		{
+			return m_uVisibleMip;
+		}
+
+		UINT GetTailMip() const
+		{
+			UINT uTailMip = 0u;
+			while (std::max<UINT>(std::max<UINT>(1u, m_uWidth >> uTailMip), std::max<UINT>(1u, m_uHeight >> uTailMip)) > library::TextureStreamer::MIP_TAIL_SIZE)
+			{
+				++uTailMip;
+			}
+
+			return uTailMip;
+		}
+
+	private:
+		static BYTE getByte(_In_ UINT uMip, _In_ UINT uRow, _In_ UINT uByte)
+		{
+			return static_cast<BYTE>(uMip * 31u + uRow * 7u + uByte);
+		}
+
+		HRESULT fail(_In_ PCWSTR pszReason)
+		{
+			m_device.Context.Check(FALSE, L"%ux%u texture, %ls", m_uWidth, m_uHeight, pszReason);
+
+			return E_FAIL;
+		}
+
+	private:
+		FakeDevice& m_device;
+		UINT m_uWidth;
+		UINT m_uHeight;
+		UINT m_uBlockSize;
+		UINT m_uBytesPerBlock;
+		std::vector<library::StreamedMipDesc> m_aMips;
+		std::vector<UINT> m_aNumRowsReceived;
+		UINT m_uVisibleMip;
+	};
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: TextureStreamerConvergesWithinBudget
+
+  Summary:  Streams fake textures of several sizes and formats
+			through a fake device with a 256 KiB budget, first with
+			the textures at various distances and then with the
+			camera right in front of all of them. Fails if a frame
+			uploads more than the budget, if an upload is out of
+			order or corrupt, or if a texture does not end up with
+			exactly the mip its screen size asks for. Logs how many
+			frames the mip tails and the whole scene took.
+-----------------------------------------------------------------F-F*/
+TEST_CASE(TextureStreamerConvergesWithinBudget)
+{
+	struct SimulatedTexture
+	{
+		UINT uWidth;
+		UINT uHeight;
+		UINT uBlockSize;
+		UINT uBytesPerBlock;
+		FLOAT ScreenSize;
+	};
+
+	// RGBA, BC1 and BC3/BC7 textures near, far, off screen and smaller than the tail
+	const SimulatedTexture aSimulatedTextures[] =
+	{
+		{ 2048u, 2048u, 1u, 4u, 1500.0f },
+		{ 2048u, 1024u, 4u, 8u, 700.0f },
+		{ 1024u, 1024u, 4u, 16u, 90.0f },
+		{ 1000u, 600u, 1u, 4u, 0.0f },
+		{ 512u, 512u, 4u, 16u, 4.0f },
+		{ 48u, 48u, 1u, 4u, 200.0f },
+		{ 4096u, 4096u, 4u, 16u, 3000.0f },
+		{ 256u, 4096u, 4u, 8u, 350.0f },
+	};
+	const UINT uNumTextures = static_cast<UINT>(std::size(aSimulatedTextures));
+	const SIZE_T uBudget = 256u * 1024u;
+	const FLOAT closeScreenSize = 4096.0f;
+
+	FakeDevice device = { .Context = context, .uNumFrameBytes = 0u };
+	library::TextureStreamer streamer;
+	streamer.SetEnabled(TRUE);
+	streamer.SetUploadBudget(uBudget);
+
+	std::vector<std::shared_ptr<FakeTexture>> aTextures;
+	for (const SimulatedTexture& simulated : aSimulatedTextures)
+	{
+		aTextures.push_back(std::make_shared<FakeTexture>(device, simulated.uWidth, simulated.uHeight, simulated.uBlockSize, simulated.uBytesPerBlock));
+		streamer.Register(aTextures.back());
+	}
+
+	for (UINT uPass = 0u; uPass < 2u; ++uPass)
+	{
+		UINT uTailFrame = UINT_MAX;
+		UINT uNumFrames = 0u;
+		SIZE_T uMaxFrameBytes = 0u;
+		SIZE_T uTotalBytes = 0u;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (; uNumFrames < MAX_NUM_SIMULATED_FRAMES; ++uNumFrames)
+		{
+			for (UINT i = 0u; i < uNumTextures; ++i)
+			{
+				FLOAT screenSize = uPass == 0u ? aSimulatedTextures[i].ScreenSize : closeScreenSize;
+				if (screenSize > 0.0f)
+				{
+					streamer.RequestScreenSize(aTextures[i].get(), screenSize);
+				}
+			}
+
+			device.uNumFrameBytes = 0u;
+			SIZE_T uNumBytes = streamer.Update();
+			context.Check(
+				uNumBytes == device.uNumFrameBytes && uNumBytes <= uBudget,
+				L"pass %u, frame %u uploaded %zu bytes, reported %zu, budget %zu",
+				uPass,
+				uNumFrames,
+				device.uNumFrameBytes,
+				uNumBytes,
+				uBudget
+			);
+			uMaxFrameBytes = std::max<SIZE_T>(uMaxFrameBytes, uNumBytes);
+			uTotalBytes += uNumBytes;
+
+			if (uTailFrame == UINT_MAX && std::all_of(aTextures.begin(), aTextures.end(), [](const std::shared_ptr<FakeTexture>& texture) { return texture->GetVisibleMip() <= texture->GetTailMip(); }))
+			{
+				uTailFrame = uNumFrames;
+			}
+
+			if (streamer.GetNumStreaming() == 0u && streamer.GetNumPendingLoads() == 0u)
+			{
+				break;
+			}
+
+			// Frames with nothing to upload are waiting on the loads
+			if (uNumBytes == 0u)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+
+		for (UINT i = 0u; i < uNumTextures; ++i)
+		{
+			const SimulatedTexture& simulated = aSimulatedTextures[i];
+			FLOAT screenSize = uPass == 0u ? simulated.ScreenSize : closeScreenSize;
+
+			UINT uWantedMip = 0u;
+			FLOAT size = static_cast<FLOAT>(std::max<UINT>(simulated.uWidth, simulated.uHeight));
+			while (screenSize > 0.0f && size >= 2.0f * screenSize)
+			{
+				size *= 0.5f;
+				++uWantedMip;
+			}
+			uWantedMip = std::min<UINT>(uWantedMip, aTextures[i]->GetTailMip());
+
+			context.Check(
+				aTextures[i]->GetVisibleMip() == uWantedMip && streamer.GetResidentMip(aTextures[i].get()) == uWantedMip,
+				L"pass %u, %ux%u texture shows mip %u, resident %u, wants %u",
+				uPass,
+				simulated.uWidth,
+				simulated.uHeight,
+				aTextures[i]->GetVisibleMip(),
+				streamer.GetResidentMip(aTextures[i].get()),
+				uWantedMip
+			);
+		}
+
+		context.Log(
+			L"pass %u, mip tails after %u frame(s), converged after %u frame(s) in %.1f ms, %.1f MB uploaded, at most %zu bytes per frame",
+			uPass,
+			uTailFrame,
+			uNumFrames,
+			std::chrono::duration<FLOAT, std::milli>(end - start).count(),
+			static_cast<FLOAT>(uTotalBytes) / (1024.0f * 1024.0f),
+			uMaxFrameBytes
+		);
+
+		context.Check(uNumFrames < MAX_NUM_SIMULATED_FRAMES, L"pass %u did not converge in %u frames", uPass, MAX_NUM_SIMULATED_FRAMES);
+	}
+}